@@ -25,8 +25,9 @@ void main()
 	// At this stage the system clock should have already been configured
 	// at high speed.
 
-	// Delay to let the IMU initialize
-	HAL_Delay(500);
+	// Delay to let the IMU chips boot. Any settling after that is caught by
+	// the calibration's stationarity check.
+	HAL_Delay(SENSOR_BOOT_DELAY);
 
 	// Start the quadcopter
 	DeathChopper9000 *dc9000 = DeathChopper9000::instance();
@@ -0,0 +1,112 @@
+/**
+ * @file
+ *
+ * @brief Battery readings from raw ADC scans
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * The part of the battery monitor that turns scans into volts, amps and
+ * mAh. It makes no HAL calls, so it can be run on a host
+ * (tests/test_battery.cpp).
+ *
+ */
+
+/** @addtogroup Peripherals
+ *  @{
+ */
+
+/** @addtogroup Adc
+ *  @{
+ */
+
+#include "BatteryMonitor.h"
+
+/** @addtogroup BatteryMonitor_Class
+ *  @{
+ */
+
+/**
+ * @brief Construct a BatteryMeter
+ * @param vGain   Volts per ADC count
+ * @param iGain   Amps per ADC count
+ * @param iOffset Amps read at zero current
+ * @param alpha   Low-pass weight of a new update (1.0 disables filtering)
+ */
+BatteryMeter::BatteryMeter(float vGain, float iGain, float iOffset, float alpha) {
+	this->vGain = vGain;
+	this->iGain = iGain;
+	this->iOffset = iOffset;
+	this->alpha = alpha;
+	primed = false;
+
+	voltage = current = consumed = 0.0f;
+}
+
+/**
+ * @brief Add a block of scans
+ * @param scans Interleaved samples, voltage then current, n scans
+ * @param n     Number of scans
+ * @param dt    Time covered by the block [s]
+ */
+void BatteryMeter::addBlock(const volatile uint16_t *scans, uint16_t n, float dt) {
+	uint32_t sumV = 0, sumI = 0;
+
+	if (n == 0) return;
+
+	for (uint16_t k = 0; k < n; k++) {
+		sumV += scans[BATT_CHANNELS*k];
+		sumI += scans[BATT_CHANNELS*k + 1];
+	}
+
+	float v = (float)sumV / (float)n * vGain;
+	float i = (float)sumI / (float)n * iGain - iOffset;
+
+	if (!primed) {
+		voltage = v;
+		current = i;
+		primed = true;
+	} else {
+		voltage += alpha * (v - voltage);
+		current += alpha * (i - current);
+	}
+
+	// A * s -> mAh
+	consumed += i * dt * (1000.0f / 3600.0f);
+}
+
+/**
+ * @brief Restart the consumption count, e.g. after a battery swap
+ */
+void BatteryMeter::resetConsumed(void) {
+	consumed = 0.0f;
+}
+
+/**
+ * @brief  Get the battery voltage
+ * @return Filtered voltage [V]
+ */
+float BatteryMeter::getVoltage(void) {
+	return voltage;
+}
+
+/**
+ * @brief  Get the battery current
+ * @return Filtered current [A]
+ */
+float BatteryMeter::getCurrent(void) {
+	return current;
+}
+
+/**
+ * @brief  Get the consumed charge
+ * @return Charge drawn since start/reset [mAh]
+ */
+float BatteryMeter::getConsumed(void) {
+	return consumed;
+}
+
+/** @} Close BatteryMonitor_Class group */
+/** @} Close Adc group */
+/** @} Close Peripherals Group */
@@ -0,0 +1,235 @@
+/**
+ * @file
+ *
+ * @brief Free-running battery voltage and current measurement
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Peripherals
+ *  @{
+ */
+
+/** @addtogroup Adc
+ *  @{
+ */
+
+#include "BatteryMonitor.h"
+#include "DMA_IT.h"
+#include "PwmTimer.h"
+#include "errDC9000.h"
+#include "config.h"
+
+/** @defgroup BatteryMonitor_Class BatteryMonitor classes
+ *  @brief Battery voltage, current and consumption
+ *  @{
+ */
+
+BatteryMonitor *BatteryMonitor::battInstance = NULL;
+
+/**
+ * @brief This function is called to create/get the instance
+ * @param v Voltage sense pin
+ * @param i Current sense pin
+ * @return Pointer to the BatteryMonitor singleton
+ */
+BatteryMonitor* BatteryMonitor::Instance(AdcPin v, AdcPin i) {
+	if (battInstance == NULL) {
+		battInstance = new BatteryMonitor(v, i);
+	}
+
+	return battInstance;
+}
+
+/**
+ * @brief Get the instance without creating it
+ * @return Pointer to the BatteryMonitor singleton, NULL if not created
+ */
+BatteryMonitor* BatteryMonitor::Instance(void) {
+	return battInstance;
+}
+
+/**
+ * @brief Configure ADC1, its DMA stream and the trigger TIM, then start
+ * @param v Voltage sense pin
+ * @param i Current sense pin
+ */
+BatteryMonitor::BatteryMonitor(AdcPin v, AdcPin i)
+	: meter(ADC_VREF / 4096.0f * VSENSE_SCALE, ADC_VREF / 4096.0f * ISENSE_SCALE,
+			ISENSE_OFFSET * ISENSE_SCALE, BATT_FILTER_ALPHA)
+{
+	AdcPin pins[BATT_CHANNELS] = {v, i};
+	GPIO_InitTypeDef GPIO_InitStruct;
+
+	battInstance = this;
+	for (uint16_t k = 0; k < 2*BATT_OVERSAMPLE*BATT_CHANNELS; k++) {
+		buff[k] = 0;
+	}
+
+	// Analog inputs
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	GPIO_InitStruct.Pin = 0;
+	for (uint8_t k = 0; k < BATT_CHANNELS; k++) {
+		GPIO_InitStruct.Pin |= (pins[k] == AdcPin::PA2) ? GPIO_PIN_2 : GPIO_PIN_3;
+	}
+	GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+	// DMA: circular, one half-word per conversion
+	__HAL_RCC_DMA2_CLK_ENABLE();
+	adc1Dma.Instance                 = BATT_DMA_STREAM;
+	adc1Dma.Init.Channel             = BATT_DMA_CHANNEL;
+	adc1Dma.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+	adc1Dma.Init.PeriphInc           = DMA_PINC_DISABLE;
+	adc1Dma.Init.MemInc              = DMA_MINC_ENABLE;
+	adc1Dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+	adc1Dma.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+	adc1Dma.Init.Mode                = DMA_CIRCULAR;
+	adc1Dma.Init.Priority            = DMA_PRIORITY_LOW;
+	adc1Dma.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+	adc1Dma.Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_HALFFULL;
+	adc1Dma.Init.MemBurst            = DMA_MBURST_SINGLE;
+	adc1Dma.Init.PeriphBurst         = DMA_PBURST_SINGLE;
+
+	if (HAL_DMA_Init(&adc1Dma) != HAL_OK) {
+		Error_Handler(errDC9000::ADC_INIT_ERROR);
+	}
+	__HAL_LINKDMA(&AdcHandle, DMA_Handle, adc1Dma);
+
+	HAL_NVIC_SetPriority(BATT_DMA_IRQn, 3, 0);
+	HAL_NVIC_EnableIRQ(BATT_DMA_IRQn);
+
+	// ADC: scan both channels on every trigger, DMA requests continue
+	AdcHandle.Instance = ADC1;
+	AdcHandle.Init.ClockPrescaler = ADC_CLOCKPRESCALER_PCLK_DIV2;
+	AdcHandle.Init.Resolution = ADC_RESOLUTION_12B;
+	AdcHandle.Init.DataAlign = ADC_DATAALIGN_RIGHT;
+	AdcHandle.Init.ScanConvMode = ENABLE;
+	AdcHandle.Init.EOCSelection = DISABLE;
+	AdcHandle.Init.ContinuousConvMode = DISABLE;
+	AdcHandle.Init.DMAContinuousRequests = ENABLE;
+	AdcHandle.Init.NbrOfConversion = BATT_CHANNELS;
+	AdcHandle.Init.DiscontinuousConvMode = DISABLE;
+	AdcHandle.Init.NbrOfDiscConversion = 0;
+	AdcHandle.Init.ExternalTrigConv = BATT_TRIG_ADC;
+	AdcHandle.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_RISING;
+	AdcHandle.State = HAL_ADC_STATE_RESET;
+
+	// NOTE: Calls HAL_ADC_MspInit()
+	if (HAL_ADC_Init(&AdcHandle) != HAL_OK) {
+		Error_Handler(errDC9000::ADC_INIT_ERROR);
+	}
+
+	ADC_ChannelConfTypeDef sConfig;
+	for (uint8_t k = 0; k < BATT_CHANNELS; k++) {
+		sConfig.Channel = (pins[k] == AdcPin::PA2) ? ADC_CHANNEL_2 : ADC_CHANNEL_3;
+		sConfig.Rank = k + 1;
+		sConfig.SamplingTime = ADC_SAMPLETIME_84CYCLES;
+		sConfig.Offset = 0;
+
+		if (HAL_ADC_ConfigChannel(&AdcHandle, &sConfig) != HAL_OK) {
+			Error_Handler(errDC9000::ADC_INIT_ERROR);
+		}
+	}
+
+	if (HAL_ADC_Start_DMA(&AdcHandle, (uint32_t *)buff, 2*BATT_OVERSAMPLE*BATT_CHANNELS) != HAL_OK) {
+		Error_Handler(errDC9000::ADC_INIT_ERROR);
+	}
+
+	// Trigger TIM: 1 MHz tick, TRGO on update
+	TimHandle.Instance = BATT_TRIG_TIM;
+	TimHandle.Init.Prescaler = (uint32_t)(timerClock(BATT_TRIG_TIM) / 1e6f) - 1;
+	TimHandle.Init.Period = 1000000 / BATT_SAMPLE_HZ - 1;
+	TimHandle.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	TimHandle.Init.CounterMode = TIM_COUNTERMODE_UP;
+	TimHandle.Init.RepetitionCounter = 0;
+	TimHandle.State = HAL_TIM_STATE_RESET;
+
+	// NOTE: Calls HAL_TIM_Base_MspInit()
+	if (HAL_TIM_Base_Init(&TimHandle) != HAL_OK) {
+		Error_Handler(errDC9000::ADC_INIT_ERROR);
+	}
+
+	TIM_MasterConfigTypeDef sMaster;
+	sMaster.MasterOutputTrigger = TIM_TRGO_UPDATE;
+	sMaster.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+	if (HAL_TIMEx_MasterConfigSynchronization(&TimHandle, &sMaster) != HAL_OK) {
+		Error_Handler(errDC9000::ADC_INIT_ERROR);
+	}
+
+	if (HAL_TIM_Base_Start(&TimHandle) != HAL_OK) {
+		Error_Handler(errDC9000::ADC_INIT_ERROR);
+	}
+}
+
+/**
+ * @brief Process a finished half of the DMA buffer. Called from the DMA interrupt
+ * @param secondHalf true for the second half of the buffer
+ */
+void BatteryMonitor::blockComplete(bool secondHalf) {
+	const volatile uint16_t *block = &buff[secondHalf ? BATT_OVERSAMPLE*BATT_CHANNELS : 0];
+
+	meter.addBlock(block, BATT_OVERSAMPLE, (float)BATT_OVERSAMPLE / (float)BATT_SAMPLE_HZ);
+}
+
+/**
+ * @brief  Get the battery voltage
+ * @return Filtered voltage [V]
+ */
+float BatteryMonitor::getVoltage(void) {
+	return meter.getVoltage();
+}
+
+/**
+ * @brief  Get the battery current
+ * @return Filtered current [A]
+ */
+float BatteryMonitor::getCurrent(void) {
+	return meter.getCurrent();
+}
+
+/**
+ * @brief  Get the consumed charge
+ * @return Charge drawn since start [mAh]
+ */
+float BatteryMonitor::getConsumed(void) {
+	return meter.getConsumed();
+}
+
+/** @} Close BatteryMonitor_Class group */
+
+/** @addtogroup Adc_Functions
+ *  @{
+ */
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+/**
+ * @brief ADC DMA half transfer complete callback
+ * @param hadc ADC handle
+ */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc) {
+	if (BatteryMonitor::Instance() != NULL) {
+		BatteryMonitor::Instance()->blockComplete(false);
+	}
+}
+
+/**
+ * @brief ADC DMA transfer complete callback
+ * @param hadc ADC handle
+ */
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc) {
+	if (BatteryMonitor::Instance() != NULL) {
+		BatteryMonitor::Instance()->blockComplete(true);
+	}
+}
+#pragma GCC diagnostic pop
+
+/** @} Close Adc_Functions group */
+
+/** @} Close Adc group */
+/** @} Close Peripherals Group */
@@ -0,0 +1,102 @@
+/**
+ * @file
+ *
+ * @brief Free-running battery voltage and current measurement
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Peripherals
+ *  @{
+ */
+
+/** @addtogroup Adc
+ *  @{
+ */
+
+#ifndef BATTERYMONITOR_H_
+#define BATTERYMONITOR_H_
+
+#include "stm32f4xx_hal.h"
+#include "Adc.h"
+
+#define BATT_SAMPLE_HZ		1000	///< Scan trigger rate [Hz]
+#define BATT_OVERSAMPLE		8		///< Scans averaged per update (half the DMA buffer)
+#define BATT_CHANNELS		2		///< Voltage, current
+#define BATT_FILTER_ALPHA	0.1f	///< Low-pass weight of a new averaged update
+
+// Scan trigger and DMA
+#define BATT_TRIG_TIM			TIM8
+#define BATT_TRIG_ADC			ADC_EXTERNALTRIGCONV_T8_TRGO
+#define BATT_DMA_STREAM			DMA2_Stream0
+#define BATT_DMA_CHANNEL		DMA_CHANNEL_0
+#define BATT_DMA_IRQn			DMA2_Stream0_IRQn
+
+/**
+ * @brief Battery readings from raw ADC scans
+ *
+ * Each update averages a block of scans (software oversampling), low-pass
+ * filters voltage and current, and integrates the block-average current into
+ * the consumed charge. Does not touch hardware.
+ */
+class BatteryMeter {
+private:
+	float vGain;				///< Volts per ADC count
+	float iGain;				///< Amps per ADC count
+	float iOffset;				///< Amps read at zero current
+	float alpha;				///< Low-pass weight of a new update
+	bool primed;				///< First update has been applied
+
+	volatile float voltage;		///< Filtered voltage [V]
+	volatile float current;		///< Filtered current [A]
+	volatile float consumed;	///< Consumed charge [mAh]
+
+public:
+	BatteryMeter(float vGain, float iGain, float iOffset, float alpha);
+
+	void addBlock(const volatile uint16_t *scans, uint16_t n, float dt);
+	void resetConsumed(void);
+
+	float getVoltage(void);
+	float getCurrent(void);
+	float getConsumed(void);
+};
+
+/**
+ * @brief Timer-triggered ADC scan of the battery voltage and current
+ *
+ * BATT_TRIG_TIM starts an ADC1 scan of both pins at BATT_SAMPLE_HZ. DMA
+ * writes the scans into a circular buffer of 2 x BATT_OVERSAMPLE scans, and
+ * each half-complete/complete interrupt feeds the finished half to a
+ * BatteryMeter. The getters return the latest values and never wait for a
+ * conversion.
+ */
+class BatteryMonitor {
+private:
+	static BatteryMonitor *battInstance;	///< Singleton instance
+
+	ADC_HandleTypeDef AdcHandle;			///< STM HAL variable containing ADC config
+	TIM_HandleTypeDef TimHandle;			///< STM HAL variable containing trigger TIM config
+	volatile uint16_t buff[2*BATT_OVERSAMPLE*BATT_CHANNELS];	///< Circular DMA buffer
+	BatteryMeter meter;						///< Scaling, filtering and integration
+
+	BatteryMonitor(AdcPin v, AdcPin i);
+
+public:
+	static BatteryMonitor *Instance(AdcPin v, AdcPin i);
+	static BatteryMonitor *Instance(void);
+
+	void blockComplete(bool secondHalf);
+
+	float getVoltage(void);
+	float getCurrent(void);
+	float getConsumed(void);
+};
+
+#endif
+
+/** @} Close Adc group */
+/** @} Close Peripherals Group */
@@ -0,0 +1,250 @@
+/**
+ * @file
+ *
+ * @brief Online gyro bias and accelerometer offset estimation
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Sensors
+ *  @{
+ */
+
+/** @addtogroup IMUCAL
+ *  @{
+ */
+
+#include "BiasEstimator.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * @brief Create an estimator with nothing learnt
+ */
+BiasEstimator::BiasEstimator() {
+	reset(NAN);
+}
+
+/**
+ * @brief Forget everything learnt, e.g. after a new calibration
+ * @param t Gyro temperature the calibration was made at [degC], NAN if
+ * 			unknown
+ */
+void BiasEstimator::reset(float t) {
+	for (uint8_t i = 0; i < 3; i++) {
+		bias[i] = 0.0f;
+		slope[i] = 0.0f;
+		p[i][0] = BIAS_P0;
+		p[i][1] = 0.0f;
+		p[i][2] = BIAS_SLOPE_P0;
+		accOffset[i] = 0.0f;
+	}
+	temp = t;
+
+	angle[0] = angle[1] = 0.0f;
+	observing = false;
+
+	memset(winSum, 0, sizeof(winSum));
+	memset(winSumSq, 0, sizeof(winSumSq));
+	winCount = 0;
+	stillWindows = 0;
+}
+
+/**
+ * @brief Move the estimates on in time and temperature
+ * @param dTemp Temperature change [degC]
+ * @param dt    Time passed [s]
+ *
+ * Kalman prediction with x = (b, k): b += k * dTemp, and both wander a
+ * little with time.
+ */
+void BiasEstimator::predict(float dTemp, float dt) {
+	for (uint8_t i = 0; i < 3; i++) {
+		bias[i] += slope[i] * dTemp;
+
+		p[i][0] += 2.0f * dTemp * p[i][1] + dTemp * dTemp * p[i][2] + BIAS_Q * dt;
+		p[i][1] += dTemp * p[i][2];
+		p[i][2] += BIAS_SLOPE_Q * dt;
+	}
+}
+
+/**
+ * @brief Correct one axis with a direct bias measurement
+ * @param axis Gyro axis
+ * @param z    Measured bias [deg/s]
+ * @param r    Variance of the measurement [(deg/s)^2]
+ */
+void BiasEstimator::measure(uint8_t axis, float z, float r) {
+	float *q = p[axis];
+	float s = q[0] + r;
+	float kb = q[0] / s;
+	float kk = q[1] / s;
+	float y = z - bias[axis];
+
+	bias[axis] += kb * y;
+	slope[axis] += kk * y;
+
+	q[2] -= kk * q[1];
+	q[1] *= 1.0f - kb;
+	q[0] *= 1.0f - kb;
+}
+
+/**
+ * @brief Use a full window if the vehicle kept still through it
+ */
+void BiasEstimator::endWindow(void) {
+	float mean[CAL_CHANNELS];
+	float var[CAL_CHANNELS];
+	bool quiet = true;
+
+	for (uint8_t c = 0; c < CAL_CHANNELS; c++) {
+		float m = winSum[c] / CAL_WINDOW;
+		var[c] = winSumSq[c] / CAL_WINDOW - m * m;
+		mean[c] = ref[c] + m;
+		quiet = quiet && (var[c] <= ((c < 3) ? CAL_GYRO_VAR : CAL_ACC_VAR));
+	}
+
+	memset(winSum, 0, sizeof(winSum));
+	memset(winSumSq, 0, sizeof(winSumSq));
+	winCount = 0;
+
+	if (!quiet) {
+		return;
+	}
+	stillWindows++;
+
+	// The average rate over a still window is all bias
+	for (uint8_t i = 0; i < 3; i++) {
+		measure(i, mean[i], fmaxf(var[i], CAL_GYRO_SEM * CAL_GYRO_SEM) / CAL_WINDOW);
+	}
+
+	// Step the accelerometer offset towards a 1 g reading
+	float v[3];
+	float n = 0.0f;
+	for (uint8_t i = 0; i < 3; i++) {
+		v[i] = mean[3 + i] - accOffset[i];
+		n += v[i] * v[i];
+	}
+	n = sqrtf(n);
+	if (n > 0.5f) {
+		for (uint8_t i = 0; i < 3; i++) {
+			accOffset[i] += BIAS_ACC_GAIN * (n - 1.0f) * v[i] / n;
+		}
+	}
+}
+
+/**
+ * @brief Take in a new gyro temperature
+ * @param t Temperature [degC], ignored if NAN (read failed)
+ */
+void BiasEstimator::setTemperature(float t) {
+	if (isnan(t)) {
+		return;
+	}
+	if (!isnan(temp)) {
+		predict(t - temp, 0.0f);
+	}
+	temp = t;
+}
+
+/**
+ * @brief Add one sample
+ * @param gyro     Gyro x, y, z, calibration offsets removed [deg/s]
+ * @param acc      Accelerometer x, y, z, calibration offsets removed [g]
+ * @param accAngle Pitch, roll from the accelerometer alone [deg]
+ * @param onGround Disarmed: still windows may be used
+ * @param dt       Time since the last sample [s]
+ */
+void BiasEstimator::update(const float *gyro, const float *acc, const float *accAngle, bool onGround, float dt) {
+	predict(0.0f, dt);
+
+	// Still windows, on the ground only
+	if (onGround) {
+		float x[CAL_CHANNELS] = { gyro[0], gyro[1], gyro[2], acc[0], acc[1], acc[2] };
+
+		if (winCount == 0) {
+			memcpy(ref, x, sizeof(ref));
+		}
+		for (uint8_t c = 0; c < CAL_CHANNELS; c++) {
+			float d = x[c] - ref[c];
+			winSum[c] += d;
+			winSumSq[c] += d * d;
+		}
+		if (++winCount >= CAL_WINDOW) {
+			endWindow();
+		}
+	} else if (winCount > 0) {
+		memset(winSum, 0, sizeof(winSum));
+		memset(winSumSq, 0, sizeof(winSumSq));
+		winCount = 0;
+	}
+
+	// Pitch and roll observer: the accelerometer angles pull the integrated
+	// rates back, and in flight what they keep pulling is bias
+	float n = 0.0f;
+	for (uint8_t i = 0; i < 3; i++) {
+		float a = acc[i] - accOffset[i];
+		n += a * a;
+	}
+	bool steady = fabsf(sqrtf(n) - 1.0f) <= BIAS_ACC_GATE;
+
+	if (!observing) {
+		angle[0] = accAngle[0];
+		angle[1] = accAngle[1];
+		observing = true;
+	}
+
+	for (uint8_t i = 0; i < 2; i++) {
+		float e = steady ? accAngle[i] - angle[i] : 0.0f;
+
+		angle[i] += (gyro[i] - bias[i] + 2.0f * BIAS_OBS_ZETA * BIAS_OBS_W * e) * dt;
+		if (!onGround) {
+			bias[i] -= BIAS_OBS_W * BIAS_OBS_W * e * dt;
+		}
+	}
+
+	for (uint8_t i = 0; i < 3; i++) {
+		bias[i] = fminf(fmaxf(bias[i], -BIAS_MAX), BIAS_MAX);
+	}
+}
+
+/**
+ * @brief Get a gyro axis' bias
+ * @param axis 0 to 2 for x, y, z
+ * @return Bias to subtract from the calibrated rate [deg/s]
+ */
+float BiasEstimator::getGyroBias(uint8_t axis) {
+	return (axis < 3) ? bias[axis] : 0.0f;
+}
+
+/**
+ * @brief Get a gyro axis' learnt thermal slope
+ * @param axis 0 to 2 for x, y, z
+ * @return Bias change per degree [deg/s per degC]
+ */
+float BiasEstimator::getSlope(uint8_t axis) {
+	return (axis < 3) ? slope[axis] : 0.0f;
+}
+
+/**
+ * @brief Get an accelerometer axis' offset
+ * @param axis 0 to 2 for x, y, z
+ * @return Offset to subtract from the calibrated acceleration [g]
+ */
+float BiasEstimator::getAccOffset(uint8_t axis) {
+	return (axis < 3) ? accOffset[axis] : 0.0f;
+}
+
+/**
+ * @brief Get how many still windows have been used
+ * @return Still windows since reset()
+ */
+uint32_t BiasEstimator::getStillWindows(void) {
+	return stillWindows;
+}
+
+/** @} Close IMUCAL group */
+/** @} Close Sensors Group */
@@ -0,0 +1,105 @@
+/**
+ * @file
+ *
+ * @brief Online gyro bias and accelerometer offset estimation
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * The offsets from IMU::calibrate() are only right at the temperature they
+ * were measured at. This tracks what is left over while running:
+ *
+ * 		- Each gyro axis has a bias b and a thermal slope k [deg/s per degC],
+ * 		  kept by a two-state Kalman filter. Every temperature reading moves
+ * 		  b by k times the change.
+ * 		- On the ground (disarmed), windows of CAL_WINDOW samples that pass
+ * 		  ImuCalibrator's stillness test measure b directly on all three
+ * 		  axes. Measurements at different temperatures teach the filter k.
+ * 		- In flight, pitch and roll are tracked by a slow observer, with the
+ * 		  accelerometer angles as reference. What the integrated rate
+ * 		  persistently gets wrong is corrected into b. The observer is only
+ * 		  fed while the accelerometer reads about 1 g, so manoeuvres don't
+ * 		  leak in. Yaw has no reference in flight and follows k alone.
+ * 		- Still windows also nudge the accelerometer offset so the reading
+ * 		  is 1 g long. That is a sphere fit one sample at a time. Sitting
+ * 		  level it can only find the offset along gravity, which is the one
+ * 		  that tilts the angles least; other attitudes fill in the rest.
+ *
+ * Does not touch hardware, so it can be run on synthetic drifting-bias data
+ * on a host.
+ *
+ */
+
+/** @addtogroup Sensors
+ *  @{
+ */
+
+/** @addtogroup IMUCAL
+ *  @{
+ */
+
+#ifndef BIASESTIMATOR_H_
+#define BIASESTIMATOR_H_
+
+#include <stdint.h>
+#include "ImuCalibrator.h"
+
+#define BIAS_P0				0.25f		///< Initial bias variance [(deg/s)^2]
+#define BIAS_SLOPE_P0		2.5e-3f		///< Initial thermal slope variance [(deg/s/degC)^2]
+#define BIAS_Q				1.0e-5f		///< Bias random walk [(deg/s)^2 per s]
+#define BIAS_SLOPE_Q		1.0e-7f		///< Thermal slope random walk [(deg/s/degC)^2 per s]
+#define BIAS_OBS_W			0.2f		///< In-flight observer bandwidth [rad/s]
+#define BIAS_OBS_ZETA		0.7f		///< In-flight observer damping
+#define BIAS_ACC_GATE		0.1f		///< Largest |1 g - accel| fed to the observer [g]
+#define BIAS_ACC_GAIN		0.1f		///< Accel offset step per still window
+#define BIAS_MAX			10.0f		///< Largest bias estimate [deg/s]
+
+/**
+ * @brief Tracks the gyro bias and accelerometer offset left after calibration
+ *
+ * Usage, every sample:
+ *
+ * 		est.update(gyro, acc, accAngle, !armed, dt);
+ * 		gyro[i] -= est.getGyroBias(i);
+ *
+ * and est.setTemperature(t) whenever a new temperature is read.
+ */
+class BiasEstimator {
+private:
+	float bias[3];					///< Gyro bias, on top of the calibration [deg/s]
+	float slope[3];					///< Thermal slope of the bias [deg/s per degC]
+	float p[3][3];					///< Covariance per axis: bias, cross, slope
+	float temp;						///< Last temperature [degC], NAN until known
+	float accOffset[3];				///< Accelerometer offset, on top of the calibration [g]
+
+	float angle[2];					///< Observer pitch, roll [deg]
+	bool observing;					///< angle has been initialised
+
+	float ref[CAL_CHANNELS];		///< First sample of the window; sums are relative to it
+	float winSum[CAL_CHANNELS];		///< Sum of this window's samples
+	float winSumSq[CAL_CHANNELS];	///< Sum of this window's squared samples
+	uint8_t winCount;				///< Samples in this window
+	uint32_t stillWindows;			///< Still windows seen
+
+	void predict(float dTemp, float dt);
+	void measure(uint8_t axis, float z, float r);
+	void endWindow(void);
+
+public:
+	BiasEstimator();
+
+	void reset(float temp);
+	void setTemperature(float temp);
+	void update(const float *gyro, const float *acc, const float *accAngle, bool onGround, float dt);
+
+	float getGyroBias(uint8_t axis);
+	float getSlope(uint8_t axis);
+	float getAccOffset(uint8_t axis);
+	uint32_t getStillWindows(void);
+};
+
+#endif
+
+/** @} Close IMUCAL group */
+/** @} Close Sensors Group */
@@ -0,0 +1,43 @@
+/**
+ * @file
+ *
+ * @brief Deferred-formatting binary logger
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup BINLOG
+ *  @{
+ */
+
+#include "BinLog.h"
+#include "CycleCounter.h"
+#include "stm32f407xx.h"
+
+/**
+ * @brief Start the cycle counter used for time stamps
+ *
+ * Leaves it running if it already is, so time stamps share a time base
+ * with the i2c statistics.
+ */
+void BinLog::init(void) {
+	cycleCounterInit();
+}
+
+/**
+ * @brief Get the time stamp for an entry
+ * @return DWT cycle count
+ */
+uint32_t BinLog::now(void) {
+	return DWT->CYCCNT;
+}
+
+/** @} Close BINLOG group */
+/** @} Close System group */
@@ -0,0 +1,207 @@
+/**
+ * @file
+ *
+ * @brief Deferred-formatting binary logger
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * A call site stores a message id from LogMessages.h, a cycle count and the
+ * raw 32-bit arguments, e.g.
+ *
+ * 		binlog<LogMsg::GYRO_X>(x);
+ *
+ * Nothing is formatted on the target. The argument count and types are
+ * checked against the format string at compile time. BinLog::drain() sends
+ * the entries as TelemetryId::TRACE frames and pi-station/binlog2text.py
+ * turns them back into text.
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @defgroup BINLOG Binary logger
+ *  @brief Log entries stored as ids and raw arguments, formatted on the host
+ *  @{
+ */
+
+#ifndef BINLOG_H_
+#define BINLOG_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include "LogMessages.h"
+
+#define BINLOG_WORDS		1024		///< Ring size [32-bit words] (power of 2)
+#define BINLOG_MAX_ARGS		8			///< Arguments per entry
+#define BINLOG_HEADER		2			///< Header words per entry: id, cycle count
+#define BINLOG_MARK			0xA5000000u	///< Top byte of a committed header word
+
+/**
+ * @brief Message ids, in LogMessages.h order
+ */
+#define LOG_MSG_ID(id, cat, level, fmt) id,
+enum class LogMsg : uint16_t {
+	LOG_MESSAGES(LOG_MSG_ID)
+	NUM_MESSAGES
+};
+#undef LOG_MSG_ID
+
+/**
+ * @brief One entry as read back from the ring
+ */
+typedef struct {
+	uint16_t id;						///< LogMsg
+	uint8_t nArgs;						///< Number of arguments
+	uint32_t time;						///< DWT cycle count when logged
+	uint32_t args[BINLOG_MAX_ARGS];		///< Raw arguments
+} BinLogEntry;
+
+/**
+ * @brief Lock-free ring of log entries
+ *
+ * Any number of producers (main loop and interrupts) reserve space with a
+ * compare-exchange (LDREX/STREX), so logging never masks interrupts. An entry is committed by
+ * writing its header word last. One consumer, the main loop, reads entries
+ * in order and stops at the first one still being written.
+ *
+ * All members are static so interrupts can log before anything else is set
+ * up.
+ */
+class BinLog {
+private:
+	static uint32_t ring[BINLOG_WORDS];		///< Entries
+	static volatile uint32_t head;			///< Words reserved (free-running)
+	static volatile uint32_t tail;			///< Words consumed (free-running)
+	static volatile uint32_t dropped;		///< Entries refused on a full ring
+
+	static int16_t peekSize(void);
+	static uint32_t now(void);
+
+public:
+	static void init(void);
+
+	static bool write(LogMsg id, const uint32_t *args, uint8_t n);
+	static bool read(BinLogEntry *e);
+	static void drain(uint8_t maxFrames);
+
+	static uint32_t getDropped(void);
+};
+
+/*
+ * Compile-time format checking
+ */
+
+#define LOG_MSG_FORMAT(id, cat, level, fmt) fmt,
+static constexpr const char *const logFormats[] = {
+	LOG_MESSAGES(LOG_MSG_FORMAT)
+};
+#undef LOG_MSG_FORMAT
+
+/**
+ * @brief Find the next conversion
+ * @return Pointer just past its '%', or to the terminating NUL
+ */
+constexpr const char *binlogNextConv(const char *f) {
+	return (*f == 0) ? f :
+		(f[0] == '%' && f[1] == '%') ? binlogNextConv(f + 2) :
+		(f[0] == '%') ? f + 1 : binlogNextConv(f + 1);
+}
+
+/**
+ * @brief Get a conversion's letter, skipping flags, width and precision
+ */
+constexpr char binlogConvChar(const char *p) {
+	return (*p == 0) ? 0 :
+		((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z')) ? *p : binlogConvChar(p + 1);
+}
+
+/**
+ * @brief Count the conversions in a format
+ */
+constexpr uint8_t binlogCountArgs(const char *f) {
+	return (*binlogNextConv(f) == 0) ? 0 : 1 + binlogCountArgs(binlogNextConv(f));
+}
+
+/**
+ * @brief Get the letter of conversion k of a format
+ */
+constexpr char binlogSpec(const char *f, uint8_t k) {
+	return (k == 0) ? binlogConvChar(binlogNextConv(f)) : binlogSpec(binlogNextConv(f), k - 1);
+}
+
+/**
+ * @brief How an argument type is stored. Types without a specialization
+ * (double, 64-bit integers, pointers) don't compile.
+ */
+template<typename T, typename Enable = void>
+struct BinLogArg;
+
+template<>
+struct BinLogArg<float> {
+	static constexpr bool fits(char c) { return c == 'f' || c == 'e' || c == 'g'; }
+	static uint32_t word(float x) { uint32_t w; memcpy(&w, &x, sizeof(w)); return w; }
+};
+
+template<typename T>
+struct BinLogArg<T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) <= 4>::type> {
+	static constexpr bool fits(char c) { return c == 'd' || c == 'i'; }
+	static uint32_t word(T x) { return (uint32_t)(int32_t)x; }
+};
+
+template<typename T>
+struct BinLogArg<T, typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value && sizeof(T) <= 4>::type> {
+	static constexpr bool fits(char c) { return c == 'u' || c == 'x' || c == 'X'; }
+	static uint32_t word(T x) { return (uint32_t)x; }
+};
+
+template<LogMsg ID, uint8_t K>
+constexpr bool binlogTypesOk() {
+	return true;
+}
+
+template<LogMsg ID, uint8_t K, typename T, typename... Rest>
+constexpr bool binlogTypesOk() {
+	return BinLogArg<T>::fits(binlogSpec(logFormats[(uint16_t)ID], K)) && binlogTypesOk<ID, K + 1, Rest...>();
+}
+
+/**
+ * @brief Check a message's arguments against its format. Naming ok
+ * instantiates the checks.
+ */
+template<LogMsg ID, typename... Args>
+struct BinLogCheck {
+	static_assert(sizeof...(Args) <= BINLOG_MAX_ARGS, "Too many log arguments");
+	static_assert(binlogCountArgs(logFormats[(uint16_t)ID]) == sizeof...(Args),
+			"Argument count doesn't match the LogMessages.h format");
+	static_assert(binlogTypesOk<ID, 0, Args...>(),
+			"Argument type doesn't match the LogMessages.h format");
+
+	static constexpr bool ok = true;
+};
+
+/**
+ * @brief Log a message
+ * @param args Arguments for the message's format
+ * @return false if the ring was full
+ *
+ * Costs a few tens of cycles and is safe from interrupts. This always logs;
+ * code normally goes through logMsg() (Log.h), which honours categories and
+ * levels.
+ */
+template<LogMsg ID, typename... Args>
+inline bool binlog(Args... args) {
+	static_assert(BinLogCheck<ID, Args...>::ok, "Bad log arguments");
+
+	const uint32_t words[sizeof...(Args) + 1] = { BinLogArg<Args>::word(args)..., 0 };
+	return BinLog::write(ID, words, sizeof...(Args));
+}
+
+#endif
+
+/** @} Close BINLOG group */
+/** @} Close System group */
@@ -0,0 +1,176 @@
+/**
+ * @file
+ *
+ * @brief Binary log ring and its TRACE frames
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * The parts of BinLog that store, read and send entries. They make no HAL
+ * calls, so they can be run on a host (tests/test_binlog.cpp); the time stamp
+ * comes from BinLog::now().
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup BINLOG
+ *  @{
+ */
+
+#include "BinLog.h"
+#include "Telemetry.h"
+#include "uart.h"
+
+#define BINLOG_MASK	(BINLOG_WORDS - 1)
+
+uint32_t BinLog::ring[BINLOG_WORDS];
+volatile uint32_t BinLog::head = 0;
+volatile uint32_t BinLog::tail = 0;
+volatile uint32_t BinLog::dropped = 0;
+
+/**
+ * @brief Store an entry
+ * @param id   Message id
+ * @param args Raw arguments
+ * @param n    Number of arguments, up to BINLOG_MAX_ARGS
+ * @return false if the ring was full
+ *
+ * Use binlog() rather than calling this directly, it checks the arguments
+ * against the message format.
+ */
+bool BinLog::write(LogMsg id, const uint32_t *args, uint8_t n) {
+	uint32_t need = BINLOG_HEADER + n;
+	uint32_t h = head;
+
+	if (n > BINLOG_MAX_ARGS) {
+		return false;
+	}
+
+	// Reserve the words. The weak compare-exchange is one LDREX/STREX pair on
+	// the Cortex-M4; an interrupt logging in between makes it fail, and we
+	// try again after it with the new head.
+	do {
+		if (h + need - tail > BINLOG_WORDS) {
+			__atomic_fetch_add(&dropped, 1, __ATOMIC_RELAXED);
+			return false;
+		}
+	} while (!__atomic_compare_exchange_n(&head, &h, h + need, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	ring[(h + 1) & BINLOG_MASK] = now();
+	for (uint8_t i = 0; i < n; i++) {
+		ring[(h + BINLOG_HEADER + i) & BINLOG_MASK] = args[i];
+	}
+
+	// Commit - the consumer must see the arguments before the header
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	ring[h & BINLOG_MASK] = BINLOG_MARK | ((uint32_t)n << 16) | (uint16_t)id;
+
+	return true;
+}
+
+/**
+ * @brief Get the encoded size of the next entry
+ * @return TRACE payload bytes, 0 if no committed entry is waiting
+ */
+int16_t BinLog::peekSize(void) {
+	uint32_t t = tail;
+
+	if (t == head) {
+		return 0;
+	}
+
+	uint32_t hdr = ring[t & BINLOG_MASK];
+	if ((hdr & 0xFF000000u) != BINLOG_MARK) {
+		// Reserved, but its producer hasn't finished writing it
+		return 0;
+	}
+
+	return 7 + 4 * ((hdr >> 16) & 0xFF);
+}
+
+/**
+ * @brief Take the oldest entry
+ * @param e Returns the entry
+ * @return false if no committed entry is waiting
+ *
+ * Main loop only.
+ */
+bool BinLog::read(BinLogEntry *e) {
+	uint32_t t = tail;
+
+	if (peekSize() == 0) {
+		return false;
+	}
+
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	uint32_t hdr = ring[t & BINLOG_MASK];
+	uint8_t n = (hdr >> 16) & 0xFF;
+
+	e->id = (uint16_t)hdr;
+	e->nArgs = n;
+	e->time = ring[(t + 1) & BINLOG_MASK];
+	for (uint8_t i = 0; i < n && i < BINLOG_MAX_ARGS; i++) {
+		e->args[i] = ring[(t + BINLOG_HEADER + i) & BINLOG_MASK];
+	}
+
+	// Free the words. The header is cleared first so the slot never looks
+	// committed once a producer reuses it.
+	ring[t & BINLOG_MASK] = 0;
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	tail = t + BINLOG_HEADER + n;
+
+	return true;
+}
+
+/**
+ * @brief Send waiting entries as TelemetryId::TRACE frames
+ * @param maxFrames Most frames to queue in this call
+ *
+ * Each frame carries as many whole entries as fit. Nothing is sent unless the
+ * UART is idle, so flight telemetry always goes first and entries wait in the
+ * ring rather than being lost on a full TX queue. Call from the background
+ * part of the loop.
+ */
+void BinLog::drain(uint8_t maxFrames) {
+	Telemetry *telem = Telemetry::Instance();
+	BinLogEntry e;
+
+	if (!usart_tx_idle()) {
+		return;
+	}
+
+	while (maxFrames > 0 && peekSize() > 0) {
+		TelemetryFrame frame(TelemetryId::TRACE, telem->nextSeq());
+		uint16_t used = 0;
+		int16_t size;
+
+		while ((size = peekSize()) > 0 && used + size <= TELEM_MAX_PAYLOAD) {
+			read(&e);
+			frame.putU16(e.id);
+			frame.putU8(e.nArgs);
+			frame.putU32(e.time);
+			for (uint8_t i = 0; i < e.nArgs; i++) {
+				frame.putU32(e.args[i]);
+			}
+			used += size;
+		}
+
+		telem->send(frame);
+		maxFrames--;
+	}
+}
+
+/**
+ * @brief Get the number of entries lost
+ * @return Entries refused because the ring was full
+ */
+uint32_t BinLog::getDropped(void) {
+	return dropped;
+}
+
+/** @} Close BINLOG group */
+/** @} Close System group */
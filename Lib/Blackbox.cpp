@@ -0,0 +1,404 @@
+/**
+ * @file
+ *
+ * @brief Flight recorder with a compact delta-encoded page format
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup BLACKBOX
+ *  @{
+ */
+
+#include "Blackbox.h"
+#include "Framing.h"
+#include <string.h>
+#include <math.h>
+
+#define BLACKBOX_MAX_RECORD	(1 + 5 * BLACKBOX_MAX_FIELDS)	///< Type + worst case varints
+
+/**
+ * @brief Scale a value to its recorded integer
+ * @param x     Value
+ * @param scale Counts per unit
+ * @return Rounded, saturated count. NaN records as 0.
+ */
+static int32_t blackboxQuantize(float x, float scale) {
+	float q = x * scale;
+
+	if (q != q) return 0;
+	if (q > 2.0e9f) return 2000000000;
+	if (q < -2.0e9f) return -2000000000;
+
+	return (int32_t)lroundf(q);
+}
+
+/**
+ * @brief Append an unsigned LEB128 varint
+ * @param p Output
+ * @param x Value
+ * @return Bytes written, 1 to 5
+ */
+static uint16_t blackboxPutVarint(uint8_t *p, uint32_t x) {
+	uint16_t n = 0;
+
+	while (x >= 0x80) {
+		p[n++] = (uint8_t)(x | 0x80);
+		x >>= 7;
+	}
+	p[n++] = (uint8_t)x;
+
+	return n;
+}
+
+/**
+ * @brief Append a signed varint, zigzag encoded so small magnitudes stay short
+ * @param p Output
+ * @param x Value
+ * @return Bytes written, 1 to 5
+ */
+static uint16_t blackboxPutSigned(uint8_t *p, int32_t x) {
+	return blackboxPutVarint(p, ((uint32_t)x << 1) ^ (uint32_t)(x >> 31));
+}
+
+/**
+ * @brief Create a recorder over a storage area
+ * @param storage    Start of the storage, readable as memory
+ * @param bytes      Storage size, a multiple of BLACKBOX_PAGE_SIZE
+ * @param storageOps Program/erase functions for the storage
+ *
+ * Finds the end of the data already stored, so new sessions are appended.
+ */
+Blackbox::Blackbox(const volatile uint8_t *storage, uint32_t bytes, BlackboxStorageOps storageOps) {
+	base = storage;
+	size = bytes;
+	ops = storageOps;
+
+	fields = 0;
+	nFields = 0;
+	key = true;
+
+	head = tail = 0;
+	fill = 0;
+	progWord = 0;
+	dropped = 0;
+
+	scan();
+}
+
+/**
+ * @brief Find the first unwritten page in storage
+ *
+ * A page is written once its first word is. A page cut short by a power loss
+ * counts as written; its CRC makes the decoder skip it.
+ */
+void Blackbox::scan(void) {
+	pageSeq = 0;
+
+	for (wr = 0; wr + BLACKBOX_PAGE_SIZE <= size; wr += BLACKBOX_PAGE_SIZE) {
+		const volatile uint8_t *p = base + wr;
+
+		if (p[0] == 0xFF && p[1] == 0xFF && p[2] == 0xFF && p[3] == 0xFF) {
+			break;
+		}
+		pageSeq = (uint16_t)(p[6] | (p[7] << 8)) + 1;
+	}
+}
+
+/**
+ * @brief Erase the storage
+ * @return false on a storage error
+ *
+ * Blocks for as long as the storage takes, seconds for internal flash. Pages
+ * still waiting in RAM are discarded.
+ */
+bool Blackbox::erase(void) {
+	tail = head;
+	progWord = 0;
+
+	if (!ops.erase()) {
+		return false;
+	}
+
+	wr = 0;
+	pageSeq = 0;
+	return true;
+}
+
+/**
+ * @brief Start a recording session
+ * @param f Fields recorded by each record(), kept by pointer
+ * @param n Number of fields, up to BLACKBOX_MAX_FIELDS
+ * @return false if the session header doesn't fit or there is no room
+ *
+ * The session header starts a new page.
+ */
+bool Blackbox::begin(const BlackboxField *f, uint8_t n) {
+	uint8_t rec[BLACKBOX_PAGE_PAYLOAD];
+	uint16_t len = 0;
+
+	end();
+
+	if (n == 0 || n > BLACKBOX_MAX_FIELDS) {
+		return false;
+	}
+
+	rec[len++] = 'H';
+	rec[len++] = BLACKBOX_VERSION;
+	rec[len++] = n;
+	for (uint8_t i = 0; i < n; i++) {
+		uint16_t nameLen = strlen(f[i].name) + 1;
+
+		if (len + nameLen + 5 > BLACKBOX_PAGE_PAYLOAD) {
+			return false;
+		}
+		memcpy(&rec[len], f[i].name, nameLen);
+		len += nameLen;
+		len += blackboxPutVarint(&rec[len], (uint32_t)lroundf(f[i].scale));
+	}
+
+	if (!append(rec, len)) {
+		dropped++;
+		return false;
+	}
+
+	fields = f;
+	nFields = n;
+	key = true;
+	return true;
+}
+
+/**
+ * @brief Record one set of values
+ * @param values One value per field, in the order given to begin()
+ * @return false if outside a session or the RAM pages are all full
+ *
+ * Writes a delta record, or a keyframe at the start of a page.
+ */
+bool Blackbox::record(const float *values) {
+	uint8_t rec[BLACKBOX_MAX_RECORD];
+	int32_t q[BLACKBOX_MAX_FIELDS];
+	uint16_t len;
+
+	if (nFields == 0) {
+		return false;
+	}
+
+	for (uint8_t i = 0; i < nFields; i++) {
+		q[i] = blackboxQuantize(values[i], fields[i].scale);
+	}
+
+	// Changes from the last record, if they fit in the open page
+	if (fill > 0 && !key) {
+		len = 0;
+		rec[len++] = 'P';
+		for (uint8_t i = 0; i < nFields; i++) {
+			len += blackboxPutSigned(&rec[len], (int32_t)((uint32_t)q[i] - (uint32_t)prev[i]));
+		}
+
+		if (fill + len <= BLACKBOX_PAGE_PAYLOAD) {
+			append(rec, len);
+			memcpy(prev, q, nFields * sizeof(q[0]));
+			return true;
+		}
+
+		closePage();
+	}
+
+	// Keyframe
+	len = 0;
+	rec[len++] = 'I';
+	for (uint8_t i = 0; i < nFields; i++) {
+		len += blackboxPutSigned(&rec[len], q[i]);
+	}
+
+	if (!append(rec, len)) {
+		dropped++;
+		key = true;
+		return false;
+	}
+
+	key = false;
+	memcpy(prev, q, nFields * sizeof(q[0]));
+	return true;
+}
+
+/**
+ * @brief End the session
+ *
+ * Closes the partly filled page so service() writes it out.
+ */
+void Blackbox::end(void) {
+	closePage();
+	nFields = 0;
+}
+
+/**
+ * @brief Add a record to the open page
+ * @param rec Record bytes
+ * @param n   Record length, at most BLACKBOX_PAGE_PAYLOAD
+ * @return false if a new page was needed and the RAM pages are all full
+ */
+bool Blackbox::append(const uint8_t *rec, uint16_t n) {
+	if (fill + n > BLACKBOX_PAGE_PAYLOAD) {
+		closePage();
+	}
+
+	// A new page needs a free slot in the ring
+	if (fill == 0 && (uint8_t)(head - tail) >= BLACKBOX_RAM_PAGES) {
+		return false;
+	}
+
+	memcpy(&pages[head % BLACKBOX_RAM_PAGES][BLACKBOX_PAGE_HEADER + fill], rec, n);
+	fill += n;
+	return true;
+}
+
+/**
+ * @brief Finish the open page and queue it for service()
+ */
+void Blackbox::closePage(void) {
+	if (fill == 0) {
+		return;
+	}
+
+	uint8_t *p = pages[head % BLACKBOX_RAM_PAGES];
+	uint16_t crc = crc16Ccitt(&p[BLACKBOX_PAGE_HEADER], fill);
+
+	p[0] = (uint8_t)BLACKBOX_MAGIC;
+	p[1] = (uint8_t)(BLACKBOX_MAGIC >> 8);
+	p[2] = (uint8_t)fill;
+	p[3] = (uint8_t)(fill >> 8);
+	p[4] = (uint8_t)crc;
+	p[5] = (uint8_t)(crc >> 8);
+	p[6] = (uint8_t)pageSeq;
+	p[7] = (uint8_t)(pageSeq >> 8);
+	pageSeq++;
+
+	// Pad the last word as erased
+	while ((BLACKBOX_PAGE_HEADER + fill) % 4) {
+		p[BLACKBOX_PAGE_HEADER + fill++] = 0xFF;
+	}
+
+	head++;
+	fill = 0;
+}
+
+/**
+ * @brief Program one word of the oldest queued page
+ * @return false if nothing is queued
+ *
+ * The first header word goes first, the CRC word last. A page cut short is
+ * then both marked as used and fails its CRC. Unused payload words are left
+ * erased.
+ */
+bool Blackbox::programNext(void) {
+	if (head == tail) {
+		return false;
+	}
+
+	const uint8_t *p = pages[tail % BLACKBOX_RAM_PAGES];
+	uint16_t payloadWords = ((uint16_t)(p[2] | (p[3] << 8)) + 3) / 4;
+	uint16_t word;
+
+	if (wr + BLACKBOX_PAGE_SIZE > size) {
+		// Storage full
+		dropped++;
+		tail++;
+		return true;
+	}
+
+	if (progWord == 0) {
+		word = 0;
+	} else if (progWord <= payloadWords) {
+		word = progWord + 1;
+	} else {
+		word = 1;
+	}
+
+	const uint8_t *w = &p[word * 4];
+	uint32_t x = (uint32_t)w[0] | ((uint32_t)w[1] << 8) | ((uint32_t)w[2] << 16) | ((uint32_t)w[3] << 24);
+	bool ok = ops.program(wr + word * 4, x);
+
+	if (!ok || word == 1) {
+		// Done, or abandon the page - its slot is used either way
+		if (!ok) {
+			dropped++;
+		}
+		wr += BLACKBOX_PAGE_SIZE;
+		progWord = 0;
+		tail++;
+	} else {
+		progWord++;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Write queued pages to storage
+ * @param maxWords Most words to program in this call, bounds the time spent
+ * @return true while pages are still queued
+ *
+ * Programming internal flash stalls instruction fetch (~16 us per word) for
+ * the whole chip, interrupts included, so only call this while a stall is
+ * harmless, e.g. disarmed.
+ */
+bool Blackbox::service(uint16_t maxWords) {
+	while (maxWords > 0 && programNext()) {
+		maxWords--;
+	}
+
+	return head != tail;
+}
+
+/**
+ * @brief Check that everything recorded is in storage
+ * @return true if no page is open or queued
+ */
+bool Blackbox::isIdle(void) {
+	return head == tail && fill == 0;
+}
+
+/**
+ * @brief Check for an open session
+ * @return true between a successful begin() and end()
+ */
+bool Blackbox::isRecording(void) {
+	return nFields > 0;
+}
+
+/**
+ * @brief Get the amount of storage written
+ * @return Bytes, a whole number of pages
+ */
+uint32_t Blackbox::getUsed(void) {
+	return wr;
+}
+
+/**
+ * @brief Get the storage size
+ * @return Bytes
+ */
+uint32_t Blackbox::getSize(void) {
+	return size;
+}
+
+/**
+ * @brief Get the number of records and pages lost
+ * @return Records refused because the RAM pages were full, plus pages
+ * dropped because the storage was full or failed
+ */
+uint32_t Blackbox::getDropped(void) {
+	return dropped;
+}
+
+/** @} Close BLACKBOX group */
+/** @} Close System group */
@@ -0,0 +1,135 @@
+/**
+ * @file
+ *
+ * @brief Flight recorder with a compact delta-encoded page format
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Storage is written in pages of BLACKBOX_PAGE_SIZE bytes:
+ * 		- [0..1] BLACKBOX_MAGIC
+ * 		- [2..3] Payload length n
+ * 		- [4..5] CRC-16/CCITT of the payload
+ * 		- [6..7] Page sequence number
+ * 		- [8..]  n bytes of records. Records never span pages.
+ *
+ * Every record starts with its type byte:
+ * 		- 'H' Session header: u8 version, u8 field count, then per field its
+ * 		      name (NUL terminated) and varint scale [counts per unit]
+ * 		- 'I' Keyframe: one zigzag varint per field, the scaled value
+ * 		- 'P' One zigzag varint per field, the change from the last record
+ *
+ * The first record of every page is an H or an I, so a page lost to a power
+ * cut only loses its own records. pi-station/blackbox2csv.py converts a dump
+ * of the storage to CSV.
+ *
+ * Does not touch hardware. Program and erase are passed in, so the same code
+ * runs against the STM32 flash or a simulated storage on a host.
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @defgroup BLACKBOX Flight recorder
+ *  @brief Full-rate flight state recorded to flash
+ *  @{
+ */
+
+#ifndef BLACKBOX_H_
+#define BLACKBOX_H_
+
+#include <stdint.h>
+
+#define BLACKBOX_VERSION		1		///< Record format version
+#define BLACKBOX_MAGIC			0xB10Cu	///< First half-word of a written page
+#define BLACKBOX_PAGE_SIZE		512		///< Bytes per page, multiple of 4
+#define BLACKBOX_PAGE_HEADER	8		///< Page header bytes
+#define BLACKBOX_PAGE_PAYLOAD	(BLACKBOX_PAGE_SIZE - BLACKBOX_PAGE_HEADER)
+#define BLACKBOX_RAM_PAGES		64		///< Pages buffered in RAM (power of 2, at most 128)
+#define BLACKBOX_MAX_FIELDS		40		///< Fields per record
+
+/**
+ * @brief Description of one recorded value
+ */
+typedef struct {
+	const char *name;	///< Column name, short - the session header has to fit one page
+	float scale;		///< Counts per unit, sets the resolution
+} BlackboxField;
+
+/**
+ * @brief Storage access for Blackbox
+ *
+ * program() writes one 32-bit word that is currently erased, at a byte
+ * offset from the start of the storage. erase() erases all of it. Both
+ * return false on a hardware error.
+ */
+typedef struct {
+	bool (*program)(uint32_t offset, uint32_t word);
+	bool (*erase)(void);
+} BlackboxStorageOps;
+
+/**
+ * @brief Flight recorder
+ *
+ * record() runs in the control loop. It only quantizes and encodes into a
+ * RAM page, a few microseconds. Full pages wait in a ring of
+ * BLACKBOX_RAM_PAGES until service() programs them, a bounded number of
+ * words per call. Programming internal flash stalls the whole chip,
+ * interrupts included, so the caller should only call service() when that
+ * is safe (fly() does so while disarmed). Records that don't fit in the ring
+ * until then are dropped and counted.
+ *
+ * Sessions (begin() to end()) are appended after whatever is already stored.
+ * When the storage is full, new pages are dropped until erase().
+ */
+class Blackbox {
+private:
+	const volatile uint8_t *base;				///< Storage, memory mapped for reading
+	uint32_t size;								///< Storage size [bytes]
+	BlackboxStorageOps ops;						///< Storage program/erase
+
+	const BlackboxField *fields;				///< Fields of the current session
+	uint8_t nFields;							///< Number of fields, 0 outside a session
+	int32_t prev[BLACKBOX_MAX_FIELDS];			///< Last recorded scaled values
+	bool key;									///< Next record must be a keyframe
+
+	uint8_t pages[BLACKBOX_RAM_PAGES][BLACKBOX_PAGE_SIZE];	///< Page ring
+	uint8_t head;								///< Pages closed (free-running)
+	uint8_t tail;								///< Pages written (free-running)
+	uint16_t fill;								///< Payload bytes in the open page
+	uint16_t progWord;							///< Progress through the page at tail
+
+	uint32_t wr;								///< Storage offset of the next page
+	uint16_t pageSeq;							///< Sequence number of the next page
+	uint32_t dropped;							///< Records and pages lost
+
+	bool append(const uint8_t *rec, uint16_t n);
+	void closePage(void);
+	bool programNext(void);
+
+public:
+	Blackbox(const volatile uint8_t *storage, uint32_t bytes, BlackboxStorageOps storageOps);
+
+	void scan(void);
+	bool erase(void);
+
+	bool begin(const BlackboxField *f, uint8_t n);
+	bool record(const float *values);
+	void end(void);
+
+	bool service(uint16_t maxWords);
+	bool isIdle(void);
+	bool isRecording(void);
+
+	uint32_t getUsed(void);
+	uint32_t getSize(void);
+	uint32_t getDropped(void);
+};
+
+#endif
+
+/** @} Close BLACKBOX group */
+/** @} Close System group */
@@ -0,0 +1,65 @@
+/**
+ * @file
+ *
+ * @brief Flight recorder storage in internal flash
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup BLACKBOX
+ *  @{
+ */
+
+#include "BlackboxFlash.h"
+
+/**
+ * @brief Unlock the flash and clear errors left by earlier operations
+ */
+static void blackboxFlashUnlock(void) {
+	HAL_FLASH_Unlock();
+	__HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR |
+			FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+}
+
+/**
+ * @brief BlackboxStorageOps::program for the recorder sectors
+ */
+static bool blackboxFlashProgram(uint32_t offset, uint32_t word) {
+	blackboxFlashUnlock();
+	HAL_StatusTypeDef status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, BLACKBOX_FLASH_ADDR + offset, word);
+	HAL_FLASH_Lock();
+
+	return status == HAL_OK;
+}
+
+/**
+ * @brief BlackboxStorageOps::erase for the recorder sectors
+ */
+static bool blackboxFlashErase(void) {
+	FLASH_EraseInitTypeDef erase;
+	uint32_t sectorError;
+
+	erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+	erase.Banks = 0;
+	erase.Sector = BLACKBOX_FLASH_FIRST_SECTOR;
+	erase.NbSectors = BLACKBOX_FLASH_SECTORS;
+	erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+	blackboxFlashUnlock();
+	HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&erase, &sectorError);
+	HAL_FLASH_Lock();
+
+	return status == HAL_OK;
+}
+
+const BlackboxStorageOps blackboxFlashOps = { blackboxFlashProgram, blackboxFlashErase };
+
+/** @} Close BLACKBOX group */
+/** @} Close System group */
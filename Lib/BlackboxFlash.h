@@ -0,0 +1,41 @@
+/**
+ * @file
+ *
+ * @brief Flight recorder storage in internal flash
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup BLACKBOX
+ *  @{
+ */
+
+#ifndef BLACKBOXFLASH_H_
+#define BLACKBOXFLASH_H_
+
+#include "stm32f4xx_hal.h"
+#include "Blackbox.h"
+
+/*
+ * Flash sectors 8 & 9 (128 KB each) hold the flight recorder. mem.ld stops
+ * the FLASH region at 512K so code never lands in them. Read a dump with
+ * "st-flash read dump.bin 0x08080000 0x40000".
+ */
+#define BLACKBOX_FLASH_ADDR			0x08080000u
+#define BLACKBOX_FLASH_SIZE			0x40000u
+#define BLACKBOX_FLASH_FIRST_SECTOR	FLASH_SECTOR_8
+#define BLACKBOX_FLASH_SECTORS		2
+
+extern const BlackboxStorageOps blackboxFlashOps;
+
+#endif
+
+/** @} Close BLACKBOX group */
+/** @} Close System group */
@@ -0,0 +1,273 @@
+/**
+ * @file
+ *
+ * @brief Cascaded angle and rate control
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @defgroup CASCADE Cascaded attitude control
+ *  @brief Outer angle loops feeding inner gyro rate loops
+ *  @{
+ */
+
+#include "CascadeControl.h"
+
+/**
+ * @brief Create a controller with all gains 0
+ *
+ * Set the gains with setAngleGains() and setRateGains() before use.
+ */
+CascadeControl::CascadeControl()
+	: anglePid{ pid3(0.0f, 0.0f, 0.0f), pid3(0.0f, 0.0f, 0.0f) },
+	  ratePid{ pid3(0.0f, 0.0f, 0.0f), pid3(0.0f, 0.0f, 0.0f), pid3(0.0f, 0.0f, 0.0f) }
+{
+	for (uint8_t i = 0; i < CONTROL_AXES; i++) {
+		rateSp[i] = 0.0f;
+		output[i] = 0.0f;
+	}
+	setRateLimit(0.0f);
+}
+
+/**
+ * @brief Change an angle loop's gains
+ * @param axis ControlAxis::ROLL or PITCH
+ * @param p    Proportional gain [deg/s per deg]
+ * @param i    Integral gain
+ * @param d    Derivative gain
+ */
+void CascadeControl::setAngleGains(ControlAxis axis, float p, float i, float d) {
+	if ((uint8_t)axis < CONTROL_ANGLE_AXES) {
+		anglePid[(uint8_t)axis].setGains(p, i, d);
+	}
+}
+
+/**
+ * @brief Change a rate loop's gains
+ * @param axis Axis
+ * @param p    Proportional gain [command per deg/s]
+ * @param i    Integral gain
+ * @param d    Derivative gain
+ */
+void CascadeControl::setRateGains(ControlAxis axis, float p, float i, float d) {
+	if ((uint8_t)axis < CONTROL_AXES) {
+		ratePid[(uint8_t)axis].setGains(p, i, d);
+	}
+}
+
+/**
+ * @brief Change a rate loop's setpoint feed-forward
+ * @param axis Axis
+ * @param kff  Command per deg/s of rate setpoint
+ */
+void CascadeControl::setFeedForward(ControlAxis axis, float kff) {
+	if ((uint8_t)axis < CONTROL_AXES) {
+		ratePid[(uint8_t)axis].setFeedForward(kff);
+	}
+}
+
+/**
+ * @brief Change a rate loop's output limit
+ * @param axis Axis
+ * @param max  Largest command either way, in rate loop output units
+ */
+void CascadeControl::setOutputLimit(ControlAxis axis, float max) {
+	if ((uint8_t)axis < CONTROL_AXES) {
+		ratePid[(uint8_t)axis].setLimits(-max, max);
+	}
+}
+
+/**
+ * @brief Change the largest rate setpoint
+ * @param maxRate Largest rate setpoint either way, all axes [deg/s]
+ */
+void CascadeControl::setRateLimit(float maxRate) {
+	for (uint8_t i = 0; i < CONTROL_ANGLE_AXES; i++) {
+		anglePid[i].setLimits(-maxRate, maxRate);
+	}
+	rateLimit = maxRate;
+}
+
+/**
+ * @brief Change the derivative filter of every loop
+ * @param hz Cut-off frequency [Hz], 0 for no filter
+ */
+void CascadeControl::setDerivativeCutoff(float hz) {
+	for (uint8_t i = 0; i < CONTROL_ANGLE_AXES; i++) {
+		anglePid[i].setDerivativeCutoff(hz);
+	}
+	for (uint8_t i = 0; i < CONTROL_AXES; i++) {
+		ratePid[i].setDerivativeCutoff(hz);
+	}
+}
+
+/**
+ * @brief Change the anti-windup back-calculation gain of every loop
+ * @param kt Gain [1/s]
+ */
+void CascadeControl::setBackCalculation(float kt) {
+	for (uint8_t i = 0; i < CONTROL_ANGLE_AXES; i++) {
+		anglePid[i].setBackCalculation(kt);
+	}
+	for (uint8_t i = 0; i < CONTROL_AXES; i++) {
+		ratePid[i].setBackCalculation(kt);
+	}
+}
+
+/**
+ * @brief Clear every loop, e.g. while disarmed
+ * @param roll      Measured roll angle [deg]
+ * @param pitch     Measured pitch angle [deg]
+ * @param rollRate  Measured roll rate [deg/s]
+ * @param pitchRate Measured pitch rate [deg/s]
+ * @param yawRate   Measured yaw rate [deg/s]
+ */
+void CascadeControl::reset(float roll, float pitch, float rollRate, float pitchRate, float yawRate) {
+	anglePid[(uint8_t)ControlAxis::ROLL].reset(roll);
+	anglePid[(uint8_t)ControlAxis::PITCH].reset(pitch);
+	ratePid[(uint8_t)ControlAxis::ROLL].reset(rollRate);
+	ratePid[(uint8_t)ControlAxis::PITCH].reset(pitchRate);
+	ratePid[(uint8_t)ControlAxis::YAW].reset(yawRate);
+
+	for (uint8_t i = 0; i < CONTROL_AXES; i++) {
+		rateSp[i] = 0.0f;
+		output[i] = 0.0f;
+	}
+}
+
+/**
+ * @brief Limit a rate setpoint to +/- rateLimit
+ */
+float CascadeControl::clampRate(float r) {
+	if (r > rateLimit) return rateLimit;
+	if (r < -rateLimit) return -rateLimit;
+	return r;
+}
+
+/**
+ * @brief Run the roll and pitch angle loops
+ * @param rollCmd  Commanded roll angle [deg]
+ * @param pitchCmd Commanded pitch angle [deg]
+ * @param roll     Measured roll angle [deg]
+ * @param pitch    Measured pitch angle [deg]
+ * @param dt       Time since the last angleLoop() [s]
+ *
+ * Sets the roll and pitch rate setpoints used by the following rateLoop()s.
+ */
+void CascadeControl::angleLoop(float rollCmd, float pitchCmd, float roll, float pitch, float dt) {
+	rateSp[(uint8_t)ControlAxis::ROLL] = anglePid[(uint8_t)ControlAxis::ROLL].calculate(rollCmd, roll, dt);
+	rateSp[(uint8_t)ControlAxis::PITCH] = anglePid[(uint8_t)ControlAxis::PITCH].calculate(pitchCmd, pitch, dt);
+}
+
+/**
+ * @brief Set the yaw rate setpoint
+ * @param rate Commanded yaw rate [deg/s]
+ */
+void CascadeControl::setYawRate(float rate) {
+	rateSp[(uint8_t)ControlAxis::YAW] = clampRate(rate);
+}
+
+/**
+ * @brief Run the rate loops
+ * @param roll  Measured roll rate [deg/s]
+ * @param pitch Measured pitch rate [deg/s]
+ * @param yaw   Measured yaw rate [deg/s]
+ * @param dt    Time since the last rateLoop() [s]
+ *
+ * The commands are read back with getOutput().
+ */
+void CascadeControl::rateLoop(float roll, float pitch, float yaw, float dt) {
+	float rate[CONTROL_AXES] = { roll, pitch, yaw };
+
+	for (uint8_t i = 0; i < CONTROL_AXES; i++) {
+		output[i] = ratePid[i].calculate(rateSp[i], rate[i], dt);
+	}
+}
+
+/**
+ * @brief Report what the mixer could apply of the last commands
+ * @param roll  Roll command applied, in rate loop output units
+ * @param pitch Pitch command applied
+ * @param yaw   Yaw command applied
+ *
+ * Lets the rate loops' anti-windup see saturation in the mixer.
+ */
+void CascadeControl::actuated(float roll, float pitch, float yaw) {
+	float applied[CONTROL_AXES] = { roll, pitch, yaw };
+
+	for (uint8_t i = 0; i < CONTROL_AXES; i++) {
+		ratePid[i].actuated(applied[i]);
+	}
+}
+
+/**
+ * @brief Replace an axis' command from the last rateLoop()
+ * @param axis Axis
+ * @param u    Command to use instead, e.g. from a RelayTuner
+ *
+ * Call before actuated(), which then pulls the rate loop's integral towards
+ * the replacement, so handing the axis back doesn't bump it.
+ */
+void CascadeControl::setOutput(ControlAxis axis, float u) {
+	if ((uint8_t)axis < CONTROL_AXES) {
+		output[(uint8_t)axis] = u;
+	}
+}
+
+/**
+ * @brief Get the rate setpoint of an axis
+ * @param axis Axis
+ * @return Rate setpoint [deg/s]
+ */
+float CascadeControl::getRateSetpoint(ControlAxis axis) {
+	return ((uint8_t)axis < CONTROL_AXES) ? rateSp[(uint8_t)axis] : 0.0f;
+}
+
+/**
+ * @brief Get the command of an axis from the last rateLoop()
+ * @param axis Axis
+ * @return Command, in rate loop output units
+ */
+float CascadeControl::getOutput(ControlAxis axis) {
+	return ((uint8_t)axis < CONTROL_AXES) ? output[(uint8_t)axis] : 0.0f;
+}
+
+/**
+ * @brief Get the terms that made up an angle loop's last output
+ * @param axis ControlAxis::ROLL or PITCH, 0 for the others
+ * @param p    Returns the proportional term
+ * @param i    Returns the integral term
+ * @param d    Returns the derivative term
+ */
+void CascadeControl::getAngleTerms(ControlAxis axis, float *p, float *i, float *d) {
+	if ((uint8_t)axis < CONTROL_ANGLE_AXES) {
+		anglePid[(uint8_t)axis].getTerms(p, i, d);
+	} else {
+		*p = *i = *d = 0.0f;
+	}
+}
+
+/**
+ * @brief Get the terms that made up a rate loop's last output
+ * @param axis Axis
+ * @param p    Returns the proportional term
+ * @param i    Returns the integral term
+ * @param d    Returns the derivative term
+ */
+void CascadeControl::getRateTerms(ControlAxis axis, float *p, float *i, float *d) {
+	if ((uint8_t)axis < CONTROL_AXES) {
+		ratePid[(uint8_t)axis].getTerms(p, i, d);
+	} else {
+		*p = *i = *d = 0.0f;
+	}
+}
+
+/** @} Close CASCADE group */
+/** @} Close Control Group */
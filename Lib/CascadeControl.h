@@ -0,0 +1,98 @@
+/**
+ * @file
+ *
+ * @brief Cascaded angle and rate control
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @addtogroup CASCADE
+ *  @{
+ */
+
+#ifndef CASCADECONTROL_H_
+#define CASCADECONTROL_H_
+
+#include <stdint.h>
+#include "pid3.h"
+
+/**
+ * @brief Controlled axes
+ */
+enum class ControlAxis : uint8_t {
+	ROLL = 0,
+	PITCH = 1,
+	YAW = 2,
+	NUM_AXES
+};
+
+#define CONTROL_AXES		((uint8_t)ControlAxis::NUM_AXES)
+#define CONTROL_ANGLE_AXES	2		///< Roll and pitch have an angle loop
+
+/**
+ * @brief Cascaded attitude controller
+ *
+ * The outer loop turns roll and pitch angle errors into rate setpoints
+ * [deg/s]; yaw takes its rate setpoint straight from the sticks. The inner
+ * loop turns rate errors, measured by the gyro, into the roll, pitch and yaw
+ * commands for the mixer. The inner loop sees a disturbance one gyro sample
+ * after it happens instead of waiting for it to show up as an angle, so it
+ * runs every gyro sample and the outer loop at a lower rate:
+ *
+ * 		ctrl.angleLoop(rollCmd, pitchCmd, roll, pitch, dtOuter);	// every N samples
+ * 		ctrl.setYawRate(yawCmd);
+ * 		ctrl.rateLoop(rollRate, pitchRate, yawRate, dtInner);		// every sample
+ * 		ctrl.actuated(roll, pitch, yaw);	// what the mixer could apply
+ *
+ * All loops are pid3s. The angle loops' output limit is the rate limit, so
+ * their anti-windup sees the rate setpoint saturate; the rate loops' is set
+ * per axis and extended with the mixer's desaturation through actuated().
+ *
+ * Does not touch hardware, so step responses can be run on a host.
+ */
+class CascadeControl {
+private:
+	pid3 anglePid[CONTROL_ANGLE_AXES];	///< Angle loops, rate setpoint out
+	pid3 ratePid[CONTROL_AXES];			///< Rate loops, command out
+	float rateSp[CONTROL_AXES];			///< Rate setpoints [deg/s]
+	float output[CONTROL_AXES];			///< Commands from the last rateLoop()
+	float rateLimit;					///< Largest rate setpoint [deg/s]
+
+	float clampRate(float r);
+
+public:
+	CascadeControl();
+
+	void setAngleGains(ControlAxis axis, float p, float i, float d);
+	void setRateGains(ControlAxis axis, float p, float i, float d);
+	void setFeedForward(ControlAxis axis, float kff);
+	void setOutputLimit(ControlAxis axis, float max);
+	void setRateLimit(float maxRate);
+	void setDerivativeCutoff(float hz);
+	void setBackCalculation(float kt);
+
+	void reset(float roll, float pitch, float rollRate, float pitchRate, float yawRate);
+
+	void angleLoop(float rollCmd, float pitchCmd, float roll, float pitch, float dt);
+	void setYawRate(float rate);
+	void rateLoop(float roll, float pitch, float yaw, float dt);
+	void actuated(float roll, float pitch, float yaw);
+	void setOutput(ControlAxis axis, float u);
+
+	float getRateSetpoint(ControlAxis axis);
+	float getOutput(ControlAxis axis);
+	void getAngleTerms(ControlAxis axis, float *p, float *i, float *d);
+	void getRateTerms(ControlAxis axis, float *p, float *i, float *d);
+};
+
+#endif
+
+/** @} Close CASCADE group */
+/** @} Close Control Group */
@@ -0,0 +1,37 @@
+/**
+ * @file
+ *
+ * @brief DWT cycle counter shared by the timing code
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @defgroup CYCLE_COUNTER Cycle counter
+ *  @brief Enables the DWT cycle counter once for every user
+ *  @{
+ */
+
+#include "CycleCounter.h"
+#include "stm32f407xx.h"
+
+/**
+ * @brief Enable the DWT cycle counter if it isn't running
+ *
+ * Never writes CYCCNT, so intervals other modules are timing stay valid.
+ */
+void cycleCounterInit(void) {
+	if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	}
+}
+
+/** @} Close CYCLE_COUNTER group */
+/** @} Close System group */
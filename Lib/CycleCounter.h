@@ -0,0 +1,35 @@
+/**
+ * @file
+ *
+ * @brief DWT cycle counter shared by the timing code
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * The i2c bus statistics, the binary log time stamps, the filter benchmark and
+ * the control loop all measure intervals on the one DWT cycle counter. Each
+ * enables it through cycleCounterInit(), which leaves a running counter alone,
+ * so no user resets the count under another's interval.
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup CYCLE_COUNTER
+ *  @{
+ */
+
+#ifndef CYCLECOUNTER_H_
+#define CYCLECOUNTER_H_
+
+#include <stdint.h>
+
+void cycleCounterInit(void);
+
+#endif /* CYCLECOUNTER_H_ */
+
+/** @} Close CYCLE_COUNTER group */
+/** @} Close System group */
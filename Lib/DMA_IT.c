@@ -23,7 +23,12 @@
 #include "DMA_IT.h"
 
 UART_HandleTypeDef UartHandle;
-I2C_HandleTypeDef i2cHandle;
+I2C_HandleTypeDef i2c1Handle;
+I2C_HandleTypeDef i2c2Handle;
+I2C_HandleTypeDef i2c3Handle;
+DMA_HandleTypeDef dshotTim3Dma;
+DMA_HandleTypeDef dshotTim4Dma;
+DMA_HandleTypeDef adc1Dma;
 
 /** @addtogroup UART_Functions
  *  @{
@@ -43,18 +48,74 @@ I2C_HandleTypeDef i2cHandle;
  *  These functions clear the appropriate interrupt flags, handle errors, and
  *  call the corresponding callback functions.
  *
+ *  A stream can be claimed by several peripherals (on different channels), but
+ *  only one at a time. Each handler therefore passes every candidate handle to
+ *  dmaService(), which services only the handle set up on that very stream, so
+ *  e.g. a DShot frame on DMA1_Stream0 never runs the U(S)ART RX handler.
+ *
  *  For more information regarding DMA, refer to @ref peripheral_UART and
  *  @ref peripheral_I2C.
  *
  *  @{
  */
 
+/**
+ * Services a DMA handle if it is set up on the stream that interrupted.
+ *
+ * HAL_DMA_IRQHandler() checks and clears the flags of hdma->Instance, so
+ * calling it for a handle that lives on another stream would service that
+ * stream from the wrong interrupt. Handles that were never initialized (NULL,
+ * or Instance still NULL) are skipped.
+ *
+ * @param hdma   DMA handle that may own the stream, may be NULL
+ * @param stream Stream whose interrupt is being handled
+ */
+static void dmaService(DMA_HandleTypeDef *hdma, DMA_Stream_TypeDef *stream) {
+	if (hdma != NULL && hdma->Instance == stream && hdma->State != HAL_DMA_STATE_RESET) {
+		HAL_DMA_IRQHandler(hdma);
+	}
+}
+
+/**
+ * Checks whether another handle already drives the stream a handle is set up on.
+ *
+ * Several streams serve more than one peripheral used by this firmware: the
+ * DShot TIM3 bursts and I2C3_RX / UART4_RX on DMA1_Stream2, the DShot TIM4
+ * bursts and UART5_RX on DMA1_Stream0, I2C3_TX and UART4_TX on DMA1_Stream4.
+ * Which of them are in use follows from pins chosen in config.h, which the
+ * preprocessor cannot compare, so the owners of those streams call this
+ * before HAL_DMA_Init() and stop with an init error rather than taking over
+ * a stream that is already running.
+ *
+ * @param hdma Handle about to be initialized, Instance already set
+ * @return 1 if an initialized handle other than hdma is on the same stream
+ */
+int dmaStreamInUse(const DMA_HandleTypeDef *hdma) {
+	const DMA_HandleTypeDef *owners[] = {
+		&dshotTim3Dma, &dshotTim4Dma, &adc1Dma,
+		i2c1Handle.hdmatx, i2c1Handle.hdmarx, i2c2Handle.hdmatx, i2c2Handle.hdmarx,
+		i2c3Handle.hdmatx, i2c3Handle.hdmarx, UartHandle.hdmatx, UartHandle.hdmarx
+	};
+	unsigned int i;
+
+	for (i = 0; i < sizeof(owners) / sizeof(owners[0]); i++) {
+		if (owners[i] != NULL && owners[i] != hdma && owners[i]->Instance == hdma->Instance &&
+			owners[i]->State != HAL_DMA_STATE_RESET) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
 /**
  * Handles DMA interrupt requests for:
+ * 		TIM4_CH1 (DShot)
  * 		UART5_RX
  */
 void DMA1_Stream0_IRQHandler(void) {
-	HAL_DMA_IRQHandler(UartHandle.hdmarx);
+	dmaService(&dshotTim4Dma, DMA1_Stream0);
+	dmaService(UartHandle.hdmarx, DMA1_Stream0);
 }
 
 /**
@@ -62,22 +123,19 @@ void DMA1_Stream0_IRQHandler(void) {
  * 		USART3_RX
  */
 void DMA1_Stream1_IRQHandler(void) {
-	HAL_DMA_IRQHandler(UartHandle.hdmarx);
+	dmaService(UartHandle.hdmarx, DMA1_Stream1);
 }
 
 /**
  * Handles DMA interrupt requests for:
  * 		I2C3_RX
+ * 		TIM3_UP (DShot)
  * 		UART4_RX
  */
 void DMA1_Stream2_IRQHandler(void) {
-	if (i2cHandle.hdmarx->State != HAL_DMA_STATE_READY && i2cHandle.hdmarx->State != HAL_DMA_STATE_RESET) {
-		HAL_DMA_IRQHandler(i2cHandle.hdmarx);
-	}
-
-	if (UartHandle.hdmarx->State != HAL_DMA_STATE_READY) {
-		HAL_DMA_IRQHandler(UartHandle.hdmarx);
-	}
+	dmaService(&dshotTim3Dma, DMA1_Stream2);
+	dmaService(i2c3Handle.hdmarx, DMA1_Stream2);
+	dmaService(UartHandle.hdmarx, DMA1_Stream2);
 }
 
 /**
@@ -86,13 +144,8 @@ void DMA1_Stream2_IRQHandler(void) {
  * 		USART3_TX
  */
 void DMA1_Stream3_IRQHandler(void) {
-	if (i2cHandle.hdmarx->State != HAL_DMA_STATE_READY && i2cHandle.hdmarx->State != HAL_DMA_STATE_RESET) {
-		HAL_DMA_IRQHandler(i2cHandle.hdmarx);
-	}
-
-	if (UartHandle.hdmatx->State != HAL_DMA_STATE_READY) {
-		HAL_DMA_IRQHandler(UartHandle.hdmatx);
-	}
+	dmaService(i2c2Handle.hdmarx, DMA1_Stream3);
+	dmaService(UartHandle.hdmatx, DMA1_Stream3);
 }
 
 /**
@@ -101,13 +154,8 @@ void DMA1_Stream3_IRQHandler(void) {
  * 		UART4_TX
  */
 void DMA1_Stream4_IRQHandler(void) {
-	if (i2cHandle.hdmatx->State != HAL_DMA_STATE_READY) {
-		HAL_DMA_IRQHandler(i2cHandle.hdmatx);
-	}
-
-	if (UartHandle.hdmatx->State != HAL_DMA_STATE_READY) {
-		HAL_DMA_IRQHandler(UartHandle.hdmatx);
-	}
+	dmaService(i2c3Handle.hdmatx, DMA1_Stream4);
+	dmaService(UartHandle.hdmatx, DMA1_Stream4);
 }
 
 /**
@@ -116,13 +164,8 @@ void DMA1_Stream4_IRQHandler(void) {
  * 		USART2_RX
  */
 void DMA1_Stream5_IRQHandler(void) {
-	if (i2cHandle.hdmarx->State != HAL_DMA_STATE_READY && i2cHandle.hdmarx->State != HAL_DMA_STATE_RESET) {
-		HAL_DMA_IRQHandler(i2cHandle.hdmarx);
-	}
-
-	if (UartHandle.hdmarx->State != HAL_DMA_STATE_READY) {
-		HAL_DMA_IRQHandler(UartHandle.hdmarx);
-	}
+	dmaService(i2c1Handle.hdmarx, DMA1_Stream5);
+	dmaService(UartHandle.hdmarx, DMA1_Stream5);
 }
 
 /**
@@ -131,13 +174,8 @@ void DMA1_Stream5_IRQHandler(void) {
  * 		USART2_TX
  */
 void DMA1_Stream6_IRQHandler(void) {
-	if (i2cHandle.hdmatx->State != HAL_DMA_STATE_READY) {
-		HAL_DMA_IRQHandler(i2cHandle.hdmatx);
-	}
-
-	if (UartHandle.hdmatx->State != HAL_DMA_STATE_READY) {
-		HAL_DMA_IRQHandler(UartHandle.hdmatx);
-	}
+	dmaService(i2c1Handle.hdmatx, DMA1_Stream6);
+	dmaService(UartHandle.hdmatx, DMA1_Stream6);
 }
 
 /**
@@ -146,20 +184,16 @@ void DMA1_Stream6_IRQHandler(void) {
  * 		UART5_TX
  */
 void DMA1_Stream7_IRQHandler(void) {
-	if (i2cHandle.hdmatx->State != HAL_DMA_STATE_READY) {
-		HAL_DMA_IRQHandler(i2cHandle.hdmatx);
-	}
-
-	if (UartHandle.hdmatx->State != HAL_DMA_STATE_READY) {
-		HAL_DMA_IRQHandler(UartHandle.hdmatx);
-	}
+	dmaService(i2c2Handle.hdmatx, DMA1_Stream7);
+	dmaService(UartHandle.hdmatx, DMA1_Stream7);
 }
 
 /**
- * Unused
+ * Handles DMA interrupt requests for:
+ * 		ADC1 (battery monitor)
  */
 void DMA2_Stream0_IRQHandler(void) {
-
+	dmaService(&adc1Dma, DMA2_Stream0);
 }
 
 /**
@@ -167,7 +201,7 @@ void DMA2_Stream0_IRQHandler(void) {
  * 		USART6_RX
  */
 void DMA2_Stream1_IRQHandler(void) {
-	HAL_DMA_IRQHandler(UartHandle.hdmarx);
+	dmaService(UartHandle.hdmarx, DMA2_Stream1);
 }
 
 /**
@@ -196,7 +230,7 @@ void DMA2_Stream4_IRQHandler(void) {
  * 		USART1_RX
  */
 void DMA2_Stream5_IRQHandler(void) {
-	HAL_DMA_IRQHandler(UartHandle.hdmarx);
+	dmaService(UartHandle.hdmarx, DMA2_Stream5);
 }
 
 /**
@@ -204,7 +238,7 @@ void DMA2_Stream5_IRQHandler(void) {
  * 		USART6_TX
  */
 void DMA2_Stream6_IRQHandler(void) {
-	HAL_DMA_IRQHandler(UartHandle.hdmatx);
+	dmaService(UartHandle.hdmatx, DMA2_Stream6);
 }
 
 /**
@@ -212,7 +246,7 @@ void DMA2_Stream6_IRQHandler(void) {
  * 		USART1_TX
  */
 void DMA2_Stream7_IRQHandler(void) {
-	HAL_DMA_IRQHandler(UartHandle.hdmatx);
+	dmaService(UartHandle.hdmatx, DMA2_Stream7);
 }
 
 /** @} Close UART_Functions_DMA group */
@@ -25,7 +25,12 @@
 #define _DMA_IT_H_
 
 extern UART_HandleTypeDef UartHandle;
-extern I2C_HandleTypeDef i2cHandle;
+extern I2C_HandleTypeDef i2c1Handle;
+extern I2C_HandleTypeDef i2c2Handle;
+extern I2C_HandleTypeDef i2c3Handle;
+extern DMA_HandleTypeDef dshotTim3Dma;
+extern DMA_HandleTypeDef dshotTim4Dma;
+extern DMA_HandleTypeDef adc1Dma;
 
 void DMA1_Stream0_IRQHandler(void);
 void DMA1_Stream1_IRQHandler(void);
@@ -45,6 +50,14 @@ void DMA2_Stream5_IRQHandler(void);
 void DMA2_Stream6_IRQHandler(void);
 void DMA2_Stream7_IRQHandler(void);
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+int dmaStreamInUse(const DMA_HandleTypeDef *hdma);
+#ifdef __cplusplus
+}
+#endif
+
 /** @} Close UART group */
 /** @} Close Peripherals Group */
 #endif
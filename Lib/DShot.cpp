@@ -0,0 +1,255 @@
+/**
+ * @file
+ *
+ * @brief DShot digital ESC protocol output using TIM DMA bursts
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * A DShot frame is 16 bits sent MSB first: an 11-bit throttle/command value,
+ * a telemetry request bit and a 4-bit checksum. Every bit takes the same
+ * time; a 1 is high for 75% of the bit period, a 0 for 37.5%.
+ *
+ */
+
+/** @addtogroup Peripherals
+ *  @{
+ */
+
+/** @addtogroup TIM
+ *  @{
+ */
+
+#include "DShot.h"
+#include "DMA_IT.h"
+#include "errDC9000.h"
+
+/** @defgroup DShot_Class DShot class
+ *  @brief DMA driven DShot output
+ *  @{
+ */
+
+DShot *DShot::instances[2] = {NULL, NULL};
+
+/**
+ * @brief DMA transfer complete callback, routes to the owning instance
+ * @param hdma DMA handle of the finished burst
+ */
+static void dshotDmaComplete(DMA_HandleTypeDef *hdma) {
+	((DShot *)hdma->Parent)->transferComplete();
+}
+
+/**
+ * @brief This function is called to create/get the instance for a TIM
+ * @param TIMx TIM peripheral (TIM3 or TIM4)
+ * @param rate Bit rate, must match the rate of an existing instance
+ * @return Pointer to the DShot instance of the TIM
+ */
+DShot* DShot::Instance(TIM_TypeDef *TIMx, DShotRate rate) {
+	int i = (TIMx == TIM3) ? 0 : (TIMx == TIM4) ? 1 : -1;
+
+	if (i < 0) {
+		Error_Handler(errDC9000::DSHOT_INIT_ERROR);
+		return NULL;
+	}
+
+	if (instances[i] == NULL) {
+		instances[i] = new DShot(TIMx, rate);
+	}
+
+	return instances[i];
+}
+
+/**
+ * @brief Configures the TIM for the bit rate and the DMA stream for bursts
+ * @param TIMx TIM peripheral
+ * @param rate Bit rate
+ */
+DShot::DShot(TIM_TypeDef *TIMx, DShotRate rate) {
+	used = 0;
+	telemetry = 0;
+	busy = false;
+	pending = false;
+	for (uint8_t i = 0; i < DSHOT_CHANNELS; i++) {
+		frames[i] = dshotFrame(DSHOT_CMD_MOTOR_STOP, false);
+	}
+	for (uint16_t i = 0; i < DSHOT_SLOTS*DSHOT_CHANNELS; i++) {
+		buff[i] = 0;
+	}
+
+	// One bit per TIM period, no prescaler for the finest duty resolution
+	uint32_t period = (uint32_t)(timerClock(TIMx) / (float)rate);
+	t1 = period * 3 / 4;
+	t0 = period * 3 / 8;
+
+	TimHandle.Instance = TIMx;
+	TimHandle.Init.Period = period - 1;
+	TimHandle.Init.Prescaler = 0;
+	TimHandle.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	TimHandle.Init.CounterMode = TIM_COUNTERMODE_UP;
+	TimHandle.State = HAL_TIM_STATE_RESET;
+	// NOTE: Calls HAL_TIM_PWM_MspInit()
+	if (HAL_TIM_PWM_Init(&TimHandle) != HAL_OK) {
+		Error_Handler(errDC9000::DSHOT_INIT_ERROR);
+	}
+	TIMx->CR1 |= TIM_CR1_ARPE;
+
+	// DMA stream writing CCR1..CCR4 through the DMA burst register
+	__HAL_RCC_DMA1_CLK_ENABLE();
+
+	IRQn_Type irq;
+	if (TIMx == TIM3) {
+		hdma = &dshotTim3Dma;
+		hdma->Instance = DSHOT_TIM3_DMA_STREAM;
+		hdma->Init.Channel = DSHOT_TIM3_DMA_CHANNEL;
+		request = DSHOT_TIM3_DMA_REQUEST;
+		irq = DSHOT_TIM3_DMA_IRQn;
+	} else {
+		hdma = &dshotTim4Dma;
+		hdma->Instance = DSHOT_TIM4_DMA_STREAM;
+		hdma->Init.Channel = DSHOT_TIM4_DMA_CHANNEL;
+		request = DSHOT_TIM4_DMA_REQUEST;
+		irq = DSHOT_TIM4_DMA_IRQn;
+	}
+
+	hdma->Init.Direction           = DMA_MEMORY_TO_PERIPH;
+	hdma->Init.PeriphInc           = DMA_PINC_DISABLE;
+	hdma->Init.MemInc              = DMA_MINC_ENABLE;
+	hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+	hdma->Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+	hdma->Init.Mode                = DMA_NORMAL;
+	hdma->Init.Priority            = DMA_PRIORITY_HIGH;
+	hdma->Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+	hdma->Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
+	hdma->Init.MemBurst            = DMA_MBURST_SINGLE;
+	hdma->Init.PeriphBurst         = DMA_PBURST_SINGLE;
+	hdma->Parent                   = this;
+
+	// The stream is shared with I2C3_RX/UART4_RX (TIM3) or UART5_RX (TIM4)
+	if (dmaStreamInUse(hdma) || HAL_DMA_Init(hdma) != HAL_OK) {
+		Error_Handler(errDC9000::DSHOT_INIT_ERROR);
+	}
+	hdma->XferCpltCallback = dshotDmaComplete;
+
+	HAL_NVIC_SetPriority(irq, 1, 0);
+	HAL_NVIC_EnableIRQ(irq);
+
+	// Each request moves 4 words, starting at CCR1
+	TIMx->DCR = TIM_DMABASE_CCR1 | TIM_DMABURSTLENGTH_4TRANSFERS;
+	__HAL_TIM_ENABLE_DMA(&TimHandle, request);
+}
+
+/**
+ * @brief  Connect a pin to the DShot output
+ * @param p GPIO pin, must belong to this TIM
+ * @return Slot (channel index 0..3) to pass to setThrottle()
+ */
+uint8_t DShot::attach(TimerPin p) {
+	TimerChannel ch = timerPinToChannel(p);
+	uint32_t channel = timerChannelToHal(ch);
+	uint8_t slot = (uint8_t)(channel / 4);		// TIM_CHANNEL_x = 0, 4, 8, 12
+
+	if (timerChannelToTim(ch) != TimHandle.Instance) {
+		Error_Handler(errDC9000::DSHOT_INIT_ERROR);
+	}
+
+	timerPinInit(p);
+
+	// PWM mode 1 with CCR preload (set by the HAL), idle low
+	TIM_OC_InitTypeDef sConfig;
+	sConfig.OCMode = TIM_OCMODE_PWM1;
+	sConfig.Pulse = 0;
+	sConfig.OCPolarity = TIM_OCPOLARITY_HIGH;
+	sConfig.OCNPolarity = TIM_OCPOLARITY_HIGH;
+	sConfig.OCFastMode = TIM_OCFAST_DISABLE;
+	sConfig.OCIdleState = TIM_OCIDLESTATE_RESET;
+	sConfig.OCNIdleState = TIM_OCIDLESTATE_RESET;
+
+	if (HAL_TIM_PWM_ConfigChannel(&TimHandle, &sConfig, channel) != HAL_OK) {
+		Error_Handler(errDC9000::DSHOT_INIT_ERROR);
+	}
+	if (HAL_TIM_PWM_Start(&TimHandle, channel) != HAL_OK) {
+		Error_Handler(errDC9000::DSHOT_INIT_ERROR);
+	}
+
+	used |= (1 << slot);
+	return slot;
+}
+
+/**
+ * @brief Set the value sent on one channel and send a frame
+ * @param slot  Slot returned by attach()
+ * @param value Throttle (48..2047) or command (0..47)
+ */
+void DShot::setThrottle(uint8_t slot, uint16_t value) {
+	bool send = false;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	slot %= DSHOT_CHANNELS;
+	frames[slot] = dshotFrame(value, (telemetry & (1 << slot)) != 0);
+	telemetry &= ~(1 << slot);
+	if (busy) {
+		// Sent from transferComplete() once the current frame is out
+		pending = true;
+	} else {
+		busy = true;
+		send = true;
+	}
+
+	__set_PRIMASK(primask);
+
+	if (send) {
+		start();
+	}
+}
+
+/**
+ * @brief Set the telemetry bit in the next frame of one channel
+ * @param slot Slot returned by attach()
+ *
+ * The ESC answers with one frame on its telemetry wire (see EscTelemetry).
+ */
+void DShot::requestTelemetry(uint8_t slot) {
+	telemetry |= (1 << (slot % DSHOT_CHANNELS));
+}
+
+/**
+ * @brief Encode the latest frames and start the DMA
+ *
+ * Must only be called by the context that set busy, so the buffer is not
+ * in use by the DMA.
+ */
+void DShot::start(void) {
+	pending = false;
+
+	for (uint8_t c = 0; c < DSHOT_CHANNELS; c++) {
+		if (used & (1 << c)) {
+			dshotEncode(frames[c], &buff[c], DSHOT_CHANNELS, t0, t1);
+		}
+	}
+
+	if (HAL_DMA_Start_IT(hdma, (uint32_t)buff, (uint32_t)&TimHandle.Instance->DMAR, DSHOT_SLOTS*DSHOT_CHANNELS) != HAL_OK) {
+		busy = false;
+	}
+}
+
+/**
+ * @brief Called from the DMA transfer complete interrupt
+ *
+ * Sends the frame again if a value changed while the last one was in flight.
+ */
+void DShot::transferComplete(void) {
+	if (pending) {
+		start();
+	} else {
+		busy = false;
+	}
+}
+
+/** @} Close DShot_Class group */
+
+/** @} Close TIM group */
+/** @} Close Peripherals Group */
@@ -0,0 +1,117 @@
+/**
+ * @file
+ *
+ * @brief DShot digital ESC protocol output using TIM DMA bursts
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Peripherals
+ *  @{
+ */
+
+/** @addtogroup TIM
+ *  @{
+ */
+
+#ifndef DSHOT_H_
+#define DSHOT_H_
+
+#include "PwmTimer.h"
+
+#define DSHOT_FRAME_BITS	16		///< Bits per DShot frame
+#define DSHOT_PAD_SLOTS		2		///< Zero-width slots after a frame so the line idles low
+#define DSHOT_SLOTS			(DSHOT_FRAME_BITS + DSHOT_PAD_SLOTS)
+#define DSHOT_CHANNELS		4		///< CCR1..CCR4, written by one DMA burst per bit
+
+#define DSHOT_CMD_MOTOR_STOP	0		///< Disarmed / motor stop
+#define DSHOT_THROTTLE_MIN		48		///< Lowest throttle value (values below are commands)
+#define DSHOT_THROTTLE_MAX		2047	///< Highest throttle value
+
+/**
+ * TIM DMA mappings used for the bursts. The update request is used where its
+ * stream is free; TIM4_UP shares DMA1_Stream6 with I2C1_TX, so TIM4 bursts
+ * are triggered by the CC1 request instead.
+ *
+ * Every TIM3 and TIM4 request shares its stream with something: TIM3_UP with
+ * I2C3_RX and UART4_RX, TIM4_CH1 with UART5_RX. Neither I2C3 (barometer on
+ * PA8/PC9) nor UART4/UART5 is used by default. The constructor stops with
+ * DSHOT_INIT_ERROR if the stream is already taken, and I2C3/UART4/UART5
+ * refuse a stream DShot holds (dmaStreamInUse()).
+ */
+#define DSHOT_TIM3_DMA_STREAM		DMA1_Stream2
+#define DSHOT_TIM3_DMA_CHANNEL		DMA_CHANNEL_5
+#define DSHOT_TIM3_DMA_REQUEST		TIM_DMA_UPDATE
+#define DSHOT_TIM3_DMA_IRQn			DMA1_Stream2_IRQn
+
+#define DSHOT_TIM4_DMA_STREAM		DMA1_Stream0
+#define DSHOT_TIM4_DMA_CHANNEL		DMA_CHANNEL_2
+#define DSHOT_TIM4_DMA_REQUEST		TIM_DMA_CC1
+#define DSHOT_TIM4_DMA_IRQn			DMA1_Stream0_IRQn
+
+/**
+ * @brief DShot bit rates
+ */
+enum class DShotRate {
+	DSHOT150 = 150000,	//!< 150 kbit/s
+	DSHOT300 = 300000,	//!< 300 kbit/s
+	DSHOT600 = 600000	//!< 600 kbit/s
+};
+
+uint16_t dshotFrame(uint16_t value, bool telemetry);
+uint16_t dshotThrottle(float s);
+void dshotEncode(uint16_t frame, uint32_t *buff, uint8_t stride, uint32_t t0, uint32_t t1);
+
+/**
+ * @brief DShot output on the channels of one TIM
+ *
+ * There is one instance per TIM, created on first use by DShot::Instance().
+ * The TIM runs at the bit rate with preloaded CCRs. A frame for all four
+ * channels is one array of DSHOT_SLOTS x 4 CCR values, which a single DMA
+ * stream writes to TIMx->DMAR in 4-word bursts, one burst per bit period.
+ * Sending a frame therefore costs the CPU only the encoding and the DMA
+ * start; the frame is on the wire in 27 us (DShot600) to 107 us (DShot150).
+ *
+ * setThrottle() may be called while a frame is in flight. The new value is
+ * kept and the frame is re-sent from the DMA transfer complete interrupt, so
+ * the buffer is never modified while the DMA reads it.
+ *
+ * All channels of the TIM are driven by the burst, so a TIM used for DShot
+ * cannot also drive PWM outputs. Only TIM3 and TIM4 have DMA mappings here.
+ */
+class DShot {
+private:
+	static DShot *instances[2];			///< TIM3 and TIM4 instances
+
+	TIM_HandleTypeDef TimHandle;		///< STM HAL variable containing TIM config
+	DMA_HandleTypeDef *hdma;			///< DMA stream feeding TIMx->DMAR
+	uint32_t request;					///< TIM_DMA_x request triggering the bursts
+	uint32_t t0;						///< CCR value of a 0 bit
+	uint32_t t1;						///< CCR value of a 1 bit
+
+	uint16_t frames[DSHOT_CHANNELS];	///< Latest frame per channel
+	uint8_t used;						///< Bit mask of attached channels
+	volatile uint8_t telemetry;			///< Bit mask of channels to request telemetry from
+	uint32_t buff[DSHOT_SLOTS*DSHOT_CHANNELS];	///< Interleaved CCR values for the DMA
+	volatile bool busy;					///< A frame is being sent
+	volatile bool pending;				///< A newer frame is waiting
+
+	DShot(TIM_TypeDef *TIMx, DShotRate rate);
+	void start(void);
+
+public:
+	static DShot *Instance(TIM_TypeDef *TIMx, DShotRate rate);
+
+	uint8_t attach(TimerPin p);
+	void setThrottle(uint8_t slot, uint16_t value);
+	void requestTelemetry(uint8_t slot);
+	void transferComplete(void);
+};
+
+#endif /* DSHOT_H_ */
+
+/** @} Close TIM group */
+/** @} Close Peripherals Group */
@@ -0,0 +1,77 @@
+/**
+ * @file
+ *
+ * @brief DShot frame encoding
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * The parts of the DShot module that build frames and CCR values. They make
+ * no HAL calls, so they can be run on a host (tests/test_dshot.cpp).
+ *
+ */
+
+/** @addtogroup Peripherals
+ *  @{
+ */
+
+/** @addtogroup TIM
+ *  @{
+ */
+
+#include "DShot.h"
+
+/** @addtogroup DShot_Class
+ *  @{
+ */
+
+/**
+ * @brief Build a DShot frame
+ * @param value     Throttle (48..2047) or command (0..47)
+ * @param telemetry Request a telemetry reply from the ESC
+ * @return 16-bit frame including the checksum
+ */
+uint16_t dshotFrame(uint16_t value, bool telemetry) {
+	uint16_t v = (uint16_t)(((value & 0x07FF) << 1) | (telemetry ? 1 : 0));
+	uint16_t crc = (v ^ (v >> 4) ^ (v >> 8)) & 0x0F;
+
+	return (uint16_t)((v << 4) | crc);
+}
+
+/**
+ * @brief Convert a speed level (0.0 to 1.0) to a DShot throttle value
+ * @param s Speed/throttle level from 0.0 to 1.0
+ * @return DSHOT_CMD_MOTOR_STOP for 0.0, otherwise DSHOT_THROTTLE_MIN to
+ * DSHOT_THROTTLE_MAX
+ */
+uint16_t dshotThrottle(float s) {
+	if (s <= 0.0f) return DSHOT_CMD_MOTOR_STOP;
+	if (s >= 1.0f) return DSHOT_THROTTLE_MAX;
+
+	return (uint16_t)(DSHOT_THROTTLE_MIN + s * (DSHOT_THROTTLE_MAX - DSHOT_THROTTLE_MIN));
+}
+
+/**
+ * @brief Convert a frame to CCR values
+ * @param frame  16-bit frame from dshotFrame()
+ * @param buff   [out] DSHOT_SLOTS CCR values, spaced stride words apart
+ * @param stride Distance between two slots of the same channel
+ * @param t0     CCR value of a 0 bit
+ * @param t1     CCR value of a 1 bit
+ *
+ * The trailing DSHOT_PAD_SLOTS slots are 0 so the line stays low once the
+ * DMA stops. Does not touch hardware.
+ */
+void dshotEncode(uint16_t frame, uint32_t *buff, uint8_t stride, uint32_t t0, uint32_t t1) {
+	for (uint8_t i = 0; i < DSHOT_FRAME_BITS; i++) {
+		buff[i*stride] = (frame & (0x8000 >> i)) ? t1 : t0;
+	}
+	for (uint8_t i = DSHOT_FRAME_BITS; i < DSHOT_SLOTS; i++) {
+		buff[i*stride] = 0;
+	}
+}
+
+/** @} Close DShot_Class group */
+/** @} Close TIM group */
+/** @} Close Peripherals Group */
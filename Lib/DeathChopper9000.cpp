@@ -16,12 +16,75 @@
 
 #include "DeathChopper9000.h"
 #include "errDC9000.h"
+#include "CycleCounter.h"
+#include <string.h>
 
 // Global DeathChopper9000 instance
 DeathChopper9000* DeathChopper9000::dc9000Instance = NULL;
 
 led *leds = NULL;
 
+// Motor pins in the order of the MOTOR_FRAME mixing matrix
+static const TimerPin motorPins[] = MOTOR_PINS;
+
+#ifdef USE_BLACKBOX
+// Flight recorder fields, in the order recordFlight() fills them. One motor
+// field per motor in the frame follows the fixed ones.
+#define FLIGHT_FIXED_FIELDS 29
+static const BlackboxField flightFields[FLIGHT_FIXED_FIELDS + MIXER_MAX_MOTORS] = {
+	{ "time", 1.0f },		// [ms]
+	{ "gx", 100.0f },		// Gyro, unfiltered [deg/s]
+	{ "gy", 100.0f },
+	{ "gxf", 100.0f },		// Gyro, filtered [deg/s]
+	{ "gyf", 100.0f },
+	{ "gzf", 100.0f },
+	{ "ax", 1000.0f },		// Accelerometer, filtered [g]
+	{ "ay", 1000.0f },
+	{ "az", 1000.0f },
+	{ "accP", 100.0f },		// Accelerometer angles [deg]
+	{ "accR", 100.0f },
+	{ "pitch", 100.0f },	// Estimated angles [deg]
+	{ "roll", 100.0f },
+	{ "pCmd", 100.0f },		// Commands [deg], [deg/s], [speed]
+	{ "rCmd", 100.0f },
+	{ "yCmd", 10.0f },
+	{ "thr", 10000.0f },
+	{ "pSp", 10.0f },		// Rate setpoints [deg/s]
+	{ "rSp", 10.0f },
+	{ "ySp", 10.0f },
+	{ "pP", 100.0f },		// Pitch rate PID terms
+	{ "pI", 100.0f },
+	{ "pD", 100.0f },
+	{ "rP", 100.0f },		// Roll rate PID terms
+	{ "rI", 100.0f },
+	{ "rD", 100.0f },
+	{ "vbat", 1000.0f },	// [V]
+	{ "ibat", 100.0f },		// [A]
+	{ "h", 10.0f },			// Height [in]
+	{ "m0", 10000.0f },		// Motor speeds, MOTOR_FRAME order
+	{ "m1", 10000.0f },
+	{ "m2", 10000.0f },
+	{ "m3", 10000.0f },
+	{ "m4", 10000.0f },
+	{ "m5", 10000.0f },
+	{ "m6", 10000.0f },
+	{ "m7", 10000.0f }
+};
+#endif
+
+// Telemetry channels and their largest frames (payloads in Telemetry.h). The
+// order sets the priority.
+static const TelemetryChannel telemChannels[] = {
+	{ TelemetryId::ATTITUDE,	0,	TELEM_RATE_ATTITUDE,	TELEM_FRAME_BYTES(12) },
+	{ TelemetryId::CONTROL,		1,	TELEM_RATE_CONTROL,		TELEM_FRAME_BYTES(25 + 2 * MIXER_MAX_MOTORS) },
+	{ TelemetryId::ALTITUDE,	2,	TELEM_RATE_ALTITUDE,	TELEM_FRAME_BYTES(2) },
+	{ TelemetryId::BATTERY,		3,	TELEM_RATE_BATTERY,		TELEM_FRAME_BYTES(6) },
+	{ TelemetryId::TIMING,		4,	TELEM_RATE_TIMING,		TELEM_FRAME_BYTES(6) },
+	{ TelemetryId::ERRORS,		5,	TELEM_RATE_ERRORS,		TELEM_FRAME_BYTES(29) },
+	{ TelemetryId::I2C_BUS,		6,	TELEM_RATE_I2C,			TELEM_FRAME_BYTES(34) }
+};
+#define TELEM_CHANNELS (sizeof(telemChannels) / sizeof(telemChannels[0]))
+
 /**
  * @brief Obtain a Death Chopper 9000
  * @return Pointer to the DeathChopper9000 singleton instance
@@ -40,7 +103,7 @@ DeathChopper9000* DeathChopper9000::instance() {
  * @brief Construct a DeathChopper9000 object
  *
  * Initializes all of the required peripherals:
- * 		- Adc for voltage sensing
+ * 		- @ref BatteryMonitor "Battery monitor" for voltage and current sensing
  * 		- @ref Motor "Motors"
  * 		- @ref LED "LEDs"
  * 		- @ref UART "UART" for remote control via XBee
@@ -56,11 +119,11 @@ DeathChopper9000* DeathChopper9000::instance() {
  * 		- @ref COMPFILTER
  */
 DeathChopper9000::DeathChopper9000()
-	: vSense(VSENSE_PIN),
-	  front(MOTOR_FRONT_PIN), rear(MOTOR_REAR_PIN),
-	  left(MOTOR_LEFT_PIN), right(MOTOR_RIGHT_PIN),
-	  pitch_pid(PITCH_KP, PITCH_KI, PITCH_KD),
-	  roll_pid(ROLL_KP, ROLL_KI, ROLL_KD),
+	: motors(motorPins, sizeof(motorPins) / sizeof(motorPins[0]), MOTOR_PROTOCOL),
+	  motorMix(MOTOR_FRAME, MAX_SPEED),
+	  telemSched(TELEM_LINK_BYTES_PER_S, TELEM_LATENCY),
+	  control(),
+	  tuner(),
 	  rangefinder()
 
 {
@@ -83,6 +146,7 @@ DeathChopper9000::DeathChopper9000()
 	gyroConfig.hpcf_config = L3GD_HPCF_Config::THREE;
 	gyroConfig.hpm_config = L3GD_HPM_Config::THREE;
 	gyroConfig.odr_bw_config = L3GD_ODR_BW_Config::EIGHT;
+	gyroConfig.prefilter = GYRO_PREFILTER;
 
 	// Accelerometer settings
 	LSM303D_InitStruct accelConfig;
@@ -93,6 +157,11 @@ DeathChopper9000::DeathChopper9000()
 	accelConfig.mres_config = LSM_MRES_Config::HIGH;
 	accelConfig.mfs_config = LSM_MFS_Config::FOUR;
 	accelConfig.md_config = LSM_MD_Config::CONTINUOUS;
+	accelConfig.prefilter = ACC_PREFILTER;
+
+	// Stored tuning values replace the config.h defaults. Loaded first, the
+	// IMU takes its pre-filter designs from them
+	params = ParamStore::Instance();
 
 	// Initialize the IMU
 	imu = new IMU(gyroConfig, accelConfig);
@@ -101,12 +170,464 @@ DeathChopper9000::DeathChopper9000()
 	 * Initialize member variables
 	 */
 	rxTimeout = 0;
+	armed = false;
 	throttle_cmd = pitch_cmd = roll_cmd = yaw_cmd = 0.0f;
 	pitch_y = roll_y = 0.0f;
-	pitch_e = roll_e = 0.0f;
-	u_pitch = u_roll = 0.0f;
-	u_pitch_cmd = u_roll_cmd = 0.0f;
-	front_s = rear_s = left_s = right_s = 0.0f;
+	pitch_rate_y = roll_rate_y = yaw_rate_y = 0.0f;
+	u_pitch = u_roll = u_yaw = 0.0f;
+	u_pitch_cmd = u_roll_cmd = u_yaw_cmd = 0.0f;
+	for (uint8_t i = 0; i < MIXER_MAX_MOTORS; i++) {
+		motor_s[i] = 0.0f;
+	}
+	loopPeriod = loopWork = loopWorkMax = 0;
+	i2cReportBus = I2C_NUM_BUSES - 1;
+
+	tuner.setLimits(TUNE_ANGLE_LIMIT, TUNE_TIMEOUT, TUNE_RATE_LIMIT);
+	tuneAxis = ControlAxis::NUM_AXES;
+	tuneRule = TuneRule::ZIEGLER_NICHOLS;
+	tuneSeq = 0;
+	tuneHeading = 0.0f;
+
+	// The frame needs exactly one pin per motor
+	if (motorMix.getMotors() != motors.getCount()) {
+		Error_Handler(errDC9000::MIXER_CONFIG_ERROR);
+	}
+
+#ifdef USE_ESC_TELEMETRY
+	escTelem = EscTelemetry::Instance(motors.getCount());
+#else
+	escTelem = NULL;
+#endif
+
+	// Start background battery sampling
+	battery = BatteryMonitor::Instance(VSENSE_PIN, ISENSE_PIN);
+
+	telem = Telemetry::Instance();
+	BinLog::init();
+
+	for (uint8_t i = 0; i < TELEM_CHANNELS; i++) {
+		if (telemSched.add(telemChannels[i]) < 0) {
+			Error_Handler(errDC9000::TELEMETRY_CONFIG_ERROR);
+		}
+	}
+
+	// Push the stored values into the objects that keep a copy
+	applyParams();
+
+	// Sensor offsets: the stored ones if they still fit, otherwise measured
+	// now and stored for the next start
+	ImuCalibration cal;
+	for (uint8_t i = 0; i < 3; i++) {
+		cal.gyro[i] = paramAsFloat((uint16_t)ParamId::CAL_GYRO_X + i);
+		cal.acc[i] = paramAsFloat((uint16_t)ParamId::CAL_ACC_X + i);
+	}
+	cal.temp = paramGet(ParamId::CAL_TEMP);
+
+	if (imu->calibrate(&cal) == CalResult::MEASURED) {
+		for (uint8_t i = 0; i < 3; i++) {
+			params->set((uint16_t)ParamId::CAL_GYRO_X + i, cal.gyro[i]);
+			params->set((uint16_t)ParamId::CAL_ACC_X + i, cal.acc[i]);
+		}
+		params->set((uint16_t)ParamId::CAL_TEMP, cal.temp);
+		params->flush();
+	}
+
+#ifdef USE_BLACKBOX
+	blackbox = new Blackbox((const volatile uint8_t *)BLACKBOX_FLASH_ADDR, BLACKBOX_FLASH_SIZE, blackboxFlashOps);
+#else
+	blackbox = NULL;
+#endif
+}
+
+/**
+ * @brief Push the current parameters into the objects that keep a copy
+ *
+ * Values read every loop (PID_OUT_SCALE, ANGLE_LIMIT, ...) come straight from
+ * paramGet() and need nothing here.
+ */
+void DeathChopper9000::applyParams(void) {
+	control.setAngleGains(ControlAxis::PITCH, paramGet(ParamId::PITCH_P), paramGet(ParamId::PITCH_I), paramGet(ParamId::PITCH_D));
+	control.setAngleGains(ControlAxis::ROLL, paramGet(ParamId::ROLL_P), paramGet(ParamId::ROLL_I), paramGet(ParamId::ROLL_D));
+
+	control.setRateGains(ControlAxis::PITCH, paramGet(ParamId::PITCH_RATE_P), paramGet(ParamId::PITCH_RATE_I), paramGet(ParamId::PITCH_RATE_D));
+	control.setRateGains(ControlAxis::ROLL, paramGet(ParamId::ROLL_RATE_P), paramGet(ParamId::ROLL_RATE_I), paramGet(ParamId::ROLL_RATE_D));
+	control.setRateGains(ControlAxis::YAW, paramGet(ParamId::YAW_RATE_P), paramGet(ParamId::YAW_RATE_I), paramGet(ParamId::YAW_RATE_D));
+
+	control.setFeedForward(ControlAxis::PITCH, paramGet(ParamId::PITCH_RATE_FF));
+	control.setFeedForward(ControlAxis::ROLL, paramGet(ParamId::ROLL_RATE_FF));
+	control.setFeedForward(ControlAxis::YAW, paramGet(ParamId::YAW_RATE_FF));
+
+	control.setOutputLimit(ControlAxis::PITCH, paramGet(ParamId::PITCH_OUT_LIMIT) * paramGet(ParamId::PID_OUT_SCALE));
+	control.setOutputLimit(ControlAxis::ROLL, paramGet(ParamId::ROLL_OUT_LIMIT) * paramGet(ParamId::PID_OUT_SCALE));
+	control.setOutputLimit(ControlAxis::YAW, paramGet(ParamId::YAW_OUT_LIMIT) * paramGet(ParamId::PID_OUT_SCALE));
+
+	control.setRateLimit(paramGet(ParamId::RATE_LIMIT));
+	control.setDerivativeCutoff(paramGet(ParamId::D_CUTOFF));
+
+	imu->setComplementaryTau(paramGet(ParamId::COMP_TAU));
+
+	for (uint8_t i = 0; i < TELEM_CHANNELS; i++) {
+		telemSched.setRate(i, telemChannels[i].rate / (float)paramGetInt(ParamId::TELEM_DIVIDER));
+	}
+
+	Log::setCategories((uint32_t)paramGetInt(ParamId::LOG_CATEGORIES));
+	Log::setLevel((uint8_t)paramGetInt(ParamId::LOG_LEVEL));
+}
+
+/**
+ * @brief Send a TelemetryId::PARAM frame
+ * @param seq    Sequence number of the request being answered
+ * @param id     Parameter id from the request
+ * @param status Result of the request
+ */
+void DeathChopper9000::sendParam(uint8_t seq, uint16_t id, ParamStatus status) {
+	TelemetryFrame frame(TelemetryId::PARAM, telem->nextSeq());
+
+	frame.putU8(seq);
+	frame.putU16(id);
+	frame.putU8((uint8_t)status);
+
+	if (id < (uint16_t)ParamId::NUM_PARAMS) {
+		frame.putU8((uint8_t)paramTable[id].type);
+		frame.putU32(paramValues[id].u);
+	} else {
+		frame.putU8(0);
+		frame.putU32(0);
+	}
+
+	telem->send(frame);
+}
+
+/**
+ * @brief Send a TelemetryId::LOG frame
+ * @param seq    Sequence number of the request being answered
+ * @param erased Whether the request erased the flight recorder
+ */
+void DeathChopper9000::sendLog(uint8_t seq, bool erased) {
+	TelemetryFrame frame(TelemetryId::LOG, telem->nextSeq());
+
+	frame.putU8(seq);
+	frame.putU8(erased ? 1 : 0);
+
+	if (blackbox != NULL) {
+		frame.putU32(blackbox->getUsed());
+		frame.putU32(blackbox->getSize());
+		frame.putU32(blackbox->getDropped());
+	} else {
+		frame.putU32(0);
+		frame.putU32(0);
+		frame.putU32(0);
+	}
+
+	telem->send(frame);
+}
+
+/**
+ * @brief Send a TelemetryId::TUNE frame
+ * @param seq    Sequence number of the AUTOTUNE request
+ * @param status Result of storing the tuned gains
+ */
+void DeathChopper9000::sendTune(uint8_t seq, ParamStatus status) {
+	TelemetryFrame frame(TelemetryId::TUNE, telem->nextSeq());
+	float gains[3] = { 0.0f, 0.0f, 0.0f };
+	float ku = tuner.getUltimateGain();
+	float tu = tuner.getUltimatePeriod();
+	uint32_t bits;
+
+	tuner.getGains(tuneRule, &gains[0], &gains[1], &gains[2]);
+
+	frame.putU8(seq);
+	frame.putU8((tuneAxis < ControlAxis::NUM_AXES) ? (uint8_t)tuneAxis + 1 : 0);
+	frame.putU8((uint8_t)tuner.getState());
+	frame.putU8((uint8_t)tuner.getAbort());
+	frame.putU8((uint8_t)tuneRule);
+
+	memcpy(&bits, &ku, sizeof(bits));
+	frame.putU32(bits);
+	memcpy(&bits, &tu, sizeof(bits));
+	frame.putU32(bits);
+	for (uint8_t i = 0; i < 3; i++) {
+		memcpy(&bits, &gains[i], sizeof(bits));
+		frame.putU32(bits);
+	}
+
+	frame.putU8((uint8_t)status);
+
+	telem->send(frame);
+}
+
+/**
+ * @brief Store the result of a finished autotune and report it
+ *
+ * A successful experiment's gains replace the rate loop's P, I and D
+ * parameters straight away. They go to flash with the other parameters
+ * tuned in flight, once disarmed.
+ */
+void DeathChopper9000::finishTune(void) {
+	static const ParamId rateGains[CONTROL_AXES] = { ParamId::ROLL_RATE_P, ParamId::PITCH_RATE_P, ParamId::YAW_RATE_P };
+	ParamStatus status = ParamStatus::OK;
+	float gains[3];
+
+	if (tuner.getGains(tuneRule, &gains[0], &gains[1], &gains[2])) {
+		// P, I and D are consecutive ids
+		for (uint8_t i = 0; i < 3 && status == ParamStatus::OK; i++) {
+			status = params->set((uint16_t)rateGains[(uint8_t)tuneAxis] + i, gains[i]);
+		}
+		applyParams();
+	}
+
+	sendTune(tuneSeq, status);
+}
+
+/**
+ * @brief Send one telemetry channel's frame
+ * @param id Channel frame (Telemetry.h for the payloads)
+ * @param h  Height [in]
+ * @param v  Battery voltage [V]
+ */
+void DeathChopper9000::sendChannel(TelemetryId id, float h, float v) {
+	TelemetryFrame frame(id, telem->nextSeq());
+	float terms[6];
+
+	switch (id) {
+	case TelemetryId::ATTITUDE:
+		frame.putFixed(pitch_y, TELEM_ANGLE_SCALE);
+		frame.putFixed(roll_y, TELEM_ANGLE_SCALE);
+		frame.putFixed(pitch_cmd, TELEM_ANGLE_SCALE);
+		frame.putFixed(roll_cmd, TELEM_ANGLE_SCALE);
+		frame.putFixed(yaw_cmd, TELEM_RATE_SCALE);
+		frame.putFixed(throttle_cmd, TELEM_SPEED_SCALE);
+		break;
+
+	case TelemetryId::CONTROL:
+		frame.putFixed(u_pitch_cmd, TELEM_SPEED_SCALE);
+		frame.putFixed(u_roll_cmd, TELEM_SPEED_SCALE);
+		frame.putFixed(u_yaw_cmd, TELEM_SPEED_SCALE);
+		frame.putFixed(control.getRateSetpoint(ControlAxis::PITCH), TELEM_RATE_SCALE);
+		frame.putFixed(control.getRateSetpoint(ControlAxis::ROLL), TELEM_RATE_SCALE);
+		frame.putFixed(control.getRateSetpoint(ControlAxis::YAW), TELEM_RATE_SCALE);
+		control.getRateTerms(ControlAxis::PITCH, &terms[0], &terms[1], &terms[2]);
+		control.getRateTerms(ControlAxis::ROLL, &terms[3], &terms[4], &terms[5]);
+		for (uint8_t i = 0; i < 6; i++) {
+			frame.putFixed(terms[i], TELEM_PID_SCALE);
+		}
+		frame.putU8(motors.getCount());
+		for (uint8_t i = 0; i < motors.getCount(); i++) {
+			frame.putFixed(motor_s[i], TELEM_SPEED_SCALE);
+		}
+		break;
+
+	case TelemetryId::ALTITUDE:
+		frame.putFixed(h, TELEM_HEIGHT_SCALE);
+		break;
+
+	case TelemetryId::BATTERY:
+		frame.putU16((uint16_t)(v * TELEM_VOLT_SCALE));
+		frame.putFixed(battery->getCurrent(), TELEM_AMP_SCALE);
+		frame.putU16((uint16_t)battery->getConsumed());
+		break;
+
+	case TelemetryId::TIMING: {
+		uint32_t cyclesPerUs = SystemCoreClock / 1000000;
+		uint32_t us[3] = { loopPeriod / cyclesPerUs, loopWork / cyclesPerUs, loopWorkMax / cyclesPerUs };
+		for (uint8_t i = 0; i < 3; i++) {
+			frame.putU16((us[i] > 0xFFFF) ? 0xFFFF : (uint16_t)us[i]);
+		}
+		loopWorkMax = 0;
+		break;
+	}
+
+	case TelemetryId::ERRORS: {
+		uint32_t i2cErrors = 0, i2cRecoveries = 0;
+		for (uint8_t b = 0; b < I2C_NUM_BUSES; b++) {
+			I2C *bus = I2C::fromBus((i2cBus)b);
+			if (bus != NULL) {
+				I2C_Stats s = bus->getStats();
+				i2cErrors += s.errors;
+				i2cRecoveries += s.recoveries;
+			}
+		}
+		UplinkStats uplinkStats;
+		usart_uplink_stats(&uplinkStats);
+
+		frame.putU16((uint16_t)i2cErrors);
+		frame.putU16((uint16_t)i2cRecoveries);
+		frame.putU8((uint8_t)imu->isStale());
+		frame.putU32(telem->getDropped());
+		frame.putU32(telemSched.getSkippedTotal());
+		frame.putU32(uplinkStats.lost);
+		frame.putU32(uplinkStats.errors);
+		frame.putU32(BinLog::getDropped());
+		frame.putU32((blackbox != NULL) ? blackbox->getDropped() : 0);
+		break;
+	}
+
+	case TelemetryId::I2C_BUS: {
+		// Next bus in use after the one reported last
+		I2C *bus = NULL;
+		for (uint8_t n = 0; n < I2C_NUM_BUSES && bus == NULL; n++) {
+			i2cReportBus = (i2cReportBus + 1) % I2C_NUM_BUSES;
+			bus = I2C::fromBus((i2cBus)i2cReportBus);
+		}
+		if (bus == NULL) {
+			return;
+		}
+
+		I2C_Stats s = bus->getStats();
+		bus->restartWindow();
+
+		frame.putU8(i2cReportBus);
+		frame.putU32(s.transfers);
+		frame.putU32(s.bytes);
+		frame.putU32(s.errors);
+		frame.putU32(s.retries);
+		frame.putU32(s.recoveries);
+		frame.putU32(s.failures);
+		frame.putU32(s.busyCycles);
+		frame.putU32(s.elapsedCycles);
+		frame.putU8(s.queuePeak);
+		break;
+	}
+
+	default:
+		return;
+	}
+
+	telem->send(frame);
+}
+
+/**
+ * @brief Record the state of this fly() loop
+ * @param h Height [in]
+ * @param v Battery voltage [V]
+ *
+ * Fills the values in flightFields order. Does nothing unless USE_BLACKBOX.
+ */
+void DeathChopper9000::recordFlight(float h, float v) {
+#ifdef USE_BLACKBOX
+	const ImuSample *s = imu->getSample();
+	float values[FLIGHT_FIXED_FIELDS + MIXER_MAX_MOTORS];
+	uint8_t n = 0;
+
+	values[n++] = (float)HAL_GetTick();
+	values[n++] = s->gyro[0];
+	values[n++] = s->gyro[1];
+	values[n++] = s->gyroFiltered[0];
+	values[n++] = s->gyroFiltered[1];
+	values[n++] = yaw_rate_y;
+	values[n++] = s->acc[0];
+	values[n++] = s->acc[1];
+	values[n++] = s->acc[2];
+	values[n++] = s->accAngle[0];
+	values[n++] = s->accAngle[1];
+	values[n++] = pitch_y;
+	values[n++] = roll_y;
+	values[n++] = pitch_cmd;
+	values[n++] = roll_cmd;
+	values[n++] = yaw_cmd;
+	values[n++] = throttle_cmd;
+	values[n++] = control.getRateSetpoint(ControlAxis::PITCH);
+	values[n++] = control.getRateSetpoint(ControlAxis::ROLL);
+	values[n++] = control.getRateSetpoint(ControlAxis::YAW);
+	control.getRateTerms(ControlAxis::PITCH, &values[n], &values[n + 1], &values[n + 2]);
+	n += 3;
+	control.getRateTerms(ControlAxis::ROLL, &values[n], &values[n + 1], &values[n + 2]);
+	n += 3;
+	values[n++] = v;
+	values[n++] = battery->getCurrent();
+	values[n++] = h;
+	for (uint8_t i = 0; i < motors.getCount(); i++) {
+		values[n++] = motor_s[i];
+	}
+
+	blackbox->record(values);
+#else
+	(void)h;
+	(void)v;
+#endif
+}
+
+/**
+ * @brief Get the next uplink message, answering heartbeats and parameters
+ * @param msg Returns the message
+ * @return false if no message is waiting
+ *
+ * A HEARTBEAT is answered with a TelemetryId::LINK frame carrying its
+ * sequence number, the ground station time and the uplink counters.
+ *
+ * PARAM_GET and PARAM_SET are answered with a TelemetryId::PARAM frame. A
+ * set takes effect immediately. It is written to flash straight away while
+ * disarmed, otherwise on the first loop after disarming.
+ *
+ * LOG_ERASE erases the flight recorder while disarmed, which blocks for a few
+ * seconds, and is answered with a TelemetryId::LOG frame.
+ *
+ * AUTOTUNE starts a relay experiment on one rate loop (armed only), or stops
+ * it, and is answered with a TelemetryId::TUNE frame. fly() runs the
+ * experiment and sends another when it ends. A refused start leaves the
+ * tuner as it was, so the reply's axis and state say what is (not) running.
+ *
+ * Every message is still returned, so the caller sees that the link is alive.
+ */
+bool DeathChopper9000::readUplink(UplinkMsg *msg) {
+	uint32_t groundTime;
+	uint16_t id;
+	float value;
+	uint8_t axis, rule;
+
+	if (!usart_read_msg(msg)) {
+		return false;
+	}
+
+	if (uplinkGetHeartbeat(msg, &groundTime)) {
+		UplinkStats stats;
+		usart_uplink_stats(&stats);
+
+		TelemetryFrame frame(TelemetryId::LINK, telem->nextSeq());
+		frame.putU8(msg->seq);
+		frame.putU32(groundTime);
+		frame.putU32(stats.received);
+		frame.putU32(stats.lost);
+		frame.putU32(stats.errors);
+		telem->send(frame);
+	} else if (uplinkGetParamGet(msg, &id)) {
+		sendParam(msg->seq, id, (id < (uint16_t)ParamId::NUM_PARAMS) ? ParamStatus::OK : ParamStatus::UNKNOWN_ID);
+	} else if (uplinkGetParamSet(msg, &id, &value)) {
+		ParamStatus status = params->set(id, value);
+		if (status == ParamStatus::OK) {
+			applyParams();
+			if (!armed) {
+				status = params->flush();
+			}
+		}
+		sendParam(msg->seq, id, status);
+	} else if (uplinkGetLogErase(msg)) {
+		bool erased = false;
+		if (blackbox != NULL && !armed) {
+			erased = blackbox->erase();
+		}
+		sendLog(msg->seq, erased);
+	} else if (uplinkGetAutotune(msg, &axis, &rule)) {
+		if (axis == 0) {
+			tuner.stop();
+		} else if (armed && axis <= CONTROL_AXES && rule < (uint8_t)TuneRule::NUM_RULES
+				&& tuner.getState() != TunerState::RUNNING) {
+			float p, i, d;
+
+			// Swing around what the loop currently holds the axis at
+			tuneAxis = (ControlAxis)(axis - 1);
+			tuneRule = (TuneRule)rule;
+			tuneSeq = msg->seq;
+			control.getRateTerms(tuneAxis, &p, &i, &d);
+			tuneHeading = 0.0f;
+			tuner.setLimits(tuneAxis == ControlAxis::YAW ? TUNE_HEADING_LIMIT : TUNE_ANGLE_LIMIT,
+					TUNE_TIMEOUT, TUNE_RATE_LIMIT);
+			tuner.start(TUNE_AMPLITUDE * paramGet(ParamId::PID_OUT_SCALE), TUNE_HYSTERESIS, i);
+		}
+		sendTune(msg->seq, ParamStatus::OK);
+	}
+
+	return true;
 }
 
 /**
@@ -116,7 +637,8 @@ DeathChopper9000::DeathChopper9000()
  * and calls the appropriate routine.
  */
 void DeathChopper9000::start() {
-	uint8_t *buff = NULL;
+	UplinkMsg msg;
+	UplinkMode mode;
 
 	// Turn an LED on so they are opposites
 	leds->turnOn(LED::RED);
@@ -127,22 +649,17 @@ void DeathChopper9000::start() {
 		leds->toggle(LED::RED);
 
 		// Check if a mode command has been received
-		buff = usart_read();
-		if (buff != NULL) {
-			// Check if demo command
-			if (buff[0] == DEMO_CMD && buff[1] == DEMO_CMD &&
-				buff[2] == DEMO_CMD && buff[3] == DEMO_CMD &&
-				buff[4] == DEMO_CMD && buff[5] == DEMO_CMD)
-			{
-				demo();
-			}
+		while (readUplink(&msg)) {
+			if (uplinkGetMode(&msg, &mode)) {
+				// Check if demo command
+				if (mode == UplinkMode::DEMO) {
+					demo();
+				}
 
-			// Check if fly command
-			else if (buff[0] == FLY_CMD && buff[1] == FLY_CMD &&
-				buff[2] == FLY_CMD && buff[3] == FLY_CMD &&
-				buff[4] == FLY_CMD && buff[5] == FLY_CMD)
-			{
-				fly();
+				// Check if fly command
+				else if (mode == UplinkMode::FLY) {
+					fly();
+				}
 			}
 		}
 
@@ -158,12 +675,31 @@ void DeathChopper9000::start() {
  *
  * Receives remote control commands via UART (XBee). Measures orientation
  * (acclerometer & gyro data is pre- and complementary filtered). Performs
- * PID feedback control and adjusts motor speeds. Transmits pitch, roll, height
- * and battery voltage back to the remote.
+ * cascaded feedback control (CascadeControl): the rate loops run every gyro
+ * sample, the angle loops every CONTROL_OUTER_DIV samples. Adjusts motor
+ * speeds once armed; the remote can only arm at idle throttle. Streams binary telemetry channels (TelemetryScheduler)
+ * back to the remote without blocking the loop.
+ * While armed, every outer loop is also recorded to the flight recorder
+ * (RAM only), which is written to flash once disarmed.
  */
 void DeathChopper9000::fly() {
-	uint8_t *readBuff = NULL;
-	uint32_t iter = 0;
+	UplinkMsg msg;
+	UplinkSticks sticks;
+	bool heard = false;
+	bool arm;
+	uint32_t loopCycles = SystemCoreClock / CONTROL_RATE_HZ;
+
+	cycleCounterInit();
+	uint32_t loopStart = DWT->CYCCNT;
+	uint32_t outerStart = loopStart;
+	uint32_t outerPeriod = 0;
+	uint8_t outerCount = 0;
+	float h = 0.0f;
+	float v = 0.0f;
+	int8_t ch;
+
+	// Motors stay off until the remote arms them
+	armed = false;
 
 	// Turn all LEDs off to make sure only the running light blinks
 	leds->turnOff(LED::BLUE);
@@ -173,84 +709,197 @@ void DeathChopper9000::fly() {
 
 	// Run forever
 	while (1) {
-		// Toggle running light
-		leds->toggle(LED::BLUE);
-
-		// See if a new remote control command has arrived yet
-		readBuff = usart_read();
-		if (readBuff != NULL) {
-			// Check for packet errors
-			if (readBuff[0] != START || readBuff[5] != STOP) {
-				Error_Handler(errDC9000::TIMEOUT_ERROR);
-			}
+		// Wait for the next gyro sample period
+		while (DWT->CYCCNT - loopStart < loopCycles) {
+		}
+		uint32_t now = DWT->CYCCNT;
+		loopPeriod = now - loopStart;
+		loopStart = now;
+
+		// The angle loops and everything but the rate loops run at a lower rate
+		bool outer = (++outerCount >= CONTROL_OUTER_DIV);
+		if (outer) {
+			outerCount = 0;
+			outerPeriod = now - outerStart;
+			outerStart = now;
+		}
 
-			// Calculate desired commands
-			throttle_cmd = (float)readBuff[1] / (253.0f / MAX_SPEED);
-			pitch_cmd 	 = ((float)readBuff[2] - 127.0) / 127.0f * MAX_ANGLE;
-			roll_cmd 	 = ((float)readBuff[3] - 127.0) / 127.0f * MAX_ANGLE;
-			yaw_cmd 	 = ((float)readBuff[4] - 127.0) / 127.0f * MAX_RATE;
+		// Measure the "output" angles and rates
+		imu->getRollPitch(&roll_y, &pitch_y);
+		imu->getRates(&roll_rate_y, &pitch_rate_y, &yaw_rate_y);
 
-			rxTimeout = 0;
+		if (abs(roll_y) >= paramGet(ParamId::ANGLE_LIMIT) || abs(pitch_y) >= paramGet(ParamId::ANGLE_LIMIT)) {
+			Error_Handler(errDC9000::FLIPPING);
 		}
+
+		if (outer) {
+			// Toggle running light
+			leds->toggle(LED::BLUE);
+
+			// Handle every remote control message since the last loop. Messages
+			// are framed and CRC checked as they arrive, so a corrupt one is
+			// dropped instead of showing up here
+			heard = false;
+			while (readUplink(&msg)) {
+				heard = true;
+
+				if (uplinkGetSticks(&msg, &sticks)) {
+					// Calculate desired commands
+					throttle_cmd = (float)sticks.throttle / 65535.0f * MAX_SPEED;
+					pitch_cmd 	 = (float)sticks.pitch / 32767.0f * paramGet(ParamId::ANGLE_LIMIT);
+					roll_cmd 	 = (float)sticks.roll / 32767.0f * paramGet(ParamId::ANGLE_LIMIT);
+					yaw_cmd 	 = (float)sticks.yaw / 32767.0f * paramGet(ParamId::RATE_LIMIT);
+				} else if (uplinkGetArm(&msg, &arm)) {
+					// Arm only at idle throttle and from level setpoints, so
+					// the motors can't jump to whatever the sticks last held
+					if (!arm) {
+						armed = false;
+					} else if (!armed && throttle_cmd <= ARM_MAX_THROTTLE) {
+						armed = true;
+						pitch_cmd = roll_cmd = yaw_cmd = 0.0f;
+					}
+				}
+			}
+
+			if (heard) {
+				rxTimeout = 0;
+			}
 #ifdef RX_TIMEOUT_ENABLE
-		// If no remote control, eventually timeout
-		else {
-			rxTimeout++;
-			if (rxTimeout >= TIMEOUT) {
-				Error_Handler(errDC9000::REMOTE_CONTROL);
-			}
-		}
+			// If no remote control, eventually timeout
+			else {
+				rxTimeout++;
+				if (rxTimeout >= TIMEOUT) {
+					Error_Handler(errDC9000::REMOTE_CONTROL);
+				}
+			}
 #endif
-		// Measure the height
-		float h = rangefinder.getDistIn();
 
-		// Measure and calculate the battery voltage
-		uint32_t vRaw = vSense.read();
-		float v = (float)vRaw * 3.0f / 4096.0f / 63.69e-3f;
+			// Angle loops: angle errors to rate setpoints
+			control.angleLoop(roll_cmd, pitch_cmd, roll_y, pitch_y, (float)outerPeriod / (float)SystemCoreClock);
+			control.setYawRate(yaw_cmd);
+		}
 
-		// Measure the "output" angles
-		imu->getRollPitch(&roll_y, &pitch_y);
+		// Rate loops: rate errors to attitude commands
+		float dt = (float)loopPeriod / (float)SystemCoreClock;
+		control.rateLoop(roll_rate_y, pitch_rate_y, yaw_rate_y, dt);
 
-		if (abs(roll_y) >= MAX_ANGLE || abs(pitch_y) >= MAX_ANGLE) {
-			Error_Handler(errDC9000::FLIPPING);
-		}
+		// While autotuning, the relay drives the tuned axis instead
+		if (tuner.getState() == TunerState::RUNNING) {
+			// Yaw has no angle to hold; the heading it swings away by stands in
+			tuneHeading += yaw_rate_y * dt;
+			float rate[CONTROL_AXES] = { roll_rate_y, pitch_rate_y, yaw_rate_y };
+			float angle[CONTROL_AXES] = { roll_y, pitch_y, tuneHeading };
+			uint8_t a = (uint8_t)tuneAxis;
 
-		// Calculate the errors
-		pitch_e = pitch_cmd - pitch_y;
-		roll_e  = roll_cmd - roll_y;
+			if (!armed) {
+				tuner.stop();
+			} else {
+				float u = tuner.update(control.getRateSetpoint(tuneAxis) - rate[a], angle[a], dt);
+				if (tuner.getState() == TunerState::RUNNING) {
+					control.setOutput(tuneAxis, u);
+				}
+			}
 
-		// Calculate PID control outputs
-//		u_pitch = pitch_pid.calculate(pitch_e);
-//		u_roll  = roll_pid.calculate(roll_e);
-		u_pitch = pitch_pid.calculate(pitch_e, LOOP_DELAY);
-		u_roll  = roll_pid.calculate(roll_e, LOOP_DELAY);
+			if (tuner.getState() != TunerState::RUNNING) {
+				finishTune();
+			}
+		}
+		u_pitch = control.getOutput(ControlAxis::PITCH);
+		u_roll  = control.getOutput(ControlAxis::ROLL);
+		u_yaw   = control.getOutput(ControlAxis::YAW);
 
 		// Convert to motor commands
-		u_pitch_cmd = u_pitch / PID_SCALE;
-		u_roll_cmd  = u_roll  / PID_SCALE;
-
-		// Calculate motor speeds
-		front_s = throttle_cmd - u_pitch_cmd;// - yaw_cmd;
-		rear_s  = throttle_cmd + u_pitch_cmd;// - yaw_cmd;
-		right_s = throttle_cmd - u_roll_cmd;//  + yaw_cmd;
-		left_s  = throttle_cmd + u_roll_cmd;//  + yaw_cmd;
+		u_pitch_cmd = u_pitch / paramGet(ParamId::PID_OUT_SCALE);
+		u_roll_cmd  = u_roll  / paramGet(ParamId::PID_OUT_SCALE);
+		u_yaw_cmd   = u_yaw   / paramGet(ParamId::PID_OUT_SCALE);
+
+		// Calculate motor speeds, and let the rate loops' anti-windup know how
+		// much of their commands the mixer could apply
+		motorMix.mix(throttle_cmd, u_roll_cmd, u_pitch_cmd, u_yaw_cmd, motor_s);
+		float rpApplied, yawApplied;
+		motorMix.getApplied(&rpApplied, &yawApplied);
+		control.actuated(rpApplied * u_roll, rpApplied * u_pitch, yawApplied * u_yaw);
 
-		front.setSpeed(front_s);
-		rear.setSpeed(rear_s);
-		left.setSpeed(left_s);
-		right.setSpeed(right_s);
-
-		// Occasionally transmit information - avoids overwhelming UART port
-		if (iter % 10 == 0) {
-			char txBuff2[100];
-//			sprintf(txBuff2, "%f\t%f\n\r", pitch_y, roll_y);
-			sprintf(txBuff2, "%f %f %f %f\n", pitch_y, roll_y, h, v);
-			usart_transmit((uint8_t *)txBuff2);
+#ifdef USE_ESC_TELEMETRY
+		// Decode the last reply and ask the next ESC with this DShot frame
+		if (outer) {
+			escTelem->poll();
+			motors.requestTelemetry(escTelem->nextRequest());
+		}
+#endif
+
+		// All motors latch the new speeds on the same timer update. The
+		// loops start from scratch on every arming.
+		if (armed) {
+			motors.setSpeeds(motor_s);
+		} else {
+			motors.stop();
+			control.reset(roll_y, pitch_y, roll_rate_y, pitch_rate_y, yaw_rate_y);
+		}
+
+		if (outer) {
+			// Background work, kept out of the sensor-to-motor path
+
+			// Store parameters tuned in flight once it's safe to stall the flash
+			if (!armed) {
+				params->flush();
+			}
+
+			// Measure the height
+			h = rangefinder.getDistIn();
+
+			// Latest battery voltage (sampled in the background)
+			v = battery->getVoltage();
+
+			imu->updateNotch();
+
+			// Gyro bias: still spells only count on the ground, and the
+			// thermal model follows the gyro temperature
+			imu->setOnGround(!armed);
+			imu->updateTemperature();
+
+#ifdef USE_BLACKBOX
+			// One recorder session per arming
+			if (armed && !blackbox->isRecording()) {
+				blackbox->begin(flightFields, FLIGHT_FIXED_FIELDS + motors.getCount());
+			} else if (!armed && blackbox->isRecording()) {
+				blackbox->end();
+			}
+
+			// Record this loop into RAM. Flash is only programmed once
+			// disarmed, as it stalls the loop and every interrupt
+			if (armed) {
+				recordFlight(h, v);
+			} else {
+				blackbox->service(BLACKBOX_WORDS_PER_LOOP);
+			}
+#endif
+
+#ifdef USE_RPM_NOTCH
+			float rpm[MIXER_MAX_MOTORS];
+			for (uint8_t i = 0; i < motors.getCount(); i++) {
+				rpm[i] = escTelem->getRpm(i);
+			}
+			imu->setMotorRpm(rpm);
+#endif
+
+			// Stream telemetry - queued, never waits for the UART. The scheduler
+			// sends what is due, most important first, while the link has room.
+			telemSched.tick((float)outerPeriod / (float)SystemCoreClock, usart_tx_pending());
+			while ((ch = telemSched.next()) >= 0) {
+				sendChannel(telemSched.getId(ch), h, v);
+				telemSched.sent(ch);
+			}
+
+			// Ship logged entries in whatever the telemetry link has left over
+			BinLog::drain(BINLOG_FRAMES_PER_LOOP);
 		}
 
-		// Delay for fixed rate
-		iter++;
-		HAL_Delay(LOOP_DELAY);
+		// Time the loop
+		loopWork = DWT->CYCCNT - loopStart;
+		if (loopWork > loopWorkMax) {
+			loopWorkMax = loopWork;
+		}
 	}
 }
 
@@ -260,14 +909,27 @@ void DeathChopper9000::fly() {
  * @note Runs forever unless errors occur
  *
  * Measures the pitch and roll angles, height, and battery voltage.
- * Transmits measured quantities via UART/XBee. If motors are enabled (toggle
- * by pressing 'x' button on remote control), adjusts speed of left and right
- * motors based on roll angle.
+ * Transmits measured quantities via UART/XBee. If motors are enabled (armed
+ * from the remote control, or toggled with the 'x' button on the original
+ * remote), adjusts speed of left and right motors based on roll angle.
+ *
+ * Runs on the same gyro-rate tick as fly(): the sensor filters are designed
+ * for CONTROL_RATE_HZ samples, so the angles are read and the motors set
+ * every tick, and everything else runs every CONTROL_OUTER_DIV ticks.
  */
 void DeathChopper9000::demo() {
-	uint8_t *buff = NULL;
+	UplinkMsg msg;
 	uint32_t iter = 0;
-	bool enableMotors = false;
+	uint32_t loopCycles = SystemCoreClock / CONTROL_RATE_HZ;
+
+	cycleCounterInit();
+	uint32_t loopStart = DWT->CYCCNT;
+	uint8_t outerCount = 0;
+	float height = 0.0f;
+	float v = 0.0f;
+
+	// Motors stay off until the remote arms them
+	armed = false;
 
 	// Turn all LEDs off to make sure only the running light blinks
 	leds->turnOff(LED::BLUE);
@@ -277,58 +939,85 @@ void DeathChopper9000::demo() {
 
 	// Run forever
 	while(1) {
-		/*
-		 * Check if data has been read from UART to see if motors should be
-		 * enabled or not
-		 */
-		buff = usart_read();
-		if (buff != NULL) {
-			if (buff[0] == DEMO_MOTOR_TOGGLE && buff[1] == DEMO_MOTOR_TOGGLE &&
-				buff[2] == DEMO_MOTOR_TOGGLE && buff[3] == DEMO_MOTOR_TOGGLE &&
-				buff[4] == DEMO_MOTOR_TOGGLE && buff[5] == DEMO_MOTOR_TOGGLE)
-			{
-				enableMotors = !enableMotors;
-			}
+		// Wait for the next gyro sample period
+		while (DWT->CYCCNT - loopStart < loopCycles) {
 		}
+		uint32_t now = DWT->CYCCNT;
+		loopPeriod = now - loopStart;
+		loopStart = now;
 
-		// Toggle flight mode running light
-		leds->toggle(LED::ORANGE);
+		bool outer = (++outerCount >= CONTROL_OUTER_DIV);
+		if (outer) {
+			outerCount = 0;
+		}
 
 		// Measure the "output" angles
 		imu->getRollPitch(&roll_y, &pitch_y);
 
-		// Measure the height
-		float height = rangefinder.getDistIn();
-
-		// Measure and calculate the battery voltage
-		uint32_t vRaw = vSense.read();
-		float v = (float)vRaw * 3.0f / 4096.0f / 63.69e-3f;
-
 		// Calculate speed of motors based on orientation
 		float speed = (roll_y + 90.0f) / 180.0f * DEMO_MAX_SPEED;
 
 		// Set the motor speeds if motors are enabled
-		if (enableMotors == true) {
-			right.setSpeed(speed);
-			left.setSpeed(DEMO_MAX_SPEED - speed);
+		if (armed == true) {
+			float speeds[MOTOR_GROUP_MAX] = {0.0f};
+			speeds[MOTOR_LEFT] = DEMO_MAX_SPEED - speed;
+			speeds[MOTOR_RIGHT] = speed;
+			motors.setSpeeds(speeds);
 		} else {
-			right.setSpeed(0.0f);
-			left.setSpeed(0.0f);
+			motors.stop();
+		}
+
+		if (!outer) {
+			continue;
 		}
 
+		/*
+		 * Check if data has been read from UART to see if motors should be
+		 * enabled or not
+		 */
+		while (readUplink(&msg)) {
+			uplinkGetArm(&msg, &armed);
+		}
+
+		if (!armed) {
+			params->flush();
+		}
+
+		// Toggle flight mode running light
+		leds->toggle(LED::ORANGE);
+
+		// Measure the height
+		height = rangefinder.getDistIn();
+
+		// Latest battery voltage (sampled in the background)
+		v = battery->getVoltage();
+
+		// Background work, kept out of the sensor-to-motor path
+		imu->updateNotch();
+		imu->setOnGround(!armed);
+		imu->updateTemperature();
+
 		// Occasionally transmit information to avoid overwhelming UART port
 		if (iter % 10 == 0) {
 			char txBuff[100];
-			sprintf(txBuff, "%f %f %f %f\n", pitch_y, roll_y, height, v);
+			textFormat(txBuff, sizeof(txBuff), "%f %f %f %f\n", pitch_y, roll_y, height, v);
 			usart_transmit((uint8_t *)txBuff);
 		}
 
-		// Delay for fixed rate
 		iter++;
-		HAL_Delay(LOOP_DELAY);
 	}
 }
 
+/**
+ * @brief Stop all motors without halting
+ *
+ * Only writes the motor outputs, so the fault path can cut the motors before
+ * it spends time reporting the error.
+ */
+void DeathChopper9000::stopMotors() {
+	motors.stop();
+}
+
 /**
  * @brief Kill all motors
  *
@@ -339,10 +1028,7 @@ void DeathChopper9000::demo() {
  * @todo Implement slow descent for auto-land
  */
 void DeathChopper9000::abort() {
-	front.setSpeed(0.0f);
-	rear.setSpeed(0.0f);
-	left.setSpeed(0.0f);
-	right.setSpeed(0.0f);
+	stopMotors();
 	while(1);
 }
 
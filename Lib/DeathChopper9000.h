@@ -17,14 +17,24 @@
 #define __DEATHCHOPPER9000__
 
 #include "config.h"
-#include "Adc.h"
+#include "BatteryMonitor.h"
 #include "uart.h"
-#include "Motor.h"
+#include "MotorGroup.h"
+#include "mixer.h"
+#include "EscTelemetry.h"
+#include "Telemetry.h"
+#include "TelemetryScheduler.h"
+#include "Log.h"
+#include "TextFormat.h"
+#include "ParamStore.h"
+#include "BlackboxFlash.h"
 #include "IMU.h"
 #include "LidarLite.h"
 #include "HCSR04.h"
 #include "pid.h"
 #include "pid2.h"
+#include "CascadeControl.h"
+#include "RelayTuner.h"
 #include "led.h"
 
 /**
@@ -32,9 +42,11 @@
  */
 extern led *leds;						///< LED controller
 
-#define FLY_CMD 1
-#define DEMO_CMD 2
-#define DEMO_MOTOR_TOGGLE 3
+// Motor indices in the MotorGroup (QUAD_PLUS order, used by demo())
+#define MOTOR_FRONT 0
+#define MOTOR_REAR  1
+#define MOTOR_LEFT  2
+#define MOTOR_RIGHT 3
 
 /**
  * @brief Quadcopter abstraction
@@ -44,17 +56,24 @@ extern led *leds;						///< LED controller
  */
 class DeathChopper9000 {
 private:
-	Adc vSense;					///< Adc for sensing battery voltage
+	BatteryMonitor *battery;	///< Battery voltage and current sensing
 
 	IMU *imu;					///< Inertial measurement unit - orientation sensing
 
-	Motor front;				///< Front motor
-	Motor rear;					///< Rear motor
-	Motor left;					///< Left motor
-	Motor right;				///< Right motor
-
-	pid2 pitch_pid;				///< PID controller for pitch angle
-	pid2 roll_pid;				///< PID controller for roll angle
+	MotorGroup motors;			///< Motors, in MOTOR_FRAME order
+	mixer motorMix;				///< Attitude commands to motor speeds
+	EscTelemetry *escTelem;		///< ESC telemetry, NULL unless USE_ESC_TELEMETRY
+	Telemetry *telem;			///< Binary telemetry to the ground station
+	TelemetryScheduler telemSched;	///< Shares the link between telemetry channels
+	ParamStore *params;			///< Runtime tunable parameters
+	Blackbox *blackbox;			///< Flight recorder, NULL unless USE_BLACKBOX
+
+	CascadeControl control;		///< Angle and rate loops
+	RelayTuner tuner;			///< Rate loop autotuner (UplinkId::AUTOTUNE)
+	ControlAxis tuneAxis;		///< Rate loop being tuned
+	TuneRule tuneRule;			///< Rule for the tuned gains
+	uint8_t tuneSeq;			///< Sequence number of the AUTOTUNE request
+	float tuneHeading;			///< Heading change since the yaw tune started [deg]
 
 // Rangefinder
 #if defined USE_LIDARLITE
@@ -64,6 +83,7 @@ private:
 #endif
 
 	uint32_t rxTimeout;			///< UART RX timeout counter
+	bool armed;					///< Motors may spin (UplinkId::ARM)
 
 	float throttle_cmd;			///< Throttle command from remote control
 	float pitch_cmd;			///< Pitch angle command from remote control
@@ -73,19 +93,24 @@ private:
 	float pitch_y;				///< Measured "output" pitch angle
 	float roll_y;				///< Measured "output" roll angle
 
-	float pitch_e;				///< Pitch angle error from command
-	float roll_e;				///< Roll angle error from command
+	float pitch_rate_y;			///< Measured pitch rate [deg/s]
+	float roll_rate_y;			///< Measured roll rate [deg/s]
+	float yaw_rate_y;			///< Measured yaw rate [deg/s]
+
+	float u_pitch;				///< Output of pitch rate controller
+	float u_roll;				///< Output of roll rate controller
+	float u_yaw;				///< Output of yaw rate controller
 
-	float u_pitch;				///< Output of pitch PID controller
-	float u_roll;				///< Output of roll PID controller
+	float u_pitch_cmd;			///< Pitch rate controller motor command/throttle
+	float u_roll_cmd;			///< Roll rate controller motor command/throttle
+	float u_yaw_cmd;			///< Yaw rate controller motor command/throttle
 
-	float u_pitch_cmd;			///< Pitch PID controller motor command/throttle
-	float u_roll_cmd;			///< Roll PID controller motor command/throttle
+	float motor_s[MIXER_MAX_MOTORS];	///< Motor speeds, in MOTOR_FRAME order
 
-	float front_s;				///< Front motor speed
-	float rear_s;				///< Rear motor speed
-	float left_s;				///< Left motor speed
-	float right_s;				///< Right motor speed
+	uint32_t loopPeriod;		///< Last inner control loop period [cycles]
+	uint32_t loopWork;			///< Last inner control loop time without the wait [cycles]
+	uint32_t loopWorkMax;		///< Worst loopWork since the last TIMING frame [cycles]
+	uint8_t i2cReportBus;		///< i2c bus in the last I2C_BUS frame
 
 	// Private constructors for singleton pattern
 	DeathChopper9000();
@@ -95,6 +120,15 @@ private:
 	static DeathChopper9000 *dc9000Instance;	/**< Internal pointer to the
 													 global I2C singleton */
 
+	bool readUplink(UplinkMsg *msg);
+	void sendParam(uint8_t seq, uint16_t id, ParamStatus status);
+	void sendLog(uint8_t seq, bool erased);
+	void sendTune(uint8_t seq, ParamStatus status);
+	void finishTune(void);
+	void sendChannel(TelemetryId id, float h, float v);
+	void applyParams(void);
+	void recordFlight(float h, float v);
+
 	void fly(void);
 	void demo(void);
 
@@ -103,6 +137,7 @@ public:
 
 	void start(void);
 
+	void stopMotors(void);
 	void abort(void);
 };
 
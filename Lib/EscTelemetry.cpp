@@ -0,0 +1,200 @@
+/**
+ * @file
+ *
+ * @brief KISS/BLHeli_32 serial ESC telemetry
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Sensors
+ *  @{
+ */
+
+/** @addtogroup Motor
+ *  @{
+ */
+
+#include "EscTelemetry.h"
+#include "config.h"
+
+/** @defgroup EscTelemetry_Class EscTelemetry classes
+ *  @brief Serial ESC telemetry decoding and request scheduling
+ *  @{
+ */
+
+EscTelemetry *EscTelemetry::escInstance = NULL;
+
+/**
+ * @brief This function is called to create/get the instance
+ * @param motors Number of motors sharing the telemetry wire
+ * @return Pointer to the EscTelemetry singleton
+ */
+EscTelemetry* EscTelemetry::Instance(uint8_t motors) {
+	if (escInstance == NULL) {
+		escInstance = new EscTelemetry(motors);
+	}
+
+	return escInstance;
+}
+
+/**
+ * @brief Get the instance without creating it
+ * @return Pointer to the EscTelemetry singleton, NULL if not created
+ */
+EscTelemetry* EscTelemetry::Instance(void) {
+	return escInstance;
+}
+
+/**
+ * @brief Set up the telemetry UART (receive only, byte interrupt)
+ * @param motors Number of motors sharing the telemetry wire
+ *
+ * Configured at register level: the HAL UART callbacks and MSP functions in
+ * uart.cpp belong to the remote control UART.
+ */
+EscTelemetry::EscTelemetry(uint8_t motors) {
+	count = (motors < 1) ? 1 : (motors > MOTOR_GROUP_MAX) ? MOTOR_GROUP_MAX : motors;
+	requested = count - 1;
+	replied = true;
+	rxHead = rxTail = 0;
+
+	for (uint8_t i = 0; i < MOTOR_GROUP_MAX; i++) {
+		data[i].temperature = data[i].voltage = data[i].current = 0.0f;
+		data[i].consumption = 0;
+		data[i].rpm = 0.0f;
+		data[i].missed = ESC_TELEM_MAX_MISSED;
+	}
+
+	USART6_CLK_ENABLE();
+	USART6_RX_GPIO_CLK_ENABLE();
+
+	GPIO_InitTypeDef GPIO_InitStruct;
+	GPIO_InitStruct.Pin = USART6_RX_PIN;
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+	GPIO_InitStruct.Pull = GPIO_PULLUP;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FAST;
+	GPIO_InitStruct.Alternate = USART6_RX_AF;
+	HAL_GPIO_Init(USART6_RX_GPIO_PORT, &GPIO_InitStruct);
+
+	// 8N1, 16x oversampling, RX not empty interrupt
+	ESC_TELEM_USART->CR1 = 0;
+	ESC_TELEM_USART->CR2 = 0;
+	ESC_TELEM_USART->CR3 = 0;
+	ESC_TELEM_USART->BRR = (HAL_RCC_GetPCLK2Freq() + ESC_TELEM_BAUD/2) / ESC_TELEM_BAUD;
+	ESC_TELEM_USART->CR1 = USART_CR1_UE | USART_CR1_RE | USART_CR1_RXNEIE;
+
+	HAL_NVIC_SetPriority(ESC_TELEM_IRQn, 2, 0);
+	HAL_NVIC_EnableIRQ(ESC_TELEM_IRQn);
+}
+
+/**
+ * @brief Store a received byte. Called from the UART interrupt
+ * @param b Received byte
+ */
+void EscTelemetry::rxByte(uint8_t b) {
+	uint8_t next = (rxHead + 1) & (ESC_TELEM_RX_BUFF - 1);
+
+	// Drop the byte if the main loop fell behind; the CRC catches the gap
+	if (next != rxTail) {
+		rxBuff[rxHead] = b;
+		rxHead = next;
+	}
+}
+
+/**
+ * @brief Decode the bytes received since the last call
+ *
+ * A valid frame is stored as the data of the last motor requested.
+ */
+void EscTelemetry::poll(void) {
+	EscTelemetryFrame frame;
+
+	while (rxTail != rxHead) {
+		uint8_t b = rxBuff[rxTail];
+		rxTail = (rxTail + 1) & (ESC_TELEM_RX_BUFF - 1);
+
+		if (decoder.feed(b, &frame)) {
+			EscTelemetryData *d = &data[requested];
+
+			d->temperature = (float)frame.temperature;
+			d->voltage = (float)frame.voltage * 0.01f;
+			d->current = (float)frame.current * 0.01f;
+			d->consumption = frame.consumption;
+			d->rpm = (float)frame.erpm * 100.0f / (ESC_MOTOR_POLES / 2);
+			d->missed = 0;
+			replied = true;
+		}
+	}
+}
+
+/**
+ * @brief  Pick the motor to ask for telemetry next
+ * @return Motor index to pass to MotorGroup::requestTelemetry()
+ *
+ * Call once per loop, after poll() and before the motor outputs are written.
+ * A motor that has not answered ESC_TELEM_MAX_MISSED requests in a row reports
+ * an RPM of 0.
+ */
+uint8_t EscTelemetry::nextRequest(void) {
+	if (!replied) {
+		EscTelemetryData *d = &data[requested];
+
+		if (d->missed < 255) d->missed++;
+		if (d->missed >= ESC_TELEM_MAX_MISSED) d->rpm = 0.0f;
+	}
+
+	requested = (requested + 1) % count;
+	replied = false;
+	decoder.reset();
+
+	return requested;
+}
+
+/**
+ * @brief  Get the measured speed of a motor
+ * @param i Motor index
+ * @return Mechanical RPM, 0 if unknown or stale
+ */
+float EscTelemetry::getRpm(uint8_t i) {
+	return (i < count) ? data[i].rpm : 0.0f;
+}
+
+/**
+ * @brief  Get all telemetry of a motor
+ * @param i Motor index
+ * @return Pointer to the latest data, NULL for an invalid index
+ */
+const EscTelemetryData* EscTelemetry::getData(uint8_t i) {
+	return (i < count) ? &data[i] : NULL;
+}
+
+/**
+ * @brief  Get the number of rejected frames
+ * @return CRC errors seen by the decoder
+ */
+uint32_t EscTelemetry::getCrcErrors(void) {
+	return decoder.getCrcErrors();
+}
+
+/** @} Close EscTelemetry_Class group */
+
+/**
+ * @brief Telemetry UART interrupt, called from USART6_IRQHandler()
+ *
+ * Reading SR then DR clears RXNE and the overrun/noise/framing flags.
+ */
+void escTelemetryIRQHandler(void) {
+	uint32_t sr = ESC_TELEM_USART->SR;
+	uint8_t b = (uint8_t)ESC_TELEM_USART->DR;
+	EscTelemetry *t = EscTelemetry::Instance();
+
+	if ((sr & USART_SR_RXNE) && t != NULL) {
+		t->rxByte(b);
+	}
+}
+
+/** @} Close Motor group */
+/** @} Close Sensors Group */
@@ -0,0 +1,139 @@
+/**
+ * @file
+ *
+ * @brief KISS/BLHeli_32 serial ESC telemetry
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * ESCs with serial telemetry share one wire into a UART RX pin. An ESC sends
+ * a single 10-byte frame after it receives a DShot frame with the telemetry
+ * bit set, so the motors are asked one at a time and every reply belongs to
+ * the last motor asked.
+ *
+ * Frame layout (big-endian):
+ * 		- [0]    Temperature [deg C]
+ * 		- [1..2] Voltage [0.01 V]
+ * 		- [3..4] Current [0.01 A]
+ * 		- [5..6] Consumption [mAh]
+ * 		- [7..8] Electrical RPM [100 erpm]
+ * 		- [9]    CRC-8 (poly 0x07) of bytes 0..8
+ *
+ */
+
+/** @addtogroup Sensors
+ *  @{
+ */
+
+/** @addtogroup Motor
+ *  @{
+ */
+
+#ifndef ESCTELEMETRY_H_
+#define ESCTELEMETRY_H_
+
+#include <stdint.h>
+#include "uart.h"
+#include "MotorGroup.h"
+
+#define ESC_TELEM_FRAME_LEN		10		///< Bytes per telemetry frame
+#define ESC_TELEM_BAUD			115200	///< Fixed by the ESC firmware
+#define ESC_TELEM_RX_BUFF		64		///< Receive ring buffer size, power of 2
+#define ESC_TELEM_MAX_MISSED	3		///< Unanswered requests before a motor's data is stale
+
+// Telemetry wire on USART6 RX (PC7, free on the Death Chopper PCB, a motor
+// output on the Discovery board, see config.h)
+#define ESC_TELEM_USART			USART6
+#define ESC_TELEM_IRQn			USART6_IRQn
+
+/**
+ * @brief Raw contents of one telemetry frame
+ */
+typedef struct {
+	uint8_t temperature;	///< Temperature [deg C]
+	uint16_t voltage;		///< Voltage [0.01 V]
+	uint16_t current;		///< Current [0.01 A]
+	uint16_t consumption;	///< Consumption [mAh]
+	uint16_t erpm;			///< Electrical RPM [100 erpm]
+} EscTelemetryFrame;
+
+/**
+ * @brief Telemetry of one motor in engineering units
+ */
+typedef struct {
+	float temperature;		///< Temperature [deg C]
+	float voltage;			///< Voltage [V]
+	float current;			///< Current [A]
+	uint16_t consumption;	///< Consumption [mAh]
+	float rpm;				///< Mechanical RPM, 0 if stale
+	uint8_t missed;			///< Requests without a reply since the last frame
+} EscTelemetryData;
+
+uint8_t escTelemetryCrc8(const uint8_t *buff, uint8_t len);
+
+/**
+ * @brief Byte-stream decoder for telemetry frames
+ *
+ * The frames have no start marker, so the decoder keeps the last
+ * ESC_TELEM_FRAME_LEN bytes and accepts them when the CRC matches. On a
+ * mismatch the oldest byte is dropped, which resynchronises after noise or a
+ * partial frame. reset() should be called between requests so a lost byte
+ * cannot shift the next reply. Does not touch hardware.
+ */
+class EscTelemetryDecoder {
+private:
+	uint8_t buff[ESC_TELEM_FRAME_LEN];	///< Last bytes received
+	uint8_t len;						///< Bytes in buff
+	uint32_t crcErrors;					///< Full windows with a bad CRC
+
+public:
+	EscTelemetryDecoder();
+
+	void reset(void);
+	bool feed(uint8_t b, EscTelemetryFrame *frame);
+	uint32_t getCrcErrors(void);
+};
+
+/**
+ * @brief ESC telemetry receiver and request scheduler
+ *
+ * The UART interrupt only copies bytes into a ring buffer. poll() decodes
+ * them from the main loop and nextRequest() picks the motor that gets the
+ * telemetry bit in the next DShot frame.
+ */
+class EscTelemetry {
+private:
+	static EscTelemetry *escInstance;	///< Singleton instance
+
+	EscTelemetryDecoder decoder;		///< Frame decoder
+	EscTelemetryData data[MOTOR_GROUP_MAX];	///< Latest data per motor
+	uint8_t count;						///< Number of motors
+	uint8_t requested;					///< Motor the pending reply belongs to
+	bool replied;						///< The requested motor has answered
+
+	volatile uint8_t rxBuff[ESC_TELEM_RX_BUFF];	///< Bytes from the interrupt
+	volatile uint8_t rxHead;			///< Next write position (interrupt)
+	volatile uint8_t rxTail;			///< Next read position (main loop)
+
+	EscTelemetry(uint8_t motors);
+
+public:
+	static EscTelemetry *Instance(uint8_t motors);
+	static EscTelemetry *Instance(void);
+
+	void rxByte(uint8_t b);
+	void poll(void);
+	uint8_t nextRequest(void);
+
+	float getRpm(uint8_t i);
+	const EscTelemetryData *getData(uint8_t i);
+	uint32_t getCrcErrors(void);
+};
+
+void escTelemetryIRQHandler(void);
+
+#endif /* ESCTELEMETRY_H_ */
+
+/** @} Close Motor group */
+/** @} Close Sensors Group */
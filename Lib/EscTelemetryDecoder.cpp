@@ -0,0 +1,105 @@
+/**
+ * @file
+ *
+ * @brief KISS/BLHeli_32 serial ESC telemetry frame decoding
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * The parts of the ESC telemetry module that check and unpack frames. They
+ * make no HAL calls, so they can be run on a host (tests/test_esc_telemetry.cpp).
+ *
+ */
+
+/** @addtogroup Sensors
+ *  @{
+ */
+
+/** @addtogroup Motor
+ *  @{
+ */
+
+#include "EscTelemetry.h"
+
+/**
+ * @brief CRC-8 used by the telemetry frames
+ * @param buff Bytes to check
+ * @param len  Number of bytes
+ * @return CRC-8, polynomial 0x07, initial value 0, MSB first
+ */
+uint8_t escTelemetryCrc8(const uint8_t *buff, uint8_t len) {
+	uint8_t crc = 0;
+
+	for (uint8_t i = 0; i < len; i++) {
+		crc ^= buff[i];
+		for (uint8_t b = 0; b < 8; b++) {
+			crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+		}
+	}
+
+	return crc;
+}
+
+/** @addtogroup EscTelemetry_Class
+ *  @{
+ */
+
+/**
+ * @brief Construct an empty decoder
+ */
+EscTelemetryDecoder::EscTelemetryDecoder() {
+	len = 0;
+	crcErrors = 0;
+}
+
+/**
+ * @brief Drop any partial frame
+ */
+void EscTelemetryDecoder::reset(void) {
+	len = 0;
+}
+
+/**
+ * @brief Add a received byte
+ * @param b     Received byte
+ * @param frame [out] Decoded frame, written only when true is returned
+ * @return true if b completed a frame with a valid CRC
+ */
+bool EscTelemetryDecoder::feed(uint8_t b, EscTelemetryFrame *frame) {
+	buff[len++] = b;
+	if (len < ESC_TELEM_FRAME_LEN) {
+		return false;
+	}
+
+	if (escTelemetryCrc8(buff, ESC_TELEM_FRAME_LEN - 1) != buff[ESC_TELEM_FRAME_LEN - 1]) {
+		// Slide the window by one byte to find the frame boundary
+		crcErrors++;
+		for (uint8_t i = 1; i < ESC_TELEM_FRAME_LEN; i++) {
+			buff[i-1] = buff[i];
+		}
+		len = ESC_TELEM_FRAME_LEN - 1;
+		return false;
+	}
+
+	frame->temperature = buff[0];
+	frame->voltage = (uint16_t)((buff[1] << 8) | buff[2]);
+	frame->current = (uint16_t)((buff[3] << 8) | buff[4]);
+	frame->consumption = (uint16_t)((buff[5] << 8) | buff[6]);
+	frame->erpm = (uint16_t)((buff[7] << 8) | buff[8]);
+
+	len = 0;
+	return true;
+}
+
+/**
+ * @brief  Get the number of rejected windows
+ * @return Full windows whose CRC did not match
+ */
+uint32_t EscTelemetryDecoder::getCrcErrors(void) {
+	return crcErrors;
+}
+
+/** @} Close EscTelemetry_Class group */
+/** @} Close Motor group */
+/** @} Close Sensors Group */
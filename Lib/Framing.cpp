@@ -0,0 +1,102 @@
+/**
+ * @file
+ *
+ * @brief CRC and COBS framing shared by the telemetry and uplink protocols
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @defgroup FRAMING Framing
+ *  @brief CRC-16 and COBS byte stuffing for serial links
+ *  @{
+ */
+
+#include "Framing.h"
+
+/**
+ * @brief CRC-16/CCITT (poly 0x1021, init 0xFFFF, no reflection)
+ * @param data Bytes to check
+ * @param len  Number of bytes
+ * @return The CRC
+ */
+uint16_t crc16Ccitt(const uint8_t *data, uint16_t len) {
+	uint16_t crc = 0xFFFF;
+
+	for (uint16_t i = 0; i < len; i++) {
+		crc ^= (uint16_t)data[i] << 8;
+		for (uint8_t b = 0; b < 8; b++) {
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+
+	return crc;
+}
+
+/**
+ * @brief COBS encode a buffer
+ * @param in  Bytes to encode
+ * @param len Number of bytes
+ * @param out Encoded bytes, at least len + len/254 + 1 long. No delimiter is
+ * 			  appended
+ * @return Number of encoded bytes
+ */
+uint16_t cobsEncode(const uint8_t *in, uint16_t len, uint8_t *out) {
+	uint16_t code = 0;		// Index of the current code byte
+	uint16_t o = 1;
+	uint8_t run = 1;
+
+	for (uint16_t i = 0; i < len; i++) {
+		if (in[i] == 0) {
+			out[code] = run;
+			code = o++;
+			run = 1;
+		} else {
+			out[o++] = in[i];
+			run++;
+			if (run == 0xFF) {
+				out[code] = run;
+				code = o++;
+				run = 1;
+			}
+		}
+	}
+	out[code] = run;
+
+	return o;
+}
+
+/**
+ * @brief COBS decode a buffer
+ * @param in  Encoded bytes, without the delimiter
+ * @param len Number of encoded bytes
+ * @param out Decoded bytes, at least len long
+ * @return Number of decoded bytes, 0 if the input is malformed
+ */
+uint16_t cobsDecode(const uint8_t *in, uint16_t len, uint8_t *out) {
+	uint16_t i = 0, o = 0;
+
+	while (i < len) {
+		uint8_t code = in[i++];
+		if (code == 0 || i + code - 1 > len) {
+			return 0;
+		}
+		for (uint8_t k = 1; k < code; k++) {
+			out[o++] = in[i++];
+		}
+		if (code != 0xFF && i < len) {
+			out[o++] = 0;
+		}
+	}
+
+	return o;
+}
+
+/** @} Close FRAMING group */
+/** @} Close System group */
@@ -0,0 +1,32 @@
+/**
+ * @file
+ *
+ * @brief CRC and COBS framing shared by the telemetry and uplink protocols
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup FRAMING
+ *  @{
+ */
+
+#ifndef FRAMING_H_
+#define FRAMING_H_
+
+#include <stdint.h>
+
+uint16_t crc16Ccitt(const uint8_t *data, uint16_t len);
+uint16_t cobsEncode(const uint8_t *in, uint16_t len, uint8_t *out);
+uint16_t cobsDecode(const uint8_t *in, uint16_t len, uint8_t *out);
+
+#endif
+
+/** @} Close FRAMING group */
+/** @} Close System group */
@@ -10,8 +10,8 @@
  *
  * This file contains functions for interfacing with the STM32Cube_HAL, namely
  * the (de)initialization and callback functions. It also contains an I2C class
- * for additional abstraction. The I2C class uses a singleton pattern to ensure
- * that only one I2C instance is created.
+ * for additional abstraction. The I2C class keeps one instance per i2c hardware
+ * peripheral so that several buses can transfer concurrently.
  *
  * All transfers are done via DMA to reduce CPU load. For memory reads, the DMA
  * transfers are double-buffered (aka "ping-pong buffered") so that one buffer
@@ -29,6 +29,7 @@
  */
 
 #include "I2C.h"
+#include "CycleCounter.h"
 #include "DMA_IT.h"
 #include "errDC9000.h"
 
@@ -36,16 +37,17 @@
 #include "stm32f4_discovery.h"
 #include "stm32f407xx.h"
 
-// Global static pointer used to ensure a single instance
-I2C* I2C::i2cInstance = NULL;
+// Global static pointers used to ensure a single instance per bus
+I2C* I2C::i2cInstances[I2C_NUM_BUSES] = {NULL, NULL, NULL};
 
-// Global variables needed by interrupts
-static DMA_HandleTypeDef hdma_tx;
-static DMA_HandleTypeDef hdma_rx;
+// Global variables needed by interrupts, indexed by i2cBus
+static I2C_HandleTypeDef * const i2cHandles[I2C_NUM_BUSES] = {&i2c1Handle, &i2c2Handle, &i2c3Handle};
+static DMA_HandleTypeDef hdma_tx[I2C_NUM_BUSES];
+static DMA_HandleTypeDef hdma_rx[I2C_NUM_BUSES];
 
-// Pin test functions
-bool isSclPin(i2cPin p);
-bool isSdaPin(i2cPin p);
+// Arrays to map i2cPin variables to HAL-compatible values
+static GPIO_TypeDef * const i2cPinToGPIO_TD[] = {GPIOA, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOC, GPIOF, GPIOF, GPIOH, GPIOH, GPIOH, GPIOH};
+static const uint16_t i2cPinToGpioPin[] = {GPIO_PIN_8, GPIO_PIN_6, GPIO_PIN_7, GPIO_PIN_8, GPIO_PIN_9, GPIO_PIN_10, GPIO_PIN_11, GPIO_PIN_9, GPIO_PIN_0, GPIO_PIN_1, GPIO_PIN_4, GPIO_PIN_5, GPIO_PIN_7, GPIO_PIN_8};
 
 // Initialization functions
 void initI2C(int scl, int sda);
@@ -61,6 +63,15 @@ void I2C1_MspDeInit(void);
 void I2C2_MspDeInit(void);
 void I2C3_MspDeInit(void);
 
+// Bus recovery helpers
+void i2cBusClear(int scl, int sda);
+
+// Clock enable of a GPIO port
+static void gpioClockEnable(GPIO_TypeDef *port);
+
+// Cycle counter used for bus utilization and recovery timing
+static void delayUs(uint32_t us);
+
 // Callbacks and ISRs
 #ifdef __cplusplus
 extern "C" {
@@ -73,6 +84,10 @@ void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c);
 void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c);
 void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
 
+void I2C1_ER_IRQHandler(void);
+void I2C2_ER_IRQHandler(void);
+void I2C3_ER_IRQHandler(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -80,15 +95,20 @@ void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
 /** @defgroup I2C_Class I2C class
  *  @brief Low-level i2c abstraction
  *
- * This class is responsible for low-level i2c reads and writes. It uses a
- * singleton design pattern so that it is impossible to create more than one
- * instance. This is because i2c transfers are done via DMA. DMA completion
- * ISRs require the i2cHandle to be global.
+ * This class is responsible for low-level i2c reads and writes. There is one
+ * instance per i2c hardware peripheral, created on first use by
+ * I2C::Instance(). Each instance owns a global HAL handle (i2c1Handle,
+ * i2c2Handle or i2c3Handle) and its own DMA streams, so DMA completion ISRs
+ * can route back to the correct bus with I2C::fromHandle().
  *
- * To use the class, an I2C* must be fetched using I2C::Instance(). Reads and
- * writes (general and memory) can then be freely performed using the member
- * functions. If the i2c hardware peripheral is busy performing an I/O operation,
- * it will block until it is available to perform the next operation.
+ * Transfers are placed in a per-bus queue. If the bus is idle the transfer is
+ * started immediately, otherwise it is started by the next call to
+ * I2C::service() after the previous transfer completed. Callers never block on
+ * a busy bus; they block in I2C::readyWait() only when they need the data.
+ *
+ * Interrupts only retire transfers. Everything that polls HAL_GetTick()
+ * (DMA starts, DMA aborts, bus recovery) runs in thread context, since SysTick
+ * is masked while the DMA and I2C_ER handlers run.
  *
  *  @{
  */
@@ -97,44 +117,400 @@ void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
  * @brief This function is called to create/get an instance of the class
  * @param cl i2cPin to be used for the clock if the instance has not been created
  * @param da i2cPin to be used for the data if the instance has not been created
- * @return Pointer to a I2C instance
+ * @return Pointer to the I2C instance of the bus the pins belong to
  */
 I2C* I2C::Instance(i2cPin cl, i2cPin da) {
-	if (i2cInstance == NULL) {
-		i2cInstance = new I2C(cl,da);
+	i2cBus b = i2cPinToBus(cl);
+
+	if (i2cInstances[(int)b] == NULL) {
+		i2cInstances[(int)b] = new I2C(b, cl, da);
+	}
+
+	return i2cInstances[(int)b];
+}
+
+/**
+ * @brief Finds the instance that owns a HAL handle
+ * @param hi2c HAL handle passed to a callback
+ * @return Pointer to the owning I2C instance, NULL if there is none
+ */
+I2C* I2C::fromHandle(I2C_HandleTypeDef *hi2c) {
+	for (int i = 0; i < I2C_NUM_BUSES; i++) {
+		if (i2cHandles[i] == hi2c) {
+			return i2cInstances[i];
+		}
 	}
 
-	return i2cInstance;
+	return NULL;
+}
+
+/**
+ * @brief Finds the instance of a bus
+ * @param b i2c bus
+ * @return Pointer to the bus' I2C instance, NULL if nothing has used it yet
+ */
+I2C* I2C::fromBus(i2cBus b) {
+	return i2cInstances[(int)b];
 }
 
 /**
  * @brief Constructs an I2C object
  */
-I2C::I2C() {
-	scl = i2cPin::PB8;
-	sda = i2cPin::PB9;
+I2C::I2C() : I2C(i2cBus::BUS1, i2cPin::PB8, i2cPin::PB9) {
 
-	initI2C((int)scl, (int)sda);
 }
 
 /**
  * @brief Constructs an I2C object
+ * @param b  i2c bus the pins belong to
  * @param cl i2cPin to use for the clock
  * @param da i2cPin to use for the data
  */
-I2C::I2C(i2cPin cl, i2cPin da) {
-	if (!isSclPin(cl) || !isSdaPin(da)) {
+I2C::I2C(i2cBus b, i2cPin cl, i2cPin da) {
+	if (!isSclPin(cl) || !isSdaPin(da) || i2cPinToBus(da) != b) {
 		Error_Handler(errDC9000::I2C_INIT_ERROR);
 	}
 
 	// Initialize member variables
 	scl = cl;
 	sda = da;
+	bus = b;
+	handle = i2cHandles[(int)b];
+
+	head = 0;
+	count = 0;
+	busy = false;
+	errorPending = false;
+	errorCode = HAL_I2C_ERROR_NONE;
+	servicing = false;
+	xferStart = 0;
+
+	// Register before initializing so callbacks can find the instance
+	i2cInstances[(int)b] = this;
+
+	cycleCounterInit();
+	resetStats();
 
 	// Initialize the i2c peripheral
 	initI2C((int)scl, (int)sda);
 }
 
+/**
+ * @brief Adds a transfer to the queue, starting it if the bus is idle
+ *
+ * Must be called from thread context, see I2C::service().
+ *
+ * @param op      Type of transfer
+ * @param devAddr i2c slave address (left-justified)
+ * @param memAddr Register address for memory transfers
+ * @param pData   Data buffer
+ * @param size    Number of bytes
+ * @param status  Optional pointer updated with the outcome of the transfer
+ * @return 0 on success, -1 if the queue is full or the transfer failed to start
+ */
+int8_t I2C::enqueue(I2C_Op op, uint16_t devAddr, uint16_t memAddr, uint8_t *pData, uint16_t size, volatile I2C_Status *status) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	if (count >= I2C_QUEUE_SIZE) {
+		stats.errors++;
+		stats.failures++;
+		__set_PRIMASK(primask);
+		if (status != NULL) {
+			*status = I2C_Status::FAILED;
+		}
+		return -1;
+	}
+
+	I2C_Transaction *t = &queue[(head + count) % I2C_QUEUE_SIZE];
+	t->op = op;
+	t->devAddr = devAddr;
+	t->memAddr = memAddr;
+	t->pData = pData;
+	t->size = size;
+	t->staged = (size <= I2C_XFER_BUFF_SIZE);
+	t->attempts = 0;
+	t->firstStart = 0;
+	t->status = status;
+
+	// Copy small writes so the caller's buffer may go out of scope
+	if (t->staged && (op == I2C_Op::WRITE || op == I2C_Op::MEM_WRITE)) {
+		for (uint16_t i = 0; i < size; i++) {
+			t->buff[i] = pData[i];
+		}
+	}
+
+	if (status != NULL) {
+		*status = I2C_Status::PENDING;
+	}
+
+	count++;
+	if (count > stats.queuePeak) {
+		stats.queuePeak = count;
+	}
+
+	__set_PRIMASK(primask);
+
+	return service();
+}
+
+/**
+ * @brief Handles a pending error and starts the next queued transfer
+ *
+ * Thread context only. Picks up errors recorded by transferError(), declares
+ * a transfer that has run for longer than I2C_XFER_TIMEOUT_US stuck, and
+ * starts the head of the queue once the bus is idle. Does nothing while a
+ * transfer is running or another call already owns the bus.
+ *
+ * @return 0 on success, -1 if a transfer was dropped
+ */
+int8_t I2C::service(void) {
+	bool idle;
+	int8_t ret = 0;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	if (servicing) {
+		__set_PRIMASK(primask);
+		return 0;
+	}
+
+	// A lost completion interrupt would otherwise leave the bus busy forever
+	if (busy && (DWT->CYCCNT - xferStart) >= I2C_XFER_TIMEOUT_US * (SystemCoreClock / 1000000)) {
+		stats.busyCycles += DWT->CYCCNT - xferStart;
+		busy = false;
+		errorCode = HAL_I2C_ERROR_TIMEOUT;
+		errorPending = true;
+	}
+
+	idle = !busy;
+	servicing = idle;
+	__set_PRIMASK(primask);
+
+	if (!idle) {
+		return 0;
+	}
+
+	if (errorPending) {
+		uint32_t dropped = stats.failures;
+
+		errorPending = false;
+
+		// The error interrupt does not stop the DMA stream
+		abortDma();
+		handleError(errorCode);
+
+		// A dropped stuck transfer leaves the HAL handle busy; reset it
+		if (HAL_I2C_GetState(handle) != HAL_I2C_STATE_READY) {
+			recoverBus();
+		}
+
+		if (stats.failures != dropped) {
+			ret = -1;
+		}
+	}
+
+	if (startNext() != 0) {
+		ret = -1;
+	}
+
+	servicing = false;
+	return ret;
+}
+
+/**
+ * @brief Starts the transfer at the head of the queue
+ *
+ * Must only be called from I2C::service() while the bus is idle. A transfer
+ * that fails to start goes through handleError(), so this returns only once a
+ * transfer is running or the queue is empty.
+ *
+ * @return 0 on success, -1 if a transfer was dropped
+ */
+int8_t I2C::startNext(void) {
+	uint32_t dropped = stats.failures;
+
+	while (count > 0) {
+		I2C_Transaction *t = &queue[head];
+		uint8_t *pData = t->staged ? t->buff : t->pData;
+		HAL_StatusTypeDef status;
+
+		xferStart = DWT->CYCCNT;
+		if (t->attempts == 0) {
+			t->firstStart = xferStart;
+		}
+		t->attempts++;
+
+		// BUSY clears shortly after the previous STOP. A slave holding SDA low
+		// keeps it set, and the HAL would wait 10 s for it, so bound the wait here
+		while (__HAL_I2C_GET_FLAG(handle, I2C_FLAG_BUSY) == SET &&
+			   (DWT->CYCCNT - xferStart) < I2C_BUSY_WAIT_US * (SystemCoreClock / 1000000));
+		if (__HAL_I2C_GET_FLAG(handle, I2C_FLAG_BUSY) == SET) {
+			handleError(HAL_I2C_ERROR_TIMEOUT);
+			continue;
+		}
+
+		// The completion interrupt may fire before the HAL returns
+		busy = true;
+
+		// The HAL polls the address phase itself; keep the error ISR out of it
+		__HAL_I2C_DISABLE_IT(handle, I2C_IT_ERR);
+
+		switch (t->op) {
+		case I2C_Op::WRITE:
+			status = HAL_I2C_Master_Transmit_DMA(handle, t->devAddr, pData, t->size);
+			break;
+		case I2C_Op::READ:
+			status = HAL_I2C_Master_Receive_DMA(handle, t->devAddr, pData, t->size);
+			break;
+		case I2C_Op::MEM_WRITE:
+			status = HAL_I2C_Mem_Write_DMA(handle, t->devAddr, t->memAddr, I2C_MEMADD_SIZE_8BIT, pData, t->size);
+			break;
+		case I2C_Op::MEM_READ:
+		default:
+			status = HAL_I2C_Mem_Read_DMA(handle, t->devAddr, t->memAddr, I2C_MEMADD_SIZE_8BIT, pData, t->size);
+			break;
+		}
+
+		__HAL_I2C_ENABLE_IT(handle, I2C_IT_ERR);
+
+		if (status == HAL_OK) {
+			return (stats.failures == dropped) ? 0 : -1;
+		}
+
+		busy = false;
+
+		// The HAL leaves the DMA stream armed when the address phase fails
+		abortDma();
+		handleError(status == HAL_ERROR ? (handle->ErrorCode | HAL_I2C_ERROR_AF) : HAL_I2C_ERROR_TIMEOUT);
+	}
+
+	return (stats.failures == dropped) ? 0 : -1;
+}
+
+/**
+ * @brief Pops the transfer at the head of the queue and reports its outcome
+ * @param result I2C_Status::OK or I2C_Status::FAILED
+ */
+void I2C::finish(I2C_Status result) {
+	I2C_Transaction *t = &queue[head];
+
+	if (result == I2C_Status::OK) {
+		// Only now overwrite the caller's buffer, so failures keep the last good data
+		if (t->staged && (t->op == I2C_Op::READ || t->op == I2C_Op::MEM_READ)) {
+			for (uint16_t i = 0; i < t->size; i++) {
+				t->pData[i] = t->buff[i];
+			}
+		}
+
+		stats.transfers++;
+		stats.bytes += t->size;
+	} else {
+		stats.failures++;
+	}
+
+	if (t->status != NULL) {
+		*t->status = result;
+	}
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	head = (head + 1) % I2C_QUEUE_SIZE;
+	count--;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Applies the recovery policy to the transfer at the head of the queue
+ * @param errorCode HAL_I2C_ERROR_x flags describing the failure
+ *
+ * Leaves the transfer queued for RETRY/RECOVER, pops it for FAIL. The caller
+ * is responsible for (re)starting the queue.
+ */
+void I2C::handleError(uint32_t errorCode) {
+	I2C_Transaction *t = &queue[head];
+	uint32_t elapsedUs = (DWT->CYCCNT - t->firstStart) / (SystemCoreClock / 1000000);
+
+	stats.errors++;
+
+	switch (i2cErrorAction(errorCode, t->attempts, elapsedUs)) {
+	case I2C_Action::RECOVER:
+		recoverBus();
+		stats.retries++;
+		break;
+	case I2C_Action::RETRY:
+		stats.retries++;
+		break;
+	case I2C_Action::FAIL:
+	default:
+		finish(I2C_Status::FAILED);
+		break;
+	}
+}
+
+/**
+ * @brief Stops any DMA stream the bus left running after an error
+ */
+void I2C::abortDma(void) {
+	if (handle->hdmarx != NULL && handle->hdmarx->State == HAL_DMA_STATE_BUSY) {
+		HAL_DMA_Abort(handle->hdmarx);
+	}
+	if (handle->hdmatx != NULL && handle->hdmatx->State == HAL_DMA_STATE_BUSY) {
+		HAL_DMA_Abort(handle->hdmatx);
+	}
+}
+
+/**
+ * @brief Releases a stuck bus and re-initializes the peripheral
+ *
+ * De-initializes the peripheral (which also resets it and its DMA streams),
+ * clocks SCL until the slave lets go of SDA, generates a STOP and initializes
+ * the peripheral again. Takes roughly 100 us.
+ */
+void I2C::recoverBus(void) {
+	stats.recoveries++;
+
+	abortDma();
+	deInitI2C((int)scl, (int)sda);
+	i2cBusClear((int)scl, (int)sda);
+	initI2C((int)scl, (int)sda);
+}
+
+/**
+ * @brief Called from the completion callbacks when the active transfer is done
+ *
+ * Updates the counters and pops the finished transfer. The next one is started
+ * by I2C::service() in thread context.
+ */
+void I2C::transferComplete(void) {
+	// Late interrupt of a transfer service() already declared stuck
+	if (!busy || count == 0) {
+		return;
+	}
+
+	stats.busyCycles += DWT->CYCCNT - xferStart;
+	finish(I2C_Status::OK);
+	busy = false;
+}
+
+/**
+ * @brief Called from the error callback when the active transfer failed
+ *
+ * Only records the error. I2C::service() aborts the DMA and retries, recovers
+ * or drops the transfer in thread context.
+ */
+void I2C::transferError(void) {
+	if (!busy || count == 0) {
+		return;
+	}
+
+	stats.busyCycles += DWT->CYCCNT - xferStart;
+	errorCode = handle->ErrorCode;
+	errorPending = true;
+	busy = false;
+}
+
 /**
  * @brief Member function to perform generic i2c writes as master
  * @param devAddr i2c slave address of the device to write to (left-justified)
@@ -143,15 +519,7 @@ I2C::I2C(i2cPin cl, i2cPin da) {
  * @return 0 on success, -1 on error
  */
 int8_t I2C::write(uint16_t devAddr, uint8_t *pData, uint16_t size) {
-	// Must wait until the I2C peripheral is ready, i.e., for any previous transfers to finish
-	while (HAL_I2C_GetState(&i2cHandle) != HAL_I2C_STATE_READY);
-
-	// Initiate a write
-	if (HAL_I2C_Master_Transmit_DMA(&i2cHandle, devAddr, pData, size) != HAL_OK) {
-		return -1;
-	}
-
-	return 0;
+	return enqueue(I2C_Op::WRITE, devAddr, 0, pData, size, NULL);
 }
 
 
@@ -160,18 +528,11 @@ int8_t I2C::write(uint16_t devAddr, uint8_t *pData, uint16_t size) {
  * @param devAddr i2c slave address of the device to read from (left-justified)
  * @param pData   Pointer to array to store read bytes
  * @param size    Number of bytes to read
+ * @param status  Optional pointer updated with the outcome of the read
  * @return 0 on success, -1 on error
  */
-int8_t I2C::read(uint16_t devAddr, uint8_t *pData, uint16_t size) {
-	// Must wait until the I2C peripheral is ready, i.e., for any previous transfers to finish
-	while (HAL_I2C_GetState(&i2cHandle) != HAL_I2C_STATE_READY);
-
-	// Initiate a read
-	if (HAL_I2C_Master_Receive_DMA(&i2cHandle, devAddr, pData, size) != HAL_OK) {
-		return -1;
-	}
-
-	return 0;
+int8_t I2C::read(uint16_t devAddr, uint8_t *pData, uint16_t size, volatile I2C_Status *status) {
+	return enqueue(I2C_Op::READ, devAddr, 0, pData, size, status);
 }
 
 /**
@@ -183,15 +544,7 @@ int8_t I2C::read(uint16_t devAddr, uint8_t *pData, uint16_t size) {
  * @return 0 on success, -1 on error
  */
 int8_t I2C::memWrite(uint16_t devAddr, uint16_t memAddr, uint8_t *pData, uint16_t size) {
-	// Must wait until the I2C peripheral is ready, i.e., for any previous transfers to finish
-	while (HAL_I2C_GetState(&i2cHandle) != HAL_I2C_STATE_READY);
-
-	// Initiate a memory write
-	if (HAL_I2C_Mem_Write_DMA(&i2cHandle, devAddr, memAddr, I2C_MEMADD_SIZE_8BIT, pData, size) != HAL_OK) {
-		return -1;
-	}
-
-	return 0;
+	return enqueue(I2C_Op::MEM_WRITE, devAddr, memAddr, pData, size, NULL);
 }
 
 /**
@@ -200,27 +553,80 @@ int8_t I2C::memWrite(uint16_t devAddr, uint16_t memAddr, uint8_t *pData, uint16_
  * @param memAddr Address of the device register to read
  * @param pData1  Pointer to data buffer
  * @param size    Number of bytes to be read
+ * @param status  Optional pointer updated with the outcome of the read
  * @return		  0 on success
- * 				  -1 if HAL_Error returned
+ * 				  -1 if the read failed to start or the queue is full
  */
-int8_t I2C::memRead(uint16_t devAddr, uint16_t memAddr, uint8_t *pData1, uint16_t size) {
-	// Must wait until the I2C peripheral is ready, i.e., for any previous transfers to finish
-	while(HAL_I2C_GetState(&i2cHandle) != HAL_I2C_STATE_READY);
+int8_t I2C::memRead(uint16_t devAddr, uint16_t memAddr, uint8_t *pData1, uint16_t size, volatile I2C_Status *status) {
+	return enqueue(I2C_Op::MEM_READ, devAddr, memAddr, pData1, size, status);
+}
 
-	// Initiate a memory read
-	if (HAL_I2C_Mem_Read_DMA(&i2cHandle, devAddr, memAddr, I2C_MEMADD_SIZE_8BIT, pData1, size) != HAL_OK) {
-		return -1;
-	}
+/**
+ * @brief Function to block until all queued transfers on this bus are done
+ *
+ * Services the bus while waiting, which starts the queued transfers one after
+ * the other and handles errors. Thread context only.
+ */
+void I2C::readyWait(void) {
+	do {
+		service();
+	} while (busy || errorPending || count > 0 || HAL_I2C_GetState(handle) != HAL_I2C_STATE_READY);
+}
+
+/**
+ * @brief Get the bus this instance drives
+ * @return i2c bus
+ */
+i2cBus I2C::getBus(void) {
+	return bus;
+}
 
-	return 0;
+/**
+ * @brief Get a snapshot of the utilization counters
+ * @return Counters since the last resetStats(), cycles and queue peak since
+ * 		   the last restartWindow()
+ */
+I2C_Stats I2C::getStats(void) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	I2C_Stats s = stats;
+	__set_PRIMASK(primask);
+
+	s.elapsedCycles = DWT->CYCCNT - statsStart;
+	return s;
 }
 
 /**
- * @brief Function to block until the peripheral is ready
+ * @brief Clear all counters and restart the utilization window
  */
-void I2C::readyWait(void) {
-	// Must wait until the I2C peripheral is ready, i.e., for any previous transfers to finish
-	while(HAL_I2C_GetState(&i2cHandle) != HAL_I2C_STATE_READY);
+void I2C::resetStats(void) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	stats.transfers = 0;
+	stats.bytes = 0;
+	stats.errors = 0;
+	stats.retries = 0;
+	stats.recoveries = 0;
+	stats.failures = 0;
+	__set_PRIMASK(primask);
+
+	restartWindow();
+}
+
+/**
+ * @brief Restart the utilization window: busy and elapsed cycles, queue peak
+ *
+ * The transfer and error counters keep running. Call at least every ~25 s,
+ * before the cycle counts wrap, e.g. after reporting them.
+ */
+void I2C::restartWindow(void) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	stats.busyCycles = 0;
+	stats.elapsedCycles = 0;
+	stats.queuePeak = count;
+	statsStart = DWT->CYCCNT;
+	__set_PRIMASK(primask);
 }
 
 /** @} Close I2C_Class group */
@@ -228,16 +634,16 @@ void I2C::readyWait(void) {
 /** @defgroup I2C_Functions Functions
  *  @brief ST HAL required functions, interrupts, helpers
  *
- *  To use i2c, a pointer to the I2C singleton is fetched using I2C::Instance().
- *  This calls the I2C constructor if the singleton has not already been
- *  initialized. The constructors call the initI2C() helper function, which
+ *  To use i2c, a pointer to the I2C instance of a bus is fetched using
+ *  I2C::Instance(). This calls the I2C constructor if that bus has not already
+ *  been initialized. The constructors call the initI2C() helper function, which
  *  handles setting up GPIO and the correct i2c hardware peripheral.
  *
  *  I/O is then performed using the I2C::write(), I2C::read(), I2C::memWrite(),
  *  and I2C::memRead() functions.
  *
  *  I2C::readyWait() is exposed to allow code that depends on i2c transfers to
- *  complete to wait for the peripheral to be idle, meaning that data is ready.
+ *  complete to wait for the bus queue to drain, meaning that data is ready.
  *
  *  @{
  */
@@ -257,9 +663,7 @@ void I2C::readyWait(void) {
 void initI2C(int scl, int sda) {
 	GPIO_InitTypeDef GPIO_InitStruct;
 
-	// Arrays to map i2cPin variables to HAL-compatible values
-	GPIO_TypeDef *i2cPinToGPIO_TD[] = {GPIOA, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOC, GPIOF, GPIOF, GPIOH, GPIOH, GPIOH, GPIOH};
-	uint16_t i2cPinToGpioPin[] = {GPIO_PIN_8, GPIO_PIN_6, GPIO_PIN_7, GPIO_PIN_8, GPIO_PIN_9, GPIO_PIN_10, GPIO_PIN_11, GPIO_PIN_9, GPIO_PIN_0, GPIO_PIN_1, GPIO_PIN_4, GPIO_PIN_5, GPIO_PIN_7, GPIO_PIN_8};
+	// Array to map i2cPin variables to the HAL peripheral
 	I2C_TypeDef *i2cPinToI2C_TD[] = {I2C3, I2C1, I2C1, I2C1, I2C1, I2C2, I2C2, I2C3, I2C2, I2C2, I2C2, I2C2, I2C3, I2C3};
 
 	// Convert types
@@ -268,31 +672,12 @@ void initI2C(int scl, int sda) {
 	uint16_t SCL_PIN = i2cPinToGpioPin[(int)scl];
 	uint16_t SDA_PIN = i2cPinToGpioPin[(int)sda];
 	I2C_TypeDef *I2Cx = i2cPinToI2C_TD[(int)scl];
+	I2C_HandleTypeDef *hi2c = i2cHandles[(int)i2cPinToBus((i2cPin)scl)];
 
 	// Enable the appropriate GPIO clocks
-	switch((uint32_t)SCL_PORT) {
-	case (uint32_t)GPIOA: __HAL_RCC_GPIOA_CLK_ENABLE(); break;
-	case (uint32_t)GPIOB: __HAL_RCC_GPIOB_CLK_ENABLE(); break;
-	case (uint32_t)GPIOC: __HAL_RCC_GPIOC_CLK_ENABLE(); break;
-	case (uint32_t)GPIOD: __HAL_RCC_GPIOD_CLK_ENABLE(); break;
-	case (uint32_t)GPIOE: __HAL_RCC_GPIOE_CLK_ENABLE(); break;
-	case (uint32_t)GPIOF: __HAL_RCC_GPIOF_CLK_ENABLE(); break;
-	case (uint32_t)GPIOH: __HAL_RCC_GPIOH_CLK_ENABLE(); break;
-	case (uint32_t)GPIOI: __HAL_RCC_GPIOI_CLK_ENABLE(); break;
-	default: break;
-	}
+	gpioClockEnable(SCL_PORT);
 	if (SCL_PORT != SDA_PORT) {
-		switch((uint32_t)SDA_PORT) {
-		case (uint32_t)GPIOA: __HAL_RCC_GPIOA_CLK_ENABLE(); break;
-		case (uint32_t)GPIOB: __HAL_RCC_GPIOB_CLK_ENABLE(); break;
-		case (uint32_t)GPIOC: __HAL_RCC_GPIOC_CLK_ENABLE(); break;
-		case (uint32_t)GPIOD: __HAL_RCC_GPIOD_CLK_ENABLE(); break;
-		case (uint32_t)GPIOE: __HAL_RCC_GPIOE_CLK_ENABLE(); break;
-		case (uint32_t)GPIOF: __HAL_RCC_GPIOF_CLK_ENABLE(); break;
-		case (uint32_t)GPIOH: __HAL_RCC_GPIOH_CLK_ENABLE(); break;
-		case (uint32_t)GPIOI: __HAL_RCC_GPIOI_CLK_ENABLE(); break;
-		default: break;
-		}
+		gpioClockEnable(SDA_PORT);
 	}
 
 	// Configure GPIO pins as Alternate Function, Open Drain
@@ -307,24 +692,27 @@ void initI2C(int scl, int sda) {
 	HAL_GPIO_Init(SDA_PORT, &GPIO_InitStruct);	// SDA Pin
 
 	// Setup the i2c peripheral struct
-	i2cHandle.Instance 			   = I2Cx;
-	i2cHandle.Init.AddressingMode  = I2C_ADDRESSINGMODE_7BIT;
-	i2cHandle.Init.ClockSpeed      = 400000;
-	i2cHandle.Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
-	i2cHandle.Init.DutyCycle       = I2C_DUTYCYCLE_16_9;
-	i2cHandle.Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
-	i2cHandle.Init.NoStretchMode   = I2C_NOSTRETCH_DISABLE;
-	i2cHandle.Init.OwnAddress1     = 0xFE;
-	i2cHandle.Init.OwnAddress2     = 0xFE;
+	hi2c->Instance 			   = I2Cx;
+	hi2c->Init.AddressingMode  = I2C_ADDRESSINGMODE_7BIT;
+	hi2c->Init.ClockSpeed      = 400000;
+	hi2c->Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
+	hi2c->Init.DutyCycle       = I2C_DUTYCYCLE_16_9;
+	hi2c->Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
+	hi2c->Init.NoStretchMode   = I2C_NOSTRETCH_DISABLE;
+	hi2c->Init.OwnAddress1     = 0xFE;
+	hi2c->Init.OwnAddress2     = 0xFE;
 
 	// Initialize the I2C
-	if (HAL_I2C_Init(&i2cHandle) != HAL_OK) {
+	if (HAL_I2C_Init(hi2c) != HAL_OK) {
 		Error_Handler(errDC9000::I2C_INIT_ERROR);
 	}
 
-	i2cHandle.Instance->CR2 |= 1<<8;	// Interrupt error enable
-	HAL_NVIC_SetPriority(I2C1_ER_IRQn,2,0);
-	HAL_NVIC_EnableIRQ(I2C1_ER_IRQn);
+	// Enable the error interrupt of the bus in use
+	IRQn_Type erIRQn[] = {I2C1_ER_IRQn, I2C2_ER_IRQn, I2C3_ER_IRQn};
+
+	hi2c->Instance->CR2 |= 1<<8;	// Interrupt error enable
+	HAL_NVIC_SetPriority(erIRQn[(int)i2cPinToBus((i2cPin)scl)],2,0);
+	HAL_NVIC_EnableIRQ(erIRQn[(int)i2cPinToBus((i2cPin)scl)]);
 }
 
 /**
@@ -332,14 +720,13 @@ void initI2C(int scl, int sda) {
  * @param hi2c I2C_HandleTypeDef * i2c configuration
  */
 void HAL_I2C_MspInit(I2C_HandleTypeDef *hi2c) {
-	uint32_t I2Cx = (uint32_t)hi2c->Instance;
-
 	// Initialize the appropriate I2C peripheral
-	switch(I2Cx) {
-	case (uint32_t)I2C1: I2C1_MspInit(hi2c); break;
-	case (uint32_t)I2C2: I2C2_MspInit(hi2c); break;
-	case (uint32_t)I2C3: I2C3_MspInit(hi2c); break;
-	default: break;
+	if (hi2c->Instance == I2C1) {
+		I2C1_MspInit(hi2c);
+	} else if (hi2c->Instance == I2C2) {
+		I2C2_MspInit(hi2c);
+	} else if (hi2c->Instance == I2C3) {
+		I2C3_MspInit(hi2c);
 	}
 }
 
@@ -357,50 +744,50 @@ void I2C1_MspInit(I2C_HandleTypeDef *hi2c) {
 	__HAL_RCC_DMA1_CLK_ENABLE();
 
 	// Configure DMA for tx
-	hdma_tx.Instance				 = I2C1_TX_DMA_STREAM;
-	hdma_tx.Init.Channel 			 = I2C1_TX_DMA_CHANNEL;
-	hdma_tx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
-	hdma_tx.Init.PeriphInc           = DMA_PINC_DISABLE;
-	hdma_tx.Init.MemInc              = DMA_MINC_ENABLE;
-	hdma_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
-	hdma_tx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
-	hdma_tx.Init.Mode                = DMA_NORMAL;
-	hdma_tx.Init.Priority            = DMA_PRIORITY_LOW;
-	hdma_tx.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
-	hdma_tx.Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
-	hdma_tx.Init.MemBurst            = DMA_MBURST_INC4;
-	hdma_tx.Init.PeriphBurst         = DMA_PBURST_INC4;
+	hdma_tx[0].Instance				 = I2C1_TX_DMA_STREAM;
+	hdma_tx[0].Init.Channel 			 = I2C1_TX_DMA_CHANNEL;
+	hdma_tx[0].Init.Direction           = DMA_MEMORY_TO_PERIPH;
+	hdma_tx[0].Init.PeriphInc           = DMA_PINC_DISABLE;
+	hdma_tx[0].Init.MemInc              = DMA_MINC_ENABLE;
+	hdma_tx[0].Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	hdma_tx[0].Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+	hdma_tx[0].Init.Mode                = DMA_NORMAL;
+	hdma_tx[0].Init.Priority            = DMA_PRIORITY_LOW;
+	hdma_tx[0].Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+	hdma_tx[0].Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
+	hdma_tx[0].Init.MemBurst            = DMA_MBURST_INC4;
+	hdma_tx[0].Init.PeriphBurst         = DMA_PBURST_INC4;
 
 	// Initialize DMA
-	if ( HAL_DMA_Init(&hdma_tx) != HAL_OK ) {
+	if ( HAL_DMA_Init(&hdma_tx[0]) != HAL_OK ) {
 		Error_Handler(errDC9000::I2C_INIT_ERROR);
 	}
 
 	// Associate the initialized DMA handle to the I2C handle
-	__HAL_LINKDMA(hi2c, hdmatx, hdma_tx);
+	__HAL_LINKDMA(hi2c, hdmatx, hdma_tx[0]);
 
 	// Configure DMA for rx
-	hdma_rx.Instance                 = I2C1_RX_DMA_STREAM;
-	hdma_rx.Init.Channel             = I2C1_RX_DMA_CHANNEL;
-	hdma_rx.Init.Direction           = DMA_PERIPH_TO_MEMORY;
-	hdma_rx.Init.PeriphInc           = DMA_PINC_DISABLE;
-	hdma_rx.Init.MemInc              = DMA_MINC_ENABLE;
-	hdma_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
-	hdma_rx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
-	hdma_rx.Init.Mode				 = DMA_NORMAL;
-	hdma_rx.Init.Priority            = DMA_PRIORITY_HIGH;
-	hdma_rx.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
-	hdma_rx.Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
-	hdma_rx.Init.MemBurst            = DMA_MBURST_INC4;
-	hdma_rx.Init.PeriphBurst         = DMA_PBURST_INC4;
+	hdma_rx[0].Instance                 = I2C1_RX_DMA_STREAM;
+	hdma_rx[0].Init.Channel             = I2C1_RX_DMA_CHANNEL;
+	hdma_rx[0].Init.Direction           = DMA_PERIPH_TO_MEMORY;
+	hdma_rx[0].Init.PeriphInc           = DMA_PINC_DISABLE;
+	hdma_rx[0].Init.MemInc              = DMA_MINC_ENABLE;
+	hdma_rx[0].Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	hdma_rx[0].Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+	hdma_rx[0].Init.Mode				 = DMA_NORMAL;
+	hdma_rx[0].Init.Priority            = DMA_PRIORITY_HIGH;
+	hdma_rx[0].Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+	hdma_rx[0].Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
+	hdma_rx[0].Init.MemBurst            = DMA_MBURST_INC4;
+	hdma_rx[0].Init.PeriphBurst         = DMA_PBURST_INC4;
 
 	// Initialize DMA
-	if ( HAL_DMA_Init(&hdma_rx) != HAL_OK ) {
+	if ( HAL_DMA_Init(&hdma_rx[0]) != HAL_OK ) {
 		Error_Handler(errDC9000::I2C_INIT_ERROR);
 	}
 
 	// Associate the initialized DMA handle to the I2C handle
-	__HAL_LINKDMA(hi2c, hdmarx, hdma_rx);
+	__HAL_LINKDMA(hi2c, hdmarx, hdma_rx[0]);
 
 	// Configure NVIC for DMA
 	HAL_NVIC_SetPriority(I2C1_DMA_TX_IRQn, 1, 0);
@@ -421,50 +808,50 @@ void I2C2_MspInit(I2C_HandleTypeDef *hi2c) {
 	__HAL_RCC_DMA1_CLK_ENABLE();
 
 	// Configure DMA for tx
-	hdma_tx.Instance				 = I2C2_TX_DMA_STREAM;
-	hdma_tx.Init.Channel 			 = I2C2_TX_DMA_CHANNEL;
-	hdma_tx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
-	hdma_tx.Init.PeriphInc           = DMA_PINC_DISABLE;
-	hdma_tx.Init.MemInc              = DMA_MINC_ENABLE;
-	hdma_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
-	hdma_tx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
-	hdma_tx.Init.Mode                = DMA_NORMAL;
-	hdma_tx.Init.Priority            = DMA_PRIORITY_LOW;
-	hdma_tx.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
-	hdma_tx.Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
-	hdma_tx.Init.MemBurst            = DMA_MBURST_INC4;
-	hdma_tx.Init.PeriphBurst         = DMA_PBURST_INC4;
+	hdma_tx[1].Instance				 = I2C2_TX_DMA_STREAM;
+	hdma_tx[1].Init.Channel 			 = I2C2_TX_DMA_CHANNEL;
+	hdma_tx[1].Init.Direction           = DMA_MEMORY_TO_PERIPH;
+	hdma_tx[1].Init.PeriphInc           = DMA_PINC_DISABLE;
+	hdma_tx[1].Init.MemInc              = DMA_MINC_ENABLE;
+	hdma_tx[1].Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	hdma_tx[1].Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+	hdma_tx[1].Init.Mode                = DMA_NORMAL;
+	hdma_tx[1].Init.Priority            = DMA_PRIORITY_LOW;
+	hdma_tx[1].Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+	hdma_tx[1].Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
+	hdma_tx[1].Init.MemBurst            = DMA_MBURST_INC4;
+	hdma_tx[1].Init.PeriphBurst         = DMA_PBURST_INC4;
 
 	// Initialize DMA
-	if ( HAL_DMA_Init(&hdma_tx) != HAL_OK ) {
+	if ( HAL_DMA_Init(&hdma_tx[1]) != HAL_OK ) {
 		Error_Handler(errDC9000::I2C_INIT_ERROR);
 	}
 
 	// Associate the initialized DMA handle to the I2C handle
-	__HAL_LINKDMA(hi2c, hdmatx, hdma_tx);
+	__HAL_LINKDMA(hi2c, hdmatx, hdma_tx[1]);
 
 	// Configure DMA for rx
-	hdma_rx.Instance                 = I2C2_RX_DMA_STREAM;
-	hdma_rx.Init.Channel             = I2C2_RX_DMA_CHANNEL;
-	hdma_rx.Init.Direction           = DMA_PERIPH_TO_MEMORY;
-	hdma_rx.Init.PeriphInc           = DMA_PINC_DISABLE;
-	hdma_rx.Init.MemInc              = DMA_MINC_ENABLE;
-	hdma_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
-	hdma_rx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
-	hdma_rx.Init.Mode				 = DMA_NORMAL;
-	hdma_rx.Init.Priority            = DMA_PRIORITY_HIGH;
-	hdma_rx.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
-	hdma_rx.Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
-	hdma_rx.Init.MemBurst            = DMA_MBURST_INC4;
-	hdma_rx.Init.PeriphBurst         = DMA_PBURST_INC4;
+	hdma_rx[1].Instance                 = I2C2_RX_DMA_STREAM;
+	hdma_rx[1].Init.Channel             = I2C2_RX_DMA_CHANNEL;
+	hdma_rx[1].Init.Direction           = DMA_PERIPH_TO_MEMORY;
+	hdma_rx[1].Init.PeriphInc           = DMA_PINC_DISABLE;
+	hdma_rx[1].Init.MemInc              = DMA_MINC_ENABLE;
+	hdma_rx[1].Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	hdma_rx[1].Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+	hdma_rx[1].Init.Mode				 = DMA_NORMAL;
+	hdma_rx[1].Init.Priority            = DMA_PRIORITY_HIGH;
+	hdma_rx[1].Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+	hdma_rx[1].Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
+	hdma_rx[1].Init.MemBurst            = DMA_MBURST_INC4;
+	hdma_rx[1].Init.PeriphBurst         = DMA_PBURST_INC4;
 
 	// Initialize DMA
-	if ( HAL_DMA_Init(&hdma_rx) != HAL_OK ) {
+	if ( HAL_DMA_Init(&hdma_rx[1]) != HAL_OK ) {
 		Error_Handler(errDC9000::I2C_INIT_ERROR);
 	}
 
 	// Associate the initialized DMA handle to the I2C handle
-	__HAL_LINKDMA(hi2c, hdmarx, hdma_rx);
+	__HAL_LINKDMA(hi2c, hdmarx, hdma_rx[1]);
 
 	// Configure NVIC for DMA
 	HAL_NVIC_SetPriority(I2C2_DMA_TX_IRQn, 1, 0);
@@ -485,50 +872,50 @@ void I2C3_MspInit(I2C_HandleTypeDef *hi2c) {
 	__HAL_RCC_DMA1_CLK_ENABLE();
 
 	// Configure DMA for tx
-	hdma_tx.Instance				 = I2C3_TX_DMA_STREAM;
-	hdma_tx.Init.Channel 			 = I2C3_TX_DMA_CHANNEL;
-	hdma_tx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
-	hdma_tx.Init.PeriphInc           = DMA_PINC_DISABLE;
-	hdma_tx.Init.MemInc              = DMA_MINC_ENABLE;
-	hdma_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
-	hdma_tx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
-	hdma_tx.Init.Mode                = DMA_NORMAL;
-	hdma_tx.Init.Priority            = DMA_PRIORITY_LOW;
-	hdma_tx.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
-	hdma_tx.Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
-	hdma_tx.Init.MemBurst            = DMA_MBURST_INC4;
-	hdma_tx.Init.PeriphBurst         = DMA_PBURST_INC4;
-
-	// Initialize DMA
-	if ( HAL_DMA_Init(&hdma_tx) != HAL_OK ) {
+	hdma_tx[2].Instance				 = I2C3_TX_DMA_STREAM;
+	hdma_tx[2].Init.Channel 			 = I2C3_TX_DMA_CHANNEL;
+	hdma_tx[2].Init.Direction           = DMA_MEMORY_TO_PERIPH;
+	hdma_tx[2].Init.PeriphInc           = DMA_PINC_DISABLE;
+	hdma_tx[2].Init.MemInc              = DMA_MINC_ENABLE;
+	hdma_tx[2].Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	hdma_tx[2].Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+	hdma_tx[2].Init.Mode                = DMA_NORMAL;
+	hdma_tx[2].Init.Priority            = DMA_PRIORITY_LOW;
+	hdma_tx[2].Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+	hdma_tx[2].Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
+	hdma_tx[2].Init.MemBurst            = DMA_MBURST_INC4;
+	hdma_tx[2].Init.PeriphBurst         = DMA_PBURST_INC4;
+
+	// Initialize DMA, unless DShot holds the stream
+	if ( dmaStreamInUse(&hdma_tx[2]) || HAL_DMA_Init(&hdma_tx[2]) != HAL_OK ) {
 		Error_Handler(errDC9000::I2C_INIT_ERROR);
 	}
 
 	// Associate the initialized DMA handle to the I2C handle
-	__HAL_LINKDMA(hi2c, hdmatx, hdma_tx);
+	__HAL_LINKDMA(hi2c, hdmatx, hdma_tx[2]);
 
 	// Configure DMA for rx
-	hdma_rx.Instance                 = I2C3_RX_DMA_STREAM;
-	hdma_rx.Init.Channel             = I2C3_RX_DMA_CHANNEL;
-	hdma_rx.Init.Direction           = DMA_PERIPH_TO_MEMORY;
-	hdma_rx.Init.PeriphInc           = DMA_PINC_DISABLE;
-	hdma_rx.Init.MemInc              = DMA_MINC_ENABLE;
-	hdma_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
-	hdma_rx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
-	hdma_rx.Init.Mode				 = DMA_NORMAL;
-	hdma_rx.Init.Priority            = DMA_PRIORITY_HIGH;
-	hdma_rx.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
-	hdma_rx.Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
-	hdma_rx.Init.MemBurst            = DMA_MBURST_INC4;
-	hdma_rx.Init.PeriphBurst         = DMA_PBURST_INC4;
-
-	// Initialize DMA
-	if ( HAL_DMA_Init(&hdma_rx) != HAL_OK ) {
+	hdma_rx[2].Instance                 = I2C3_RX_DMA_STREAM;
+	hdma_rx[2].Init.Channel             = I2C3_RX_DMA_CHANNEL;
+	hdma_rx[2].Init.Direction           = DMA_PERIPH_TO_MEMORY;
+	hdma_rx[2].Init.PeriphInc           = DMA_PINC_DISABLE;
+	hdma_rx[2].Init.MemInc              = DMA_MINC_ENABLE;
+	hdma_rx[2].Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	hdma_rx[2].Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+	hdma_rx[2].Init.Mode				 = DMA_NORMAL;
+	hdma_rx[2].Init.Priority            = DMA_PRIORITY_HIGH;
+	hdma_rx[2].Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+	hdma_rx[2].Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
+	hdma_rx[2].Init.MemBurst            = DMA_MBURST_INC4;
+	hdma_rx[2].Init.PeriphBurst         = DMA_PBURST_INC4;
+
+	// Initialize DMA, unless DShot holds the stream
+	if ( dmaStreamInUse(&hdma_rx[2]) || HAL_DMA_Init(&hdma_rx[2]) != HAL_OK ) {
 		Error_Handler(errDC9000::I2C_INIT_ERROR);
 	}
 
 	// Associate the initialized DMA handle to the I2C handle
-	__HAL_LINKDMA(hi2c, hdmarx, hdma_rx);
+	__HAL_LINKDMA(hi2c, hdmarx, hdma_rx[2]);
 
 	// Configure NVIC for DMA
 	HAL_NVIC_SetPriority(I2C3_DMA_TX_IRQn, 1, 0);
@@ -553,18 +940,15 @@ void I2C3_MspInit(I2C_HandleTypeDef *hi2c) {
  * De-initializes GPIO for I2C peripheral and calls HAL_I2C_DeInit()
  */
 void deInitI2C(int scl, int sda) {
-	// Mapping arrays
-	GPIO_TypeDef *i2cPinToGPIO_TD[] = {GPIOA, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOC, GPIOF, GPIOF, GPIOH, GPIOH, GPIOH, GPIOH};
-	uint16_t i2cPinToGpioPin[] = {GPIO_PIN_8, GPIO_PIN_6, GPIO_PIN_7, GPIO_PIN_8, GPIO_PIN_9, GPIO_PIN_10, GPIO_PIN_11, GPIO_PIN_9, GPIO_PIN_0, GPIO_PIN_1, GPIO_PIN_4, GPIO_PIN_5, GPIO_PIN_7, GPIO_PIN_8};
-
 	// Convert data types
 	GPIO_TypeDef *SCL_PORT = i2cPinToGPIO_TD[(int)scl];
 	GPIO_TypeDef *SDA_PORT = i2cPinToGPIO_TD[(int)sda];
 	uint16_t SCL_PIN = i2cPinToGpioPin[(int)scl];
 	uint16_t SDA_PIN = i2cPinToGpioPin[(int)sda];
+	I2C_HandleTypeDef *hi2c = i2cHandles[(int)i2cPinToBus((i2cPin)scl)];
 
 	// De-initialize I2C peripheral
-	if (HAL_I2C_DeInit(&i2cHandle) != HAL_OK) {
+	if (HAL_I2C_DeInit(hi2c) != HAL_OK) {
 		Error_Handler(errDC9000::I2C_DEINIT_ERROR);
 	}
 
@@ -578,14 +962,13 @@ void deInitI2C(int scl, int sda) {
  * @param hi2c I2C_HandleTypeDef * i2c configuration
  */
 void HAL_I2C_MspDeInit(I2C_HandleTypeDef *hi2c){
-	uint32_t I2Cx = (uint32_t)hi2c->Instance;
-
-	// Initialize the appropriate I2C peripheral
-	switch(I2Cx) {
-	case (uint32_t)I2C1: I2C1_MspDeInit(); break;
-	case (uint32_t)I2C2: I2C2_MspDeInit(); break;
-	case (uint32_t)I2C3: I2C3_MspDeInit(); break;
-	default: break;
+	// De-initialize the appropriate I2C peripheral
+	if (hi2c->Instance == I2C1) {
+		I2C1_MspDeInit();
+	} else if (hi2c->Instance == I2C2) {
+		I2C2_MspDeInit();
+	} else if (hi2c->Instance == I2C3) {
+		I2C3_MspDeInit();
 	}
 }
 
@@ -602,16 +985,17 @@ void I2C1_MspDeInit() {
 	// GPIO DeInit by I2C::deInitI2C()
 
 	// De-Initialize the DMA streams
-	if ( HAL_DMA_DeInit(&hdma_tx) != HAL_OK ) {
+	if ( HAL_DMA_DeInit(&hdma_tx[0]) != HAL_OK ) {
 		Error_Handler(errDC9000::I2C_DEINIT_ERROR);
 	}
-	if ( HAL_DMA_DeInit(&hdma_rx) != HAL_OK ) {
+	if ( HAL_DMA_DeInit(&hdma_rx[0]) != HAL_OK ) {
 		Error_Handler(errDC9000::I2C_DEINIT_ERROR);
 	}
 
 	// Disable the DMA TX/RX Interrupts
 	HAL_NVIC_DisableIRQ(I2C1_DMA_TX_IRQn);
 	HAL_NVIC_DisableIRQ(I2C1_DMA_RX_IRQn);
+	HAL_NVIC_DisableIRQ(I2C1_ER_IRQn);
 }
 
 /**
@@ -620,22 +1004,23 @@ void I2C1_MspDeInit() {
  */
 void I2C2_MspDeInit() {
 	// Reset peripheral
-	__HAL_RCC_I2C1_FORCE_RESET();
-	__HAL_RCC_I2C1_RELEASE_RESET();
+	__HAL_RCC_I2C2_FORCE_RESET();
+	__HAL_RCC_I2C2_RELEASE_RESET();
 
 	// GPIO DeInit by I2C::deInitI2C()
 
 	// De-Initialize the DMA streams
-	if ( HAL_DMA_DeInit(&hdma_tx) != HAL_OK ) {
+	if ( HAL_DMA_DeInit(&hdma_tx[1]) != HAL_OK ) {
 		Error_Handler(errDC9000::I2C_DEINIT_ERROR);
 	}
-	if ( HAL_DMA_DeInit(&hdma_rx) != HAL_OK ) {
+	if ( HAL_DMA_DeInit(&hdma_rx[1]) != HAL_OK ) {
 		Error_Handler(errDC9000::I2C_DEINIT_ERROR);
 	}
 
 	// Disable the DMA TX/RX Interrupts
 	HAL_NVIC_DisableIRQ(I2C2_DMA_TX_IRQn);
 	HAL_NVIC_DisableIRQ(I2C2_DMA_RX_IRQn);
+	HAL_NVIC_DisableIRQ(I2C2_ER_IRQn);
 }
 
 /**
@@ -644,22 +1029,23 @@ void I2C2_MspDeInit() {
  */
 void I2C3_MspDeInit() {
 	// Reset peripheral
-	__HAL_RCC_I2C1_FORCE_RESET();
-	__HAL_RCC_I2C1_RELEASE_RESET();
+	__HAL_RCC_I2C3_FORCE_RESET();
+	__HAL_RCC_I2C3_RELEASE_RESET();
 
 	// GPIO DeInit by I2C::deInitI2C()
 
 	// De-Initialize the DMA streams
-	if ( HAL_DMA_DeInit(&hdma_tx) != HAL_OK ) {
+	if ( HAL_DMA_DeInit(&hdma_tx[2]) != HAL_OK ) {
 		Error_Handler(errDC9000::I2C_DEINIT_ERROR);
 	}
-	if ( HAL_DMA_DeInit(&hdma_rx) != HAL_OK ) {
+	if ( HAL_DMA_DeInit(&hdma_rx[2]) != HAL_OK ) {
 		Error_Handler(errDC9000::I2C_DEINIT_ERROR);
 	}
 
 	// Disable the DMA TX/RX Interrupts
 	HAL_NVIC_DisableIRQ(I2C3_DMA_TX_IRQn);
 	HAL_NVIC_DisableIRQ(I2C3_DMA_RX_IRQn);
+	HAL_NVIC_DisableIRQ(I2C3_ER_IRQn);
 }
 
 /** @} Close I2C_Functions_DeInit group */
@@ -676,29 +1062,31 @@ void I2C3_MspDeInit() {
 /**
  * @brief Function called when master transmit is complete
  *
- * Currently does nothing. Can be used to signal that a Master write has
- * completed successfully.
+ * Routes to the owning bus, which retires the finished transfer.
  *
  * @param hi2c i2c configuration
- *
- * @todo Implement to add functionality
  */
 void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+	I2C *i2c = I2C::fromHandle(hi2c);
 
+	if (i2c != NULL) {
+		i2c->transferComplete();
+	}
 }
 
 /**
  * @brief Function called when master receive is complete
  *
- * Currently does nothing. Can be used to signal that a Master read has
- * completed successfully.
+ * Routes to the owning bus, which retires the finished transfer.
  *
  * @param hi2c i2c configuration
- *
- * @todo Implement to add functionality
  */
 void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+	I2C *i2c = I2C::fromHandle(hi2c);
 
+	if (i2c != NULL) {
+		i2c->transferComplete();
+	}
 }
 
 /**
@@ -728,45 +1116,74 @@ void HAL_I2C_SlaveRxCpltCallback(I2C_HandleTypeDef *hi2c) {
 /**
  * @brief Function called when master memory transmit is complete
  *
- * Currently does nothing. Can be used to signal that a Master write to
- * slave memory has completed successfully.
+ * Routes to the owning bus, which retires the finished transfer.
  *
  * @param hi2c i2c configuration
- *
- * @todo Implement to add functionality
  */
 void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+	I2C *i2c = I2C::fromHandle(hi2c);
 
+	if (i2c != NULL) {
+		i2c->transferComplete();
+	}
 }
 
 /**
  * @brief Function called when master memory receive is complete
  *
- * Currently does nothing. Can be used to signal that a Master read from
- * slave memory has completed successfully.
+ * Routes to the owning bus, which retires the finished transfer.
  *
  * @param hi2c i2c configuration
- *
- * @todo Implement to add functionality
  */
 void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+	I2C *i2c = I2C::fromHandle(hi2c);
 
+	if (i2c != NULL) {
+		i2c->transferComplete();
+	}
 }
 
 /**
  * @brief Function called when transmission error occurs
  *
- * Currently does nothing. Can be used to signal when an i2c error occurs
+ * Routes to the owning bus, which records the error for I2C::service() to
+ * retry, recover the bus or drop the transfer. An error on an unknown handle
+ * is fatal.
  *
  * @param hi2c i2c configuration
- *
- * @todo Implement to add functionality
  */
 void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
-	Error_Handler(errDC9000::I2C_IO_ERROR);
+	I2C *i2c = I2C::fromHandle(hi2c);
+
+	if (i2c != NULL) {
+		i2c->transferError();
+	} else {
+		Error_Handler(errDC9000::I2C_IO_ERROR);
+	}
 }
 #pragma GCC diagnostic pop
 
+/**
+ * @brief Handles the I2C1 error interrupt (bus error, arbitration lost, NACK, overrun)
+ */
+void I2C1_ER_IRQHandler(void) {
+	HAL_I2C_ER_IRQHandler(&i2c1Handle);
+}
+
+/**
+ * @brief Handles the I2C2 error interrupt (bus error, arbitration lost, NACK, overrun)
+ */
+void I2C2_ER_IRQHandler(void) {
+	HAL_I2C_ER_IRQHandler(&i2c2Handle);
+}
+
+/**
+ * @brief Handles the I2C3 error interrupt (bus error, arbitration lost, NACK, overrun)
+ */
+void I2C3_ER_IRQHandler(void) {
+	HAL_I2C_ER_IRQHandler(&i2c3Handle);
+}
+
 /** @} Close I2C_Functions_Callbacks group */
 
 /** @addtogroup I2C_Functions_Helpers Helper functions
@@ -775,27 +1192,94 @@ void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
  */
 
 /**
- * @brief Helper function to determine if an i2cPin is a clock pin
- * @param p Pin to check
- * @return True if p is an i2c clock pin, false otherwise
+ * @brief Releases a slave that is holding SDA low
+ * @param scl i2cPin used for the clock
+ * @param sda i2cPin used for the data
+ *
+ * Drives the pins as open-drain GPIO and clocks SCL (~100 kHz) up to
+ * I2C_RECOVERY_CLOCKS times until SDA is released, then generates a STOP.
+ * The pins must be handed back to the peripheral with initI2C().
  */
-bool isSclPin(i2cPin p) {
-	// Array corresponding to the i2cPin enum class
-	bool map[14] = {true, true, false, true, false, true, false, false, false, true, true, false, true, false};
+void i2cBusClear(int scl, int sda) {
+	GPIO_InitTypeDef GPIO_InitStruct;
+
+	GPIO_TypeDef *SCL_PORT = i2cPinToGPIO_TD[(int)scl];
+	GPIO_TypeDef *SDA_PORT = i2cPinToGPIO_TD[(int)sda];
+	uint16_t SCL_PIN = i2cPinToGpioPin[(int)scl];
+	uint16_t SDA_PIN = i2cPinToGpioPin[(int)sda];
 
-	return map[(int)p];
+	// Release both lines before switching them to GPIO
+	HAL_GPIO_WritePin(SCL_PORT, SCL_PIN, GPIO_PIN_SET);
+	HAL_GPIO_WritePin(SDA_PORT, SDA_PIN, GPIO_PIN_SET);
+
+	GPIO_InitStruct.Pin = SCL_PIN;
+	GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_OD;
+	GPIO_InitStruct.Pull = GPIO_PULLUP;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FAST;
+	GPIO_InitStruct.Alternate = 0;
+	HAL_GPIO_Init(SCL_PORT, &GPIO_InitStruct);	// SCL Pin
+
+	GPIO_InitStruct.Pin = SDA_PIN;
+	HAL_GPIO_Init(SDA_PORT, &GPIO_InitStruct);	// SDA Pin
+
+	// Clock out whatever byte the slave thinks it is sending
+	for (int i = 0; i < I2C_RECOVERY_CLOCKS; i++) {
+		if (HAL_GPIO_ReadPin(SDA_PORT, SDA_PIN) == GPIO_PIN_SET) {
+			break;
+		}
+		HAL_GPIO_WritePin(SCL_PORT, SCL_PIN, GPIO_PIN_RESET);
+		delayUs(5);
+		HAL_GPIO_WritePin(SCL_PORT, SCL_PIN, GPIO_PIN_SET);
+		delayUs(5);
+	}
+
+	// STOP condition: SDA rises while SCL is high
+	HAL_GPIO_WritePin(SCL_PORT, SCL_PIN, GPIO_PIN_RESET);
+	delayUs(5);
+	HAL_GPIO_WritePin(SDA_PORT, SDA_PIN, GPIO_PIN_RESET);
+	delayUs(5);
+	HAL_GPIO_WritePin(SCL_PORT, SCL_PIN, GPIO_PIN_SET);
+	delayUs(5);
+	HAL_GPIO_WritePin(SDA_PORT, SDA_PIN, GPIO_PIN_SET);
+	delayUs(5);
+}
+
+/**
+ * @brief Enables the clock of a GPIO port
+ * @param port GPIO port
+ *
+ * Compares pointers rather than switching on the port address, which lets
+ * the module build for a host (tests/test_i2c.cpp).
+ */
+static void gpioClockEnable(GPIO_TypeDef *port) {
+	if (port == GPIOA) {
+		__HAL_RCC_GPIOA_CLK_ENABLE();
+	} else if (port == GPIOB) {
+		__HAL_RCC_GPIOB_CLK_ENABLE();
+	} else if (port == GPIOC) {
+		__HAL_RCC_GPIOC_CLK_ENABLE();
+	} else if (port == GPIOD) {
+		__HAL_RCC_GPIOD_CLK_ENABLE();
+	} else if (port == GPIOE) {
+		__HAL_RCC_GPIOE_CLK_ENABLE();
+	} else if (port == GPIOF) {
+		__HAL_RCC_GPIOF_CLK_ENABLE();
+	} else if (port == GPIOH) {
+		__HAL_RCC_GPIOH_CLK_ENABLE();
+	} else if (port == GPIOI) {
+		__HAL_RCC_GPIOI_CLK_ENABLE();
+	}
 }
 
 /**
- * @brief Helper function to determine if an i2cPin is a data pin
- * @param p Pin to check
- * @return True if p is an i2c data pin, false otherwise
+ * @brief Busy-waits using the DWT cycle counter
+ * @param us Number of microseconds to wait
  */
-bool isSdaPin(i2cPin p) {
-	// Array corresponding to the i2cPin enum class
-	bool map[14] = {false, false, true, false, true, false, true, true, true, false, false, true, false, true};
+static void delayUs(uint32_t us) {
+	uint32_t start = DWT->CYCCNT;
+	uint32_t cycles = us * (SystemCoreClock / 1000000);
 
-	return map[(int)p];
+	while ((DWT->CYCCNT - start) < cycles);
 }
 
 /** @} Close I2C_Functions_Helpers group */
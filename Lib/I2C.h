@@ -112,52 +112,189 @@ enum class i2cPin {
 	PH8,	// I2C3_SDA
 };
 
-/// @todo Move to config
-#define I2C_SCL_PIN (i2cPin::PB6)
-#define I2C_SDA_PIN (i2cPin::PB9)
+/**
+ * @brief The i2c hardware peripherals; each is an independent bus
+ */
+enum class i2cBus {
+	BUS1 = 0,	// I2C1
+	BUS2,		// I2C2
+	BUS3		// I2C3
+};
+
+#define I2C_NUM_BUSES		3	///< Number of i2c hardware peripherals
+#define I2C_QUEUE_SIZE		8	///< Max number of pending transfers per bus
+#define I2C_XFER_BUFF_SIZE	8	///< Transfers up to this size are staged in the queue
+
+#define I2C_MAX_RETRIES		3		///< Retries per transfer after the first attempt
+#define I2C_RETRY_BUDGET_US	1000	///< Max time spent retrying/recovering a transfer [us]
+#define I2C_MAX_STALE		25		///< Consecutive failed reads before a sensor gives up
+#define I2C_RECOVERY_CLOCKS	9		///< SCL pulses used to release a stuck slave
+#define I2C_BUSY_WAIT_US	100		///< Max wait for BUSY to clear before declaring the bus stuck [us]
+#define I2C_XFER_TIMEOUT_US	2000	///< Max time a started transfer may run before it is declared stuck [us]
 
 /** @} Close I2C_Defines group */
 
+/**
+ * @brief Outcome of a queued i2c transfer
+ */
+enum class I2C_Status {
+	IDLE = 0,	// No transfer requested
+	PENDING,	// Queued or in progress
+	OK,			// Completed; data is fresh
+	FAILED		// Gave up after retries; read buffer holds the last good data
+};
+
+/**
+ * @brief Recovery action chosen after a failed transfer attempt
+ */
+enum class I2C_Action {
+	RETRY = 0,	// Restart the same transfer
+	RECOVER,	// Release the bus, re-init the peripheral, then retry
+	FAIL		// Out of retries or time; drop the transfer
+};
+
+/**
+ * @brief Type of a queued i2c transfer
+ */
+enum class I2C_Op {
+	WRITE = 0,
+	READ,
+	MEM_WRITE,
+	MEM_READ
+};
+
+/**
+ * @brief A single queued i2c transfer
+ *
+ * Small transfers are staged in buff. Writes are copied in when queued, so
+ * callers may pass pointers to local variables. Reads are copied out to pData
+ * only once they complete successfully, so a failed read leaves the caller's
+ * previous (good) data untouched. Larger transfers use pData directly, so the
+ * buffer must remain valid until I2C::readyWait() returns.
+ */
+typedef struct {
+	I2C_Op op;							///< Type of transfer
+	uint16_t devAddr;					///< Slave address (left-justified)
+	uint16_t memAddr;					///< Register address for memory transfers
+	uint8_t *pData;						///< Caller's data buffer
+	uint16_t size;						///< Number of bytes
+	bool staged;						///< True if the DMA uses buff instead of pData
+	uint8_t attempts;					///< Number of times the transfer was started
+	uint32_t firstStart;				///< Cycle count at the first attempt
+	volatile I2C_Status *status;		///< Optional completion status for the caller
+	uint8_t buff[I2C_XFER_BUFF_SIZE];	///< Staging buffer for small transfers
+} I2C_Transaction;
+
+/**
+ * @brief Per-bus utilization counters
+ *
+ * Cycle counts are taken from the DWT cycle counter, so utilization is
+ * busyCycles / elapsedCycles. The 32-bit counter wraps every ~25 s at
+ * 168 MHz, so the window they cover has to be restarted at least that often
+ * (I2C::restartWindow()). The other counters run until I2C::resetStats().
+ */
+typedef struct {
+	uint32_t transfers;		///< Completed transfers
+	uint32_t bytes;			///< Bytes moved by completed transfers
+	uint32_t errors;		///< Failed transfer attempts
+	uint32_t retries;		///< Attempts restarted after an error
+	uint32_t recoveries;	///< Bus releases and peripheral re-inits
+	uint32_t failures;		///< Transfers dropped after exhausting retries
+	uint32_t busyCycles;	///< CPU cycles the bus spent transferring in the window
+	uint32_t elapsedCycles;	///< CPU cycles since the window was restarted
+	uint8_t queuePeak;		///< Largest queue depth in the window
+} I2C_Stats;
+
 /**
  * @brief Class for low-level i2c operations
  *
- * This class is responsible for low-level i2c reads and writes. It uses a
- * singleton design pattern so that it is impossible to create more than one
- * instance. This is because i2c transfers are done via DMA. DMA completion
- * ISRs require the i2cHandle to be global.
+ * This class is responsible for low-level i2c reads and writes. There is one
+ * instance per i2c hardware peripheral (bus), so e.g. the barometer can sit on
+ * I2C2 and transfer in parallel with the IMU on I2C1. Each bus has its own
+ * HAL handle, DMA streams and transfer queue. DMA completion callbacks are
+ * routed back to the owning instance using I2C::fromHandle().
  *
  * To use the class, an I2C* must be fetched using I2C::Instance(). Reads and
  * writes (general and memory) can then be freely performed using the member
- * functions. If the i2c hardware peripheral is busy performing an I/O operation,
- * it will block until it is available to perform the next operation.
+ * functions. Transfers are queued and started from thread context by
+ * I2C::service(), which enqueue() and I2C::readyWait() call; readyWait()
+ * blocks until the bus queue has drained.
+ *
+ * The completion and error interrupts only retire the active transfer or
+ * record the error. Starting a transfer, aborting DMA and recovering the bus
+ * all poll HAL_GetTick(), which does not advance inside an ISR, so they are
+ * never done there.
+ *
+ * Failed transfers are retried within I2C_RETRY_BUDGET_US. Bus errors,
+ * arbitration loss, a stuck BUSY line and a transfer that does not complete
+ * within I2C_XFER_TIMEOUT_US additionally release the bus by clocking SCL and
+ * re-initialize the peripheral before retrying.
  */
 class I2C {
 private:
 	// Constructors are private so it can't be called from outside code
 
 	I2C();
-	I2C(i2cPin cl, i2cPin da);
+	I2C(i2cBus b, i2cPin cl, i2cPin da);
 	I2C(I2C const&);
 	I2C& operator=(I2C const&);
 
 	i2cPin scl;					///< i2c clock GPIO pin
 	i2cPin sda;					///< i2c data GPIO pin
+	i2cBus bus;					///< i2c hardware peripheral used
+
+	I2C_HandleTypeDef *handle;	///< HAL handle of the bus (global, see DMA_IT.h)
+
+	I2C_Transaction queue[I2C_QUEUE_SIZE];	///< Circular transfer queue
+	volatile uint8_t head;		///< Index of the active/next transfer
+	volatile uint8_t count;		///< Number of queued transfers
+	volatile bool busy;			///< True while a transfer is in progress
+	volatile bool errorPending;	///< Set by the error ISR, handled by service()
+	volatile uint32_t errorCode;	///< HAL_I2C_ERROR_x flags of the pending error
+	volatile bool servicing;	///< True while service() owns the bus
 
-	static I2C *i2cInstance;	///< Pointer to the singleton instance
+	I2C_Stats stats;			///< Utilization counters
+	uint32_t statsStart;		///< Cycle count at the start of the utilization window
+	volatile uint32_t xferStart;	///< Cycle count at the start of the active transfer
+
+	static I2C *i2cInstances[I2C_NUM_BUSES];	///< One instance per bus
+
+	int8_t enqueue(I2C_Op op, uint16_t devAddr, uint16_t memAddr, uint8_t *pData, uint16_t size, volatile I2C_Status *status);
+	int8_t startNext(void);
+	void finish(I2C_Status result);
+	void handleError(uint32_t errorCode);
+	void abortDma(void);
+	void recoverBus(void);
 
 public:
 	static I2C* Instance(i2cPin cl, i2cPin da);
+	static I2C* fromHandle(I2C_HandleTypeDef *hi2c);
+	static I2C* fromBus(i2cBus b);
 
 	int8_t write(uint16_t devAddr, uint8_t *pData, uint16_t size);
-	int8_t read(uint16_t devAddr, uint8_t *pData, uint16_t size);
+	int8_t read(uint16_t devAddr, uint8_t *pData, uint16_t size, volatile I2C_Status *status = NULL);
 
 	int8_t memWrite(uint16_t devAddr, uint16_t memAddr, uint8_t *pData, uint16_t size);
 
-	int8_t memRead(uint16_t devAddr, uint16_t memAddr, uint8_t *pData1, uint16_t size);
+	int8_t memRead(uint16_t devAddr, uint16_t memAddr, uint8_t *pData1, uint16_t size, volatile I2C_Status *status = NULL);
 
+	int8_t service(void);
 	void readyWait(void);
+
+	void transferComplete(void);
+	void transferError(void);
+
+	i2cBus getBus(void);
+	I2C_Stats getStats(void);
+	void resetStats(void);
+	void restartWindow(void);
 };
 
+bool isSclPin(i2cPin p);
+bool isSdaPin(i2cPin p);
+i2cBus i2cPinToBus(i2cPin p);
+I2C_Action i2cErrorAction(uint32_t errorCode, uint8_t attempts, uint32_t elapsedUs);
+bool i2cSensorLost(I2C_Status status, uint8_t *failures);
 
 #endif
 
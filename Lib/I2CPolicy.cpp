@@ -0,0 +1,123 @@
+/**
+ * @file
+ *
+ * @brief i2c pin map and error recovery policy
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * The parts of the I2C module that decide rather than drive: which bus a pin
+ * belongs to, and what to do after a failed transfer. They make no HAL calls,
+ * so they can be run on a host (tests/test_i2c.cpp).
+ *
+ */
+
+/** @addtogroup Peripherals
+ *  @{
+ */
+
+/** @addtogroup I2C
+ *  @{
+ */
+
+/** @addtogroup I2C_Functions
+ *  @{
+ */
+
+/** @addtogroup I2C_Functions_Helpers
+ *  @{
+ */
+
+#include "I2C.h"
+
+/**
+ * @brief Helper function to determine if an i2cPin is a clock pin
+ * @param p Pin to check
+ * @return True if p is an i2c clock pin, false otherwise
+ */
+bool isSclPin(i2cPin p) {
+	// Array corresponding to the i2cPin enum class
+	bool map[14] = {true, true, false, true, false, true, false, false, false, true, true, false, true, false};
+
+	return map[(int)p];
+}
+
+/**
+ * @brief Helper function to determine if an i2cPin is a data pin
+ * @param p Pin to check
+ * @return True if p is an i2c data pin, false otherwise
+ */
+bool isSdaPin(i2cPin p) {
+	// Array corresponding to the i2cPin enum class
+	bool map[14] = {false, false, true, false, true, false, true, true, true, false, false, true, false, true};
+
+	return map[(int)p];
+}
+
+/**
+ * @brief Helper function to determine which bus an i2cPin belongs to
+ * @param p Pin to check
+ * @return i2c bus driven by the pin
+ */
+i2cBus i2cPinToBus(i2cPin p) {
+	// Array corresponding to the i2cPin enum class
+	i2cBus map[14] = {i2cBus::BUS3, i2cBus::BUS1, i2cBus::BUS1, i2cBus::BUS1, i2cBus::BUS1,
+					  i2cBus::BUS2, i2cBus::BUS2, i2cBus::BUS3, i2cBus::BUS2, i2cBus::BUS2,
+					  i2cBus::BUS2, i2cBus::BUS2, i2cBus::BUS3, i2cBus::BUS3};
+
+	return map[(int)p];
+}
+
+/**
+ * @brief Recovery policy for a failed transfer attempt
+ * @param errorCode HAL_I2C_ERROR_x flags describing the failure
+ * @param attempts  Number of times the transfer has been started
+ * @param elapsedUs Time since the first attempt [us]
+ * @return Action to take
+ *
+ * Bus errors, arbitration loss and timeouts (stuck BUSY line) mean the bus
+ * state is unknown, so the bus is released before retrying. NACKs, overruns
+ * and DMA errors are simply retried. Does not touch hardware, so the policy
+ * can be exercised by injecting error codes.
+ */
+I2C_Action i2cErrorAction(uint32_t errorCode, uint8_t attempts, uint32_t elapsedUs) {
+	if (attempts > I2C_MAX_RETRIES || elapsedUs >= I2C_RETRY_BUDGET_US) {
+		return I2C_Action::FAIL;
+	}
+
+	if (errorCode & (HAL_I2C_ERROR_BERR | HAL_I2C_ERROR_ARLO | HAL_I2C_ERROR_TIMEOUT)) {
+		return I2C_Action::RECOVER;
+	}
+
+	return I2C_Action::RETRY;
+}
+
+/**
+ * @brief Counts consecutive failed reads of a sensor
+ * @param status   Status of the sensor's previous read
+ * @param failures Consecutive failure counter of the sensor
+ * @return True once I2C_MAX_STALE reads in a row have failed
+ *
+ * Sensors call this before starting a new read. A single failed read only
+ * leaves the last good sample in place (stale); a sensor that stays
+ * unreachable is eventually treated as lost.
+ */
+bool i2cSensorLost(I2C_Status status, uint8_t *failures) {
+	if (status == I2C_Status::FAILED) {
+		if (*failures < 255) {
+			(*failures)++;
+		}
+	} else if (status == I2C_Status::OK) {
+		*failures = 0;
+	}
+
+	return *failures >= I2C_MAX_STALE;
+}
+
+/** @} Close I2C_Functions_Helpers group */
+
+/** @} Close I2C_Functions group */
+
+/** @} Close I2C group */
+/** @} Close Peripherals Group */
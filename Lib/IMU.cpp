@@ -32,39 +32,148 @@
  */
 
 #include "IMU.h"
+#include "config.h"
+#include "mixer.h"
+#include "Params.h"
+#include "CycleCounter.h"
 #include <math.h>
+#include <string.h>
 
 // Define for whether or not pre-filtered sensor data should be used for calculations
 #define USE_PREFILTERED
 
+/// COMPLEMENTARY_TAU as the getRoll()/getPitch() filters take it
+#define COMP_FILTER_TAU PREFILTER_TAU_AT(COMPLEMENTARY_TAU, CONTROL_RATE_HZ)
+
 /**
  * @brief Create an IMU object with default sensor configurations
  *
- * Initializes each of the sensors and the required filters
+ * Initializes each of the sensors and the required filters. The sensor
+ * offsets are zero until calibrate().
  */
 IMU::IMU()
-	: barometer(), gyro(), accel(),
-	  aFilter_x(COMPLEMENTARY_TAU), aFilter_y(COMPLEMENTARY_TAU),
-	  gFilter_x(COMPLEMENTARY_TAU), gFilter_y(COMPLEMENTARY_TAU)
+	: barometer(BARO_SCL_PIN, BARO_SDA_PIN), gyro(), accel(),
+	  aFilter_x(COMP_FILTER_TAU), aFilter_y(COMP_FILTER_TAU),
+	  gFilter_x(COMP_FILTER_TAU), gFilter_y(COMP_FILTER_TAU),
+	  notch_x(CONTROL_RATE_HZ, DYN_NOTCH_COUNT), notch_y(CONTROL_RATE_HZ, DYN_NOTCH_COUNT),
+	  notch_z(CONTROL_RATE_HZ, DYN_NOTCH_COUNT),
+	  rpm_x(CONTROL_RATE_HZ, mixerFrameMotors(MOTOR_FRAME)), rpm_y(CONTROL_RATE_HZ, mixerFrameMotors(MOTOR_FRAME)),
+	  rpm_z(CONTROL_RATE_HZ, mixerFrameMotors(MOTOR_FRAME))
 {
 	// Initialize members
-	rate_roll = rate_pitch = angle_roll = angle_pitch = 0.0f;
-	log = logger::instance();
+	rate_roll = rate_pitch = rate_yaw = angle_roll = angle_pitch = 0.0f;
+	compTau = COMPLEMENTARY_TAU;
+	memset(&sample, 0, sizeof(sample));
+	onGround = true;
+	tempCount = 0;
+	notchNext = 0;
+}
+
+/**
+ * @brief Replace the gyro pre-filter design with the stored one
+ * @param init Gyro configuration, its prefilter is kept if GYRO_FILTER is invalid
+ * @return Configuration to construct the gyro with
+ */
+static L3GD20H_InitStruct paramPrefilter(L3GD20H_InitStruct init) {
+	init.prefilter = filterDesignFromIndex((uint8_t)paramGetInt(ParamId::GYRO_FILTER), init.prefilter);
+	return init;
+}
+
+/**
+ * @brief Replace the accelerometer pre-filter design with the stored one
+ * @param init Accelerometer configuration, its prefilter is kept if ACC_FILTER is invalid
+ * @return Configuration to construct the accelerometer with
+ */
+static LSM303D_InitStruct paramPrefilter(LSM303D_InitStruct init) {
+	init.prefilter = filterDesignFromIndex((uint8_t)paramGetInt(ParamId::ACC_FILTER), init.prefilter);
+	return init;
 }
 
 /**
  * @brief Create an IMU object with a given sensor configuration
  * @param gyroConfig  Configuration options for the gyro
  * @param accelConfig Configuration options for the accelerometer/magnetometer
+ *
+ * The pre-filter designs come from the GYRO_FILTER and ACC_FILTER parameters,
+ * so the parameters must be loaded (ParamStore::Instance()) first. The
+ * designs in the configurations are the fallback. The sensor offsets are zero
+ * until calibrate().
  */
 IMU::IMU(L3GD20H_InitStruct gyroConfig, LSM303D_InitStruct accelConfig)
-	: barometer(), gyro(gyroConfig), accel(accelConfig),
-	  aFilter_x(COMPLEMENTARY_TAU), aFilter_y(COMPLEMENTARY_TAU),
-	  gFilter_x(COMPLEMENTARY_TAU), gFilter_y(COMPLEMENTARY_TAU)
+	: barometer(BARO_SCL_PIN, BARO_SDA_PIN), gyro(paramPrefilter(gyroConfig)), accel(paramPrefilter(accelConfig)),
+	  aFilter_x(COMP_FILTER_TAU), aFilter_y(COMP_FILTER_TAU),
+	  gFilter_x(COMP_FILTER_TAU), gFilter_y(COMP_FILTER_TAU),
+	  notch_x(CONTROL_RATE_HZ, DYN_NOTCH_COUNT), notch_y(CONTROL_RATE_HZ, DYN_NOTCH_COUNT),
+	  notch_z(CONTROL_RATE_HZ, DYN_NOTCH_COUNT),
+	  rpm_x(CONTROL_RATE_HZ, mixerFrameMotors(MOTOR_FRAME)), rpm_y(CONTROL_RATE_HZ, mixerFrameMotors(MOTOR_FRAME)),
+	  rpm_z(CONTROL_RATE_HZ, mixerFrameMotors(MOTOR_FRAME))
 {
 	// Initialize members
-	rate_roll = rate_pitch = angle_roll = angle_pitch = 0.0f;
-	log = logger::instance();
+	rate_roll = rate_pitch = rate_yaw = angle_roll = angle_pitch = 0.0f;
+	compTau = COMPLEMENTARY_TAU;
+	memset(&sample, 0, sizeof(sample));
+	onGround = true;
+	tempCount = 0;
+	notchNext = 0;
+}
+
+/**
+ * @brief  Measure the gyro and accelerometer offsets
+ * @param  cal In: offsets stored by an earlier calibration, or temp
+ * 			   CAL_TEMP_NONE for none. Out: the offsets now in use. May be
+ * 			   NULL to always measure.
+ * @return Where the offsets came from. Only CalResult::MEASURED is worth
+ * 		   storing.
+ *
+ * Samples both sensors together at CONTROL_RATE_HZ until ImuCalibrator has
+ * the offsets: about 80 ms when the stored ones still fit, 160 ms from
+ * scratch if the vehicle keeps still, CAL_TIMEOUT at most. What they miss
+ * later, e.g. as the gyro warms up, is tracked from here on by the bias
+ * estimator (USE_BIAS_ESTIMATION).
+ */
+CalResult IMU::calibrate(ImuCalibration *cal) {
+	ImuCalibrator calibrator;
+	ImuCalibration offsets;
+	CalResult result;
+	uint32_t period = SystemCoreClock / CONTROL_RATE_HZ;
+
+	cycleCounterInit();
+	uint32_t last = DWT->CYCCNT;
+
+	// Measure without the old offsets
+	gyro.setOffsets(0.0f, 0.0f, 0.0f);
+	accel.setAccOffsets(0.0f, 0.0f, 0.0f);
+
+	float temp = gyro.readTemp();
+	calibrator.start(cal, temp);
+
+	do {
+		while (DWT->CYCCNT - last < period) {
+		}
+		uint32_t now = DWT->CYCCNT;
+		float dt = (float)(now - last) / (float)SystemCoreClock;
+		last = now;
+
+		accel.readAcc();
+		gyro.read();
+
+		float g[3] = { gyro.getX(), gyro.getY(), gyro.getZ() };
+		float a[3] = { accel.getAccX(), accel.getAccY(), accel.getAccZ() };
+		result = calibrator.update(g, a, dt);
+	} while (result == CalResult::RUNNING);
+
+	calibrator.getCalibration(&offsets);
+	gyro.setOffsets(offsets.gyro[0], offsets.gyro[1], offsets.gyro[2]);
+	accel.setAccOffsets(offsets.acc[0], offsets.acc[1], offsets.acc[2]);
+
+	// Nothing left over at the calibration temperature
+	bias.reset(temp);
+
+	if (cal != NULL) {
+		*cal = offsets;
+	}
+
+	return result;
 }
 
 /**
@@ -75,6 +184,14 @@ float IMU::getDT(void) {
 	return gyro.getDT();
 }
 
+/**
+ * @brief  Check whether the latest orientation used held sensor samples
+ * @return True if the last gyro or accelerometer read failed
+ */
+bool IMU::isStale(void) {
+	return gyro.isStale() || accel.isAccStale();
+}
+
 /**
  * @brief  Calculate the pitch angle
  * @return The pitch angle [deg]
@@ -99,11 +216,7 @@ float IMU::getPitch(void) {
 	float angle_x;
 	angle_x = atan2f(ax_f, sqrtf(ay_f*ay_f + az_f*az_f)) * 180.0f / PI;
 
-#ifdef LOG_ACC_ANGLE
-	char buff[100];
-	sprintf(buff, "P %f\n\r",angle_x);
-	log->log(buff);
-#endif
+	logMsg<LogMsg::ACC_PITCH>(angle_x);
 
 	// Alternate implementation
 //	angle_pitch = COMPLEMENTARY_TAU * (angle_pitch + gx_f * gyro.getDT()) + (1.0f - COMPLEMENTARY_TAU) * (angle_x);
@@ -147,11 +260,7 @@ float IMU::getRoll(void) {
 	float angle_y;
 	angle_y = atan2f(ay_f, sqrtf(ax_f*ax_f + az_f*az_f)) * 180.0f / PI;
 
-#ifdef LOG_ACC_ANGLE
-	char buff[100];
-	sprintf(buff, "R %f\n\r",angle_y);
-	log->log(buff);
-#endif
+	logMsg<LogMsg::ACC_ROLL>(angle_y);
 
 	// Alternate implementation
 //	angle_roll = COMPLEMENTARY_TAU * (angle_roll + gy_f * gyro.getDT()) + (1.0f-COMPLEMENTARY_TAU)*angle_y;
@@ -182,16 +291,25 @@ void IMU::getRollPitch(float *roll, float*pitch) {
 	gyro.read();
 
 	float ax_f, ay_f, az_f;
-	float gx_f, gy_f;
-#ifdef USE_PREFILTERED
-	// Fetch the pre-filtered accelerometer data [g]
+	float gx_f, gy_f, gz_f;
+#if defined USE_PREFILTERED
+	// Fetch the pre-filtered accelerometer data [g] (fixed-point if USE_FIXED_POINT)
 	ax_f = accel.getAccXFiltered();
 	ay_f = accel.getAccYFiltered();
 	az_f = accel.getAccZFiltered();
 
+#ifdef USE_RPM_NOTCH
+	// Remove the motor fundamentals and harmonics on all three axes ahead of
+	// the gyro pre-filter, so its lag and attenuation don't distort them
+	gx_f = gyro.filterX(rpm_x.filterSample(gyro.getX()));
+	gy_f = gyro.filterY(rpm_y.filterSample(gyro.getY()));
+	gz_f = gyro.filterZ(rpm_z.filterSample(gyro.getZ()));
+#else
 	// Fetch the pre-filtered gyroscope data [deg/s]
 	gx_f = gyro.getXFiltered();
 	gy_f = gyro.getYFiltered();
+	gz_f = gyro.getZFiltered();
+#endif
 #else
 	// Fetch the unfiltered accelerometer data [g]
 	ax_f = accel.getAccX();
@@ -201,6 +319,30 @@ void IMU::getRollPitch(float *roll, float*pitch) {
 	// Fetch the unfiltered gyroscope data [deg/s]
 	gx_f = gyro.getX();
 	gy_f = gyro.getY();
+	gz_f = gyro.getZ();
+
+#ifdef USE_RPM_NOTCH
+	// Remove the motor fundamentals and harmonics
+	gx_f = rpm_x.filterSample(gx_f);
+	gy_f = rpm_y.filterSample(gy_f);
+	gz_f = rpm_z.filterSample(gz_f);
+#endif
+#endif
+
+#ifdef USE_DYN_NOTCH
+	// Remove the tracked vibration peaks
+	gx_f = notch_x.filterSample(gx_f);
+	gy_f = notch_y.filterSample(gy_f);
+	gz_f = notch_z.filterSample(gz_f);
+#endif
+
+#ifdef USE_BIAS_ESTIMATION
+	// Remove the accelerometer offset learnt since calibrate(); the estimator
+	// itself wants the readings with it
+	float acc[3] = { ax_f, ay_f, az_f };
+	ax_f -= bias.getAccOffset(0);
+	ay_f -= bias.getAccOffset(1);
+	az_f -= bias.getAccOffset(2);
 #endif
 
 	// Calculate pitch & roll angles based on accelerometer data
@@ -208,14 +350,52 @@ void IMU::getRollPitch(float *roll, float*pitch) {
 	angle_x = atan2f(ax_f, sqrtf(ay_f*ay_f + az_f*az_f)) * 180.0f / PI;
 	angle_y = atan2f(ay_f, sqrtf(ax_f*ax_f + az_f*az_f)) * 180.0f / PI;
 
-#ifdef LOG_ACC_ANGLE
-	char buff1[100];
-	sprintf(buff1, "P %f\n\rR %f\n\r",angle_x,angle_y);
-	log->log(buff1);
+#ifdef USE_BIAS_ESTIMATION
+	// Track the gyro bias, then remove it from everything downstream
+	float rate[3] = { gx_f, gy_f, gz_f };
+	float accAngle[2] = { angle_x, angle_y };
+	bias.update(rate, acc, accAngle, onGround, gyro.getDT());
+	gx_f -= bias.getGyroBias(0);
+	gy_f -= bias.getGyroBias(1);
+	gz_f -= bias.getGyroBias(2);
 #endif
 
-	angle_pitch = COMPLEMENTARY_TAU * (angle_pitch + gx_f * gyro.getDT()) + (1.0f - COMPLEMENTARY_TAU) * (angle_x);
-	angle_roll  = COMPLEMENTARY_TAU * (angle_roll + gy_f * gyro.getDT()) + (1.0f-COMPLEMENTARY_TAU)*angle_y;
+	logMsg<LogMsg::ACC_ANGLES>(angle_x, angle_y);
+
+	// Complementary filter: integrated gyro term plus accelerometer term. The
+	// gyro weight comes from the time constant and the measured sample
+	// period, so the response doesn't depend on the loop rate.
+	float dt = gyro.getDT();
+	float a = compTau / (compTau + dt);
+	float gyro_x_f, gyro_y_f, angle_x_f, angle_y_f;
+	gyro_x_f = a * (angle_pitch + gx_f * dt);
+	gyro_y_f = a * (angle_roll + gy_f * dt);
+	angle_x_f = (1.0f - a) * angle_x;
+	angle_y_f = (1.0f - a) * angle_y;
+
+	logMsg<LogMsg::COMP_TERMS>(angle_x_f, angle_y_f, gyro_x_f, gyro_y_f);
+
+	angle_pitch = angle_x_f + gyro_x_f;
+	angle_roll  = angle_y_f + gyro_y_f;
+
+	// Rates for the rate loops, filtered the same way as for the angles
+	rate_pitch = gx_f;
+	rate_roll  = gy_f;
+	rate_yaw   = gz_f;
+
+#ifdef USE_BLACKBOX
+	// Keep the intermediate values for the flight recorder. getX()/getY()
+	// only rescale the last reading, so they don't disturb any filter.
+	sample.gyro[0] = gyro.getX();
+	sample.gyro[1] = gyro.getY();
+	sample.gyroFiltered[0] = gx_f;
+	sample.gyroFiltered[1] = gy_f;
+	sample.acc[0] = ax_f;
+	sample.acc[1] = ay_f;
+	sample.acc[2] = az_f;
+	sample.accAngle[0] = angle_x;
+	sample.accAngle[1] = angle_y;
+#endif
 
 	// Complementary filter the accelerometer calculated angle
 //	float angle_x_f, angle_y_f;
@@ -227,22 +407,114 @@ void IMU::getRollPitch(float *roll, float*pitch) {
 //	gyro_x_f = gFilter_x.filterSample(gx_f);
 //	gyro_y_f = gFilter_y.filterSample(gy_f);
 
-#ifdef LOG_COMP_FILTERED
-	char buff2[100];
-	sprintf(buff2, "Pf %f\n\rRf %f\n\rPdf %f\n\rRdf %f\n\r", angle_x_f, angle_y_f, gyro_x_f, gyro_y_f);
-	log->log(buff2);
-#endif
-
 	// Sum the two
 //	*pitch = angle_x_f + gyro_x_f;
 //	*roll  = angle_y_f + gyro_y_f;
 	*pitch = angle_pitch;
 	*roll  = angle_roll;
 
-#ifdef LOG_OUTPUT
-	char buff3[100];
-	sprintf(buff3, "PT %f\n\rRT %f\n\r", *pitch, *roll);
-	log->log(buff3);
+	logMsg<LogMsg::ATTITUDE>(*pitch, *roll);
+}
+
+/**
+ * @brief Get the angular rates used by the last getRollPitch()
+ * @param roll  [out] Roll rate [deg/s]
+ * @param pitch [out] Pitch rate [deg/s]
+ * @param yaw   [out] Yaw rate [deg/s]
+ *
+ * Roll and pitch have been through the same filters and notches as for the
+ * angles. Yaw has the pre-filter and the RPM notches, but no dynamic notch.
+ */
+void IMU::getRates(float *roll, float *pitch, float *yaw) {
+	*roll  = rate_roll;
+	*pitch = rate_pitch;
+	*yaw   = rate_yaw;
+}
+
+/**
+ * @brief Get the intermediate values of the last getRollPitch()
+ * @return Sample, only filled in when USE_BLACKBOX is defined
+ */
+const ImuSample *IMU::getSample(void) {
+	return &sample;
+}
+
+/**
+ * @brief Retune the vibration notches
+ *
+ * Runs the FFT analysis of at most one axis per call, taking the axes in
+ * turn. All three fill their buffers together, so this spreads the three
+ * FFTs over consecutive calls instead of running them back to back. Call
+ * from the background part of the main loop, after the motor outputs are
+ * updated; it runs on the control thread, so one call must fit in the slack
+ * of the outer slice.
+ */
+void IMU::updateNotch(void) {
+#ifdef USE_DYN_NOTCH
+	dynamicNotch *notch[3] = { &notch_x, &notch_y, &notch_z };
+
+	for (uint8_t i = 0; i < 3; i++) {
+		uint8_t axis = notchNext;
+		notchNext = (notchNext + 1) % 3;
+		if (notch[axis]->update()) {
+			break;
+		}
+	}
+#endif
+}
+
+/**
+ * @brief Move the RPM notches to new motor speeds
+ * @param rpm Mechanical RPM per motor in MOTOR_FRAME order, 0 if unknown
+ *
+ * Call from the background part of the main loop.
+ */
+void IMU::setMotorRpm(const float *rpm) {
+#ifdef USE_RPM_NOTCH
+	rpm_x.update(rpm);
+	rpm_y.update(rpm);
+	rpm_z.update(rpm);
+#else
+	(void)rpm;
+#endif
+}
+
+/**
+ * @brief Change the complementary filter time constant
+ * @param tau Time constant [s]; the accelerometer angle is trusted for
+ *            changes slower than this, the integrated gyro for faster ones
+ *
+ * Used by getRollPitch() from the next sample on (ParamId::COMP_TAU).
+ */
+void IMU::setComplementaryTau(float tau) {
+	compTau = tau;
+}
+
+/**
+ * @brief Tell the bias estimator whether the vehicle is on the ground
+ * @param ground True while disarmed
+ *
+ * On the ground, spells of keeping still measure the gyro bias directly. In
+ * flight only pitch and roll are corrected, against the accelerometer.
+ */
+void IMU::setOnGround(bool ground) {
+	onGround = ground;
+}
+
+/**
+ * @brief Feed the gyro temperature to the bias estimator
+ *
+ * Call every outer loop from the background part of the main loop. Every
+ * BIAS_TEMP_DIV calls the last temperature read is passed on and the next
+ * one is queued, so it never waits for the bus.
+ */
+void IMU::updateTemperature(void) {
+#ifdef USE_BIAS_ESTIMATION
+	if (++tempCount >= BIAS_TEMP_DIV) {
+		tempCount = 0;
+		bias.setTemperature(gyro.getTemp());
+		gyro.requestTemp();
+	}
 #endif
 }
 
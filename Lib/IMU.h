@@ -21,7 +21,7 @@
 #ifndef IMU_H_
 #define IMU_H_
 
-#include "logger.h"
+#include "Log.h"
 
 #include "LPS25H.h"
 #include "L3GD20H.h"
@@ -30,9 +30,20 @@
 #include "gyroCompFilter.h"
 #include "accelCompFilter2.h"
 #include "gyroCompFilter2.h"
+#include "dynamicNotch.h"
+#include "rpmNotch.h"
+#include "ImuCalibrator.h"
+#include "BiasEstimator.h"
 
-// Complementary filter time constant
-#define COMPLEMENTARY_TAU (0.8f)
+/**
+ * @brief Intermediate values of the last getRollPitch(), for the flight recorder
+ */
+typedef struct {
+	float gyro[2];			///< Gyro x, y rate before any filtering [deg/s]
+	float gyroFiltered[2];	///< Gyro x, y rate as used for the angles [deg/s]
+	float acc[3];			///< Accelerometer x, y, z as used for the angles [g]
+	float accAngle[2];		///< Pitch, roll from the accelerometer alone [deg]
+} ImuSample;
 
 /**
  * @brief Class for calculating orientation
@@ -47,28 +58,49 @@ private:
 	L3GD20H gyro;					///< Gyroscope object
 	LSM303D accel;					///< Accelerometer/Magnetometer object
 
-	logger *log;					///< Logger for gathering data
-
 	accelCompFilter aFilter_x;		///< Complementary filter for x-angle measured by accelerometer
 	accelCompFilter aFilter_y;		///< Complementary filter for y-angle measured by accelerometer
 	gyroCompFilter gFilter_x;		///< Complementary filter for x-rate measured by gyroscope
 	gyroCompFilter gFilter_y;		///< Complementary filter for y-rate measured by gyroscope
+	dynamicNotch notch_x;			///< Vibration notches for the x-rate
+	dynamicNotch notch_y;			///< Vibration notches for the y-rate
+	dynamicNotch notch_z;			///< Vibration notches for the z-rate
+	uint8_t notchNext;				///< Axis updateNotch() analyses first
+	rpmNotch rpm_x;					///< Motor RPM notches for the x-rate
+	rpmNotch rpm_y;					///< Motor RPM notches for the y-rate
+	rpmNotch rpm_z;					///< Motor RPM notches for the z-rate
+	BiasEstimator bias;				///< Gyro bias and accelerometer offset left after calibration
+	bool onGround;					///< Disarmed, so still spells can be used for the bias
+	uint8_t tempCount;				///< Outer loops since the last temperature read
 
 	float rate_roll;				///< The angular roll rate [deg/s]
 	float rate_pitch;				///< The angular pitch rate [deg/s]
+	float rate_yaw;					///< The angular yaw rate [deg/s]
 	float angle_roll;				///< The roll angle
 	float angle_pitch;				///< The pitch angle
+	float compTau;					///< Complementary filter time constant [s]
+	ImuSample sample;				///< Intermediate values of the last update
 
 public:
 	IMU();
 	IMU(L3GD20H_InitStruct gyroConfig, LSM303D_InitStruct accelConfig);
 
+	CalResult calibrate(ImuCalibration *cal);
+
 	float getDT(void);
+	bool isStale(void);
 
 	float getRoll(void);
 	float getPitch(void);
 
 	void getRollPitch(float *roll, float*pitch);
+	void getRates(float *roll, float *pitch, float *yaw);
+	const ImuSample *getSample(void);
+	void updateNotch(void);
+	void setMotorRpm(const float *rpm);
+	void setComplementaryTau(float tau);
+	void setOnGround(bool ground);
+	void updateTemperature(void);
 };
 
 #endif
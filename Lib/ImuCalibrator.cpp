@@ -0,0 +1,262 @@
+/**
+ * @file
+ *
+ * @brief Stationarity-gated gyro and accelerometer offset calibration
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Sensors
+ *  @{
+ */
+
+/** @defgroup IMUCAL IMU calibration
+ *  @brief Gyro and accelerometer offsets, measured while still or reused from flash
+ *  @{
+ */
+
+#include "ImuCalibrator.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * @brief Accelerometer reading at rest, level: gravity is -1 g on z
+ */
+static const float accRest[3] = { 0.0f, 0.0f, -1.0f };
+
+/**
+ * @brief Create an idle calibrator
+ *
+ * update() does nothing until start().
+ */
+ImuCalibrator::ImuCalibrator() {
+	start(NULL, CAL_TEMP_NONE);
+	result = CalResult::UNSETTLED;
+}
+
+/**
+ * @brief Start a calibration
+ * @param stored Offsets stored by an earlier calibration, NULL if none
+ * @param t      Gyro temperature now [degC], NAN if it couldn't be read
+ *
+ * The stored offsets are only considered if they were measured within
+ * CAL_CACHE_TEMP of t. Offsets measured without a temperature are tagged
+ * CAL_TEMP_NONE, so they are never reused.
+ */
+void ImuCalibrator::start(const ImuCalibration *stored, float t) {
+	result = CalResult::RUNNING;
+	temp = isnan(t) ? CAL_TEMP_NONE : t;
+	elapsed = 0.0f;
+	attempts = 0;
+
+	cacheUsable = false;
+	if (stored != NULL) {
+		cache = *stored;
+		cacheUsable = (temp != CAL_TEMP_NONE) && (stored->temp != CAL_TEMP_NONE)
+				&& (fabsf(temp - stored->temp) <= CAL_CACHE_TEMP);
+	} else {
+		memset(&cache, 0, sizeof(cache));
+		cache.temp = CAL_TEMP_NONE;
+	}
+
+	bestVar = INFINITY;
+	memset(bestMean, 0, sizeof(bestMean));
+	for (uint8_t c = 0; c < 3; c++) {
+		bestMean[3 + c] = accRest[c];
+	}
+	memset(&offsets, 0, sizeof(offsets));
+	offsets.temp = CAL_TEMP_NONE;
+
+	restart();
+}
+
+/**
+ * @brief Throw away the average so far and start a new one
+ */
+void ImuCalibrator::restart(void) {
+	memset(winSum, 0, sizeof(winSum));
+	memset(winSumSq, 0, sizeof(winSumSq));
+	memset(sum, 0, sizeof(sum));
+	memset(sumSq, 0, sizeof(sumSq));
+	winCount = 0;
+	windows = 0;
+	attempts++;
+}
+
+/**
+ * @brief End the calibration
+ * @param how  Where the offsets come from
+ * @param mean Average sensor readings to take the offsets from, or NULL for
+ * 			   the stored offsets
+ */
+void ImuCalibrator::finish(CalResult how, const float *mean) {
+	if (mean == NULL) {
+		offsets = cache;
+	} else {
+		for (uint8_t c = 0; c < 3; c++) {
+			offsets.gyro[c] = mean[c];
+			offsets.acc[c] = mean[3 + c] - accRest[c];
+		}
+		offsets.temp = temp;
+	}
+	result = how;
+}
+
+/**
+ * @brief Judge a full window: keep it, start over, or finish
+ */
+void ImuCalibrator::endWindow(void) {
+	float mean[CAL_CHANNELS];
+	float gyroVar = 0.0f;
+	bool quiet = true;
+
+	for (uint8_t c = 0; c < CAL_CHANNELS; c++) {
+		float m = winSum[c] / CAL_WINDOW;
+		float var = winSumSq[c] / CAL_WINDOW - m * m;
+
+		mean[c] = ref[c] + m;
+		if (c < 3) {
+			gyroVar += var;
+			quiet = quiet && (var <= CAL_GYRO_VAR);
+		} else {
+			quiet = quiet && (var <= CAL_ACC_VAR);
+		}
+	}
+
+	if (gyroVar < bestVar) {
+		bestVar = gyroVar;
+		memcpy(bestMean, mean, sizeof(bestMean));
+	}
+
+	// The first window decides whether the stored offsets will do. If the
+	// vehicle is being moved they are the best there is for a while.
+	if (cacheUsable) {
+		cacheUsable = false;
+
+		bool agrees = true;
+		for (uint8_t c = 0; c < 3; c++) {
+			agrees = agrees && (fabsf(mean[c] - cache.gyro[c]) <= CAL_CACHE_GYRO);
+		}
+		if (!quiet || agrees) {
+			finish(CalResult::CACHED, NULL);
+			return;
+		}
+	}
+
+	if (!quiet) {
+		restart();
+		return;
+	}
+
+	windows++;
+	bool settled = true;
+	for (uint8_t c = 0; c < CAL_CHANNELS; c++) {
+		sum[c] += winSum[c];
+		sumSq[c] += winSumSq[c];
+
+		float n = (float)windows * CAL_WINDOW;
+		float m = sum[c] / n;
+		mean[c] = ref[c] + m;
+
+		// Standard error of the gyro average: sqrt(variance / n)
+		if (c < 3) {
+			settled = settled && ((sumSq[c] / n - m * m) / n <= CAL_GYRO_SEM * CAL_GYRO_SEM);
+		}
+	}
+
+	if ((windows >= CAL_MIN_WINDOWS && settled) || windows >= CAL_MAX_WINDOWS) {
+		finish(CalResult::MEASURED, mean);
+		return;
+	}
+
+	memset(winSum, 0, sizeof(winSum));
+	memset(winSumSq, 0, sizeof(winSumSq));
+	winCount = 0;
+}
+
+/**
+ * @brief Add one sample
+ * @param gyro Gyro x, y, z, without offsets [deg/s]
+ * @param acc  Accelerometer x, y, z, without offsets [g]
+ * @param dt   Time since the last sample [s]
+ * @return CalResult::RUNNING until the offsets are known
+ */
+CalResult ImuCalibrator::update(const float *gyro, const float *acc, float dt) {
+	if (result != CalResult::RUNNING) {
+		return result;
+	}
+
+	float x[CAL_CHANNELS] = { gyro[0], gyro[1], gyro[2], acc[0], acc[1], acc[2] };
+
+	// Sums relative to the first sample keep the variances accurate in
+	// single precision, with gravity on the accelerometer
+	if (windows == 0 && winCount == 0) {
+		memcpy(ref, x, sizeof(ref));
+	}
+
+	for (uint8_t c = 0; c < CAL_CHANNELS; c++) {
+		float d = x[c] - ref[c];
+		winSum[c] += d;
+		winSumSq[c] += d * d;
+	}
+
+	if (++winCount >= CAL_WINDOW) {
+		endWindow();
+	}
+
+	elapsed += dt;
+	if (result == CalResult::RUNNING && elapsed >= CAL_TIMEOUT) {
+		// Never still long enough: quiet windows so far if there are enough,
+		// the quietest window otherwise
+		if (windows >= CAL_MIN_WINDOWS) {
+			float mean[CAL_CHANNELS];
+			for (uint8_t c = 0; c < CAL_CHANNELS; c++) {
+				mean[c] = ref[c] + sum[c] / ((float)windows * CAL_WINDOW);
+			}
+			finish(CalResult::MEASURED, mean);
+		} else {
+			finish(CalResult::UNSETTLED, bestMean);
+		}
+	}
+
+	return result;
+}
+
+/**
+ * @brief Get the outcome
+ * @return CalResult::RUNNING until done
+ */
+CalResult ImuCalibrator::getResult(void) {
+	return result;
+}
+
+/**
+ * @brief Get the offsets
+ * @param cal Returns the offsets and the temperature they were measured at.
+ * 			  All zero while RUNNING.
+ */
+void ImuCalibrator::getCalibration(ImuCalibration *cal) {
+	*cal = offsets;
+}
+
+/**
+ * @brief Get how many times the average was started
+ * @return 1, plus one for every time the vehicle moved
+ */
+uint8_t ImuCalibrator::getAttempts(void) {
+	return attempts;
+}
+
+/**
+ * @brief Get how long the calibration has taken
+ * @return Time since start() [s]
+ */
+float ImuCalibrator::getElapsed(void) {
+	return elapsed;
+}
+
+/** @} Close IMUCAL group */
+/** @} Close Sensors Group */
@@ -0,0 +1,126 @@
+/**
+ * @file
+ *
+ * @brief Stationarity-gated gyro and accelerometer offset calibration
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Replaces the fixed 128-sample averages the gyro and accelerometer each ran
+ * in turn at power-on (about 5 s together). Both sensors are averaged from
+ * the same samples, in windows of CAL_WINDOW. A window only counts if every
+ * axis is quiet (variance under CAL_GYRO_VAR / CAL_ACC_VAR); a noisy one
+ * means the vehicle was moved, and the average starts over. Calibration ends
+ * as soon as the gyro average is known to within CAL_GYRO_SEM, normally
+ * after CAL_MIN_WINDOWS.
+ *
+ * The result can be stored with the gyro temperature. On the next start at
+ * about the same temperature, one quiet window that agrees with the stored
+ * offsets is enough, and the stored offsets are used straight away if the
+ * vehicle is being moved.
+ *
+ * Does not touch hardware, so it can be run on synthetic sample streams on
+ * a host.
+ *
+ */
+
+/** @addtogroup Sensors
+ *  @{
+ */
+
+/** @addtogroup IMUCAL
+ *  @{
+ */
+
+#ifndef IMUCALIBRATOR_H_
+#define IMUCALIBRATOR_H_
+
+#include <stdint.h>
+
+#define CAL_WINDOW			16			///< Samples per stationarity window
+#define CAL_MIN_WINDOWS		2			///< Quiet windows before the average is trusted
+#define CAL_MAX_WINDOWS		8			///< Quiet windows after which it is used regardless
+#define CAL_GYRO_VAR		0.25f		///< Largest gyro variance in a quiet window [(deg/s)^2]
+#define CAL_ACC_VAR			1.0e-4f		///< Largest accelerometer variance in a quiet window [g^2]
+#define CAL_GYRO_SEM		0.02f		///< Gyro average uncertainty (standard error) to stop at [deg/s]
+#define CAL_TIMEOUT			3.0f		///< Longest wait for the vehicle to keep still [s]
+#define CAL_CACHE_TEMP		5.0f		///< Largest temperature change to reuse stored offsets [degC]
+#define CAL_CACHE_GYRO		0.5f		///< Largest gyro difference from the stored offsets [deg/s]
+#define CAL_TEMP_NONE		-128.0f		///< ImuCalibration::temp of no stored calibration
+
+#define CAL_CHANNELS		6			///< Gyro x, y, z, accelerometer x, y, z
+
+/**
+ * @brief Sensor offsets, subtracted from every sample
+ */
+typedef struct {
+	float gyro[3];		///< Gyro x, y, z at rest [deg/s]
+	float acc[3];		///< Accelerometer x, y, z at rest, less gravity (-1 g on z) [g]
+	float temp;			///< Gyro temperature when measured [degC], CAL_TEMP_NONE if unknown
+} ImuCalibration;
+
+/**
+ * @brief Where the offsets came from
+ */
+enum class CalResult : uint8_t {
+	RUNNING = 0,		///< Still sampling
+	MEASURED = 1,		///< Averaged over quiet windows, worth storing
+	CACHED = 2,			///< The stored offsets, confirmed or the vehicle was moving
+	UNSETTLED = 3		///< Never kept still; the quietest window. Don't store.
+};
+
+/**
+ * @brief Offset calibration from a stream of gyro and accelerometer samples
+ *
+ * Usage, one sample at a time at the sensor rate:
+ *
+ * 		cal.start(&stored, temp);		// or NULL with nothing stored
+ * 		while (cal.update(gyro, acc, dt) == CalResult::RUNNING) {
+ * 			// next sample
+ * 		}
+ * 		cal.getCalibration(&offsets);
+ */
+class ImuCalibrator {
+private:
+	CalResult result;					///< Outcome, RUNNING until done
+	ImuCalibration cache;				///< Stored offsets to try first
+	bool cacheUsable;					///< Stored offsets at a close enough temperature
+	float temp;							///< Gyro temperature now [degC]
+	float elapsed;						///< Time since start() [s]
+
+	float ref[CAL_CHANNELS];			///< First sample of this attempt; sums are relative to it
+	float winSum[CAL_CHANNELS];			///< Sum of this window's samples
+	float winSumSq[CAL_CHANNELS];		///< Sum of this window's squared samples
+	uint8_t winCount;					///< Samples in this window
+
+	float sum[CAL_CHANNELS];			///< Sum over the quiet windows of this attempt
+	float sumSq[CAL_CHANNELS];			///< Sum of squares over the quiet windows
+	uint8_t windows;					///< Quiet windows in this attempt
+	uint8_t attempts;					///< Windows that ended an attempt by moving, plus one
+
+	float bestVar;						///< Gyro variance of the quietest window so far
+	float bestMean[CAL_CHANNELS];		///< Average of the quietest window so far
+
+	ImuCalibration offsets;				///< Result, once done
+
+	void restart(void);
+	void endWindow(void);
+	void finish(CalResult how, const float *mean);
+
+public:
+	ImuCalibrator();
+
+	void start(const ImuCalibration *stored, float temp);
+	CalResult update(const float *gyro, const float *acc, float dt);
+
+	CalResult getResult(void);
+	void getCalibration(ImuCalibration *cal);
+	uint8_t getAttempts(void);
+	float getElapsed(void);
+};
+
+#endif
+
+/** @} Close IMUCAL group */
+/** @} Close Sensors Group */
@@ -26,24 +26,55 @@
 
 #include "L3GD20H.h"
 #include "errDC9000.h"
+#include "config.h"
+#include "Log.h"
+#include <math.h>
+
+#ifdef USE_FIXED_POINT
+/**
+ * Gyro IIR design for the fixed-point path, {b0, b1, b2, a1, a2} per section.
+ * Fs = 200 Hz (CONTROL_RATE_HZ), Fpass = 12.5 Hz, Fstop = 15 Hz, Apass = 0.1 dB, Astop = -40 dB
+ * (same design as preFilterGyro)
+ */
+static const float32_t gyroQ15Coef[15] = {
+	1, -1.67171299109, 1,
+	1.71022092712, -0.833197919132,
+	1, -0.631952192663, 1,
+	1.58706817569, -0.648599546625,
+	1, -1.77493127647, 1,
+	1.79913121367, -0.958726718288
+};
+#define GYRO_Q15_SECTIONS	3
+#define GYRO_Q15_GAIN		0.0118105736583f
+
+#define GYRO_FILTER_ARGS(design)	gyroQ15Coef, GYRO_Q15_SECTIONS, GYRO_Q15_GAIN
+
+/// Drop the headroom bits of a raw sample, rounding so the input isn't biased low
+#define GYRO_RAW_TO_Q15(raw)	(((int32_t)(raw) + (1 << (PREFILTER_Q15_HEADROOM - 1))) >> PREFILTER_Q15_HEADROOM)
+#else
+#define GYRO_FILTER_ARGS(design)	design, PREFILTER_TAU_AT(PREFILTER_TAU_S, CONTROL_RATE_HZ)
+#endif
 
 /**
  * @brief Instantiates an object using default I2C pins and configures the sensor to default
  */
 L3GD20H::L3GD20H(void)
-	: gx(PREFILTER_TAU), gy(PREFILTER_TAU), gz(PREFILTER_TAU)		// complementary
-//	: gx(), gy(), gz()												// IIR or FIR
+	: gx(GYRO_FILTER_ARGS(GYRO_PREFILTER))
+	, gy(GYRO_FILTER_ARGS(GYRO_PREFILTER))
+	, gz(GYRO_FILTER_ARGS(GYRO_PREFILTER))
 {
-	// Get a pointer to the logger
-	log = logger::instance();
-
 	// Initialize members
 	address = 0b11010110;
 	dt = prevTick = 0;
 	xOffset = yOffset = zOffset = 0.0f;
+	gyroStatus = I2C_Status::IDLE;
+	gyroFailures = 0;
+	tempBuff = 0;
+	tempStatus = I2C_Status::IDLE;
+	temperature = NAN;
 
 	// Get a pointer to the I2C instance
-	i2c = I2C::Instance(I2C_SCL_PIN, I2C_SDA_PIN);
+	i2c = I2C::Instance(IMU_SCL_PIN, IMU_SDA_PIN);
 
 	// Default gyro configuration
 	L3GD20H_InitStruct init;
@@ -51,6 +82,7 @@ L3GD20H::L3GD20H(void)
 	init.hpm_config 	= 	L3GD_HPM_Config::THREE;		// Normal mode
 	init.hpcf_config 	= 	L3GD_HPCF_Config::FIVE;		// 1 Hz cut-off frequency for 200 Hz ODR
 	init.fs_config 		= 	L3GD_FS_Config::MEDIUM;		// 500 dps full-scale
+	init.prefilter		=	GYRO_PREFILTER;
 	resolution = 17.50e-3f;
 
 	// Enable and configure the gyro
@@ -62,16 +94,19 @@ L3GD20H::L3GD20H(void)
  * @param init Sensor configuration parameters
  */
 L3GD20H::L3GD20H(L3GD20H_InitStruct init)
-	: gx(PREFILTER_TAU), gy(PREFILTER_TAU), gz(PREFILTER_TAU)		// complementary
-//	: gx(), gy(), gz()												// IIR or FIR
+	: gx(GYRO_FILTER_ARGS(init.prefilter))
+	, gy(GYRO_FILTER_ARGS(init.prefilter))
+	, gz(GYRO_FILTER_ARGS(init.prefilter))
 {
-	// Get a pointer to the logger
-	log = logger::instance();
-
 	// Initialize members
 	address = 0b11010110;
 	dt = prevTick = 0;
 	xOffset = yOffset = zOffset = 0.0f;
+	gyroStatus = I2C_Status::IDLE;
+	gyroFailures = 0;
+	tempBuff = 0;
+	tempStatus = I2C_Status::IDLE;
+	temperature = NAN;
 
 	// Gyro configuration
 	switch(init.fs_config) {
@@ -82,7 +117,7 @@ L3GD20H::L3GD20H(L3GD20H_InitStruct init)
 	}
 
 	// Get a pointer to the I2C instance
-	i2c = I2C::Instance(I2C_SCL_PIN, I2C_SDA_PIN);
+	i2c = I2C::Instance(IMU_SCL_PIN, IMU_SDA_PIN);
 
 	// Enable and configure the gyroscope
 	enable(init);
@@ -158,40 +193,71 @@ void L3GD20H::enable(L3GD20H_InitStruct init) {
 	if (HAL_TIM_Base_Start(&TimHandle) != HAL_OK) {
 		Error_Handler(errDC9000::L3G_INIT_ERROR);
 	}
+}
+
+/**
+ * @brief Set the offsets subtracted from every sample
+ * @param x X offset [dps]
+ * @param y Y offset [dps]
+ * @param z Z offset [dps]
+ *
+ * Offsets are zero until set, see IMU::calibrate().
+ */
+void L3GD20H::setOffsets(float x, float y, float z) {
+	xOffset = x;
+	yOffset = y;
+	zOffset = z;
+}
+
+/**
+ * @brief Read the die temperature
+ * @return Temperature [degC], NAN if the read failed
+ *
+ * Blocks until the bus is idle. The sensor's temperature has no factory
+ * offset, so it only compares readings from the same chip.
+ */
+float L3GD20H::readTemp(void) {
+	uint8_t buf = 0;
+	volatile I2C_Status status = I2C_Status::IDLE;
+
+	i2c->memRead(address, (uint8_t)L3GD20H_Reg::OUT_TEMP, &buf, 1, &status);
+	i2c->readyWait();
+
+	if (status != I2C_Status::OK) {
+		return NAN;
+	}
 
-	// Calibrate the sensor to eliminate offset error
-	calibrate();
+	// -1 LSB/degC
+	return -(float)(int8_t)buf;
 }
 
 /**
- * @brief Basic calibration to eliminate offset errors
+ * @brief Queue a read of the die temperature
  *
- * Initializes the offset members so offset error can be reduced/eliminated.
- * The sensor must remain stationary during calibration.
+ * Doesn't wait; the result is picked up by getTemp(). Does nothing while
+ * the last request is still queued.
  */
-void L3GD20H::calibrate() {
-	uint8_t samples = 128;
-	float gx_offset = 0.0f, gy_offset = 0.0f, gz_offset = 0.0f;
-
-	read();	// Initial read so values are correct
-	// Take some readings and accumulate
-	for (int i = 0; i < samples; i++) {
-		read();
-		gx_offset += getXFiltered();
-		gy_offset += getYFiltered();
-		gz_offset += getZFiltered();
-		HAL_Delay(20);
+void L3GD20H::requestTemp(void) {
+	if (tempStatus == I2C_Status::PENDING) {
+		return;
 	}
 
-	// Average the offsets
-	gx_offset = gx_offset / (float)samples;
-	gy_offset = gy_offset / (float)samples;
-	gz_offset = gz_offset / (float)samples;
+	i2c->memRead(address, (uint8_t)L3GD20H_Reg::OUT_TEMP, &tempBuff, 1, &tempStatus);
+}
+
+/**
+ * @brief Get the die temperature from the last completed requestTemp()
+ * @return Temperature [degC], NAN if no read has succeeded yet
+ *
+ * Doesn't wait. A failed read leaves the previous temperature.
+ */
+float L3GD20H::getTemp(void) {
+	if (tempStatus == I2C_Status::OK) {
+		// -1 LSB/degC
+		temperature = -(float)(int8_t)tempBuff;
+	}
 
-	// Save the offsets
-	xOffset = gx_offset;
-	yOffset = gy_offset;
-	zOffset = gz_offset;
+	return temperature;
 }
 
 /**
@@ -199,7 +265,12 @@ void L3GD20H::calibrate() {
  * @param htim Pointer to TimHandle
  */
 void HAL_TIM_Base_MspInit(TIM_HandleTypeDef *htim) {
-	__HAL_RCC_TIM6_CLK_ENABLE();
+	if (htim->Instance == TIM8) {
+		// Battery monitor ADC trigger
+		__HAL_RCC_TIM8_CLK_ENABLE();
+	} else {
+		__HAL_RCC_TIM6_CLK_ENABLE();
+	}
 }
 
 /**
@@ -212,7 +283,10 @@ float L3GD20H::getDT() {
 
 /**
  * @brief Initiates a read of all 3 axes
- * @note  Calls Error_Handler() on error
+ *
+ * If the read fails the previous sample is held and isStale() returns true.
+ *
+ * @note  Calls Error_Handler() if I2C_MAX_STALE reads in a row have failed
  */
 void L3GD20H::read(void) {
 //	HAL_GPIO_TogglePin(GPIOA, GPIO_PIN_4);
@@ -229,11 +303,24 @@ void L3GD20H::read(void) {
 	// Store counter value
 	prevTick = tmp;
 
-	// Read from the gyro registers
-
-	if (i2c->memRead(address, ( (uint8_t)L3GD20H_Reg::OUT_X_L | (1<<7) ), gyroBuff, 6) < 0) {
+	// Keep going on held samples unless the gyro has been gone too long
+	if (i2cSensorLost(gyroStatus, &gyroFailures)) {
 		Error_Handler(errDC9000::L3G_IO_ERROR);
 	}
+
+	// Read from the gyro registers; gyroBuff is only updated on success
+	i2c->memRead(address, ( (uint8_t)L3GD20H_Reg::OUT_X_L | (1<<7) ), gyroBuff, 6, &gyroStatus);
+}
+
+/**
+ * @brief  Check whether the latest read failed
+ * @return True if the getters return the last good (held) sample
+ */
+bool L3GD20H::isStale(void) {
+	// Wait for the measurement to be ready
+	i2c->readyWait();
+
+	return gyroStatus == I2C_Status::FAILED;
 }
 
 /**
@@ -254,11 +341,7 @@ int16_t L3GD20H::getXRaw(void) {
  */
 float L3GD20H::getX() {
 	float x = (float)getXRaw() * resolution - xOffset;
-#ifdef LOG_RAW
-	char buff[100];
-	sprintf(buff, "Gx %f\n\r", x);
-	log->log(buff);
-#endif
+	logMsg<LogMsg::GYRO_X>(x);
 	return x;
 }
 
@@ -267,15 +350,31 @@ float L3GD20H::getX() {
  * @return Filtered angular velocity about the x axis (pitch) [dps]
  */
 float L3GD20H::getXFiltered() {
-	float32_t x = getX();
-	float xf = gx.filterSample(&x);
-#ifdef LOG_PREFILTERED
-	char buff[100];
-	sprintf(buff, "Gxf %f\n\r", xf);
-	log->log(buff);
+#ifdef USE_FIXED_POINT
+	// Filter the raw sample as Q15, only the output is converted to a float
+	q15_t q = gx.filterSample(GYRO_RAW_TO_Q15(getXRaw()));
+	float xf = (float)((int32_t)q << PREFILTER_Q15_HEADROOM) * resolution - xOffset;
+	logMsg<LogMsg::GYRO_X_FILT>(xf);
+	return xf;
+#else
+	return filterX(getX());
 #endif
+}
+
+#ifndef USE_FIXED_POINT
+/**
+ * @brief  Function to pre-filter a rate about the x axis (pitch) taken with getX()
+ * @param  x Angular velocity about the x axis (pitch) [dps]
+ * @return Filtered angular velocity about the x axis (pitch) [dps]
+ *
+ * For filters that must run ahead of the pre-filter, e.g. the RPM notches.
+ */
+float L3GD20H::filterX(float x) {
+	float xf = gx.filterSample(x);
+	logMsg<LogMsg::GYRO_X_FILT>(xf);
 	return xf;
 }
+#endif
 
 /**
  * @brief  Function to get the rate of angular rotation about the y axis (roll)
@@ -295,11 +394,7 @@ int16_t L3GD20H::getYRaw(void) {
  */
 float L3GD20H::getY() {
 	float y = (float)getYRaw() * resolution - yOffset;
-#ifdef LOG_RAW
-	char buff[100];
-	sprintf(buff, "Gy %f\n\r", y);
-	log->log(buff);
-#endif
+	logMsg<LogMsg::GYRO_Y>(y);
 	return y;
 }
 
@@ -308,15 +403,31 @@ float L3GD20H::getY() {
  * @return Filtered angular velocity about the y axis (roll) [dps]
  */
 float L3GD20H::getYFiltered() {
-	float32_t y = getY();
-	float yf = gy.filterSample(&y);
-#ifdef LOG_PREFILTERED
-	char buff[100];
-	sprintf(buff, "Gyf %f\n\r", yf);
-	log->log(buff);
+#ifdef USE_FIXED_POINT
+	// Filter the raw sample as Q15, only the output is converted to a float
+	q15_t q = gy.filterSample(GYRO_RAW_TO_Q15(getYRaw()));
+	float yf = (float)((int32_t)q << PREFILTER_Q15_HEADROOM) * resolution - yOffset;
+	logMsg<LogMsg::GYRO_Y_FILT>(yf);
+	return yf;
+#else
+	return filterY(getY());
 #endif
+}
+
+#ifndef USE_FIXED_POINT
+/**
+ * @brief  Function to pre-filter a rate about the y axis (roll) taken with getY()
+ * @param  y Angular velocity about the y axis (roll) [dps]
+ * @return Filtered angular velocity about the y axis (roll) [dps]
+ *
+ * For filters that must run ahead of the pre-filter, e.g. the RPM notches.
+ */
+float L3GD20H::filterY(float y) {
+	float yf = gy.filterSample(y);
+	logMsg<LogMsg::GYRO_Y_FILT>(yf);
 	return yf;
 }
+#endif
 
 /**
  * @brief  Function to get the rate of angular rotation about the z axis (yaw)
@@ -336,11 +447,7 @@ int16_t L3GD20H::getZRaw(void) {
  */
 float L3GD20H::getZ() {
 	float z = (float)getZRaw() * resolution - zOffset;
-#ifdef LOG_RAW
-	char buff[100];
-	sprintf(buff, "Gz %f\n\r", z);
-	log->log(buff);
-#endif
+	logMsg<LogMsg::GYRO_Z>(z);
 	return z;
 }
 
@@ -349,15 +456,31 @@ float L3GD20H::getZ() {
  * @return Filtered angular velocity about the z axis (yaw) [dps]
  */
 float L3GD20H::getZFiltered() {
-	float32_t z = getZ();
-	float zf = gz.filterSample(&z);
-#ifdef LOG_PREFILTERED
-	char buff[100];
-	sprintf(buff, "Gzf %f\n\r", zf);
-	log->log(buff);
+#ifdef USE_FIXED_POINT
+	// Filter the raw sample as Q15, only the output is converted to a float
+	q15_t q = gz.filterSample(GYRO_RAW_TO_Q15(getZRaw()));
+	float zf = (float)((int32_t)q << PREFILTER_Q15_HEADROOM) * resolution - zOffset;
+	logMsg<LogMsg::GYRO_Z_FILT>(zf);
+	return zf;
+#else
+	return filterZ(getZ());
 #endif
+}
+
+#ifndef USE_FIXED_POINT
+/**
+ * @brief  Function to pre-filter a rate about the z axis (yaw) taken with getZ()
+ * @param  z Angular velocity about the z axis (yaw) [dps]
+ * @return Filtered angular velocity about the z axis (yaw) [dps]
+ *
+ * For filters that must run ahead of the pre-filter, e.g. the RPM notches.
+ */
+float L3GD20H::filterZ(float z) {
+	float zf = gz.filterSample(z);
+	logMsg<LogMsg::GYRO_Z_FILT>(zf);
 	return zf;
 }
+#endif
 
 /** @} Close L3GD20H group */
 /** @} Close IMU group */
@@ -29,13 +29,12 @@
 #define L3GD20H_H_
 
 #include "I2C.h"
-#include "logger.h"
+#include "config.h"
 
-#include "preFilter.h"
-#include "preFilter2.h"
-#include "preFilter3.h"
-#include "preFilterFIR.h"
-#include "preFilterGyro.h"
+#include "sensorFilter.h"
+#ifdef USE_FIXED_POINT
+#include "preFilterQ15.h"
+#endif
 
 /**
  * @brief Register enumerations for the ST L3GD20H gyro
@@ -518,6 +517,7 @@ typedef struct {
 	L3GD_HPM_Config		hpm_config;			///< High-pass filter mode setting
 	L3GD_HPCF_Config	hpcf_config;		///< High-pass filter cut-off frequency setting
 	L3GD_FS_Config		fs_config;			///< Full-scale setting
+	filterDesign		prefilter;			///< Pre-filter design for the rate outputs
 } L3GD20H_InitStruct;
 
 /** @} Close L3GD20H_Config group */
@@ -533,16 +533,26 @@ typedef struct {
  */
 class L3GD20H {
 private:
-	I2C *i2c;								///< I2C global instance
-	preFilter2 gx;							///< Filter to pre-filter raw gyro X-axis data
-	preFilter2 gy;							///< Filter to pre-filter raw gyro Y-axis data
-	preFilter2 gz;							///< Filter to pre-filter raw gyro Z-axis data
-
-	logger *log;							///< Logger instance for gathering data
+	I2C *i2c;								///< I2C bus instance
+#ifdef USE_FIXED_POINT
+	preFilterQ15 gx;						///< Fixed-point filter for raw gyro X-axis data
+	preFilterQ15 gy;						///< Fixed-point filter for raw gyro Y-axis data
+	preFilterQ15 gz;						///< Fixed-point filter for raw gyro Z-axis data
+#else
+	sensorFilter gx;						///< Filter to pre-filter raw gyro X-axis data
+	sensorFilter gy;						///< Filter to pre-filter raw gyro Y-axis data
+	sensorFilter gz;						///< Filter to pre-filter raw gyro Z-axis data
+#endif
 
 	float resolution;						///< Resolution setting
 
 	uint8_t gyroBuff[6];					///< Gyro angular velocity buffer
+	volatile I2C_Status gyroStatus;			///< Status of the last gyro read
+	uint8_t gyroFailures;					///< Consecutive failed gyro reads
+
+	uint8_t tempBuff;						///< Temperature buffer
+	volatile I2C_Status tempStatus;			///< Status of the last temperature read
+	float temperature;						///< Last temperature read [degC], NAN if none
 
 	TIM_HandleTypeDef TimHandle;			///< TIM for measuring sample rate
 	uint32_t prevTick;						///< Previous TIM count value
@@ -554,7 +564,6 @@ private:
 	uint8_t address;						///< Slave address of the chip
 
 	void enable(L3GD20H_InitStruct init);
-	void calibrate(void);
 
 	int16_t getXRaw(void);		// Roll
 	int16_t getYRaw(void);		// Pitch
@@ -566,7 +575,13 @@ public:
 
 	float getDT(void);
 
+	void setOffsets(float x, float y, float z);
+	float readTemp(void);
+	void requestTemp(void);
+	float getTemp(void);
+
 	void read(void);
+	bool isStale(void);
 
 	float getX(void);		// Roll
 	float getY(void);		// Pitch
@@ -574,6 +589,11 @@ public:
 	float getXFiltered(void);
 	float getYFiltered(void);
 	float getZFiltered(void);
+#ifndef USE_FIXED_POINT
+	float filterX(float x);
+	float filterY(float y);
+	float filterZ(float z);
+#endif
 };
 
 #endif
@@ -27,16 +27,37 @@
 #include "I2C.h"
 #include "LPS25H.h"
 #include "errDC9000.h"
+#include "config.h"
 
 /**
- * @brief Instantiates an object using default I2C pins
+ * @brief Instantiates an object on the barometer's default I2C pins
  */
 LPS25H::LPS25H(void) {
-	// Initialize member
+	// Initialize members
 	address = 0b10111010;
+	status = I2C_Status::IDLE;
+	failures = 0;
 
 	// Get a pointer to the I2C instance
-	i2c = I2C::Instance(I2C_SCL_PIN, I2C_SDA_PIN);
+	i2c = I2C::Instance(BARO_SCL_PIN, BARO_SDA_PIN);
+
+	// Enable and configure the altimeter
+	enable();
+}
+
+/**
+ * @brief Instantiates an object on a given i2c bus
+ * @param cl i2cPin used for the clock
+ * @param da i2cPin used for the data
+ */
+LPS25H::LPS25H(i2cPin cl, i2cPin da) {
+	// Initialize members
+	address = 0b10111010;
+	status = I2C_Status::IDLE;
+	failures = 0;
+
+	// Get a pointer to the I2C instance of the bus
+	i2c = I2C::Instance(cl, da);
 
 	// Enable and configure the altimeter
 	enable();
@@ -64,18 +85,20 @@ float LPS25H::readPressureMillibars(void) {
 
 /**
  * @brief  Initiates a new pressure read
- * @return The latest complete raw pressure reading
- * @note   Calls Error_Handler() on error
+ * @return The latest complete raw pressure reading (held if the read failed)
+ * @note   Calls Error_Handler() if I2C_MAX_STALE reads in a row have failed
  */
 int32_t LPS25H::readPressureRaw(void) {
-	// Initiate the i2c read
-	if ( i2c->memRead(address, ( (uint8_t)LPS25H_Reg::PRESS_OUT_XL | (1<<7) ), pressureBuff, 3) < 0 ) {
-		Error_Handler(errDC9000::LPS_IO_ERROR);
-	}
+	// Initiate the i2c read; pressureBuff is only updated on success
+	i2c->memRead(address, ( (uint8_t)LPS25H_Reg::PRESS_OUT_XL | (1<<7) ), pressureBuff, 3, &status);
 
 	// Wait for the read to complete
 	i2c->readyWait();
 
+	if (i2cSensorLost(status, &failures)) {
+		Error_Handler(errDC9000::LPS_IO_ERROR);
+	}
+
 	// Return the raw pressure value
 	return pressureBuff[2] << 16 | pressureBuff[1] << 8 | pressureBuff[0];
 }
@@ -91,22 +114,32 @@ float LPS25H::readTemperatureF(void) {
 
 /**
  * @brief  Initiates a new temperature read
- * @return The latest complete raw temperature reading
- * @note   Calls Error_Handler() on error
+ * @return The latest complete raw temperature reading (held if the read failed)
+ * @note   Calls Error_Handler() if I2C_MAX_STALE reads in a row have failed
  */
 int16_t LPS25H::readTemperatureRaw(void) {
-	// Initiate the i2c read
-	if ( i2c->memRead(address, ( (uint8_t)LPS25H_Reg::TEMP_OUT_L | (1<<7) ), temperatureBuff, 2) < 0 ) {
-		Error_Handler(errDC9000::LPS_IO_ERROR);
-	}
+	// Initiate the i2c read; temperatureBuff is only updated on success
+	i2c->memRead(address, ( (uint8_t)LPS25H_Reg::TEMP_OUT_L | (1<<7) ), temperatureBuff, 2, &status);
 
 	// Wait for the read to complete
 	i2c->readyWait();
 
+	if (i2cSensorLost(status, &failures)) {
+		Error_Handler(errDC9000::LPS_IO_ERROR);
+	}
+
 	// Return the raw temperature value
 	return (int16_t) (temperatureBuff[1] << 8 | temperatureBuff[0]);
 }
 
+/**
+ * @brief  Check whether the latest read failed
+ * @return True if the last returned reading was held from an earlier read
+ */
+bool LPS25H::isStale(void) {
+	return status == I2C_Status::FAILED;
+}
+
 /** @} Close LPS25H group */
 /** @} Close IMU group */
 /** @} Close Sensors Group */
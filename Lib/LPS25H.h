@@ -80,22 +80,27 @@ enum class LPS25H_Reg {
  */
 class LPS25H {
 private:
-	I2C *i2c;						///< I2C global instance
+	I2C *i2c;						///< I2C bus instance
 	uint8_t address;				///< Slave address of the chip
 
 	uint8_t pressureBuff[3];		///< Buffer to store pressure reading bytes
 	uint8_t temperatureBuff[2];		///< Buffer to store temperature reading bytes
+	volatile I2C_Status status;		///< Status of the last read
+	uint8_t failures;				///< Consecutive failed reads
 
 	void enable(void);
 
 public:
 	LPS25H(void);
+	LPS25H(i2cPin cl, i2cPin da);
 
 	float readPressureMillibars(void);
 	int32_t readPressureRaw(void);
 
 	float readTemperatureF(void);
 	int16_t readTemperatureRaw(void);
+
+	bool isStale(void);
 };
 
 #endif
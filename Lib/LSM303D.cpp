@@ -26,25 +26,54 @@
 
 #include "LSM303D.h"
 #include "errDC9000.h"
+#include "config.h"
+#include "Log.h"
+
+#ifdef USE_FIXED_POINT
+/**
+ * Accelerometer IIR design for the fixed-point path, {b0, b1, b2, a1, a2} per
+ * section. Fs = 200 Hz (CONTROL_RATE_HZ), Fpass = 2 Hz (same design as preFilterAcc). The poles
+ * sit too close to the unit circle for Q15, hence Q31.
+ */
+static const float32_t accQ31Coef[20] = {
+	1, -1.98982556714, 1,
+	1.97886614394, -0.982257780648,
+	1, -1.98002560283, 1,
+	1.96462573041, -0.966676926152,
+	1, -1.85755297101, 1,
+	1.95266174823, -0.95346779688,
+	1, -1.99202450372, 1,
+	1.99052519416, -0.994653975147
+};
+#define ACC_Q31_SECTIONS	4
+#define ACC_Q31_GAIN		9.91298688922e-05f
+
+/// Shift from a raw 16-bit sample to Q31, leaving PREFILTER_Q31_HEADROOM bits
+#define ACC_Q31_SHIFT		(16 - PREFILTER_Q31_HEADROOM)
+
+#define ACC_FILTER_ARGS(design)	accQ31Coef, ACC_Q31_SECTIONS, ACC_Q31_GAIN
+#else
+#define ACC_FILTER_ARGS(design)	design, PREFILTER_TAU_AT(PREFILTER_TAU_S, CONTROL_RATE_HZ)
+#endif
 
 /**
  * @brief Instantiates sensor with default configuration
  */
 LSM303D::LSM303D()
-	: ax(PREFILTER_TAU), ay(PREFILTER_TAU), az(PREFILTER_TAU)
-//	: ax(), ay(), az()
+	: ax(ACC_FILTER_ARGS(ACC_PREFILTER))
+	, ay(ACC_FILTER_ARGS(ACC_PREFILTER))
+	, az(ACC_FILTER_ARGS(ACC_PREFILTER))
 {
-	// Get a pointer to the logger
-	log = logger::instance();
-
 	// Save the i2c slave address of the sensor
 	address = 0b00111010;
 
 	// Initialize members
 	accXOffset = accYOffset = accZOffset = 0.0f;
+	accStatus = magStatus = I2C_Status::IDLE;
+	accFailures = magFailures = 0;
 
 	// Initialize the I2C pointer
-	i2c = I2C::Instance(I2C_SCL_PIN, I2C_SDA_PIN);
+	i2c = I2C::Instance(IMU_SCL_PIN, IMU_SDA_PIN);
 
 	// Default settings
 	LSM303D_InitStruct init;
@@ -55,6 +84,7 @@ LSM303D::LSM303D()
 	init.mres_config = LSM_MRES_Config::HIGH;		// Magnetometer high-resolution mode
 	init.mfs_config  = LSM_MFS_Config::FOUR;		// +/- 4 gauss Magnetometer full-scale
 	init.md_config   = LSM_MD_Config::CONTINUOUS;	// Magnetic sensor continuous mode
+	init.prefilter   = ACC_PREFILTER;
 	accResolution    = 0.122e-3f;
 	magResolution	 = 0.160e-3f;
 
@@ -67,20 +97,20 @@ LSM303D::LSM303D()
  * @param init Sensor configuration parameters
  */
 LSM303D::LSM303D(LSM303D_InitStruct init)
-	: ax(PREFILTER_TAU), ay(PREFILTER_TAU), az(PREFILTER_TAU)
-//	: ax(), ay(), az()
+	: ax(ACC_FILTER_ARGS(init.prefilter))
+	, ay(ACC_FILTER_ARGS(init.prefilter))
+	, az(ACC_FILTER_ARGS(init.prefilter))
 {
-	// Get a pointer to the logger
-	log = logger::instance();
-
 	// Save the i2c slave address of the sensor
 	address = 0b00111010;
 
 	// Initialize members
 	accXOffset = accYOffset = accZOffset = 0.0f;
+	accStatus = magStatus = I2C_Status::IDLE;
+	accFailures = magFailures = 0;
 
 	// Initialize the I2C pointer
-	i2c = I2C::Instance(I2C_SCL_PIN, I2C_SDA_PIN);
+	i2c = I2C::Instance(IMU_SCL_PIN, IMU_SDA_PIN);
 
 	// Determine the appropriate resolutions
 	switch(init.afs_config) {
@@ -157,40 +187,20 @@ void LSM303D::enable(LSM303D_InitStruct init) {
 //	GPIO_InitStruct.Pull	= GPIO_NOPULL;
 //	GPIO_InitStruct.Speed 	= GPIO_SPEED_FAST;
 //	HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
-
-	// Calibrate the sensor to eliminate offset error
-	accCalibrate();
 }
 
 /**
- * @brief Basic calibration to eliminate offset errors
+ * @brief Set the accelerometer offsets subtracted from every sample
+ * @param x X offset [g]
+ * @param y Y offset [g]
+ * @param z Z offset [g], less gravity (a level sensor reads -1 g on z)
  *
- * Initializes the offset members so offset error can be reduced/eliminated.
- * The sensor must remain stationary during calibration.
+ * Offsets are zero until set, see IMU::calibrate().
  */
-void LSM303D::accCalibrate(void) {
-	uint8_t samples = 128;
-	float ax_offset = 0.0f, ay_offset = 0.0f, az_offset = 0.0f;
-
-	readAcc();	// Initial read so values are correct
-	// Take some readings and accumulate
-	for (int i = 0; i < samples; i++) {
-		readAcc();
-		ax_offset += getAccXFiltered();
-		ay_offset += getAccYFiltered();
-		az_offset += getAccZFiltered();
-		HAL_Delay(20);
-	}
-
-	// Average the offsets
-	ax_offset = ax_offset / (float)samples;
-	ay_offset = ay_offset / (float)samples;
-	az_offset = (az_offset / (float)samples) + 1.0f;	// Subtract gravity
-
-	// Save the offsets
-	accXOffset = ax_offset;
-	accYOffset = ay_offset;
-	accZOffset = az_offset;
+void LSM303D::setAccOffsets(float x, float y, float z) {
+	accXOffset = x;
+	accYOffset = y;
+	accZOffset = z;
 }
 
 /**
@@ -204,13 +214,30 @@ void LSM303D::read(void) {
 
 /**
  * @brief Initiates a read of the accelerometer data registers
- * @note  Calls Error_Handler() on error
+ *
+ * If the read fails the previous sample is held and isAccStale() returns true.
+ *
+ * @note  Calls Error_Handler() if I2C_MAX_STALE reads in a row have failed
  */
 void LSM303D::readAcc(void) {
-	// Read from the accelerometer registers
-	if ( i2c->memRead(address, ( (uint8_t)LSM303D_Reg::OUT_X_L_A | (1<<7) ), accBuff, 6) < 0) {
+	// Keep going on held samples unless the accelerometer has been gone too long
+	if (i2cSensorLost(accStatus, &accFailures)) {
 		Error_Handler(errDC9000::LSM_IO_ERROR);
 	}
+
+	// Read from the accelerometer registers; accBuff is only updated on success
+	i2c->memRead(address, ( (uint8_t)LSM303D_Reg::OUT_X_L_A | (1<<7) ), accBuff, 6, &accStatus);
+}
+
+/**
+ * @brief  Check whether the latest accelerometer read failed
+ * @return True if the getters return the last good (held) sample
+ */
+bool LSM303D::isAccStale(void) {
+	// Wait for the measurement to be ready
+	i2c->readyWait();
+
+	return accStatus == I2C_Status::FAILED;
 }
 
 /**
@@ -231,11 +258,7 @@ int16_t LSM303D::getAccXRaw(void) {
  */
 float LSM303D::getAccX() {
 	float x = (float)getAccXRaw() * accResolution - accXOffset;
-#ifdef LOG_RAW
-	char buff[100];
-	sprintf(buff, "Ax %f\n\r", x);
-	log->log(buff);
-#endif
+	logMsg<LogMsg::ACC_X>(x);
 	return x;
 }
 
@@ -244,13 +267,14 @@ float LSM303D::getAccX() {
  * @return Filtered X acceleration (g)
  */
 float LSM303D::getAccXFiltered() {
-	float32_t x = getAccX();
-	float xf = ax.filterSample(&x);
-#ifdef LOG_PREFILTERED
-	char buff[100];
-	sprintf(buff, "Axf %f\n\r", xf);
-	log->log(buff);
+#ifdef USE_FIXED_POINT
+	// Filter the raw sample as Q31, only the output is converted to a float
+	q31_t q = ax.filterSample((q31_t)getAccXRaw() << ACC_Q31_SHIFT);
+	float xf = (float)q * (accResolution / (float)(1 << ACC_Q31_SHIFT)) - accXOffset;
+#else
+	float xf = ax.filterSample(getAccX());
 #endif
+	logMsg<LogMsg::ACC_X_FILT>(xf);
 	return xf;
 }
 
@@ -272,11 +296,7 @@ int16_t LSM303D::getAccYRaw(void) {
  */
 float LSM303D::getAccY() {
 	float y = (float)getAccYRaw() * accResolution - accYOffset;
-#ifdef LOG_RAW
-	char buff[100];
-	sprintf(buff, "Ay %f\n\r", y);
-	log->log(buff);
-#endif
+	logMsg<LogMsg::ACC_Y>(y);
 	return y;
 }
 
@@ -285,13 +305,14 @@ float LSM303D::getAccY() {
  * @return Filtered Y accleration (g)
  */
 float LSM303D::getAccYFiltered() {
-	float32_t y = getAccY();
-	float yf = ay.filterSample(&y);
-#ifdef LOG_PREFILTERED
-	char buff[100];
-	sprintf(buff, "Ayf %f\n\r", yf);
-	log->log(buff);
+#ifdef USE_FIXED_POINT
+	// Filter the raw sample as Q31, only the output is converted to a float
+	q31_t q = ay.filterSample((q31_t)getAccYRaw() << ACC_Q31_SHIFT);
+	float yf = (float)q * (accResolution / (float)(1 << ACC_Q31_SHIFT)) - accYOffset;
+#else
+	float yf = ay.filterSample(getAccY());
 #endif
+	logMsg<LogMsg::ACC_Y_FILT>(yf);
 	return yf;
 }
 
@@ -313,11 +334,7 @@ int16_t LSM303D::getAccZRaw(void) {
  */
 float LSM303D::getAccZ() {
 	float z = (float)getAccZRaw() * accResolution - accZOffset;
-#ifdef LOG_RAW
-	char buff[100];
-	sprintf(buff, "Az %f\n\r", z);
-	log->log(buff);
-#endif
+	logMsg<LogMsg::ACC_Z>(z);
 	return z;
 }
 
@@ -326,25 +343,43 @@ float LSM303D::getAccZ() {
  * @return Filtered Z acceleration (g)
  */
 float LSM303D::getAccZFiltered() {
-	float32_t z = getAccZ();
-	float zf = az.filterSample(&z);
-#ifdef LOG_PREFILTERED
-	char buff[100];
-	sprintf(buff, "Azf %f\n\r", zf);
-	log->log(buff);
+#ifdef USE_FIXED_POINT
+	// Filter the raw sample as Q31, only the output is converted to a float
+	q31_t q = az.filterSample((q31_t)getAccZRaw() << ACC_Q31_SHIFT);
+	float zf = (float)q * (accResolution / (float)(1 << ACC_Q31_SHIFT)) - accZOffset;
+#else
+	float zf = az.filterSample(getAccZ());
 #endif
+	logMsg<LogMsg::ACC_Z_FILT>(zf);
 	return zf;
 }
 
 /**
  * @brief Initiates a read of all 3 magnetometer axes
- * @note  Calls Error_Handler() on error
+ *
+ * If the read fails the previous sample is held and isMagStale() returns true.
+ *
+ * @note  Calls Error_Handler() if I2C_MAX_STALE reads in a row have failed
  */
 void LSM303D::readMag(void) {
-	if ( i2c->memRead(address, ( (uint8_t)LSM303D_Reg::OUT_X_L_M | (1<<7) ), magBuff, 6) < 0) {
+	// Keep going on held samples unless the magnetometer has been gone too long
+	if (i2cSensorLost(magStatus, &magFailures)) {
 		Error_Handler(errDC9000::LSM_IO_ERROR);
 	}
 
+	// magBuff is only updated on success
+	i2c->memRead(address, ( (uint8_t)LSM303D_Reg::OUT_X_L_M | (1<<7) ), magBuff, 6, &magStatus);
+}
+
+/**
+ * @brief  Check whether the latest magnetometer read failed
+ * @return True if the getters return the last good (held) sample
+ */
+bool LSM303D::isMagStale(void) {
+	// Wait for the measurement to be ready
+	i2c->readyWait();
+
+	return magStatus == I2C_Status::FAILED;
 }
 
 /**
@@ -29,13 +29,12 @@
 #define LSM303D_H_
 
 #include "I2C.h"
-#include "logger.h"
+#include "config.h"
 
-#include "preFilter.h"
-#include "preFilter2.h"
-#include "preFilter3.h"
-#include "preFilterFIR.h"
-#include "preFilterAcc.h"
+#include "sensorFilter.h"
+#ifdef USE_FIXED_POINT
+#include "preFilterQ31.h"
+#endif
 
 /**
  * @brief Register enumerations for the ST LSM303D accelerometer/magnetometer
@@ -392,6 +391,7 @@ typedef struct {
 	LSM_MRES_Config mres_config;	///< Magnetometer resolution setting
 	LSM_MFS_Config	mfs_config;		///< Magnetometer full-scale setting
 	LSM_MD_Config	md_config;		///< Magnetic sensor mode setting
+	filterDesign	prefilter;		///< Pre-filter design for the acceleration outputs
 } LSM303D_InitStruct;
 
 /** @} Close LSM303D_Config group */
@@ -408,24 +408,31 @@ typedef struct {
  */
 class LSM303D {
 private:
-	I2C *i2c;					///< I2C global instance
-	preFilter2 ax;				///< Filter to pre-filter raw accelerometer X-axis data
-	preFilter2 ay;				///< Filter to pre-filter raw accelerometer Y-axis data
-	preFilter2 az;				///< Filter to pre-filter raw accelerometer Z-axis data
-
-	logger *log;				///< Logger instance for gathering data
+	I2C *i2c;					///< I2C bus instance
+#ifdef USE_FIXED_POINT
+	preFilterQ31 ax;			///< Fixed-point filter for raw accelerometer X-axis data
+	preFilterQ31 ay;			///< Fixed-point filter for raw accelerometer Y-axis data
+	preFilterQ31 az;			///< Fixed-point filter for raw accelerometer Z-axis data
+#else
+	sensorFilter ax;			///< Filter to pre-filter raw accelerometer X-axis data
+	sensorFilter ay;			///< Filter to pre-filter raw accelerometer Y-axis data
+	sensorFilter az;			///< Filter to pre-filter raw accelerometer Z-axis data
+#endif
 
 	float accResolution;		///< Accelerometer resolution setting
 	float magResolution;		///< Magnetometer resolution setting
 
 	uint8_t accBuff[6];			///< Accelerometer buffer
+	volatile I2C_Status accStatus;	///< Status of the last accelerometer read
+	uint8_t accFailures;		///< Consecutive failed accelerometer reads
 
 	uint8_t magBuff[6];			///< Magnetometer buffer
+	volatile I2C_Status magStatus;	///< Status of the last magnetometer read
+	uint8_t magFailures;		///< Consecutive failed magnetometer reads
 
 	uint8_t address;			///< Slave address of the chip
 
 	void enable(LSM303D_InitStruct init);
-	void accCalibrate(void);
 
 	int16_t getAccXRaw(void);
 	int16_t getAccYRaw(void);
@@ -446,6 +453,8 @@ public:
 	void read(void);
 
 	void readAcc(void);
+	bool isAccStale(void);
+	void setAccOffsets(float x, float y, float z);
 	float getAccX(void);
 	float getAccY(void);
 	float getAccZ(void);
@@ -454,6 +463,7 @@ public:
 	float getAccZFiltered(void);
 
 	void readMag(void);
+	bool isMagStale(void);
 	float getMagX(void);
 	float getMagY(void);
 	float getMagZ(void);
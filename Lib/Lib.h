@@ -119,6 +119,15 @@
  * | I2C3 |      TX        |  1  |   4    |    3    |
  * |      |      RX        |  1  |   2    |    3    |
  *
+ * Each peripheral is an independent bus with its own I2C instance, DMA streams and transfer queue, so
+ * sensors on different buses transfer concurrently. The sensor pins are set in config.h (IMU_SCL_PIN,
+ * BARO_SCL_PIN, ...). Per-bus utilization is available from I2C::getStats() and is sent bus by bus in the
+ * I2C_BUS telemetry frames.
+ *
+ * Failed transfers do not abort the flight. They are retried for up to I2C_RETRY_BUDGET_US; bus errors,
+ * arbitration loss and a stuck bus are first cleared by clocking SCL and re-initializing the peripheral.
+ * Meanwhile sensors hold their last good sample and report it as stale. Only a sensor that stays
+ * unreachable for I2C_MAX_STALE reads in a row calls Error_Handler().
  *
  * I2C is used to read and write from the AltIMU10-v4. See @ref sensors_IMU for more information.
  *
@@ -0,0 +1,60 @@
+/**
+ * @file
+ *
+ * @brief Log categories and levels on top of the binary logger
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @defgroup LOG Log categories & levels
+ *  @brief Build-time and run-time filtering of binary log messages
+ *  @{
+ */
+
+#include "Log.h"
+
+// Everything the build includes is on until the parameters say otherwise
+volatile uint32_t Log::categories = logBuildCategories;
+volatile uint8_t Log::level = LOG_MAX_LEVEL;
+
+/**
+ * @brief Choose the categories to log
+ * @param mask LOG_CAT_BIT() mask. Categories not compiled in stay off.
+ */
+void Log::setCategories(uint32_t mask) {
+	categories = mask & logBuildCategories;
+}
+
+/**
+ * @brief Choose the most detailed level to log
+ * @param l LogLevel value. Levels above LOG_MAX_LEVEL stay off.
+ */
+void Log::setLevel(uint8_t l) {
+	level = (l > LOG_MAX_LEVEL) ? LOG_MAX_LEVEL : l;
+}
+
+/**
+ * @brief Get the categories being logged
+ * @return LOG_CAT_BIT() mask
+ */
+uint32_t Log::getCategories(void) {
+	return categories;
+}
+
+/**
+ * @brief Get the most detailed level being logged
+ * @return LogLevel value
+ */
+uint8_t Log::getLevel(void) {
+	return level;
+}
+
+/** @} Close LOG group */
+/** @} Close System group */
@@ -0,0 +1,167 @@
+/**
+ * @file
+ *
+ * @brief Log categories and levels on top of the binary logger
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Every message in LogMessages.h has a category and a level. Two filters
+ * decide whether logMsg<LogMsg::X>(...) does anything:
+ * 		- Build time: the category's LOG_xxx define in config.h, and
+ * 		  LOG_MAX_LEVEL. A message that fails this compiles to nothing - no
+ * 		  call, no code, no argument words.
+ * 		- Run time: Log::setCategories() and Log::setLevel(), from the
+ * 		  LOG_CATEGORIES and LOG_LEVEL parameters. These can only narrow what
+ * 		  the build includes, and cost one load and compare per message.
+ *
+ * Arguments are checked against the format whether or not the message is
+ * compiled in, so a disabled log line can't rot.
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup LOG Log categories & levels
+ *  @{
+ */
+
+#ifndef LOG_H_
+#define LOG_H_
+
+#include <stdint.h>
+#include <type_traits>
+#include "config.h"
+#include "BinLog.h"
+
+/**
+ * @brief Log categories, what a message is about
+ */
+enum class LogCat : uint8_t {
+	RAW,				///< Raw sensor readings (LOG_RAW)
+	PREFILTERED,		///< Pre-filtered sensor readings (LOG_PREFILTERED)
+	ACC_ANGLE,			///< Angles from the accelerometer alone (LOG_ACC_ANGLE)
+	COMP_FILTERED,		///< Complementary filter terms (LOG_COMP_FILTERED)
+	OUTPUT,				///< Attitude estimate (LOG_OUTPUT)
+	NUM_CATS
+};
+
+/**
+ * @brief Log levels, most important first
+ */
+enum class LogLevel : uint8_t {
+	FAULT = 0,			///< Something failed
+	WARNING = 1,		///< Something looks wrong
+	INFO = 2,			///< Per-loop state
+	VERBOSE = 3			///< Per-sample detail
+};
+
+#define LOG_CAT_BIT(cat) (1u << (uint8_t)LogCat::cat)
+
+/**
+ * @brief Categories compiled in, from the config.h defines
+ */
+static constexpr uint32_t logBuildCategories = 0
+#ifdef LOG_RAW
+	| LOG_CAT_BIT(RAW)
+#endif
+#ifdef LOG_PREFILTERED
+	| LOG_CAT_BIT(PREFILTERED)
+#endif
+#ifdef LOG_ACC_ANGLE
+	| LOG_CAT_BIT(ACC_ANGLE)
+#endif
+#ifdef LOG_COMP_FILTERED
+	| LOG_CAT_BIT(COMP_FILTERED)
+#endif
+#ifdef LOG_OUTPUT
+	| LOG_CAT_BIT(OUTPUT)
+#endif
+	;
+
+#define LOG_MSG_CAT(id, cat, level, fmt) LogCat::cat,
+static constexpr LogCat logCategories[] = {
+	LOG_MESSAGES(LOG_MSG_CAT)
+};
+#undef LOG_MSG_CAT
+
+#define LOG_MSG_LEVEL(id, cat, level, fmt) LogLevel::level,
+static constexpr LogLevel logLevels[] = {
+	LOG_MESSAGES(LOG_MSG_LEVEL)
+};
+#undef LOG_MSG_LEVEL
+
+/**
+ * @brief Check whether a message is compiled in
+ */
+constexpr bool logBuilt(LogMsg id) {
+	return ((logBuildCategories >> (uint8_t)logCategories[(uint16_t)id]) & 1) != 0 &&
+			(uint8_t)logLevels[(uint16_t)id] <= LOG_MAX_LEVEL;
+}
+
+/**
+ * @brief Run-time log filter
+ *
+ * All members are static, like BinLog, so interrupts can log at any time.
+ */
+class Log {
+private:
+	static volatile uint32_t categories;	///< Enabled categories, LOG_CAT_BIT() mask
+	static volatile uint8_t level;			///< Highest enabled level
+
+public:
+	static void setCategories(uint32_t mask);
+	static void setLevel(uint8_t l);
+
+	static uint32_t getCategories(void);
+	static uint8_t getLevel(void);
+
+	/**
+	 * @brief Check the run-time filter for a message
+	 * @param id Message
+	 * @return true if its category and level are enabled
+	 */
+	static inline bool enabled(LogMsg id) {
+		return ((categories >> (uint8_t)logCategories[(uint16_t)id]) & 1) != 0 &&
+				(uint8_t)logLevels[(uint16_t)id] <= level;
+	}
+};
+
+/**
+ * @brief Compiled-out message: nothing at all
+ */
+template<LogMsg ID, typename... Args>
+__attribute__((always_inline)) inline void logSend(std::false_type, Args...) {
+}
+
+/**
+ * @brief Compiled-in message: run-time filter, then into the ring
+ */
+template<LogMsg ID, typename... Args>
+__attribute__((always_inline)) inline void logSend(std::true_type, Args... args) {
+	if (Log::enabled(ID)) {
+		binlog<ID>(args...);
+	}
+}
+
+/**
+ * @brief Log a message, subject to its category and level
+ * @param args Arguments for the message's format
+ *
+ * Safe from interrupts. Inlined even without optimization so a compiled-out
+ * message leaves no call behind.
+ */
+template<LogMsg ID, typename... Args>
+__attribute__((always_inline)) inline void logMsg(Args... args) {
+	static_assert(BinLogCheck<ID, Args...>::ok, "Bad log arguments");
+
+	logSend<ID>(std::integral_constant<bool, logBuilt(ID)>(), args...);
+}
+
+#endif
+
+/** @} Close LOG group */
+/** @} Close System group */
@@ -0,0 +1,60 @@
+/**
+ * @file
+ *
+ * @brief Catalogue of binary log messages
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Each entry is X(id, category, level, format). The firmware only ever
+ * stores the id and the raw arguments. The format strings stay on the
+ * ground: pi-station/binlog2text.py reads this file to build its table, so
+ * it must be kept to one X(...) per line. Append new messages at the end;
+ * ids are positions.
+ *
+ * Category and level are LogCat and LogLevel names (Log.h). A message is
+ * only compiled in if its category is enabled in config.h and its level is
+ * within LOG_MAX_LEVEL.
+ *
+ * Formats take printf conversions, one 32-bit argument each:
+ * 		- %f, %e, %g  float
+ * 		- %d, %i      signed integer
+ * 		- %u, %x, %X  unsigned integer
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup BINLOG
+ *  @{
+ */
+
+#ifndef LOGMESSAGES_H_
+#define LOGMESSAGES_H_
+
+#define LOG_MESSAGES(X) \
+	X(GYRO_X,			RAW,			VERBOSE,	"Gx %f") \
+	X(GYRO_Y,			RAW,			VERBOSE,	"Gy %f") \
+	X(GYRO_Z,			RAW,			VERBOSE,	"Gz %f") \
+	X(GYRO_X_FILT,		PREFILTERED,	VERBOSE,	"Gxf %f") \
+	X(GYRO_Y_FILT,		PREFILTERED,	VERBOSE,	"Gyf %f") \
+	X(GYRO_Z_FILT,		PREFILTERED,	VERBOSE,	"Gzf %f") \
+	X(ACC_X,			RAW,			VERBOSE,	"Ax %f") \
+	X(ACC_Y,			RAW,			VERBOSE,	"Ay %f") \
+	X(ACC_Z,			RAW,			VERBOSE,	"Az %f") \
+	X(ACC_X_FILT,		PREFILTERED,	VERBOSE,	"Axf %f") \
+	X(ACC_Y_FILT,		PREFILTERED,	VERBOSE,	"Ayf %f") \
+	X(ACC_Z_FILT,		PREFILTERED,	VERBOSE,	"Azf %f") \
+	X(ACC_PITCH,		ACC_ANGLE,		INFO,		"P %f") \
+	X(ACC_ROLL,			ACC_ANGLE,		INFO,		"R %f") \
+	X(ACC_ANGLES,		ACC_ANGLE,		INFO,		"P %f R %f") \
+	X(COMP_TERMS,		COMP_FILTERED,	INFO,		"Pf %f Rf %f Pdf %f Rdf %f") \
+	X(ATTITUDE,			OUTPUT,			INFO,		"PT %f RT %f")
+
+#endif
+
+/** @} Close BINLOG group */
+/** @} Close System group */
@@ -40,6 +40,10 @@
  */
 Motor::Motor() {
 	pwm = new PwmTimer();
+	dshot = NULL;
+	dshotSlot = 0;
+	zeroWidth = ZERO_SPEED_WIDTH;
+	fullWidth = FULL_SPEED_WIDTH;
 
 	setSpeed(0.0);
 }
@@ -50,6 +54,47 @@ Motor::Motor() {
  */
 Motor::Motor(TimerPin p) {
 	pwm = new PwmTimer(50.0, p);
+	dshot = NULL;
+	dshotSlot = 0;
+	zeroWidth = ZERO_SPEED_WIDTH;
+	fullWidth = FULL_SPEED_WIDTH;
+
+	setSpeed(0.0);
+}
+
+/**
+ * @brief Initializes a motor on the specified pin, p, using protocol proto
+ * @param p     The pin to initialize for the motor control
+ * @param proto ESC input protocol
+ */
+Motor::Motor(TimerPin p, MotorProtocol proto) {
+	float f;
+
+	pwm = NULL;
+	dshot = NULL;
+	dshotSlot = 0;
+	zeroWidth = ZERO_SPEED_WIDTH;
+	fullWidth = FULL_SPEED_WIDTH;
+
+	switch (proto) {
+	case MotorProtocol::DSHOT150:
+		dshot = DShot::Instance(timerChannelToTim(timerPinToChannel(p)), DShotRate::DSHOT150);
+		break;
+	case MotorProtocol::DSHOT300:
+		dshot = DShot::Instance(timerChannelToTim(timerPinToChannel(p)), DShotRate::DSHOT300);
+		break;
+	case MotorProtocol::DSHOT600:
+		dshot = DShot::Instance(timerChannelToTim(timerPinToChannel(p)), DShotRate::DSHOT600);
+		break;
+	default:
+		motorPwmTiming(proto, &f, &zeroWidth, &fullWidth);
+		pwm = new PwmTimer(f, p);
+		break;
+	}
+
+	if (dshot != NULL) {
+		dshotSlot = dshot->attach(p);
+	}
 
 	setSpeed(0.0);
 }
@@ -66,6 +111,11 @@ void Motor::setSpeed(float s) {
 	else if (s > MAX_SPEED) speed = MAX_SPEED;
 	else speed = s;
 
+	if (dshot != NULL) {
+		dshot->setThrottle(dshotSlot, dshotThrottle(speed));
+		return;
+	}
+
 	// Convert speed to pulse width and configure TIM for new width
 	w = mapSpeedToPulseW(speed);
 	pwm->setWidth(w);
@@ -88,7 +138,7 @@ float Motor::getSpeed(void) {
  * @return PWM positive pulse width corresponding to the speed in ms
  */
 float Motor::mapSpeedToPulseW(float s) {
-	return (FULL_SPEED_WIDTH - ZERO_SPEED_WIDTH) * s + ZERO_SPEED_WIDTH;
+	return (fullWidth - zeroWidth) * s + zeroWidth;
 }
 
 /** @} Close Motor group */
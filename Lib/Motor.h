@@ -29,6 +29,7 @@
 #define MOTOR_H_
 
 #include "PwmTimer.h"
+#include "DShot.h"
 #include "config.h"
 
 /**
@@ -40,6 +41,29 @@
 #define FULL_SPEED_WIDTH 2.0f
 #define ZERO_SPEED_WIDTH 1.0f
 
+/**
+ * Faster analog protocols. OneShot125 pulses are 8x shorter than standard PWM
+ * and are repeated at ONESHOT125_FREQ.
+ */
+#define PWM400_FREQ 400.0f
+#define ONESHOT125_FREQ 2000.0f
+#define ONESHOT125_FULL_WIDTH 0.25f
+#define ONESHOT125_ZERO_WIDTH 0.125f
+
+/**
+ * @brief ESC input protocols
+ */
+enum class MotorProtocol {
+	PWM,		//!< 50 Hz, 1-2 ms pulse
+	PWM400,		//!< 400 Hz, 1-2 ms pulse
+	ONESHOT125,	//!< 2 kHz, 125-250 us pulse
+	DSHOT150,	//!< DShot at 150 kbit/s
+	DSHOT300,	//!< DShot at 300 kbit/s
+	DSHOT600	//!< DShot at 600 kbit/s
+};
+
+bool motorPwmTiming(MotorProtocol proto, float *f, float *zeroW, float *fullW);
+
 /**
  * @brief Electronic Speed Controller (ESC) Interface
  *
@@ -52,11 +76,19 @@
  * constructor. The Motor::setSpeed() function takes care of calculating the
  * necessary pulse width and calls routines in the PwmTimer class for processor-
  * specific operations.
+ *
+ * With a DShot protocol the motor shares a DShot instance with the other
+ * motors on the same TIM, and the speed is sent as a digital throttle value
+ * instead of a pulse width. No ESC calibration is needed in that case.
  */
 class Motor {
 private:
 	PwmTimer *pwm;	///< PwmTimer object to handle hardware-specifics
+	DShot *dshot;	///< DShot output of the pin's TIM (DShot protocols only)
+	uint8_t dshotSlot;	///< Channel of the motor within the DShot output
 	float speed;	///< Speed/throttle of the motor. 0.0 <= speed <= 1.0
+	float zeroWidth;	///< Pulse width at zero throttle in ms
+	float fullWidth;	///< Pulse width at full throttle in ms
 
 	float mapSpeedToPulseW(float s);
 
@@ -64,6 +96,7 @@ public:
 
 	Motor();
 	Motor(TimerPin p);
+	Motor(TimerPin p, MotorProtocol proto);
 
 	void setSpeed(float s);
 
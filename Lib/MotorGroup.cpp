@@ -0,0 +1,269 @@
+/**
+ * @file
+ *
+ * @brief Synchronised output stage for the flight motors
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * MotorGroup drives all motors from one call. Channel registers and the
+ * speed-to-tick scaling are worked out once at init, so an update is one
+ * multiply-add and register write per motor. All CCRs are preloaded and
+ * written while update events are disabled, so every motor latches its new
+ * width on the same update event instead of one event per motor.
+ *
+ */
+
+/** @addtogroup Sensors
+ *  @{
+ */
+
+/** @addtogroup Motor
+ *  @{
+ */
+
+#include "MotorGroup.h"
+#include "errDC9000.h"
+
+/** @defgroup MotorGroup_Class MotorGroup class
+ *  @brief Motors updated together
+ *  @{
+ */
+
+/**
+ * @brief Initializes the motors on the given pins and stops them
+ * @param pins  Pin per motor
+ * @param count Number of motors, at most MOTOR_GROUP_MAX
+ * @param proto ESC protocol of all motors
+ */
+MotorGroup::MotorGroup(const TimerPin *pins, uint8_t count, MotorProtocol proto) {
+	if (count > MOTOR_GROUP_MAX) {
+		Error_Handler(errDC9000::PWM_INIT_ERROR);
+		count = MOTOR_GROUP_MAX;
+	}
+
+	protocol = proto;
+	n = count;
+	numTims = 0;
+	for (uint8_t i = 0; i < n; i++) {
+		dshot[i] = NULL;
+		dshotSlot[i] = 0;
+		speed[i] = 0.0f;
+	}
+
+	switch (protocol) {
+	case MotorProtocol::DSHOT150:
+	case MotorProtocol::DSHOT300:
+	case MotorProtocol::DSHOT600:
+		initDShot(pins);
+		break;
+	default:
+		initPwm(pins);
+		break;
+	}
+
+	write();
+}
+
+/**
+ * @brief Set the speed of all motors
+ * @param s Speed/throttle level per motor (getCount() values), 0.0 to
+ * MAX_SPEED; values outside are clamped
+ */
+void MotorGroup::setSpeeds(const float *s) {
+	for (uint8_t i = 0; i < n; i++) {
+		// Only allow speeds between 0.0 and MAX_SPEED
+		if (s[i] < 0.0f) speed[i] = 0.0f;
+		else if (s[i] > MAX_SPEED) speed[i] = MAX_SPEED;
+		else speed[i] = s[i];
+	}
+
+	write();
+}
+
+/**
+ * @brief Set the speed of one motor, keeping the others
+ * @param i Motor index
+ * @param s Speed/throttle level from 0.0 to MAX_SPEED, clamped
+ */
+void MotorGroup::setSpeed(uint8_t i, float s) {
+	if (i >= n) return;
+
+	if (s < 0.0f) speed[i] = 0.0f;
+	else if (s > MAX_SPEED) speed[i] = MAX_SPEED;
+	else speed[i] = s;
+
+	write();
+}
+
+/**
+ * @brief Stop all motors
+ */
+void MotorGroup::stop(void) {
+	for (uint8_t i = 0; i < n; i++) {
+		speed[i] = 0.0f;
+	}
+
+	write();
+}
+
+/**
+ * @brief Ask one ESC for a telemetry frame with its next DShot frame
+ * @param i Motor index
+ * @return false if the protocol has no telemetry request (PWM protocols)
+ */
+bool MotorGroup::requestTelemetry(uint8_t i) {
+	if (i >= n || dshot[i] == NULL) return false;
+
+	dshot[i]->requestTelemetry(dshotSlot[i]);
+	return true;
+}
+
+/**
+ * @brief Get the number of motors
+ * @return Number of motors in the group
+ */
+uint8_t MotorGroup::getCount(void) {
+	return n;
+}
+
+/**
+ * @brief Retrieves the last speed set for a motor
+ * @param i Motor index
+ * @return Speed/throttle level from 0.0 to MAX_SPEED
+ */
+float MotorGroup::getSpeed(uint8_t i) {
+	if (i >= n) return 0.0f;
+
+	return speed[i];
+}
+
+/**
+ * @brief Send the stored speeds to the ESCs
+ */
+void MotorGroup::write(void) {
+	if (numTims > 0) {
+		motorGroupLatch(tims, numTims, out, speed, n);
+		return;
+	}
+
+	for (uint8_t i = 0; i < n; i++) {
+		dshot[i]->setThrottle(dshotSlot[i], dshotThrottle(speed[i]));
+	}
+}
+
+/**
+ * @brief Configure the TIMs and precompute the outputs for a PWM protocol
+ * @param pins Motor pins
+ *
+ * All TIMs count at the same tick rate (set by the slowest TIM clock) with the
+ * same period, and are started back to back with interrupts disabled.
+ */
+void MotorGroup::initPwm(const TimerPin *pins) {
+	// Find the TIMs and CCRs of the motors
+	for (uint8_t i = 0; i < n; i++) {
+		TimerChannel ch = timerPinToChannel(pins[i]);
+		TIM_TypeDef *TIMx = timerChannelToTim(ch);
+		uint8_t t = 0;
+
+		while (t < numTims && tims[t] != TIMx) t++;
+		if (t == numTims) {
+			tims[numTims++] = TIMx;
+		}
+
+		// CCR1..CCR4 are consecutive, TIM_CHANNEL_x = 0, 4, 8, 12
+		out[i].tim = t;
+		out[i].ccr = &TIMx->CCR1 + timerChannelToHal(ch) / 4;
+	}
+
+	// Common tick rate, as fine as the 16-bit period allows
+	float fMin = timerClock(tims[0]);
+	for (uint8_t t = 1; t < numTims; t++) {
+		if (timerClock(tims[t]) < fMin) fMin = timerClock(tims[t]);
+	}
+	uint32_t ARR;
+	float zero, span;
+	float fTick = motorGroupTiming(protocol, fMin, &ARR, &zero, &span);
+
+	for (uint8_t t = 0; t < numTims; t++) {
+		TimHandle[t].Instance = tims[t];
+		TimHandle[t].Init.Period = ARR;
+		TimHandle[t].Init.Prescaler = (uint32_t)(timerClock(tims[t]) / fTick + 0.5f) - 1;
+		TimHandle[t].Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+		TimHandle[t].Init.CounterMode = TIM_COUNTERMODE_UP;
+		TimHandle[t].State = HAL_TIM_STATE_RESET;
+		// NOTE: Calls HAL_TIM_PWM_MspInit()
+		if (HAL_TIM_PWM_Init(&TimHandle[t]) != HAL_OK) {
+			Error_Handler(errDC9000::PWM_INIT_ERROR);
+		}
+		tims[t]->CR1 |= TIM_CR1_ARPE;
+	}
+
+	for (uint8_t i = 0; i < n; i++) {
+		TIM_HandleTypeDef *htim = &TimHandle[out[i].tim];
+		uint32_t channel = timerChannelToHal(timerPinToChannel(pins[i]));
+
+		out[i].zero = zero;
+		out[i].span = span;
+
+		timerPinInit(pins[i]);
+
+		// PWM mode 1, CCR preload is set by the HAL
+		TIM_OC_InitTypeDef sConfig;
+		sConfig.OCMode = TIM_OCMODE_PWM1;
+		sConfig.Pulse = (uint32_t)out[i].zero;
+		sConfig.OCPolarity = TIM_OCPOLARITY_HIGH;
+		sConfig.OCNPolarity = TIM_OCPOLARITY_HIGH;
+		sConfig.OCFastMode = TIM_OCFAST_DISABLE;
+		sConfig.OCIdleState = TIM_OCIDLESTATE_RESET;
+		sConfig.OCNIdleState = TIM_OCIDLESTATE_RESET;
+
+		if (HAL_TIM_PWM_ConfigChannel(htim, &sConfig, channel) != HAL_OK) {
+			Error_Handler(errDC9000::PWM_INIT_ERROR);
+		}
+
+		// Enable the output without starting the counter
+		TIM_CCxChannelCmd(htim->Instance, channel, TIM_CCx_ENABLE);
+		if (IS_TIM_ADVANCED_INSTANCE(htim->Instance)) {
+			__HAL_TIM_MOE_ENABLE(htim);
+		}
+	}
+
+	// Load the preloaded PSC, ARR and CCRs, then start all counters together
+	for (uint8_t t = 0; t < numTims; t++) {
+		tims[t]->EGR = TIM_EGR_UG;
+		tims[t]->CNT = 0;
+	}
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	for (uint8_t t = 0; t < numTims; t++) {
+		tims[t]->CR1 |= TIM_CR1_CEN;
+	}
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Attach the motors to the DShot outputs of their TIMs
+ * @param pins Motor pins
+ */
+void MotorGroup::initDShot(const TimerPin *pins) {
+	DShotRate rate;
+
+	switch (protocol) {
+	case MotorProtocol::DSHOT150: rate = DShotRate::DSHOT150; break;
+	case MotorProtocol::DSHOT300: rate = DShotRate::DSHOT300; break;
+	default: rate = DShotRate::DSHOT600; break;
+	}
+
+	for (uint8_t i = 0; i < n; i++) {
+		dshot[i] = DShot::Instance(timerChannelToTim(timerPinToChannel(pins[i])), rate);
+		dshotSlot[i] = dshot[i]->attach(pins[i]);
+	}
+}
+
+/** @} Close MotorGroup_Class group */
+
+/** @} Close Motor group */
+/** @} Close Sensors Group */
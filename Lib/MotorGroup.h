@@ -0,0 +1,92 @@
+/**
+ * @file
+ *
+ * @brief Synchronised output stage for the flight motors
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * MotorGroup drives all motors from one call. Channel registers and the
+ * speed-to-tick scaling are worked out once at init, so an update is one
+ * multiply-add and register write per motor. All CCRs are preloaded and
+ * written while update events are disabled, so every motor latches its new
+ * width on the same update event instead of one event per motor.
+ *
+ */
+
+/** @addtogroup Sensors
+ *  @{
+ */
+
+/** @addtogroup Motor
+ *  @{
+ */
+
+#ifndef MOTORGROUP_H_
+#define MOTORGROUP_H_
+
+#include "Motor.h"
+
+#define MOTOR_GROUP_MAX		8		///< Most motors in a group (octo)
+
+/**
+ * @brief Precomputed output of one motor
+ */
+struct MotorGroupOut {
+	volatile uint32_t *ccr;		///< CCRx register driving the motor
+	uint8_t tim;				///< Index of the motor's TIM in the group
+	float zero;					///< CCR ticks at zero throttle
+	float span;					///< CCR ticks from zero to full throttle
+};
+
+float motorGroupTiming(MotorProtocol proto, float clock, uint32_t *arr, float *zero, float *span);
+void motorGroupLatch(TIM_TypeDef * const *tims, uint8_t numTims,
+		const MotorGroupOut *out, const float *s, uint8_t n);
+
+/**
+ * @brief Motors updated together
+ *
+ * The PWM protocols (PWM, PWM400, ONESHOT125) configure the motors' TIMs with
+ * a common tick rate and start their counters back to back, so TIMs with the
+ * same period stay in step and update together. The DShot protocols hand the
+ * values to the DShot output of each TIM.
+ *
+ * Motors are indexed in the order the pins are passed to the constructor.
+ */
+class MotorGroup {
+private:
+	MotorProtocol protocol;					///< ESC protocol of all motors
+
+	uint8_t n;								///< Number of motors
+
+	TIM_HandleTypeDef TimHandle[MOTOR_GROUP_MAX];	///< HAL handles of the TIMs used
+	TIM_TypeDef *tims[MOTOR_GROUP_MAX];		///< TIMs used, in TimHandle order
+	uint8_t numTims;						///< Number of TIMs used
+
+	MotorGroupOut out[MOTOR_GROUP_MAX];		///< Precomputed PWM outputs
+	DShot *dshot[MOTOR_GROUP_MAX];			///< DShot output per motor
+	uint8_t dshotSlot[MOTOR_GROUP_MAX];		///< DShot channel per motor
+
+	float speed[MOTOR_GROUP_MAX];			///< Last speed per motor
+
+	void initPwm(const TimerPin *pins);
+	void initDShot(const TimerPin *pins);
+	void write(void);
+
+public:
+	MotorGroup(const TimerPin *pins, uint8_t count, MotorProtocol proto);
+
+	void setSpeeds(const float *s);
+	void setSpeed(uint8_t i, float s);
+	void stop(void);
+	bool requestTelemetry(uint8_t i);
+
+	uint8_t getCount(void);
+	float getSpeed(uint8_t i);
+};
+
+#endif /* MOTORGROUP_H_ */
+
+/** @} Close Motor group */
+/** @} Close Sensors Group */
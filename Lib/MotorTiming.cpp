@@ -0,0 +1,114 @@
+/**
+ * @file
+ *
+ * @brief PWM timing and CCR latching of the motor outputs
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * The parts of Motor and MotorGroup that work out pulse widths and write the
+ * channel registers. They make no HAL calls, so they can be run on a host
+ * (tests/test_motor_group.cpp).
+ *
+ */
+
+/** @addtogroup Sensors
+ *  @{
+ */
+
+/** @addtogroup Motor
+ *  @{
+ */
+
+#include <math.h>
+#include "MotorGroup.h"
+
+/**
+ * @brief Get the PWM timing of an analog ESC protocol
+ * @param proto ESC protocol
+ * @param f     [out] PWM frequency in Hz
+ * @param zeroW [out] Pulse width at zero throttle in ms
+ * @param fullW [out] Pulse width at full throttle in ms
+ * @return false for the DShot protocols, which have no pulse width
+ */
+bool motorPwmTiming(MotorProtocol proto, float *f, float *zeroW, float *fullW) {
+	switch (proto) {
+	case MotorProtocol::PWM:
+		*f = 50.0f;
+		*zeroW = ZERO_SPEED_WIDTH;
+		*fullW = FULL_SPEED_WIDTH;
+		return true;
+	case MotorProtocol::PWM400:
+		*f = PWM400_FREQ;
+		*zeroW = ZERO_SPEED_WIDTH;
+		*fullW = FULL_SPEED_WIDTH;
+		return true;
+	case MotorProtocol::ONESHOT125:
+		*f = ONESHOT125_FREQ;
+		*zeroW = ONESHOT125_ZERO_WIDTH;
+		*fullW = ONESHOT125_FULL_WIDTH;
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * @brief Work out the common tick rate and output scaling of a PWM protocol
+ * @param proto ESC protocol
+ * @param clock Clock of the slowest TIM in the group in Hz
+ * @param arr   [out] Auto-reload value giving the protocol's frequency
+ * @param zero  [out] CCR ticks at zero throttle
+ * @param span  [out] CCR ticks from zero to full throttle
+ * @return Tick rate in Hz, the finest the 16-bit period allows; 0 for the
+ * DShot protocols
+ */
+float motorGroupTiming(MotorProtocol proto, float clock, uint32_t *arr, float *zero, float *span) {
+	float f, zeroW, fullW;
+
+	if (!motorPwmTiming(proto, &f, &zeroW, &fullW)) {
+		return 0.0f;
+	}
+
+	float div = ceilf(clock / (f * 65536.0f));
+	float fTick = clock / div;
+	float ticksPerMs = fTick * 0.001f;
+
+	*arr = (uint32_t)(fTick / f) - 1;
+	*zero = zeroW * ticksPerMs;
+	*span = (fullW - zeroW) * ticksPerMs;
+
+	return fTick;
+}
+
+/**
+ * @brief Write new widths so that all outputs latch on one update event
+ * @param tims    TIMs driving the outputs
+ * @param numTims Number of TIMs
+ * @param out     Precomputed outputs
+ * @param s       Speed/throttle level per output, 0.0 to MAX_SPEED
+ * @param n       Number of outputs
+ *
+ * Update events are disabled on every TIM while the CCRs are written, so the
+ * preloaded values are transferred either all before or all after the writes.
+ * Only touches the registers in tims and out, so it can be run against plain
+ * TIM_TypeDef structs.
+ */
+void motorGroupLatch(TIM_TypeDef * const *tims, uint8_t numTims,
+		const MotorGroupOut *out, const float *s, uint8_t n) {
+	for (uint8_t t = 0; t < numTims; t++) {
+		tims[t]->CR1 |= TIM_CR1_UDIS;
+	}
+
+	for (uint8_t i = 0; i < n; i++) {
+		*out[i].ccr = (uint32_t)(out[i].zero + s[i] * out[i].span);
+	}
+
+	for (uint8_t t = 0; t < numTims; t++) {
+		tims[t]->CR1 &= ~TIM_CR1_UDIS;
+	}
+}
+
+/** @} Close Motor group */
+/** @} Close Sensors Group */
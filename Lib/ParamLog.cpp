@@ -0,0 +1,244 @@
+/**
+ * @file
+ *
+ * @brief Log-structured parameter storage in two flash banks
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup PARAMS
+ *  @{
+ */
+
+#include "ParamLog.h"
+#include "Framing.h"
+
+/**
+ * @brief CRC-16 of a record's id and value
+ */
+static uint16_t recordCrc(uint16_t id, uint32_t value) {
+	uint8_t b[6];
+	b[0] = (uint8_t)id;
+	b[1] = (uint8_t)(id >> 8);
+	b[2] = (uint8_t)value;
+	b[3] = (uint8_t)(value >> 8);
+	b[4] = (uint8_t)(value >> 16);
+	b[5] = (uint8_t)(value >> 24);
+	return crc16Ccitt(b, sizeof(b));
+}
+
+/**
+ * @brief Create a log over two equally sized flash banks
+ * @param bank0     Base of bank 0 (word aligned)
+ * @param bank1     Base of bank 1 (word aligned)
+ * @param bankBytes Size of each bank [bytes]
+ * @param flash     Program/erase functions for the banks
+ *
+ * Nothing is read until load() is called.
+ */
+ParamLog::ParamLog(volatile uint32_t *bank0, volatile uint32_t *bank1, uint32_t bankBytes, ParamFlashOps flash) {
+	bank[0] = bank0;
+	bank[1] = bank1;
+	words = bankBytes / 4;
+	ops = flash;
+	active = -1;
+	generation = 0;
+	wr = 0;
+}
+
+/**
+ * @brief Check a bank's header
+ * @param b   Bank
+ * @param gen Returns the bank's generation if it is valid
+ * @return true if the header is complete
+ */
+bool ParamLog::bankValid(uint8_t b, uint32_t *gen) {
+	volatile uint32_t *p = bank[b];
+
+	if (p[0] != PARAM_LOG_MAGIC || p[1] != ~p[2]) {
+		return false;
+	}
+
+	*gen = p[1];
+	return true;
+}
+
+/**
+ * @brief Program one record
+ * @param b      Bank
+ * @param offset Word offset of the record, advanced past it even on failure
+ * @param id     Parameter id
+ * @param value  Value bits
+ * @return false if the flash didn't take the record
+ *
+ * The value is written before the id/CRC word, so a record cut short by a
+ * power loss never passes its CRC.
+ */
+bool ParamLog::writeRecord(uint8_t b, uint32_t *offset, uint16_t id, uint32_t value) {
+	volatile uint32_t *p = bank[b] + *offset;
+	uint32_t tag = (uint32_t)id | ((uint32_t)recordCrc(id, value) << 16);
+
+	*offset += 2;
+
+	if (!ops.program(&p[0], value) || p[0] != value) {
+		return false;
+	}
+	if (!ops.program(&p[1], tag) || p[1] != tag) {
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Read the stored values
+ * @param values Values by id. Ids without a stored record keep their value.
+ * @param n      Number of ids. Records for ids >= n are ignored.
+ * @return Number of records applied
+ *
+ * Also finds the bank and offset the next append() will use.
+ */
+uint16_t ParamLog::load(ParamValue *values, uint16_t n) {
+	uint32_t gen[2];
+	bool valid[2];
+	uint16_t applied = 0;
+
+	valid[0] = bankValid(0, &gen[0]);
+	valid[1] = bankValid(1, &gen[1]);
+
+	if (valid[0] && valid[1]) {
+		active = (gen[1] > gen[0]) ? 1 : 0;
+	} else if (valid[0]) {
+		active = 0;
+	} else if (valid[1]) {
+		active = 1;
+	} else {
+		// Blank or never completed - the first append() compacts
+		active = -1;
+		generation = 0;
+		wr = 0;
+		return 0;
+	}
+
+	generation = gen[active];
+
+	volatile uint32_t *p = bank[active];
+	for (wr = PARAM_LOG_HEADER; wr + 2 <= words; wr += 2) {
+		uint32_t value = p[wr];
+		uint32_t tag = p[wr + 1];
+
+		// End of the log
+		if (value == PARAM_LOG_ERASED && tag == PARAM_LOG_ERASED) {
+			break;
+		}
+
+		// Skip torn or corrupt records, they still use up their slot
+		uint16_t id = (uint16_t)tag;
+		if ((uint16_t)(tag >> 16) != recordCrc(id, value) || id >= n) {
+			continue;
+		}
+
+		values[id].u = value;
+		applied++;
+	}
+
+	return applied;
+}
+
+/**
+ * @brief Store a changed value
+ * @param id     Parameter id
+ * @param value  New value bits
+ * @param values All current values, already including the new one
+ * @param n      Number of ids
+ * @return false on a flash error
+ *
+ * Normally programs 8 bytes. When the bank is full, compacts instead, which
+ * erases a bank and stalls the flash for a second or more.
+ */
+bool ParamLog::append(uint16_t id, uint32_t value, const ParamValue *values, uint16_t n) {
+	if (active < 0 || wr + 2 > words) {
+		return compact(values, n);
+	}
+
+	return writeRecord(active, &wr, id, value);
+}
+
+/**
+ * @brief Rewrite all values into the other bank
+ * @param values Values by id
+ * @param n      Number of ids
+ * @return false on a flash error, in which case the old bank stays in use
+ */
+bool ParamLog::compact(const ParamValue *values, uint16_t n) {
+	uint8_t target = (active == 0) ? 1 : 0;
+	uint32_t gen = (active < 0) ? 1 : generation + 1;
+	uint32_t offset = PARAM_LOG_HEADER;
+
+	if (PARAM_LOG_HEADER + 2 * (uint32_t)n > words) {
+		return false;
+	}
+
+	if (!ops.erase(target)) {
+		return false;
+	}
+
+	for (uint16_t id = 0; id < n; id++) {
+		if (!writeRecord(target, &offset, id, values[id].u)) {
+			return false;
+		}
+	}
+
+	// Header last - the bank only becomes valid once every record is in
+	volatile uint32_t *p = bank[target];
+	if (!ops.program(&p[1], gen) || !ops.program(&p[2], ~gen) ||
+			!ops.program(&p[0], PARAM_LOG_MAGIC)) {
+		return false;
+	}
+	if (!bankValid(target, &gen)) {
+		return false;
+	}
+
+	active = target;
+	generation = gen;
+	wr = offset;
+
+	return true;
+}
+
+/**
+ * @brief Get the bank in use
+ * @return 0 or 1, or -1 if nothing has been stored yet
+ */
+int8_t ParamLog::getActive(void) {
+	return active;
+}
+
+/**
+ * @brief Get the generation of the bank in use
+ * @return Generation, incremented by every compaction
+ */
+uint32_t ParamLog::getGeneration(void) {
+	return generation;
+}
+
+/**
+ * @brief Get the room left before the next compaction
+ * @return Number of records that still fit in the active bank
+ */
+uint32_t ParamLog::getFree(void) {
+	if (active < 0) {
+		return 0;
+	}
+	return (words - wr) / 2;
+}
+
+/** @} Close PARAMS group */
+/** @} Close System group */
@@ -0,0 +1,95 @@
+/**
+ * @file
+ *
+ * @brief Log-structured parameter storage in two flash banks
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Does not touch hardware. Program and erase are passed in, so the same code
+ * runs against the STM32 flash (ParamStore) or a simulated flash on a host.
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup PARAMS
+ *  @{
+ */
+
+#ifndef PARAMLOG_H_
+#define PARAMLOG_H_
+
+#include <stdint.h>
+
+#define PARAM_LOG_MAGIC		0x314D5250u	///< "PRM1", first word of a valid bank
+#define PARAM_LOG_HEADER	4			///< Header words: magic, generation, ~generation, spare
+#define PARAM_LOG_ERASED	0xFFFFFFFFu	///< Erased flash word
+
+/**
+ * @brief One stored parameter value, interpreted by its ParamType
+ */
+typedef union {
+	float f;			///< ParamType::FLOAT
+	int32_t i;			///< ParamType::INT
+	uint32_t u;			///< Raw bits as stored
+} ParamValue;
+
+/**
+ * @brief Flash access for ParamLog
+ *
+ * program() writes one 32-bit word that is currently erased. erase() erases
+ * a whole bank (0 or 1). Both return false on a hardware error.
+ */
+typedef struct {
+	bool (*program)(volatile uint32_t *addr, uint32_t word);
+	bool (*erase)(uint8_t bank);
+} ParamFlashOps;
+
+/**
+ * @brief Append-only parameter log with A/B compaction
+ *
+ * Each bank starts with a header and is followed by 8-byte records: the value
+ * word, then a word holding the parameter id and a CRC-16 of id and value.
+ * A change appends one record, so a bank is only erased once it fills up.
+ * Then the live values are written to the other bank under the next
+ * generation number, and its header is written last. Erases alternate
+ * between the two banks, which spreads the wear.
+ *
+ * Load uses the valid bank with the newest generation, and the last good
+ * record for each id wins. A record torn by a power loss fails its CRC and is
+ * skipped. A bank whose compaction was cut short has no header, so the old
+ * bank is still used.
+ */
+class ParamLog {
+private:
+	volatile uint32_t *bank[2];	///< Bank base addresses
+	uint32_t words;				///< Words per bank
+	ParamFlashOps ops;			///< Flash program/erase
+
+	int8_t active;				///< Bank in use, -1 if neither is valid
+	uint32_t generation;		///< Generation of the active bank
+	uint32_t wr;				///< Next free word offset in the active bank
+
+	bool bankValid(uint8_t b, uint32_t *gen);
+	bool writeRecord(uint8_t b, uint32_t *offset, uint16_t id, uint32_t value);
+
+public:
+	ParamLog(volatile uint32_t *bank0, volatile uint32_t *bank1, uint32_t bankBytes, ParamFlashOps flash);
+
+	uint16_t load(ParamValue *values, uint16_t n);
+	bool append(uint16_t id, uint32_t value, const ParamValue *values, uint16_t n);
+	bool compact(const ParamValue *values, uint16_t n);
+
+	int8_t getActive(void);
+	uint32_t getGeneration(void);
+	uint32_t getFree(void);
+};
+
+#endif
+
+/** @} Close PARAMS group */
+/** @} Close System group */
@@ -0,0 +1,171 @@
+/**
+ * @file
+ *
+ * @brief Parameter storage in the last two flash sectors
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup PARAMS
+ *  @{
+ */
+
+#include "ParamStore.h"
+
+// Global ParamStore instance
+ParamStore* ParamStore::paramInstance = NULL;
+
+/**
+ * @brief Unlock the flash and clear errors left by earlier operations
+ */
+static void flashUnlock(void) {
+	HAL_FLASH_Unlock();
+	__HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR |
+			FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+}
+
+/**
+ * @brief ParamFlashOps::program for the STM32 flash
+ */
+static bool flashProgram(volatile uint32_t *addr, uint32_t word) {
+	flashUnlock();
+	HAL_StatusTypeDef status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, (uint32_t)addr, word);
+	HAL_FLASH_Lock();
+
+	return status == HAL_OK;
+}
+
+/**
+ * @brief ParamFlashOps::erase for the STM32 flash
+ */
+static bool flashErase(uint8_t bank) {
+	FLASH_EraseInitTypeDef erase;
+	uint32_t sectorError;
+
+	erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+	erase.Banks = 0;
+	erase.Sector = (bank == 0) ? PARAM_BANK0_SECTOR : PARAM_BANK1_SECTOR;
+	erase.NbSectors = 1;
+	erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+	flashUnlock();
+	HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&erase, &sectorError);
+	HAL_FLASH_Lock();
+
+	return status == HAL_OK;
+}
+
+static const ParamFlashOps stm32FlashOps = { flashProgram, flashErase };
+
+/**
+ * @brief Obtain the parameter store
+ * @return Pointer to the ParamStore singleton instance
+ *
+ * The first call loads the stored values into paramValues.
+ */
+ParamStore* ParamStore::Instance() {
+	if (paramInstance == NULL) {
+		paramInstance = new ParamStore();
+	}
+
+	return paramInstance;
+}
+
+/**
+ * @brief Load the stored parameters
+ *
+ * Ids with no stored value, or a value outside the current bounds (the table
+ * may have changed since it was stored), use their default.
+ */
+ParamStore::ParamStore()
+	: log((volatile uint32_t *)PARAM_BANK0_ADDR, (volatile uint32_t *)PARAM_BANK1_ADDR,
+		  PARAM_BANK_SIZE, stm32FlashOps)
+{
+	paramDefaults();
+	log.load(paramValues, (uint16_t)ParamId::NUM_PARAMS);
+
+	for (uint16_t id = 0; id < (uint16_t)ParamId::NUM_PARAMS; id++) {
+		ParamValue v;
+		if (paramCheck(id, paramAsFloat(id), &v) != ParamStatus::OK) {
+			paramDefault(id);
+		}
+		dirty[id] = false;
+	}
+
+	pending = false;
+}
+
+/**
+ * @brief Change a parameter
+ * @param id    Parameter id
+ * @param value New value, rounded for INT parameters
+ * @return ParamStatus::OK, or why the value was refused
+ *
+ * Takes effect in paramValues immediately; flush() stores it.
+ */
+ParamStatus ParamStore::set(uint16_t id, float value) {
+	ParamValue v;
+	ParamStatus status = paramCheck(id, value, &v);
+
+	if (status != ParamStatus::OK) {
+		return status;
+	}
+
+	if (v.u != paramValues[id].u) {
+		paramValues[id] = v;
+		dirty[id] = true;
+		pending = true;
+	}
+
+	return ParamStatus::OK;
+}
+
+/**
+ * @brief Write changed parameters to flash
+ * @return ParamStatus::OK, or STORE_ERROR if the flash refused a write
+ *
+ * Blocks while the flash is busy: ~16 us per record, and a second or more
+ * when a sector has to be erased. Only call this with the motors disarmed.
+ * Entries that failed stay dirty and are retried once another set() makes
+ * the store pending again, rather than hammering a failing sector.
+ */
+ParamStatus ParamStore::flush(void) {
+	ParamStatus status = ParamStatus::OK;
+
+	if (!pending) {
+		return status;
+	}
+
+	pending = false;
+	for (uint16_t id = 0; id < (uint16_t)ParamId::NUM_PARAMS; id++) {
+		if (!dirty[id]) {
+			continue;
+		}
+
+		if (log.append(id, paramValues[id].u, paramValues, (uint16_t)ParamId::NUM_PARAMS)) {
+			dirty[id] = false;
+		} else {
+			status = ParamStatus::STORE_ERROR;
+		}
+	}
+
+	return status;
+}
+
+/**
+ * @brief Check for changes not yet in flash
+ * @return true if flush() has work to do
+ */
+bool ParamStore::isPending(void) {
+	return pending;
+}
+
+/** @} Close PARAMS group */
+/** @} Close System group */
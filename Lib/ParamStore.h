@@ -0,0 +1,71 @@
+/**
+ * @file
+ *
+ * @brief Parameter storage in the last two flash sectors
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup PARAMS
+ *  @{
+ */
+
+#ifndef PARAMSTORE_H_
+#define PARAMSTORE_H_
+
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+#include "Params.h"
+#include "ParamLog.h"
+
+/*
+ * Flash sectors 10 & 11 (128 KB each) hold the parameter log. mem.ld ends
+ * the FLASH region before them so code never lands in them.
+ */
+#define PARAM_BANK0_ADDR	0x080C0000u
+#define PARAM_BANK1_ADDR	0x080E0000u
+#define PARAM_BANK0_SECTOR	FLASH_SECTOR_10
+#define PARAM_BANK1_SECTOR	FLASH_SECTOR_11
+#define PARAM_BANK_SIZE		0x20000u
+
+/**
+ * @brief Keeps paramValues in sync with flash
+ *
+ * Loads the stored values on creation, so paramGet() returns them from then
+ * on. set() takes effect in RAM straight away for live tuning. The change is
+ * only written to flash by flush(), since programming and erasing stall
+ * every fetch from flash. Call flush() only while the motors are disarmed.
+ */
+class ParamStore {
+private:
+	ParamLog log;									///< Storage in the two sectors
+	bool dirty[(uint16_t)ParamId::NUM_PARAMS];		///< Set but not yet stored
+	bool pending;									///< Any entry set since the last flush()
+
+	// Private constructors for singleton pattern
+	ParamStore();
+	ParamStore(ParamStore const&);
+	ParamStore& operator=(ParamStore const&);
+
+	static ParamStore *paramInstance;				///< Internal pointer to the singleton
+
+public:
+	static ParamStore* Instance();
+
+	ParamStatus set(uint16_t id, float value);
+	ParamStatus flush(void);
+
+	bool isPending(void);
+};
+
+#endif
+
+/** @} Close PARAMS group */
+/** @} Close System group */
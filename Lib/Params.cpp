@@ -0,0 +1,141 @@
+/**
+ * @file
+ *
+ * @brief Typed table of runtime tunable parameters
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup PARAMS
+ *  @{
+ */
+
+#include "Params.h"
+#include "config.h"
+#include "pid2.h"
+#include "pid3.h"
+#include "ImuCalibrator.h"
+#include "sensorFilter.h"
+#include <math.h>
+
+/**
+ * @brief Parameter descriptions, indexed by ParamId
+ */
+const ParamInfo paramTable[(uint16_t)ParamId::NUM_PARAMS] = {
+	{ "PITCH_P",		ParamType::FLOAT,	PITCH_KP,				0.0f,	100.0f },
+	{ "PITCH_I",		ParamType::FLOAT,	PITCH_KI,				0.0f,	100.0f },
+	{ "PITCH_D",		ParamType::FLOAT,	PITCH_KD,				0.0f,	100.0f },
+	{ "ROLL_P",			ParamType::FLOAT,	ROLL_KP,				0.0f,	100.0f },
+	{ "ROLL_I",			ParamType::FLOAT,	ROLL_KI,				0.0f,	100.0f },
+	{ "ROLL_D",			ParamType::FLOAT,	ROLL_KD,				0.0f,	100.0f },
+	{ "PID_OUT_SCALE",	ParamType::FLOAT,	PID_SCALE,				1.0f,	1000.0f },
+	{ "ANGLE_LIMIT",	ParamType::FLOAT,	MAX_ANGLE,				5.0f,	60.0f },
+	{ "RATE_LIMIT",		ParamType::FLOAT,	MAX_RATE,				10.0f,	720.0f },
+	{ "COMP_TAU",		ParamType::FLOAT,	COMPLEMENTARY_TAU,		0.001f,	2.0f },
+	{ "INTEGRAL_SAT",	ParamType::FLOAT,	INTEGRAL_SATURATION,	0.0f,	100.0f },
+	{ "DEADBAND",		ParamType::FLOAT,	ERROR_DEADBAND,			0.0f,	10.0f },
+	{ "TELEM_DIVIDER",	ParamType::INT,		TELEMETRY_DIVIDER,		1.0f,	100.0f },
+	{ "LOG_CATEGORIES",	ParamType::INT,		LOG_DEFAULT_CATEGORIES,	0.0f,	31.0f },
+	{ "LOG_LEVEL",		ParamType::INT,		LOG_DEFAULT_LEVEL,		0.0f,	3.0f },
+	{ "PITCH_RATE_P",	ParamType::FLOAT,	PITCH_RATE_KP,			0.0f,	100.0f },
+	{ "PITCH_RATE_I",	ParamType::FLOAT,	PITCH_RATE_KI,			0.0f,	100.0f },
+	{ "PITCH_RATE_D",	ParamType::FLOAT,	PITCH_RATE_KD,			0.0f,	100.0f },
+	{ "ROLL_RATE_P",	ParamType::FLOAT,	ROLL_RATE_KP,			0.0f,	100.0f },
+	{ "ROLL_RATE_I",	ParamType::FLOAT,	ROLL_RATE_KI,			0.0f,	100.0f },
+	{ "ROLL_RATE_D",	ParamType::FLOAT,	ROLL_RATE_KD,			0.0f,	100.0f },
+	{ "YAW_RATE_P",		ParamType::FLOAT,	YAW_RATE_KP,			0.0f,	100.0f },
+	{ "YAW_RATE_I",		ParamType::FLOAT,	YAW_RATE_KI,			0.0f,	100.0f },
+	{ "YAW_RATE_D",		ParamType::FLOAT,	YAW_RATE_KD,			0.0f,	100.0f },
+	{ "PITCH_RATE_FF",	ParamType::FLOAT,	PITCH_RATE_KFF,			0.0f,	100.0f },
+	{ "ROLL_RATE_FF",	ParamType::FLOAT,	ROLL_RATE_KFF,			0.0f,	100.0f },
+	{ "YAW_RATE_FF",	ParamType::FLOAT,	YAW_RATE_KFF,			0.0f,	100.0f },
+	{ "PITCH_OUT_LIMIT",	ParamType::FLOAT,	PITCH_OUT_MAX,			0.0f,	1.0f },
+	{ "ROLL_OUT_LIMIT",	ParamType::FLOAT,	ROLL_OUT_MAX,			0.0f,	1.0f },
+	{ "YAW_OUT_LIMIT",	ParamType::FLOAT,	YAW_OUT_MAX,			0.0f,	1.0f },
+	{ "D_CUTOFF",		ParamType::FLOAT,	PID_D_CUTOFF,			0.0f,	100.0f },
+	{ "CAL_GYRO_X",		ParamType::FLOAT,	0.0f,					-50.0f,	50.0f },
+	{ "CAL_GYRO_Y",		ParamType::FLOAT,	0.0f,					-50.0f,	50.0f },
+	{ "CAL_GYRO_Z",		ParamType::FLOAT,	0.0f,					-50.0f,	50.0f },
+	{ "CAL_ACC_X",		ParamType::FLOAT,	0.0f,					-1.0f,	1.0f },
+	{ "CAL_ACC_Y",		ParamType::FLOAT,	0.0f,					-1.0f,	1.0f },
+	{ "CAL_ACC_Z",		ParamType::FLOAT,	0.0f,					-1.0f,	1.0f },
+	{ "CAL_TEMP",		ParamType::FLOAT,	CAL_TEMP_NONE,			CAL_TEMP_NONE,	127.0f },
+	{ "GYRO_FILTER",	ParamType::INT,		(int)GYRO_PREFILTER,	0.0f,	FILTER_NUM_DESIGNS - 1 },
+	{ "ACC_FILTER",		ParamType::INT,		(int)ACC_PREFILTER,		0.0f,	FILTER_NUM_DESIGNS - 1 }
+};
+
+/**
+ * @brief Current parameter values, indexed by ParamId
+ */
+ParamValue paramValues[(uint16_t)ParamId::NUM_PARAMS];
+
+/**
+ * @brief Set one parameter to its default
+ * @param id Parameter id, must be valid
+ */
+void paramDefault(uint16_t id) {
+	if (paramTable[id].type == ParamType::INT) {
+		paramValues[id].i = (int32_t)paramTable[id].def;
+	} else {
+		paramValues[id].f = paramTable[id].def;
+	}
+}
+
+/**
+ * @brief Set every parameter to its default
+ */
+void paramDefaults(void) {
+	for (uint16_t id = 0; id < (uint16_t)ParamId::NUM_PARAMS; id++) {
+		paramDefault(id);
+	}
+}
+
+/**
+ * @brief Validate a value for a parameter
+ * @param id    Parameter id, as received
+ * @param value Requested value. INT parameters are rounded.
+ * @param out   Returns the value in the parameter's type
+ * @return ParamStatus::OK, UNKNOWN_ID or OUT_OF_RANGE
+ */
+ParamStatus paramCheck(uint16_t id, float value, ParamValue *out) {
+	if (id >= (uint16_t)ParamId::NUM_PARAMS) {
+		return ParamStatus::UNKNOWN_ID;
+	}
+
+	const ParamInfo *info = &paramTable[id];
+
+	// Written so NaN fails too
+	if (!(value >= info->min && value <= info->max)) {
+		return ParamStatus::OUT_OF_RANGE;
+	}
+
+	if (info->type == ParamType::INT) {
+		out->i = (int32_t)lroundf(value);
+	} else {
+		out->f = value;
+	}
+
+	return ParamStatus::OK;
+}
+
+/**
+ * @brief Get any parameter's current value as a float
+ * @param id Parameter id, must be valid
+ * @return Value
+ */
+float paramAsFloat(uint16_t id) {
+	if (paramTable[id].type == ParamType::INT) {
+		return (float)paramValues[id].i;
+	}
+	return paramValues[id].f;
+}
+
+/** @} Close PARAMS group */
+/** @} Close System group */
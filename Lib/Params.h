@@ -0,0 +1,137 @@
+/**
+ * @file
+ *
+ * @brief Typed table of runtime tunable parameters
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @defgroup PARAMS Parameters
+ *  @brief Runtime tuning values, stored in flash and set over the uplink
+ *  @{
+ */
+
+#ifndef PARAMS_H_
+#define PARAMS_H_
+
+#include <stdint.h>
+#include "ParamLog.h"
+
+/**
+ * @brief Parameter ids
+ *
+ * The id is what gets stored in flash and sent over the link. Only append
+ * new ids before NUM_PARAMS. Never reorder or reuse them.
+ */
+enum class ParamId : uint16_t {
+	PITCH_P,			///< Pitch angle proportional gain [deg/s per deg]
+	PITCH_I,			///< Pitch angle integral gain
+	PITCH_D,			///< Pitch angle derivative gain
+	ROLL_P,				///< Roll angle proportional gain [deg/s per deg]
+	ROLL_I,				///< Roll angle integral gain
+	ROLL_D,				///< Roll angle derivative gain
+	PID_OUT_SCALE,		///< Rate PID output per unit motor speed
+	ANGLE_LIMIT,		///< Maximum pitch & roll angle [deg]
+	RATE_LIMIT,			///< Maximum rate setpoint, all axes [deg/s]
+	COMP_TAU,			///< Complementary filter time constant [s]
+	INTEGRAL_SAT,		///< pid2 error integral limit, unused by CascadeControl
+	DEADBAND,			///< pid2 error deadband [deg], unused by CascadeControl
+	TELEM_DIVIDER,		///< Divides every telemetry channel's rate
+	LOG_CATEGORIES,		///< Log categories enabled, LOG_CAT_BIT() mask
+	LOG_LEVEL,			///< Most detailed LogLevel logged
+	PITCH_RATE_P,		///< Pitch rate proportional gain
+	PITCH_RATE_I,		///< Pitch rate integral gain
+	PITCH_RATE_D,		///< Pitch rate derivative gain
+	ROLL_RATE_P,		///< Roll rate proportional gain
+	ROLL_RATE_I,		///< Roll rate integral gain
+	ROLL_RATE_D,		///< Roll rate derivative gain
+	YAW_RATE_P,			///< Yaw rate proportional gain
+	YAW_RATE_I,			///< Yaw rate integral gain
+	YAW_RATE_D,			///< Yaw rate derivative gain
+	PITCH_RATE_FF,		///< Pitch rate setpoint feed-forward gain
+	ROLL_RATE_FF,		///< Roll rate setpoint feed-forward gain
+	YAW_RATE_FF,		///< Yaw rate setpoint feed-forward gain
+	PITCH_OUT_LIMIT,	///< Largest pitch command [motor speed]
+	ROLL_OUT_LIMIT,		///< Largest roll command [motor speed]
+	YAW_OUT_LIMIT,		///< Largest yaw command [motor speed]
+	D_CUTOFF,			///< PID derivative filter cut-off [Hz], 0 for none
+	CAL_GYRO_X,			///< Stored gyro x offset [deg/s] (IMU::calibrate())
+	CAL_GYRO_Y,			///< Stored gyro y offset [deg/s]
+	CAL_GYRO_Z,			///< Stored gyro z offset [deg/s]
+	CAL_ACC_X,			///< Stored accelerometer x offset [g]
+	CAL_ACC_Y,			///< Stored accelerometer y offset [g]
+	CAL_ACC_Z,			///< Stored accelerometer z offset, less gravity [g]
+	CAL_TEMP,			///< Gyro temperature of the stored offsets [degC], CAL_TEMP_NONE for none
+	GYRO_FILTER,		///< Gyro pre-filter design (filterDesign), applied at the next start
+	ACC_FILTER,			///< Accelerometer pre-filter design (filterDesign), applied at the next start
+	NUM_PARAMS
+};
+
+/**
+ * @brief How a parameter's value is interpreted
+ */
+enum class ParamType : uint8_t {
+	FLOAT = 0,
+	INT = 1
+};
+
+/**
+ * @brief Result of a parameter access, reported back in TelemetryId::PARAM
+ */
+enum class ParamStatus : uint8_t {
+	OK = 0,				///< Value read or set
+	UNKNOWN_ID = 1,		///< No parameter with that id
+	OUT_OF_RANGE = 2,	///< Value outside [min, max], not set
+	STORE_ERROR = 3		///< Set in RAM, but writing flash failed
+};
+
+/**
+ * @brief Description of one parameter
+ */
+typedef struct {
+	const char *name;	///< Name for the ground station
+	ParamType type;		///< Value type
+	float def;			///< Default, from config.h
+	float min;			///< Smallest accepted value
+	float max;			///< Largest accepted value
+} ParamInfo;
+
+extern const ParamInfo paramTable[(uint16_t)ParamId::NUM_PARAMS];
+extern ParamValue paramValues[(uint16_t)ParamId::NUM_PARAMS];
+
+void paramDefault(uint16_t id);
+void paramDefaults(void);
+ParamStatus paramCheck(uint16_t id, float value, ParamValue *out);
+float paramAsFloat(uint16_t id);
+
+/**
+ * @brief Get a FLOAT parameter's current value
+ * @param id Parameter
+ * @return Value
+ *
+ * A plain load from RAM, cheap enough for the control loop.
+ */
+static inline float paramGet(ParamId id) {
+	return paramValues[(uint16_t)id].f;
+}
+
+/**
+ * @brief Get an INT parameter's current value
+ * @param id Parameter
+ * @return Value
+ */
+static inline int32_t paramGetInt(ParamId id) {
+	return paramValues[(uint16_t)id].i;
+}
+
+#endif
+
+/** @} Close PARAMS group */
+/** @} Close System group */
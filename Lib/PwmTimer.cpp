@@ -35,6 +35,115 @@
 #include "stm32f4_discovery.h"
 #include "stm32f407xx.h"
 
+/** @defgroup TIM_Helpers TIM pin helpers
+ *  @brief Pin and channel lookups shared by the PWM and DShot outputs
+ *  @{
+ */
+
+// Arrays for mapping TimerPin p to STM HAL variables
+static const TimerChannel TimerPinToChannel[50] = {TimerChannel::TIM5_CH1, TimerChannel::TIM2_CH2, TimerChannel::TIM2_CH3, TimerChannel::TIM2_CH4, TimerChannel::TIM3_CH1, TimerChannel::TIM3_CH2, TimerChannel::TIM1_CH1, TimerChannel::TIM1_CH2, TimerChannel::TIM1_CH3, TimerChannel::TIM1_CH4, TimerChannel::TIM2_CH1, TimerChannel::TIM3_CH3, TimerChannel::TIM3_CH4, TimerChannel::TIM2_CH2, TimerChannel::TIM3_CH1, TimerChannel::TIM3_CH2, TimerChannel::TIM4_CH1, TimerChannel::TIM4_CH2, TimerChannel::TIM4_CH3, TimerChannel::TIM4_CH4, TimerChannel::TIM2_CH3, TimerChannel::TIM2_CH4, TimerChannel::TIM12_CH1, TimerChannel::TIM12_CH2, TimerChannel::TIM3_CH1, TimerChannel::TIM3_CH2, TimerChannel::TIM3_CH3, TimerChannel::TIM3_CH4, TimerChannel::TIM4_CH1, TimerChannel::TIM4_CH2, TimerChannel::TIM4_CH3, TimerChannel::TIM4_CH4, TimerChannel::TIM9_CH1, TimerChannel::TIM9_CH2, TimerChannel::TIM1_CH1, TimerChannel::TIM1_CH2, TimerChannel::TIM1_CH3, TimerChannel::TIM1_CH4, TimerChannel::TIM10_CH1, TimerChannel::TIM11_CH1, TimerChannel::TIM13_CH1, TimerChannel::TIM14_CH1, TimerChannel::TIM5_CH1, TimerChannel::TIM5_CH2, TimerChannel::TIM5_CH3, TimerChannel::TIM5_CH4, TimerChannel::TIM8_CH4, TimerChannel::TIM8_CH1, TimerChannel::TIM8_CH2, TimerChannel::TIM8_CH3};
+static GPIO_TypeDef* const TimerPinToGPIO_TD[50] = {GPIOA, GPIOA, GPIOA, GPIOA, GPIOA, GPIOA, GPIOA, GPIOA, GPIOA, GPIOA, GPIOA, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOC, GPIOC, GPIOC, GPIOC, GPIOD, GPIOD, GPIOD, GPIOD, GPIOE, GPIOE, GPIOE, GPIOE, GPIOE, GPIOE, GPIOF, GPIOF, GPIOF, GPIOF, GPIOH, GPIOH, GPIOH, GPIOI, GPIOI, GPIOI, GPIOI, GPIOI};
+static const uint16_t TimerPinToGpioPin[50] = {GPIO_PIN_0, GPIO_PIN_1, GPIO_PIN_2, GPIO_PIN_3, GPIO_PIN_6, GPIO_PIN_7, GPIO_PIN_8, GPIO_PIN_9, GPIO_PIN_10, GPIO_PIN_11,  GPIO_PIN_15, GPIO_PIN_0, GPIO_PIN_1, GPIO_PIN_3, GPIO_PIN_4, GPIO_PIN_5, GPIO_PIN_6, GPIO_PIN_7, GPIO_PIN_8, GPIO_PIN_9, GPIO_PIN_10, GPIO_PIN_11,  GPIO_PIN_14, GPIO_PIN_15, GPIO_PIN_6, GPIO_PIN_7, GPIO_PIN_8, GPIO_PIN_9, GPIO_PIN_12, GPIO_PIN_13, GPIO_PIN_14, GPIO_PIN_15, GPIO_PIN_5, GPIO_PIN_6, GPIO_PIN_9, GPIO_PIN_11, GPIO_PIN_13, GPIO_PIN_14, GPIO_PIN_6, GPIO_PIN_7, GPIO_PIN_8, GPIO_PIN_9, GPIO_PIN_10, GPIO_PIN_11, GPIO_PIN_12, GPIO_PIN_0, GPIO_PIN_2, GPIO_PIN_5, GPIO_PIN_6, GPIO_PIN_7	};
+
+static TIM_TypeDef* const TimerChannelToTIM_TD[32] = {TIM1, TIM1, TIM1, TIM1, TIM2, TIM2, TIM2, TIM2, TIM3, TIM3, TIM3, TIM3, TIM4, TIM4, TIM4, TIM4, TIM5, TIM5, TIM5, TIM5, TIM8, TIM8, TIM8, TIM8, TIM9, TIM9, TIM10, TIM11, TIM12, TIM12, TIM13, TIM14};
+static const uint32_t TimerChannelToCH[32] = {TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_1, TIM_CHANNEL_1, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_1, TIM_CHANNEL_1};
+static const uint8_t TimerChannelToAF[32] = {GPIO_AF1_TIM1, GPIO_AF1_TIM1, GPIO_AF1_TIM1, GPIO_AF1_TIM1, GPIO_AF1_TIM2, GPIO_AF1_TIM2, GPIO_AF1_TIM2, GPIO_AF1_TIM2, GPIO_AF2_TIM3, GPIO_AF2_TIM3, GPIO_AF2_TIM3, GPIO_AF2_TIM3, GPIO_AF2_TIM4, GPIO_AF2_TIM4, GPIO_AF2_TIM4, GPIO_AF2_TIM4, GPIO_AF2_TIM5, GPIO_AF2_TIM5, GPIO_AF2_TIM5, GPIO_AF2_TIM5, GPIO_AF3_TIM8, GPIO_AF3_TIM8, GPIO_AF3_TIM8, GPIO_AF3_TIM8, GPIO_AF3_TIM9, GPIO_AF3_TIM9, GPIO_AF3_TIM10, GPIO_AF3_TIM11, GPIO_AF9_TIM12, GPIO_AF9_TIM12, GPIO_AF9_TIM13, GPIO_AF9_TIM14};
+
+/**
+ * @brief  Find the TIM channel a pin is connected to
+ * @param p GPIO pin
+ * @return TIM and channel
+ */
+TimerChannel timerPinToChannel(TimerPin p) {
+	return TimerPinToChannel[(int)p];
+}
+
+/**
+ * @brief  Find the TIM peripheral of a channel
+ * @param ch TIM channel
+ * @return TIM peripheral
+ */
+TIM_TypeDef *timerChannelToTim(TimerChannel ch) {
+	return TimerChannelToTIM_TD[(int)ch];
+}
+
+/**
+ * @brief  Convert a TIM channel to the HAL TIM_CHANNEL_x value
+ * @param ch TIM channel
+ * @return TIM_CHANNEL_1 to TIM_CHANNEL_4
+ */
+uint32_t timerChannelToHal(TimerChannel ch) {
+	return TimerChannelToCH[(int)ch];
+}
+
+/**
+ * @brief Enable the GPIO clock and connect a pin to its TIM channel
+ * @param p GPIO pin
+ */
+void timerPinInit(TimerPin p) {
+	GPIO_TypeDef *GPIO_PORT = TimerPinToGPIO_TD[(int)p];
+	uint16_t GPIO_PIN = TimerPinToGpioPin[(int)p];
+	uint32_t AF = TimerChannelToAF[(int)TimerPinToChannel[(int)p]];
+
+	// GPIO Initialization
+	GPIO_InitTypeDef GPIO_InitStruct;
+
+	// Enable the appropriate GPIO clock
+	switch((uint32_t)GPIO_PORT) {
+	case (uint32_t)GPIOA: __HAL_RCC_GPIOA_CLK_ENABLE(); break;
+	case (uint32_t)GPIOB: __HAL_RCC_GPIOB_CLK_ENABLE(); break;
+	case (uint32_t)GPIOC: __HAL_RCC_GPIOC_CLK_ENABLE(); break;
+	case (uint32_t)GPIOD: __HAL_RCC_GPIOD_CLK_ENABLE(); break;
+	case (uint32_t)GPIOE: __HAL_RCC_GPIOE_CLK_ENABLE(); break;
+	case (uint32_t)GPIOF: __HAL_RCC_GPIOF_CLK_ENABLE(); break;
+	case (uint32_t)GPIOH: __HAL_RCC_GPIOH_CLK_ENABLE(); break;
+	case (uint32_t)GPIOI: __HAL_RCC_GPIOI_CLK_ENABLE(); break;
+	default: break;
+	}
+
+	// Set pin configuration
+	GPIO_InitStruct.Pin = GPIO_PIN;
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_HIGH;
+	GPIO_InitStruct.Alternate = AF;
+
+	HAL_GPIO_Init(GPIO_PORT, &GPIO_InitStruct);
+}
+
+/**
+ * @brief  Get the counting clock of a TIM peripheral
+ * @param TIMx TIM peripheral
+ * @return f_timer in Hz
+ */
+float timerClock(TIM_TypeDef *TIMx) {
+	ApbNum apb;
+
+	// Determine which APB for f_timer calculation
+	switch ((uint32_t) TIMx) {
+	case (uint32_t)TIM1: apb = ApbNum::APB2; break;
+	case (uint32_t)TIM2: apb = ApbNum::APB1; break;
+	case (uint32_t)TIM3: apb = ApbNum::APB1; break;
+	case (uint32_t)TIM4: apb = ApbNum::APB1; break;
+	case (uint32_t)TIM5: apb = ApbNum::APB1; break;
+	case (uint32_t)TIM8: apb = ApbNum::APB2; break;
+	case (uint32_t)TIM9: apb = ApbNum::APB2; break;
+	case (uint32_t)TIM10: apb = ApbNum::APB2; break;
+	case (uint32_t)TIM11: apb = ApbNum::APB2; break;
+	case (uint32_t)TIM12: apb = ApbNum::APB1; break;
+	case (uint32_t)TIM13: apb = ApbNum::APB1; break;
+	case (uint32_t)TIM14: apb = ApbNum::APB1; break;
+	default: apb = ApbNum::APB1;
+	}
+
+	uint32_t SysClkFreq = HAL_RCC_GetSysClockFreq();
+
+	if (apb == ApbNum::APB1) return (float)(SysClkFreq/2);
+	else return (float)SysClkFreq;
+}
+
+/** @} Close TIM_Helpers group */
+
 /** @defgroup TIM_Class PwmTimer class
  *  @brief TIM abstraction for generating PWM
  *  @{
@@ -60,9 +169,9 @@ PwmTimer::PwmTimer() {
 PwmTimer::PwmTimer(float f, TimerPin p) {
 	pin = p;
 
-	// Only allow frequencies between 50 and 400 Hz - ESC limited
+	// Only allow frequencies between 50 Hz and 2 kHz - ESC limited (OneShot125)
 	if (f < 50.0) frequency = 50.0;
-	else if (f > 400.0) frequency = 400.0;
+	else if (f > 2000.0) frequency = 2000.0;
 	else frequency = f;
 	pulseWidth = 1.0;
 
@@ -110,12 +219,7 @@ void PwmTimer::setFreq(float f) {
  */
 void PwmTimer::setWidth(float w) {
 	pulseWidth = w;
-	uint32_t channel;
-
-	// Convert to an HAL TIM_CHANNEL_x
-	uint32_t TimerChannelToCH[32] = {TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_1, TIM_CHANNEL_1, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_1, TIM_CHANNEL_1};
-
-	channel = TimerChannelToCH[(int)ch];
+	uint32_t channel = timerChannelToHal(ch);
 
 	// Calculate the required Capture/Compare Register value
 	uint32_t ccr = (uint32_t) ( (float)(TimHandle.Init.Period + 1) * pulseWidth * .001 * frequency - 1);
@@ -131,75 +235,17 @@ void PwmTimer::setWidth(float w) {
  * @param p GPIO pin to initialize
  */
 void PwmTimer::initTimer(float f, float w, TimerPin p) {
-	// Arrays for mapping TimerPin p to STM HAL variables
-	TimerChannel TimerPinToChannel[50] = {TimerChannel::TIM5_CH1, TimerChannel::TIM2_CH2, TimerChannel::TIM2_CH3, TimerChannel::TIM2_CH4, TimerChannel::TIM3_CH1, TimerChannel::TIM3_CH2, TimerChannel::TIM1_CH1, TimerChannel::TIM1_CH2, TimerChannel::TIM1_CH3, TimerChannel::TIM1_CH4, TimerChannel::TIM2_CH1, TimerChannel::TIM3_CH3, TimerChannel::TIM3_CH4, TimerChannel::TIM2_CH2, TimerChannel::TIM3_CH1, TimerChannel::TIM3_CH2, TimerChannel::TIM4_CH1, TimerChannel::TIM4_CH2, TimerChannel::TIM4_CH3, TimerChannel::TIM4_CH4, TimerChannel::TIM2_CH3, TimerChannel::TIM2_CH4, TimerChannel::TIM12_CH1, TimerChannel::TIM12_CH2, TimerChannel::TIM3_CH1, TimerChannel::TIM3_CH2, TimerChannel::TIM3_CH3, TimerChannel::TIM3_CH4, TimerChannel::TIM4_CH1, TimerChannel::TIM4_CH2, TimerChannel::TIM4_CH3, TimerChannel::TIM4_CH4, TimerChannel::TIM9_CH1, TimerChannel::TIM9_CH2, TimerChannel::TIM1_CH1, TimerChannel::TIM1_CH2, TimerChannel::TIM1_CH3, TimerChannel::TIM1_CH4, TimerChannel::TIM10_CH1, TimerChannel::TIM11_CH1, TimerChannel::TIM13_CH1, TimerChannel::TIM14_CH1, TimerChannel::TIM5_CH1, TimerChannel::TIM5_CH2, TimerChannel::TIM5_CH3, TimerChannel::TIM5_CH4, TimerChannel::TIM8_CH4, TimerChannel::TIM8_CH1, TimerChannel::TIM8_CH2, TimerChannel::TIM8_CH3};
-	GPIO_TypeDef* TimerPinToGPIO_TD[50] = {GPIOA, GPIOA, GPIOA, GPIOA, GPIOA, GPIOA, GPIOA, GPIOA, GPIOA, GPIOA, GPIOA, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOB, GPIOC, GPIOC, GPIOC, GPIOC, GPIOD, GPIOD, GPIOD, GPIOD, GPIOE, GPIOE, GPIOE, GPIOE, GPIOE, GPIOE, GPIOF, GPIOF, GPIOF, GPIOF, GPIOH, GPIOH, GPIOH, GPIOI, GPIOI, GPIOI, GPIOI, GPIOI};
-	uint16_t TimerPinToGpioPin[50] = {GPIO_PIN_0, GPIO_PIN_1, GPIO_PIN_2, GPIO_PIN_3, GPIO_PIN_6, GPIO_PIN_7, GPIO_PIN_8, GPIO_PIN_9, GPIO_PIN_10, GPIO_PIN_11,  GPIO_PIN_15, GPIO_PIN_0, GPIO_PIN_1, GPIO_PIN_3, GPIO_PIN_4, GPIO_PIN_5, GPIO_PIN_6, GPIO_PIN_7, GPIO_PIN_8, GPIO_PIN_9, GPIO_PIN_10, GPIO_PIN_11,  GPIO_PIN_14, GPIO_PIN_15, GPIO_PIN_6, GPIO_PIN_7, GPIO_PIN_8, GPIO_PIN_9, GPIO_PIN_12, GPIO_PIN_13, GPIO_PIN_14, GPIO_PIN_15, GPIO_PIN_5, GPIO_PIN_6, GPIO_PIN_9, GPIO_PIN_11, GPIO_PIN_13, GPIO_PIN_14, GPIO_PIN_6, GPIO_PIN_7, GPIO_PIN_8, GPIO_PIN_9, GPIO_PIN_10, GPIO_PIN_11, GPIO_PIN_12, GPIO_PIN_0, GPIO_PIN_2, GPIO_PIN_5, GPIO_PIN_6, GPIO_PIN_7	};
-
-	TIM_TypeDef* TimerChannelToTIM_TD[32] = {TIM1, TIM1, TIM1, TIM1, TIM2, TIM2, TIM2, TIM2, TIM3, TIM3, TIM3, TIM3, TIM4, TIM4, TIM4, TIM4, TIM5, TIM5, TIM5, TIM5, TIM8, TIM8, TIM8, TIM8, TIM9, TIM9, TIM10, TIM11, TIM12, TIM12, TIM13, TIM14};
-	uint32_t TimerChannelToCH[32] = {TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_1, TIM_CHANNEL_1, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_1, TIM_CHANNEL_1};
-	uint8_t TimerChannelToAF[32] = {GPIO_AF1_TIM1, GPIO_AF1_TIM1, GPIO_AF1_TIM1, GPIO_AF1_TIM1, GPIO_AF1_TIM2, GPIO_AF1_TIM2, GPIO_AF1_TIM2, GPIO_AF1_TIM2, GPIO_AF2_TIM3, GPIO_AF2_TIM3, GPIO_AF2_TIM3, GPIO_AF2_TIM3, GPIO_AF2_TIM4, GPIO_AF2_TIM4, GPIO_AF2_TIM4, GPIO_AF2_TIM4, GPIO_AF2_TIM5, GPIO_AF2_TIM5, GPIO_AF2_TIM5, GPIO_AF2_TIM5, GPIO_AF3_TIM8, GPIO_AF3_TIM8, GPIO_AF3_TIM8, GPIO_AF3_TIM8, GPIO_AF3_TIM9, GPIO_AF3_TIM9, GPIO_AF3_TIM10, GPIO_AF3_TIM11, GPIO_AF9_TIM12, GPIO_AF9_TIM12, GPIO_AF9_TIM13, GPIO_AF9_TIM14};
-
 	// Map to usable variables
-	ch = TimerPinToChannel[(int)p];
-	GPIO_TypeDef *GPIO_PORT = TimerPinToGPIO_TD[(int)p];
-	uint16_t GPIO_PIN = TimerPinToGpioPin[(int)p];
-
-	TIM_TypeDef *TIMx = TimerChannelToTIM_TD[(int)ch];
-	uint32_t channel = TimerChannelToCH[(int)ch];
-	uint32_t AF = TimerChannelToAF[(int)ch];
+	ch = timerPinToChannel(p);
+	TIM_TypeDef *TIMx = timerChannelToTim(ch);
+	uint32_t channel = timerChannelToHal(ch);
 
 	// GPIO Initialization
-	GPIO_InitTypeDef GPIO_InitStruct;
-
-	// Enable the appropriate GPIO clock
-	switch((uint32_t)GPIO_PORT) {
-	case (uint32_t)GPIOA: __HAL_RCC_GPIOA_CLK_ENABLE(); break;
-	case (uint32_t)GPIOB: __HAL_RCC_GPIOB_CLK_ENABLE(); break;
-	case (uint32_t)GPIOC: __HAL_RCC_GPIOC_CLK_ENABLE(); break;
-	case (uint32_t)GPIOD: __HAL_RCC_GPIOD_CLK_ENABLE(); break;
-	case (uint32_t)GPIOE: __HAL_RCC_GPIOE_CLK_ENABLE(); break;
-	case (uint32_t)GPIOF: __HAL_RCC_GPIOF_CLK_ENABLE(); break;
-	case (uint32_t)GPIOH: __HAL_RCC_GPIOH_CLK_ENABLE(); break;
-	case (uint32_t)GPIOI: __HAL_RCC_GPIOI_CLK_ENABLE(); break;
-	default: break;
-	}
-
-	// Set pin configuration
-	GPIO_InitStruct.Pin = GPIO_PIN;
-	GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
-	GPIO_InitStruct.Pull = GPIO_NOPULL;
-	GPIO_InitStruct.Speed = GPIO_SPEED_HIGH;
-	GPIO_InitStruct.Alternate = AF;
-
-	HAL_GPIO_Init(GPIO_PORT, &GPIO_InitStruct);
-
-	// TIM Configuration
-	ApbNum apb;
-
-	// Determine which APB for f_timer calculation
-	switch ((uint32_t) TIMx) {
-	case (uint32_t)TIM1: apb = ApbNum::APB2; break;
-	case (uint32_t)TIM2: apb = ApbNum::APB1; break;
-	case (uint32_t)TIM3: apb = ApbNum::APB1; break;
-	case (uint32_t)TIM4: apb = ApbNum::APB1; break;
-	case (uint32_t)TIM5: apb = ApbNum::APB1; break;
-	case (uint32_t)TIM8: apb = ApbNum::APB2; break;
-	case (uint32_t)TIM9: apb = ApbNum::APB2; break;
-	case (uint32_t)TIM10: apb = ApbNum::APB2; break;
-	case (uint32_t)TIM11: apb = ApbNum::APB2; break;
-	case (uint32_t)TIM12: apb = ApbNum::APB1; break;
-	case (uint32_t)TIM13: apb = ApbNum::APB1; break;
-	case (uint32_t)TIM14: apb = ApbNum::APB1; break;
-	default: apb = ApbNum::APB1;
-	}
+	timerPinInit(p);
 
 	// Calculate PSC and ARR values for given PWM frequency
 	float fTick = 3360000;
-	uint32_t SysClkFreq = HAL_RCC_GetSysClockFreq();
-
-	if (apb == ApbNum::APB1) fTimer = (float)(SysClkFreq/2);
-	else fTimer = (float)SysClkFreq;
+	fTimer = timerClock(TIMx);
 
 	uint32_t PSC = (uint32_t) ( fTimer / fTick - 1 );
 	uint32_t ARR = (uint32_t) ( fTick / f - 1 );
@@ -278,7 +324,7 @@ void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef *htim) {
 	default:	break;
 	}
 
-	// GPIO clock is enabled in PwmTimer::initTimer()
+	// GPIO clock is enabled in timerPinInit()
 }
 
 /** @} Close TIM_Functions group */
@@ -184,6 +184,12 @@ public:
 	void setWidth(float w);
 };
 
+TimerChannel timerPinToChannel(TimerPin p);
+TIM_TypeDef *timerChannelToTim(TimerChannel ch);
+uint32_t timerChannelToHal(TimerChannel ch);
+void timerPinInit(TimerPin p);
+float timerClock(TIM_TypeDef *TIMx);
+
 #endif /* PWMTIMER_H_ */
 
 /** @} Close TIM group */
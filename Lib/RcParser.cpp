@@ -0,0 +1,140 @@
+/**
+ * @file
+ *
+ * @brief Streaming remote control packet parser
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Peripherals
+ *  @{
+ */
+
+/** @addtogroup UART
+ *  @{
+ */
+
+#include "RcParser.h"
+
+/** @defgroup RcParser_Class RcParser class
+ *  @brief Remote control packet framing and validation
+ *  @{
+ */
+
+/**
+ * @brief Construct an RcParser
+ */
+RcParser::RcParser() {
+	len = 0;
+	runByte = 0;
+	runLen = 0;
+	fresh = false;
+	packets = errors = 0;
+
+	latest.type = RcPacketType::STICKS;
+	latest.time = 0;
+	for (uint8_t i = 0; i < TRANSFER_SIZE; i++) {
+		latest.data[i] = 0;
+	}
+}
+
+/**
+ * @brief Feed one received byte
+ * @param b    Received byte
+ * @param time Current time [ms]
+ * @return true if b completed a packet
+ */
+bool RcParser::feed(uint8_t b, uint32_t time) {
+	bool done = false;
+
+	// Stick packets
+	if (b == START) {
+		if (len > 0) {
+			errors++;
+		}
+		buff[0] = b;
+		len = 1;
+	} else if (len > 0) {
+		buff[len++] = b;
+
+		if (len == TRANSFER_SIZE || b == STOP) {
+			if (len == TRANSFER_SIZE && b == STOP) {
+				latest.type = RcPacketType::STICKS;
+				for (uint8_t i = 0; i < TRANSFER_SIZE; i++) {
+					latest.data[i] = buff[i];
+				}
+				done = true;
+			} else {
+				errors++;
+			}
+			len = 0;
+		}
+	}
+
+	// Commands - runs of one byte outside a stick packet. START and STOP
+	// bracket every stick packet, so its data can't form a full run.
+	if (b == START || b == STOP || b != runByte) {
+		runByte = b;
+		runLen = 0;
+	}
+	if (b != START && b != STOP && len == 0) {
+		runLen++;
+		if (runLen == TRANSFER_SIZE) {
+			latest.type = RcPacketType::COMMAND;
+			for (uint8_t i = 0; i < TRANSFER_SIZE; i++) {
+				latest.data[i] = b;
+			}
+			runLen = 0;
+			done = true;
+		}
+	}
+
+	if (done) {
+		latest.time = time;
+		packets++;
+		fresh = true;
+	}
+
+	return done;
+}
+
+/**
+ * @brief Get the newest packet if it hasn't been read yet
+ * @param pkt Returns the packet
+ * @return false if there is no new packet
+ *
+ * @note Only the newest packet is kept; older unread packets are superseded
+ */
+bool RcParser::read(RcPacket *pkt) {
+	if (!fresh) {
+		return false;
+	}
+
+	*pkt = latest;
+	fresh = false;
+	return true;
+}
+
+/**
+ * @brief  Get the number of good packets
+ * @return Packet count
+ */
+uint32_t RcParser::getPackets(void) {
+	return packets;
+}
+
+/**
+ * @brief  Get the number of dropped partial packets
+ * @return Error count
+ */
+uint32_t RcParser::getErrors(void) {
+	return errors;
+}
+
+/** @} Close RcParser_Class group */
+
+/** @} Close UART group */
+/** @} Close Peripherals Group */
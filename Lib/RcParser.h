@@ -0,0 +1,95 @@
+/**
+ * @file
+ *
+ * @brief Streaming remote control packet parser
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * The remote sends two kinds of 6-byte packets:
+ * 		- Sticks:  START, throttle, pitch, roll, yaw, STOP (data bytes < STOP)
+ * 		- Command: the same command byte repeated TRANSFER_SIZE times
+ *
+ * Bytes are fed one at a time as they arrive, so packets don't have to line
+ * up with any DMA buffer and a lost or extra byte only costs the packet it
+ * hits.
+ *
+ */
+
+/** @addtogroup Peripherals
+ *  @{
+ */
+
+/** @addtogroup UART
+ *  @{
+ */
+
+#ifndef RCPARSER_H_
+#define RCPARSER_H_
+
+#include <stdint.h>
+
+/// Defines for UART RX
+#define START 255
+#define STOP  254
+#define TRANSFER_SIZE 6
+
+/// Command bytes
+#define FLY_CMD 1
+#define DEMO_CMD 2
+#define DEMO_MOTOR_TOGGLE 3
+
+/**
+ * @brief Remote control packet types
+ */
+enum class RcPacketType : uint8_t {
+	STICKS,		///< START, 4 stick bytes, STOP
+	COMMAND		///< One command byte, repeated
+};
+
+/**
+ * @brief A validated remote control packet
+ */
+struct RcPacket {
+	RcPacketType type;				///< Packet type
+	uint8_t data[TRANSFER_SIZE];	///< Raw packet bytes
+	uint32_t time;					///< Time the last byte was processed [ms]
+};
+
+/**
+ * @brief Incremental byte-stream parser for remote control packets
+ *
+ * A stick packet is collected from each START. A START seen mid-packet
+ * restarts the packet, and a STOP in the wrong place or a missing STOP
+ * drops it, so the parser is back in sync on the next START. Commands are
+ * recognised as TRANSFER_SIZE identical bytes outside a stick packet. Does
+ * not touch hardware.
+ */
+class RcParser {
+private:
+	uint8_t buff[TRANSFER_SIZE];	///< Stick packet being collected
+	uint8_t len;					///< Bytes in buff, 0 when waiting for START
+	uint8_t runByte;				///< Byte of the current run
+	uint8_t runLen;					///< Length of the current run
+
+	RcPacket latest;				///< Last complete packet
+	volatile bool fresh;			///< latest hasn't been read
+
+	uint32_t packets;				///< Good packets
+	uint32_t errors;				///< Dropped partial packets
+
+public:
+	RcParser();
+
+	bool feed(uint8_t b, uint32_t time);
+	bool read(RcPacket *pkt);
+
+	uint32_t getPackets(void);
+	uint32_t getErrors(void);
+};
+
+#endif
+
+/** @} Close UART group */
+/** @} Close Peripherals Group */
@@ -0,0 +1,277 @@
+/**
+ * @file
+ *
+ * @brief Relay-feedback PID autotuner
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @defgroup AUTOTUNE Relay autotuner
+ *  @brief Ultimate gain and period from a relay experiment, PID gains from those
+ *  @{
+ */
+
+#include "RelayTuner.h"
+#include <math.h>
+
+#ifndef PI
+#define PI 3.14159265358979f
+#endif
+
+/**
+ * @brief Gains of one tuning rule: Kp = p Ku, Ti = i Tu, Td = d Tu
+ */
+typedef struct {
+	float p;	///< Proportional gain, fraction of Ku
+	float i;	///< Integral time, fraction of Tu
+	float d;	///< Derivative time, fraction of Tu
+} TuneRuleGains;
+
+/**
+ * @brief Tuning rules, indexed by TuneRule
+ */
+static const TuneRuleGains tuneRules[(uint8_t)TuneRule::NUM_RULES] = {
+	{ 0.6f,			0.5f,	0.125f },			// ZIEGLER_NICHOLS
+	{ 1.0f / 2.2f,	2.2f,	1.0f / 6.3f },		// TYREUS_LUYBEN
+	{ 0.7f,			0.4f,	0.15f },			// PESSEN
+	{ 0.33f,		0.5f,	1.0f / 3.0f },		// SOME_OVERSHOOT
+	{ 0.2f,			0.5f,	1.0f / 3.0f }		// NO_OVERSHOOT
+};
+
+/**
+ * @brief Create an idle tuner
+ *
+ * No angle or error limit and no timeout until setLimits().
+ */
+RelayTuner::RelayTuner() {
+	state = TunerState::IDLE;
+	reason = TunerAbort::NONE;
+	amplitude = hysteresis = bias = 0.0f;
+	angleLimit = INFINITY;
+	errorLimit = INFINITY;
+	timeout = INFINITY;
+	relay = 1.0f;
+	elapsed = sinceRise = 0.0f;
+	risen = false;
+	eMax = eMin = 0.0f;
+	lastPeriod = phase = sumCos = sumSin = 0.0f;
+	cycles = 0;
+	sumPeriod = sumAmp = 0.0f;
+	minPeriod = maxPeriod = 0.0f;
+	ku = tu = 0.0f;
+}
+
+/**
+ * @brief Change the abort limits
+ * @param angle Largest angle either way [deg]
+ * @param time  Longest experiment [s]
+ * @param error Largest loop error either way, error units. Catches a runaway
+ * 				rate the angle won't show, or that has no angle (yaw).
+ */
+void RelayTuner::setLimits(float angle, float time, float error) {
+	angleLimit = angle;
+	timeout = time;
+	errorLimit = error;
+}
+
+/**
+ * @brief Start an experiment
+ * @param d    Relay amplitude, actuator units. Bounds the actuator swing.
+ * @param h    Relay hysteresis, error units. A little above the noise.
+ * @param trim Actuator value to swing around, e.g. the loop's integral term
+ */
+void RelayTuner::start(float d, float h, float trim) {
+	amplitude = d;
+	hysteresis = h;
+	bias = trim;
+
+	state = TunerState::RUNNING;
+	reason = TunerAbort::NONE;
+	relay = 1.0f;
+	elapsed = sinceRise = 0.0f;
+	risen = false;
+	eMax = -INFINITY;
+	eMin = INFINITY;
+	lastPeriod = phase = sumCos = sumSin = 0.0f;
+	cycles = 0;
+	sumPeriod = sumAmp = 0.0f;
+	minPeriod = INFINITY;
+	maxPeriod = 0.0f;
+	ku = tu = 0.0f;
+}
+
+/**
+ * @brief Stop the experiment early
+ */
+void RelayTuner::stop(void) {
+	if (state == TunerState::RUNNING) {
+		abort(TunerAbort::STOPPED);
+	}
+}
+
+/**
+ * @brief End the experiment unsuccessfully
+ */
+void RelayTuner::abort(TunerAbort why) {
+	state = TunerState::ABORTED;
+	reason = why;
+}
+
+/**
+ * @brief Work out Ku and Tu from the measured cycles
+ */
+void RelayTuner::finish(void) {
+	float period = sumPeriod / TUNE_MEASURE_CYCLES;
+	float a1 = sumAmp / TUNE_MEASURE_CYCLES;
+
+	if (maxPeriod - minPeriod > TUNE_MAX_SPREAD * period || a1 <= 0.0f) {
+		abort(TunerAbort::UNSTEADY);
+		return;
+	}
+
+	ku = 4.0f * amplitude / (PI * a1);
+	tu = period;
+	state = TunerState::DONE;
+}
+
+/**
+ * @brief Run the relay for one sample
+ * @param e     Loop error, setpoint - measurement
+ * @param angle Angle to keep within the limit [deg]. For an axis without one,
+ * 				the excursion since start(), e.g. the integrated yaw rate.
+ * @param dt    Sample time [s]
+ * @return Actuator command, bias +/- amplitude. Just the bias once the
+ * 		   experiment is over.
+ *
+ * One cycle runs from one switch of the relay to +1 to the next. The first
+ * TUNE_SKIP_CYCLES are left out, the next TUNE_MEASURE_CYCLES are averaged.
+ */
+float RelayTuner::update(float e, float angle, float dt) {
+	if (state != TunerState::RUNNING) {
+		return bias;
+	}
+
+	elapsed += dt;
+	sinceRise += dt;
+
+	if (fabsf(angle) > angleLimit) {
+		abort(TunerAbort::ANGLE);
+		return bias;
+	}
+	if (fabsf(e) > errorLimit) {
+		abort(TunerAbort::ERROR);
+		return bias;
+	}
+	if (elapsed > timeout) {
+		abort(TunerAbort::TIMED_OUT);
+		return bias;
+	}
+
+	eMax = fmaxf(eMax, e);
+	eMin = fminf(eMin, e);
+
+	// Fundamental of the error, assuming this cycle is as long as the last
+	sumCos += e * cosf(phase) * dt;
+	sumSin += e * sinf(phase) * dt;
+	phase += 2.0f * PI * dt / fmaxf(lastPeriod, dt);
+
+	if (relay > 0.0f && e < -hysteresis) {
+		relay = -1.0f;
+	} else if (relay < 0.0f && e > hysteresis) {
+		relay = 1.0f;
+
+		// A full cycle since the last switch to +1
+		if (risen) {
+			cycles++;
+			if (cycles > TUNE_SKIP_CYCLES) {
+				// The oscillation has to clear the hysteresis to be a limit
+				// cycle rather than noise
+				if ((eMax - eMin) / 2.0f <= hysteresis) {
+					abort(TunerAbort::UNSTEADY);
+					return bias;
+				}
+
+				sumPeriod += sinceRise;
+				sumAmp += 2.0f / sinceRise * sqrtf(sumCos * sumCos + sumSin * sumSin);
+				minPeriod = fminf(minPeriod, sinceRise);
+				maxPeriod = fmaxf(maxPeriod, sinceRise);
+
+				if (cycles == TUNE_SKIP_CYCLES + TUNE_MEASURE_CYCLES) {
+					finish();
+					return bias;
+				}
+			}
+		}
+		risen = true;
+		lastPeriod = sinceRise;
+		sinceRise = 0.0f;
+		phase = 0.0f;
+		sumCos = sumSin = 0.0f;
+		eMax = eMin = e;
+	}
+
+	return bias + relay * amplitude;
+}
+
+/**
+ * @brief Get the state of the experiment
+ * @return State
+ */
+TunerState RelayTuner::getState(void) {
+	return state;
+}
+
+/**
+ * @brief Get why the experiment was aborted
+ * @return Reason, TunerAbort::NONE unless ABORTED
+ */
+TunerAbort RelayTuner::getAbort(void) {
+	return reason;
+}
+
+/**
+ * @brief Get the measured ultimate gain
+ * @return Ku [actuator per error unit], 0 until DONE
+ */
+float RelayTuner::getUltimateGain(void) {
+	return ku;
+}
+
+/**
+ * @brief Get the measured ultimate period
+ * @return Tu [s], 0 until DONE
+ */
+float RelayTuner::getUltimatePeriod(void) {
+	return tu;
+}
+
+/**
+ * @brief Calculate PID gains from Ku and Tu
+ * @param rule Tuning rule
+ * @param kp   Returns the proportional gain
+ * @param ki   Returns the integral gain, Kp / Ti
+ * @param kd   Returns the derivative gain, Kp * Td
+ * @return false if the experiment isn't DONE or the rule is unknown
+ */
+bool RelayTuner::getGains(TuneRule rule, float *kp, float *ki, float *kd) {
+	if (state != TunerState::DONE || (uint8_t)rule >= (uint8_t)TuneRule::NUM_RULES) {
+		return false;
+	}
+
+	const TuneRuleGains *g = &tuneRules[(uint8_t)rule];
+
+	*kp = g->p * ku;
+	*ki = *kp / (g->i * tu);
+	*kd = *kp * g->d * tu;
+	return true;
+}
+
+/** @} Close AUTOTUNE group */
+/** @} Close Control Group */
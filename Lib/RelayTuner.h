@@ -0,0 +1,153 @@
+/**
+ * @file
+ *
+ * @brief Relay-feedback PID autotuner
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Åström–Hägglund relay experiment: the loop's controller is replaced by a
+ * relay that drives the actuator to bias +/- amplitude depending on the sign
+ * of the error. Most plants settle into a limit cycle at their ultimate
+ * (phase crossover) period Tu. The relay output's fundamental has amplitude
+ * 4d/pi, so with a1 the amplitude of the error's fundamental the ultimate
+ * gain is
+ *
+ * 		Ku = 4 d / (pi a1)
+ *
+ * a1 is taken by correlating the error with a sine and cosine at the last
+ * period, rather than from the peaks as in the textbook version, which reads
+ * Ku 20-30% low on plants with dead time (the error isn't a sine). The relay
+ * hysteresis h keeps noise from chattering the relay; keep it small next to
+ * the oscillation, it moves the oscillation slightly below the phase
+ * crossover. PID gains then follow from Ku and Tu with one of the TuneRule
+ * tables.
+ *
+ * The actuator swing is bounded by the amplitude, and the experiment aborts
+ * if the angle or the loop error passes a limit, or no steady oscillation
+ * turns up in time. An axis without an angle (yaw) passes its excursion
+ * since start() instead, e.g. the integrated rate.
+ *
+ * Does not touch hardware, so the state machine and gain calculation can be
+ * run against a simulated plant on a host.
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @addtogroup AUTOTUNE
+ *  @{
+ */
+
+#ifndef RELAYTUNER_H_
+#define RELAYTUNER_H_
+
+#include <stdint.h>
+
+#define TUNE_SKIP_CYCLES	2		///< Cycles left out while the oscillation settles
+#define TUNE_MEASURE_CYCLES	4		///< Cycles averaged for Ku and Tu
+#define TUNE_MAX_SPREAD		0.2f	///< Largest period spread over the measured cycles, fraction of Tu
+
+/**
+ * @brief Where the experiment is
+ */
+enum class TunerState : uint8_t {
+	IDLE = 0,			///< Never started
+	RUNNING = 1,		///< Relay in control
+	DONE = 2,			///< Ku and Tu measured
+	ABORTED = 3			///< Stopped early, see TunerAbort
+};
+
+/**
+ * @brief Why the experiment was aborted
+ */
+enum class TunerAbort : uint8_t {
+	NONE = 0,
+	ANGLE = 1,			///< Angle passed the limit
+	TIMED_OUT = 2,		///< No steady oscillation in time
+	STOPPED = 3,		///< stop() called
+	UNSTEADY = 4,		///< Periods or amplitude too irregular to use
+	ERROR = 5			///< Loop error passed the limit
+};
+
+/**
+ * @brief Tuning rules, from Ku and Tu to PID gains
+ */
+enum class TuneRule : uint8_t {
+	ZIEGLER_NICHOLS = 0,	///< Classic, fast, about 25% overshoot
+	TYREUS_LUYBEN = 1,		///< Conservative, less integral
+	PESSEN = 2,				///< Pessen integral rule, aggressive
+	SOME_OVERSHOOT = 3,		///< Ziegler-Nichols "some overshoot"
+	NO_OVERSHOOT = 4,		///< Ziegler-Nichols "no overshoot"
+	NUM_RULES
+};
+
+/**
+ * @brief Relay experiment on one loop
+ *
+ * Usage, every sample of the loop being tuned:
+ *
+ * 		tuner.start(d, h, trim);
+ * 		while (tuner.getState() == TunerState::RUNNING) {
+ * 			u = tuner.update(setpoint - y, angle, dt);	// instead of the PID
+ * 			// or, for yaw: heading += y * dt; tuner.update(setpoint - y, heading, dt);
+ * 		}
+ * 		tuner.getGains(TuneRule::ZIEGLER_NICHOLS, &kp, &ki, &kd);
+ */
+class RelayTuner {
+private:
+	TunerState state;		///< Where the experiment is
+	TunerAbort reason;		///< Why it was aborted
+
+	float amplitude;		///< Relay amplitude d, actuator units
+	float hysteresis;		///< Relay hysteresis h, error units
+	float bias;				///< Actuator value the relay swings around
+	float angleLimit;		///< Largest angle before aborting [deg]
+	float errorLimit;		///< Largest loop error before aborting, error units
+	float timeout;			///< Longest experiment [s]
+
+	float relay;			///< Relay state, +1 or -1
+	float elapsed;			///< Time since start() [s]
+	float sinceRise;		///< Time since the relay last switched to +1 [s]
+	bool risen;				///< The relay has switched to +1 at least once
+	float eMax;				///< Largest error this cycle
+	float eMin;				///< Smallest error this cycle
+	float lastPeriod;		///< Length of the last cycle [s]
+	float phase;			///< Phase within the cycle, at lastPeriod [rad]
+	float sumCos;			///< Error times cos(phase), integrated over the cycle
+	float sumSin;			///< Error times sin(phase), integrated over the cycle
+	uint8_t cycles;			///< Cycles completed
+
+	float sumPeriod;		///< Measured periods, summed [s]
+	float sumAmp;			///< Measured error fundamental amplitudes, summed
+	float minPeriod;		///< Shortest measured period [s]
+	float maxPeriod;		///< Longest measured period [s]
+
+	float ku;				///< Ultimate gain, actuator per error unit
+	float tu;				///< Ultimate period [s]
+
+	void abort(TunerAbort why);
+	void finish(void);
+
+public:
+	RelayTuner();
+
+	void setLimits(float angleLimit, float timeout, float errorLimit);
+	void start(float amplitude, float hysteresis, float bias);
+	float update(float e, float angle, float dt);
+	void stop(void);
+
+	TunerState getState(void);
+	TunerAbort getAbort(void);
+	float getUltimateGain(void);
+	float getUltimatePeriod(void);
+	bool getGains(TuneRule rule, float *kp, float *ki, float *kd);
+};
+
+#endif
+
+/** @} Close AUTOTUNE group */
+/** @} Close Control Group */
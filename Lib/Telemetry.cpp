@@ -0,0 +1,331 @@
+/**
+ * @file
+ *
+ * @brief Binary telemetry frames
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @defgroup TELEMETRY Binary telemetry
+ *  @brief Compact CRC-checked telemetry frames sent over the UART
+ *  @{
+ */
+
+#include "Telemetry.h"
+#include "uart.h"
+
+/** @defgroup TELEMETRY_Functions Field functions
+ *  @brief Fixed-point helpers
+ *  @{
+ */
+
+/**
+ * @brief Convert to a saturated fixed-point field
+ * @param x     Value
+ * @param scale Counts per unit
+ * @return round(x * scale), clamped to the int16_t range
+ */
+int16_t telemetryFixed(float x, float scale) {
+	float c = x * scale;
+
+	if (c >= 32767.0f) return 32767;
+	if (c <= -32768.0f) return -32768;
+
+	return (int16_t)(c >= 0.0f ? c + 0.5f : c - 0.5f);
+}
+
+/**
+ * @brief Read a little-endian uint16_t field
+ * @param p First byte
+ * @return Field value
+ */
+uint16_t telemetryGetU16(const uint8_t *p) {
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+ * @brief Read a little-endian int16_t field
+ * @param p First byte
+ * @return Field value
+ */
+int16_t telemetryGetS16(const uint8_t *p) {
+	return (int16_t)telemetryGetU16(p);
+}
+
+/** @} Close TELEMETRY_Functions group */
+
+/** @defgroup TELEMETRY_Class Telemetry classes
+ *  @brief Frame builder, decoder and sender
+ *  @{
+ */
+
+/**
+ * @brief Start a frame
+ * @param id  Message id
+ * @param seq Sequence number, see Telemetry::nextSeq()
+ */
+TelemetryFrame::TelemetryFrame(TelemetryId id, uint8_t seq) {
+	raw[0] = (uint8_t)id;
+	raw[1] = seq;
+	len = 2;
+	overflow = false;
+}
+
+/**
+ * @brief Check that n more payload bytes fit
+ * @param n Field size
+ * @return true if the field fits
+ */
+bool TelemetryFrame::reserve(uint16_t n) {
+	if (len + n > TELEM_MAX_PAYLOAD + 2) {
+		overflow = true;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Append a byte
+ * @param x Value
+ */
+void TelemetryFrame::putU8(uint8_t x) {
+	if (!reserve(1)) return;
+	raw[len++] = x;
+}
+
+/**
+ * @brief Append a uint16_t, little-endian
+ * @param x Value
+ */
+void TelemetryFrame::putU16(uint16_t x) {
+	if (!reserve(2)) return;
+	raw[len++] = (uint8_t)x;
+	raw[len++] = (uint8_t)(x >> 8);
+}
+
+/**
+ * @brief Append an int16_t, little-endian
+ * @param x Value
+ */
+void TelemetryFrame::putS16(int16_t x) {
+	putU16((uint16_t)x);
+}
+
+/**
+ * @brief Append a uint32_t, little-endian
+ * @param x Value
+ */
+void TelemetryFrame::putU32(uint32_t x) {
+	if (!reserve(4)) return;
+	for (uint8_t i = 0; i < 4; i++) {
+		raw[len++] = (uint8_t)(x >> (8*i));
+	}
+}
+
+/**
+ * @brief Append a float as a saturated int16_t fixed-point field
+ * @param x     Value
+ * @param scale Counts per unit
+ */
+void TelemetryFrame::putFixed(float x, float scale) {
+	putS16(telemetryFixed(x, scale));
+}
+
+/**
+ * @brief  Check whether any field was dropped
+ * @return true if the payload overflowed
+ */
+bool TelemetryFrame::overflowed(void) {
+	return overflow;
+}
+
+/**
+ * @brief Append the CRC, COBS encode and delimit the frame
+ * @param out Encoded frame, at least TELEM_MAX_FRAME long
+ * @return Number of bytes to send
+ *
+ * @note The frame can't be extended afterwards
+ */
+uint16_t TelemetryFrame::encode(uint8_t *out) {
+	uint16_t crc = crc16Ccitt(raw, len);
+	raw[len] = (uint8_t)crc;
+	raw[len + 1] = (uint8_t)(crc >> 8);
+
+	uint16_t n = cobsEncode(raw, len + 2, out);
+	out[n++] = 0;
+
+	return n;
+}
+
+/**
+ * @brief Construct a TelemetryDecoder
+ */
+TelemetryDecoder::TelemetryDecoder() {
+	len = 0;
+	overrun = false;
+	frameLen = 0;
+	crcErrors = lost = 0;
+	haveSeq = false;
+	lastSeq = 0;
+}
+
+/**
+ * @brief Feed one received byte
+ * @param b Received byte
+ * @return true when a good frame has just completed
+ */
+bool TelemetryDecoder::feed(uint8_t b) {
+	if (b != 0) {
+		if (len < TELEM_MAX_FRAME) {
+			buff[len++] = b;
+		} else {
+			overrun = true;
+		}
+		return false;
+	}
+
+	// Delimiter - an empty frame is just back-to-back zeros
+	if (len == 0 && !overrun) {
+		return false;
+	}
+
+	uint8_t tmp[TELEM_MAX_FRAME];
+	uint16_t n = overrun ? 0 : cobsDecode(buff, len, tmp);
+	len = 0;
+	overrun = false;
+
+	if (n < 4 || crc16Ccitt(tmp, n - 2) != telemetryGetU16(&tmp[n - 2])) {
+		crcErrors++;
+		return false;
+	}
+
+	for (uint16_t i = 0; i < n - 2; i++) {
+		frame[i] = tmp[i];
+	}
+	frameLen = n - 2;
+
+	if (haveSeq) {
+		lost += (uint8_t)(frame[1] - lastSeq - 1);
+	}
+	haveSeq = true;
+	lastSeq = frame[1];
+
+	return true;
+}
+
+/**
+ * @brief  Get the id of the last good frame
+ * @return Message id
+ */
+TelemetryId TelemetryDecoder::getId(void) {
+	return (TelemetryId)frame[0];
+}
+
+/**
+ * @brief  Get the sequence number of the last good frame
+ * @return Sequence number
+ */
+uint8_t TelemetryDecoder::getSeq(void) {
+	return frame[1];
+}
+
+/**
+ * @brief  Get the payload of the last good frame
+ * @return Pointer to the first payload byte
+ */
+const uint8_t *TelemetryDecoder::getPayload(void) {
+	return &frame[2];
+}
+
+/**
+ * @brief  Get the payload length of the last good frame
+ * @return Payload bytes
+ */
+uint16_t TelemetryDecoder::getLength(void) {
+	return frameLen >= 2 ? frameLen - 2 : 0;
+}
+
+/**
+ * @brief  Get the number of frames dropped for CRC or framing errors
+ * @return Bad frame count
+ */
+uint32_t TelemetryDecoder::getCrcErrors(void) {
+	return crcErrors;
+}
+
+/**
+ * @brief  Get the number of frames missing from the sequence
+ * @return Lost frame count
+ */
+uint32_t TelemetryDecoder::getLost(void) {
+	return lost;
+}
+
+Telemetry *Telemetry::telemInstance = NULL;
+
+/**
+ * @brief This function is called to create/get the instance
+ * @return Pointer to the Telemetry singleton
+ *
+ * @note init_USART() should be called first
+ */
+Telemetry* Telemetry::Instance(void) {
+	if (telemInstance == NULL) {
+		telemInstance = new Telemetry();
+	}
+
+	return telemInstance;
+}
+
+/**
+ * @brief Construct the Telemetry sender
+ */
+Telemetry::Telemetry() {
+	seq = 0;
+	dropped = 0;
+}
+
+/**
+ * @brief  Get the sequence number for a new frame
+ * @return Sequence number
+ */
+uint8_t Telemetry::nextSeq(void) {
+	return seq++;
+}
+
+/**
+ * @brief Queue a frame without blocking
+ * @param frame Frame to encode and send
+ * @return false if the UART TX queue is full and the frame was dropped
+ */
+bool Telemetry::send(TelemetryFrame &frame) {
+	uint8_t *out = usart_tx_reserve(TELEM_MAX_FRAME);
+
+	if (out == NULL) {
+		dropped++;
+		return false;
+	}
+
+	usart_tx_commit(frame.encode(out));
+	return true;
+}
+
+/**
+ * @brief  Get the number of frames dropped on a full queue
+ * @return Dropped frame count
+ */
+uint32_t Telemetry::getDropped(void) {
+	return dropped;
+}
+
+/** @} Close TELEMETRY_Class group */
+
+/** @} Close TELEMETRY group */
+/** @} Close System group */
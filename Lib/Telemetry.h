@@ -0,0 +1,249 @@
+/**
+ * @file
+ *
+ * @brief Binary telemetry frames
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Telemetry is sent as small binary frames instead of printf text. A frame
+ * before framing is:
+ * 		- [0]      Message id (TelemetryId)
+ * 		- [1]      Sequence number, wraps at 255
+ * 		- [2..n+1] Payload, little-endian fixed-point fields
+ * 		- [n+2..]  CRC-16/CCITT (poly 0x1021, init 0xFFFF) of bytes 0..n+1,
+ * 		           little-endian
+ *
+ * The frame is COBS encoded (Framing.h) and terminated by a single 0x00, so a receiver
+ * resynchronises on the next zero byte after any corruption.
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup TELEMETRY
+ *  @{
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include "Framing.h"
+
+#define TELEM_MAX_PAYLOAD	64		///< Largest payload [bytes]
+#define TELEM_MAX_RAW		(TELEM_MAX_PAYLOAD + 4)		///< id + seq + payload + CRC
+#define TELEM_MAX_FRAME		(TELEM_MAX_RAW + TELEM_MAX_RAW/254 + 2)	///< COBS overhead + delimiter
+
+/// Bytes on the wire for a frame with an n byte payload
+#define TELEM_FRAME_BYTES(n)	((n) + 4 + ((n) + 4)/254 + 2)
+
+// Fixed-point scales (counts per unit)
+#define TELEM_ANGLE_SCALE	100.0f	///< 0.01 deg
+#define TELEM_RATE_SCALE	10.0f	///< 0.1 deg/s
+#define TELEM_SPEED_SCALE	10000.0f	///< 1e-4 of full motor speed
+#define TELEM_HEIGHT_SCALE	10.0f	///< 0.1 in
+#define TELEM_VOLT_SCALE	1000.0f	///< mV
+#define TELEM_AMP_SCALE		100.0f	///< 0.01 A
+#define TELEM_PID_SCALE		10.0f	///< 0.1 of PID output
+
+/**
+ * @brief Telemetry message ids
+ *
+ * FLIGHT is no longer sent; fly() splits the same state into the ATTITUDE to
+ * ERRORS channel frames below (TelemetryScheduler.h). Its payload was, in
+ * order (s16 fields use the TELEM_*_SCALE noted):
+ * 		- s16 pitch, roll [ANGLE]
+ * 		- s16 pitch command, roll command [ANGLE]
+ * 		- s16 yaw rate command [RATE]
+ * 		- s16 throttle command, pitch PID output, roll PID output [SPEED]
+ * 		- u8  motor count n, then n x s16 motor speed [SPEED]
+ * 		- s16 height [HEIGHT]
+ * 		- u16 battery voltage [VOLT]
+ * 		- s16 battery current [AMP]
+ * 		- u16 consumed charge [mAh]
+ * 		- u16 I2C errors, u16 I2C recoveries
+ * 		- u8  IMU stale flag
+ *
+ * LINK payload, sent in reply to each UplinkId::HEARTBEAT:
+ * 		- u8  heartbeat sequence number
+ * 		- u32 ground station time from the heartbeat [ms]
+ * 		- u32 uplink messages received, lost and dropped by CRC/framing
+ *
+ * PARAM payload, sent in reply to each UplinkId::PARAM_GET and PARAM_SET:
+ * 		- u8  request sequence number
+ * 		- u16 parameter id (ParamId)
+ * 		- u8  ParamStatus
+ * 		- u8  ParamType, then u32 value bits (f32 or s32) after the request
+ *
+ * LOG payload, sent in reply to each UplinkId::LOG_ERASE:
+ * 		- u8  request sequence number
+ * 		- u8  1 if erased, 0 if refused (armed, no recorder) or failed
+ * 		- u32 recorder bytes used, u32 recorder size, u32 records dropped
+ *
+ * TRACE payload, binary log entries (BinLog.h), repeated while they fit:
+ * 		- u16 LogMsg id, u8 argument count n
+ * 		- u32 DWT cycle count
+ * 		- n x u32 raw argument
+ *
+ * ATTITUDE payload:
+ * 		- s16 pitch, roll [ANGLE]
+ * 		- s16 pitch command, roll command [ANGLE]
+ * 		- s16 yaw rate command [RATE]
+ * 		- s16 throttle command [SPEED]
+ *
+ * CONTROL payload:
+ * 		- s16 pitch, roll, yaw rate loop output [SPEED]
+ * 		- s16 pitch, roll, yaw rate setpoint [RATE]
+ * 		- s16 pitch rate P, I, D terms, roll rate P, I, D terms [PID]
+ * 		- u8  motor count n, then n x s16 motor speed [SPEED]
+ *
+ * ALTITUDE payload:
+ * 		- s16 height [HEIGHT]
+ *
+ * BATTERY payload:
+ * 		- u16 battery voltage [VOLT]
+ * 		- s16 battery current [AMP]
+ * 		- u16 consumed charge [mAh]
+ *
+ * TIMING payload:
+ * 		- u16 loop period, last [us]
+ * 		- u16 loop work time (everything but the wait), last and worst since
+ * 		  the previous TIMING frame [us]
+ *
+ * ERRORS payload:
+ * 		- u16 I2C errors, u16 I2C recoveries, summed over every bus in use
+ * 		- u8  IMU stale flag
+ * 		- u32 telemetry frames dropped on a full queue
+ * 		- u32 telemetry frames skipped by the scheduler
+ * 		- u32 uplink messages lost, u32 uplink frames dropped by CRC/framing
+ * 		- u32 binary log entries dropped, u32 flight recorder records dropped
+ *
+ * TUNE payload, sent in reply to each UplinkId::AUTOTUNE and when the
+ * experiment ends:
+ * 		- u8  request sequence number
+ * 		- u8  axis (ControlAxis + 1, 0 for none), u8 TunerState,
+ * 		  u8 TunerAbort, u8 TuneRule
+ * 		- u32 f32 bits of the ultimate gain Ku and period Tu [s]
+ * 		- u32 f32 bits of the rate P, I, D gains stored, 0 unless DONE
+ * 		- u8  ParamStatus of storing the gains
+ *
+ * I2C_BUS payload, one bus in use per frame, taking turns:
+ * 		- u8  bus (i2cBus)
+ * 		- u32 transfers, u32 bytes, u32 errors, u32 retries, u32 recoveries,
+ * 		  u32 failures, all since boot
+ * 		- u32 busy cycles, u32 elapsed cycles since this bus' previous
+ * 		  I2C_BUS frame; their ratio is the bus utilization
+ * 		- u8  largest queue depth since the previous frame
+ */
+enum class TelemetryId : uint8_t {
+	FLIGHT = 1,		///< fly() state
+	LINK = 2,		///< Heartbeat echo and uplink counters
+	PARAM = 3,		///< Parameter value after a get or set
+	LOG = 4,		///< Flight recorder state
+	TRACE = 5,		///< Binary log entries
+	ATTITUDE = 6,	///< Attitude and commands
+	CONTROL = 7,	///< PID terms and motor speeds
+	ALTITUDE = 8,	///< Height
+	BATTERY = 9,	///< Battery state
+	TIMING = 10,	///< Control loop timing
+	ERRORS = 11,	///< Error and drop counters
+	TUNE = 12,		///< Autotuner state and result
+	I2C_BUS = 13	///< Per-bus i2c counters and utilization
+};
+
+int16_t telemetryFixed(float x, float scale);
+uint16_t telemetryGetU16(const uint8_t *p);
+int16_t telemetryGetS16(const uint8_t *p);
+
+/**
+ * @brief Builds one telemetry frame
+ *
+ * Fields are appended in order. Fields that don't fit in TELEM_MAX_PAYLOAD
+ * are dropped and the frame is marked as overflowed.
+ */
+class TelemetryFrame {
+private:
+	uint8_t raw[TELEM_MAX_RAW];		///< id, seq, payload
+	uint16_t len;					///< Bytes used in raw
+	bool overflow;					///< A field didn't fit
+
+	bool reserve(uint16_t n);
+
+public:
+	TelemetryFrame(TelemetryId id, uint8_t seq);
+
+	void putU8(uint8_t x);
+	void putU16(uint16_t x);
+	void putS16(int16_t x);
+	void putU32(uint32_t x);
+	void putFixed(float x, float scale);
+
+	bool overflowed(void);
+	uint16_t encode(uint8_t *out);
+};
+
+/**
+ * @brief Byte-at-a-time telemetry frame decoder
+ *
+ * Collects bytes up to each 0x00 delimiter, COBS decodes and CRC checks the
+ * frame. Bad or oversized frames are counted and discarded.
+ */
+class TelemetryDecoder {
+private:
+	uint8_t buff[TELEM_MAX_FRAME];	///< Encoded bytes since the last delimiter
+	uint16_t len;					///< Bytes in buff
+	bool overrun;					///< Frame longer than buff, skip to delimiter
+	uint8_t frame[TELEM_MAX_FRAME];	///< Last good decoded frame
+	uint16_t frameLen;				///< Bytes in frame, including id and seq
+
+	uint32_t crcErrors;				///< Frames dropped by CRC or framing
+	uint32_t lost;					///< Frames missed, from sequence gaps
+	bool haveSeq;					///< A frame has been received
+	uint8_t lastSeq;				///< Sequence number of the last frame
+
+public:
+	TelemetryDecoder();
+
+	bool feed(uint8_t b);
+
+	TelemetryId getId(void);
+	uint8_t getSeq(void);
+	const uint8_t *getPayload(void);
+	uint16_t getLength(void);
+
+	uint32_t getCrcErrors(void);
+	uint32_t getLost(void);
+};
+
+/**
+ * @brief Sends telemetry frames without blocking
+ *
+ * send() encodes a frame straight into the UART TX queue (usart_tx_reserve())
+ * and returns; frames are dropped (and counted) when the queue is full.
+ */
+class Telemetry {
+private:
+	static Telemetry *telemInstance;	///< Singleton instance
+
+	uint8_t seq;						///< Next sequence number
+	uint32_t dropped;					///< Frames dropped on a full queue
+
+	Telemetry();
+
+public:
+	static Telemetry *Instance(void);
+
+	uint8_t nextSeq(void);
+	bool send(TelemetryFrame &frame);
+
+	uint32_t getDropped(void);
+};
+
+#endif
+
+/** @} Close TELEMETRY group */
+/** @} Close System group */
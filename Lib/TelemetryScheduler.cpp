@@ -0,0 +1,204 @@
+/**
+ * @file
+ *
+ * @brief Shares the telemetry link between channels by priority and rate
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup TELEM_SCHED
+ *  @{
+ */
+
+#include "TelemetryScheduler.h"
+
+/**
+ * @brief Create a scheduler with no channels
+ * @param bytesPerSecond Link capacity [bytes/s]
+ * @param latency        Most telemetry to keep queued [s]. Longer uses the
+ * 						 link better, shorter keeps the data fresher.
+ */
+TelemetryScheduler::TelemetryScheduler(float bytesPerSecond, float latency) {
+	float w = bytesPerSecond * latency;
+
+	window = (w > 65535.0f) ? 65535 : (uint16_t)w;
+	budget = 0;
+	count = 0;
+
+	for (uint8_t i = 0; i < TELEM_MAX_CHANNELS; i++) {
+		due[i] = 0.0f;
+		sentCount[i] = 0;
+		skipped[i] = 0;
+		starved[i] = 0;
+	}
+}
+
+/**
+ * @brief Add a channel
+ * @param c Channel description
+ * @return Channel number, -1 if there is no room or the frame can never fit
+ * 		   the window
+ *
+ * A new channel is due straight away.
+ */
+int8_t TelemetryScheduler::add(const TelemetryChannel &c) {
+	if (count >= TELEM_MAX_CHANNELS || c.size > window) {
+		return -1;
+	}
+
+	channels[count] = c;
+	due[count] = 1.0f;
+
+	return (int8_t)count++;
+}
+
+/**
+ * @brief Change a channel's target rate
+ * @param ch   Channel number
+ * @param rate Target rate [Hz], 0 to stop the channel
+ */
+void TelemetryScheduler::setRate(uint8_t ch, float rate) {
+	if (ch < count) {
+		channels[ch].rate = rate;
+	}
+}
+
+/**
+ * @brief Start a new loop
+ * @param dt      Time since the last tick [s]
+ * @param backlog Bytes still queued for the link (usart_tx_pending())
+ */
+void TelemetryScheduler::tick(float dt, uint16_t backlog) {
+	for (uint8_t i = 0; i < count; i++) {
+		due[i] += channels[i].rate * dt;
+
+		// A whole frame behind: skip it rather than send a burst later
+		while (due[i] >= 2.0f) {
+			due[i] -= 1.0f;
+			skipped[i]++;
+			if (starved[i] < 0xFF) {
+				starved[i]++;
+			}
+		}
+	}
+
+	budget = (backlog < window) ? (uint16_t)(window - backlog) : 0;
+}
+
+/**
+ * @brief Pick the next channel to send
+ * @return Channel number, -1 if nothing is due or the link is full
+ *
+ * Starved channels (TELEM_STARVE_SKIPS) go first, then the most important
+ * due channel; among equals, the one furthest behind. If the pick doesn't fit
+ * in what is left of the budget, nothing is sent until a later tick, so a
+ * large frame can't be starved by small ones.
+ */
+int8_t TelemetryScheduler::next(void) {
+	int8_t best = -1;
+
+	for (uint8_t i = 0; i < count; i++) {
+		if (due[i] < 1.0f) {
+			continue;
+		}
+		if (best < 0) {
+			best = (int8_t)i;
+			continue;
+		}
+
+		bool starving = starved[i] >= TELEM_STARVE_SKIPS;
+		bool bestStarving = starved[best] >= TELEM_STARVE_SKIPS;
+
+		if (starving != bestStarving) {
+			if (starving) {
+				best = (int8_t)i;
+			}
+		} else if (channels[i].priority < channels[best].priority ||
+				(channels[i].priority == channels[best].priority && due[i] > due[best])) {
+			best = (int8_t)i;
+		}
+	}
+
+	if (best < 0 || channels[best].size > budget) {
+		return -1;
+	}
+
+	return best;
+}
+
+/**
+ * @brief Account for a frame handed to the link
+ * @param ch Channel number returned by next()
+ *
+ * Charges the channel's full frame size, the next tick's measured backlog
+ * corrects for frames that came out shorter.
+ */
+void TelemetryScheduler::sent(uint8_t ch) {
+	if (ch >= count) {
+		return;
+	}
+
+	due[ch] -= 1.0f;
+	sentCount[ch]++;
+	starved[ch] = 0;
+	budget = (channels[ch].size < budget) ? (uint16_t)(budget - channels[ch].size) : 0;
+}
+
+/**
+ * @brief Get the frame a channel sends
+ * @param ch Channel number
+ * @return Telemetry id
+ */
+TelemetryId TelemetryScheduler::getId(uint8_t ch) {
+	return channels[ch].id;
+}
+
+/**
+ * @brief Get the number of frames a channel has sent
+ * @param ch Channel number
+ * @return Frames sent
+ */
+uint32_t TelemetryScheduler::getSent(uint8_t ch) {
+	return (ch < count) ? sentCount[ch] : 0;
+}
+
+/**
+ * @brief Get the number of frames a channel skipped for lack of bandwidth
+ * @param ch Channel number
+ * @return Frames skipped
+ */
+uint32_t TelemetryScheduler::getSkipped(uint8_t ch) {
+	return (ch < count) ? skipped[ch] : 0;
+}
+
+/**
+ * @brief Get the number of frames skipped by all channels
+ * @return Frames skipped
+ */
+uint32_t TelemetryScheduler::getSkippedTotal(void) {
+	uint32_t total = 0;
+
+	for (uint8_t i = 0; i < count; i++) {
+		total += skipped[i];
+	}
+
+	return total;
+}
+
+/**
+ * @brief Get the most bytes the scheduler keeps queued
+ * @return Window [bytes]
+ */
+uint16_t TelemetryScheduler::getWindow(void) {
+	return window;
+}
+
+/** @} Close TELEM_SCHED group */
+/** @} Close System group */
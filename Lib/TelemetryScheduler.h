@@ -0,0 +1,101 @@
+/**
+ * @file
+ *
+ * @brief Shares the telemetry link between channels by priority and rate
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Each channel is one kind of frame with a priority and a target rate. Every
+ * loop, tick() accrues what each channel is owed and works out how many
+ * bytes the link can take: the link should never hold more than a
+ * `latency` worth of bytes, and the bytes still queued in the UART (measured,
+ * so it covers replies and traces sent outside the scheduler) come off that.
+ * next() then hands out channels, most important first, until the budget is
+ * spent.
+ *
+ * When the link can't keep up the least important channels lose rate first;
+ * a channel that falls a whole frame behind skips it instead of bursting to
+ * catch up. After TELEM_STARVE_SKIPS skips in a row a channel goes next
+ * regardless of priority, so on a poor link every channel still trickles
+ * through at 1/(TELEM_STARVE_SKIPS + 1) of its rate, as long as the link can
+ * carry that much. Nothing ever waits for the UART.
+ *
+ * Does not touch hardware, so the packing can be run against a simulated
+ * link on a host.
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @defgroup TELEM_SCHED Telemetry scheduler
+ *  @brief Prioritised, rate-limited telemetry channels
+ *  @{
+ */
+
+#ifndef TELEMETRYSCHEDULER_H_
+#define TELEMETRYSCHEDULER_H_
+
+#include <stdint.h>
+#include "Telemetry.h"
+
+#define TELEM_MAX_CHANNELS	8		///< Channels per scheduler
+#define TELEM_STARVE_SKIPS	4		///< Frames skipped in a row before a channel jumps the queue
+
+/**
+ * @brief Description of one telemetry channel
+ */
+typedef struct {
+	TelemetryId id;		///< Frame the channel sends
+	uint8_t priority;	///< 0 is the most important
+	float rate;			///< Target rate [Hz]
+	uint16_t size;		///< Largest encoded frame [bytes], see TELEM_FRAME_BYTES()
+} TelemetryChannel;
+
+/**
+ * @brief Telemetry bandwidth scheduler
+ *
+ * Usage, once per loop:
+ *
+ * 		sched.tick(dt, usart_tx_pending());
+ * 		while ((ch = sched.next()) >= 0) {
+ * 			// build and send the frame for sched.getId(ch)
+ * 			sched.sent(ch);
+ * 		}
+ */
+class TelemetryScheduler {
+private:
+	TelemetryChannel channels[TELEM_MAX_CHANNELS];	///< Channel descriptions
+	float due[TELEM_MAX_CHANNELS];				///< Frames owed to each channel
+	uint32_t sentCount[TELEM_MAX_CHANNELS];		///< Frames sent per channel
+	uint32_t skipped[TELEM_MAX_CHANNELS];		///< Frames skipped per channel
+	uint8_t starved[TELEM_MAX_CHANNELS];		///< Frames skipped since the last one sent
+	uint8_t count;								///< Channels added
+
+	uint16_t window;							///< Most bytes to keep queued
+	uint16_t budget;							///< Bytes that may still be queued this tick
+
+public:
+	TelemetryScheduler(float bytesPerSecond, float latency);
+
+	int8_t add(const TelemetryChannel &c);
+	void setRate(uint8_t ch, float rate);
+
+	void tick(float dt, uint16_t backlog);
+	int8_t next(void);
+	void sent(uint8_t ch);
+
+	TelemetryId getId(uint8_t ch);
+	uint32_t getSent(uint8_t ch);
+	uint32_t getSkipped(uint8_t ch);
+	uint32_t getSkippedTotal(void);
+	uint16_t getWindow(void);
+};
+
+#endif
+
+/** @} Close TELEM_SCHED group */
+/** @} Close System group */
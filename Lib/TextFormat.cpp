@@ -0,0 +1,488 @@
+/**
+ * @file
+ *
+ * @brief Small number formatter and snprintf subset for text output
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @defgroup TEXTFORMAT Text formatting
+ *  @brief Heap-free, bounded-time number formatting
+ *  @{
+ */
+
+#include "TextFormat.h"
+#include <string.h>
+
+/**
+ * Powers of ten for the fraction digits
+ */
+static const uint32_t pow10[FMT_MAX_DECIMALS + 1] = {
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+/**
+ * @brief Write an unsigned 64-bit integer in decimal
+ * @param out Output, at least 20 characters. Not terminated.
+ * @param v   Value
+ * @return Number of characters written
+ *
+ * Only used for float integer parts of 2^32 and above; everything else takes
+ * the 32-bit path, which needs no library division.
+ */
+static uint8_t fmtUint64(char *out, uint64_t v) {
+	char tmp[20];
+	uint8_t n = 0;
+
+	if (v <= 0xFFFFFFFFu) {
+		return fmtUint(out, (uint32_t)v);
+	}
+
+	while (v != 0) {
+		tmp[n++] = (char)('0' + v % 10);
+		v /= 10;
+	}
+	for (uint8_t i = 0; i < n; i++) {
+		out[i] = tmp[n - 1 - i];
+	}
+
+	return n;
+}
+
+/**
+ * @brief Write an unsigned integer in decimal
+ * @param out Output, at least 10 characters. Not terminated.
+ * @param v   Value
+ * @return Number of characters written
+ */
+uint8_t fmtUint(char *out, uint32_t v) {
+	char tmp[10];
+	uint8_t n = 0;
+
+	do {
+		tmp[n++] = (char)('0' + v % 10);
+		v /= 10;
+	} while (v != 0);
+
+	for (uint8_t i = 0; i < n; i++) {
+		out[i] = tmp[n - 1 - i];
+	}
+
+	return n;
+}
+
+/**
+ * @brief Write a signed integer in decimal
+ * @param out Output, at least FMT_INT_MAX characters. Not terminated.
+ * @param v   Value
+ * @return Number of characters written
+ */
+uint8_t fmtInt(char *out, int32_t v) {
+	if (v < 0) {
+		out[0] = '-';
+		return 1 + fmtUint(out + 1, 0u - (uint32_t)v);
+	}
+
+	return fmtUint(out, (uint32_t)v);
+}
+
+/**
+ * @brief Write an unsigned integer in hexadecimal, without a prefix
+ * @param out   Output, at least 8 characters. Not terminated.
+ * @param v     Value
+ * @param upper Use A-F rather than a-f
+ * @return Number of characters written
+ */
+uint8_t fmtHex(char *out, uint32_t v, bool upper) {
+	const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+	uint8_t n = 1;
+
+	while (n < 8 && (v >> (4 * n)) != 0) {
+		n++;
+	}
+	for (uint8_t i = 0; i < n; i++) {
+		out[i] = digits[(v >> (4 * (n - 1 - i))) & 0xF];
+	}
+
+	return n;
+}
+
+/**
+ * @brief Write a float in fixed-point notation, like printf's %.<decimals>f
+ * @param out      Output, at least FMT_FLOAT_MAX characters. Not terminated.
+ * @param v        Value
+ * @param decimals Digits after the point, at most FMT_MAX_DECIMALS
+ * @return Number of characters written
+ *
+ * The float is m * 2^e exactly, so the digits come from integer arithmetic
+ * on m and round half to even, as glibc and newlib do. Magnitudes of 2^64
+ * (1.8e19) and above don't fit and are written as "ovf".
+ */
+uint8_t fmtFloat(char *out, float v, uint8_t decimals) {
+	uint32_t bits;
+	memcpy(&bits, &v, sizeof(bits));
+
+	uint32_t man = bits & 0x7FFFFF;
+	int16_t exp = (int16_t)((bits >> 23) & 0xFF);
+	uint8_t n = 0;
+
+	if (decimals > FMT_MAX_DECIMALS) {
+		decimals = FMT_MAX_DECIMALS;
+	}
+
+	if (bits >> 31) {
+		out[n++] = '-';
+	}
+
+	// Infinity and NaN
+	if (exp == 0xFF) {
+		memcpy(&out[n], (man != 0) ? "nan" : "inf", 3);
+		return n + 3;
+	}
+
+	// value = man * 2^exp
+	if (exp == 0) {
+		exp = 1;
+	} else {
+		man |= 0x800000;
+	}
+	exp -= 150;
+
+	uint64_t whole;
+	uint32_t frac = 0;
+
+	if (exp >= 0) {
+		if (exp > 40) {
+			memcpy(&out[n], "ovf", 3);
+			return n + 3;
+		}
+		whole = (uint64_t)man << exp;
+	} else {
+		// Split into integer part and fraction bits, then scale the fraction
+		// by 10^decimals. man < 2^24, so the product stays below 2^54.
+		uint8_t s = (uint8_t)-exp;
+		uint64_t fbits = (s < 32) ? (man & ((1u << s) - 1)) : man;
+		uint64_t x = fbits * pow10[decimals];
+		uint64_t q = 0;
+		bool up = false;
+
+		whole = (s < 32) ? (man >> s) : 0;
+
+		if (s < 64) {
+			uint64_t rem = x & ((1ull << s) - 1);
+			uint64_t half = 1ull << (s - 1);
+
+			q = x >> s;
+			if (rem > half) {
+				up = true;
+			} else if (rem == half) {
+				up = (((decimals > 0) ? q : whole) & 1) != 0;
+			}
+		}
+
+		if (up) {
+			q++;
+			if (q >= pow10[decimals]) {
+				q -= pow10[decimals];
+				whole++;
+			}
+		}
+		frac = (uint32_t)q;
+	}
+
+	n += fmtUint64(&out[n], whole);
+
+	if (decimals > 0) {
+		out[n++] = '.';
+		for (uint8_t i = decimals; i > 0; i--) {
+			out[n + i - 1] = (char)('0' + frac % 10);
+			frac /= 10;
+		}
+		n += decimals;
+	}
+
+	return n;
+}
+
+/**
+ * @brief Output buffer of the formatter. Characters past the end are
+ * counted but dropped.
+ */
+typedef struct {
+	char *buf;			///< Output
+	uint16_t size;		///< Size of buf, including the terminator
+	uint16_t len;		///< Characters written so far
+} TextOut;
+
+static void textPut(TextOut *o, char c) {
+	if (o->len + 1 < o->size) {
+		o->buf[o->len] = c;
+	}
+	o->len++;
+}
+
+static void textPad(TextOut *o, char c, int16_t count) {
+	while (count-- > 0) {
+		textPut(o, c);
+	}
+}
+
+/**
+ * @brief Write one converted field with its sign and padding
+ * @param o      Output
+ * @param sign   Sign character, or 0
+ * @param body   Digits or text
+ * @param n      Length of body
+ * @param width  Minimum field width
+ * @param left   Pad on the right
+ * @param zero   Pad with zeros after the sign
+ */
+static void textField(TextOut *o, char sign, const char *body, uint16_t n, uint16_t width, bool left, bool zero) {
+	int16_t pad = (int16_t)width - (int16_t)n - (sign ? 1 : 0);
+
+	if (!left && !zero) {
+		textPad(o, ' ', pad);
+	}
+	if (sign) {
+		textPut(o, sign);
+	}
+	if (!left && zero) {
+		textPad(o, '0', pad);
+	}
+	for (uint16_t i = 0; i < n; i++) {
+		textPut(o, body[i]);
+	}
+	if (left) {
+		textPad(o, ' ', pad);
+	}
+}
+
+/**
+ * @brief Apply an integer precision to converted digits
+ * @param digits Digits, room for FMT_FLOAT_MAX characters
+ * @param n      Number of digits
+ * @param prec   Minimum number of digits, -1 for none
+ * @return New number of digits
+ *
+ * Pads with leading zeros, as printf does. A precision of 0 writes no digits
+ * for a zero value.
+ */
+static uint8_t textIntPrecision(char *digits, uint8_t n, int16_t prec) {
+	if (prec < 0) {
+		return n;
+	}
+	if (prec == 0 && n == 1 && digits[0] == '0') {
+		return 0;
+	}
+	if (prec > FMT_FLOAT_MAX) {
+		prec = FMT_FLOAT_MAX;
+	}
+	if (prec > n) {
+		uint8_t shift = (uint8_t)prec - n;
+		memmove(&digits[shift], digits, n);
+		memset(digits, '0', shift);
+		n = (uint8_t)prec;
+	}
+
+	return n;
+}
+
+/**
+ * @brief Format into a buffer, like snprintf
+ * @param buf  Output, always terminated when size > 0
+ * @param size Size of buf
+ * @param fmt  Format
+ * @return Length of the full output, which was cut short if it is size or
+ * 		   more
+ *
+ * Supports %d %i %u %x %X %f %F %c %s %%, the flags - 0 + and space, and
+ * width and precision (either may be *). h, l and z are accepted and
+ * ignored: every integer is 32 bits. Precision sets the minimum number of
+ * integer digits (at most FMT_FLOAT_MAX; like printf it turns off the 0
+ * flag), %f's decimals (6 by default, at most FMT_MAX_DECIMALS) and %s's
+ * maximum length. Anything else is copied through unconverted.
+ */
+uint16_t textFormat(char *buf, uint16_t size, const char *fmt, ...) {
+	va_list ap;
+
+	va_start(ap, fmt);
+	uint16_t len = textFormatV(buf, size, fmt, ap);
+	va_end(ap);
+
+	return len;
+}
+
+/**
+ * @brief Format into a buffer, like vsnprintf
+ * @see textFormat()
+ */
+uint16_t textFormatV(char *buf, uint16_t size, const char *fmt, va_list ap) {
+	TextOut o = { buf, size, 0 };
+	char tmp[FMT_FLOAT_MAX];
+
+	while (*fmt) {
+		if (*fmt != '%') {
+			textPut(&o, *fmt++);
+			continue;
+		}
+
+		const char *start = fmt++;
+		bool left = false, zero = false, isLong = false;
+		char plus = 0;
+		uint16_t width = 0;
+		int16_t prec = -1;
+
+		// Flags
+		for (;; fmt++) {
+			if (*fmt == '-') {
+				left = true;
+			} else if (*fmt == '0') {
+				zero = true;
+			} else if (*fmt == '+') {
+				plus = '+';
+			} else if (*fmt == ' ') {
+				if (plus == 0) {
+					plus = ' ';
+				}
+			} else {
+				break;
+			}
+		}
+
+		// Width and precision
+		if (*fmt == '*') {
+			int w = va_arg(ap, int);
+			if (w < 0) {
+				left = true;
+				w = -w;
+			}
+			width = (uint16_t)w;
+			fmt++;
+		} else {
+			while (*fmt >= '0' && *fmt <= '9') {
+				width = (uint16_t)(width * 10 + (*fmt++ - '0'));
+			}
+		}
+		if (*fmt == '.') {
+			fmt++;
+			prec = 0;
+			if (*fmt == '*') {
+				int p = va_arg(ap, int);
+				prec = (p < 0) ? -1 : (int16_t)p;
+				fmt++;
+			} else {
+				while (*fmt >= '0' && *fmt <= '9') {
+					prec = (int16_t)(prec * 10 + (*fmt++ - '0'));
+				}
+			}
+		}
+
+		// Length modifiers
+		while (*fmt == 'h' || *fmt == 'l' || *fmt == 'z') {
+			if (*fmt == 'l') {
+				isLong = true;
+			}
+			fmt++;
+		}
+
+		char conv = *fmt;
+		char sign = 0;
+		uint8_t n;
+
+		switch (conv) {
+		case 'd':
+		case 'i': {
+			int32_t v = isLong ? (int32_t)va_arg(ap, long) : (int32_t)va_arg(ap, int);
+			if (v < 0) {
+				sign = '-';
+				n = fmtUint(tmp, 0u - (uint32_t)v);
+			} else {
+				sign = plus;
+				n = fmtUint(tmp, (uint32_t)v);
+			}
+			n = textIntPrecision(tmp, n, prec);
+			textField(&o, sign, tmp, n, width, left, zero && prec < 0);
+			break;
+		}
+		case 'u':
+		case 'x':
+		case 'X': {
+			uint32_t v = isLong ? (uint32_t)va_arg(ap, unsigned long) : (uint32_t)va_arg(ap, unsigned int);
+			n = (conv == 'u') ? fmtUint(tmp, v) : fmtHex(tmp, v, conv == 'X');
+			n = textIntPrecision(tmp, n, prec);
+			textField(&o, 0, tmp, n, width, left, zero && prec < 0);
+			break;
+		}
+		case 'f':
+		case 'F': {
+			float v = (float)va_arg(ap, double);
+			n = fmtFloat(tmp, v, (prec < 0) ? 6 : (uint8_t)((prec > FMT_MAX_DECIMALS) ? FMT_MAX_DECIMALS : prec));
+			const char *body = tmp;
+			if (tmp[0] == '-') {
+				sign = '-';
+				body++;
+				n--;
+			} else {
+				sign = plus;
+			}
+			// No zero padding in front of inf or nan
+			bool number = body[0] >= '0' && body[0] <= '9';
+			if (conv == 'F') {
+				for (uint8_t i = 0; i < n; i++) {
+					if (body[i] >= 'a' && body[i] <= 'z') {
+						tmp[body - tmp + i] = (char)(body[i] - 'a' + 'A');
+					}
+				}
+			}
+			textField(&o, sign, body, n, width, left, zero && number);
+			break;
+		}
+		case 'c':
+			tmp[0] = (char)va_arg(ap, int);
+			textField(&o, 0, tmp, 1, width, left, false);
+			break;
+		case 's': {
+			const char *s = va_arg(ap, const char *);
+			uint16_t len = 0;
+			if (s == NULL) {
+				s = "(null)";
+			}
+			while (s[len] && (prec < 0 || len < (uint16_t)prec)) {
+				len++;
+			}
+			textField(&o, 0, s, len, width, left, false);
+			break;
+		}
+		case '%':
+			textPut(&o, '%');
+			break;
+		default:
+			// Unknown conversion: copy it through and carry on
+			while (start < fmt) {
+				textPut(&o, *start++);
+			}
+			if (*fmt == 0) {
+				continue;
+			}
+			textPut(&o, *fmt);
+			break;
+		}
+		fmt++;
+	}
+
+	if (size > 0) {
+		buf[(o.len < size) ? o.len : size - 1] = 0;
+	}
+
+	return o.len;
+}
+
+/** @} Close TEXTFORMAT group */
+/** @} Close System group */
@@ -0,0 +1,47 @@
+/**
+ * @file
+ *
+ * @brief Small number formatter and snprintf subset for text output
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Replaces newlib's printf family for text telemetry and messages. Float
+ * conversion works on the bits of the float with 64-bit integer arithmetic,
+ * so it is exact, takes a bounded number of steps, uses no heap and keeps
+ * all state on the caller's stack (reentrant, interrupt safe). Output
+ * matches C's printf except where noted on textFormat().
+ *
+ */
+
+/** @addtogroup System
+ *  @{
+ */
+
+/** @addtogroup TEXTFORMAT
+ *  @{
+ */
+
+#ifndef TEXTFORMAT_H_
+#define TEXTFORMAT_H_
+
+#include <stdint.h>
+#include <stdarg.h>
+
+#define FMT_MAX_DECIMALS	9		///< Most digits after the point
+#define FMT_FLOAT_MAX		32		///< Longest fmtFloat() output: sign, 20 digits, point, 9 decimals
+#define FMT_INT_MAX			11		///< Longest fmtInt() output
+
+uint8_t fmtUint(char *out, uint32_t v);
+uint8_t fmtInt(char *out, int32_t v);
+uint8_t fmtHex(char *out, uint32_t v, bool upper);
+uint8_t fmtFloat(char *out, float v, uint8_t decimals);
+
+uint16_t textFormat(char *buf, uint16_t size, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+uint16_t textFormatV(char *buf, uint16_t size, const char *fmt, va_list ap);
+
+#endif
+
+/** @} Close TEXTFORMAT group */
+/** @} Close System group */
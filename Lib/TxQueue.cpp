@@ -0,0 +1,202 @@
+/**
+ * @file
+ *
+ * @brief Byte ring of queued UART TX frames
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Peripherals
+ *  @{
+ */
+
+/** @addtogroup UART
+ *  @{
+ */
+
+#include <string.h>
+
+#include "TxQueue.h"
+
+#define FRAME_MASK (UART_TX_MAX_FRAMES - 1)
+
+/** @defgroup TxQueue_Class TxQueue class
+ *  @brief Owned TX buffer memory for the UART DMA
+ *  @{
+ */
+
+/**
+ * @brief Construct an empty TxQueue
+ */
+TxQueue::TxQueue() {
+	head = tail = 0;
+	taken = 0;
+	wr = 0;
+	reserved = -1;
+	reservedLen = 0;
+	dropped = 0;
+}
+
+/**
+ * @brief Find room for a contiguous frame
+ * @param n Frame size
+ * @return Offset in ring, -1 if there is no room
+ *
+ * While frames are queued the used bytes run from the oldest frame's offset
+ * rd up to wr, wrapping once. If wr > rd there is room after wr and before
+ * rd (at offset 0); if wr <= rd the ring has wrapped and the only room is
+ * between wr and rd.
+ */
+int32_t TxQueue::alloc(uint16_t n) {
+	uint8_t t = tail;
+
+	if (n == 0 || n > UART_TX_RING_SIZE) return -1;
+	if ((uint8_t)(head - t) >= UART_TX_MAX_FRAMES) return -1;
+
+	if (head == t) {
+		// Nothing queued - start over at the beginning
+		wr = 0;
+		return 0;
+	}
+
+	uint16_t rd = start[t & FRAME_MASK];
+	if (wr > rd) {
+		if (wr + n <= UART_TX_RING_SIZE) return wr;
+		if (n <= rd) return 0;
+	} else if (wr + n <= rd) {
+		return wr;
+	}
+
+	return -1;
+}
+
+/**
+ * @brief Copy a frame into the queue
+ * @param data Frame bytes, free to reuse on return
+ * @param n    Frame size
+ * @return false if there was no room and the frame was dropped
+ */
+bool TxQueue::push(const uint8_t *data, uint16_t n) {
+	uint8_t *p = reserve(n);
+
+	if (p == NULL) return false;
+
+	memcpy(p, data, n);
+	commit(n);
+	return true;
+}
+
+/**
+ * @brief Reserve space to build a frame in place
+ * @param n Largest size the frame may have
+ * @return Where to write the frame, NULL if there is no room (counted as a
+ * 		   dropped frame)
+ *
+ * @note Must be followed by commit() before the next reserve() or push()
+ */
+uint8_t *TxQueue::reserve(uint16_t n) {
+	int32_t off = alloc(n);
+
+	if (off < 0) {
+		dropped++;
+		return NULL;
+	}
+
+	reserved = off;
+	reservedLen = n;
+	return &ring[off];
+}
+
+/**
+ * @brief Queue the frame written after reserve()
+ * @param n Bytes actually written, at most the reserved size. 0 abandons the
+ * 			reservation
+ */
+void TxQueue::commit(uint16_t n) {
+	if (reserved < 0) return;
+
+	if (n > reservedLen) n = reservedLen;
+	if (n > 0) {
+		start[head & FRAME_MASK] = (uint16_t)reserved;
+		len[head & FRAME_MASK] = n;
+		wr = (uint16_t)reserved + n;
+		head = head + 1;		// Publish last
+	}
+
+	reserved = -1;
+}
+
+/**
+ * @brief Take the oldest queued frames for one transfer
+ * @param n Returns the transfer size
+ * @return Start of the transfer, NULL if nothing is queued
+ *
+ * Frames that follow each other in the ring are merged, so back-to-back
+ * frames go out in a single transfer. They stay queued until release().
+ */
+const uint8_t *TxQueue::take(uint16_t *n) {
+	uint8_t h = head;
+	uint8_t t = tail;
+
+	if (h == t) return NULL;
+
+	uint16_t off = start[t & FRAME_MASK];
+	uint16_t total = len[t & FRAME_MASK];
+	taken = 1;
+
+	for (uint8_t k = t + 1; k != h; k++) {
+		if (start[k & FRAME_MASK] != off + total) break;
+		total += len[k & FRAME_MASK];
+		taken++;
+	}
+
+	*n = total;
+	return &ring[off];
+}
+
+/**
+ * @brief Free the frames of the last take() once they have been sent
+ */
+void TxQueue::release(void) {
+	tail = tail + taken;
+	taken = 0;
+}
+
+/**
+ * @brief  Check for queued frames
+ * @return true if nothing is queued or being sent
+ */
+bool TxQueue::empty(void) {
+	return head == tail;
+}
+
+/**
+ * @brief  Get the number of bytes waiting to be sent
+ * @return Bytes in queued frames, including the transfer in progress
+ */
+uint16_t TxQueue::pending(void) {
+	uint8_t h = head;
+	uint16_t bytes = 0;
+
+	for (uint8_t t = tail; t != h; t++) {
+		bytes += len[t & FRAME_MASK];
+	}
+
+	return bytes;
+}
+
+/**
+ * @brief  Get the number of frames refused for lack of room
+ * @return Dropped frame count
+ */
+uint32_t TxQueue::getDropped(void) {
+	return dropped;
+}
+
+/** @} Close TxQueue_Class group */
+
+/** @} Close UART group */
+/** @} Close Peripherals Group */
@@ -0,0 +1,76 @@
+/**
+ * @file
+ *
+ * @brief Byte ring of queued UART TX frames
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Peripherals
+ *  @{
+ */
+
+/** @addtogroup UART
+ *  @{
+ */
+
+#ifndef TXQUEUE_H_
+#define TXQUEUE_H_
+
+#include <stdint.h>
+
+#define UART_TX_RING_SIZE	2048	///< Bytes of queued TX data
+#define UART_TX_MAX_FRAMES	32		///< Queued frames (power of 2)
+
+/**
+ * @brief Queue of TX frames stored contiguously in an owned byte ring
+ *
+ * The producer (main loop) either copies a frame in with push(), or writes
+ * it in place between reserve() and commit(). The consumer (DMA side) takes
+ * the oldest frames with take() and frees them with release() once sent.
+ * take() merges frames that sit back to back in the ring into one transfer.
+ *
+ * Every frame is contiguous, so a frame that doesn't fit before the end of
+ * the ring starts again at offset 0. One producer and one consumer may run
+ * concurrently (main loop and interrupt). There must be only one producer:
+ * push(), reserve() and commit() are not reentrant, so code that can
+ * interrupt the main loop must not call them. Does not touch hardware.
+ */
+class TxQueue {
+private:
+	uint8_t ring[UART_TX_RING_SIZE];		///< Frame bytes
+	volatile uint16_t start[UART_TX_MAX_FRAMES];	///< Frame offsets in ring
+	volatile uint16_t len[UART_TX_MAX_FRAMES];		///< Frame lengths
+	volatile uint8_t head;					///< Frames committed (free-running)
+	volatile uint8_t tail;					///< Frames released (free-running)
+	uint8_t taken;							///< Frames in the current transfer
+	uint16_t wr;							///< Write offset after the newest frame
+	int32_t reserved;						///< Offset of the open reservation, -1 if none
+	uint16_t reservedLen;					///< Size of the open reservation
+
+	uint32_t dropped;						///< Frames refused for lack of room
+
+	int32_t alloc(uint16_t n);
+
+public:
+	TxQueue();
+
+	bool push(const uint8_t *data, uint16_t n);
+	uint8_t *reserve(uint16_t n);
+	void commit(uint16_t n);
+
+	const uint8_t *take(uint16_t *n);
+	void release(void);
+
+	bool empty(void);
+	uint16_t pending(void);
+	uint32_t getDropped(void);
+};
+
+#endif
+
+/** @} Close UART group */
+/** @} Close Peripherals Group */
@@ -0,0 +1,437 @@
+/**
+ * @file
+ *
+ * @brief Remote control uplink protocol
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Peripherals
+ *  @{
+ */
+
+/** @addtogroup UART
+ *  @{
+ */
+
+#include <string.h>
+
+#include "Uplink.h"
+
+/** @defgroup Uplink_Functions Uplink message functions
+ *  @brief Packing, unpacking and framing uplink messages
+ *  @{
+ */
+
+/**
+ * @brief Start a message
+ * @param m   Message
+ * @param id  Message id
+ * @param seq Sequence number
+ */
+static void uplinkBegin(UplinkMsg *m, UplinkId id, uint8_t seq) {
+	m->id = id;
+	m->seq = seq;
+	m->len = 0;
+	m->time = 0;
+}
+
+/**
+ * @brief Append a uint16_t, little-endian
+ * @param m Message
+ * @param x Value
+ */
+static void uplinkPut16(UplinkMsg *m, uint16_t x) {
+	m->payload[m->len++] = (uint8_t)x;
+	m->payload[m->len++] = (uint8_t)(x >> 8);
+}
+
+/**
+ * @brief Append a uint32_t, little-endian
+ * @param m Message
+ * @param x Value
+ */
+static void uplinkPut32(UplinkMsg *m, uint32_t x) {
+	uplinkPut16(m, (uint16_t)x);
+	uplinkPut16(m, (uint16_t)(x >> 16));
+}
+
+/**
+ * @brief Read a little-endian uint16_t
+ * @param p First byte
+ * @return Value
+ */
+static uint16_t uplinkGet16(const uint8_t *p) {
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+ * @brief Read a little-endian uint32_t
+ * @param p First byte
+ * @return Value
+ */
+static uint32_t uplinkGet32(const uint8_t *p) {
+	return (uint32_t)uplinkGet16(p) | ((uint32_t)uplinkGet16(p + 2) << 16);
+}
+
+/**
+ * @brief Build a STICKS message
+ * @param m   Message
+ * @param seq Sequence number
+ * @param s   Stick positions
+ */
+void uplinkSticks(UplinkMsg *m, uint8_t seq, const UplinkSticks *s) {
+	uplinkBegin(m, UplinkId::STICKS, seq);
+	uplinkPut16(m, s->throttle);
+	uplinkPut16(m, (uint16_t)s->pitch);
+	uplinkPut16(m, (uint16_t)s->roll);
+	uplinkPut16(m, (uint16_t)s->yaw);
+}
+
+/**
+ * @brief Build a MODE message
+ * @param m    Message
+ * @param seq  Sequence number
+ * @param mode Requested mode
+ */
+void uplinkMode(UplinkMsg *m, uint8_t seq, UplinkMode mode) {
+	uplinkBegin(m, UplinkId::MODE, seq);
+	m->payload[m->len++] = (uint8_t)mode;
+}
+
+/**
+ * @brief Build an ARM message
+ * @param m     Message
+ * @param seq   Sequence number
+ * @param armed true to arm, false to disarm
+ */
+void uplinkArm(UplinkMsg *m, uint8_t seq, bool armed) {
+	uplinkBegin(m, UplinkId::ARM, seq);
+	m->payload[m->len++] = armed ? 1 : 0;
+}
+
+/**
+ * @brief Build a PARAM_GET message
+ * @param m   Message
+ * @param seq Sequence number
+ * @param id  Parameter id
+ */
+void uplinkParamGet(UplinkMsg *m, uint8_t seq, uint16_t id) {
+	uplinkBegin(m, UplinkId::PARAM_GET, seq);
+	uplinkPut16(m, id);
+}
+
+/**
+ * @brief Build a PARAM_SET message
+ * @param m     Message
+ * @param seq   Sequence number
+ * @param id    Parameter id
+ * @param value New value
+ */
+void uplinkParamSet(UplinkMsg *m, uint8_t seq, uint16_t id, float value) {
+	uint32_t bits;
+
+	memcpy(&bits, &value, sizeof(bits));
+	uplinkBegin(m, UplinkId::PARAM_SET, seq);
+	uplinkPut16(m, id);
+	uplinkPut32(m, bits);
+}
+
+/**
+ * @brief Build a HEARTBEAT message
+ * @param m    Message
+ * @param seq  Sequence number
+ * @param time Ground station time [ms]
+ */
+void uplinkHeartbeat(UplinkMsg *m, uint8_t seq, uint32_t time) {
+	uplinkBegin(m, UplinkId::HEARTBEAT, seq);
+	uplinkPut32(m, time);
+}
+
+/**
+ * @brief Build a LOG_ERASE message
+ * @param m   Message
+ * @param seq Sequence number
+ */
+void uplinkLogErase(UplinkMsg *m, uint8_t seq) {
+	uplinkBegin(m, UplinkId::LOG_ERASE, seq);
+}
+
+/**
+ * @brief Build an AUTOTUNE message
+ * @param m    Message
+ * @param seq  Sequence number
+ * @param axis Rate loop to tune, ControlAxis + 1, or 0 to stop
+ * @param rule TuneRule for the gains
+ */
+void uplinkAutotune(UplinkMsg *m, uint8_t seq, uint8_t axis, uint8_t rule) {
+	uplinkBegin(m, UplinkId::AUTOTUNE, seq);
+	m->payload[m->len++] = axis;
+	m->payload[m->len++] = rule;
+}
+
+/**
+ * @brief Read a STICKS message
+ * @param m Message
+ * @param s Returns the stick positions
+ * @return false if m is not a well-formed STICKS message
+ */
+bool uplinkGetSticks(const UplinkMsg *m, UplinkSticks *s) {
+	if (m->id != UplinkId::STICKS || m->len != 8) return false;
+
+	s->throttle = uplinkGet16(&m->payload[0]);
+	s->pitch = (int16_t)uplinkGet16(&m->payload[2]);
+	s->roll = (int16_t)uplinkGet16(&m->payload[4]);
+	s->yaw = (int16_t)uplinkGet16(&m->payload[6]);
+	return true;
+}
+
+/**
+ * @brief Read a MODE message
+ * @param m    Message
+ * @param mode Returns the requested mode
+ * @return false if m is not a well-formed MODE message
+ */
+bool uplinkGetMode(const UplinkMsg *m, UplinkMode *mode) {
+	if (m->id != UplinkId::MODE || m->len != 1) return false;
+
+	*mode = (UplinkMode)m->payload[0];
+	return true;
+}
+
+/**
+ * @brief Read an ARM message
+ * @param m     Message
+ * @param armed Returns the requested arming state
+ * @return false if m is not a well-formed ARM message
+ */
+bool uplinkGetArm(const UplinkMsg *m, bool *armed) {
+	if (m->id != UplinkId::ARM || m->len != 1) return false;
+
+	*armed = m->payload[0] != 0;
+	return true;
+}
+
+/**
+ * @brief Read a PARAM_GET message
+ * @param m  Message
+ * @param id Returns the parameter id
+ * @return false if m is not a well-formed PARAM_GET message
+ */
+bool uplinkGetParamGet(const UplinkMsg *m, uint16_t *id) {
+	if (m->id != UplinkId::PARAM_GET || m->len != 2) return false;
+
+	*id = uplinkGet16(&m->payload[0]);
+	return true;
+}
+
+/**
+ * @brief Read a PARAM_SET message
+ * @param m     Message
+ * @param id    Returns the parameter id
+ * @param value Returns the new value
+ * @return false if m is not a well-formed PARAM_SET message
+ */
+bool uplinkGetParamSet(const UplinkMsg *m, uint16_t *id, float *value) {
+	if (m->id != UplinkId::PARAM_SET || m->len != 6) return false;
+
+	uint32_t bits = uplinkGet32(&m->payload[2]);
+	*id = uplinkGet16(&m->payload[0]);
+	memcpy(value, &bits, sizeof(bits));
+	return true;
+}
+
+/**
+ * @brief Read a HEARTBEAT message
+ * @param m    Message
+ * @param time Returns the ground station time [ms]
+ * @return false if m is not a well-formed HEARTBEAT message
+ */
+bool uplinkGetHeartbeat(const UplinkMsg *m, uint32_t *time) {
+	if (m->id != UplinkId::HEARTBEAT || m->len != 4) return false;
+
+	*time = uplinkGet32(&m->payload[0]);
+	return true;
+}
+
+/**
+ * @brief Check for a LOG_ERASE message
+ * @param m Message
+ * @return false if m is not a well-formed LOG_ERASE message
+ */
+bool uplinkGetLogErase(const UplinkMsg *m) {
+	return m->id == UplinkId::LOG_ERASE && m->len == 0;
+}
+
+/**
+ * @brief Read an AUTOTUNE message
+ * @param m    Message
+ * @param axis Returns the rate loop to tune, ControlAxis + 1, or 0 to stop
+ * @param rule Returns the TuneRule
+ * @return false if m is not a well-formed AUTOTUNE message
+ */
+bool uplinkGetAutotune(const UplinkMsg *m, uint8_t *axis, uint8_t *rule) {
+	if (m->id != UplinkId::AUTOTUNE || m->len != 2) return false;
+
+	*axis = m->payload[0];
+	*rule = m->payload[1];
+	return true;
+}
+
+/**
+ * @brief Frame a message for sending
+ * @param m   Message
+ * @param out Encoded frame, at least UPLINK_MAX_FRAME long
+ * @return Number of bytes to send
+ */
+uint16_t uplinkEncode(const UplinkMsg *m, uint8_t *out) {
+	uint8_t raw[UPLINK_MAX_RAW];
+	uint8_t n = m->len > UPLINK_MAX_PAYLOAD ? UPLINK_MAX_PAYLOAD : m->len;
+
+	raw[0] = UPLINK_VERSION;
+	raw[1] = (uint8_t)m->id;
+	raw[2] = m->seq;
+	raw[3] = n;
+	memcpy(&raw[4], m->payload, n);
+
+	uint16_t crc = crc16Ccitt(raw, n + 4);
+	raw[n + 4] = (uint8_t)crc;
+	raw[n + 5] = (uint8_t)(crc >> 8);
+
+	uint16_t len = cobsEncode(raw, n + 6, out);
+	out[len++] = 0;
+
+	return len;
+}
+
+/**
+ * @brief Translate a packet from the original 6-byte remote protocol
+ * @param pkt   Legacy packet
+ * @param seq   Sequence counter for the generated messages
+ * @param armed Arming state of the legacy motor toggle
+ * @param out   Returns the messages, room for 2
+ * @return Number of messages generated
+ *
+ * FLY_CMD becomes MODE(FLY) followed by ARM, since the old remote had no
+ * arming step. DEMO_MOTOR_TOGGLE flips the arming state.
+ */
+uint8_t uplinkFromLegacy(const RcPacket *pkt, uint8_t *seq, bool *armed, UplinkMsg *out) {
+	uint8_t n = 0;
+
+	if (pkt->type == RcPacketType::STICKS) {
+		UplinkSticks s;
+		s.throttle = (uint16_t)((uint32_t)pkt->data[1] * 65535 / 253);
+		s.pitch = (int16_t)(((int32_t)pkt->data[2] - 127) * 32767 / 127);
+		s.roll = (int16_t)(((int32_t)pkt->data[3] - 127) * 32767 / 127);
+		s.yaw = (int16_t)(((int32_t)pkt->data[4] - 127) * 32767 / 127);
+		uplinkSticks(&out[n++], (*seq)++, &s);
+	} else if (pkt->data[0] == FLY_CMD) {
+		*armed = true;
+		uplinkMode(&out[n++], (*seq)++, UplinkMode::FLY);
+		uplinkArm(&out[n++], (*seq)++, true);
+	} else if (pkt->data[0] == DEMO_CMD) {
+		*armed = false;
+		uplinkMode(&out[n++], (*seq)++, UplinkMode::DEMO);
+	} else if (pkt->data[0] == DEMO_MOTOR_TOGGLE) {
+		*armed = !*armed;
+		uplinkArm(&out[n++], (*seq)++, *armed);
+	}
+
+	for (uint8_t i = 0; i < n; i++) {
+		out[i].time = pkt->time;
+	}
+
+	return n;
+}
+
+/** @} Close Uplink_Functions group */
+
+/** @defgroup Uplink_Class UplinkDecoder class
+ *  @brief Uplink frame decoding
+ *  @{
+ */
+
+/**
+ * @brief Construct an UplinkDecoder
+ */
+UplinkDecoder::UplinkDecoder() {
+	len = 0;
+	overrun = false;
+	stats.received = stats.lost = stats.errors = 0;
+	haveSeq = false;
+	lastSeq = 0;
+	uplinkBegin(&msg, UplinkId::HEARTBEAT, 0);
+}
+
+/**
+ * @brief Feed one received byte
+ * @param b    Received byte
+ * @param time Current time [ms]
+ * @return true when a good message has just completed, see getMsg()
+ */
+bool UplinkDecoder::feed(uint8_t b, uint32_t time) {
+	if (b != 0) {
+		if (len < UPLINK_MAX_FRAME) {
+			buff[len++] = b;
+		} else {
+			overrun = true;
+		}
+		return false;
+	}
+
+	// Delimiter - an empty frame is just back-to-back zeros
+	if (len == 0 && !overrun) {
+		return false;
+	}
+
+	uint8_t raw[UPLINK_MAX_FRAME];
+	uint16_t n = overrun ? 0 : cobsDecode(buff, len, raw);
+	len = 0;
+	overrun = false;
+
+	if (n < 6 || raw[0] != UPLINK_VERSION || raw[3] != n - 6 || raw[3] > UPLINK_MAX_PAYLOAD ||
+		crc16Ccitt(raw, n - 2) != uplinkGet16(&raw[n - 2]))
+	{
+		stats.errors++;
+		return false;
+	}
+
+	msg.id = (UplinkId)raw[1];
+	msg.seq = raw[2];
+	msg.len = raw[3];
+	memcpy(msg.payload, &raw[4], msg.len);
+	msg.time = time;
+
+	if (haveSeq) {
+		stats.lost += (uint8_t)(msg.seq - lastSeq - 1);
+	}
+	haveSeq = true;
+	lastSeq = msg.seq;
+	stats.received++;
+
+	return true;
+}
+
+/**
+ * @brief  Get the last good message
+ * @return Pointer to the message
+ */
+const UplinkMsg *UplinkDecoder::getMsg(void) {
+	return &msg;
+}
+
+/**
+ * @brief Get the receive counters
+ * @param s Returns the counters
+ */
+void UplinkDecoder::getStats(UplinkStats *s) {
+	*s = stats;
+}
+
+/** @} Close Uplink_Class group */
+
+/** @} Close UART group */
+/** @} Close Peripherals Group */
@@ -0,0 +1,147 @@
+/**
+ * @file
+ *
+ * @brief Remote control uplink protocol
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Every uplink message is sent as one frame:
+ * 		- [0]        Protocol version (UPLINK_VERSION)
+ * 		- [1]        Message id (UplinkId)
+ * 		- [2]        Sequence number, wraps at 255
+ * 		- [3]        Payload length n
+ * 		- [4..n+3]   Payload, little-endian
+ * 		- [n+4..n+5] CRC-16/CCITT of bytes 0..n+3, little-endian
+ *
+ * The frame is COBS encoded and terminated by a single 0x00, the same
+ * framing as the telemetry downlink (Framing.h). The firmware answers each
+ * HEARTBEAT with a TelemetryId::LINK frame, so the ground station gets the
+ * round-trip latency and the uplink loss counters. pi-station/parseDS4.py
+ * sends this protocol and prints both.
+ *
+ */
+
+/** @addtogroup Peripherals
+ *  @{
+ */
+
+/** @addtogroup UART
+ *  @{
+ */
+
+#ifndef UPLINK_H_
+#define UPLINK_H_
+
+#include <stdint.h>
+#include "Framing.h"
+#include "RcParser.h"
+
+#define UPLINK_VERSION		1		///< Frame format version
+#define UPLINK_MAX_PAYLOAD	16		///< Largest payload [bytes]
+#define UPLINK_MAX_RAW		(UPLINK_MAX_PAYLOAD + 6)	///< Header + payload + CRC
+#define UPLINK_MAX_FRAME	(UPLINK_MAX_RAW + 2)		///< COBS overhead + delimiter
+
+/**
+ * @brief Uplink message ids
+ */
+enum class UplinkId : uint8_t {
+	STICKS = 1,		///< u16 throttle (0..65535), s16 pitch, roll, yaw (+-32767 = full scale)
+	MODE = 2,		///< u8 UplinkMode
+	ARM = 3,		///< u8 1 = armed, 0 = disarmed
+	PARAM_GET = 4,	///< u16 parameter id
+	PARAM_SET = 5,	///< u16 parameter id, f32 value
+	HEARTBEAT = 6,	///< u32 ground station time [ms], echoed back in the LINK frame
+	LOG_ERASE = 7,	///< No payload. Erase the flight recorder (disarmed only).
+	AUTOTUNE = 8	///< u8 axis (ControlAxis + 1, 0 = stop), u8 TuneRule. Armed only.
+};
+
+/**
+ * @brief Flight modes selected with UplinkId::MODE
+ */
+enum class UplinkMode : uint8_t {
+	FLY = 1,		///< Remote controlled flight
+	DEMO = 2		///< Contract demo
+};
+
+/**
+ * @brief A decoded uplink message
+ */
+struct UplinkMsg {
+	UplinkId id;							///< Message id
+	uint8_t seq;							///< Sequence number
+	uint8_t len;							///< Payload length
+	uint8_t payload[UPLINK_MAX_PAYLOAD];	///< Payload
+	uint32_t time;							///< Time the message was received [ms]
+};
+
+/**
+ * @brief Stick positions, full resolution
+ */
+struct UplinkSticks {
+	uint16_t throttle;		///< 0..65535 = zero to full throttle
+	int16_t pitch;			///< +-32767 = full scale
+	int16_t roll;			///< +-32767 = full scale
+	int16_t yaw;			///< +-32767 = full scale
+};
+
+/**
+ * @brief Uplink receive counters
+ */
+struct UplinkStats {
+	uint32_t received;		///< Good messages
+	uint32_t lost;			///< Messages missing from the sequence
+	uint32_t errors;		///< Frames dropped by CRC, length or version
+};
+
+void uplinkSticks(UplinkMsg *m, uint8_t seq, const UplinkSticks *s);
+void uplinkMode(UplinkMsg *m, uint8_t seq, UplinkMode mode);
+void uplinkArm(UplinkMsg *m, uint8_t seq, bool armed);
+void uplinkParamGet(UplinkMsg *m, uint8_t seq, uint16_t id);
+void uplinkParamSet(UplinkMsg *m, uint8_t seq, uint16_t id, float value);
+void uplinkHeartbeat(UplinkMsg *m, uint8_t seq, uint32_t time);
+void uplinkLogErase(UplinkMsg *m, uint8_t seq);
+void uplinkAutotune(UplinkMsg *m, uint8_t seq, uint8_t axis, uint8_t rule);
+
+bool uplinkGetSticks(const UplinkMsg *m, UplinkSticks *s);
+bool uplinkGetMode(const UplinkMsg *m, UplinkMode *mode);
+bool uplinkGetArm(const UplinkMsg *m, bool *armed);
+bool uplinkGetParamGet(const UplinkMsg *m, uint16_t *id);
+bool uplinkGetParamSet(const UplinkMsg *m, uint16_t *id, float *value);
+bool uplinkGetHeartbeat(const UplinkMsg *m, uint32_t *time);
+bool uplinkGetLogErase(const UplinkMsg *m);
+bool uplinkGetAutotune(const UplinkMsg *m, uint8_t *axis, uint8_t *rule);
+
+uint16_t uplinkEncode(const UplinkMsg *m, uint8_t *out);
+uint8_t uplinkFromLegacy(const RcPacket *pkt, uint8_t *seq, bool *armed, UplinkMsg *out);
+
+/**
+ * @brief Byte-at-a-time uplink frame decoder
+ *
+ * Collects bytes up to each 0x00 delimiter, then checks the COBS framing,
+ * version, length and CRC. Sequence gaps are counted as lost messages.
+ */
+class UplinkDecoder {
+private:
+	uint8_t buff[UPLINK_MAX_FRAME];	///< Encoded bytes since the last delimiter
+	uint16_t len;					///< Bytes in buff
+	bool overrun;					///< Frame longer than buff, skip to delimiter
+	UplinkMsg msg;					///< Last good message
+
+	UplinkStats stats;				///< Receive counters
+	bool haveSeq;					///< A message has been received
+	uint8_t lastSeq;				///< Sequence number of the last message
+
+public:
+	UplinkDecoder();
+
+	bool feed(uint8_t b, uint32_t time);
+	const UplinkMsg *getMsg(void);
+	void getStats(UplinkStats *s);
+};
+
+#endif
+
+/** @} Close UART group */
+/** @} Close Peripherals Group */
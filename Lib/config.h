@@ -28,6 +28,19 @@
 
 //#define USE_LIDARLITE
 #define USE_ULTRASONIC
+//#define USE_DYN_NOTCH
+//#define USE_ESC_TELEMETRY
+//#define USE_RPM_NOTCH
+#define USE_BIAS_ESTIMATION
+
+// Run the gyro/accelerometer pre-filters on the raw integer samples in
+// fixed-point (preFilterQ15/preFilterQ31) instead of the float sensorFilter
+// designs. Only the selected path is built into the sensor classes.
+//#define USE_FIXED_POINT
+
+// Accept the original 6-byte remote packets instead of the framed uplink
+// protocol (Uplink.h), translated into uplink messages
+//#define UPLINK_LEGACY
 
 /*
  * Dev board specific configuration
@@ -56,18 +69,100 @@
 #error "No development board defined"
 #endif
 
+/*
+ * ESC protocol (MotorProtocol in Motor.h): PWM, PWM400, ONESHOT125 or DSHOTx.
+ * DShot drives all four channels of a motor's TIM, so every motor on
+ * TIM3/TIM4 must use the same protocol.
+ */
+#define MOTOR_PROTOCOL MotorProtocol::PWM
+
+/*
+ * Frame geometry (mixerFrame in mixer.h). MOTOR_PINS lists the pins in the
+ * frame's motor order, so a hex or octo frame only needs its pins added here.
+ */
+#define MOTOR_FRAME mixerFrame::QUAD_PLUS
+#define MOTOR_PINS {MOTOR_FRONT_PIN, MOTOR_REAR_PIN, MOTOR_LEFT_PIN, MOTOR_RIGHT_PIN}
+
 #define VSENSE_PIN AdcPin::PA2
 #define ISENSE_PIN AdcPin::PA3
 
 /*
- * Flight Parameters
+ * Battery sense scaling (BatteryMonitor.h). ADC_VREF is the ADC reference,
+ * VSENSE_SCALE the battery volts per sensed volt (divider ratio), ISENSE_SCALE
+ * the amps per sensed volt and ISENSE_OFFSET the sensed volts at zero current.
+ */
+#define ADC_VREF 3.0f
+#define VSENSE_SCALE (1.0f / 63.69e-3f)
+#define ISENSE_SCALE 36.6f
+#define ISENSE_OFFSET 0.0f
+
+/*
+ * Sensor i2c buses
+ * The gyro and accelerometer are on IMU_SCL_PIN/IMU_SDA_PIN. The barometer
+ * shares I2C1 with them by default. Moving it to its own bus (e.g. I2C3 on
+ * PA8/PC9; PB10/PB11 are taken by USART3) lets its transfers run in parallel
+ * with the gyro and accelerometer reads.
+ */
+#define IMU_SCL_PIN  i2cPin::PB6
+#define IMU_SDA_PIN  i2cPin::PB9
+#define BARO_SCL_PIN i2cPin::PB6
+#define BARO_SDA_PIN i2cPin::PB9
+
+/*
+ * Power-on to the IMU chips accepting their configuration [ms]. Offsets
+ * are measured after that (IMU::calibrate()) and stored with the
+ * temperature, see ImuCalibrator.h for the thresholds.
+ */
+#define SENSOR_BOOT_DELAY 20
+
+/*
+ * Default sensor pre-filter designs (see filterRegistry in sensorFilter.cpp).
+ * The GYRO_FILTER/ACC_FILTER parameters select another design by registry
+ * index at the next start. Not used with USE_FIXED_POINT.
+ */
+#define GYRO_PREFILTER filterDesign::LPF2
+#define ACC_PREFILTER  filterDesign::LPF2
+
+/*
+ * Dynamic notch on the gyro rates (USE_DYN_NOTCH). The notches track the
+ * strongest vibration peaks, so GYRO_PREFILTER can be relaxed when enabled.
+ */
+#define DYN_NOTCH_COUNT 2
+
+/*
+ * ESC serial telemetry (USE_ESC_TELEMETRY) on USART6 RX. Needs a DShot
+ * MOTOR_PROTOCOL, since the ESCs only answer DShot telemetry requests.
+ * USE_RPM_NOTCH places gyro notches at the reported motor speeds, on all
+ * three axes ahead of the pre-filter.
+ */
+#define ESC_MOTOR_POLES 14
+
+// The telemetry input PC7 (USART6 RX) drives the rear motor on the Discovery
+// board; move MOTOR_REAR_PIN to a free TIM3 pin (e.g. PB5) to use both
+#if defined USE_ESC_TELEMETRY && defined DISCOVERY_BOARD
+#error "USE_ESC_TELEMETRY needs PC7, which DISCOVERY_BOARD uses for MOTOR_REAR_PIN"
+#endif
+
+#if defined USE_RPM_NOTCH && !defined USE_ESC_TELEMETRY
+#error "USE_RPM_NOTCH requires USE_ESC_TELEMETRY"
+#endif
+
+#if defined USE_RPM_NOTCH && defined USE_FIXED_POINT
+#error "USE_RPM_NOTCH can't be combined with USE_FIXED_POINT"
+#endif
+
+/*
+ * Flight Parameters. Those in Params.h are only defaults, the values stored
+ * in flash (ParamStore) and set over the uplink take over at runtime.
  */
 #define MAX_ANGLE 20.0f					// Maximum pitch & roll angle [deg]
-#define MAX_RATE  180.0f				// Maximum yaw rate [deg/s]
+#define MAX_RATE  180.0f				// Maximum rate setpoint, all axes [deg/s]
 #define V_MIN 0.2f
 #define MAX_SPEED 0.4f
+#define ARM_MAX_THROTTLE (0.05f * MAX_SPEED)	// Highest throttle command ARM is accepted at
 #define DEMO_MAX_SPEED 0.2f
 
+// Angle loops (CascadeControl): rate setpoint [deg/s] per degree of error
 #define PITCH_KP 6.0f
 #define PITCH_KI 0.0f
 #define PITCH_KD 0.0f
@@ -76,14 +171,134 @@
 #define ROLL_KI  0.0f
 #define ROLL_KD  0.0f
 
+// Rate loops: PID output per deg/s of error. With P at 1 and the angle gains
+// above, the output for an angle error is what the angle-only loop gave, plus
+// damping from the gyro rate.
+#define PITCH_RATE_KP 1.0f
+#define PITCH_RATE_KI 0.0f
+#define PITCH_RATE_KD 0.0f
+
+#define ROLL_RATE_KP  1.0f
+#define ROLL_RATE_KI  0.0f
+#define ROLL_RATE_KD  0.0f
+
+#define YAW_RATE_KP   1.0f
+#define YAW_RATE_KI   0.0f
+#define YAW_RATE_KD   0.0f
+
+// Rate loop setpoint feed-forward: PID output per deg/s of setpoint
+#define PITCH_RATE_KFF 0.0f
+#define ROLL_RATE_KFF  0.0f
+#define YAW_RATE_KFF   0.0f
+
+// Rate loop output limits, in motor speed (PID output / PID_OUT_SCALE)
+#define PITCH_OUT_MAX 0.2f
+#define ROLL_OUT_MAX  0.2f
+#define YAW_OUT_MAX   0.1f
+
 #define PID_SCALE 55.0f
 
+// Complementary filter time constant [s]
+#define COMPLEMENTARY_TAU (0.04f)
+
 /*
  * UART RX parameters
  */
 #define LOOP_DELAY 10	// Main loop delay in ms
 #define TIMEOUT ((int)2.0f / ((float)LOOP_DELAY / (float)1000))
 
+/*
+ * Control loop timing. fly() runs the rate loops every gyro sample, at the
+ * gyro ODR set in DeathChopper9000() (L3GD_ODR_BW_Config::EIGHT, 200 Hz).
+ * The angle loops and the rest of the loop (uplink, telemetry, recorder) run
+ * every CONTROL_OUTER_DIV samples, at the LOOP_DELAY rate, so timeouts
+ * counted in loops keep their meaning. demo() runs on the same tick.
+ */
+#define CONTROL_RATE_HZ 200
+#define CONTROL_OUTER_DIV 2
+
+#if CONTROL_RATE_HZ / CONTROL_OUTER_DIV != 1000 / LOOP_DELAY
+#error "CONTROL_RATE_HZ / CONTROL_OUTER_DIV must match LOOP_DELAY"
+#endif
+
+// The sensor IIR designs (L3GD20H.cpp, LSM303D.cpp, preFilterGyro,
+// preFilterAcc) are worked out for this rate; redesign them if it changes
+#if CONTROL_RATE_HZ != 200
+#error "Sensor IIR coefficients are designed for CONTROL_RATE_HZ 200"
+#endif
+
+/*
+ * Online gyro bias and accelerometer offset tracking (USE_BIAS_ESTIMATION),
+ * on top of the offsets from IMU::calibrate(). See BiasEstimator.h. The gyro
+ * temperature feeding the thermal model is read every BIAS_TEMP_DIV outer
+ * loops, once a second.
+ */
+#define BIAS_TEMP_DIV (1000 / LOOP_DELAY)
+
+/*
+ * Relay autotuner (RelayTuner.h, UplinkId::AUTOTUNE). The relay swings one
+ * rate loop's output TUNE_AMPLITUDE either side of its integral term. The
+ * experiment aborts past TUNE_ANGLE_LIMIT, which has to be well inside
+ * ANGLE_LIMIT, past TUNE_RATE_LIMIT of rate error, or after TUNE_TIMEOUT.
+ * Yaw has no angle, so its heading change since the start is held to
+ * TUNE_HEADING_LIMIT instead.
+ */
+#define TUNE_AMPLITUDE	0.05f	// Relay amplitude, in motor speed (PID output / PID_OUT_SCALE)
+#define TUNE_HYSTERESIS	5.0f	// Relay hysteresis [deg/s], above the gyro noise
+#define TUNE_ANGLE_LIMIT 10.0f	// Largest angle while tuning [deg]
+#define TUNE_HEADING_LIMIT 45.0f	// Largest heading change while tuning yaw [deg]
+#define TUNE_RATE_LIMIT	150.0f	// Largest rate error while tuning [deg/s]
+#define TUNE_TIMEOUT	10.0f	// Longest experiment [s]
+
+/*
+ * Telemetry scheduler (TelemetryScheduler.h). The link is 57600 baud with 9
+ * bit words (8 data + parity), 11 bits a byte with start and stop. At most
+ * TELEM_LATENCY seconds of telemetry is kept queued. Channel rates [Hz] are
+ * divided by TELEMETRY_DIVIDER (the TELEM_DIVIDER parameter); as set they
+ * use about 40% of the link, leaving the rest for replies and traces.
+ */
+#define TELEM_LINK_BYTES_PER_S (57600.0f / 11.0f)
+#define TELEM_LATENCY 0.03f
+#define TELEMETRY_DIVIDER 1
+#define TELEM_RATE_ATTITUDE 50.0f
+#define TELEM_RATE_CONTROL 25.0f
+#define TELEM_RATE_ALTITUDE 10.0f
+#define TELEM_RATE_BATTERY 5.0f
+#define TELEM_RATE_TIMING 5.0f
+#define TELEM_RATE_ERRORS 1.0f
+#define TELEM_RATE_I2C 2.0f
+
+/*
+ * Flight recorder (Blackbox.h). Records every outer fly() loop while armed
+ * into RAM, BLACKBOX_RAM_PAGES pages (32 kB, about 6 s of flight at ~50
+ * bytes per record); later records are dropped. Flash programming stalls the
+ * whole chip, interrupts included, so the pages are only written to flash
+ * sectors 8 & 9 once disarmed, BLACKBOX_WORDS_PER_LOOP words (~1 ms) per
+ * loop. Off by default.
+ */
+//#define USE_BLACKBOX
+#define BLACKBOX_WORDS_PER_LOOP 64
+
+/*
+ * Binary log (BinLog.h). Most TRACE frames sent per fly() loop, and only
+ * while the UART is idle; a full frame is ~70 bytes.
+ */
+#define BINLOG_FRAMES_PER_LOOP 1
+
+/*
+ * Log categories compiled in (Log.h). Messages in a category left undefined,
+ * or above LOG_MAX_LEVEL (0 fault .. 3 verbose), generate no code. The
+ * LOG_CATEGORIES and LOG_LEVEL parameters narrow this further at run time.
+ */
+//#define LOG_RAW
+//#define LOG_PREFILTERED
+//#define LOG_ACC_ANGLE
+//#define LOG_COMP_FILTERED
+//#define LOG_OUTPUT
+#define LOG_MAX_LEVEL 3
+#define LOG_DEFAULT_CATEGORIES 0x1F	// All of the above that are compiled in
+#define LOG_DEFAULT_LEVEL 3
+
 #endif
 
 /** @} Close Config group */
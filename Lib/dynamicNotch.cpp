@@ -0,0 +1,283 @@
+/**
+ * @file
+ *
+ * @brief Class for FFT-tracked notch filtering of gyro vibration
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @addtogroup PREFILTER
+ *  @{
+ */
+
+#include "dynamicNotch.h"
+#include <math.h>
+
+/**
+ * @brief Find the strongest peaks of a magnitude spectrum
+ * @param mag       Magnitude spectrum
+ * @param bins      Number of bins in mag
+ * @param binHz     Width of one bin [Hz]
+ * @param minHz     Lowest frequency to search [Hz]
+ * @param maxHz     Highest frequency to search [Hz]
+ * @param threshold A peak must exceed this multiple of the mean magnitude
+ * @param peaks     [out] Peak frequencies [Hz], strongest first
+ * @param maxPeaks  Size of peaks
+ * @return Number of peaks found
+ *
+ * Peaks are local maxima refined by parabolic interpolation between the
+ * neighbouring bins. Does not touch hardware, so it can be fed synthetic
+ * spectra.
+ */
+uint8_t dynNotchFindPeaks(const float32_t *mag, uint16_t bins, float32_t binHz, float32_t minHz, float32_t maxHz,
+		float32_t threshold, float32_t *peaks, uint8_t maxPeaks) {
+	float32_t level[DYN_NOTCH_MAX];
+	uint8_t n = 0;
+
+	if (maxPeaks > DYN_NOTCH_MAX) {
+		maxPeaks = DYN_NOTCH_MAX;
+	}
+
+	// Search range, leaving a neighbour on each side for the interpolation
+	uint16_t lo = (uint16_t)(minHz / binHz);
+	uint16_t hi = (uint16_t)(maxHz / binHz);
+	if (lo < 1) {
+		lo = 1;
+	}
+	if (hi > bins - 2) {
+		hi = bins - 2;
+	}
+	if (lo > hi) {
+		return 0;
+	}
+
+	float32_t mean = 0.0f;
+	for (uint16_t k = lo; k <= hi; k++) {
+		mean += mag[k];
+	}
+	mean /= (float32_t)(hi - lo + 1);
+
+	for (uint16_t k = lo; k <= hi; k++) {
+		float32_t m = mag[k];
+		if (m <= mean*threshold || m <= mag[k-1] || m < mag[k+1]) {
+			continue;
+		}
+
+		// Insert into the list of strongest peaks
+		uint8_t pos = n;
+		while (pos > 0 && level[pos-1] < m) {
+			pos--;
+		}
+		if (pos >= maxPeaks) {
+			continue;
+		}
+		for (uint8_t j = (n < maxPeaks) ? n : maxPeaks - 1; j > pos; j--) {
+			level[j] = level[j-1];
+			peaks[j] = peaks[j-1];
+		}
+
+		float32_t den = mag[k-1] - 2.0f*m + mag[k+1];
+		float32_t delta = (den != 0.0f) ? 0.5f*(mag[k-1] - mag[k+1]) / den : 0.0f;
+
+		level[pos] = m;
+		peaks[pos] = ((float32_t)k + delta) * binHz;
+		if (n < maxPeaks) {
+			n++;
+		}
+	}
+
+	return n;
+}
+
+/**
+ * @brief Calculate notch biquad coefficients
+ * @param f0   Center frequency [Hz]
+ * @param q    Quality factor
+ * @param fs   Sample rate [Hz]
+ * @param coef [out] {b0, b1, b2, a1, a2} in the ARM CMSIS sign convention
+ *
+ * Bilinear-transform notch with unity gain away from f0. The -3 dB width is
+ * set directly in the digital domain (f0 / q), so the notch keeps its Q up
+ * to Nyquist; the usual sin(w0) / 2q narrows it several times near fs/2.
+ */
+void dynNotchCoefficients(float32_t f0, float32_t q, float32_t fs, float32_t *coef) {
+	float32_t w0 = 2.0f * PI * f0 / fs;
+	float32_t c = cosf(w0);
+	float32_t alpha = tanf(PI * f0 / (q * fs));
+	float32_t a0 = 1.0f + alpha;
+
+	coef[0] = 1.0f / a0;
+	coef[1] = -2.0f * c / a0;
+	coef[2] = 1.0f / a0;
+	coef[3] = 2.0f * c / a0;
+	coef[4] = -(1.0f - alpha) / a0;
+}
+
+/**
+ * @brief Construct a dynamicNotch object
+ * @param sampleRate Rate filterSample() is called at [Hz]
+ * @param notches    Number of notches to track (1 to DYN_NOTCH_MAX)
+ *
+ * All notches start as pass-through until the first analysis.
+ */
+dynamicNotch::dynamicNotch(float32_t sampleRate, uint8_t notches) {
+	fs = sampleRate;
+	numNotches = (notches < 1) ? 1 : (notches > DYN_NOTCH_MAX) ? DYN_NOTCH_MAX : notches;
+
+	idx = 0;
+	newSamples = 0;
+	active = 0;
+
+	for (uint8_t i = 0; i < DYN_NOTCH_MAX; i++) {
+		center[i] = 0.0f;
+		missed[i] = 0;
+		for (uint8_t b = 0; b < 2; b++) {
+			coef[b][5*i + 0] = 1.0f;
+			coef[b][5*i + 1] = 0.0f;
+			coef[b][5*i + 2] = 0.0f;
+			coef[b][5*i + 3] = 0.0f;
+			coef[b][5*i + 4] = 0.0f;
+		}
+	}
+
+	for (uint16_t k = 0; k < DYN_NOTCH_FFT_SIZE; k++) {
+		samples[k] = 0.0f;
+		window[k] = 0.5f - 0.5f * cosf(2.0f * PI * (float32_t)k / (float32_t)(DYN_NOTCH_FFT_SIZE - 1));
+	}
+
+	// arm structure initialization
+	arm_biquad_cascade_df2T_init_f32(&f, numNotches, coef[active], state);
+	arm_rfft_fast_init_f32(&fft, DYN_NOTCH_FFT_SIZE);
+}
+
+/**
+ * @brief   Calculate the filter output
+ * @param x The current sample input
+ * @return  The corresponding filter output
+ *
+ * Buffers the sample for the next analysis and applies the notches.
+ */
+float32_t dynamicNotch::filterSample(float32_t x) {
+	float32_t y = 0.0f;
+
+	samples[idx] = x;
+	idx = (idx + 1) % DYN_NOTCH_FFT_SIZE;
+	if (newSamples < DYN_NOTCH_FFT_SIZE) {
+		newSamples++;
+	}
+
+	arm_biquad_cascade_df2T_f32(&f, &x, &y, 1);
+
+	return y;
+}
+
+/**
+ * @brief  Analyse the buffered samples and retune the notches
+ * @return true if an analysis was run
+ *
+ * Returns immediately until DYN_NOTCH_HOP new samples are available, so it
+ * may be called as often as convenient from a low-priority context.
+ */
+bool dynamicNotch::update(void) {
+	if (newSamples < DYN_NOTCH_HOP) {
+		return false;
+	}
+	newSamples = 0;
+
+	// Unroll the ring buffer, oldest sample first, and apply the window
+	uint16_t start = idx;
+	for (uint16_t k = 0; k < DYN_NOTCH_FFT_SIZE; k++) {
+		fftBuff[k] = samples[(start + k) % DYN_NOTCH_FFT_SIZE] * window[k];
+	}
+
+	arm_rfft_fast_f32(&fft, fftBuff, spectrum, 0);
+
+	// spectrum[1] holds the Nyquist bin, not the imaginary part of DC
+	spectrum[1] = 0.0f;
+	arm_cmplx_mag_f32(spectrum, mag, DYN_NOTCH_FFT_SIZE/2);
+
+	float32_t peaks[DYN_NOTCH_MAX];
+	uint8_t n = dynNotchFindPeaks(mag, DYN_NOTCH_FFT_SIZE/2, fs / DYN_NOTCH_FFT_SIZE, DYN_NOTCH_MIN_HZ, 0.45f*fs,
+			DYN_NOTCH_THRESHOLD, peaks, numNotches);
+
+	retune(peaks, n);
+
+	return true;
+}
+
+/**
+ * @brief Match peaks to notches and switch to the new coefficients
+ * @param peaks Peak frequencies [Hz], strongest first
+ * @param n     Number of peaks
+ */
+void dynamicNotch::retune(const float32_t *peaks, uint8_t n) {
+	bool used[DYN_NOTCH_MAX] = {false};
+	float32_t maxJump = 3.0f * fs / DYN_NOTCH_FFT_SIZE;
+
+	// Follow existing notches with the nearest peak
+	for (uint8_t i = 0; i < numNotches; i++) {
+		if (center[i] == 0.0f) {
+			continue;
+		}
+
+		int8_t best = -1;
+		for (uint8_t j = 0; j < n; j++) {
+			if (!used[j] && fabsf(peaks[j] - center[i]) < maxJump &&
+				(best < 0 || fabsf(peaks[j] - center[i]) < fabsf(peaks[best] - center[i]))) {
+				best = j;
+			}
+		}
+
+		if (best >= 0) {
+			used[best] = true;
+			center[i] += DYN_NOTCH_SMOOTH * (peaks[best] - center[i]);
+			missed[i] = 0;
+		} else if (++missed[i] > DYN_NOTCH_HOLD) {
+			center[i] = 0.0f;
+		}
+	}
+
+	// Start free notches on the remaining peaks
+	for (uint8_t j = 0; j < n; j++) {
+		for (uint8_t i = 0; i < numNotches && !used[j]; i++) {
+			if (center[i] == 0.0f) {
+				center[i] = peaks[j];
+				missed[i] = 0;
+				used[j] = true;
+			}
+		}
+	}
+
+	// Fill the inactive coefficient set, then switch with one store
+	uint8_t next = active ^ 1;
+	for (uint8_t i = 0; i < numNotches; i++) {
+		float32_t *c = &coef[next][5*i];
+		if (center[i] > 0.0f) {
+			dynNotchCoefficients(center[i], DYN_NOTCH_Q, fs, c);
+		} else {
+			c[0] = 1.0f;
+			c[1] = c[2] = c[3] = c[4] = 0.0f;
+		}
+	}
+	f.pCoeffs = coef[next];
+	active = next;
+}
+
+/**
+ * @brief  Get a tracked center frequency
+ * @param i Notch index
+ * @return Center frequency [Hz], 0 if the notch is off
+ */
+float32_t dynamicNotch::getCenter(uint8_t i) {
+	return (i < numNotches) ? center[i] : 0.0f;
+}
+
+/** @} Close PREFILTER group */
+/** @} Close Control Group */
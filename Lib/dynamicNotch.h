@@ -0,0 +1,91 @@
+/**
+ * @file
+ *
+ * @brief Class for FFT-tracked notch filtering of gyro vibration
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @addtogroup PREFILTER
+ *  @{
+ */
+
+#ifndef DYNAMICNOTCH_H_
+#define DYNAMICNOTCH_H_
+
+#include <stdint.h>
+#include "stm32f407xx.h"
+#include "arm_math.h"
+
+#define DYN_NOTCH_FFT_SIZE	64		///< FFT length [samples], power of 2 (32..4096)
+#define DYN_NOTCH_HOP		16		///< New samples between two FFTs
+#define DYN_NOTCH_MAX		3		///< Number of notch biquads
+#define DYN_NOTCH_Q			3.0f	///< Notch quality factor (center / -3 dB width)
+#define DYN_NOTCH_MIN_HZ	8.0f	///< Lowest tracked frequency [Hz]
+#define DYN_NOTCH_THRESHOLD	2.5f	///< Peak must exceed this multiple of the mean magnitude
+#define DYN_NOTCH_SMOOTH	0.3f	///< Weight of a new peak estimate in the tracked center
+#define DYN_NOTCH_HOLD		4		///< FFTs a notch survives without a matching peak
+
+uint8_t dynNotchFindPeaks(const float32_t *mag, uint16_t bins, float32_t binHz, float32_t minHz, float32_t maxHz,
+		float32_t threshold, float32_t *peaks, uint8_t maxPeaks);
+void dynNotchCoefficients(float32_t f0, float32_t q, float32_t fs, float32_t *coef);
+
+/**
+ * @brief Notch filter bank that follows the strongest vibration peaks
+ *
+ * filterSample() is the only part meant for the control loop: it stores the
+ * sample in a ring buffer and runs the notch biquads (ARM CMSIS Direct-Form
+ * II Transpose), which is a few tens of cycles per notch.
+ *
+ * update() does the analysis and must be called from a low-priority slice,
+ * never from the inner loop. Once DYN_NOTCH_HOP new samples are buffered it
+ * runs one Hann-windowed arm_rfft_fast_f32 over the last DYN_NOTCH_FFT_SIZE
+ * samples, picks the strongest peaks, smooths the tracked center frequencies
+ * and writes new coefficients into the inactive half of a double buffer.
+ * The filter switches to it with a single pointer store, so filterSample()
+ * never sees a half-written coefficient set.
+ *
+ * Notches without a peak for DYN_NOTCH_HOLD analyses are set to pass-through.
+ */
+class dynamicNotch {
+private:
+	arm_biquad_cascade_df2T_instance_f32 f;		///< ARM IIR Direct-Form II Transpose filter structure
+	arm_rfft_fast_instance_f32 fft;				///< ARM real FFT structure
+	float32_t coef[2][5*DYN_NOTCH_MAX];			///< Double-buffered notch coefficients
+	uint8_t active;								///< Index of the coefficient set in use
+	float32_t state[2*DYN_NOTCH_MAX];			///< State buffer used by ARM routine
+
+	float32_t samples[DYN_NOTCH_FFT_SIZE];		///< Ring buffer of recent input samples
+	uint16_t idx;								///< Next write position in samples
+	volatile uint16_t newSamples;				///< Samples written since the last FFT
+	float32_t window[DYN_NOTCH_FFT_SIZE];		///< Hann window
+	float32_t fftBuff[DYN_NOTCH_FFT_SIZE];		///< FFT input (destroyed by the ARM routine)
+	float32_t spectrum[DYN_NOTCH_FFT_SIZE];		///< FFT output, interleaved complex
+	float32_t mag[DYN_NOTCH_FFT_SIZE/2];		///< Magnitude spectrum
+
+	float32_t fs;								///< Sample rate [Hz]
+	uint8_t numNotches;							///< Notches in use
+	float32_t center[DYN_NOTCH_MAX];			///< Tracked center frequencies [Hz], 0 if off
+	uint8_t missed[DYN_NOTCH_MAX];				///< Analyses since the notch last matched a peak
+
+	void retune(const float32_t *peaks, uint8_t n);
+
+public:
+	dynamicNotch(float32_t sampleRate, uint8_t notches);
+
+	float32_t filterSample(float32_t x);
+	bool update(void);
+	float32_t getCenter(uint8_t i);
+};
+
+#endif
+
+/** @} Close PREFILTER group */
+/** @} Close Control Group */
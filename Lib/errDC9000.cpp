@@ -19,6 +19,7 @@
  *  @{
  */
 
+#include <string.h>
 #include "errDC9000.h"
 #include "DeathChopper9000.h"
 
@@ -42,26 +43,29 @@ const char* errDC9000_msg[] = {
 	"LSM303D init error\n\r",			// LSM_INIT_ERROR
 	"LSM303D communication error\n\r",	// LSM_IO_ERROR
 	"PWM init error\n\r",				// PWM_INIT_ERROR
+	"DShot init error\n\r",			// DSHOT_INIT_ERROR
+	"Mixer config error\n\r",			// MIXER_CONFIG_ERROR
 	"LIDAR Lite init error\n\r",		// LIDAR_INIT_ERROR
 	"HC-SR04 init error\n\r",			// ULTRASONIC_INIT_ERROR
 	"ADC init error\n\r",				// ADC_INIT_ERROR
-	"ADC read error\n\r"				// ADC_IO_ERROR
+	"ADC read error\n\r",				// ADC_IO_ERROR
+	"Telemetry config error\n\r"		// TELEMETRY_CONFIG_ERROR
 };
 
 /**
  * @brief Handle errors
  * @param e The error
  *
- * Send an error message over UART, turn on the error LED, and shut all
- * motors off.
+ * Shut all motors off, turn on the error LED, send an error message over
+ * UART and halt. The motors are cut first: the message is written by polling
+ * and takes milliseconds at the telemetry baud rate, and the DMA transfer it
+ * would otherwise wait for can take longer still.
  *
  * @todo Possibly descend instead of killing the motors immediately
  */
 void Error_Handler(errDC9000 e) {
-	// If the error has to do with UART, can't send error message via UART
-	if (e != errDC9000::UART_INIT_ERROR && e != errDC9000::UART_IO_ERROR && e != errDC9000::UART_DEINIT_ERROR) {
-		usart_transmit((uint8_t *)errDC9000_msg[(int)e]);
-	}
+	DeathChopper9000 *dc9000 = DeathChopper9000::instance();
+	dc9000->stopMotors();
 
 	// Turn on ONLY the red "Error" LED
 	leds->turnOff(LED::BLUE);
@@ -69,7 +73,15 @@ void Error_Handler(errDC9000 e) {
 	leds->turnOff(LED::ORANGE);
 	leds->turnOn(LED::RED);
 
-	DeathChopper9000 *dc9000 = DeathChopper9000::instance();
+	// If the error has to do with UART, can't send error message via UART.
+	// Errors can be raised from interrupts, which must not touch the TX
+	// queue, and nothing queued would be sent after the halt anyway, so the
+	// transfer in flight is dropped rather than waited for
+	if (e != errDC9000::UART_INIT_ERROR && e != errDC9000::UART_IO_ERROR && e != errDC9000::UART_DEINIT_ERROR) {
+		usart_tx_abort();
+		usart_write_raw((const uint8_t *)errDC9000_msg[(int)e], strlen(errDC9000_msg[(int)e]));
+	}
+
 	dc9000->abort();
 }
 
@@ -41,10 +41,13 @@ enum class errDC9000 {
 	LSM_INIT_ERROR,				///< LSM303D initialization error
 	LSM_IO_ERROR,				///< LSM303D comm error
 	PWM_INIT_ERROR,				///< PWM initialization error
+	DSHOT_INIT_ERROR,			///< DShot initialization error
+	MIXER_CONFIG_ERROR,			///< Motor pins don't match the frame
 	LIDAR_INIT_ERROR,			///< LIDAR Lite initialization error
 	ULTRASONIC_INIT_ERROR,		///< HC-SR04 initialization error
 	ADC_INIT_ERROR,				///< ADC initialization error
-	ADC_IO_ERROR				///< ADC read errors
+	ADC_IO_ERROR,				///< ADC read errors
+	TELEMETRY_CONFIG_ERROR		///< Telemetry channels don't fit the scheduler
 };
 
 void Error_Handler(errDC9000 e);
@@ -80,10 +80,10 @@ void logger::log(char *s) {
 /**
  * @brief Transmit buffer
  *
- * Starts a UART transmission to send the logged data.
+ * Copies the logged data into the UART TX queue.
  *
- * @note It is possible that this function will block, so care should be taken
- * to not log too much data. UART is slow.
+ * @note Never blocks, but the data is dropped if the queue is full, so care
+ * should be taken to not log too much data. UART is slow.
  */
 void logger::dump() {
 	usart_transmit((uint8_t *)activeBuffer);
@@ -36,12 +36,6 @@
 // Size of the log buffers
 #define LOG_SIZE 1024
 
-//#define LOG_RAW
-//#define LOG_PREFILTERED
-//#define LOG_ACC_ANGLE
-//#define LOG_COMP_FILTERED
-//#define LOG_OUTPUT
-
 /**
  * @brief Class for logging and transmitting data
  *
@@ -0,0 +1,215 @@
+/**
+ * @file
+ *
+ * @brief Matrix motor mixer with attitude-preserving desaturation
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Mixing matrix rows are (throttle, roll, pitch, yaw). For a motor at angle a,
+ * measured clockwise from the nose, roll = -sin(a) and pitch = -cos(a), so a
+ * positive roll command speeds up the left side and a positive pitch command
+ * the rear. Yaw is +1 or -1 by propeller direction. The X frames use the same
+ * per-axis authority as QUAD_PLUS so the PID gains carry over.
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @defgroup MIXER Motor mixer
+ *  @brief Converts attitude commands to motor speeds for a frame geometry
+ *  @{
+ */
+
+#include "mixer.h"
+
+// Front, rear, left, right (matches the original hard-coded mixing)
+static const float32_t mixQuadPlus[4*MIXER_AXES] = {
+	1.0f,  0.0f,     -1.0f,     -1.0f,
+	1.0f,  0.0f,      1.0f,     -1.0f,
+	1.0f,  1.0f,      0.0f,      1.0f,
+	1.0f, -1.0f,      0.0f,      1.0f
+};
+
+// Front-right, rear-left, front-left, rear-right
+static const float32_t mixQuadX[4*MIXER_AXES] = {
+	1.0f, -0.7071f,  -0.7071f,  -1.0f,
+	1.0f,  0.7071f,   0.7071f,  -1.0f,
+	1.0f,  0.7071f,  -0.7071f,   1.0f,
+	1.0f, -0.7071f,   0.7071f,   1.0f
+};
+
+// Clockwise from front-right, 30 deg off the nose
+static const float32_t mixHexX[6*MIXER_AXES] = {
+	1.0f, -0.5f,     -0.8660f,  -1.0f,
+	1.0f, -1.0f,      0.0f,      1.0f,
+	1.0f, -0.5f,      0.8660f,  -1.0f,
+	1.0f,  0.5f,      0.8660f,   1.0f,
+	1.0f,  1.0f,      0.0f,     -1.0f,
+	1.0f,  0.5f,     -0.8660f,   1.0f
+};
+
+// Clockwise from front-right, 22.5 deg off the nose
+static const float32_t mixOctoX[8*MIXER_AXES] = {
+	1.0f, -0.3827f,  -0.9239f,  -1.0f,
+	1.0f, -0.9239f,  -0.3827f,   1.0f,
+	1.0f, -0.9239f,   0.3827f,  -1.0f,
+	1.0f, -0.3827f,   0.9239f,   1.0f,
+	1.0f,  0.3827f,   0.9239f,  -1.0f,
+	1.0f,  0.9239f,   0.3827f,   1.0f,
+	1.0f,  0.9239f,  -0.3827f,  -1.0f,
+	1.0f,  0.3827f,  -0.9239f,   1.0f
+};
+
+/**
+ * @brief Get the mixing matrix of a frame
+ * @param frame  Frame geometry
+ * @param motors [out] Number of motors (matrix rows)
+ * @return Row-major matrix, motors x MIXER_AXES
+ */
+static const float32_t *mixerMatrix(mixerFrame frame, uint8_t *motors) {
+	switch (frame) {
+	case mixerFrame::QUAD_X:	*motors = 4; return mixQuadX;
+	case mixerFrame::HEX_X:		*motors = 6; return mixHexX;
+	case mixerFrame::OCTO_X:	*motors = 8; return mixOctoX;
+	case mixerFrame::QUAD_PLUS:
+	default:					*motors = 4; return mixQuadPlus;
+	}
+}
+
+/**
+ * @brief Get how much of the attitude commands the last mix() applied
+ * @param rollPitch [out] Fraction of the roll and pitch commands, 0 to 1
+ * @param yaw       [out] Fraction of the yaw command, 0 to 1
+ *
+ * Below 1 when desaturation scaled the commands down, 0 at zero throttle.
+ * Feed back to the controllers' anti-windup.
+ */
+void mixer::getApplied(float *rollPitch, float *yaw) {
+	*rollPitch = rpApplied;
+	*yaw = yawApplied;
+}
+
+/**
+ * @brief Get the number of motors of a frame
+ * @param frame Frame geometry
+ * @return Number of motors
+ */
+uint8_t mixerFrameMotors(mixerFrame frame) {
+	uint8_t motors;
+	mixerMatrix(frame, &motors);
+	return motors;
+}
+
+/**
+ * @brief Initialize the mixer for a frame geometry
+ * @param frame  Frame geometry
+ * @param outMax Highest motor speed (motor speeds range from 0 to outMax)
+ */
+mixer::mixer(mixerFrame frame, float outMax) {
+	const float32_t *m = mixerMatrix(frame, &n);
+
+	this->frame = frame;
+	this->outMax = outMax;
+	rpApplied = yawApplied = 0.0f;
+
+	for (uint8_t i = 0; i < n*MIXER_AXES; i++) {
+		matData[i] = m[i];
+	}
+	for (uint8_t i = 0; i < MIXER_AXES*3; i++) {
+		cmdData[i] = 0.0f;
+	}
+
+	arm_mat_init_f32(&mat, n, MIXER_AXES, matData);
+	arm_mat_init_f32(&cmd, MIXER_AXES, 3, cmdData);
+	arm_mat_init_f32(&part, n, 3, partData);
+}
+
+/**
+ * @brief Mix the commands into motor speeds
+ * @param throttle Collective throttle, 0.0 to outMax
+ * @param roll     Roll command, positive speeds up the left side
+ * @param pitch    Pitch command, positive speeds up the rear
+ * @param yaw      Yaw command
+ * @param out      [out] Speed per motor, 0.0 to outMax
+ */
+void mixer::mix(float throttle, float roll, float pitch, float yaw, float *out) {
+	if (throttle <= 0.0f) {
+		for (uint8_t i = 0; i < n; i++) out[i] = 0.0f;
+		rpApplied = yawApplied = 0.0f;
+		return;
+	}
+
+	// Command columns: throttle, roll + pitch, yaw
+	cmdData[0] = throttle;
+	cmdData[4] = roll;
+	cmdData[7] = pitch;
+	cmdData[11] = yaw;
+	arm_mat_mult_f32(&mat, &cmd, &part);
+
+	// Spread of the roll/pitch part alone and with yaw added
+	float rpMin = partData[1], rpMax = partData[1];
+	float aMin = partData[1] + partData[2], aMax = aMin;
+	for (uint8_t i = 1; i < n; i++) {
+		float rp = partData[i*3 + 1];
+		float a = rp + partData[i*3 + 2];
+
+		if (rp < rpMin) rpMin = rp;
+		if (rp > rpMax) rpMax = rp;
+		if (a < aMin) aMin = a;
+		if (a > aMax) aMax = a;
+	}
+
+	float rpRange = rpMax - rpMin;
+	float aRange = aMax - aMin;
+	float rpScale = 1.0f;
+	float yawScale = 1.0f;
+
+	if (rpRange > outMax) {
+		// Roll/pitch alone saturate: keep their ratio, give up yaw
+		rpScale = outMax / rpRange;
+		yawScale = 0.0f;
+	} else if (aRange > outMax) {
+		// Range is convex in the yaw scale, so this scale always fits
+		yawScale = (outMax - rpRange) / (aRange - rpRange);
+	}
+	rpApplied = rpScale;
+	yawApplied = yawScale;
+
+	// Attitude part per motor and its extremes
+	aMin = aMax = rpScale * partData[1] + yawScale * partData[2];
+	for (uint8_t i = 0; i < n; i++) {
+		float a = rpScale * partData[i*3 + 1] + yawScale * partData[i*3 + 2];
+
+		out[i] = a;
+		if (a < aMin) aMin = a;
+		if (a > aMax) aMax = a;
+	}
+
+	// Move throttle so every motor stays within 0..outMax
+	float shift = 0.0f;
+	if (throttle + aMin < 0.0f) shift = -aMin - throttle;
+	else if (throttle + aMax > outMax) shift = outMax - aMax - throttle;
+
+	for (uint8_t i = 0; i < n; i++) {
+		float s = partData[i*3] + shift + out[i];
+
+		if (s < 0.0f) s = 0.0f;
+		else if (s > outMax) s = outMax;
+		out[i] = s;
+	}
+}
+
+/**
+ * @brief Get the number of motors
+ * @return Number of motors of the frame
+ */
+uint8_t mixer::getMotors(void) {
+	return n;
+}
+
+/** @} Close MIXER group */
+/** @} Close Control Group */
@@ -0,0 +1,89 @@
+/**
+ * @file
+ *
+ * @brief Matrix motor mixer with attitude-preserving desaturation
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @addtogroup MIXER
+ *  @{
+ */
+
+#ifndef MIXER_H_
+#define MIXER_H_
+
+#include <stdint.h>
+#include "stm32f407xx.h"
+#include "arm_math.h"
+
+#define MIXER_MAX_MOTORS	8		///< Largest supported frame (octo)
+#define MIXER_AXES			4		///< Throttle, roll, pitch, yaw
+
+/**
+ * @brief Supported frame geometries
+ *
+ * Motor order per frame is given with the tables in mixer.cpp and must match
+ * the order of the MotorGroup pins.
+ */
+enum class mixerFrame {
+	QUAD_PLUS = 0,	//!< Front, rear, left, right
+	QUAD_X,			//!< Front-right, rear-left, front-left, rear-right
+	HEX_X,			//!< Clockwise from front-right
+	OCTO_X			//!< Clockwise from front-right
+};
+
+uint8_t mixerFrameMotors(mixerFrame frame);
+
+/**
+ * @brief Mixes throttle, roll, pitch and yaw commands into motor speeds
+ *
+ * Each motor has a row (throttle, roll, pitch, yaw) in the frame's mixing
+ * matrix. One arm_mat_mult_f32 call splits every motor's output into its
+ * throttle, roll/pitch and yaw parts, which are then desaturated in order of
+ * priority:
+ * 		-# Roll/pitch spread wider than the output range is scaled down and yaw
+ * 		   is dropped.
+ * 		-# Yaw is scaled down until roll/pitch + yaw fits.
+ * 		-# Throttle is moved up or down so no motor leaves the output range.
+ *
+ * Attitude authority is kept at the cost of throttle, so a full-throttle
+ * correction still produces a differential thrust. Zero throttle stops all
+ * motors regardless of the attitude commands.
+ */
+class mixer {
+private:
+	mixerFrame frame;						///< Frame geometry
+	uint8_t n;								///< Number of motors
+	float outMax;							///< Highest motor speed
+	float rpApplied;						///< Fraction of roll/pitch the last mix() applied
+	float yawApplied;						///< Fraction of yaw the last mix() applied
+
+	float32_t matData[MIXER_MAX_MOTORS*MIXER_AXES];	///< Mixing matrix (n x 4)
+	float32_t cmdData[MIXER_AXES*3];				///< Commands (4 x 3)
+	float32_t partData[MIXER_MAX_MOTORS*3];			///< Output parts (n x 3)
+
+	arm_matrix_instance_f32 mat;			///< Mixing matrix
+	arm_matrix_instance_f32 cmd;			///< Throttle, roll/pitch and yaw columns
+	arm_matrix_instance_f32 part;			///< Per motor throttle, roll/pitch, yaw
+
+public:
+	mixer(mixerFrame frame, float outMax);
+
+	void mix(float throttle, float roll, float pitch, float yaw, float *out);
+	void getApplied(float *rollPitch, float *yaw);
+
+	uint8_t getMotors(void);
+};
+
+#endif /* MIXER_H_ */
+
+/** @} Close MIXER group */
+/** @} Close Control Group */
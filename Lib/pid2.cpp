@@ -33,6 +33,34 @@ pid2::pid2(float p, float i, float d) {
 	kd = d;
 	integral = 0.0f;
 	e1 = 0.0f;
+	integralSat = INTEGRAL_SATURATION;
+	deadband = ERROR_DEADBAND;
+	terms[0] = terms[1] = terms[2] = 0.0f;
+}
+
+/**
+ * @brief Change the gains while running
+ * @param p Proportional gain
+ * @param i Integral gain
+ * @param d Derivative gain
+ *
+ * The error integral and previous error are kept, so there is no bump other
+ * than the one from the new gains themselves.
+ */
+void pid2::setGains(float p, float i, float d) {
+	kp = p;
+	ki = i;
+	kd = d;
+}
+
+/**
+ * @brief Change the integral limit and error deadband
+ * @param sat  Limit of the error integral (default INTEGRAL_SATURATION)
+ * @param band Errors smaller than this are treated as 0 (default ERROR_DEADBAND)
+ */
+void pid2::setLimits(float sat, float band) {
+	integralSat = sat;
+	deadband = band;
 }
 
 /**
@@ -45,7 +73,7 @@ float pid2::calculate(float e, float dt) {
 	/* Rejecting error since it doesn't matter too much if the angle is off by
 	 * a small margin. This should help reject sensor noise.
 	 */
-	if (e > -ERROR_DEADBAND && e < ERROR_DEADBAND) {
+	if (e > -deadband && e < deadband) {
 		e = 0.0f;
 	}
 
@@ -53,14 +81,17 @@ float pid2::calculate(float e, float dt) {
 	 * doesn't dominate the controller output
 	 */
 	integral += e * dt;
-	if (integral > INTEGRAL_SATURATION) integral = INTEGRAL_SATURATION;
-	if (integral < -INTEGRAL_SATURATION) integral = -INTEGRAL_SATURATION;
+	if (integral > integralSat) integral = integralSat;
+	if (integral < -integralSat) integral = -integralSat;
 
 	// Calculate the derivative of the error
 	float derivative = (e - e1) / dt;
 
 	// Calculate the controller output
-	float u = kp*e + ki*integral + kd*derivative;
+	terms[0] = kp*e;
+	terms[1] = ki*integral;
+	terms[2] = kd*derivative;
+	float u = terms[0] + terms[1] + terms[2];
 
 	// Store the error
 	e1 = e;
@@ -68,5 +99,17 @@ float pid2::calculate(float e, float dt) {
 	return u;
 }
 
+/**
+ * @brief Get the terms that made up the last output
+ * @param p Returns the proportional term
+ * @param i Returns the integral term
+ * @param d Returns the derivative term
+ */
+void pid2::getTerms(float *p, float *i, float *d) {
+	*p = terms[0];
+	*i = terms[1];
+	*d = terms[2];
+}
+
 /** @} Close PID group */
 /** @} Close Control Group */
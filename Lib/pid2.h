@@ -21,6 +21,7 @@
 #ifndef PID2_H_
 #define PID2_H_
 
+// Defaults, tunable at runtime with setLimits() (see Params.h)
 #define INTEGRAL_SATURATION 5.0f
 #define ERROR_DEADBAND 1.0f
 
@@ -38,11 +39,18 @@ private:
 	float kd;			///< The derivative gain constant
 	float integral;		///< The error integral
 	float e1;			///< The previous error for calculating the derivative
+	float integralSat;	///< Limit of the error integral
+	float deadband;		///< Errors smaller than this are treated as 0
+	float terms[3];		///< P, I and D terms of the last output
 
 public:
 	pid2(float kp, float ki, float kd);
 
+	void setGains(float kp, float ki, float kd);
+	void setLimits(float integralSat, float deadband);
+
 	float calculate(float e, float dt);
+	void getTerms(float *p, float *i, float *d);
 };
 
 #endif
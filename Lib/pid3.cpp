@@ -0,0 +1,184 @@
+/**
+ * @file
+ *
+ * @brief Class for PID feedback control with anti-windup
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @addtogroup PID
+ *  @{
+ */
+
+#include "pid3.h"
+#include <math.h>
+
+#ifndef PI
+#define PI 3.14159265358979f
+#endif
+
+/**
+ * @brief Construct a pid3 object with the given gains
+ * @param p Proportional gain
+ * @param i Integral gain
+ * @param d Derivative gain
+ *
+ * No feed-forward and no output limits until set.
+ */
+pid3::pid3(float p, float i, float d) {
+	// Initialize members
+	kp = p;
+	ki = i;
+	kd = d;
+	kff = 0.0f;
+	kt = PID_BACK_CALC;
+	outMin = -INFINITY;
+	outMax = INFINITY;
+	setDerivativeCutoff(PID_D_CUTOFF);
+	reset(0.0f);
+}
+
+/**
+ * @brief Change the gains while running
+ * @param p Proportional gain
+ * @param i Integral gain
+ * @param d Derivative gain
+ *
+ * The integral term is kept as is, so a new integral gain only changes how
+ * fast it moves from here on. An integral gain of 0 clears it, since nothing
+ * would move it again.
+ */
+void pid3::setGains(float p, float i, float d) {
+	kp = p;
+	ki = i;
+	kd = d;
+	if (ki == 0.0f) {
+		integral = 0.0f;
+	}
+}
+
+/**
+ * @brief Change the setpoint feed-forward gain
+ * @param ff Output per unit setpoint, 0 for none
+ */
+void pid3::setFeedForward(float ff) {
+	kff = ff;
+}
+
+/**
+ * @brief Change the output limits
+ * @param min Lowest output
+ * @param max Highest output
+ */
+void pid3::setLimits(float min, float max) {
+	outMin = min;
+	outMax = max;
+}
+
+/**
+ * @brief Change the derivative filter cut-off
+ * @param hz Cut-off frequency [Hz], 0 for no filter
+ */
+void pid3::setDerivativeCutoff(float hz) {
+	dTau = (hz > 0.0f) ? 1.0f / (2.0f * PI * hz) : 0.0f;
+}
+
+/**
+ * @brief Change the anti-windup back-calculation gain
+ * @param t Gain [1/s]. 1/t is how long the integral takes to unwind; keep
+ * 			t * dt below 1.
+ */
+void pid3::setBackCalculation(float t) {
+	kt = t;
+}
+
+/**
+ * @brief Clear the controller state
+ * @param y Current measurement, so the next derivative starts from it
+ */
+void pid3::reset(float y) {
+	integral = 0.0f;
+	dTerm = 0.0f;
+	y1 = y;
+	u = 0.0f;
+	dt1 = 0.0f;
+	terms[0] = terms[1] = terms[2] = terms[3] = 0.0f;
+}
+
+/**
+ * @brief Calculate the controller output
+ * @param sp Setpoint
+ * @param y  Measurement
+ * @param dt The sample time [s], above 0
+ * @return The controller output, within the limits
+ */
+float pid3::calculate(float sp, float y, float dt) {
+	float e = sp - y;
+
+	// Derivative of the measurement through a first-order low-pass:
+	// d += (dt / (tau + dt)) * (-kd * dy/dt - d)
+	dTerm += (-kd * (y - y1) - dTerm * dt) / (dTau + dt);
+	y1 = y;
+
+	terms[0] = kp * e;
+	terms[1] = integral;
+	terms[2] = dTerm;
+	terms[3] = kff * sp;
+
+	float v = terms[0] + terms[1] + terms[2] + terms[3];
+	u = fminf(fmaxf(v, outMin), outMax);
+
+	// Integrate the error, and bleed off whatever the limits cut. Without an
+	// integral gain there is nothing to wind up: the bleed alone would build
+	// an offset while saturated that nothing takes away afterwards.
+	if (ki != 0.0f) {
+		integral += (ki * e + kt * (u - v)) * dt;
+	}
+	dt1 = dt;
+
+	return u;
+}
+
+/**
+ * @brief Report what the actuator actually did with the last output
+ * @param applied The part of the last output that was applied
+ *
+ * For saturation after the controller, e.g. the mixer scaling commands down.
+ * The difference is fed back into the integral like the output limits.
+ */
+void pid3::actuated(float applied) {
+	if (ki != 0.0f) {
+		integral += kt * (applied - u) * dt1;
+	}
+	u = applied;
+}
+
+/**
+ * @brief Get the terms that made up the last output
+ * @param p Returns the proportional term
+ * @param i Returns the integral term
+ * @param d Returns the derivative term
+ */
+void pid3::getTerms(float *p, float *i, float *d) {
+	*p = terms[0];
+	*i = terms[1];
+	*d = terms[2];
+}
+
+/**
+ * @brief Get the feed-forward term of the last output
+ * @return Feed-forward term
+ */
+float pid3::getFeedForward(void) {
+	return terms[3];
+}
+
+/** @} Close PID group */
+/** @} Close Control Group */
@@ -0,0 +1,85 @@
+/**
+ * @file
+ *
+ * @brief Class for PID feedback control with anti-windup
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @addtogroup PID
+ *  @{
+ */
+
+#ifndef PID3_H_
+#define PID3_H_
+
+// Defaults, tunable at runtime (see Params.h)
+#define PID_D_CUTOFF	30.0f	///< Derivative filter cut-off [Hz]
+#define PID_BACK_CALC	10.0f	///< Anti-windup back-calculation gain [1/s]
+
+/**
+ * @brief PID with derivative on measurement and back-calculation anti-windup
+ *
+ * Compared to pid2:
+ * 		- The derivative is taken from the measurement, not the error, so a
+ * 		  setpoint step gives no derivative kick, and it goes through a
+ * 		  first-order low-pass so it doesn't amplify sensor noise.
+ * 		- The integral is not clamped. When the output saturates, the
+ * 		  difference between what was asked for and what the actuator did is
+ * 		  fed back into the integral (back-calculation), so it stops growing
+ * 		  exactly when it stops having an effect. The actuator saturation is
+ * 		  the output limits, plus anything reported with actuated().
+ * 		- No deadband, which made the output limit-cycle around zero error.
+ * 		- Optional setpoint feed-forward.
+ *
+ * The integral holds the integral term itself (gain included), so gain
+ * changes don't bump the output. No allocation, and calculate() has no
+ * branches besides the output limits and skipping the integral when its gain
+ * is 0.
+ */
+class pid3 {
+private:
+	float kp;			///< The proportional gain constant
+	float ki;			///< The integral gain constant
+	float kd;			///< The derivative gain constant
+	float kff;			///< The setpoint feed-forward gain
+	float kt;			///< Back-calculation gain [1/s]
+	float dTau;			///< Derivative filter time constant [s]
+	float outMin;		///< Lowest output
+	float outMax;		///< Highest output
+
+	float integral;		///< Integral term
+	float dTerm;		///< Filtered derivative term
+	float y1;			///< The previous measurement for calculating the derivative
+	float u;			///< Last output, after the limits
+	float dt1;			///< Last sample time [s]
+	float terms[4];		///< P, I, D and feed-forward terms of the last output
+
+public:
+	pid3(float kp, float ki, float kd);
+
+	void setGains(float kp, float ki, float kd);
+	void setFeedForward(float kff);
+	void setLimits(float min, float max);
+	void setDerivativeCutoff(float hz);
+	void setBackCalculation(float kt);
+
+	void reset(float y);
+	float calculate(float sp, float y, float dt);
+	void actuated(float applied);
+
+	void getTerms(float *p, float *i, float *d);
+	float getFeedForward(void);
+};
+
+#endif
+
+/** @} Close PID group */
+/** @} Close Control Group */
@@ -21,8 +21,17 @@
 #ifndef PREFILTER_H_
 #define PREFILTER_H_
 
-// Pre-filter time constant
-#define PREFILTER_TAU (150.0f)
+// Pre-filter time constant [s]
+#define PREFILTER_TAU_S (0.75f)
+
+/**
+ * Time constant tau_s [s] as preFilter and preFilter2 take it at a sample
+ * rate fs [Hz]: bilinear transform, so in half sample periods.
+ */
+#define PREFILTER_TAU_AT(tau_s, fs) (2.0f * (tau_s) * (fs))
+
+// Pre-filter time constant for 100 Hz samples (150)
+#define PREFILTER_TAU PREFILTER_TAU_AT(PREFILTER_TAU_S, 100.0f)
 
 /**
  * @brief 1st order low-pass filter
@@ -155,6 +155,13 @@ preFilter3::preFilter3() {
  	arm_biquad_cascade_df2T_init_f32(&f,num_sections,&coef[0],state);
 }
 
+/**
+ * @brief Destroy the filter, releasing the state buffer
+ */
+preFilter3::~preFilter3() {
+	free(state);
+}
+
 /**
  * @brief   Calculate the filter output
  * @param x The current sample input
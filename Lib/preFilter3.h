@@ -42,6 +42,7 @@ private:
 
 public:
 	preFilter3();
+	~preFilter3();
 
 	float32_t filterSample(float32_t *x);
 };
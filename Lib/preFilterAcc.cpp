@@ -61,17 +61,32 @@ preFilterAcc::preFilterAcc() {
 //	int num_sections = 4;
 
 	// Fs = 100 Hz, Fpass = 2 Hz, Fstop = 3 Hz, Apass = 0.1 dB, Astop = -80 dB
+//	static float32_t coef[20] = {
+//		1, -1.95953138525, 1,
+//		1.95144255108, -0.964882197289,
+//		1, -1.92112902732, 1,
+//		1.92640902728, -0.934482799651,
+//		1, -1.48432259432, 1,
+//		1.90586457236, -0.909019680291,
+//		1, -1.96822547213, 1,
+//		1.97290627125, -0.989358918125
+//	};
+//	g = 0.000106468611206;
+//	int num_sections = 4;
+
+	// Fs = 200 Hz, Fpass = 2 Hz, Fstop = 3 Hz, Apass = 0.1 dB, Astop = -80 dB
+	// (the inner loop rate, CONTROL_RATE_HZ)
 	static float32_t coef[20] = {
-		1, -1.95953138525, 1,
-		1.95144255108, -0.964882197289,
-		1, -1.92112902732, 1,
-		1.92640902728, -0.934482799651,
-		1, -1.48432259432, 1,
-		1.90586457236, -0.909019680291,
-		1, -1.96822547213, 1,
-		1.97290627125, -0.989358918125
+		1, -1.98982556714, 1,
+		1.97886614394, -0.982257780648,
+		1, -1.98002560283, 1,
+		1.96462573041, -0.966676926152,
+		1, -1.85755297101, 1,
+		1.95266174823, -0.95346779688,
+		1, -1.99202450372, 1,
+		1.99052519416, -0.994653975147
 	};
-	g = 0.000106468611206;
+	g = 9.91298688922e-05;
 	int num_sections = 4;
 
 	// Fs = 100 Hz, Fpass = 2 Hz, Fstop = 2.5 Hz, Apass = 0.1 dB, Astop = -100 dB
@@ -99,6 +114,13 @@ preFilterAcc::preFilterAcc() {
  	arm_biquad_cascade_df2T_init_f32(&f,num_sections,&coef[0],state);
 }
 
+/**
+ * @brief Destroy the filter, releasing the state buffer
+ */
+preFilterAcc::~preFilterAcc() {
+	free(state);
+}
+
 /**
  * @brief   Calculate the filter output
  * @param x The current sample input
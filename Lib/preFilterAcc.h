@@ -42,6 +42,7 @@ private:
 
 public:
 	preFilterAcc();
+	~preFilterAcc();
 
 	float32_t filterSample(float32_t *x);
 };
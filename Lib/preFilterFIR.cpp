@@ -120,6 +120,13 @@ preFilterFIR::preFilterFIR() {
  	arm_fir_init_f32(&f, num_taps, &coef[0], state, 1);
 }
 
+/**
+ * @brief Destroy the filter, releasing the state buffer
+ */
+preFilterFIR::~preFilterFIR() {
+	free(state);
+}
+
 /**
  * @brief   Calculate the filter output
  * @param x The current sample input
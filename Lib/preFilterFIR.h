@@ -41,6 +41,7 @@ private:
 
 public:
 	preFilterFIR();
+	~preFilterFIR();
 
 	float32_t filterSample(float32_t *x);
 };
@@ -0,0 +1,79 @@
+/**
+ * @file
+ *
+ * @brief Class for FIR filtering raw sensor data in Q15 fixed-point
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @addtogroup PREFILTER
+ *  @{
+ */
+
+#include "preFilterFIRQ15.h"
+
+/**
+ * @brief Construct a preFilterFIRQ15 object
+ * @param c       Float filter coefficients
+ * @param numTaps Number of coefficients
+ * @param block   Max number of samples passed to filterBlock()
+ *
+ * Converts the coefficients to Q15 and initializes the ARM structs.
+ */
+preFilterFIRQ15::preFilterFIRQ15(const float32_t *c, uint16_t numTaps, uint32_t block) {
+	// The Q15 routine needs an even number of taps (>= 4)
+	uint16_t taps = numTaps + (numTaps & 1);
+	if (taps < 4) {
+		taps = 4;
+	}
+	blockSize = (block > 0) ? block : 1;
+
+	// coefficient and state buffers used by arm routine
+	coef = (q15_t *)calloc(taps, sizeof(q15_t));
+	state = (q15_t *)calloc(taps + blockSize, sizeof(q15_t));
+
+	arm_float_to_q15((float32_t *)c, coef, numTaps);
+
+	// arm FIR structure initialization
+	arm_fir_init_q15(&f, taps, coef, state, blockSize);
+}
+
+/**
+ * @brief   Calculate the filter output
+ * @param x The current sample input
+ * @return  The corresponding filter output
+ */
+q15_t preFilterFIRQ15::filterSample(q15_t x) {
+	q15_t y = 0;
+
+	arm_fir_fast_q15(&f, &x, &y, 1);
+
+	return y;
+}
+
+/**
+ * @brief   Filter a block of samples
+ * @param x Input samples
+ * @param y Output samples
+ * @param n Number of samples, at most the block size given at construction
+ *
+ * The fast routine computes two outputs per inner loop iteration, so blocks
+ * of two or more samples are considerably cheaper per sample.
+ */
+void preFilterFIRQ15::filterBlock(q15_t *x, q15_t *y, uint32_t n) {
+	if (n > blockSize) {
+		n = blockSize;
+	}
+
+	arm_fir_fast_q15(&f, x, y, n);
+}
+
+/** @} Close PREFILTER group */
+/** @} Close Control Group */
@@ -0,0 +1,56 @@
+/**
+ * @file
+ *
+ * @brief Class for FIR filtering raw sensor data in Q15 fixed-point
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @addtogroup PREFILTER
+ *  @{
+ */
+
+#ifndef PREFILTERFIRQ15_H_
+#define PREFILTERFIRQ15_H_
+
+#include <stdlib.h>
+#include "stm32f407xx.h"
+#include "arm_math.h"
+
+/**
+ * @brief Arbitrary FIR filter in Q15 fixed-point
+ *
+ * This class implements an arbitrary FIR filter using the ARM CMSIS fast Q15
+ * FIR routine, which computes two taps per dual 16-bit MAC (SMLAD). The
+ * coefficients are given as floats and converted once at construction; an
+ * odd number of taps is padded with a zero since the routine needs an even
+ * count.
+ *
+ * Coefficients smaller than 2^-15 are lost in the conversion, so long,
+ * narrow designs such as the one in preFilterFIR should stay in float.
+ */
+class preFilterFIRQ15 {
+private:
+	arm_fir_instance_q15 f;		///< ARM FIR filter structure
+	q15_t *coef;				///< Q15 coefficients
+	q15_t *state;				///< State buffer used by ARM routine
+	uint32_t blockSize;			///< Max samples per call
+
+public:
+	preFilterFIRQ15(const float32_t *c, uint16_t numTaps, uint32_t block);
+
+	q15_t filterSample(q15_t x);
+	void filterBlock(q15_t *x, q15_t *y, uint32_t n);
+};
+
+#endif
+
+/** @} Close PREFILTER group */
+/** @} Close Control Group */
@@ -107,15 +107,28 @@ preFilterGyro::preFilterGyro() {
 //	int num_sections = 3;
 
 	// Fs = 100 Hz, Fpass = 12.5 Hz, Fstop = 15 Hz, Apass = 0.1 dB, Astop = -40 dB
+//	static float32_t coef[15] = {
+//		1, -0.882441011183, 1,
+//		1.2617494564, -0.708807988091,
+//		1, 0.770732765855, 1,
+//		1.19566959055, -0.410588782579,
+//		1, -1.17828082288, 1,
+//		1.32666260013, -0.925616102885
+//	};
+//	g = 0.0223585778671;
+//	int num_sections = 3;
+
+	// Fs = 200 Hz, Fpass = 12.5 Hz, Fstop = 15 Hz, Apass = 0.1 dB, Astop = -40 dB
+	// (the inner loop rate, CONTROL_RATE_HZ)
 	static float32_t coef[15] = {
-		1, -0.882441011183, 1,
-		1.2617494564, -0.708807988091,
-		1, 0.770732765855, 1,
-		1.19566959055, -0.410588782579,
-		1, -1.17828082288, 1,
-		1.32666260013, -0.925616102885
+		1, -1.67171299109, 1,
+		1.71022092712, -0.833197919132,
+		1, -0.631952192663, 1,
+		1.58706817569, -0.648599546625,
+		1, -1.77493127647, 1,
+		1.79913121367, -0.958726718288
 	};
-	g = 0.0223585778671;
+	g = 0.0118105736583;
 	int num_sections = 3;
 
 	// state buffer used by arm routine of size 2*NUM_SECTIONS
@@ -125,6 +138,13 @@ preFilterGyro::preFilterGyro() {
  	arm_biquad_cascade_df2T_init_f32(&f,num_sections,&coef[0],state);
 }
 
+/**
+ * @brief Destroy the filter, releasing the state buffer
+ */
+preFilterGyro::~preFilterGyro() {
+	free(state);
+}
+
 /**
  * @brief   Calculate the filter output
  * @param x The current sample input
@@ -42,6 +42,7 @@ private:
 
 public:
 	preFilterGyro();
+	~preFilterGyro();
 
 	float32_t filterSample(float32_t *x);
 };
@@ -0,0 +1,115 @@
+/**
+ * @file
+ *
+ * @brief Class for low-pass filtering raw sensor data in Q15 fixed-point
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @addtogroup PREFILTER
+ *  @{
+ */
+
+#include "preFilterQ15.h"
+#include <math.h>
+
+/**
+ * @brief Construct a preFilterQ15 object
+ * @param c           Float coefficients, {b0, b1, b2, a1, a2} per section
+ * @param numSections Number of second order sections
+ * @param g           Overall filter gain factor
+ *
+ * Folds the gain into the numerators, picks the post-shift so every
+ * coefficient fits in Q15, works out the truncation offset and initializes
+ * the ARM structs.
+ */
+preFilterQ15::preFilterQ15(const float32_t *c, int numSections, float32_t g) {
+	// Spread the gain over the sections so no single stage overflows
+	float32_t gs = powf(g, 1.0f / (float32_t)numSections);
+
+	// Find the post-shift needed to bring all coefficients below 1.0
+	float32_t maxCoef = 0.0f;
+	for (int i = 0; i < 5*numSections; i++) {
+		float32_t v = fabsf((i % 5 < 3) ? c[i]*gs : c[i]);
+		if (v > maxCoef) {
+			maxCoef = v;
+		}
+	}
+	int8_t postShift = 0;
+	while (maxCoef >= 1.0f) {
+		maxCoef /= 2.0f;
+		postShift++;
+	}
+	float32_t scale = 1.0f / (float32_t)(1 << postShift);
+
+	// coefficient and state buffers used by arm routine
+	coef = (q15_t *)malloc(sizeof(q15_t)*(6*numSections));
+	state = (q15_t *)malloc(sizeof(q15_t)*(4*numSections));
+
+	for (int s = 0; s < numSections; s++) {
+		float32_t sec[5] = {
+			c[5*s + 0]*gs*scale, c[5*s + 1]*gs*scale, c[5*s + 2]*gs*scale,
+			c[5*s + 3]*scale, c[5*s + 4]*scale
+		};
+
+		// The Q15 routine expects a padding zero after b0 for SIMD alignment
+		arm_float_to_q15(&sec[0], &coef[6*s], 1);
+		coef[6*s + 1] = 0;
+		arm_float_to_q15(&sec[1], &coef[6*s + 2], 4);
+	}
+
+	// Each section output is floored, a mean error of -1/2 LSB that goes
+	// through the section's own feedback and then every following section
+	float32_t truncation = 0.5f * (1.0f - 1.0f / (scale * 32768.0f));
+	float32_t bias = 0.0f;
+	for (int s = 0; s < numSections; s++) {
+		float32_t feedback = 1.0f - c[5*s + 3] - c[5*s + 4];
+		float32_t dcGain = (c[5*s + 0] + c[5*s + 1] + c[5*s + 2]) * gs / feedback;
+
+		bias = bias * dcGain - truncation / feedback;
+	}
+	offset = (q15_t)roundf(bias);
+
+	// arm biquad structure initialization
+	arm_biquad_cascade_df1_init_q15(&f, numSections, coef, state, postShift);
+}
+
+/**
+ * @brief   Calculate the filter output
+ * @param x The current sample input
+ * @return  The corresponding filter output
+ */
+q15_t preFilterQ15::filterSample(q15_t x) {
+	q15_t y = 0;
+
+	arm_biquad_cascade_df1_fast_q15(&f, &x, &y, 1);
+
+	return (q15_t)clip_q31_to_q15((q31_t)y - offset);
+}
+
+/**
+ * @brief   Filter a block of samples
+ * @param x Input samples
+ * @param y Output samples
+ * @param n Number of samples
+ *
+ * Processing a block amortizes the call and state load/store overhead and is
+ * the most efficient way to run the filter.
+ */
+void preFilterQ15::filterBlock(q15_t *x, q15_t *y, uint32_t n) {
+	arm_biquad_cascade_df1_fast_q15(&f, x, y, n);
+
+	for (uint32_t i = 0; i < n; i++) {
+		y[i] = (q15_t)clip_q31_to_q15((q31_t)y[i] - offset);
+	}
+}
+
+/** @} Close PREFILTER group */
+/** @} Close Control Group */
@@ -0,0 +1,67 @@
+/**
+ * @file
+ *
+ * @brief Class for low-pass filtering raw sensor data in Q15 fixed-point
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @addtogroup PREFILTER
+ *  @{
+ */
+
+#ifndef PREFILTERQ15_H_
+#define PREFILTERQ15_H_
+
+#include <stdlib.h>
+#include "stm32f407xx.h"
+#include "arm_math.h"
+
+/**
+ * Bits of headroom taken off the raw 16-bit sample before filtering. The
+ * fast CMSIS Q15 biquad only avoids overflow for inputs in [-0.25, 0.25).
+ */
+#define PREFILTER_Q15_HEADROOM 2
+
+/**
+ * @brief Arbitrary IIR filter in Q15 fixed-point
+ *
+ * This class implements an arbitrary IIR filter using the ARM CMSIS Direct
+ * Form I fast Q15 biquad routine, which uses the dual 16-bit MAC (SMLAD) of
+ * the Cortex-M4. The coefficients are given as floats in the same layout as
+ * preFilterGyro/preFilterAcc and converted once at construction. The gain is
+ * spread evenly over the sections to keep intermediate values in range.
+ *
+ * Raw sensor samples stay integers all the way through the filter; convert
+ * the output to a float only where it is fused.
+ *
+ * The CMSIS routine truncates every section output, which biases the output
+ * low by roughly half an LSB times the DC gain that follows each section
+ * (several LSB for narrow designs). That offset is computed from the design
+ * and removed from the output.
+ */
+class preFilterQ15 {
+private:
+	arm_biquad_casd_df1_inst_q15 f;		///< ARM IIR Direct-Form I filter structure
+	q15_t *coef;						///< Q15 coefficients, {b0, 0, b1, b2, a1, a2} per section
+	q15_t *state;						///< State buffer used by ARM routine
+	q15_t offset;						///< Mean output error of the truncating shifts [LSB]
+
+public:
+	preFilterQ15(const float32_t *c, int numSections, float32_t g);
+
+	q15_t filterSample(q15_t x);
+	void filterBlock(q15_t *x, q15_t *y, uint32_t n);
+};
+
+#endif
+
+/** @} Close PREFILTER group */
+/** @} Close Control Group */
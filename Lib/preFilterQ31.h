@@ -0,0 +1,70 @@
+/**
+ * @file
+ *
+ * @brief Class for low-pass filtering raw sensor data in Q31 fixed-point
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @addtogroup PREFILTER
+ *  @{
+ */
+
+#ifndef PREFILTERQ31_H_
+#define PREFILTERQ31_H_
+
+#include <stdlib.h>
+#include "stm32f407xx.h"
+#include "arm_math.h"
+
+/**
+ * Bits of headroom kept above the raw 16-bit sample when it is widened to
+ * Q31. The fast CMSIS Q31 biquad only avoids overflow for inputs in
+ * [-0.25, 0.25).
+ */
+#define PREFILTER_Q31_HEADROOM 2
+
+/**
+ * @brief Arbitrary IIR filter in Q31 fixed-point
+ *
+ * This class implements an arbitrary IIR filter using the ARM CMSIS Direct
+ * Form I fast Q31 biquad routine. It costs more than preFilterQ15 but keeps
+ * enough coefficient precision for narrow low-pass designs whose poles sit
+ * very close to the unit circle. The coefficients are given as floats in the same layout as
+ * preFilterGyro/preFilterAcc and converted once at construction. The gain is
+ * spread evenly over the sections to keep intermediate values in range.
+ *
+ * Raw sensor samples stay integers all the way through the filter; convert
+ * the output to a float only where it is fused.
+ *
+ * The fast routine keeps only the upper word of each of the five products in
+ * a section, which biases the output low the same way the truncated section
+ * outputs of preFilterQ15 do. For the 200 Hz accelerometer design that is
+ * about 2 raw sensor LSB, so the offset is computed from the design and
+ * removed from the output.
+ */
+class preFilterQ31 {
+private:
+	arm_biquad_casd_df1_inst_q31 f;		///< ARM IIR Direct-Form I filter structure
+	q31_t *coef;						///< Q31 coefficients, {b0, b1, b2, a1, a2} per section
+	q31_t *state;						///< State buffer used by ARM routine
+	q31_t offset;						///< Mean output error of the truncated products [LSB]
+
+public:
+	preFilterQ31(const float32_t *c, int numSections, float32_t g);
+
+	q31_t filterSample(q31_t x);
+	void filterBlock(q31_t *x, q31_t *y, uint32_t n);
+};
+
+#endif
+
+/** @} Close PREFILTER group */
+/** @} Close Control Group */
@@ -0,0 +1,121 @@
+/**
+ * @file
+ *
+ * @brief Class for notch filtering the gyro at the measured motor frequencies
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @addtogroup PREFILTER
+ *  @{
+ */
+
+#include "rpmNotch.h"
+#include <math.h>
+
+/**
+ * @brief Find where a frequency appears after sampling
+ * @param f  Frequency [Hz]
+ * @param fs Sample rate [Hz]
+ * @return Aliased frequency, 0 to fs/2 [Hz]
+ */
+float32_t rpmNotchAlias(float32_t f, float32_t fs) {
+	float32_t a = fmodf(f, fs);
+
+	return (a > 0.5f*fs) ? fs - a : a;
+}
+
+/**
+ * @brief Construct an rpmNotch object
+ * @param sampleRate Rate filterSample() is called at [Hz]
+ * @param motors     Number of motors (1 to RPM_NOTCH_MOTORS)
+ *
+ * All notches start as pass-through until the first update().
+ */
+rpmNotch::rpmNotch(float32_t sampleRate, uint8_t motors) {
+	fs = sampleRate;
+	numMotors = (motors < 1) ? 1 : (motors > RPM_NOTCH_MOTORS) ? RPM_NOTCH_MOTORS : motors;
+	active = 0;
+
+	for (uint8_t i = 0; i < RPM_NOTCH_MOTORS*RPM_NOTCH_HARMONICS; i++) {
+		center[i] = 0.0f;
+		for (uint8_t b = 0; b < 2; b++) {
+			coef[b][5*i + 0] = 1.0f;
+			coef[b][5*i + 1] = 0.0f;
+			coef[b][5*i + 2] = 0.0f;
+			coef[b][5*i + 3] = 0.0f;
+			coef[b][5*i + 4] = 0.0f;
+		}
+	}
+
+	// arm structure initialization
+	arm_biquad_cascade_df2T_init_f32(&f, numMotors*RPM_NOTCH_HARMONICS, coef[active], state);
+}
+
+/**
+ * @brief   Calculate the filter output
+ * @param x The current sample input
+ * @return  The corresponding filter output
+ */
+float32_t rpmNotch::filterSample(float32_t x) {
+	float32_t y = 0.0f;
+
+	arm_biquad_cascade_df2T_f32(&f, &x, &y, 1);
+
+	return y;
+}
+
+/**
+ * @brief Move the notches to new motor speeds
+ * @param rpm Mechanical RPM per motor, 0 if unknown
+ *
+ * Call from the background part of the loop whenever new telemetry arrived.
+ */
+void rpmNotch::update(const float *rpm) {
+	uint8_t next = active ^ 1;
+
+	for (uint8_t m = 0; m < numMotors; m++) {
+		for (uint8_t h = 0; h < RPM_NOTCH_HARMONICS; h++) {
+			uint8_t i = m*RPM_NOTCH_HARMONICS + h;
+			float32_t *c = &coef[next][5*i];
+			float32_t fc = rpmNotchAlias(rpm[m] / 60.0f * (float32_t)(h + 1), fs);
+
+			if (rpm[m] > 0.0f && fc > RPM_NOTCH_MIN_HZ && fc < 0.5f*fs - RPM_NOTCH_MIN_HZ) {
+				center[i] = fc;
+				dynNotchCoefficients(fc, RPM_NOTCH_Q, fs, c);
+			} else {
+				center[i] = 0.0f;
+				c[0] = 1.0f;
+				c[1] = c[2] = c[3] = c[4] = 0.0f;
+			}
+		}
+	}
+
+	// Switch to the new set with one store
+	f.pCoeffs = coef[next];
+	active = next;
+}
+
+/**
+ * @brief  Get a notch center frequency
+ * @param motor    Motor index
+ * @param harmonic Harmonic index, 0 for the fundamental
+ * @return Center frequency [Hz], 0 if the notch is off
+ */
+float32_t rpmNotch::getCenter(uint8_t motor, uint8_t harmonic) {
+	if (motor >= numMotors || harmonic >= RPM_NOTCH_HARMONICS) {
+		return 0.0f;
+	}
+
+	return center[motor*RPM_NOTCH_HARMONICS + harmonic];
+}
+
+/** @} Close PREFILTER group */
+/** @} Close Control Group */
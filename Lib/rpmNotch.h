@@ -0,0 +1,69 @@
+/**
+ * @file
+ *
+ * @brief Class for notch filtering the gyro at the measured motor frequencies
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @addtogroup PREFILTER
+ *  @{
+ */
+
+#ifndef RPMNOTCH_H_
+#define RPMNOTCH_H_
+
+#include <stdint.h>
+#include "stm32f407xx.h"
+#include "arm_math.h"
+#include "dynamicNotch.h"
+
+#define RPM_NOTCH_MOTORS	8		///< Most motors tracked
+#define RPM_NOTCH_HARMONICS	2		///< Notches per motor (fundamental, 2nd, ...)
+#define RPM_NOTCH_Q			5.0f	///< Notch quality factor
+#define RPM_NOTCH_MIN_HZ	8.0f	///< Notches closer than this to DC or Nyquist are off [Hz]
+
+float32_t rpmNotchAlias(float32_t f, float32_t fs);
+
+/**
+ * @brief Notch filter bank placed from motor RPM telemetry
+ *
+ * One notch per motor and harmonic at rpm / 60 * h. Frequencies above the
+ * Nyquist rate are folded to where they alias, since that is where the
+ * vibration appears in the sampled gyro signal. Notches that land near DC or
+ * Nyquist are set to pass-through so they can't eat the rate signal.
+ *
+ * filterSample() runs in the control loop. update() computes coefficients
+ * into the inactive half of a double buffer and switches with one pointer
+ * store, like dynamicNotch.
+ */
+class rpmNotch {
+private:
+	arm_biquad_cascade_df2T_instance_f32 f;		///< ARM IIR Direct-Form II Transpose filter structure
+	float32_t coef[2][5*RPM_NOTCH_MOTORS*RPM_NOTCH_HARMONICS];	///< Double-buffered notch coefficients
+	uint8_t active;								///< Index of the coefficient set in use
+	float32_t state[2*RPM_NOTCH_MOTORS*RPM_NOTCH_HARMONICS];	///< State buffer used by ARM routine
+
+	float32_t fs;								///< Sample rate [Hz]
+	uint8_t numMotors;							///< Motors tracked
+	float32_t center[RPM_NOTCH_MOTORS*RPM_NOTCH_HARMONICS];	///< Notch centers [Hz], 0 if off
+
+public:
+	rpmNotch(float32_t sampleRate, uint8_t motors);
+
+	float32_t filterSample(float32_t x);
+	void update(const float *rpm);
+	float32_t getCenter(uint8_t motor, uint8_t harmonic);
+};
+
+#endif
+
+/** @} Close PREFILTER group */
+/** @} Close Control Group */
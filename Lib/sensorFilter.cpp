@@ -0,0 +1,198 @@
+/**
+ * @file
+ *
+ * @brief Runtime-selectable wrapper around the pre-filter variants
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @addtogroup PREFILTER
+ *  @{
+ */
+
+#include "sensorFilter.h"
+#include "CycleCounter.h"
+#include <new>
+#include <math.h>
+#include "stm32f407xx.h"
+
+/**
+ * @brief Every design sensorFilter can build, indexed by filterDesign
+ */
+const filterDesignInfo filterRegistry[FILTER_NUM_DESIGNS] = {
+	{ filterDesign::NONE,		"none"		},
+	{ filterDesign::LPF1,		"lpf1"		},
+	{ filterDesign::LPF2,		"lpf2"		},
+	{ filterDesign::IIR,		"iir"		},
+	{ filterDesign::IIR_ACC,	"iir_acc"	},
+	{ filterDesign::IIR_GYRO,	"iir_gyro"	},
+	{ filterDesign::FIR,		"fir"		},
+	{ filterDesign::ACC_COMP,	"acc_comp"	},
+	{ filterDesign::ACC_COMP2,	"acc_comp2"	},
+	{ filterDesign::GYRO_COMP,	"gyro_comp"	},
+	{ filterDesign::GYRO_COMP2,	"gyro_comp2"}
+};
+
+/**
+ * @brief Convert a stored parameter to a filter design
+ * @param index    Registry index, e.g. read from the parameter store
+ * @param fallback Design to use if the index is not registered
+ * @return The design to construct
+ */
+filterDesign filterDesignFromIndex(uint8_t index, filterDesign fallback) {
+	if (index >= FILTER_NUM_DESIGNS) {
+		return fallback;
+	}
+
+	return filterRegistry[index].design;
+}
+
+/**
+ * @brief Get the registry name of a design
+ * @param d Filter design
+ * @return Short name of the design
+ */
+const char *filterDesignName(filterDesign d) {
+	if ((int)d < 0 || (int)d >= FILTER_NUM_DESIGNS) {
+		return "?";
+	}
+
+	return filterRegistry[(int)d].name;
+}
+
+/**
+ * @brief Construct the selected filter in place
+ * @param d   Filter design
+ * @param tau Time constant for the designs that take one
+ */
+sensorFilter::sensorFilter(filterDesign d, float tau) {
+	design = d;
+
+	switch (design) {
+	case filterDesign::LPF1:		new (&v.lpf1) preFilter(tau);				break;
+	case filterDesign::LPF2:		new (&v.lpf2) preFilter2(tau);				break;
+	case filterDesign::IIR:			new (&v.iir) preFilter3();					break;
+	case filterDesign::IIR_ACC:		new (&v.iirAcc) preFilterAcc();				break;
+	case filterDesign::IIR_GYRO:	new (&v.iirGyro) preFilterGyro();			break;
+	case filterDesign::FIR:			new (&v.fir) preFilterFIR();				break;
+	case filterDesign::ACC_COMP:	new (&v.accComp) accelCompFilter(tau);		break;
+	case filterDesign::ACC_COMP2:	new (&v.accComp2) accelCompFilter2(tau);	break;
+	case filterDesign::GYRO_COMP:	new (&v.gyroComp) gyroCompFilter(tau);		break;
+	case filterDesign::GYRO_COMP2:	new (&v.gyroComp2) gyroCompFilter2(tau);	break;
+	case filterDesign::NONE:
+	default:
+		design = filterDesign::NONE;
+		break;
+	}
+}
+
+/**
+ * @brief Destroy the selected filter, releasing its state buffer
+ */
+sensorFilter::~sensorFilter() {
+	switch (design) {
+	case filterDesign::IIR:			v.iir.~preFilter3();		break;
+	case filterDesign::IIR_ACC:		v.iirAcc.~preFilterAcc();	break;
+	case filterDesign::IIR_GYRO:	v.iirGyro.~preFilterGyro();	break;
+	case filterDesign::FIR:			v.fir.~preFilterFIR();		break;
+	default:						break;	// trivially destructible
+	}
+}
+
+/**
+ * @brief   Calculate the filter output
+ * @param x The current sample input
+ * @return  The corresponding filter output
+ */
+float sensorFilter::filterSample(float x) {
+	switch (design) {
+	case filterDesign::LPF1:		return v.lpf1.filterSample(&x);
+	case filterDesign::LPF2:		return v.lpf2.filterSample(&x);
+	case filterDesign::IIR:			return v.iir.filterSample(&x);
+	case filterDesign::IIR_ACC:		return v.iirAcc.filterSample(&x);
+	case filterDesign::IIR_GYRO:	return v.iirGyro.filterSample(&x);
+	case filterDesign::FIR:			return v.fir.filterSample(&x);
+	case filterDesign::ACC_COMP:	return v.accComp.filterSample(x);
+	case filterDesign::ACC_COMP2:	return v.accComp2.filterSample(x);
+	case filterDesign::GYRO_COMP:	return v.gyroComp.filterSample(x);
+	case filterDesign::GYRO_COMP2:	return v.gyroComp2.filterSample(x);
+	case filterDesign::NONE:
+	default:						return x;
+	}
+}
+
+/**
+ * @brief  Get the selected design
+ * @return Filter design
+ */
+filterDesign sensorFilter::getDesign(void) {
+	return design;
+}
+
+/**
+ * @brief  Get the registry name of the selected design
+ * @return Short name of the design
+ */
+const char *sensorFilter::getName(void) {
+	return filterDesignName(design);
+}
+
+/**
+ * @brief Read the DWT cycle counter, enabling it on first use
+ * @return CPU cycle count
+ *
+ * The clock to pass to filterSweep() on the target.
+ */
+uint32_t filterCycleClock(void) {
+	cycleCounterInit();
+
+	return DWT->CYCCNT;
+}
+
+/**
+ * @brief Run every registered design over the same recorded data
+ * @param x       Recorded input samples
+ * @param n       Number of samples
+ * @param tau     Time constant for the designs that take one
+ * @param clock   Counter to time the designs with, filterCycleClock() on the target
+ * @param results [out] One entry per registered design
+ * @return Number of results written (FILTER_NUM_DESIGNS)
+ *
+ * Each design starts from a fresh state, so the results can be compared
+ * directly. The host benchmark (tests/bench_filters.cpp) runs this with a
+ * nanosecond clock.
+ */
+uint8_t filterSweep(const float *x, uint32_t n, float tau, filterClock clock, filterSweepResult *results) {
+	for (uint8_t i = 0; i < FILTER_NUM_DESIGNS; i++) {
+		sensorFilter f(filterRegistry[i].design, tau);
+		float sumSq = 0.0f;
+		float sumDiffSq = 0.0f;
+		uint32_t cycles = 0;
+
+		for (uint32_t k = 0; k < n; k++) {
+			uint32_t start = clock();
+			float y = f.filterSample(x[k]);
+			cycles += clock() - start;
+
+			sumSq += y*y;
+			sumDiffSq += (y - x[k])*(y - x[k]);
+		}
+
+		results[i].design = filterRegistry[i].design;
+		results[i].cycles = cycles;
+		results[i].rms = (n > 0) ? sqrtf(sumSq / (float)n) : 0.0f;
+		results[i].rmsDiff = (n > 0) ? sqrtf(sumDiffSq / (float)n) : 0.0f;
+	}
+
+	return FILTER_NUM_DESIGNS;
+}
+
+/** @} Close PREFILTER group */
+/** @} Close Control Group */
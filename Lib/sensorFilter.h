@@ -0,0 +1,137 @@
+/**
+ * @file
+ *
+ * @brief Runtime-selectable wrapper around the pre-filter variants
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+/** @addtogroup Control
+ *  @{
+ */
+
+/** @addtogroup PREFILTER
+ *  @{
+ */
+
+#ifndef SENSORFILTER_H_
+#define SENSORFILTER_H_
+
+#include <stdint.h>
+
+#include "preFilter.h"
+#include "preFilter2.h"
+#include "preFilter3.h"
+#include "preFilterAcc.h"
+#include "preFilterGyro.h"
+#include "preFilterFIR.h"
+#include "accelCompFilter.h"
+#include "accelCompFilter2.h"
+#include "gyroCompFilter.h"
+#include "gyroCompFilter2.h"
+
+/**
+ * @brief Filter designs available to sensorFilter
+ *
+ * The numeric values are the registry indices and may be stored as a
+ * parameter, so only append new designs at the end.
+ */
+enum class filterDesign {
+	NONE		= 0,	//!< Pass-through
+	LPF1		= 1,	//!< 1st order low-pass (preFilter)
+	LPF2		= 2,	//!< 2nd order low-pass (preFilter2)
+	IIR			= 3,	//!< Generic IIR design (preFilter3)
+	IIR_ACC		= 4,	//!< Accelerometer IIR design (preFilterAcc)
+	IIR_GYRO	= 5,	//!< Gyro IIR design (preFilterGyro)
+	FIR			= 6,	//!< 761-tap FIR design (preFilterFIR)
+	ACC_COMP	= 7,	//!< 1st order complementary low-pass (accelCompFilter)
+	ACC_COMP2	= 8,	//!< 2nd order complementary low-pass (accelCompFilter2)
+	GYRO_COMP	= 9,	//!< 1st order complementary high-pass (gyroCompFilter)
+	GYRO_COMP2	= 10	//!< 2nd order complementary high-pass (gyroCompFilter2)
+};
+
+#define FILTER_NUM_DESIGNS 11
+
+/**
+ * @brief Registry entry describing one filter design
+ */
+typedef struct {
+	filterDesign design;	///< Design identifier
+	const char *name;		///< Short name for logs and benchmark output
+} filterDesignInfo;
+
+/**
+ * @brief Result of running one design over a recorded data set
+ */
+typedef struct {
+	filterDesign design;	///< Design identifier
+	uint32_t cycles;		///< Total clock ticks spent filtering (CPU cycles with filterCycleClock)
+	float rms;				///< RMS of the filter output
+	float rmsDiff;			///< RMS of the difference between output and input
+} filterSweepResult;
+
+extern const filterDesignInfo filterRegistry[FILTER_NUM_DESIGNS];
+
+filterDesign filterDesignFromIndex(uint8_t index, filterDesign fallback);
+const char *filterDesignName(filterDesign d);
+
+/**
+ * @brief Single-input filter whose design is chosen at construction
+ *
+ * Holds exactly one of the pre-filter classes in a tagged union and
+ * dispatches with a switch, so there are no virtual calls and no heap
+ * allocation beyond what the selected filter itself does. Designs that are
+ * not selected cost nothing; in particular the FIR state is only allocated
+ * when FIR is chosen.
+ *
+ * The tau parameter is used by the first order, second order and
+ * complementary designs; the IIR/FIR designs carry their own coefficients.
+ */
+class sensorFilter {
+private:
+	filterDesign design;			///< Selected design
+
+	/// Storage for the selected filter, only the member matching design is live
+	union filterVariant {
+		preFilter lpf1;
+		preFilter2 lpf2;
+		preFilter3 iir;
+		preFilterAcc iirAcc;
+		preFilterGyro iirGyro;
+		preFilterFIR fir;
+		accelCompFilter accComp;
+		accelCompFilter2 accComp2;
+		gyroCompFilter gyroComp;
+		gyroCompFilter2 gyroComp2;
+
+		filterVariant() {}
+		~filterVariant() {}
+	} v;
+
+	sensorFilter(const sensorFilter &);				// non-copyable, the
+	sensorFilter &operator=(const sensorFilter &);	// variants own buffers
+
+public:
+	sensorFilter(filterDesign d, float tau);
+	~sensorFilter();
+
+	float filterSample(float x);
+	filterDesign getDesign(void);
+	const char *getName(void);
+};
+
+/**
+ * @brief Free-running counter used to time filterSweep()
+ */
+typedef uint32_t (*filterClock)(void);
+
+uint32_t filterCycleClock(void);
+uint8_t filterSweep(const float *x, uint32_t n, float tau, filterClock clock, filterSweepResult *results);
+
+#endif
+
+/** @} Close PREFILTER group */
+/** @} Close Control Group */
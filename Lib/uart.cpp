@@ -41,18 +41,27 @@
 #include <string.h>
 
 #include "uart.h"
+#include "config.h"
 #include "errDC9000.h"
+#include "EscTelemetry.h"
+#include "TxQueue.h"
 
-static __IO ITStatus UartReady = RESET;
+static TxQueue txQueue;
+static volatile bool txBusy = false;
 static DMA_HandleTypeDef hdma_tx;
 static DMA_HandleTypeDef hdma_rx;
-static volatile int8_t validRx = -1;
-static volatile bool dataRead = false;
-
-static volatile uint8_t DmaBuff[2*TRANSFER_SIZE] = {0};
-static volatile uint8_t readBuffPing[TRANSFER_SIZE] = {0};
-static volatile uint8_t readBuffPong[TRANSFER_SIZE] = {0};
-static volatile bool pingPongBar = true;		// true means ping can be read - write to pong
+static volatile uint8_t DmaBuff[RX_BUFF_SIZE] = {0};
+static uint16_t rxPos = 0;						// Next DmaBuff byte to parse
+static UplinkMsg rxMsgs[UPLINK_QUEUE_LEN];		// Received messages
+static volatile uint8_t rxHead = 0;				// Messages queued (free-running)
+static volatile uint8_t rxTail = 0;				// Messages read (free-running)
+#ifdef UPLINK_LEGACY
+static RcParser rcParser;
+static uint8_t legacySeq = 0;
+static bool legacyArmed = false;
+#else
+static UplinkDecoder uplinkDecoder;
+#endif
 
 /*
  * Locking Macros
@@ -133,9 +142,14 @@ void USART6_IRQHandler(void);
  *  handles GPIO initialization and configures the desired U(S)ART port.
  *
  *  Once the UART has been initialized, it is ready to send data using the
- *  usart_transmit() function. To receive data, the usart_receive_begin()
- *  function must be called, then usart_read() will return a pointer to a
- *  buffer containing received data.
+ *  usart_transmit() or usart_queue() functions. Sent data is copied into (or,
+ *  with usart_tx_reserve()/usart_tx_commit(), built in) a TX queue that owns
+ *  the memory, and HAL_UART_TxCpltCallback() starts the next DMA transfer, so
+ *  callers never wait for the UART. The queue has a single producer, so these
+ *  may only be called from the main loop; interrupts and the fault path
+ *  (Error_Handler()) write with the blocking usart_write_raw(). To receive data, the usart_receive_begin()
+ *  function must be called, then usart_read_msg() will return each uplink
+ *  message in the order it arrived.
  *
  *  @{
  */
@@ -243,7 +257,7 @@ void init_USART(int uart_num, int num_args, ...)
 	}
 
 	// The UART peripheral is now ready to transmit
-	UartReady = SET;
+	txBusy = false;
 }
 
 /** @} Close UART_Functions_Init group */
@@ -253,57 +267,289 @@ void init_USART(int uart_num, int num_args, ...)
  *  @{
  */
 
+/**
+ * @brief Start the next queued transfer if the UART is idle
+ *
+ * @note Called with interrupts disabled or from the TX complete interrupt
+ */
+static void usart_tx_kick(void)
+{
+	const uint8_t *p;
+	uint16_t len;
+
+	if (txBusy) {
+		return;
+	}
+
+	p = txQueue.take(&len);
+	if (p == NULL) {
+		return;
+	}
+	txBusy = true;
+
+	if (HAL_UART_Transmit_DMA(&UartHandle, (uint8_t *)p, len) != HAL_OK)
+	{
+		Error_Handler(errDC9000::UART_IO_ERROR);
+	}
+}
+
+/**
+ * @brief Kick the TX queue from thread context
+ */
+static void usart_tx_start(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	usart_tx_kick();
+	__set_PRIMASK(primask);
+}
+
 /**
  * @brief Send (TX) a string via the U(S)ART
  *
+ * The string is copied into the TX queue, so s may be reused on return.
+ *
  * @note init_USART() should be called first
- * @note Calls Error_Handler() on error
+ * @note Never waits; the string is dropped if the queue is full
  *
  * @param s The string to send
  */
 void usart_transmit(uint8_t *s)
 {
-	uint16_t len;
+	usart_queue(s, strlen((char *)s));
+}
 
-	while (UartReady != SET);
-	UartReady = RESET;
+/**
+ * @brief Send (TX) a buffer via the U(S)ART
+ *
+ * @note init_USART() should be called first
+ * @note Never waits
+ *
+ * @param buf Bytes to send, copied into the TX queue
+ * @param len Number of bytes
+ * @return false if the queue is full and the buffer was dropped
+ */
+bool usart_queue(const uint8_t *buf, uint16_t len)
+{
+	if (!txQueue.push(buf, len)) {
+		return false;
+	}
 
-	len = strlen((char *)s);
+	usart_tx_start();
+	return true;
+}
 
-	if (HAL_UART_Transmit_DMA(&UartHandle, s, len) != HAL_OK)
-	{
-		Error_Handler(errDC9000::UART_IO_ERROR);
+/**
+ * @brief Reserve TX queue space to build a frame in place (zero-copy)
+ *
+ * @note Must be followed by usart_tx_commit()
+ *
+ * @param len Largest size the frame may have
+ * @return Where to write the frame, NULL if the queue is full
+ */
+uint8_t* usart_tx_reserve(uint16_t len)
+{
+	return txQueue.reserve(len);
+}
+
+/**
+ * @brief Send the frame built after usart_tx_reserve()
+ * @param len Bytes actually written, at most the reserved size
+ */
+void usart_tx_commit(uint16_t len)
+{
+	txQueue.commit(len);
+	usart_tx_start();
+}
+
+/**
+ * @brief Write bytes directly to the U(S)ART, bypassing the TX queue
+ *
+ * For the fault path and interrupt context, where the queue can't be used:
+ * the main loop may be halfway through a push or an open reservation. Lets
+ * the DMA transfer in flight finish, stops the DMA from starting the next
+ * one, then writes by polling. Waits at most UART_RAW_TIMEOUT polls per byte.
+ *
+ * @note Leaves the TX DMA disabled; only meant for messages before a halt
+ *
+ * @param buf Bytes to send
+ * @param len Number of bytes
+ */
+void usart_write_raw(const uint8_t *buf, uint16_t len)
+{
+	USART_TypeDef *u = UartHandle.Instance;
+	uint32_t n;
+
+	if (u == NULL || (u->CR1 & USART_CR1_UE) == 0) {
+		return;
+	}
+
+	if (UartHandle.hdmatx != NULL && UartHandle.hdmatx->Instance != NULL) {
+		n = UART_RAW_TIMEOUT * len;
+		while ((UartHandle.hdmatx->Instance->CR & DMA_SxCR_EN) && UartHandle.hdmatx->Instance->NDTR > 0 && --n > 0) {}
+	}
+	u->CR3 &= ~USART_CR3_DMAT;
+
+	for (uint16_t i = 0; i < len; i++) {
+		n = UART_RAW_TIMEOUT;
+		while ((u->SR & USART_SR_TXE) == 0 && --n > 0) {}
+		u->DR = buf[i];
 	}
+
+	n = UART_RAW_TIMEOUT;
+	while ((u->SR & USART_SR_TC) == 0 && --n > 0) {}
+}
+
+/**
+ * @brief Stop the TX DMA transfer in flight, dropping the rest of it
+ *
+ * For the fault path, so usart_write_raw() doesn't wait for a queued frame to
+ * drain. The stream's interrupts are masked first, so the completion callback
+ * can't start the next queued transfer. Waits at most UART_RAW_TIMEOUT polls
+ * for the stream to stop.
+ *
+ * @note Leaves the TX DMA disabled; only meant for messages before a halt
+ */
+void usart_tx_abort(void)
+{
+	USART_TypeDef *u = UartHandle.Instance;
+	uint32_t n = UART_RAW_TIMEOUT;
+
+	if (u == NULL || UartHandle.hdmatx == NULL || UartHandle.hdmatx->Instance == NULL) {
+		return;
+	}
+
+	DMA_Stream_TypeDef *stream = UartHandle.hdmatx->Instance;
+	stream->CR &= ~(DMA_SxCR_TCIE | DMA_SxCR_HTIE | DMA_SxCR_TEIE | DMA_SxCR_DMEIE);
+	u->CR3 &= ~USART_CR3_DMAT;
+	stream->CR &= ~DMA_SxCR_EN;
+	while ((stream->CR & DMA_SxCR_EN) && --n > 0) {}
+}
+
+/**
+ * @brief Check whether everything queued has been sent
+ * @return true if the TX queue is empty
+ */
+bool usart_tx_idle(void)
+{
+	return txQueue.empty();
+}
+
+/**
+ * @brief Get the number of bytes queued and not yet sent
+ * @return Bytes waiting in the TX queue
+ */
+uint16_t usart_tx_pending(void)
+{
+	return txQueue.pending();
+}
+
+/**
+ * @brief Get the number of TX frames dropped on a full queue
+ * @return Dropped frame count
+ */
+uint32_t usart_tx_dropped(void)
+{
+	return txQueue.getDropped();
 }
 
 /**
  * @brief Start receiving data (RX) using DMA
  *
- * Data is received using DMA in circular mode. Software double buffering is used to
- * avoid race conditions when trying to simultaneously read/write from/to the buffer.
+ * Data is received using DMA in circular mode. New bytes are handed to the
+ * uplink decoder when the line goes idle after a message, and on the DMA
+ * half/full interrupts so a long burst can't overrun the buffer.
  *
- * @note init_USART() should be called first. This must be called before usart_read()
+ * @note init_USART() should be called first. This must be called before usart_read_msg()
  * @note Calls Error_Handler() on error
  */
 void usart_receive_begin() {
-	if (HAL_UART_Receive_DMA(&UartHandle, (uint8_t *)DmaBuff, 2*TRANSFER_SIZE)) {
+	rxPos = 0;
+	if (HAL_UART_Receive_DMA(&UartHandle, (uint8_t *)DmaBuff, RX_BUFF_SIZE)) {
 		Error_Handler(errDC9000::UART_INIT_ERROR);
 	}
+
+	__HAL_UART_CLEAR_IDLEFLAG(&UartHandle);
+	__HAL_UART_ENABLE_IT(&UartHandle, UART_IT_IDLE);
 }
 
 /**
- * @brief Retrieve a string that has been read
+ * @brief Retrieve the oldest unread uplink message
  *
- * @note init_USART() and usart_receive_being() should be called first
+ * @note init_USART() and usart_receive_begin() should be called first
  *
- * @return A pointer to a buffer containing the read string/data
+ * @param msg Returns the message, with the time it was received
+ * @return false if there are no unread messages
  */
-uint8_t* usart_read(void) {
-	if (dataRead == true || validRx < 0) {
-		return NULL;
-	} else {
-		dataRead = true;
-		return pingPongBar == true ? (uint8_t *)readBuffPing : (uint8_t *)readBuffPong;
+bool usart_read_msg(UplinkMsg *msg) {
+	if (rxTail == rxHead) {
+		return false;
+	}
+
+	*msg = rxMsgs[rxTail & (UPLINK_QUEUE_LEN - 1)];
+	rxTail = rxTail + 1;
+	return true;
+}
+
+/**
+ * @brief Get the uplink receive counters
+ * @param s Returns the counters
+ */
+void usart_uplink_stats(UplinkStats *s) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+#ifdef UPLINK_LEGACY
+	s->received = rcParser.getPackets();
+	s->lost = 0;
+	s->errors = rcParser.getErrors();
+#else
+	uplinkDecoder.getStats(s);
+#endif
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Queue a received message for usart_read_msg()
+ * @param msg Message, dropped if the queue is full
+ */
+static void usart_rx_queue(const UplinkMsg *msg) {
+	if ((uint8_t)(rxHead - rxTail) >= UPLINK_QUEUE_LEN) {
+		return;
+	}
+
+	rxMsgs[rxHead & (UPLINK_QUEUE_LEN - 1)] = *msg;
+	rxHead = rxHead + 1;		// Publish last
+}
+
+/**
+ * @brief Decode every byte the RX DMA has written since the last call
+ *
+ * @note Called from the UART and RX DMA interrupts
+ */
+static void usart_rx_process(void) {
+	uint16_t pos = (RX_BUFF_SIZE - __HAL_DMA_GET_COUNTER(UartHandle.hdmarx)) % RX_BUFF_SIZE;
+	uint32_t now = HAL_GetTick();
+
+	while (rxPos != pos) {
+		uint8_t b = DmaBuff[rxPos];
+		rxPos = (rxPos + 1) % RX_BUFF_SIZE;
+
+#ifdef UPLINK_LEGACY
+		if (rcParser.feed(b, now)) {
+			RcPacket pkt;
+			UplinkMsg msgs[2];
+
+			rcParser.read(&pkt);
+			uint8_t n = uplinkFromLegacy(&pkt, &legacySeq, &legacyArmed, msgs);
+			for (uint8_t i = 0; i < n; i++) {
+				usart_rx_queue(&msgs[i]);
+			}
+		}
+#else
+		if (uplinkDecoder.feed(b, now)) {
+			usart_rx_queue(uplinkDecoder.getMsg());
+		}
+#endif
 	}
 }
 
@@ -616,7 +862,7 @@ void USART3MspInit()
 
 /**
  * @brief Helper function. MspInit routine for UART4
- * @note Calls Error_Handler() on error
+ * @note Calls Error_Handler() on error, also if DShot holds one of its DMA streams
  */
 void UART4MspInit()
 {
@@ -658,7 +904,7 @@ void UART4MspInit()
 	hdma_tx.Init.MemBurst            = DMA_MBURST_INC4;
 	hdma_tx.Init.PeriphBurst         = DMA_PBURST_INC4;
 
-	if ( HAL_DMA_Init(&hdma_tx) != HAL_OK ) {
+	if ( dmaStreamInUse(&hdma_tx) || HAL_DMA_Init(&hdma_tx) != HAL_OK ) {
 		Error_Handler(errDC9000::UART_INIT_ERROR);
 	}
 
@@ -681,7 +927,7 @@ void UART4MspInit()
 	hdma_rx.Init.MemBurst            = DMA_MBURST_INC4;
 	hdma_rx.Init.PeriphBurst         = DMA_PBURST_INC4;
 
-	if ( HAL_DMA_Init(&hdma_rx) != HAL_OK ) {
+	if ( dmaStreamInUse(&hdma_rx) || HAL_DMA_Init(&hdma_rx) != HAL_OK ) {
 		Error_Handler(errDC9000::UART_INIT_ERROR);
 	}
 
@@ -704,7 +950,7 @@ void UART4MspInit()
 
 /**
  * @brief Helper function. MspInit routine for UART5
- * @note Calls Error_Handler() on error
+ * @note Calls Error_Handler() on error, also if DShot holds one of its DMA streams
  */
 void UART5MspInit()
 {
@@ -746,7 +992,7 @@ void UART5MspInit()
 	hdma_tx.Init.MemBurst            = DMA_MBURST_INC4;
 	hdma_tx.Init.PeriphBurst         = DMA_PBURST_INC4;
 
-	if ( HAL_DMA_Init(&hdma_tx) != HAL_OK ) {
+	if ( dmaStreamInUse(&hdma_tx) || HAL_DMA_Init(&hdma_tx) != HAL_OK ) {
 		Error_Handler(errDC9000::UART_INIT_ERROR);
 	}
 
@@ -769,7 +1015,7 @@ void UART5MspInit()
 	hdma_rx.Init.MemBurst            = DMA_MBURST_INC4;
 	hdma_rx.Init.PeriphBurst         = DMA_PBURST_INC4;
 
-	if ( HAL_DMA_Init(&hdma_rx) != HAL_OK ) {
+	if ( dmaStreamInUse(&hdma_rx) || HAL_DMA_Init(&hdma_rx) != HAL_OK ) {
 		Error_Handler(errDC9000::UART_INIT_ERROR);
 	}
 
@@ -1101,86 +1347,41 @@ void USART6MspDeInit()
  * @brief UART TX Complete callback
  *
  * This function is called from within the appropriate DMAx_Streamy_IRQHandler()
- * when the DMA transfer is complete - i.e., when all the bytes in s have been
- * sent after usart_transmit() is caled.
+ * when the DMA transfer is complete. Frees the sent frames and immediately
+ * starts the next queued transfer.
  *
  * @param huart Pointer to UartHandle
  */
 void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
 {
-	UartReady = SET;
+	txQueue.release();
+	txBusy = false;
+	usart_tx_kick();
 }
 
 /**
  * @brief UART RX Half Complete callback
  *
  * This function is called from within the appropriate DMAx_Streamy_IRQHandler()
- * when the DMA transfer is half complete - i.e., when a single "remote control"
- * buffer has been received.
+ * when the first half of the circular RX buffer has been written.
  *
  * @param huart Pointer to UartHandle
  */
 void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef *huart) {
-//	_GET_LOCK_NORETURN(rxLock);
-	validRx = 0;
-//	_UNLOCK(rxLock);
-
-	// False means Pong can be read, so write to Ping
-	if (pingPongBar == false) {
-		// Copy first half of DmaBuff to readPing
-		for (int i = 0; i < TRANSFER_SIZE; i++) {
-			readBuffPing[i] = DmaBuff[i];
-		}
-		// Switch buffers
-		pingPongBar = true;
-	} else {	// True means Ping can be read, so write to Pong
-		// Copy first half of DmaBuff to readPong
-		for (int i = 0; i < TRANSFER_SIZE; i++) {
-			readBuffPong[i] = DmaBuff[i];
-		}
-		// Switch buffers
-		pingPongBar = false;
-	}
-
-	// Have new data that hasn't been read
-	dataRead = false;
+	usart_rx_process();
 }
 
 /**
  * @brief UART RX Complete Callback
  *
  * This function is caled from within the appropriate DMAx_Streamy_IRQHandler()
- * when the DMA transfer is complete - i.e., when a second "remote control"
- * buffer has been received.
+ * when the circular RX buffer wraps.
  *
  * @param huart Pointer to UartHandle
  */
 void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 {
-//	UartReady = SET;
-//	_GET_LOCK_NORETURN(rxLock);
-	validRx = 1;
-//	dataRead = false;
-//	_UNLOCK(rxLock);
-
-	// False means Pong can be read, so write to Ping
-	if (pingPongBar == false) {
-		// Copy the second half of DmaBuff to readPing
-		for (int i = 0; i < TRANSFER_SIZE; i++) {
-			readBuffPing[i] = DmaBuff[TRANSFER_SIZE+i];
-		}
-		pingPongBar = true;
-	} else {	// True means Ping can be read, so write to Pong
-		// Copy the second half of DmaBuff to readPong
-		for (int i = 0; i < TRANSFER_SIZE; i++) {
-			readBuffPong[i] = DmaBuff[TRANSFER_SIZE+i];
-		}
-		// Switch buffers
-		pingPongBar = false;
-	}
-
-	// Have new data that hasn't been read
-	dataRead = false;
+	usart_rx_process();
 }
 
 /**
@@ -1208,6 +1409,24 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
  *  @{
  */
 
+/**
+ * @brief Common U(S)ART interrupt handling
+ *
+ * Parses received bytes as soon as the line goes idle, then lets the HAL
+ * handle the remaining flags and errors.
+ */
+static void usart_irq(void)
+{
+	if (__HAL_UART_GET_FLAG(&UartHandle, UART_FLAG_IDLE) != RESET &&
+		__HAL_UART_GET_IT_SOURCE(&UartHandle, UART_IT_IDLE) != RESET)
+	{
+		__HAL_UART_CLEAR_IDLEFLAG(&UartHandle);
+		usart_rx_process();
+	}
+
+	HAL_UART_IRQHandler(&UartHandle);
+}
+
 /**
  * @brief USART1 Interrupt Service Routine
  *
@@ -1215,7 +1434,7 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
  */
 void USART1_IRQHandler(void)
 {
-	HAL_UART_IRQHandler(&UartHandle);
+	usart_irq();
 }
 
 /**
@@ -1225,7 +1444,7 @@ void USART1_IRQHandler(void)
  */
 void USART2_IRQHandler(void)
 {
-	HAL_UART_IRQHandler(&UartHandle);
+	usart_irq();
 }
 
 /**
@@ -1235,7 +1454,7 @@ void USART2_IRQHandler(void)
  */
 void USART3_IRQHandler(void)
 {
-	HAL_UART_IRQHandler(&UartHandle);
+	usart_irq();
 }
 
 /**
@@ -1245,7 +1464,7 @@ void USART3_IRQHandler(void)
  */
 void UART4_IRQHandler(void)
 {
-	HAL_UART_IRQHandler(&UartHandle);
+	usart_irq();
 }
 
 /**
@@ -1255,17 +1474,22 @@ void UART4_IRQHandler(void)
  */
 void UART5_IRQHandler(void)
 {
-	HAL_UART_IRQHandler(&UartHandle);
+	usart_irq();
 }
 
 /**
  * @brief USART6 Interrupt Service Routine
  *
- * Resets interrupt flags and handles errors
+ * Resets interrupt flags and handles errors. USART6 carries the ESC
+ * telemetry unless it is the remote control UART.
  */
 void USART6_IRQHandler(void)
 {
-	HAL_UART_IRQHandler(&UartHandle);
+	if (UartHandle.Instance == USART6) {
+		usart_irq();
+	} else {
+		escTelemetryIRQHandler();
+	}
 }
 
 /** @} Close UART_Functions_ISRs group */
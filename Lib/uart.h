@@ -22,20 +22,45 @@
 #define _UART_H_
 
 #include <stdarg.h>
+#include <stdbool.h>
 #include "stm32f4xx_hal.h"
 #include "stm32_hal_legacy.h"
 #include "stm32f4xx_hal_dma.h"
 #include "stm32f4_discovery.h"
 
 #include "DMA_IT.h"
+#ifdef __cplusplus
+#include "Uplink.h"
+#endif
 
 void init_USART(int uart_num, int num_args, ...);
 
 void usart_transmit(uint8_t *s);
 
+bool usart_queue(const uint8_t *buf, uint16_t len);
+
+uint8_t* usart_tx_reserve(uint16_t len);
+
+void usart_tx_commit(uint16_t len);
+
+void usart_write_raw(const uint8_t *buf, uint16_t len);
+
+void usart_tx_abort(void);
+
+bool usart_tx_idle(void);
+
+uint16_t usart_tx_pending(void);
+
+uint32_t usart_tx_dropped(void);
+
 void usart_receive_begin(void);
 
-uint8_t* usart_read(void);
+// The uplink types are C++; DMA_IT.c only needs the handles
+#ifdef __cplusplus
+bool usart_read_msg(UplinkMsg *msg);
+
+void usart_uplink_stats(UplinkStats *s);
+#endif
 
 /** @addtogroup UART_Defines Definitions
  *  @brief U(S)ART RX, GPIO, DMA constants
@@ -47,10 +72,13 @@ uint8_t* usart_read(void);
  *  @{
  */
 
-/// Defines for UART RX
-#define START 255
-#define STOP  254
-#define TRANSFER_SIZE 6
+/// Circular RX DMA buffer size. Message framing is defined in Uplink.h
+/// (and RcParser.h for UPLINK_LEGACY)
+#define RX_BUFF_SIZE 64
+/// Received uplink messages waiting for usart_read_msg() (power of 2)
+#define UPLINK_QUEUE_LEN 8
+/// Status polls per byte before usart_write_raw() moves on
+#define UART_RAW_TIMEOUT 100000
 
 /** @} Close UART_Defines_RX group */
 
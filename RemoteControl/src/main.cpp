@@ -6,6 +6,7 @@
 #include "stm32f4_discovery.h"
 
 #include "uart.h"
+#include "TextFormat.h"
 #include "Motor.h"
 #include "IMU.h"
 #include "pid.h"
@@ -47,9 +48,9 @@ int main(int argc, char* argv[])
 
 	init_USART(3, 6, 57600, UART_WORDLENGTH_9B, UART_STOPBITS_1, UART_PARITY_EVEN);
 
-//	uint8_t DmaBuff[2*TRANSFER_SIZE] = {0};
-//	uint8_t readBuff[TRANSFER_SIZE] = {0};
-	uint8_t *readBuff = NULL;
+	UplinkMsg msg;
+	UplinkSticks sticks;
+	UplinkStats stats;
 
 	char txBuff[] = "USART working\n\r";
 //	trace_printf("USART working\n");
@@ -63,24 +64,23 @@ int main(int argc, char* argv[])
 
 	while (1)
 	{
-//		if (usart_read(DmaBuff, readBuff, transferSize) > 0) {
-		readBuff = usart_read();
-		if (readBuff != NULL) {
+		if (usart_read_msg(&msg) && uplinkGetSticks(&msg, &sticks)) {
 //			HAL_GPIO_WritePin(GPIOE, GPIO_PIN_5, GPIO_PIN_SET);
 
-//			trace_printf("%d %d %d %d\n", readBuff[0], readBuff[1], readBuff[2], readBuff[3]);
 			char txBuff[100];
-			sprintf(txBuff, "Received: %d %d %d %d %d %d\n\r", readBuff[0], readBuff[1], readBuff[2], readBuff[3], readBuff[4], readBuff[5]);
+			textFormat(txBuff, sizeof(txBuff), "Received: %d %d %d %d %d\n\r", msg.seq, sticks.throttle, sticks.pitch, sticks.roll, sticks.yaw);
 			usart_transmit((uint8_t *)txBuff);
 
-			if (readBuff[0] != START || readBuff[5] != STOP) {
+			// Light the LED once a frame has been lost or dropped
+			usart_uplink_stats(&stats);
+			if (stats.lost > 0 || stats.errors > 0) {
 				HAL_GPIO_WritePin(GPIOD, GPIO_PIN_12, GPIO_PIN_SET);
 			}
 
-			throttle_cmd = (float)readBuff[1] / 253.0f;
-			pitch_cmd 	 = ((float)readBuff[2] - 127.0) / 127.0f;
-			roll_cmd 	 = ((float)readBuff[3] - 127.0) / 127.0f;
-			yaw_cmd 	 = ((float)readBuff[4] - 127.0) / 127.0f;
+			throttle_cmd = (float)sticks.throttle / 65535.0f;
+			pitch_cmd 	 = (float)sticks.pitch / 32767.0f;
+			roll_cmd 	 = (float)sticks.roll / 32767.0f;
+			yaw_cmd 	 = (float)sticks.yaw / 32767.0f;
 
 			front_s = throttle_cmd;// - pitch_cmd - yaw_cmd;
 			rear_s  = throttle_cmd;// + pitch_cmd - yaw_cmd;
@@ -93,7 +93,7 @@ int main(int argc, char* argv[])
 			right.setSpeed(right_s);
 
 			char txBuff2[100];
-			sprintf(txBuff2, "Motors: %f %f %f %f\n\r", front_s, rear_s, right_s, left_s);
+			textFormat(txBuff2, sizeof(txBuff2), "Motors: %f %f %f %f\n\r", front_s, rear_s, right_s, left_s);
 			usart_transmit((uint8_t *)txBuff2);
 //
 //			HAL_GPIO_WritePin(GPIOE, GPIO_PIN_5, GPIO_PIN_RESET);
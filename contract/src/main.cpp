@@ -14,6 +14,7 @@
 #include "IMU.h"
 #include "LidarLite.h"
 #include "uart.h"
+#include "TextFormat.h"
 
 static bool enableMotors = false;
 
@@ -65,6 +66,7 @@ int main(int argc, char* argv[])
 	accelConfig.md_config = LSM_MD_Config::CONTINUOUS;
 
 	IMU imu(gyroConfig, accelConfig);
+	imu.calibrate(NULL);
 //	Adc vSense(AdcPin::PA2);
 //	Adc iSense(AdcPin::PA3);
 
@@ -107,7 +109,7 @@ int main(int argc, char* argv[])
 		}
 
 		if (iter % 2 == 0) {
-			sprintf(txBuff, "Pitch: %f\tRoll: %f\n\r", pitch, roll);
+			textFormat(txBuff, sizeof(txBuff), "Pitch: %f\tRoll: %f\n\r", pitch, roll);
 //			sprintf(txBuff, "Height: %f\tRoll: %f\tPitch: %f\n\r", height, roll, pitch);
 //			sprintf(txBuff, "Height: %f\tRoll: %f\tPitch: %f\tVoltage: %f\n\r", height, roll, pitch, v);
 //			sprintf(txBuff, "Height: %f\tRoll: %f\tPitch: %f\tVoltage: %f\tCurrent%f\n\r", height, roll, pitch, v, i);
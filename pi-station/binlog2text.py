@@ -0,0 +1,164 @@
+#!/usr/bin/env python
+
+""" Turn binary log entries from the telemetry downlink into text
+
+Usage: binlog2text.py capture.bin [LogMessages.h] [clock Hz]
+       binlog2text.py /dev/ttyUSB0 [LogMessages.h] [clock Hz]
+
+The input is a raw capture of the downlink, or a serial port to read live
+(needs pyserial). Frames are described in Lib/Telemetry.h; only TRACE frames
+are used. The formats come from Lib/LogMessages.h, found relative to this script
+by default, so the table always matches the firmware it was built from.
+Each line is the entry's time in seconds from the first entry, then its text.
+"""
+
+import os
+import re
+import sys
+import struct
+
+""" Frame constants, must match Lib/Telemetry.h """
+TRACE = 5
+BAUD = 57600
+CLOCK = 168e6
+
+""" CRC-16/CCITT, as Lib/Framing.cpp """
+def crc16(data):
+	crc = 0xFFFF
+	for b in bytearray(data):
+		crc ^= b << 8
+		for i in range(8):
+			if crc & 0x8000:
+				crc = ((crc << 1) ^ 0x1021) & 0xFFFF
+			else:
+				crc = (crc << 1) & 0xFFFF
+	return crc
+
+""" COBS decode one frame without its delimiter, None if malformed """
+def cobsDecode(data):
+	out = bytearray()
+	pos = 0
+	while pos < len(data):
+		code = data[pos]
+		if code == 0 or pos + code > len(data):
+			return None
+		out += data[pos + 1:pos + code]
+		pos += code
+		if code < 0xFF and pos < len(data):
+			out.append(0)
+	return out
+
+""" Read the X(id, category, level, "format") lines of LogMessages.h, ids are positions """
+def loadFormats(path):
+	formats = []
+	for line in open(path):
+		m = re.match(r'\s*X\(\s*(\w+)\s*,[^"]*"((?:[^"\\]|\\.)*)"\s*\)', line)
+		if m:
+			formats.append((m.group(1), m.group(2)))
+	return formats
+
+""" Turn raw argument words into Python values for the format's conversions """
+def convertArgs(fmt, words):
+	args = []
+	for conv in re.findall(r'%[-+ #0-9.]*(?:hh|h|ll|l)?([a-zA-Z%])', fmt):
+		if conv == '%':
+			continue
+		w = words[len(args)] if len(args) < len(words) else 0
+		if conv in 'feEgG':
+			args.append(struct.unpack('<f', struct.pack('<I', w))[0])
+		elif conv in 'di':
+			args.append(w - 0x100000000 if w & 0x80000000 else w)
+		else:
+			args.append(w)
+	return tuple(args)
+
+class Decoder:
+	def __init__(self, formats, clock, out):
+		self.formats = formats
+		self.clock = clock
+		self.out = out
+		self.last = None
+		self.cycles = 0
+		self.lines = 0
+		self.bad = 0
+		self.lost = 0
+		self.seq = None
+
+	""" Unwrap the 32-bit cycle counter into a running count """
+	def time(self, stamp):
+		if self.last is not None:
+			self.cycles += (stamp - self.last) & 0xFFFFFFFF
+		self.last = stamp
+		return self.cycles / self.clock
+
+	""" Handle one delimited chunk of the stream """
+	def frame(self, raw):
+		data = cobsDecode(bytearray(raw))
+		if data is None or len(data) < 4 or crc16(data[:-2]) != struct.unpack('<H', bytes(data[-2:]))[0]:
+			self.bad += 1
+			return
+
+		""" Sequence numbers are shared by every frame type """
+		if self.seq is not None:
+			self.lost += (data[1] - self.seq - 1) & 0xFF
+		self.seq = data[1]
+		if data[0] != TRACE:
+			return
+
+		payload = data[2:-2]
+		pos = 0
+		while pos + 7 <= len(payload):
+			msg, n, stamp = struct.unpack('<HBI', bytes(payload[pos:pos + 7]))
+			pos += 7
+			words = struct.unpack('<%dI' % n, bytes(payload[pos:pos + 4 * n]))
+			pos += 4 * n
+			t = self.time(stamp)
+
+			if msg < len(self.formats):
+				name, fmt = self.formats[msg]
+				try:
+					text = fmt % convertArgs(fmt, words)
+				except (TypeError, ValueError):
+					text = '%s %s' % (name, ' '.join('0x%08x' % w for w in words))
+			else:
+				text = 'unknown message %d %s' % (msg, ' '.join('0x%08x' % w for w in words))
+			self.out.write('%.6f %s\n' % (t, text.rstrip('\r\n')))
+			self.lines += 1
+
+	""" Split a byte stream on 0x00 delimiters, returns the unfinished tail """
+	def feed(self, buf):
+		while True:
+			end = buf.find(b'\x00')
+			if end < 0:
+				return buf
+			if end > 0:
+				self.frame(buf[:end])
+			buf = buf[end + 1:]
+
+def main():
+	if len(sys.argv) < 2:
+		sys.stderr.write(__doc__)
+		sys.exit(1)
+
+	here = os.path.dirname(os.path.abspath(__file__))
+	header = sys.argv[2] if len(sys.argv) > 2 else os.path.join(here, '..', 'Lib', 'LogMessages.h')
+	clock = float(sys.argv[3]) if len(sys.argv) > 3 else CLOCK
+	decoder = Decoder(loadFormats(header), clock, sys.stdout)
+
+	if os.path.isfile(sys.argv[1]):
+		decoder.feed(open(sys.argv[1], 'rb').read())
+	else:
+		import serial
+		port = serial.Serial(port=sys.argv[1], baudrate=BAUD, timeout=0.1)
+		buf = b''
+		try:
+			while True:
+				buf = decoder.feed(buf + port.read(256))
+				sys.stdout.flush()
+		except KeyboardInterrupt:
+			pass
+
+	sys.stderr.write('%d entries, %d bad frames, %d frames lost\n' % (decoder.lines, decoder.bad, decoder.lost))
+
+if __name__ == '__main__':
+	main()
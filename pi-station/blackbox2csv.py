@@ -0,0 +1,148 @@
+#!/usr/bin/env python
+
+""" Convert a flight recorder dump to CSV
+
+Usage: blackbox2csv.py dump.bin [out.csv]
+
+The dump is the raw recorder storage, e.g. read with
+    st-flash read dump.bin 0x08080000 0x40000
+The page and record format is described in Lib/Blackbox.h. Every recording
+session (one per arming) gets its own header row, and a session column.
+Damaged pages are skipped with a warning on stderr.
+"""
+
+import sys
+import struct
+
+""" Format constants, must match Lib/Blackbox.h """
+VERSION = 1
+MAGIC = 0xB10C
+PAGE_SIZE = 512
+PAGE_HEADER = 8
+PAGE_PAYLOAD = PAGE_SIZE - PAGE_HEADER
+
+""" CRC-16/CCITT, as Lib/Framing.cpp """
+def crc16(data):
+	crc = 0xFFFF
+	for b in bytearray(data):
+		crc ^= b << 8
+		for i in range(8):
+			if crc & 0x8000:
+				crc = ((crc << 1) ^ 0x1021) & 0xFFFF
+			else:
+				crc = (crc << 1) & 0xFFFF
+	return crc
+
+""" Read an unsigned varint, returns (value, next position) """
+def getVarint(data, pos):
+	x = 0
+	shift = 0
+	while True:
+		if pos >= len(data):
+			raise ValueError('record runs past the page')
+		b = data[pos]
+		pos += 1
+		x |= (b & 0x7F) << shift
+		shift += 7
+		if b < 0x80:
+			return x, pos
+
+""" Read a zigzag varint, returns (value, next position) """
+def getSigned(data, pos):
+	x, pos = getVarint(data, pos)
+	return (x >> 1) ^ -(x & 1), pos
+
+""" Wrap to a signed 32-bit integer, like the recorder's delta arithmetic """
+def wrap32(x):
+	x &= 0xFFFFFFFF
+	return x - 0x100000000 if x & 0x80000000 else x
+
+""" Format a value at the resolution it was recorded with """
+def formatValue(count, scale):
+	if scale == 1:
+		return str(count)
+	return repr(float(count) / scale)
+
+""" Decode a dump, writing CSV lines to out. Returns (rows, damaged pages) """
+def decode(dump, out):
+	dump = bytearray(dump)
+	session = 0
+	fields = None
+	prev = None
+	rows = 0
+	damaged = 0
+
+	for offset in range(0, len(dump) - PAGE_SIZE + 1, PAGE_SIZE):
+		page = dump[offset:offset + PAGE_SIZE]
+		magic, length, crc, seq = struct.unpack('<HHHH', bytes(page[:PAGE_HEADER]))
+
+		""" End of the recorded data """
+		if magic == 0xFFFF and length == 0xFFFF:
+			break
+
+		payload = page[PAGE_HEADER:PAGE_HEADER + length]
+		if magic != MAGIC or length > PAGE_PAYLOAD or crc16(payload) != crc:
+			sys.stderr.write('page %d at 0x%x damaged, skipped\n' % (seq, offset))
+			damaged += 1
+			prev = None
+			continue
+
+		pos = 0
+		try:
+			while pos < len(payload):
+				kind = chr(payload[pos])
+				pos += 1
+
+				if kind == 'H':
+					if payload[pos] != VERSION:
+						raise ValueError('unknown version %d' % payload[pos])
+					n = payload[pos + 1]
+					pos += 2
+					fields = []
+					for i in range(n):
+						end = payload.index(b'\x00', pos)
+						name = payload[pos:end].decode('ascii')
+						scale, pos = getVarint(payload, end + 1)
+						fields.append((name, scale))
+					session += 1
+					prev = None
+					out.write('session,' + ','.join(f[0] for f in fields) + '\n')
+
+				elif kind == 'I' or kind == 'P':
+					if fields is None:
+						raise ValueError('record before any session header')
+					values = []
+					for i in range(len(fields)):
+						x, pos = getSigned(payload, pos)
+						values.append(x)
+					if kind == 'P':
+						if prev is None:
+							continue
+						values = [wrap32(p + d) for p, d in zip(prev, values)]
+					prev = values
+					out.write(str(session) + ',' + ','.join(formatValue(c, f[1]) for c, f in zip(values, fields)) + '\n')
+					rows += 1
+
+				else:
+					raise ValueError('unknown record type 0x%02x' % ord(kind))
+
+		except ValueError as e:
+			sys.stderr.write('page %d at 0x%x: %s\n' % (seq, offset, e))
+			damaged += 1
+			prev = None
+
+	return rows, damaged
+
+def main():
+	if len(sys.argv) < 2:
+		sys.stderr.write(__doc__)
+		sys.exit(1)
+
+	dump = open(sys.argv[1], 'rb').read()
+	out = open(sys.argv[2], 'w') if len(sys.argv) > 2 else sys.stdout
+
+	rows, damaged = decode(dump, out)
+	sys.stderr.write('%d records, %d damaged pages\n' % (rows, damaged))
+
+if __name__ == '__main__':
+	main()
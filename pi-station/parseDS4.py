@@ -2,6 +2,8 @@
 
 import sys
 import serial
+import struct
+import threading
 import time
 
 """ Report format """
@@ -57,24 +59,181 @@ pitch_LUT 	 = ['left_analog_y', 'right_analog_y', 'left_analog_y', 'right_analog
 roll_LUT 	 = ['right_analog_x', 'right_analog_x', 'left_analog_x', 'left_analog_x']
 yaw_LUT 	 = ['left_analog_x', 'left_analog_x', 'right_analog_x', 'right_analog_x']
 
-""" Comms protocol constants """
-START = 255
-STOP  = 254
+""" Uplink constants, must match Lib/Uplink.h and Lib/Telemetry.h """
+UPLINK_VERSION = 1
+STICKS = 1
+MODE = 2
+ARM = 3
+HEARTBEAT = 6
+MODE_FLY = 1
+MODE_DEMO = 2
+LINK = 2
+HEARTBEAT_PERIOD = 1.0		# [s]
 
 """ Controller behavior constants """
-MODE  = 3
+CONTROL_MODE = 3
 STICK_ZERO = 127
 DEADBAND = 10
 
-""" Special command constants """
-FLY = 1
-DEMO = 2
-DEMO_MOTOR_TOGGLE = 3
+ids = ['r2_analog', pitch_LUT[CONTROL_MODE-1], roll_LUT[CONTROL_MODE-1], yaw_LUT[CONTROL_MODE-1]]
 
-packet = []
-ids = ['dummy_id', 'r2_analog', pitch_LUT[MODE-1], roll_LUT[MODE-1], yaw_LUT[MODE-1]]
+""" CRC-16/CCITT, as Lib/Framing.cpp """
+def crc16(data):
+	crc = 0xFFFF
+	for b in bytearray(data):
+		crc ^= b << 8
+		for i in range(8):
+			if crc & 0x8000:
+				crc = ((crc << 1) ^ 0x1021) & 0xFFFF
+			else:
+				crc = (crc << 1) & 0xFFFF
+	return crc
 
-ser = serial.Serial('/dev/ttyUSB0', 57600, parity=serial.PARITY_EVEN)
+""" COBS encode one frame, without its delimiter """
+def cobsEncode(data):
+	out = bytearray([0])
+	code = 0
+	for b in bytearray(data):
+		if b != 0:
+			out.append(b)
+		if b == 0 or len(out) - code == 0xFF:
+			out[code] = len(out) - code
+			code = len(out)
+			out.append(0)
+	out[code] = len(out) - code
+	return out
+
+""" COBS decode one frame without its delimiter, None if malformed """
+def cobsDecode(data):
+	out = bytearray()
+	pos = 0
+	while pos < len(data):
+		code = data[pos]
+		if code == 0 or pos + code > len(data):
+			return None
+		out += data[pos + 1:pos + code]
+		pos += code
+		if code < 0xFF and pos < len(data):
+			out.append(0)
+	return out
+
+""" Milliseconds since the script started, the HEARTBEAT time """
+start = time.time()
+def now():
+	return int((time.time() - start) * 1000) & 0xFFFFFFFF
+
+""" Sends uplink frames and keeps the link accounting of both directions.
+
+	Every message carries a sequence number. Each HEARTBEAT is answered with a
+	LINK frame that echoes its time, so the round trip is the time it came
+	back less the time it carries, and reports how many messages the
+	DC9000 received, lost and dropped. Heartbeats without a reply count as
+	lost round trips; gaps in the downlink sequence numbers as lost frames. """
+class Link:
+	def __init__(self, ser):
+		self.ser = ser
+		self.lock = threading.Lock()
+		self.seq = 0
+		self.sent = 0
+		self.lastHeartbeat = 0.0
+		self.pending = {}			# Heartbeat sequence number -> time sent [ms]
+		self.heartbeats = 0
+		self.replies = 0
+		self.rtt = []
+		self.remote = (0, 0, 0)		# Received, lost, errors at the DC9000
+		self.downSeq = None
+		self.downFrames = 0
+		self.downLost = 0
+		self.downBad = 0
+
+	""" Frame and send one message """
+	def send(self, msgId, payload=b''):
+		with self.lock:
+			raw = struct.pack('<BBBB', UPLINK_VERSION, msgId, self.seq, len(payload)) + payload
+			raw += struct.pack('<H', crc16(raw))
+			self.ser.write(cobsEncode(raw) + b'\x00')
+			if msgId == HEARTBEAT:
+				self.pending[self.seq] = struct.unpack('<I', payload)[0]
+				self.heartbeats += 1
+			self.seq = (self.seq + 1) & 0xFF
+			self.sent += 1
+
+	def sticks(self, throttle, pitch, roll, yaw):
+		self.send(STICKS, struct.pack('<Hhhh', throttle, pitch, roll, yaw))
+
+	def mode(self, mode):
+		self.send(MODE, struct.pack('<B', mode))
+
+	def arm(self, armed):
+		self.send(ARM, struct.pack('<B', 1 if armed else 0))
+
+	""" Send a HEARTBEAT if one is due """
+	def heartbeat(self):
+		if time.time() - self.lastHeartbeat >= HEARTBEAT_PERIOD:
+			self.lastHeartbeat = time.time()
+			self.send(HEARTBEAT, struct.pack('<I', now()))
+
+	""" Stop the motors: zero throttle, then disarm """
+	def stop(self):
+		self.sticks(0, 0, 0, 0)
+		self.arm(False)
+
+	""" One downlink frame without its delimiter """
+	def frame(self, data):
+		data = cobsDecode(bytearray(data))
+		if data is None or len(data) < 4 or crc16(data[:-2]) != struct.unpack('<H', bytes(data[-2:]))[0]:
+			self.downBad += 1
+			return
+		msgId, seq = data[0], data[1]
+		with self.lock:
+			if self.downSeq is not None:
+				self.downLost += (seq - self.downSeq - 1) & 0xFF
+			self.downSeq = seq
+			self.downFrames += 1
+			if msgId == LINK and len(data) == 2 + 17 + 2:
+				hbSeq, sentAt, received, lost, errors = struct.unpack('<BIIII', bytes(data[2:19]))
+				if self.pending.pop(hbSeq, None) is not None:
+					self.replies += 1
+					self.rtt.append((now() - sentAt) & 0xFFFFFFFF)
+				self.remote = (received, lost, errors)
+				print self.report()
+
+	""" Read the downlink until the port closes """
+	def receive(self):
+		buf = b''
+		while True:
+			buf += self.ser.read(64)
+			while True:
+				end = buf.find(b'\x00')
+				if end < 0:
+					break
+				if end > 0:
+					self.frame(buf[:end])
+				buf = buf[end + 1:]
+
+	""" One line of link statistics """
+	def report(self):
+		received, lost, errors = self.remote
+		rtt = sorted(self.rtt[-100:])
+		line = 'link: sent %d, DC9000 received %d lost %d bad %d; ' % (self.sent, received, lost, errors)
+		line += 'heartbeats %d answered %d; ' % (self.heartbeats, self.replies)
+		if rtt:
+			line += 'rtt %d ms (median of %d, max %d); ' % (rtt[len(rtt) // 2], len(rtt), rtt[-1])
+		line += 'downlink %d frames, %d lost, %d bad' % (self.downFrames, self.downLost, self.downBad)
+		return line
+
+ser = serial.Serial('/dev/ttyUSB0', 57600, parity=serial.PARITY_EVEN, timeout=0.1)
+link = Link(ser)
+receiver = threading.Thread(target=link.receive)
+receiver.daemon = True
+receiver.start()
+
+""" Stick position 0..255 to +-32767, zero inside the deadband """
+def stick(value):
+	value -= STICK_ZERO
+	if abs(value) < DEADBAND:
+		return 0
+	return max(-32767, min(32767, int(value * 32767 / 128.0)))
 
 """ Get a complete controller status report """
 def getReport():
@@ -163,59 +322,48 @@ def passwordProtect():
 def fly():
 	""" Tell the DC9000 it should enter flight mode """
 	print 'Entering flight mode'
-	packet = [FLY, FLY, FLY, FLY, FLY, FLY]
-	ser.write(bytearray(packet))
+	link.mode(MODE_FLY)
+	link.arm(True)
 	
-	packet = [START, 0, STICK_ZERO, STICK_ZERO, STICK_ZERO, STOP]
+	values = [0, STICK_ZERO, STICK_ZERO, STICK_ZERO]
 	
 	""" Read controller status """
 	for line in sys.stdin:
 		""" Handle controller disconnect gracefully """
 		if 'Disconnected' in line:
 			print 'Error: Controller has been disconnected'
-			packet = [0, 0, STICK_ZERO, STICK_ZERO, STICK_ZERO, 0]
-			ser.write(bytearray(packet))
+			link.stop()
 			exit()
-		""" New report so send RC packet """
+		""" New report so send the sticks. The pitch axis is reversed """
 		if 'Report dump' in line:
-			""" Clip joysticks to deadband to eliminate noise """
-			if abs(packet[2] - STICK_ZERO) < DEADBAND:
-				packet[2] = STICK_ZERO
-			if abs(packet[3] - STICK_ZERO) < DEADBAND:
-				packet[3] = STICK_ZERO
-			if abs(packet[4] - STICK_ZERO) < DEADBAND:
-				packet[4] = STICK_ZERO
-			ser.write(bytearray(packet))
-			print packet
+			link.sticks(int(values[0] * 65535 / 255), -stick(values[1]), stick(values[2]), stick(values[3]))
+			link.heartbeat()
+			print values
 		""" Search for control parameters """
 		for index, val in enumerate(ids):
 			if val in line:
-				""" Have to reverse the pitch axis. Rescale so 254,255 are reserved """
-				if index == 2:
-					packet[index] = int(int(filter(str.isdigit, str.lstrip(line, ' r2'))) / 255.0 * 253.0 * -1.0 + 253.0)
-				else:
-					packet[index] = int(int(filter(str.isdigit, str.lstrip(line, ' r2'))) / 255.0 * 253.0)
+				values[index] = int(filter(str.isdigit, str.lstrip(line, ' r2')))
 					
-		""" Send packet that causes quad to abort """
+		""" Stop the motors and quit """
 		if 'button_cross' in line:
 			if 'True' in line:
-				packet = [0, 0, STICK_ZERO, STICK_ZERO, STICK_ZERO, 0]
-				ser.write(bytearray(packet))
+				link.stop()
 				exit()
 
 """ Remote control for contract demo mode. Toggles motors enabled/disabled """
 def demo():
 	print 'Entering demo mode'
-	packet = [DEMO, DEMO, DEMO, DEMO, DEMO, DEMO]
-	ser.write(bytearray(packet))
+	link.mode(MODE_DEMO)
+	armed = False
 	for line in sys.stdin:
 		if 'button_cross' in line and 'True' in line:
-			packet = [DEMO_MOTOR_TOGGLE, DEMO_MOTOR_TOGGLE, DEMO_MOTOR_TOGGLE, DEMO_MOTOR_TOGGLE, DEMO_MOTOR_TOGGLE, DEMO_MOTOR_TOGGLE]
-			ser.write(bytearray(packet))
+			armed = not armed
+			link.arm(armed)
+		if 'Report dump' in line:
+			link.heartbeat()
 		if 'Disconnected' in line:
 			print 'Error: Controller has been disconnected'
-			packet = [0, 0, STICK_ZERO, STICK_ZERO, STICK_ZERO, 0]
-			ser.write(bytearray(packet))
+			link.stop()
 			exit()
 
 """ Run everything """
@@ -235,14 +383,13 @@ def main():
 		line = sys.stdin.readline()
 		if 'Disconnected' in line:
 			print 'Error: Controller has been disconnected'
-			packet = [0, 0, STICK_ZERO, STICK_ZERO, STICK_ZERO, 0]
-			ser.write(bytearray(packet))
+			link.stop()
 			exit()
 		if 'button_triangle' in line and 'True' in line:
-			op_mode = FLY
+			op_mode = MODE_FLY
 			fly()
 		elif 'button_circle' in line and 'True' in line:
-			op_mode = DEMO
+			op_mode = MODE_DEMO
 			demo()
 		else:
 			line = sys.stdin.readline()
@@ -0,0 +1,198 @@
+/**
+ * @file
+ *
+ * @brief Host benchmark sweeping every registered sensor pre-filter design
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Runs filterSweep() over one column of a recorded IMU log and prints one
+ * line per design: time per sample, output RMS and RMS change from the input.
+ * Host timings only rank the designs; use filterCycleClock() on the target
+ * for cycle counts.
+ *
+ * 	bench_filters [file] [column]
+ *
+ * The file holds whitespace separated columns (ax ay az gx gy gz, as in the
+ * logs under DeathChopper9000/imu testing); lines that don't parse are
+ * skipped. The column is 1-based and defaults to 4 (gyro x).
+ *
+ * A second table runs the fixed-point path USE_FIXED_POINT builds for that
+ * sensor (gyro Q15 for columns 4-6, accelerometer Q31 for 1-3) on the column
+ * converted to raw counts, and compares it to the float design it replaces.
+ *
+ */
+
+#include "sensorFilter.h"
+#include "preFilterQ15.h"
+#include "preFilterQ31.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_MAX_SAMPLES	20000
+#define BENCH_MAX_COLUMNS	16
+
+#define GYRO_LSB	0.0175f		///< L3GD20H at 500 dps full-scale [dps/LSB]
+#define ACC_LSB		0.000122f	///< LSM303D at 4 g full-scale [g/LSB]
+
+// Same designs as gyroQ15Coef in L3GD20H.cpp and accQ31Coef in LSM303D.cpp
+static const float32_t gyroCoef[15] = {
+	1, -1.67171299109, 1,
+	1.71022092712, -0.833197919132,
+	1, -0.631952192663, 1,
+	1.58706817569, -0.648599546625,
+	1, -1.77493127647, 1,
+	1.79913121367, -0.958726718288
+};
+#define GYRO_SECTIONS	3
+#define GYRO_GAIN		0.0118105736583f
+
+static const float32_t accCoef[20] = {
+	1, -1.98982556714, 1,
+	1.97886614394, -0.982257780648,
+	1, -1.98002560283, 1,
+	1.96462573041, -0.966676926152,
+	1, -1.85755297101, 1,
+	1.95266174823, -0.95346779688,
+	1, -1.99202450372, 1,
+	1.99052519416, -0.994653975147
+};
+#define ACC_SECTIONS	4
+#define ACC_GAIN		9.91298688922e-05f
+#define ACC_SHIFT		(16 - PREFILTER_Q31_HEADROOM)
+
+/**
+ * @brief Nanosecond counter for filterSweep()
+ */
+static uint32_t hostClock(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+
+/**
+ * @brief Read one column of a recorded log
+ * @return Number of samples read
+ */
+static uint32_t readColumn(const char *path, int column, float *x, uint32_t max) {
+	FILE *f = fopen(path, "r");
+	char line[512];
+	uint32_t n = 0;
+
+	if (f == NULL) {
+		return 0;
+	}
+
+	while (n < max && fgets(line, sizeof(line), f) != NULL) {
+		float v[BENCH_MAX_COLUMNS];
+		int cols = 0;
+		char *p = line;
+		char *end;
+
+		while (cols < BENCH_MAX_COLUMNS) {
+			v[cols] = strtof(p, &end);
+			if (end == p) {
+				break;
+			}
+			p = end;
+			cols++;
+		}
+
+		if (cols >= column) {
+			x[n++] = v[column - 1];
+		}
+	}
+
+	fclose(f);
+	return n;
+}
+
+/**
+ * @brief Run the fixed-point path of a sensor and the float design it replaces
+ * @param x    Samples [dps or g]
+ * @param n    Number of samples
+ * @param gyro Gyro (Q15) path, else accelerometer (Q31)
+ */
+static void benchFixed(const float *x, uint32_t n, bool gyro) {
+	static int16_t raw[BENCH_MAX_SAMPLES];
+	static float yFloat[BENCH_MAX_SAMPLES], yFixed[BENCH_MAX_SAMPLES];
+	float lsb = gyro ? GYRO_LSB : ACC_LSB;
+	uint32_t t0, tFloat, tFixed;
+
+	// Raw counts as the sensor reports them, clipped at full-scale
+	for (uint32_t i = 0; i < n; i++) {
+		float v = roundf(x[i] / lsb);
+		raw[i] = (int16_t)(v > 32767.0f ? 32767.0f : (v < -32768.0f ? -32768.0f : v));
+	}
+
+	sensorFilter ref(gyro ? filterDesign::IIR_GYRO : filterDesign::IIR_ACC, PREFILTER_TAU);
+	t0 = hostClock();
+	for (uint32_t i = 0; i < n; i++) {
+		yFloat[i] = ref.filterSample(raw[i] * lsb);
+	}
+	tFloat = hostClock() - t0;
+
+	// Scaled back to sensor units as L3GD20H::getXFiltered() and
+	// LSM303D::getAccXFiltered() do
+	if (gyro) {
+		preFilterQ15 q(gyroCoef, GYRO_SECTIONS, GYRO_GAIN);
+		t0 = hostClock();
+		for (uint32_t i = 0; i < n; i++) {
+			q15_t y = q.filterSample((raw[i] + (1 << (PREFILTER_Q15_HEADROOM - 1))) >> PREFILTER_Q15_HEADROOM);
+			yFixed[i] = (float)((int32_t)y << PREFILTER_Q15_HEADROOM) * lsb;
+		}
+		tFixed = hostClock() - t0;
+	} else {
+		preFilterQ31 q(accCoef, ACC_SECTIONS, ACC_GAIN);
+		t0 = hostClock();
+		for (uint32_t i = 0; i < n; i++) {
+			q31_t y = q.filterSample((q31_t)raw[i] << ACC_SHIFT);
+			yFixed[i] = (float)y / (float)(1 << ACC_SHIFT) * lsb;
+		}
+		tFixed = hostClock() - t0;
+	}
+
+	double rms = 0.0, diff = 0.0;
+	for (uint32_t i = 0; i < n; i++) {
+		double d = yFixed[i] - yFloat[i];
+		rms += (double)yFixed[i] * yFixed[i];
+		diff += d * d;
+	}
+
+	printf("\n%-12s %10s %10s %10s %10s\n", "fixed-point", "ns/sample", "rms", "float ns", "rms diff");
+	printf("%-12s %10.1f %10.4f %10.1f %10.4f (%.2f LSB)\n", gyro ? "gyro Q15" : "acc Q31", (double)tFixed / n,
+			sqrt(rms / n), (double)tFloat / n, sqrt(diff / n), sqrt(diff / n) / lsb);
+}
+
+int main(int argc, char **argv) {
+	const char *path = (argc > 1) ? argv[1] : "../DeathChopper9000/imu testing/1 Initial testing/acc_gyro_data_flat_motors.txt";
+	int column = (argc > 2) ? atoi(argv[2]) : 4;
+	static float x[BENCH_MAX_SAMPLES];
+	filterSweepResult results[FILTER_NUM_DESIGNS];
+
+	if (column < 1 || column > BENCH_MAX_COLUMNS) {
+		fprintf(stderr, "bad column %d\n", column);
+		return 1;
+	}
+
+	uint32_t n = readColumn(path, column, x, BENCH_MAX_SAMPLES);
+	if (n == 0) {
+		fprintf(stderr, "no samples in %s\n", path);
+		return 1;
+	}
+
+	uint8_t count = filterSweep(x, n, PREFILTER_TAU, hostClock, results);
+
+	printf("%s, column %d, %u samples\n", path, column, (unsigned)n);
+	printf("%-12s %10s %10s %10s\n", "design", "ns/sample", "rms", "rms diff");
+	for (uint8_t i = 0; i < count; i++) {
+		printf("%-12s %10.1f %10.4f %10.4f\n", filterDesignName(results[i].design),
+				(double)results[i].cycles / n, results[i].rms, results[i].rmsDiff);
+	}
+
+	benchFixed(x, n, column > 3);
+
+	return 0;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file
+ *
+ * @brief Host benchmark of the motor mixer on every frame geometry
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Times mix() on QUAD_PLUS, QUAD_X, HEX_X and OCTO_X, once with commands
+ * that always fit the output range (no desaturation) and once with commands
+ * that sweep through saturated and unsaturated cases, so every branch of the
+ * desaturation is included. A plain matrix product clipped per motor, the
+ * mixing without any desaturation, is timed alongside for reference. Host
+ * timings only rank the cases; use a DWT-timed loop on the target for cycle
+ * counts.
+ *
+ * 	bench_mixer [iterations]
+ *
+ */
+
+#include "mixer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define OUT_MAX		1.0f		///< Highest motor speed
+
+/**
+ * @brief Nanosecond counter
+ */
+static uint64_t hostClock(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Commands of one call
+ * @param k         Call number
+ * @param saturate  Sweep into saturation, else stay within the output range
+ * @param c         [out] Throttle, roll, pitch, yaw
+ */
+static void commands(uint32_t k, bool saturate, float *c) {
+	float x = (float)(k % 64) / 32.0f - 1.0f;
+
+	if (saturate) {
+		c[0] = 0.5f + 0.45f * x;
+		c[1] = 0.6f * x;
+		c[2] = -0.4f * x;
+		c[3] = 0.3f;
+	} else {
+		c[0] = 0.5f + 0.05f * x;
+		c[1] = 0.1f * x;
+		c[2] = -0.08f * x;
+		c[3] = 0.05f;
+	}
+}
+
+/**
+ * @brief Time mix() over a run of commands
+ * @param m          Mixer under test
+ * @param iterations Number of calls
+ * @param saturate   Sweep into saturation
+ * @param desat      [out] Fraction of calls that scaled a command down
+ * @param sum        [in,out] Sum of the outputs, so no call is optimised away
+ * @return Time per call [ns]
+ */
+static double timeMix(mixer &m, uint32_t iterations, bool saturate, double *desat, double *sum) {
+	float c[4], out[MIXER_MAX_MOTORS];
+	uint32_t scaled = 0;
+
+	uint64_t t0 = hostClock();
+	for (uint32_t k = 0; k < iterations; k++) {
+		float rp, yaw;
+
+		commands(k, saturate, c);
+		m.mix(c[0], c[1], c[2], c[3], out);
+		m.getApplied(&rp, &yaw);
+		if (rp < 1.0f || yaw < 1.0f) {
+			scaled++;
+		}
+		*sum += out[k % m.getMotors()];
+	}
+	uint64_t t = hostClock() - t0;
+
+	*desat = (double)scaled / iterations;
+	return (double)t / iterations;
+}
+
+/**
+ * @brief Time the mixing with no desaturation: the matrix row per motor,
+ * clipped to the output range
+ * @param frame      Frame geometry
+ * @param iterations Number of calls
+ * @param sum        [in,out] Sum of the outputs
+ * @return Time per call [ns]
+ */
+static double timePlain(mixerFrame frame, uint32_t iterations, double *sum) {
+	float32_t matData[MIXER_MAX_MOTORS*MIXER_AXES], cmdData[MIXER_AXES], outData[MIXER_MAX_MOTORS];
+	arm_matrix_instance_f32 mat, cmd, out;
+	uint8_t n = mixerFrameMotors(frame);
+	float c[4];
+
+	// The matrix is the mixer's own, read back one axis at a time
+	mixer m(frame, OUT_MAX);
+	for (uint8_t a = 0; a < MIXER_AXES; a++) {
+		float u[MIXER_AXES] = { 0.5f, 0.0f, 0.0f, 0.0f };
+		float lo[MIXER_MAX_MOTORS], hi[MIXER_MAX_MOTORS];
+
+		m.mix(u[0], u[1], u[2], u[3], lo);
+		u[a] += 0.1f;
+		m.mix(u[0], u[1], u[2], u[3], hi);
+		for (uint8_t i = 0; i < n; i++) {
+			matData[i*MIXER_AXES + a] = (hi[i] - lo[i]) / 0.1f;
+		}
+	}
+
+	arm_mat_init_f32(&mat, n, MIXER_AXES, matData);
+	arm_mat_init_f32(&cmd, MIXER_AXES, 1, cmdData);
+	arm_mat_init_f32(&out, n, 1, outData);
+
+	uint64_t t0 = hostClock();
+	for (uint32_t k = 0; k < iterations; k++) {
+		commands(k, true, c);
+		for (uint8_t a = 0; a < MIXER_AXES; a++) {
+			cmdData[a] = c[a];
+		}
+		arm_mat_mult_f32(&mat, &cmd, &out);
+		for (uint8_t i = 0; i < n; i++) {
+			if (outData[i] < 0.0f) outData[i] = 0.0f;
+			else if (outData[i] > OUT_MAX) outData[i] = OUT_MAX;
+		}
+		*sum += outData[k % n];
+	}
+	uint64_t t = hostClock() - t0;
+
+	return (double)t / iterations;
+}
+
+int main(int argc, char **argv) {
+	const mixerFrame frames[] = { mixerFrame::QUAD_PLUS, mixerFrame::QUAD_X, mixerFrame::HEX_X, mixerFrame::OCTO_X };
+	const char *names[] = { "QUAD_PLUS", "QUAD_X", "HEX_X", "OCTO_X" };
+	uint32_t iterations = (argc > 1) ? (uint32_t)atol(argv[1]) : 1000000;
+	double sum = 0.0;
+
+	if (iterations == 0) {
+		fprintf(stderr, "bad iteration count\n");
+		return 1;
+	}
+
+	printf("mixer, %lu calls per case\n", (unsigned long)iterations);
+	printf("%-10s %6s %10s %10s %10s %10s\n", "frame", "motors", "plain ns", "in-range", "saturated", "desat");
+	for (uint8_t f = 0; f < sizeof(frames) / sizeof(frames[0]); f++) {
+		mixer m(frames[f], OUT_MAX);
+		double desatIn, desatSat;
+
+		double tPlain = timePlain(frames[f], iterations, &sum);
+		double tIn = timeMix(m, iterations, false, &desatIn, &sum);
+		double tSat = timeMix(m, iterations, true, &desatSat, &sum);
+
+		printf("%-10s %6u %10.1f %10.1f %10.1f %9.0f%%\n", names[f], (unsigned)m.getMotors(), tPlain, tIn, tSat,
+				100.0 * desatSat);
+		if (desatIn != 0.0) {
+			fprintf(stderr, "%s: in-range commands were desaturated\n", names[f]);
+			return 1;
+		}
+	}
+
+	// Keeps the outputs live
+	printf("(output sum %.1f)\n", sum);
+
+	return 0;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file
+ *
+ * @brief Host benchmark of textFormat() against the C library's snprintf
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Formats the kinds of line the firmware sends as text (integers, floats at
+ * several precisions, hex, strings, and a mixed motor line) with both, over
+ * the same pseudo-random arguments, and prints the time per call. Host
+ * timings only rank the two; newlib's printf on the target is slower still
+ * and allocates for %f.
+ *
+ * 	bench_text_format [iterations]
+ *
+ */
+
+#include "TextFormat.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_ARGS	1024	///< Argument sets, cycled through
+
+/**
+ * @brief Nanosecond counter
+ */
+static uint64_t hostClock(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static int32_t ints[BENCH_ARGS];
+static float floats[BENCH_ARGS];
+
+/**
+ * @brief xorshift32, for reproducible arguments
+ */
+static uint32_t randomBits(void) {
+	static uint32_t x = 2463534242u;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return x;
+}
+
+/**
+ * @brief One formatting case
+ */
+typedef struct {
+	const char *name;		///< Shown in the table
+	const char *fmt;		///< Format string
+	int args;				///< 0 = one int, 1 = one float, 4 = four floats, 5 = string and int
+} benchCase;
+
+static const benchCase cases[] = {
+	{ "int",      "%d",                          0 },
+	{ "hex",      "%08x",                        0 },
+	{ "float .2", "%.2f",                        1 },
+	{ "float",    "%f",                          1 },
+	{ "float .6", "%10.6f",                      1 },
+	{ "motors",   "Motors: %f %f %f %f\n\r",     4 },
+	{ "string",   "%s error %d\n\r",             5 }
+};
+
+/**
+ * @brief Time one formatter over every argument set
+ * @param textFmt    textFormat(), else snprintf
+ * @param c          Case
+ * @param iterations Calls
+ * @param sum        [in,out] Sum of the lengths, so no call is optimised away
+ * @return Time per call [ns]
+ */
+static double timeCase(bool textFmt, const benchCase *c, uint32_t iterations, uint64_t *sum) {
+	char buf[128];
+
+	uint64_t t0 = hostClock();
+	for (uint32_t k = 0; k < iterations; k++) {
+		uint32_t i = k % BENCH_ARGS;
+		float f = floats[i];
+		int n;
+
+		switch (c->args) {
+		case 0:
+			n = textFmt ? textFormat(buf, sizeof(buf), c->fmt, ints[i]) : snprintf(buf, sizeof(buf), c->fmt, ints[i]);
+			break;
+		case 1:
+			n = textFmt ? textFormat(buf, sizeof(buf), c->fmt, f) : snprintf(buf, sizeof(buf), c->fmt, f);
+			break;
+		case 4:
+			n = textFmt ? textFormat(buf, sizeof(buf), c->fmt, f, -f, 0.5f * f, f + 0.25f)
+					: snprintf(buf, sizeof(buf), c->fmt, f, -f, 0.5f * f, f + 0.25f);
+			break;
+		default:
+			n = textFmt ? textFormat(buf, sizeof(buf), c->fmt, "I2C", ints[i])
+					: snprintf(buf, sizeof(buf), c->fmt, "I2C", ints[i]);
+			break;
+		}
+		*sum += n + (uint8_t)buf[0];
+	}
+	uint64_t t = hostClock() - t0;
+
+	return (double)t / iterations;
+}
+
+/**
+ * @brief Check both give the same text for the first argument set
+ */
+static bool matches(const benchCase *c) {
+	char a[128], b[128];
+	float f = floats[0];
+
+	switch (c->args) {
+	case 0:
+		textFormat(a, sizeof(a), c->fmt, ints[0]);
+		snprintf(b, sizeof(b), c->fmt, ints[0]);
+		break;
+	case 1:
+		textFormat(a, sizeof(a), c->fmt, f);
+		snprintf(b, sizeof(b), c->fmt, f);
+		break;
+	case 4:
+		textFormat(a, sizeof(a), c->fmt, f, -f, 0.5f * f, f + 0.25f);
+		snprintf(b, sizeof(b), c->fmt, f, -f, 0.5f * f, f + 0.25f);
+		break;
+	default:
+		textFormat(a, sizeof(a), c->fmt, "I2C", ints[0]);
+		snprintf(b, sizeof(b), c->fmt, "I2C", ints[0]);
+		break;
+	}
+
+	return strcmp(a, b) == 0;
+}
+
+int main(int argc, char **argv) {
+	uint32_t iterations = (argc > 1) ? (uint32_t)atol(argv[1]) : 1000000;
+	uint64_t sum = 0;
+
+	if (iterations == 0) {
+		fprintf(stderr, "bad iteration count\n");
+		return 1;
+	}
+
+	// Integers of every length, floats of the magnitudes telemetry sends
+	for (int i = 0; i < BENCH_ARGS; i++) {
+		ints[i] = (int32_t)randomBits() >> (randomBits() % 31);
+		floats[i] = ((float)(randomBits() % 2000001) - 1000000.0f) / (float)(1u << (randomBits() % 20));
+	}
+
+	printf("textFormat vs snprintf, %lu calls per case\n", (unsigned long)iterations);
+	printf("%-10s %-26s %12s %12s %8s\n", "case", "format", "textFormat", "snprintf", "ratio");
+	for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+		char fmt[32];
+		size_t j = 0;
+
+		if (!matches(&cases[c])) {
+			fprintf(stderr, "%s: textFormat and snprintf disagree\n", cases[c].name);
+			return 1;
+		}
+
+		// Show the format with its escapes
+		for (const char *p = cases[c].fmt; *p != '\0' && j < sizeof(fmt) - 3; p++) {
+			if (*p == '\n' || *p == '\r') {
+				fmt[j++] = '\\';
+				fmt[j++] = (*p == '\n') ? 'n' : 'r';
+			} else {
+				fmt[j++] = *p;
+			}
+		}
+		fmt[j] = '\0';
+
+		double tText = timeCase(true, &cases[c], iterations, &sum);
+		double tLib = timeCase(false, &cases[c], iterations, &sum);
+		printf("%-10s %-26s %9.1f ns %9.1f ns %7.2fx\n", cases[c].name, fmt, tText, tLib, tLib / tText);
+	}
+
+	// Keeps the outputs live
+	printf("(length sum %lu)\n", (unsigned long)sum);
+
+	return 0;
+}
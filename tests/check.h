@@ -0,0 +1,58 @@
+/**
+ * @file
+ *
+ * @brief Minimal checks for the host tests
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Each test is a plain program: CHECK() and CHECK_NEAR() print failures as
+ * they happen, checkDone() prints the tally and gives the exit code.
+ *
+ */
+
+#ifndef CHECK_H_
+#define CHECK_H_
+
+#include <stdio.h>
+#include <math.h>
+
+static int checkCount = 0;		///< Checks run
+static int checkFailed = 0;		///< Checks failed
+
+/**
+ * @brief Fail the test if c is false
+ */
+#define CHECK(c) do { \
+		checkCount++; \
+		if (!(c)) { \
+			checkFailed++; \
+			printf("%s:%d: FAIL %s\n", __FILE__, __LINE__, #c); \
+		} \
+	} while (0)
+
+/**
+ * @brief Fail the test unless |a - b| <= tol
+ */
+#define CHECK_NEAR(a, b, tol) do { \
+		double checkA = (a), checkB = (b); \
+		checkCount++; \
+		if (!(fabs(checkA - checkB) <= (tol))) { \
+			checkFailed++; \
+			printf("%s:%d: FAIL %s = %g, expected %s = %g +/- %g\n", __FILE__, __LINE__, \
+					#a, checkA, #b, checkB, (double)(tol)); \
+		} \
+	} while (0)
+
+/**
+ * @brief Print the tally
+ * @param name Test name
+ * @return Exit code: 0 if every check passed
+ */
+static inline int checkDone(const char *name) {
+	printf("%s: %d checks, %d failed\n", name, checkCount, checkFailed);
+	return checkFailed ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,234 @@
+/**
+ * @file
+ *
+ * @brief Host versions of the CMSIS-DSP routines used by Lib
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * The DSP library itself is linked only into the firmware. These follow the
+ * scalar reference code of the Cortex-M4 build closely enough to be
+ * bit-exact for the fixed-point filters (same accumulator widths, shifts and
+ * saturation), so fixed-point tests see the same rounding as the target.
+ *
+ */
+
+#include "arm_math.h"
+#include <string.h>
+
+/**
+ * @brief Saturate a 32-bit value to a signed field of the given width
+ */
+static q31_t hostSsat(q63_t x, int bits) {
+	q63_t hi = ((q63_t)1 << (bits - 1)) - 1;
+	q63_t lo = -((q63_t)1 << (bits - 1));
+
+	return (q31_t)(x > hi ? hi : (x < lo ? lo : x));
+}
+
+void arm_float_to_q15(float32_t *pSrc, q15_t *pDst, uint32_t blockSize) {
+	for (uint32_t i = 0; i < blockSize; i++) {
+		pDst[i] = (q15_t)hostSsat((q63_t)(pSrc[i] * 32768.0f), 16);
+	}
+}
+
+void arm_float_to_q31(float32_t *pSrc, q31_t *pDst, uint32_t blockSize) {
+	for (uint32_t i = 0; i < blockSize; i++) {
+		pDst[i] = hostSsat((q63_t)((double)pSrc[i] * 2147483648.0), 32);
+	}
+}
+
+void arm_biquad_cascade_df1_init_q15(arm_biquad_casd_df1_inst_q15 *S, uint8_t numStages,
+		q15_t *pCoeffs, q15_t *pState, int8_t postShift) {
+	S->numStages = numStages;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	S->postShift = postShift;
+	memset(pState, 0, 4u * numStages * sizeof(q15_t));
+}
+
+void arm_biquad_cascade_df1_fast_q15(const arm_biquad_casd_df1_inst_q15 *S, q15_t *pSrc,
+		q15_t *pDst, uint32_t blockSize) {
+	q15_t *in = pSrc;
+	int shift = 15 - S->postShift;
+
+	for (int stage = 0; stage < S->numStages; stage++) {
+		const q15_t *c = &S->pCoeffs[6*stage];	// {b0, 0, b1, b2, a1, a2}
+		q15_t *st = &S->pState[4*stage];		// {x[n-1], x[n-2], y[n-1], y[n-2]}
+
+		for (uint32_t n = 0; n < blockSize; n++) {
+			// 32-bit accumulator, as __SMUAD/__SMLAD
+			q31_t acc = (q31_t)((int64_t)c[0]*in[n] + (int64_t)c[2]*st[0] + (int64_t)c[3]*st[1]
+					+ (int64_t)c[4]*st[2] + (int64_t)c[5]*st[3]);
+			q15_t out = (q15_t)hostSsat(acc >> shift, 16);
+
+			st[1] = st[0];
+			st[0] = in[n];
+			st[3] = st[2];
+			st[2] = out;
+			pDst[n] = out;
+		}
+
+		in = pDst;
+	}
+}
+
+void arm_biquad_cascade_df1_init_q31(arm_biquad_casd_df1_inst_q31 *S, uint8_t numStages,
+		q31_t *pCoeffs, q31_t *pState, int8_t postShift) {
+	S->numStages = numStages;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	S->postShift = postShift;
+	memset(pState, 0, 4u * numStages * sizeof(q31_t));
+}
+
+void arm_biquad_cascade_df1_fast_q31(const arm_biquad_casd_df1_inst_q31 *S, q31_t *pSrc,
+		q31_t *pDst, uint32_t blockSize) {
+	q31_t *in = pSrc;
+	int shift = S->postShift + 1;
+
+	for (uint32_t stage = 0; stage < S->numStages; stage++) {
+		const q31_t *c = &S->pCoeffs[5*stage];	// {b0, b1, b2, a1, a2}
+		q31_t *st = &S->pState[4*stage];		// {x[n-1], x[n-2], y[n-1], y[n-2]}
+
+		for (uint32_t n = 0; n < blockSize; n++) {
+			// Each product keeps its upper 32 bits, as in the fast routine
+			q31_t acc = (q31_t)(((q63_t)c[0]*in[n]) >> 32);
+			acc += (q31_t)(((q63_t)c[1]*st[0]) >> 32);
+			acc += (q31_t)(((q63_t)c[2]*st[1]) >> 32);
+			acc += (q31_t)(((q63_t)c[3]*st[2]) >> 32);
+			acc += (q31_t)(((q63_t)c[4]*st[3]) >> 32);
+			q31_t out = (q31_t)((uint32_t)acc << shift);
+
+			st[1] = st[0];
+			st[0] = in[n];
+			st[3] = st[2];
+			st[2] = out;
+			pDst[n] = out;
+		}
+
+		in = pDst;
+	}
+}
+
+void arm_biquad_cascade_df2T_init_f32(arm_biquad_cascade_df2T_instance_f32 *S, uint8_t numStages,
+		float32_t *pCoeffs, float32_t *pState) {
+	S->numStages = numStages;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	memset(pState, 0, 2u * numStages * sizeof(float32_t));
+}
+
+void arm_biquad_cascade_df2T_f32(const arm_biquad_cascade_df2T_instance_f32 *S, float32_t *pSrc,
+		float32_t *pDst, uint32_t blockSize) {
+	float32_t *in = pSrc;
+
+	for (int stage = 0; stage < S->numStages; stage++) {
+		const float32_t *c = &S->pCoeffs[5*stage];	// {b0, b1, b2, a1, a2}
+		float32_t *st = &S->pState[2*stage];		// {d1, d2}
+
+		for (uint32_t n = 0; n < blockSize; n++) {
+			float32_t x = in[n];
+			float32_t y = c[0]*x + st[0];
+
+			st[0] = c[1]*x + c[3]*y + st[1];
+			st[1] = c[2]*x + c[4]*y;
+			pDst[n] = y;
+		}
+
+		in = pDst;
+	}
+}
+
+void arm_fir_init_f32(arm_fir_instance_f32 *S, uint16_t numTaps, float32_t *pCoeffs,
+		float32_t *pState, uint32_t blockSize) {
+	S->numTaps = numTaps;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	memset(pState, 0, (numTaps + blockSize - 1u) * sizeof(float32_t));
+}
+
+void arm_fir_f32(const arm_fir_instance_f32 *S, float32_t *pSrc, float32_t *pDst, uint32_t blockSize) {
+	uint16_t taps = S->numTaps;
+	float32_t *st = S->pState;		// oldest sample first, then the new block
+
+	memcpy(&st[taps - 1], pSrc, blockSize * sizeof(float32_t));
+
+	// Coefficients are stored time-reversed, so both run oldest first
+	for (uint32_t n = 0; n < blockSize; n++) {
+		float32_t acc = 0.0f;
+		for (uint16_t k = 0; k < taps; k++) {
+			acc += st[n + k] * S->pCoeffs[k];
+		}
+		pDst[n] = acc;
+	}
+
+	memmove(st, &st[blockSize], (taps - 1u) * sizeof(float32_t));
+}
+
+void arm_mat_init_f32(arm_matrix_instance_f32 *S, uint16_t nRows, uint16_t nColumns, float32_t *pData) {
+	S->numRows = nRows;
+	S->numCols = nColumns;
+	S->pData = pData;
+}
+
+arm_status arm_mat_mult_f32(const arm_matrix_instance_f32 *pSrcA, const arm_matrix_instance_f32 *pSrcB,
+		arm_matrix_instance_f32 *pDst) {
+	if (pSrcA->numCols != pSrcB->numRows || pDst->numRows != pSrcA->numRows
+			|| pDst->numCols != pSrcB->numCols) {
+		return ARM_MATH_SIZE_MISMATCH;
+	}
+
+	for (uint16_t i = 0; i < pSrcA->numRows; i++) {
+		for (uint16_t j = 0; j < pSrcB->numCols; j++) {
+			float32_t acc = 0.0f;
+			for (uint16_t k = 0; k < pSrcA->numCols; k++) {
+				acc += pSrcA->pData[i*pSrcA->numCols + k] * pSrcB->pData[k*pSrcB->numCols + j];
+			}
+			pDst->pData[i*pDst->numCols + j] = acc;
+		}
+	}
+
+	return ARM_MATH_SUCCESS;
+}
+
+arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32 *S, uint16_t fftLen) {
+	memset(S, 0, sizeof(*S));
+	S->fftLenRFFT = fftLen;
+	return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @brief Forward real FFT as a direct DFT, in the CMSIS output layout
+ *
+ * pOut[0] and pOut[1] hold the DC and Nyquist bins (both real), followed by
+ * the real and imaginary parts of bins 1 to N/2-1. The inverse is not needed.
+ */
+void arm_rfft_fast_f32(arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag) {
+	uint16_t n = S->fftLenRFFT;
+	(void)ifftFlag;
+
+	for (uint16_t k = 0; k <= n/2; k++) {
+		double re = 0.0, im = 0.0;
+		for (uint16_t t = 0; t < n; t++) {
+			double w = 2.0 * M_PI * k * t / n;
+			re += p[t] * cos(w);
+			im -= p[t] * sin(w);
+		}
+		if (k == 0) {
+			pOut[0] = (float32_t)re;
+		} else if (k == n/2) {
+			pOut[1] = (float32_t)re;
+		} else {
+			pOut[2*k] = (float32_t)re;
+			pOut[2*k + 1] = (float32_t)im;
+		}
+	}
+}
+
+void arm_cmplx_mag_f32(float32_t *pSrc, float32_t *pDst, uint32_t numSamples) {
+	for (uint32_t i = 0; i < numSamples; i++) {
+		pDst[i] = sqrtf(pSrc[2*i]*pSrc[2*i] + pSrc[2*i + 1]*pSrc[2*i + 1]);
+	}
+}
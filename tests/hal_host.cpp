@@ -0,0 +1,256 @@
+/**
+ * @file
+ *
+ * @brief Host versions of the HAL calls the i2c driver makes
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Transfers only start here. A test ends them with hostI2CComplete() or
+ * hostI2CFail(), which run the HAL callbacks the way the DMA and error
+ * interrupts do on the target.
+ *
+ */
+
+#include "hal_host.h"
+#include "DMA_IT.h"
+#include <string.h>
+
+hostDwtType hostDwt;
+CoreDebug_Type hostCoreDebug;
+RCC_TypeDef hostRcc;
+I2C_TypeDef hostI2C[3];
+
+hostI2CBus hostI2CBuses[3];
+int hostErrors = 0;
+errDC9000 hostLastError = errDC9000::FLIPPING;
+
+uint32_t SystemCoreClock = HOST_CORE_CLOCK;
+
+// The HAL handles DMA_IT.c owns on the target
+I2C_HandleTypeDef i2c1Handle;
+I2C_HandleTypeDef i2c2Handle;
+I2C_HandleTypeDef i2c3Handle;
+
+/**
+ * @brief Bus of a HAL handle
+ * @return 0 to 2 for I2C1 to I2C3
+ */
+int hostBusIndex(I2C_HandleTypeDef *hi2c) {
+	return (hi2c == &i2c1Handle) ? 0 : (hi2c == &i2c2Handle) ? 1 : 2;
+}
+
+/**
+ * @brief Forget what was recorded and answer every start with HAL_OK
+ */
+void hostI2CReset(void) {
+	memset(hostI2CBuses, 0, sizeof(hostI2CBuses));
+	for (int i = 0; i < 3; i++) {
+		hostI2CBuses[i].failWith = HAL_OK;
+	}
+	hostErrors = 0;
+}
+
+/**
+ * @brief Let time pass without reading the cycle counter
+ */
+void hostAdvanceUs(uint32_t us) {
+	hostDwt.CYCCNT.now += us * (HOST_CORE_CLOCK / 1000000);
+}
+
+/**
+ * @brief The active transfer of a bus completes
+ * @param hi2c Bus
+ * @param data What a read brings in, NULL for a write
+ */
+void hostI2CComplete(I2C_HandleTypeDef *hi2c, const uint8_t *data) {
+	hostI2CBus *b = &hostI2CBuses[hostBusIndex(hi2c)];
+
+	if (b->read && data != NULL) {
+		memcpy(b->pData, data, b->size);
+	}
+	hi2c->State = HAL_I2C_STATE_READY;
+	if (hi2c->hdmarx != NULL) {
+		hi2c->hdmarx->State = HAL_DMA_STATE_READY;
+	}
+	if (hi2c->hdmatx != NULL) {
+		hi2c->hdmatx->State = HAL_DMA_STATE_READY;
+	}
+
+	if (b->mem) {
+		b->read ? HAL_I2C_MemRxCpltCallback(hi2c) : HAL_I2C_MemTxCpltCallback(hi2c);
+	} else {
+		b->read ? HAL_I2C_MasterRxCpltCallback(hi2c) : HAL_I2C_MasterTxCpltCallback(hi2c);
+	}
+}
+
+/**
+ * @brief The error interrupt of a bus fires, leaving its DMA stream running
+ * @param hi2c      Bus
+ * @param errorCode HAL_I2C_ERROR_x flags
+ */
+void hostI2CFail(I2C_HandleTypeDef *hi2c, uint32_t errorCode) {
+	hi2c->ErrorCode = errorCode;
+	hi2c->State = HAL_I2C_STATE_READY;
+	HAL_I2C_ErrorCallback(hi2c);
+}
+
+/**
+ * @brief Start a transfer, or fail to as the test asked
+ */
+static HAL_StatusTypeDef hostStart(I2C_HandleTypeDef *hi2c, uint16_t devAddr, uint16_t memAddr, uint8_t *pData,
+		uint16_t size, bool read, bool mem) {
+	hostI2CBus *b = &hostI2CBuses[hostBusIndex(hi2c)];
+
+	b->starts++;
+	b->devAddr = devAddr;
+	b->memAddr = memAddr;
+	b->pData = pData;
+	b->size = size;
+	b->read = read;
+	b->mem = mem;
+
+	if (b->failStarts > 0) {
+		b->failStarts--;
+		hi2c->ErrorCode = b->failCode;
+		if (read && hi2c->hdmarx != NULL) {
+			hi2c->hdmarx->State = HAL_DMA_STATE_BUSY;	// Left armed, as the HAL does
+		}
+		return b->failWith;
+	}
+
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	hi2c->State = read ? HAL_I2C_STATE_BUSY_RX : HAL_I2C_STATE_BUSY_TX;
+	DMA_HandleTypeDef *dma = read ? hi2c->hdmarx : hi2c->hdmatx;
+	if (dma != NULL) {
+		dma->State = HAL_DMA_STATE_BUSY;
+	}
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+		uint16_t Size) {
+	return hostStart(hi2c, DevAddress, 0, pData, Size, false, false);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+		uint16_t Size) {
+	return hostStart(hi2c, DevAddress, 0, pData, Size, true, false);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+	(void)MemAddSize;
+	return hostStart(hi2c, DevAddress, MemAddress, pData, Size, false, true);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+	(void)MemAddSize;
+	return hostStart(hi2c, DevAddress, MemAddress, pData, Size, true, true);
+}
+
+HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef *hi2c) {
+	return hi2c->State;
+}
+
+/**
+ * @brief Initialize the peripheral: the bus is idle again unless it is held
+ */
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c) {
+	hostI2CBus *b = &hostI2CBuses[hostBusIndex(hi2c)];
+
+	b->inits++;
+	HAL_I2C_MspInit(hi2c);
+	hi2c->Instance->SR2 = b->busHeld ? I2C_SR2_BUSY : 0;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	hi2c->State = HAL_I2C_STATE_READY;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c) {
+	hostI2CBuses[hostBusIndex(hi2c)].deInits++;
+	HAL_I2C_MspDeInit(hi2c);
+	hi2c->State = HAL_I2C_STATE_RESET;
+	return HAL_OK;
+}
+
+void HAL_I2C_ER_IRQHandler(I2C_HandleTypeDef *hi2c) {
+	(void)hi2c;
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma) {
+	hdma->State = HAL_DMA_STATE_READY;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma) {
+	hdma->State = HAL_DMA_STATE_RESET;
+	return HAL_OK;
+}
+
+/**
+ * @brief Abort a stream, counted against the bus it belongs to
+ */
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma) {
+	I2C_HandleTypeDef *hi2c = (I2C_HandleTypeDef *)hdma->Parent;
+
+	if (hi2c != NULL) {
+		hostI2CBuses[hostBusIndex(hi2c)].dmaAborts++;
+	}
+	hdma->State = HAL_DMA_STATE_READY;
+	return HAL_OK;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init) {
+	(void)GPIOx;
+	(void)GPIO_Init;
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin) {
+	(void)GPIOx;
+	(void)GPIO_Pin;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+	(void)GPIOx;
+	(void)GPIO_Pin;
+	(void)PinState;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+	(void)GPIOx;
+	(void)GPIO_Pin;
+	return GPIO_PIN_SET;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority) {
+	(void)IRQn;
+	(void)PreemptPriority;
+	(void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) {
+	(void)IRQn;
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn) {
+	(void)IRQn;
+}
+
+/**
+ * @brief No DShot or UART streams exist on the host, so none is ever taken
+ */
+int dmaStreamInUse(const DMA_HandleTypeDef *hdma) {
+	(void)hdma;
+	return 0;
+}
+
+/**
+ * @brief Record a fatal error; the target would stop here
+ */
+void Error_Handler(errDC9000 e) {
+	hostErrors++;
+	hostLastError = e;
+}
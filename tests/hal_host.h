@@ -0,0 +1,112 @@
+/**
+ * @file
+ *
+ * @brief Host stand-ins for the HAL calls and core registers the i2c driver uses
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Lib/I2C.cpp is built unchanged against the vendored HAL headers, with this
+ * file forced in first (-include). The registers it touches directly (I2Cx,
+ * RCC, DWT, CoreDebug) become plain structs, interrupt masking does nothing,
+ * and the HAL functions it calls are replaced by hal_host.cpp, which records
+ * what was asked of each bus and lets a test decide how it answers.
+ *
+ * The DWT cycle counter moves on by HOST_CYCLES_PER_READ every time it is
+ * read, so the driver's bounded busy-waits end the way they do on the target.
+ *
+ */
+
+#ifndef HAL_HOST_H_
+#define HAL_HOST_H_
+
+#include "stm32f4xx_hal.h"
+#include "errDC9000.h"
+
+#define HOST_CORE_CLOCK			168000000	///< SystemCoreClock on the host [Hz]
+#define HOST_CYCLES_PER_READ	168			///< Cycles that pass per read of DWT->CYCCNT (1 us)
+
+/**
+ * @brief A cycle counter that advances as it is read
+ */
+class hostCycleCounter {
+public:
+	uint32_t now;		///< Current count
+
+	operator uint32_t() {
+		now += HOST_CYCLES_PER_READ;
+		return now;
+	}
+
+	hostCycleCounter &operator=(uint32_t v) {
+		now = v;
+		return *this;
+	}
+};
+
+/**
+ * @brief The DWT registers the firmware uses
+ */
+typedef struct {
+	uint32_t CTRL;				///< Control
+	hostCycleCounter CYCCNT;	///< Cycle count
+} hostDwtType;
+
+extern hostDwtType hostDwt;
+extern CoreDebug_Type hostCoreDebug;
+extern RCC_TypeDef hostRcc;
+extern I2C_TypeDef hostI2C[3];
+
+#undef DWT
+#undef CoreDebug
+#undef RCC
+#undef I2C1
+#undef I2C2
+#undef I2C3
+#define DWT			(&hostDwt)
+#define CoreDebug	(&hostCoreDebug)
+#define RCC			(&hostRcc)
+#define I2C1		(&hostI2C[0])
+#define I2C2		(&hostI2C[1])
+#define I2C3		(&hostI2C[2])
+
+// No interrupts on the host
+#define __disable_irq()		((void)0)
+#define __get_PRIMASK()		(0U)
+#define __set_PRIMASK(x)	((void)(x))
+
+/**
+ * @brief What a test has asked of one bus, and how the HAL answers it
+ */
+typedef struct {
+	// Answers
+	int failStarts;				///< Transfer starts left to fail
+	HAL_StatusTypeDef failWith;	///< What a failing start returns
+	uint32_t failCode;			///< ErrorCode a failing HAL_ERROR start leaves
+	bool busHeld;				///< A slave holds the bus: BUSY stays set through recovery
+
+	// Record
+	int starts;					///< Transfers started (HAL_OK or not)
+	int inits;					///< HAL_I2C_Init() calls
+	int deInits;				///< HAL_I2C_DeInit() calls
+	int dmaAborts;				///< HAL_DMA_Abort() calls
+	uint16_t devAddr;			///< Slave address of the last start
+	uint16_t memAddr;			///< Register of the last start
+	uint8_t *pData;				///< Buffer of the last start
+	uint16_t size;				///< Size of the last start
+	bool read;					///< The last start was a read
+	bool mem;					///< The last start was a memory transfer
+} hostI2CBus;
+
+extern hostI2CBus hostI2CBuses[3];
+extern int hostErrors;				///< Error_Handler() calls
+extern errDC9000 hostLastError;		///< Error of the last Error_Handler() call
+
+int hostBusIndex(I2C_HandleTypeDef *hi2c);
+void hostI2CReset(void);
+void hostAdvanceUs(uint32_t us);
+void hostI2CComplete(I2C_HandleTypeDef *hi2c, const uint8_t *data);
+void hostI2CFail(I2C_HandleTypeDef *hi2c, uint32_t errorCode);
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file
+ *
+ * @brief Host test of the battery meter (oversampling, filter, consumption)
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+#include "BatteryMonitor.h"
+#include "check.h"
+
+/**
+ * @brief Fill n interleaved scans with a constant voltage and current count
+ */
+static void fillScans(uint16_t *scans, uint16_t n, uint16_t v, uint16_t i) {
+	for (uint16_t k = 0; k < n; k++) {
+		scans[BATT_CHANNELS*k] = v;
+		scans[BATT_CHANNELS*k + 1] = i;
+	}
+}
+
+int main(void) {
+	uint16_t scans[BATT_CHANNELS*BATT_OVERSAMPLE];
+	const float dt = (float)BATT_OVERSAMPLE / BATT_SAMPLE_HZ;
+
+	// Gains of 0.01 V and 0.01 A per count, 0.5 A offset
+	BatteryMeter m(0.01f, 0.01f, 0.5f, BATT_FILTER_ALPHA);
+	CHECK(m.getVoltage() == 0.0f && m.getCurrent() == 0.0f && m.getConsumed() == 0.0f);
+
+	// The first block sets the filter directly, no ramp from 0
+	fillScans(scans, BATT_OVERSAMPLE, 1200, 1050);
+	m.addBlock(scans, BATT_OVERSAMPLE, dt);
+	CHECK_NEAR(m.getVoltage(), 12.0f, 1e-4f);
+	CHECK_NEAR(m.getCurrent(), 10.0f, 1e-4f);
+
+	// Oversampling averages the block, dither below one count is kept
+	for (uint16_t k = 0; k < BATT_OVERSAMPLE; k++) {
+		scans[BATT_CHANNELS*k] = (k & 1) ? 1201 : 1200;
+	}
+	BatteryMeter avg(0.01f, 0.01f, 0.5f, 1.0f);
+	avg.addBlock(scans, BATT_OVERSAMPLE, dt);
+	CHECK_NEAR(avg.getVoltage(), 12.005f, 1e-4f);
+
+	// A step is low-pass filtered with weight alpha per block
+	fillScans(scans, BATT_OVERSAMPLE, 1100, 1050);
+	m.addBlock(scans, BATT_OVERSAMPLE, dt);
+	CHECK_NEAR(m.getVoltage(), 12.0f - BATT_FILTER_ALPHA * 1.0f, 1e-4f);
+	for (int k = 0; k < 200; k++) {
+		m.addBlock(scans, BATT_OVERSAMPLE, dt);
+	}
+	CHECK_NEAR(m.getVoltage(), 11.0f, 1e-3f);
+
+	// Consumption integrates the unfiltered current: 10 A for 202 blocks
+	CHECK_NEAR(m.getConsumed(), 10.0f * 202 * dt * 1000.0f / 3600.0f, 1e-3f);
+
+	// One hour at 2 A is 2000 mAh
+	BatteryMeter c(0.01f, 0.01f, 0.0f, BATT_FILTER_ALPHA);
+	fillScans(scans, BATT_OVERSAMPLE, 1200, 200);
+	for (int k = 0; k < 3600; k++) {
+		c.addBlock(scans, BATT_OVERSAMPLE, 1.0f);
+	}
+	CHECK_NEAR(c.getConsumed(), 2000.0f, 0.5f);
+	c.resetConsumed();
+	CHECK(c.getConsumed() == 0.0f);
+	CHECK_NEAR(c.getCurrent(), 2.0f, 1e-4f);
+
+	// An empty block changes nothing
+	c.addBlock(scans, 0, 1.0f);
+	CHECK(c.getConsumed() == 0.0f);
+
+	return checkDone("test_battery");
+}
@@ -0,0 +1,221 @@
+/**
+ * @file
+ *
+ * @brief Host test of the in-flight gyro bias estimator over a simulated flight
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * The gyro bias follows the temperature with a fixed slope per axis, plus a
+ * slow random walk. The vehicle warms up on the ground, flies two minutes
+ * with gentle pitch and roll, yaw turns and climbs while it warms up more,
+ * then lands and cools a little. Temperature is read at 1 Hz, rounded to a
+ * degree like the L3GD20H reports it; samples come at the 200 Hz the IMU
+ * runs at.
+ *
+ */
+
+#include "BiasEstimator.h"
+#include "check.h"
+#include <random>
+
+#ifndef PI
+#define PI 3.14159265358979f
+#endif
+
+#define DT				0.005f		///< Sample time [s]
+#define GROUND_END		30.0f		///< Take off [s]
+#define FLIGHT_END		150.0f		///< Landing [s]
+#define LANDED_END		170.0f		///< End of the run [s]
+#define SETTLE_TIME		20.0f		///< Time at the end of the flight the errors are averaged over [s]
+
+static const float slopeTrue[3] = { 0.03f, -0.02f, 0.025f };	///< Bias change [deg/s per degC]
+static const float accOffsetTrue[3] = { 0.0f, 0.0f, 0.03f };	///< Left over by the calibration [g]
+static float walk[3] = { 0.0f, 0.0f, 0.0f };					///< Random walk part of the bias [deg/s]
+
+static std::mt19937 rng(3);
+static std::normal_distribution<float> gauss(0.0f, 1.0f);
+
+/**
+ * @brief True gyro bias
+ * @param axis 0 to 2 for x, y, z
+ * @param temp Gyro temperature [degC]
+ */
+static float biasTrue(int axis, float temp) {
+	return slopeTrue[axis] * (temp - 25.0f) + walk[axis];
+}
+
+/**
+ * @brief Gyro temperature through the run: the ground, flight and landing
+ * @param t Time [s]
+ */
+static float temperature(float t) {
+	if (t < GROUND_END) {
+		return 25.0f + 3.0f * t / GROUND_END;
+	} else if (t < FLIGHT_END) {
+		return 28.0f + 12.0f * (t - GROUND_END) / (FLIGHT_END - GROUND_END);
+	}
+	return 40.0f - 2.0f * (t - FLIGHT_END) / (LANDED_END - FLIGHT_END);
+}
+
+/**
+ * @brief Bias errors at a point of the run
+ */
+typedef struct {
+	float err[3];		///< Estimate less the true bias [deg/s]
+	float raw[3];		///< True bias, the error with no estimator [deg/s]
+} biasResult;
+
+/**
+ * @brief Print the errors at a point of the run
+ */
+static void printResult(const char *name, BiasEstimator &est, const biasResult &r) {
+	printf("%-8s bias err %+.3f %+.3f %+.3f (uncorrected %+.3f %+.3f %+.3f) deg/s, slope %+.3f %+.3f %+.3f\n", name,
+			r.err[0], r.err[1], r.err[2], r.raw[0], r.raw[1], r.raw[2], est.getSlope(0), est.getSlope(1),
+			est.getSlope(2));
+}
+
+int main(void) {
+	BiasEstimator est;
+	biasResult ground, flight, landed;
+	const float still[3] = { 0.0f, 0.0f, -1.0f };
+	const float level[2] = { 0.0f, 0.0f };
+
+	// Nothing learnt to start with, and no such axis
+	CHECK(est.getGyroBias(0) == 0.0f && est.getSlope(1) == 0.0f && est.getAccOffset(2) == 0.0f);
+	CHECK(est.getGyroBias(3) == 0.0f && est.getSlope(3) == 0.0f && est.getAccOffset(3) == 0.0f);
+	CHECK(est.getStillWindows() == 0);
+
+	// Moving on the ground: no window passes
+	for (int k = 0; k < 200; k++) {
+		float g[3] = { 30.0f * sinf(k * 0.3f), 0.0f, 0.0f };
+		est.update(g, still, level, true, DT);
+	}
+	CHECK(est.getStillWindows() == 0);
+
+	// The flight
+	est.reset(25.0f);
+	float t = 0.0f, lastRead = -1.0f;
+	double errSum[3] = { 0.0, 0.0, 0.0 }, rawSum[3] = { 0.0, 0.0, 0.0 };
+	int n = 0;
+	uint32_t groundWindows = 0, flightWindows = 0;
+
+	while (t < LANDED_END) {
+		bool onGround = t < GROUND_END || t >= FLIGHT_END;
+		float temp = temperature(t);
+
+		for (int i = 0; i < 3; i++) {
+			walk[i] += 0.002f * sqrtf(DT) * gauss(rng);
+		}
+		if (t - lastRead >= 1.0f) {
+			est.setTemperature(roundf(temp));
+			est.setTemperature(NAN);		// A failed read is skipped
+			lastRead = t;
+		}
+
+		float angle[2] = { 0.0f, 0.0f }, rate[3] = { 0.0f, 0.0f, 0.0f };
+		float accMag = 1.0f;
+		if (!onGround) {
+			angle[0] = 5.0f * sinf(0.7f * t);
+			rate[0] = 5.0f * 0.7f * cosf(0.7f * t);
+			angle[1] = 4.0f * sinf(0.5f * t + 1.0f);
+			rate[1] = 4.0f * 0.5f * cosf(0.5f * t + 1.0f);
+			rate[2] = 10.0f * sinf(0.2f * t);
+			if (fmodf(t, 20.0f) < 2.0f) {
+				accMag = 1.3f;		// Climbing
+			}
+		}
+
+		float g[3], a[3], ac[3], accAngle[2];
+		float gyroNoise = onGround ? 0.12f : 0.4f;
+		float accNoise = onGround ? 0.004f : 0.05f;
+		float p = angle[0] * PI / 180.0f, r = angle[1] * PI / 180.0f;
+		a[0] = accMag * sinf(p);
+		a[1] = accMag * sinf(r) * cosf(p);
+		a[2] = -accMag * cosf(r) * cosf(p);
+		for (int i = 0; i < 3; i++) {
+			g[i] = rate[i] + biasTrue(i, temp) + gyroNoise * gauss(rng);
+			a[i] += accOffsetTrue[i] + accNoise * gauss(rng);
+			ac[i] = a[i] - est.getAccOffset(i);
+		}
+
+		// The angles the way IMU gets them, with the learnt offset taken off.
+		// A climb also tilts what the accelerometer sees.
+		accAngle[0] = atan2f(ac[0], sqrtf(ac[1] * ac[1] + ac[2] * ac[2])) * 180.0f / PI;
+		accAngle[1] = atan2f(ac[1], sqrtf(ac[0] * ac[0] + ac[2] * ac[2])) * 180.0f / PI;
+		if (accMag > 1.1f) {
+			accAngle[0] += 8.0f;
+		}
+
+		uint32_t before = est.getStillWindows();
+		est.update(g, a, accAngle, onGround, DT);
+		if (onGround) {
+			groundWindows += est.getStillWindows() - before;
+		} else {
+			flightWindows += est.getStillWindows() - before;
+		}
+
+		float tNext = t + DT;
+		biasResult *end = NULL;
+		if (t < GROUND_END && tNext >= GROUND_END) {
+			end = &ground;
+		} else if (t < FLIGHT_END && tNext >= FLIGHT_END) {
+			end = &flight;
+		} else if (tNext >= LANDED_END) {
+			end = &landed;
+		}
+		for (int i = 0; i < 3; i++) {
+			float b = biasTrue(i, temp);
+			if (end != NULL) {
+				end->err[i] = est.getGyroBias(i) - b;
+				end->raw[i] = b;
+			}
+			if (!onGround && tNext > FLIGHT_END - SETTLE_TIME) {
+				errSum[i] += fabsf(est.getGyroBias(i) - b);
+				rawSum[i] += fabsf(b);
+			}
+		}
+		if (!onGround && tNext > FLIGHT_END - SETTLE_TIME) {
+			n++;
+		}
+		t = tNext;
+	}
+
+	printResult("ground", est, ground);
+	printResult("flight", est, flight);
+	printResult("landed", est, landed);
+	printf("last %.0f s of flight, mean |err| %.3f %.3f %.3f (uncorrected %.3f %.3f %.3f) deg/s\n", SETTLE_TIME,
+			errSum[0] / n, errSum[1] / n, errSum[2] / n, rawSum[0] / n, rawSum[1] / n, rawSum[2] / n);
+	printf("acc offset %.4f %.4f %.4f g, %lu still windows on the ground, %lu in flight\n", est.getAccOffset(0),
+			est.getAccOffset(1), est.getAccOffset(2), (unsigned long)groundWindows, (unsigned long)flightWindows);
+
+	// Still windows track the bias on the ground, and only there
+	CHECK(groundWindows > 0);
+	CHECK(flightWindows == 0);
+	for (int i = 0; i < 3; i++) {
+		CHECK(fabsf(ground.err[i]) < 0.05f);
+		CHECK(fabsf(landed.err[i]) < 0.05f);
+	}
+
+	// In flight the observer keeps pitch and roll well below the uncorrected
+	// bias; yaw has only the slope learnt on the ground to go on
+	for (int i = 0; i < 2; i++) {
+		CHECK(errSum[i] < 0.25 * rawSum[i]);
+	}
+	CHECK(errSum[2] < 0.6 * rawSum[2]);
+
+	// The slopes have the right sign, and the accelerometer offset is found
+	for (int i = 0; i < 3; i++) {
+		CHECK(est.getSlope(i) * slopeTrue[i] > 0.0f);
+	}
+	CHECK_NEAR(est.getAccOffset(2), accOffsetTrue[2], 0.005f);
+	CHECK(fabsf(est.getAccOffset(0)) < 0.005f && fabsf(est.getAccOffset(1)) < 0.005f);
+
+	// reset() forgets it all
+	est.reset(25.0f);
+	CHECK(est.getGyroBias(0) == 0.0f && est.getSlope(0) == 0.0f && est.getAccOffset(2) == 0.0f);
+	CHECK(est.getStillWindows() == 0);
+
+	return checkDone("test_bias_estimator");
+}
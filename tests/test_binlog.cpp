@@ -0,0 +1,202 @@
+/**
+ * @file
+ *
+ * @brief Host test of the binary logger: format checks, ring and TRACE frames
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * BinLog::now() is replaced by a counter that can also log from inside
+ * write(), the way an interrupt would between the reservation and the commit.
+ * BinLog::drain() is linked against a stand-in for the UART TX queue.
+ *
+ */
+
+#include "BinLog.h"
+#include "Telemetry.h"
+#include "uart.h"
+#include "check.h"
+#include <string.h>
+
+// Format parsing is all compile time
+static_assert(binlogCountArgs("Gx %f") == 1, "one conversion");
+static_assert(binlogCountArgs("100%% %d of %5.2f, %-3u%%") == 3, "%% is not a conversion");
+static_assert(binlogCountArgs("none") == 0, "no conversion");
+static_assert(binlogSpec("a %08.3f b %+d c %x", 0) == 'f', "flags and width skipped");
+static_assert(binlogSpec("a %08.3f b %+d c %x", 1) == 'd', "second conversion");
+static_assert(binlogSpec("a %08.3f b %+d c %x", 2) == 'x', "third conversion");
+static_assert(BinLogArg<float>::fits('g') && !BinLogArg<float>::fits('d'), "float");
+static_assert(BinLogArg<int16_t>::fits('i') && !BinLogArg<int16_t>::fits('u'), "signed");
+static_assert(BinLogArg<uint8_t>::fits('X') && !BinLogArg<uint8_t>::fits('f'), "unsigned");
+static_assert(binlogCountArgs(logFormats[(uint16_t)LogMsg::COMP_TERMS]) == 4, "catalogue");
+
+static uint32_t cycles = 0;			///< Time stamp of the next entry
+static bool interrupt = false;		///< Log from inside the next now()
+static bool blockedInside = false;	///< read() found nothing during the interrupt
+
+uint32_t BinLog::now(void) {
+	if (interrupt) {
+		interrupt = false;
+		BinLogEntry e;
+
+		// The outer entry is reserved but not committed, so it holds up
+		// the reader even once this one is committed behind it
+		binlog<LogMsg::ATTITUDE>(-1.0f, -2.0f);
+		blockedInside = !BinLog::read(&e);
+	}
+	return cycles++;
+}
+
+static uint8_t txBuff[4096];	///< Bytes committed to the stand-in TX queue
+static uint16_t txLen = 0;		///< Bytes in txBuff
+static bool txIdle = true;		///< Value of usart_tx_idle()
+
+uint8_t* usart_tx_reserve(uint16_t len) {
+	if (txLen + len > sizeof(txBuff)) return NULL;
+	return &txBuff[txLen];
+}
+
+void usart_tx_commit(uint16_t len) {
+	txLen += len;
+}
+
+bool usart_tx_idle(void) {
+	return txIdle;
+}
+
+/**
+ * @brief Raw word of a float argument
+ */
+static uint32_t floatWord(float x) {
+	uint32_t w;
+	memcpy(&w, &x, sizeof(w));
+	return w;
+}
+
+/**
+ * @brief Read one entry and check it
+ */
+static bool readIs(LogMsg id, uint8_t n, const uint32_t *args) {
+	BinLogEntry e;
+
+	if (!BinLog::read(&e) || e.id != (uint16_t)id || e.nArgs != n) {
+		return false;
+	}
+	return memcmp(e.args, args, n * sizeof(uint32_t)) == 0;
+}
+
+int main(void) {
+	BinLogEntry e;
+
+	// Nothing to read yet
+	CHECK(!BinLog::read(&e));
+
+	// Arguments are stored raw, in order, with a time stamp
+	cycles = 1000;
+	CHECK(binlog<LogMsg::GYRO_X>(1.5f));
+	CHECK(binlog<LogMsg::COMP_TERMS>(1.0f, -2.0f, 3.25f, 0.0f));
+	CHECK(BinLog::read(&e));
+	CHECK(e.id == (uint16_t)LogMsg::GYRO_X && e.nArgs == 1 && e.time == 1000);
+	CHECK(e.args[0] == floatWord(1.5f));
+	CHECK(BinLog::read(&e));
+	CHECK(e.id == (uint16_t)LogMsg::COMP_TERMS && e.nArgs == 4 && e.time == 1001);
+	CHECK(e.args[0] == floatWord(1.0f) && e.args[1] == floatWord(-2.0f));
+	CHECK(e.args[2] == floatWord(3.25f) && e.args[3] == floatWord(0.0f));
+	CHECK(!BinLog::read(&e));
+
+	// A full ring refuses entries and counts them; what was stored survives
+	int stored = 0;
+	while (binlog<LogMsg::GYRO_Y>((float)stored)) {
+		stored++;
+	}
+	CHECK(stored == BINLOG_WORDS / (BINLOG_HEADER + 1));
+	CHECK(BinLog::getDropped() == 1);
+	CHECK(!binlog<LogMsg::ACC_PITCH>(0.0f));
+	CHECK(BinLog::getDropped() == 2);
+	for (int i = 0; i < stored; i++) {
+		uint32_t w = floatWord((float)i);
+		CHECK(readIs(LogMsg::GYRO_Y, 1, &w));
+	}
+	CHECK(!BinLog::read(&e));
+
+	// Entries wrap around the ring many times over
+	bool wrapOk = true;
+	for (int i = 0; i < 5000; i++) {
+		uint32_t w[2] = { floatWord((float)i), floatWord(-(float)i) };
+		wrapOk &= binlog<LogMsg::ACC_ANGLES>((float)i, -(float)i);
+		wrapOk &= readIs(LogMsg::ACC_ANGLES, 2, w);
+	}
+	CHECK(wrapOk);
+	CHECK(BinLog::getDropped() == 2);
+
+	// An interrupt logging between the reservation and the commit: the
+	// reader waits for the interrupted entry, then gets both in order
+	interrupt = true;
+	CHECK(binlog<LogMsg::ACC_ROLL>(7.0f));
+	CHECK(blockedInside);
+	uint32_t roll = floatWord(7.0f);
+	uint32_t att[2] = { floatWord(-1.0f), floatWord(-2.0f) };
+	CHECK(readIs(LogMsg::ACC_ROLL, 1, &roll));
+	CHECK(readIs(LogMsg::ATTITUDE, 2, att));
+	CHECK(!BinLog::read(&e));
+
+	// drain() waits for an idle UART, then packs whole entries into frames
+	cycles = 0x12345678;
+	for (int i = 0; i < 12; i++) {
+		binlog<LogMsg::GYRO_Z>((float)i);
+	}
+	binlog<LogMsg::COMP_TERMS>(1.0f, 2.0f, 3.0f, 4.0f);
+	txIdle = false;
+	BinLog::drain(10);
+	CHECK(txLen == 0);
+	txIdle = true;
+	BinLog::drain(2);
+	CHECK(txLen > 0);
+	CHECK(BinLog::read(&e) && e.id == (uint16_t)LogMsg::GYRO_Z && e.args[0] == floatWord(10.0f));
+	BinLog::drain(10);
+	CHECK(!BinLog::read(&e));
+
+	TelemetryDecoder d;
+	int frames = 0, entries = 0;
+	bool framesOk = true;
+	for (uint16_t i = 0; i < txLen; i++) {
+		if (!d.feed(txBuff[i])) {
+			continue;
+		}
+		frames++;
+		framesOk &= d.getId() == TelemetryId::TRACE;
+
+		const uint8_t *p = d.getPayload();
+		uint16_t pos = 0;
+		while (pos < d.getLength()) {
+			uint16_t id = telemetryGetU16(&p[pos]);
+			uint8_t n = p[pos + 2];
+			uint32_t time = telemetryGetU16(&p[pos + 3]) | ((uint32_t)telemetryGetU16(&p[pos + 5]) << 16);
+			uint32_t a0 = telemetryGetU16(&p[pos + 7]) | ((uint32_t)telemetryGetU16(&p[pos + 9]) << 16);
+
+			if (entries == 11) {
+				// Entry 10 was read above, not drained
+				framesOk &= id == (uint16_t)LogMsg::GYRO_Z && n == 1 && a0 == floatWord(11.0f);
+				framesOk &= time == 0x12345678u + 11;
+			} else if (entries == 12) {
+				framesOk &= id == (uint16_t)LogMsg::COMP_TERMS && n == 4 && a0 == floatWord(1.0f);
+			} else {
+				framesOk &= id == (uint16_t)LogMsg::GYRO_Z && n == 1 && a0 == floatWord((float)entries);
+				framesOk &= time == 0x12345678u + entries;
+			}
+			pos += 7 + 4 * n;
+			entries++;
+			if (entries == 10) {
+				entries++;
+			}
+		}
+		framesOk &= pos == d.getLength() && d.getLength() <= TELEM_MAX_PAYLOAD;
+	}
+	CHECK(framesOk);
+	CHECK(entries == 13);
+	CHECK(frames == 3);		// 5 + 5 entries in two frames, then the last two
+	CHECK(d.getCrcErrors() == 0 && d.getLost() == 0);
+
+	return checkDone("test_binlog");
+}
@@ -0,0 +1,335 @@
+/**
+ * @file
+ *
+ * @brief Host test of the flight recorder against a simulated flash
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * The storage behaves like NOR flash: programming can only clear bits, and
+ * programming a bit that isn't erased fails the test. Records are checked by
+ * decoding the storage the way pi-station/blackbox2csv.py does.
+ *
+ */
+
+#include "Blackbox.h"
+#include "Framing.h"
+#include "check.h"
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+
+#define STORAGE_SIZE	(128 * 1024)
+
+static uint8_t flash[STORAGE_SIZE];
+static long programs = 0;		///< Words programmed
+static long failAt = -1;		///< Program call that fails, -1 for none
+static bool overwrite = false;	///< A non-erased bit was programmed
+
+static bool flashProgram(uint32_t offset, uint32_t word) {
+	programs++;
+	if (programs == failAt) {
+		return false;
+	}
+	for (int i = 0; i < 4; i++) {
+		uint8_t b = (uint8_t)(word >> (8 * i));
+		if ((flash[offset + i] & b) != b) {
+			overwrite = true;
+		}
+		flash[offset + i] &= b;
+	}
+	return true;
+}
+
+static bool flashErase(void) {
+	memset(flash, 0xFF, sizeof(flash));
+	return true;
+}
+
+static const BlackboxStorageOps flashOps = { flashProgram, flashErase };
+
+// Same mix of resolutions as the flight fields in DeathChopper9000.cpp
+static const BlackboxField fields[] = {
+	{ "time", 1.0f }, { "gx", 100.0f }, { "gy", 100.0f }, { "gz", 100.0f },
+	{ "ax", 1000.0f }, { "ay", 1000.0f }, { "az", 1000.0f },
+	{ "pitch", 100.0f }, { "roll", 100.0f }, { "thr", 10000.0f },
+	{ "pP", 100.0f }, { "pI", 100.0f }, { "pD", 100.0f },
+	{ "vbat", 1000.0f }, { "m0", 10000.0f }, { "m1", 10000.0f },
+	{ "m2", 10000.0f }, { "m3", 10000.0f }
+};
+#define NUM_FIELDS	(sizeof(fields) / sizeof(fields[0]))
+
+typedef std::vector<int32_t> row;
+
+/**
+ * @brief Scaled value as the recorder stores it
+ */
+static int32_t quantize(float x, float scale) {
+	float q = x * scale;
+
+	if (q != q) return 0;
+	if (q > 2.0e9f) return 2000000000;
+	if (q < -2.0e9f) return -2000000000;
+	return (int32_t)lroundf(q);
+}
+
+/**
+ * @brief One loop of plausible flight state
+ */
+static void flightState(int k, float *v) {
+	float t = k * 10.0f;
+
+	v[0] = t;
+	for (int i = 1; i < 4; i++) {
+		v[i] = 40.0f * sinf(t / (300.0f * i)) + (rand() % 100 - 50) / 20.0f;
+	}
+	for (int i = 4; i < 7; i++) {
+		v[i] = (i == 6 ? 1.0f : 0.0f) + (rand() % 100 - 50) / 1000.0f;
+	}
+	v[7] = 10.0f * sinf(t / 1000.0f);
+	v[8] = 5.0f * cosf(t / 800.0f);
+	v[9] = 0.45f;
+	v[10] = 0.3f * v[1];
+	v[11] = 2.0f + t / 1e5f;
+	v[12] = (rand() % 100 - 50) / 50.0f;
+	v[13] = 11.1f - t / 1e6f;
+	for (int i = 14; i < 18; i++) {
+		v[i] = 0.45f + (rand() % 200 - 100) / 1000.0f;
+	}
+	if (k == 100) {
+		v[2] = NAN;
+	}
+}
+
+/**
+ * @brief Read an unsigned varint
+ */
+static uint32_t getVarint(const uint8_t *p, uint16_t *pos) {
+	uint32_t x = 0;
+	int shift = 0;
+	uint8_t b;
+
+	do {
+		b = p[(*pos)++];
+		x |= (uint32_t)(b & 0x7F) << shift;
+		shift += 7;
+	} while (b & 0x80);
+
+	return x;
+}
+
+/**
+ * @brief Read a zigzag varint
+ */
+static int32_t getSigned(const uint8_t *p, uint16_t *pos) {
+	uint32_t x = getVarint(p, pos);
+	return (int32_t)(x >> 1) ^ -(int32_t)(x & 1);
+}
+
+/**
+ * @brief Decoded storage
+ */
+typedef struct {
+	std::vector<row> records;	///< Every I and P record, as scaled values
+	int sessions;				///< H records
+	int pages;					///< Pages with a good CRC
+	int badPages;				///< Written pages that fail their checks
+	bool pageStartsKey;			///< Every good page started with an H or I
+} decoded;
+
+/**
+ * @brief Decode the storage up to the first erased page
+ */
+static decoded decode(uint32_t size) {
+	decoded d;
+	row prev(NUM_FIELDS, 0);
+	uint8_t n = 0;
+
+	d.sessions = d.pages = d.badPages = 0;
+	d.pageStartsKey = true;
+
+	for (uint32_t off = 0; off + BLACKBOX_PAGE_SIZE <= size; off += BLACKBOX_PAGE_SIZE) {
+		const uint8_t *p = &flash[off];
+		uint16_t len = (uint16_t)(p[2] | (p[3] << 8));
+		uint16_t crc = (uint16_t)(p[4] | (p[5] << 8));
+
+		if (p[0] == 0xFF && p[1] == 0xFF && p[2] == 0xFF && p[3] == 0xFF) {
+			break;
+		}
+		if ((uint16_t)(p[0] | (p[1] << 8)) != BLACKBOX_MAGIC || len > BLACKBOX_PAGE_PAYLOAD
+				|| crc16Ccitt(&p[BLACKBOX_PAGE_HEADER], len) != crc) {
+			d.badPages++;
+			continue;
+		}
+		CHECK((uint16_t)(p[6] | (p[7] << 8)) == off / BLACKBOX_PAGE_SIZE);
+		d.pages++;
+
+		const uint8_t *r = &p[BLACKBOX_PAGE_HEADER];
+		uint16_t pos = 0;
+		if (r[0] != 'H' && r[0] != 'I') {
+			d.pageStartsKey = false;
+		}
+		while (pos < len) {
+			uint8_t type = r[pos++];
+
+			if (type == 'H') {
+				CHECK(r[pos++] == BLACKBOX_VERSION);
+				n = r[pos++];
+				CHECK(n == NUM_FIELDS);
+				for (uint8_t i = 0; i < n; i++) {
+					CHECK(strcmp((const char *)&r[pos], fields[i].name) == 0);
+					pos += strlen((const char *)&r[pos]) + 1;
+					CHECK(getVarint(r, &pos) == (uint32_t)fields[i].scale);
+				}
+				d.sessions++;
+			} else if (type == 'I' || type == 'P') {
+				for (uint8_t i = 0; i < n; i++) {
+					int32_t x = getSigned(r, &pos);
+					prev[i] = (type == 'I') ? x : (int32_t)((uint32_t)prev[i] + (uint32_t)x);
+				}
+				d.records.push_back(prev);
+			} else {
+				CHECK(false);
+				break;
+			}
+		}
+	}
+
+	return d;
+}
+
+/**
+ * @brief Record until the RAM ring is full, as while armed
+ * @param bb       Recorder, in a session
+ * @param k        Loop counter, advanced
+ * @param expected Accepted records, appended
+ * @param loops    Loops to run
+ * @return Records refused
+ */
+static int recordArmed(Blackbox &bb, int *k, std::vector<row> &expected, int loops) {
+	int refused = 0;
+
+	for (int i = 0; i < loops; i++, (*k)++) {
+		float v[NUM_FIELDS];
+		flightState(*k, v);
+
+		if (bb.record(v)) {
+			row q(NUM_FIELDS);
+			for (uint8_t f = 0; f < NUM_FIELDS; f++) {
+				q[f] = quantize(v[f], fields[f].scale);
+			}
+			expected.push_back(q);
+		} else {
+			refused++;
+		}
+	}
+
+	return refused;
+}
+
+int main(void) {
+	std::vector<row> expected;
+	int k = 0;
+
+	srand(3);
+	memset(flash, 0xFF, sizeof(flash));
+	Blackbox *bb = new Blackbox(flash, STORAGE_SIZE, flashOps);
+	CHECK(bb->getUsed() == 0);
+	CHECK(bb->getSize() == STORAGE_SIZE);
+	CHECK(bb->isIdle());
+
+	// Armed: records only fill RAM, nothing is programmed however long it runs
+	CHECK(!bb->record((const float *)flash));
+	CHECK(bb->begin(fields, NUM_FIELDS));
+	CHECK(bb->isRecording());
+	int refused = recordArmed(*bb, &k, expected, 20000);
+	size_t perRecord = (size_t)BLACKBOX_RAM_PAGES * BLACKBOX_PAGE_PAYLOAD / expected.size();
+	printf("armed: %u records in RAM (~%u bytes each), %d refused\n",
+			(unsigned)expected.size(), (unsigned)perRecord, refused);
+	CHECK(programs == 0);
+	CHECK(refused > 0);
+	CHECK(bb->getDropped() == (uint32_t)refused);
+	CHECK(bb->getUsed() == 0);
+	CHECK(!bb->isIdle());
+
+	// Disarmed: service() writes everything out, a bounded amount per call
+	bb->end();
+	CHECK(!bb->isRecording());
+	int calls = 0;
+	while (bb->service(64)) {
+		CHECK(programs <= 64L * (calls + 1));
+		calls++;
+	}
+	CHECK(bb->isIdle());
+	CHECK(!overwrite);
+	CHECK(bb->getUsed() == BLACKBOX_RAM_PAGES * BLACKBOX_PAGE_SIZE);
+	CHECK(programs <= (long)bb->getUsed() / 4);
+
+	decoded d = decode(STORAGE_SIZE);
+	CHECK(d.sessions == 1);
+	CHECK(d.pages == BLACKBOX_RAM_PAGES);
+	CHECK(d.badPages == 0);
+	CHECK(d.pageStartsKey);
+	CHECK(d.records == expected);
+	CHECK(d.records.size() > 100 && d.records[100][2] == 0);	// NaN records as 0
+
+	// A restart finds the end of the data, the next session is appended
+	Blackbox *again = new Blackbox(flash, STORAGE_SIZE, flashOps);
+	CHECK(again->getUsed() == bb->getUsed());
+	delete bb;
+	bb = again;
+	CHECK(bb->begin(fields, NUM_FIELDS));
+	CHECK(recordArmed(*bb, &k, expected, 500) == 0);
+	bb->end();
+	while (bb->service(64)) {
+	}
+	d = decode(STORAGE_SIZE);
+	CHECK(d.sessions == 2);
+	CHECK(d.badPages == 0);
+	CHECK(d.records == expected);
+	CHECK(!overwrite);
+
+	// A failed program abandons that page only, the decoder skips it
+	uint32_t used = bb->getUsed();
+	uint32_t dropped = bb->getDropped();
+	failAt = programs + 3;
+	CHECK(bb->begin(fields, NUM_FIELDS));
+	CHECK(recordArmed(*bb, &k, expected, 500) == 0);
+	bb->end();
+	while (bb->service(64)) {
+	}
+	failAt = -1;
+	CHECK(bb->getDropped() == dropped + 1);
+	CHECK(bb->getUsed() > used);
+	d = decode(STORAGE_SIZE);
+	CHECK(d.sessions == 2);		// The H page was the one lost
+	CHECK(d.badPages == 1);
+	CHECK(!overwrite);
+
+	// Erase starts over
+	CHECK(bb->erase());
+	CHECK(bb->getUsed() == 0);
+	CHECK(decode(STORAGE_SIZE).pages == 0);
+	delete bb;
+
+	// A full storage drops pages instead of wrapping
+	bb = new Blackbox(flash, 4 * BLACKBOX_PAGE_SIZE, flashOps);
+	expected.clear();
+	CHECK(bb->begin(fields, NUM_FIELDS));
+	refused = recordArmed(*bb, &k, expected, 1000);
+	CHECK(refused == 0);
+	bb->end();
+	while (bb->service(64)) {
+	}
+	CHECK(bb->getUsed() == 4 * BLACKBOX_PAGE_SIZE);
+	CHECK(bb->getDropped() > 0);
+	d = decode(4 * BLACKBOX_PAGE_SIZE);
+	CHECK(d.pages == 4);
+	CHECK(d.records.size() < expected.size());
+	CHECK(std::vector<row>(expected.begin(), expected.begin() + d.records.size()) == d.records);
+	CHECK(!overwrite);
+	delete bb;
+
+	return checkDone("test_blackbox");
+}
@@ -0,0 +1,199 @@
+/**
+ * @file
+ *
+ * @brief Host test of the cascaded angle and rate control
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Each axis is modelled as a double integrator: the command accelerates the
+ * rate, the rate integrates to the angle. The loops run the way fly() runs
+ * them, rate loops every CONTROL_RATE_HZ sample and angle loops every
+ * CONTROL_OUTER_DIV samples, with the default gains of config.h.
+ *
+ */
+
+#include "CascadeControl.h"
+#include "config.h"
+#include "check.h"
+
+#define ACCEL_PER_CMD	3000.0f		///< Angular acceleration per unit motor speed [deg/s^2]
+#define DT_INNER		(1.0f / CONTROL_RATE_HZ)
+#define DT_OUTER		(DT_INNER * CONTROL_OUTER_DIV)
+
+/**
+ * @brief One axis of the vehicle
+ */
+typedef struct {
+	float rate;		///< [deg/s]
+	float angle;	///< [deg]
+} axisState;
+
+/**
+ * @brief Advance an axis by one inner loop sample
+ * @param s   Axis
+ * @param cmd Rate loop output, in PID units
+ * @param k   Angular acceleration per unit motor speed [deg/s^2]
+ */
+static void axisStep(axisState *s, float cmd, float k) {
+	s->rate += k * (cmd / PID_SCALE) * DT_INNER;
+	s->angle += s->rate * DT_INNER;
+}
+
+/**
+ * @brief A controller with the default gains and limits
+ */
+static void configure(CascadeControl &c) {
+	c.setAngleGains(ControlAxis::PITCH, PITCH_KP, PITCH_KI, PITCH_KD);
+	c.setAngleGains(ControlAxis::ROLL, ROLL_KP, ROLL_KI, ROLL_KD);
+	c.setRateGains(ControlAxis::PITCH, PITCH_RATE_KP, PITCH_RATE_KI, PITCH_RATE_KD);
+	c.setRateGains(ControlAxis::ROLL, ROLL_RATE_KP, ROLL_RATE_KI, ROLL_RATE_KD);
+	c.setRateGains(ControlAxis::YAW, YAW_RATE_KP, YAW_RATE_KI, YAW_RATE_KD);
+	c.setOutputLimit(ControlAxis::PITCH, PITCH_OUT_MAX * PID_SCALE);
+	c.setOutputLimit(ControlAxis::ROLL, ROLL_OUT_MAX * PID_SCALE);
+	c.setOutputLimit(ControlAxis::YAW, YAW_OUT_MAX * PID_SCALE);
+	c.setRateLimit(MAX_RATE);
+	c.setDerivativeCutoff(PID_D_CUTOFF);
+	c.setBackCalculation(PID_BACK_CALC);
+}
+
+/**
+ * @brief Step response of one angle axis
+ */
+typedef struct {
+	float rise;			///< Time to 90% [s]
+	float settle;		///< Time after which it stays within 5% [s]
+	float overshoot;	///< Past the step [%]
+	float final;		///< Angle at the end [deg]
+} stepResult;
+
+/**
+ * @brief Run a pitch step, with a yaw rate command alongside
+ * @param step    Pitch step [deg]
+ * @param yawCmd  Yaw rate setpoint [deg/s]
+ * @param seconds Time to run
+ * @param yaw     Returns the yaw axis at the end
+ */
+static stepResult pitchStep(float step, float yawCmd, float seconds, axisState *yaw) {
+	CascadeControl c;
+	axisState pitch = { 0.0f, 0.0f };
+	stepResult r = { -1.0f, 0.0f, 0.0f, 0.0f };
+	float peak = 0.0f;
+	int samples = (int)(seconds * CONTROL_RATE_HZ);
+
+	configure(c);
+	yaw->rate = yaw->angle = 0.0f;
+
+	for (int k = 0; k < samples; k++) {
+		float t = k * DT_INNER;
+
+		if (k % CONTROL_OUTER_DIV == 0) {
+			c.angleLoop(0.0f, step, 0.0f, pitch.angle, DT_OUTER);
+		}
+		c.setYawRate(yawCmd);
+		c.rateLoop(0.0f, pitch.rate, yaw->rate, DT_INNER);
+		c.actuated(c.getOutput(ControlAxis::ROLL), c.getOutput(ControlAxis::PITCH), c.getOutput(ControlAxis::YAW));
+
+		axisStep(&pitch, c.getOutput(ControlAxis::PITCH), ACCEL_PER_CMD);
+		axisStep(yaw, c.getOutput(ControlAxis::YAW), 0.2f * ACCEL_PER_CMD);
+
+		if (pitch.angle > peak) {
+			peak = pitch.angle;
+		}
+		if (r.rise < 0.0f && pitch.angle >= 0.9f * step) {
+			r.rise = t;
+		}
+		if (fabsf(pitch.angle - step) > 0.05f * step) {
+			r.settle = t + DT_INNER;
+		}
+	}
+
+	r.overshoot = 100.0f * (peak - step) / step;
+	r.final = pitch.angle;
+	return r;
+}
+
+int main(void) {
+	CascadeControl c;
+	float p, i, d;
+
+	// A new controller commands nothing
+	configure(c);
+	c.rateLoop(0.0f, 0.0f, 0.0f, DT_INNER);
+	for (uint8_t a = 0; a < CONTROL_AXES; a++) {
+		CHECK(c.getOutput((ControlAxis)a) == 0.0f);
+		CHECK(c.getRateSetpoint((ControlAxis)a) == 0.0f);
+	}
+
+	// The angle loops give rate setpoints, clamped to the rate limit, and
+	// the rate loops turn the rate error into a command
+	c.angleLoop(1.0f, -1.5f, 0.0f, 0.0f, DT_OUTER);
+	CHECK_NEAR(c.getRateSetpoint(ControlAxis::ROLL), 1.0f * ROLL_KP, 1e-4f);
+	CHECK_NEAR(c.getRateSetpoint(ControlAxis::PITCH), -1.5f * PITCH_KP, 1e-4f);
+	c.getAngleTerms(ControlAxis::ROLL, &p, &i, &d);
+	CHECK_NEAR(p, 1.0f * ROLL_KP, 1e-4f);
+	c.getAngleTerms(ControlAxis::YAW, &p, &i, &d);
+	CHECK(p == 0.0f && i == 0.0f && d == 0.0f);
+	c.rateLoop(2.0f, 0.0f, 0.0f, DT_INNER);
+	CHECK_NEAR(c.getOutput(ControlAxis::ROLL), (1.0f * ROLL_KP - 2.0f) * ROLL_RATE_KP, 1e-3f);
+	CHECK_NEAR(c.getOutput(ControlAxis::PITCH), -1.5f * PITCH_KP * PITCH_RATE_KP, 1e-3f);
+	c.getRateTerms(ControlAxis::ROLL, &p, &i, &d);
+	CHECK_NEAR(p, (1.0f * ROLL_KP - 2.0f) * ROLL_RATE_KP, 1e-3f);
+
+	c.angleLoop(90.0f, 0.0f, 0.0f, 0.0f, DT_OUTER);
+	CHECK(c.getRateSetpoint(ControlAxis::ROLL) == MAX_RATE);
+	c.setYawRate(-1000.0f);
+	CHECK(c.getRateSetpoint(ControlAxis::YAW) == -MAX_RATE);
+
+	// Rate loop outputs stop at the output limits
+	c.rateLoop(0.0f, 0.0f, 0.0f, DT_INNER);
+	CHECK_NEAR(c.getOutput(ControlAxis::ROLL), ROLL_OUT_MAX * PID_SCALE, 1e-4f);
+	CHECK_NEAR(c.getOutput(ControlAxis::YAW), -YAW_OUT_MAX * PID_SCALE, 1e-4f);
+
+	// A replaced output is what the next actuated() reports
+	c.setOutput(ControlAxis::PITCH, 3.0f);
+	CHECK(c.getOutput(ControlAxis::PITCH) == 3.0f);
+	c.setOutput(ControlAxis::NUM_AXES, 3.0f);		// No such axis, ignored
+	CHECK(c.getOutput(ControlAxis::NUM_AXES) == 0.0f);
+
+	// reset() clears the setpoints and outputs
+	c.reset(0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+	for (uint8_t a = 0; a < CONTROL_AXES; a++) {
+		CHECK(c.getOutput((ControlAxis)a) == 0.0f);
+		CHECK(c.getRateSetpoint((ControlAxis)a) == 0.0f);
+	}
+
+	// Feed-forward adds to the rate loop output per deg/s of setpoint
+	CascadeControl ff;
+	configure(ff);
+	ff.setRateGains(ControlAxis::YAW, 0.0f, 0.0f, 0.0f);
+	ff.setFeedForward(ControlAxis::YAW, 0.02f);
+	ff.setYawRate(100.0f);
+	ff.rateLoop(0.0f, 0.0f, 100.0f, DT_INNER);
+	CHECK_NEAR(ff.getOutput(ControlAxis::YAW), 2.0f, 1e-4f);
+
+	// Step response at the loop rates of config.h, small enough that no
+	// output limit is reached: the pitch step settles without overshoot and
+	// the yaw rate follows its setpoint
+	axisState yaw;
+	stepResult r = pitchStep(1.0f, 5.0f, 2.0f, &yaw);
+	printf("pitch 1 deg: rise %.3f s, settle %.3f s, overshoot %.1f%%, final %.3f; yaw %.2f/5 deg/s\n",
+			r.rise, r.settle, r.overshoot, r.final, yaw.rate);
+	CHECK(r.rise > 0.0f && r.rise < 0.5f);
+	CHECK(r.settle < 0.6f);
+	CHECK(r.overshoot < 1.0f);
+	CHECK_NEAR(r.final, 1.0f, 0.01f);
+	CHECK_NEAR(yaw.rate, 5.0f, 0.1f);
+
+	// Steps that saturate the rate loops: with no integral gain the limits
+	// must not leave an offset behind once they let go
+	r = pitchStep(10.0f, 90.0f, 3.0f, &yaw);
+	printf("pitch 10 deg: rise %.3f s, settle %.3f s, overshoot %.1f%%, final %.3f; yaw %.2f/90 deg/s\n",
+			r.rise, r.settle, r.overshoot, r.final, yaw.rate);
+	CHECK(r.overshoot < 1.0f);
+	CHECK_NEAR(r.final, 10.0f, 0.1f);
+	CHECK_NEAR(yaw.rate, 90.0f, 1.0f);
+
+	return checkDone("test_cascade_control");
+}
@@ -0,0 +1,79 @@
+/**
+ * @file
+ *
+ * @brief Host test of the DShot frame encoder
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+#include "DShot.h"
+#include "check.h"
+
+/**
+ * @brief Checksum of the upper 12 bits, as the ESC computes it
+ */
+static uint16_t frameCrc(uint16_t frame) {
+	uint16_t v = frame >> 4;
+	return (uint16_t)((v ^ (v >> 4) ^ (v >> 8)) & 0x0F);
+}
+
+int main(void) {
+	// Reference frames: throttle 1046 and the first throttle value
+	CHECK(dshotFrame(1046, false) == 0x82C6);
+	CHECK(dshotFrame(1046, true) == 0x82D7);
+	CHECK(dshotFrame(DSHOT_THROTTLE_MIN, false) == 0x0606);
+	CHECK(dshotFrame(DSHOT_CMD_MOTOR_STOP, false) == 0x0000);
+
+	// Value, telemetry bit and checksum land where the ESC reads them
+	for (uint32_t v = 0; v <= DSHOT_THROTTLE_MAX; v++) {
+		for (int t = 0; t < 2; t++) {
+			uint16_t f = dshotFrame((uint16_t)v, t != 0);
+			if ((f >> 5) != v || ((f >> 4) & 1) != t || (f & 0x0F) != frameCrc(f)) {
+				CHECK(false);
+			}
+		}
+	}
+
+	// Values above 11 bits are masked, not carried into the telemetry bit
+	CHECK(dshotFrame(0x0800 | 100, false) == dshotFrame(100, false));
+
+	// Throttle mapping: 0 stops, the range is DSHOT_THROTTLE_MIN..MAX
+	CHECK(dshotThrottle(0.0f) == DSHOT_CMD_MOTOR_STOP);
+	CHECK(dshotThrottle(-0.5f) == DSHOT_CMD_MOTOR_STOP);
+	CHECK(dshotThrottle(1e-6f) == DSHOT_THROTTLE_MIN);
+	CHECK(dshotThrottle(0.5f) == DSHOT_THROTTLE_MIN + (DSHOT_THROTTLE_MAX - DSHOT_THROTTLE_MIN) / 2);
+	CHECK(dshotThrottle(1.0f) == DSHOT_THROTTLE_MAX);
+	CHECK(dshotThrottle(2.0f) == DSHOT_THROTTLE_MAX);
+	uint16_t last = 0;
+	for (int i = 1; i <= 1000; i++) {
+		uint16_t t = dshotThrottle(i / 1000.0f);
+		CHECK(t >= DSHOT_THROTTLE_MIN && t >= last);
+		last = t;
+	}
+
+	// Encoding: MSB first, one slot per stride, padding slots low, other
+	// channels untouched
+	uint32_t buff[DSHOT_SLOTS*DSHOT_CHANNELS];
+	for (uint32_t i = 0; i < DSHOT_SLOTS*DSHOT_CHANNELS; i++) {
+		buff[i] = 0xDEAD;
+	}
+	const uint32_t t0 = 30, t1 = 60;
+	uint16_t frame = dshotFrame(1046, false);
+	dshotEncode(frame, &buff[2], DSHOT_CHANNELS, t0, t1);
+	for (uint8_t i = 0; i < DSHOT_FRAME_BITS; i++) {
+		CHECK(buff[2 + i*DSHOT_CHANNELS] == ((frame & (0x8000 >> i)) ? t1 : t0));
+	}
+	for (uint8_t i = DSHOT_FRAME_BITS; i < DSHOT_SLOTS; i++) {
+		CHECK(buff[2 + i*DSHOT_CHANNELS] == 0);
+	}
+	for (uint32_t i = 0; i < DSHOT_SLOTS*DSHOT_CHANNELS; i++) {
+		if (i % DSHOT_CHANNELS != 2) {
+			CHECK(buff[i] == 0xDEAD);
+		}
+	}
+
+	return checkDone("test_dshot");
+}
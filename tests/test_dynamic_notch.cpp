@@ -0,0 +1,240 @@
+/**
+ * @file
+ *
+ * @brief Host test of the FFT-tracked gyro notch filter
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Checks the peak search on spectra of known tones, the notch design
+ * against its frequency response, and the tracking filter on a gyro signal
+ * whose vibration tone moves, then drops below DYN_NOTCH_MIN_HZ. Samples
+ * come at the 200 Hz the IMU runs at.
+ *
+ */
+
+#include "dynamicNotch.h"
+#include "check.h"
+#include <complex>
+#include <random>
+
+#define FS		200.0f						///< Sample rate [Hz]
+#define BIN_HZ	(FS / DYN_NOTCH_FFT_SIZE)	///< Width of one FFT bin [Hz]
+
+static std::mt19937 rng(5);
+static std::normal_distribution<float> gauss(0.0f, 1.0f);
+
+/**
+ * @brief Magnitude spectrum of a sum of tones, computed as dynamicNotch does
+ * @param f   Tone frequencies [Hz]
+ * @param a   Tone amplitudes
+ * @param n   Number of tones
+ * @param mag [out] DYN_NOTCH_FFT_SIZE/2 bins
+ */
+static void toneSpectrum(const float *f, const float *a, int n, float32_t *mag) {
+	float32_t x[DYN_NOTCH_FFT_SIZE], spectrum[DYN_NOTCH_FFT_SIZE];
+	arm_rfft_fast_instance_f32 fft;
+
+	for (int k = 0; k < DYN_NOTCH_FFT_SIZE; k++) {
+		float w = 0.5f - 0.5f * cosf(2.0f * PI * k / (DYN_NOTCH_FFT_SIZE - 1));
+		x[k] = 0.0f;
+		for (int i = 0; i < n; i++) {
+			x[k] += a[i] * sinf(2.0f * PI * f[i] * k / FS);
+		}
+		x[k] *= w;
+	}
+
+	arm_rfft_fast_init_f32(&fft, DYN_NOTCH_FFT_SIZE);
+	arm_rfft_fast_f32(&fft, x, spectrum, 0);
+	spectrum[1] = 0.0f;
+	arm_cmplx_mag_f32(spectrum, mag, DYN_NOTCH_FFT_SIZE/2);
+}
+
+/**
+ * @brief Peaks land on the injected tones, strongest first, within range
+ */
+static void testFindPeaks(void) {
+	float32_t mag[DYN_NOTCH_FFT_SIZE/2], peaks[DYN_NOTCH_MAX];
+	const float f[2] = { 37.5f, 63.7f };	// On a bin, and between two
+	const float a[2] = { 1.0f, 0.6f };
+
+	toneSpectrum(f, a, 2, mag);
+	uint8_t n = dynNotchFindPeaks(mag, DYN_NOTCH_FFT_SIZE/2, BIN_HZ, DYN_NOTCH_MIN_HZ, 0.45f*FS,
+			DYN_NOTCH_THRESHOLD, peaks, DYN_NOTCH_MAX);
+	printf("peaks at %.2f %.2f Hz\n", peaks[0], peaks[1]);
+	CHECK(n == 2);
+	CHECK_NEAR(peaks[0], f[0], 0.25f * BIN_HZ);
+	CHECK_NEAR(peaks[1], f[1], 0.25f * BIN_HZ);
+
+	// Only the strongest when one is asked for
+	CHECK(dynNotchFindPeaks(mag, DYN_NOTCH_FFT_SIZE/2, BIN_HZ, DYN_NOTCH_MIN_HZ, 0.45f*FS,
+			DYN_NOTCH_THRESHOLD, peaks, 1) == 1);
+	CHECK_NEAR(peaks[0], f[0], 0.25f * BIN_HZ);
+
+	// Nothing outside the search range
+	CHECK(dynNotchFindPeaks(mag, DYN_NOTCH_FFT_SIZE/2, BIN_HZ, 45.0f, 55.0f,
+			DYN_NOTCH_THRESHOLD, peaks, DYN_NOTCH_MAX) == 0);
+	CHECK(dynNotchFindPeaks(mag, DYN_NOTCH_FFT_SIZE/2, BIN_HZ, 80.0f, 20.0f,
+			DYN_NOTCH_THRESHOLD, peaks, DYN_NOTCH_MAX) == 0);
+
+	// A flat spectrum has no peak
+	for (int k = 0; k < DYN_NOTCH_FFT_SIZE/2; k++) {
+		mag[k] = 1.0f;
+	}
+	CHECK(dynNotchFindPeaks(mag, DYN_NOTCH_FFT_SIZE/2, BIN_HZ, DYN_NOTCH_MIN_HZ, 0.45f*FS,
+			DYN_NOTCH_THRESHOLD, peaks, DYN_NOTCH_MAX) == 0);
+}
+
+/**
+ * @brief Gain of a biquad at a frequency
+ * @param c {b0, b1, b2, a1, a2}, CMSIS sign convention
+ */
+static float gainAt(const float32_t *c, float f) {
+	std::complex<double> z1 = std::polar(1.0, -2.0 * M_PI * f / FS);
+	std::complex<double> num = (double)c[0] + (double)c[1]*z1 + (double)c[2]*z1*z1;
+	std::complex<double> den = 1.0 - (double)c[3]*z1 - (double)c[4]*z1*z1;
+	return (float)std::abs(num / den);
+}
+
+/**
+ * @brief The notch is deep at its center, unity far from it, and as wide as
+ * DYN_NOTCH_Q asks at any center up to Nyquist
+ */
+static void testCoefficients(void) {
+	const float centers[3] = { 20.0f, 50.0f, 80.0f };
+
+	for (int i = 0; i < 3; i++) {
+		float32_t c[5];
+		float f0 = centers[i];
+		dynNotchCoefficients(f0, DYN_NOTCH_Q, FS, c);
+
+		// -3 dB edges, found by scanning out from the center
+		float lo = f0, hi = f0;
+		while (lo > 0.0f && gainAt(c, lo) < sqrtf(0.5f)) {
+			lo -= 0.01f;
+		}
+		while (hi < FS/2 && gainAt(c, hi) < sqrtf(0.5f)) {
+			hi += 0.01f;
+		}
+		float q = f0 / (hi - lo);
+
+		printf("notch %.0f Hz: depth %.1f dB, -3 dB %.2f..%.2f Hz, Q %.2f\n", f0,
+				20.0f * log10f(gainAt(c, f0) + 1e-9f), lo, hi, q);
+		CHECK(gainAt(c, f0) < 1e-3f);					// Deeper than 60 dB
+		CHECK_NEAR(gainAt(c, 0.0f), 1.0f, 1e-4f);
+		CHECK_NEAR(gainAt(c, FS/2), 1.0f, 1e-4f);
+		CHECK_NEAR(q, DYN_NOTCH_Q, 0.05f * DYN_NOTCH_Q);
+	}
+}
+
+/**
+ * @brief Run the filter over a gyro rate with a vibration tone
+ * @param notch   Filter under test
+ * @param fTone   Tone frequency at each sample [Hz], as a function of time
+ * @param seconds Length of the run [s]
+ * @param t0      Start time [s]
+ * @param inRms   [out] RMS of the tone over the last second
+ * @param outRms  [out] RMS of the output less the motion, last second
+ */
+template <typename F>
+static void runTone(dynamicNotch &notch, F fTone, float seconds, float t0, float *inRms, float *outRms) {
+	static float phase = 0.0f;
+	int n = (int)(seconds * FS);
+	double in = 0.0, out = 0.0;
+	int count = 0;
+
+	for (int k = 0; k < n; k++) {
+		float t = t0 + k / FS;
+		float motion = 20.0f * sinf(2.0f * PI * 0.5f * t);
+		phase += 2.0f * PI * fTone(t) / FS;
+		float tone = 8.0f * sinf(phase);
+
+		float y = notch.filterSample(motion + tone + 0.3f * gauss(rng));
+		if ((k & 1) == 0) {
+			notch.update();		// The outer slice runs every other sample
+		}
+
+		if (k >= n - (int)FS) {
+			in += tone * tone;
+			out += (y - motion) * (y - motion);
+			count++;
+		}
+	}
+
+	*inRms = sqrtf(in / count);
+	*outRms = sqrtf(out / count);
+}
+
+/**
+ * @brief The notch finds a tone, follows it as it moves, and lets go of it
+ * once it drops below DYN_NOTCH_MIN_HZ
+ */
+static void testTracking(void) {
+	dynamicNotch notch(FS, 1);
+	float in, out;
+
+	// Pass-through until the first analysis
+	CHECK(notch.getCenter(0) == 0.0f && notch.getCenter(1) == 0.0f);
+	for (int k = 0; k < DYN_NOTCH_HOP - 1; k++) {
+		CHECK(notch.filterSample(1.0f + k) == 1.0f + k);
+		CHECK(!notch.update());
+	}
+	CHECK(notch.filterSample(0.0f) == 0.0f);
+	CHECK(notch.update());
+
+	// A steady tone
+	runTone(notch, [](float) { return 45.0f; }, 3.0f, 0.0f, &in, &out);
+	printf("45 Hz steady: center %.2f Hz, tone rms %.2f -> %.2f\n", notch.getCenter(0), in, out);
+	CHECK_NEAR(notch.getCenter(0), 45.0f, 0.5f * BIN_HZ);
+	CHECK(out < 0.25f * in);
+
+	// Rising 45 to 70 Hz over 5 s; the center lags by a bin at most
+	runTone(notch, [](float t) { return 45.0f + 5.0f * (t - 3.0f); }, 5.0f, 3.0f, &in, &out);
+	printf("sweep to 70 Hz: center %.2f Hz, tone rms %.2f -> %.2f\n", notch.getCenter(0), in, out);
+	CHECK_NEAR(notch.getCenter(0), 70.0f, BIN_HZ);
+	CHECK(out < 0.5f * in);
+
+	// Gliding down to 3 Hz, under DYN_NOTCH_MIN_HZ: the notch follows to the
+	// minimum, never below it, and lets go within DYN_NOTCH_HOLD analyses
+	// (plus one window for the tone to leave the buffer)
+	static float phase = 0.0f;
+	float lowest = 1000.0f;
+	int analyses = 0, under = -1, off = -1;
+	for (int k = 0; k < 4.5f * FS; k++) {
+		float t = k / FS;
+		float f = (t < 3.0f) ? 70.0f - 67.0f * t / 3.0f : 3.0f;
+		phase += 2.0f * PI * f / FS;
+		notch.filterSample(8.0f * sinf(phase) + 0.3f * gauss(rng));
+		if (f < DYN_NOTCH_MIN_HZ && under < 0) {
+			under = analyses;
+		}
+		if ((k & 1) == 0 && notch.update()) {
+			analyses++;
+			float c = notch.getCenter(0);
+			if (c > 0.0f && c < lowest) {
+				lowest = c;
+			}
+			if (c == 0.0f && off < 0) {
+				off = analyses;
+			}
+		}
+	}
+	printf("glide to 3 Hz: lowest center %.2f Hz, off %d analyses after the tone left the range\n", lowest,
+			off - under);
+	CHECK(lowest >= DYN_NOTCH_MIN_HZ - 0.5f * BIN_HZ && lowest < DYN_NOTCH_MIN_HZ + 2.0f * BIN_HZ);
+	CHECK(off > under && off - under <= DYN_NOTCH_HOLD + DYN_NOTCH_FFT_SIZE / DYN_NOTCH_HOP + 1);
+	CHECK(notch.getCenter(0) == 0.0f);
+
+	// And a tone that comes back is picked up again
+	runTone(notch, [](float) { return 55.0f; }, 2.0f, 0.0f, &in, &out);
+	CHECK_NEAR(notch.getCenter(0), 55.0f, 0.5f * BIN_HZ);
+}
+
+int main(void) {
+	testFindPeaks();
+	testCoefficients();
+	testTracking();
+
+	return checkDone("test_dynamic_notch");
+}
@@ -0,0 +1,95 @@
+/**
+ * @file
+ *
+ * @brief Host test of the KISS/BLHeli_32 ESC telemetry decoder
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+#include "EscTelemetry.h"
+#include "check.h"
+
+/**
+ * @brief Build a frame with a valid CRC
+ */
+static void makeFrame(uint8_t *f, uint8_t temp, uint16_t volt, uint16_t amp, uint16_t mah, uint16_t erpm) {
+	f[0] = temp;
+	f[1] = (uint8_t)(volt >> 8);
+	f[2] = (uint8_t)volt;
+	f[3] = (uint8_t)(amp >> 8);
+	f[4] = (uint8_t)amp;
+	f[5] = (uint8_t)(mah >> 8);
+	f[6] = (uint8_t)mah;
+	f[7] = (uint8_t)(erpm >> 8);
+	f[8] = (uint8_t)erpm;
+	f[9] = escTelemetryCrc8(f, ESC_TELEM_FRAME_LEN - 1);
+}
+
+/**
+ * @brief Feed bytes, return the number of frames decoded
+ */
+static int feedAll(EscTelemetryDecoder &d, const uint8_t *b, int n, EscTelemetryFrame *last) {
+	int frames = 0;
+	for (int i = 0; i < n; i++) {
+		if (d.feed(b[i], last)) frames++;
+	}
+	return frames;
+}
+
+int main(void) {
+	// CRC-8 (poly 0x07, init 0): check value of "123456789" is 0xF4
+	const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+	CHECK(escTelemetryCrc8(check, 9) == 0xF4);
+	CHECK(escTelemetryCrc8(check, 0) == 0x00);
+
+	uint8_t f[ESC_TELEM_FRAME_LEN];
+	EscTelemetryFrame out;
+	EscTelemetryDecoder d;
+
+	// One frame: fields are big-endian
+	makeFrame(f, 41, 1612, 523, 1200, 345);
+	CHECK(feedAll(d, f, ESC_TELEM_FRAME_LEN, &out) == 1);
+	CHECK(out.temperature == 41);
+	CHECK(out.voltage == 1612);
+	CHECK(out.current == 523);
+	CHECK(out.consumption == 1200);
+	CHECK(out.erpm == 345);
+	CHECK(d.getCrcErrors() == 0);
+
+	// Back to back frames decode without a reset in between
+	uint8_t two[2*ESC_TELEM_FRAME_LEN];
+	makeFrame(two, 30, 1500, 100, 10, 200);
+	makeFrame(&two[ESC_TELEM_FRAME_LEN], 31, 1490, 110, 11, 210);
+	CHECK(feedAll(d, two, sizeof(two), &out) == 2);
+	CHECK(out.temperature == 31 && out.erpm == 210);
+
+	// Leading garbage: the window slides until the CRC matches
+	EscTelemetryDecoder g;
+	uint8_t noisy[3 + ESC_TELEM_FRAME_LEN] = {0x55, 0xAA, 0x13};
+	makeFrame(&noisy[3], 50, 1400, 2000, 300, 999);
+	CHECK(feedAll(g, noisy, sizeof(noisy), &out) == 1);
+	CHECK(out.temperature == 50 && out.current == 2000 && out.erpm == 999);
+	CHECK(g.getCrcErrors() == 3);
+
+	// A corrupted frame is rejected and counted
+	EscTelemetryDecoder c;
+	makeFrame(f, 41, 1612, 523, 1200, 345);
+	f[4] ^= 0x10;
+	CHECK(feedAll(c, f, ESC_TELEM_FRAME_LEN, &out) == 0);
+	CHECK(c.getCrcErrors() == 1);
+
+	// reset() drops a partial frame, so the next reply decodes cleanly
+	EscTelemetryDecoder r;
+	makeFrame(f, 20, 1000, 0, 0, 0);
+	CHECK(feedAll(r, f, 4, &out) == 0);
+	r.reset();
+	makeFrame(f, 21, 1100, 1, 2, 3);
+	CHECK(feedAll(r, f, ESC_TELEM_FRAME_LEN, &out) == 1);
+	CHECK(out.temperature == 21 && out.voltage == 1100);
+	CHECK(r.getCrcErrors() == 0);
+
+	return checkDone("test_esc_telemetry");
+}
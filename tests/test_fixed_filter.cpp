@@ -0,0 +1,208 @@
+/**
+ * @file
+ *
+ * @brief Host test of the fixed-point pre-filters against a float reference
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Runs the gyro (Q15) and accelerometer (Q31) designs used by USE_FIXED_POINT
+ * over synthetic raw sensor samples, the same way L3GD20H/LSM303D feed them,
+ * and bounds the difference to a double precision run of the unquantized
+ * design. Errors are in raw sensor counts (LSB).
+ *
+ */
+
+#include "preFilterQ15.h"
+#include "preFilterQ31.h"
+#include "check.h"
+#include <stdlib.h>
+
+// Same designs as gyroQ15Coef in L3GD20H.cpp and accQ31Coef in LSM303D.cpp
+static const float32_t gyroCoef[15] = {
+	1, -1.67171299109, 1,
+	1.71022092712, -0.833197919132,
+	1, -0.631952192663, 1,
+	1.58706817569, -0.648599546625,
+	1, -1.77493127647, 1,
+	1.79913121367, -0.958726718288
+};
+#define GYRO_SECTIONS	3
+#define GYRO_GAIN		0.0118105736583f
+
+static const float32_t accCoef[20] = {
+	1, -1.98982556714, 1,
+	1.97886614394, -0.982257780648,
+	1, -1.98002560283, 1,
+	1.96462573041, -0.966676926152,
+	1, -1.85755297101, 1,
+	1.95266174823, -0.95346779688,
+	1, -1.99202450372, 1,
+	1.99052519416, -0.994653975147
+};
+#define ACC_SECTIONS	4
+#define ACC_GAIN		9.91298688922e-05f
+#define ACC_SHIFT		(16 - PREFILTER_Q31_HEADROOM)
+
+#define FS				200.0		///< Sample rate the designs are for [Hz]
+#define NUM_SAMPLES		2000
+#define SETTLE			200			///< Samples skipped before comparing
+
+/**
+ * @brief Double precision Direct-Form I cascade, CMSIS sign convention
+ */
+class refFilter {
+private:
+	const float32_t *c;
+	int sections;
+	double gain;
+	double st[8][4];
+
+public:
+	refFilter(const float32_t *coef, int n, double g) : c(coef), sections(n), gain(g) {
+		for (int s = 0; s < 8; s++) {
+			st[s][0] = st[s][1] = st[s][2] = st[s][3] = 0.0;
+		}
+	}
+
+	double filterSample(double x) {
+		x *= gain;
+		for (int s = 0; s < sections; s++) {
+			const float32_t *k = &c[5*s];
+			double y = k[0]*x + k[1]*st[s][0] + k[2]*st[s][1] + k[3]*st[s][2] + k[4]*st[s][3];
+			st[s][1] = st[s][0];
+			st[s][0] = x;
+			st[s][3] = st[s][2];
+			st[s][2] = y;
+			x = y;
+		}
+		return x;
+	}
+};
+
+/**
+ * @brief Synthetic raw sample: in-band motion, out-of-band vibration, noise
+ * @param n     Sample index
+ * @param bias  Constant offset [LSB]
+ * @param amp   Amplitude of the motion [LSB]
+ * @param fVib  Vibration frequency [Hz]
+ */
+static int16_t rawSample(int n, double bias, double amp, double fVib) {
+	double t = n / FS;
+	double v = bias + amp * sin(2.0 * M_PI * 1.0 * t) + 0.5 * amp * sin(2.0 * M_PI * fVib * t)
+			+ (rand() % 201 - 100);
+
+	return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+}
+
+/**
+ * @brief Difference between the fixed-point and the reference output [LSB]
+ */
+typedef struct {
+	double mean;	///< Mean (bias)
+	double rms;		///< RMS
+	double max;		///< Largest absolute difference
+} filterError;
+
+/**
+ * @brief Accumulate the difference of one sample
+ */
+static void addError(filterError *e, double d, int *n) {
+	e->mean += d;
+	e->rms += d*d;
+	if (fabs(d) > e->max) {
+		e->max = fabs(d);
+	}
+	(*n)++;
+}
+
+/**
+ * @brief Turn the sums of addError() into mean and RMS
+ */
+static filterError endError(filterError e, int n) {
+	e.mean /= n;
+	e.rms = sqrt(e.rms / n);
+	return e;
+}
+
+/**
+ * @brief Error of the gyro Q15 path
+ */
+static filterError gyroError(double bias, double amp) {
+	preFilterQ15 q(gyroCoef, GYRO_SECTIONS, GYRO_GAIN);
+	refFilter r(gyroCoef, GYRO_SECTIONS, GYRO_GAIN);
+	filterError e = {0.0, 0.0, 0.0};
+	int count = 0;
+
+	srand(1);
+	for (int n = 0; n < NUM_SAMPLES; n++) {
+		int16_t raw = rawSample(n, bias, amp, 30.0);
+
+		// As L3GD20H::getXFiltered()
+		q15_t y = q.filterSample((raw + (1 << (PREFILTER_Q15_HEADROOM - 1))) >> PREFILTER_Q15_HEADROOM);
+		double fixed = (double)((int32_t)y << PREFILTER_Q15_HEADROOM);
+		double ref = r.filterSample(raw);
+
+		if (n >= SETTLE) {
+			addError(&e, fixed - ref, &count);
+		}
+	}
+
+	return endError(e, count);
+}
+
+/**
+ * @brief Error of the accelerometer Q31 path
+ */
+static filterError accError(double bias, double amp) {
+	preFilterQ31 q(accCoef, ACC_SECTIONS, ACC_GAIN);
+	refFilter r(accCoef, ACC_SECTIONS, ACC_GAIN);
+	filterError e = {0.0, 0.0, 0.0};
+	int count = 0;
+
+	srand(2);
+	for (int n = 0; n < NUM_SAMPLES; n++) {
+		int16_t raw = rawSample(n, bias, amp, 20.0);
+
+		// As LSM303D::getAccXFiltered()
+		q31_t y = q.filterSample((q31_t)raw << ACC_SHIFT);
+		double fixed = (double)y / (double)(1 << ACC_SHIFT);
+		double ref = r.filterSample(raw);
+
+		if (n >= SETTLE) {
+			addError(&e, fixed - ref, &count);
+		}
+	}
+
+	return endError(e, count);
+}
+
+/**
+ * @brief Print and bound one error measurement
+ */
+#define CHECK_ERROR(name, e, maxMean, maxRms, maxAbs) do { \
+		filterError checkE = (e); \
+		printf("%-24s mean %6.2f  rms %6.2f  max %6.2f LSB\n", name, checkE.mean, checkE.rms, checkE.max); \
+		CHECK(fabs(checkE.mean) <= (maxMean)); \
+		CHECK(checkE.rms <= (maxRms)); \
+		CHECK(checkE.max <= (maxAbs)); \
+	} while (0)
+
+int main(void) {
+	// Gyro: 1 LSB = 17.5 mdps at 500 dps full-scale. The Q15 path works in
+	// steps of 4 LSB (the headroom bits), which the feedback amplifies; what
+	// must not remain is a bias, since that reads as a rate offset. At 200 Hz
+	// the poles sit closer to the unit circle than they did at 100 Hz, so the
+	// noise is a little higher (under 0.3 dps RMS)
+	CHECK_ERROR("gyro Q15 at rest", gyroError(0, 0), 2.0, 16.0, 48.0);
+	CHECK_ERROR("gyro Q15 moving", gyroError(200, 4000), 2.0, 16.0, 48.0);
+	CHECK_ERROR("gyro Q15 near full-scale", gyroError(0, 16000), 2.0, 16.0, 48.0);
+
+	// Accelerometer: 1 LSB = 0.122 mg. 1 g at rest plus tilting, the narrow
+	// design needs Q31 to stay within a fraction of an LSB
+	CHECK_ERROR("acc Q31 at rest", accError(8196, 0), 1.0, 1.0, 1.0);
+	CHECK_ERROR("acc Q31 moving", accError(8196, 4000), 1.0, 1.0, 1.0);
+
+	return checkDone("test_fixed_filter");
+}
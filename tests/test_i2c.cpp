@@ -0,0 +1,476 @@
+/**
+ * @file
+ *
+ * @brief Host test of the i2c driver: pin map, callback routing, recovery policy
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Lib/I2C.cpp runs as built for the target, against the HAL stand-ins of
+ * hal_host.cpp. Transfers end when the test completes or fails them, which
+ * runs the same HAL callbacks the DMA and error interrupts do.
+ *
+ */
+
+#include "I2C.h"
+#include "DMA_IT.h"
+#include "CycleCounter.h"
+#include "config.h"
+#include "check.h"
+#include <string.h>
+
+/**
+ * @brief Pin, bus and function, as in the I2C pin mapping table (Lib.h)
+ */
+static const struct {
+	i2cPin pin;
+	i2cBus bus;
+	bool scl;
+} pinTable[] = {
+	{ i2cPin::PA8,	i2cBus::BUS3, true },
+	{ i2cPin::PB6,	i2cBus::BUS1, true },
+	{ i2cPin::PB7,	i2cBus::BUS1, false },
+	{ i2cPin::PB8,	i2cBus::BUS1, true },
+	{ i2cPin::PB9,	i2cBus::BUS1, false },
+	{ i2cPin::PB10,	i2cBus::BUS2, true },
+	{ i2cPin::PB11,	i2cBus::BUS2, false },
+	{ i2cPin::PC9,	i2cBus::BUS3, false },
+	{ i2cPin::PF0,	i2cBus::BUS2, false },
+	{ i2cPin::PF1,	i2cBus::BUS2, true },
+	{ i2cPin::PH4,	i2cBus::BUS2, true },
+	{ i2cPin::PH5,	i2cBus::BUS2, false },
+	{ i2cPin::PH7,	i2cBus::BUS3, true },
+	{ i2cPin::PH8,	i2cBus::BUS3, false }
+};
+
+static void testPins(void) {
+	for (unsigned i = 0; i < sizeof(pinTable) / sizeof(pinTable[0]); i++) {
+		CHECK(i2cPinToBus(pinTable[i].pin) == pinTable[i].bus);
+		CHECK(isSclPin(pinTable[i].pin) == pinTable[i].scl);
+		CHECK(isSdaPin(pinTable[i].pin) == !pinTable[i].scl);
+	}
+
+	// The configured sensor pins are a clock and a data pin of one bus
+	CHECK(isSclPin(IMU_SCL_PIN) && isSdaPin(IMU_SDA_PIN));
+	CHECK(i2cPinToBus(IMU_SCL_PIN) == i2cPinToBus(IMU_SDA_PIN));
+	CHECK(isSclPin(BARO_SCL_PIN) && isSdaPin(BARO_SDA_PIN));
+	CHECK(i2cPinToBus(BARO_SCL_PIN) == i2cPinToBus(BARO_SDA_PIN));
+}
+
+static void testErrorAction(void) {
+	// Bus state unknown: release the bus first
+	CHECK(i2cErrorAction(HAL_I2C_ERROR_BERR, 1, 0) == I2C_Action::RECOVER);
+	CHECK(i2cErrorAction(HAL_I2C_ERROR_ARLO, 1, 0) == I2C_Action::RECOVER);
+	CHECK(i2cErrorAction(HAL_I2C_ERROR_TIMEOUT, 1, 0) == I2C_Action::RECOVER);
+	CHECK(i2cErrorAction(HAL_I2C_ERROR_AF | HAL_I2C_ERROR_BERR, 1, 0) == I2C_Action::RECOVER);
+
+	// The transfer just didn't go through: try again
+	CHECK(i2cErrorAction(HAL_I2C_ERROR_AF, 1, 0) == I2C_Action::RETRY);
+	CHECK(i2cErrorAction(HAL_I2C_ERROR_OVR, 1, 0) == I2C_Action::RETRY);
+	CHECK(i2cErrorAction(HAL_I2C_ERROR_DMA, 1, 0) == I2C_Action::RETRY);
+	CHECK(i2cErrorAction(HAL_I2C_ERROR_NONE, 1, 0) == I2C_Action::RETRY);
+
+	// Out of attempts or time
+	CHECK(i2cErrorAction(HAL_I2C_ERROR_AF, I2C_MAX_RETRIES, 0) == I2C_Action::RETRY);
+	CHECK(i2cErrorAction(HAL_I2C_ERROR_AF, I2C_MAX_RETRIES + 1, 0) == I2C_Action::FAIL);
+	CHECK(i2cErrorAction(HAL_I2C_ERROR_BERR, I2C_MAX_RETRIES + 1, 0) == I2C_Action::FAIL);
+	CHECK(i2cErrorAction(HAL_I2C_ERROR_AF, 1, I2C_RETRY_BUDGET_US - 1) == I2C_Action::RETRY);
+	CHECK(i2cErrorAction(HAL_I2C_ERROR_AF, 1, I2C_RETRY_BUDGET_US) == I2C_Action::FAIL);
+	CHECK(i2cErrorAction(HAL_I2C_ERROR_BERR, 1, I2C_RETRY_BUDGET_US) == I2C_Action::FAIL);
+}
+
+static void testSensorLost(void) {
+	uint8_t failures = 0;
+
+	// Only consecutive failures count
+	for (int i = 0; i < I2C_MAX_STALE - 1; i++) {
+		CHECK(!i2cSensorLost(I2C_Status::FAILED, &failures));
+	}
+	CHECK(!i2cSensorLost(I2C_Status::PENDING, &failures));
+	CHECK(!i2cSensorLost(I2C_Status::IDLE, &failures));
+	CHECK(i2cSensorLost(I2C_Status::FAILED, &failures));
+	CHECK(!i2cSensorLost(I2C_Status::OK, &failures));
+	CHECK(failures == 0);
+
+	// The counter saturates
+	for (int i = 0; i < 300; i++) {
+		i2cSensorLost(I2C_Status::FAILED, &failures);
+	}
+	CHECK(failures == 255);
+	CHECK(i2cSensorLost(I2C_Status::FAILED, &failures));
+}
+
+/**
+ * @brief Callbacks reach the bus that owns the handle, and only that bus
+ */
+static void testDispatch(void) {
+	hostI2CReset();
+
+	I2C *bus1 = I2C::Instance(i2cPin::PB8, i2cPin::PB9);
+	I2C *bus3 = I2C::Instance(i2cPin::PA8, i2cPin::PC9);
+
+	// One instance per bus, found again from its pins, bus or HAL handle
+	CHECK(bus1 != NULL && bus3 != NULL && bus1 != bus3);
+	CHECK(I2C::Instance(i2cPin::PB6, i2cPin::PB7) == bus1);
+	CHECK(bus1->getBus() == i2cBus::BUS1 && bus3->getBus() == i2cBus::BUS3);
+	CHECK(I2C::fromBus(i2cBus::BUS1) == bus1 && I2C::fromBus(i2cBus::BUS3) == bus3);
+	CHECK(I2C::fromHandle(&i2c1Handle) == bus1);
+	CHECK(I2C::fromHandle(&i2c3Handle) == bus3);
+	CHECK(I2C::fromHandle(&i2c2Handle) == NULL);		// Nothing uses I2C2
+	CHECK(i2c1Handle.Instance == I2C1 && i2c3Handle.Instance == I2C3);
+	CHECK(hostI2CBuses[0].inits == 1 && hostI2CBuses[2].inits == 1);
+	CHECK(hostErrors == 0);
+
+	// A read on each bus: both start at once, and each completion retires
+	// its own bus' read
+	uint8_t a[6] = { 0 }, b[3] = { 0 };
+	const uint8_t aIn[6] = { 1, 2, 3, 4, 5, 6 }, bIn[3] = { 7, 8, 9 };
+	volatile I2C_Status aStatus, bStatus;
+	CHECK(bus1->memRead(0xD6, 0xA8, a, sizeof(a), &aStatus) == 0);
+	CHECK(bus3->memRead(0xBA, 0x28, b, sizeof(b), &bStatus) == 0);
+	CHECK(hostI2CBuses[0].starts == 1 && hostI2CBuses[2].starts == 1);
+	CHECK(hostI2CBuses[0].devAddr == 0xD6 && hostI2CBuses[0].memAddr == 0xA8 && hostI2CBuses[0].size == 6);
+	CHECK(aStatus == I2C_Status::PENDING && bStatus == I2C_Status::PENDING);
+
+	hostI2CComplete(&i2c3Handle, bIn);
+	CHECK(bStatus == I2C_Status::OK && memcmp(b, bIn, sizeof(b)) == 0);
+	CHECK(aStatus == I2C_Status::PENDING && a[0] == 0);
+	CHECK(bus3->getStats().transfers == 1 && bus1->getStats().transfers == 0);
+
+	hostI2CComplete(&i2c1Handle, aIn);
+	CHECK(aStatus == I2C_Status::OK && memcmp(a, aIn, sizeof(a)) == 0);
+	CHECK(bus1->getStats().transfers == 1 && bus1->getStats().bytes == 6);
+
+	// Each kind of transfer completes through its own callback. Writes are
+	// copied when queued, so the caller's buffer may change straight away.
+	uint8_t w[2] = { 0x20, 0x0F };
+	bus1->memWrite(0xD6, 0x20, w, sizeof(w));
+	w[0] = 0;
+	CHECK(hostI2CBuses[0].mem && !hostI2CBuses[0].read && hostI2CBuses[0].pData[0] == 0x20);
+	HAL_I2C_MemTxCpltCallback(&i2c1Handle);
+	bus1->write(0x3C, w, 1);
+	CHECK(!hostI2CBuses[0].mem && !hostI2CBuses[0].read);
+	HAL_I2C_MasterTxCpltCallback(&i2c1Handle);
+	bus1->read(0x3C, a, 1, &aStatus);
+	CHECK(!hostI2CBuses[0].mem && hostI2CBuses[0].read);
+	hostI2CComplete(&i2c1Handle, bIn);
+	CHECK(aStatus == I2C_Status::OK && a[0] == 7);
+	CHECK(bus1->getStats().transfers == 4);
+
+	// A completion nothing is waiting for (late, or for a slave transfer)
+	// changes nothing
+	HAL_I2C_MemRxCpltCallback(&i2c1Handle);
+	HAL_I2C_SlaveRxCpltCallback(&i2c1Handle);
+	CHECK(bus1->getStats().transfers == 4);
+
+	// Callbacks for a bus nothing uses are ignored; an error there is fatal
+	HAL_I2C_MemRxCpltCallback(&i2c2Handle);
+	CHECK(hostErrors == 0);
+	HAL_I2C_ErrorCallback(&i2c2Handle);
+	CHECK(hostErrors == 1 && hostLastError == errDC9000::I2C_IO_ERROR);
+
+	// Queues are per bus: a full queue on I2C1 leaves I2C3 free, and an
+	// error on I2C1 is not counted on I2C3
+	volatile I2C_Status full[I2C_QUEUE_SIZE + 1];
+	for (int i = 0; i < I2C_QUEUE_SIZE; i++) {
+		CHECK(bus1->memRead(0xD6, 0xA8, a, 1, &full[i]) == 0);
+	}
+	CHECK(bus1->memRead(0xD6, 0xA8, a, 1, &full[I2C_QUEUE_SIZE]) == -1);
+	CHECK(full[I2C_QUEUE_SIZE] == I2C_Status::FAILED);
+	CHECK(bus3->memRead(0xBA, 0x28, b, 1, &bStatus) == 0);
+	CHECK(hostI2CBuses[2].starts == 2);
+	CHECK(bus1->getStats().errors == 1 && bus3->getStats().errors == 0);
+	hostI2CComplete(&i2c3Handle, bIn);
+	CHECK(bStatus == I2C_Status::OK);
+
+	for (int i = 0; i < I2C_QUEUE_SIZE; i++) {
+		hostI2CComplete(&i2c1Handle, aIn);
+		bus1->service();
+	}
+	for (int i = 0; i < I2C_QUEUE_SIZE; i++) {
+		CHECK(full[i] == I2C_Status::OK);
+	}
+	CHECK(bus1->getStats().queuePeak == I2C_QUEUE_SIZE);
+	CHECK(bus3->getStats().queuePeak == 1);
+	bus1->resetStats();
+	bus3->resetStats();
+}
+
+static I2C *bus;							///< Bus the recovery tests run on
+static const uint8_t good[4] = { 0x11, 0x22, 0x33, 0x44 };	///< Last good data
+static const uint8_t fresh[4] = { 0x55, 0x66, 0x77, 0x88 };	///< What a read brings in
+
+/**
+ * @brief Start a recovery test on I2C1 from an idle bus and zeroed counters
+ */
+static void recoveryStart(void) {
+	bus = I2C::Instance(i2cPin::PB8, i2cPin::PB9);
+	bus->readyWait();
+	bus->resetStats();
+	hostI2CReset();
+	hostI2C[0].SR2 = 0;
+}
+
+/**
+ * @brief A NACK is retried I2C_MAX_RETRIES times, then the read is dropped
+ * keeping the last good data
+ */
+static void testNack(void) {
+	recoveryStart();
+
+	uint8_t d[4];
+	volatile I2C_Status status;
+	memcpy(d, good, sizeof(d));
+	CHECK(bus->memRead(0xD6, 0xA8, d, sizeof(d), &status) == 0);
+
+	for (int i = 0; i < I2C_MAX_RETRIES; i++) {
+		hostI2CFail(&i2c1Handle, HAL_I2C_ERROR_AF);
+		CHECK(bus->service() == 0);
+		CHECK(status == I2C_Status::PENDING);
+	}
+	CHECK(hostI2CBuses[0].starts == I2C_MAX_RETRIES + 1);
+
+	hostI2CFail(&i2c1Handle, HAL_I2C_ERROR_AF);
+	CHECK(bus->service() == -1);
+	CHECK(status == I2C_Status::FAILED);
+	CHECK(memcmp(d, good, sizeof(d)) == 0);
+	CHECK(hostI2CBuses[0].starts == I2C_MAX_RETRIES + 1);
+
+	// The error ISR leaves the rx stream running; service() stops it
+	I2C_Stats st = bus->getStats();
+	CHECK(hostI2CBuses[0].dmaAborts == I2C_MAX_RETRIES + 1);
+	CHECK(st.errors == I2C_MAX_RETRIES + 1 && st.retries == I2C_MAX_RETRIES);
+	CHECK(st.failures == 1 && st.recoveries == 0 && st.transfers == 0);
+	CHECK(hostI2CBuses[0].deInits == 0);
+}
+
+/**
+ * @brief A bus error re-initializes the bus, then the read goes through
+ */
+static void testBusError(void) {
+	recoveryStart();
+
+	uint8_t d[4];
+	volatile I2C_Status status;
+	memcpy(d, good, sizeof(d));
+	bus->memRead(0xD6, 0xA8, d, sizeof(d), &status);
+	hostI2CFail(&i2c1Handle, HAL_I2C_ERROR_BERR);
+	CHECK(bus->service() == 0);
+
+	I2C_Stats st = bus->getStats();
+	CHECK(st.recoveries == 1 && st.retries == 1 && st.failures == 0);
+	CHECK(hostI2CBuses[0].deInits == 1 && hostI2CBuses[0].inits == 1);
+	CHECK(hostI2CBuses[0].starts == 2 && status == I2C_Status::PENDING);
+
+	hostI2CComplete(&i2c1Handle, fresh);
+	CHECK(status == I2C_Status::OK && memcmp(d, fresh, sizeof(d)) == 0);
+	CHECK(bus->getStats().transfers == 1);
+}
+
+/**
+ * @brief Transfers that fail to start: HAL_BUSY recovers the bus, HAL_ERROR
+ * (address NACK) retries, both within the same call
+ */
+static void testStartFailure(void) {
+	recoveryStart();
+
+	uint8_t d[4];
+	volatile I2C_Status status;
+	hostI2CBuses[0].failStarts = 1;
+	hostI2CBuses[0].failWith = HAL_BUSY;
+	CHECK(bus->memRead(0xD6, 0xA8, d, sizeof(d), &status) == 0);
+	CHECK(hostI2CBuses[0].starts == 2);
+	CHECK(bus->getStats().recoveries == 1 && bus->getStats().retries == 1);
+	hostI2CComplete(&i2c1Handle, fresh);
+	CHECK(status == I2C_Status::OK);
+
+	recoveryStart();
+	hostI2CBuses[0].failStarts = 2;
+	hostI2CBuses[0].failWith = HAL_ERROR;
+	CHECK(bus->memRead(0xD6, 0xA8, d, sizeof(d), &status) == 0);
+	CHECK(hostI2CBuses[0].starts == 3 && hostI2CBuses[0].dmaAborts == 2);
+	CHECK(bus->getStats().recoveries == 0 && bus->getStats().retries == 2);
+	hostI2CComplete(&i2c1Handle, fresh);
+	CHECK(status == I2C_Status::OK);
+
+	// A start that keeps failing drops the transfer right away
+	recoveryStart();
+	memcpy(d, good, sizeof(d));
+	hostI2CBuses[0].failStarts = 100;
+	hostI2CBuses[0].failWith = HAL_ERROR;
+	CHECK(bus->memRead(0xD6, 0xA8, d, sizeof(d), &status) == -1);
+	CHECK(status == I2C_Status::FAILED && memcmp(d, good, sizeof(d)) == 0);
+	CHECK(hostI2CBuses[0].starts == I2C_MAX_RETRIES + 1);
+}
+
+/**
+ * @brief A slave holding SDA keeps BUSY set: the bounded wait gives up, the
+ * bus is recovered, and the transfer is dropped without ever starting
+ */
+static void testBusHeld(void) {
+	recoveryStart();
+
+	uint8_t d[4];
+	volatile I2C_Status status;
+	hostI2CBuses[0].busHeld = true;
+	hostI2C[0].SR2 = I2C_SR2_BUSY;
+	CHECK(bus->memRead(0xD6, 0xA8, d, sizeof(d), &status) == -1);
+	CHECK(status == I2C_Status::FAILED);
+	CHECK(hostI2CBuses[0].starts == 0);
+	CHECK(bus->getStats().recoveries == I2C_MAX_RETRIES);
+	CHECK(bus->getStats().failures == 1);
+
+	// Once the slave lets go the next recovery clears the bus
+	hostI2CBuses[0].busHeld = false;
+	bus->memRead(0xD6, 0xA8, d, sizeof(d), &status);
+	CHECK(hostI2CBuses[0].starts == 1 && status == I2C_Status::PENDING);
+	hostI2CComplete(&i2c1Handle, fresh);
+	CHECK(status == I2C_Status::OK);
+}
+
+/**
+ * @brief A lost completion interrupt: the transfer is declared stuck after
+ * I2C_XFER_TIMEOUT_US, is past the retry budget and dropped, and the bus is
+ * reset. The late interrupt changes nothing.
+ */
+static void testLostInterrupt(void) {
+	recoveryStart();
+
+	uint8_t d[4];
+	volatile I2C_Status status;
+	memcpy(d, good, sizeof(d));
+	bus->memRead(0xD6, 0xA8, d, sizeof(d), &status);
+	CHECK(bus->service() == 0);
+	CHECK(status == I2C_Status::PENDING);
+
+	hostAdvanceUs(I2C_XFER_TIMEOUT_US);
+	CHECK(bus->service() == -1);
+	CHECK(status == I2C_Status::FAILED && memcmp(d, good, sizeof(d)) == 0);
+	CHECK(bus->getStats().recoveries == 1 && bus->getStats().failures == 1);
+	CHECK(HAL_I2C_GetState(&i2c1Handle) == HAL_I2C_STATE_READY);
+
+	hostI2CComplete(&i2c1Handle, fresh);
+	CHECK(memcmp(d, good, sizeof(d)) == 0 && bus->getStats().transfers == 0);
+}
+
+/**
+ * @brief Retries stop once I2C_RETRY_BUDGET_US has passed since the first start
+ */
+static void testRetryBudget(void) {
+	recoveryStart();
+
+	uint8_t d[4];
+	volatile I2C_Status status;
+	bus->memRead(0xD6, 0xA8, d, sizeof(d), &status);
+	hostAdvanceUs(I2C_RETRY_BUDGET_US / 2);
+	hostI2CFail(&i2c1Handle, HAL_I2C_ERROR_AF);
+	CHECK(bus->service() == 0);
+	CHECK(hostI2CBuses[0].starts == 2);
+
+	hostAdvanceUs(I2C_RETRY_BUDGET_US / 2);
+	hostI2CFail(&i2c1Handle, HAL_I2C_ERROR_AF);
+	CHECK(bus->service() == -1);
+	CHECK(status == I2C_Status::FAILED && hostI2CBuses[0].starts == 2);
+}
+
+/**
+ * @brief The interrupts only retire transfers; the next one is started by
+ * service() or readyWait() in thread context
+ */
+static void testQueueAdvance(void) {
+	recoveryStart();
+
+	uint8_t d1[4], d2[4];
+	volatile I2C_Status s1, s2;
+	bus->memRead(0xD6, 0xA8, d1, sizeof(d1), &s1);
+	bus->memRead(0x3C, 0x03, d2, sizeof(d2), &s2);
+	CHECK(hostI2CBuses[0].starts == 1);
+
+	hostI2CComplete(&i2c1Handle, fresh);
+	CHECK(s1 == I2C_Status::OK && s2 == I2C_Status::PENDING);
+	CHECK(hostI2CBuses[0].starts == 1);
+	bus->service();
+	CHECK(hostI2CBuses[0].starts == 2 && hostI2CBuses[0].devAddr == 0x3C);
+
+	hostI2CFail(&i2c1Handle, HAL_I2C_ERROR_AF);
+	CHECK(hostI2CBuses[0].starts == 2 && s2 == I2C_Status::PENDING);
+	bus->service();
+	CHECK(hostI2CBuses[0].starts == 3);
+	hostI2CComplete(&i2c1Handle, fresh);
+	CHECK(s2 == I2C_Status::OK);
+
+	// With nothing completing, readyWait() still returns: each transfer is
+	// declared stuck and dropped in turn
+	bus->memRead(0xD6, 0xA8, d1, sizeof(d1), &s1);
+	bus->memRead(0x3C, 0x03, d2, sizeof(d2), &s2);
+	bus->readyWait();
+	CHECK(s1 == I2C_Status::FAILED && s2 == I2C_Status::FAILED);
+	CHECK(hostI2CBuses[0].starts == 5);
+	CHECK(HAL_I2C_GetState(&i2c1Handle) == HAL_I2C_STATE_READY);
+}
+
+/**
+ * @brief A sensor that stops answering serves its last good sample (stale),
+ * then is reported lost after I2C_MAX_STALE failed reads
+ */
+static void testStale(void) {
+	recoveryStart();
+
+	uint8_t d[4], failures = 0;
+	volatile I2C_Status status = I2C_Status::OK;
+	memcpy(d, good, sizeof(d));
+	hostI2CBuses[0].failStarts = 1000;
+	hostI2CBuses[0].failWith = HAL_ERROR;
+
+	int reads = 0;
+	while (!i2cSensorLost(status, &failures)) {
+		bus->memRead(0xD6, 0xA8, d, sizeof(d), &status);
+		CHECK(memcmp(d, good, sizeof(d)) == 0);
+		reads++;
+	}
+	CHECK(reads == I2C_MAX_STALE);
+	CHECK(bus->getStats().failures == I2C_MAX_STALE);
+
+	// One good read and it is back
+	hostI2CBuses[0].failStarts = 0;
+	bus->memRead(0xD6, 0xA8, d, sizeof(d), &status);
+	hostI2CComplete(&i2c1Handle, fresh);
+	CHECK(!i2cSensorLost(status, &failures) && failures == 0);
+	CHECK(memcmp(d, fresh, sizeof(d)) == 0);
+}
+
+/**
+ * @brief Enabling the cycle counter starts it once and never resets it, so
+ * another module enabling it doesn't break the bus statistics
+ */
+static void testCycleCounter(void) {
+	hostDwt.CTRL = 0;
+	hostCoreDebug.DEMCR = 0;
+	hostDwt.CYCCNT = 1234;
+	cycleCounterInit();
+	CHECK(hostDwt.CTRL & DWT_CTRL_CYCCNTENA_Msk);
+	CHECK(hostCoreDebug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk);
+
+	hostDwt.CYCCNT = 0xFFFFF000u;
+	cycleCounterInit();
+	CHECK(hostDwt.CYCCNT.now == 0xFFFFF000u);
+}
+
+int main(void) {
+	testCycleCounter();
+	testPins();
+	testErrorAction();
+	testSensorLost();
+	testDispatch();
+	testNack();
+	testBusError();
+	testStartFailure();
+	testBusHeld();
+	testLostInterrupt();
+	testRetryBudget();
+	testQueueAdvance();
+	testStale();
+
+	return checkDone("test_i2c");
+}
@@ -0,0 +1,155 @@
+/**
+ * @file
+ *
+ * @brief Host test of the IMU offset calibration on synthetic sample streams
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Samples are the true offsets plus white noise about as strong as the
+ * L3GD20H and LSM303D give at rest, plus optional motion, at the 200 Hz the
+ * IMU samples at during calibrate().
+ *
+ */
+
+#include "ImuCalibrator.h"
+#include "check.h"
+#include <random>
+
+#define DT				0.005f		///< Sample time [s]
+#define GYRO_NOISE		0.12f		///< Gyro noise, standard deviation [deg/s]
+#define ACC_NOISE		0.004f		///< Accelerometer noise, standard deviation [g]
+
+static const float gyroTrue[3] = { 1.5f, -0.8f, 0.3f };		///< Gyro at rest [deg/s]
+static const float accTrue[3] = { 0.02f, -0.03f, -0.97f };	///< Accelerometer at rest [g]
+
+static std::mt19937 rng(1);
+static std::normal_distribution<float> gauss(0.0f, 1.0f);
+
+/**
+ * @brief Motion on top of the rest readings
+ * @param t Time since start() [s]
+ * @return Gyro amplitude of a 3 Hz wobble [deg/s]
+ */
+typedef float (*motionFn)(float t);
+
+static float still(float t) { (void)t; return 0.0f; }
+static float moving(float t) { (void)t; return 20.0f; }
+static float movedAtFirst(float t) { return t < 0.3f ? 20.0f : 0.0f; }
+static float bumped(float t) { return (t > 0.09f && t < 0.12f) ? 5.0f : 0.0f; }
+
+/**
+ * @brief Run a calibration to the end, or 10 s
+ * @param cal     Calibrator
+ * @param stored  Stored offsets, NULL for none
+ * @param temp    Gyro temperature [degC]
+ * @param motion  Motion while calibrating
+ * @param seconds Returns how long it took [s]
+ */
+static CalResult calibrate(ImuCalibrator &cal, const ImuCalibration *stored, float temp, motionFn motion,
+		float *seconds) {
+	CalResult r;
+	float t = 0.0f;
+
+	cal.start(stored, temp);
+	do {
+		float m = motion(t);
+		float g[3], a[3];
+
+		for (int c = 0; c < 3; c++) {
+			float wobble = sinf(2.0f * M_PI * 3.0f * t + c);
+			g[c] = gyroTrue[c] + GYRO_NOISE * gauss(rng) + m * wobble;
+			a[c] = accTrue[c] + ACC_NOISE * gauss(rng) + 0.01f * m * wobble;
+		}
+		t += DT;
+		r = cal.update(g, a, DT);
+	} while (r == CalResult::RUNNING && t < 10.0f);
+
+	*seconds = t;
+	return r;
+}
+
+/**
+ * @brief Offsets match the true rest readings, less gravity on z
+ */
+static bool offsetsOk(ImuCalibrator &cal, float gyroTol) {
+	ImuCalibration o;
+	bool ok = true;
+
+	cal.getCalibration(&o);
+	for (int c = 0; c < 3; c++) {
+		ok &= fabsf(o.gyro[c] - gyroTrue[c]) < gyroTol;
+		ok &= fabsf(o.acc[c] - (accTrue[c] - (c == 2 ? -1.0f : 0.0f))) < 0.005f;
+	}
+	return ok;
+}
+
+int main(void) {
+	ImuCalibrator cal;
+	ImuCalibration o;
+	float t;
+	CalResult r;
+
+	// Idle until started
+	CHECK(cal.getResult() == CalResult::UNSETTLED);
+
+	// Cold start, kept still: a few windows are enough
+	r = calibrate(cal, NULL, 30.0f, still, &t);
+	printf("cold, still: result %d in %.0f ms\n", (int)r, t * 1000.0f);
+	CHECK(r == CalResult::MEASURED);
+	CHECK(t < 0.45f);
+	CHECK(cal.getAttempts() == 1);
+	CHECK(offsetsOk(cal, 0.06f));
+	cal.getCalibration(&o);
+	CHECK(o.temp == 30.0f);
+	CHECK_NEAR(cal.getElapsed(), t, 1e-4f);
+	ImuCalibration stored = o;
+
+	// Moved at first, or bumped part way: the average starts over
+	r = calibrate(cal, NULL, 30.0f, movedAtFirst, &t);
+	printf("cold, moved 0.3 s: result %d in %.0f ms, %u attempts\n", (int)r, t * 1000.0f, cal.getAttempts());
+	CHECK(r == CalResult::MEASURED && cal.getAttempts() > 1 && t < 0.8f);
+	CHECK(offsetsOk(cal, 0.06f));
+	r = calibrate(cal, NULL, 30.0f, bumped, &t);
+	CHECK(r == CalResult::MEASURED && cal.getAttempts() > 1);
+	CHECK(offsetsOk(cal, 0.06f));
+
+	// Stored offsets at a close temperature: confirmed by one quiet window,
+	// or used straight away while the vehicle is being moved
+	r = calibrate(cal, &stored, 32.0f, still, &t);
+	printf("warm, still: result %d in %.0f ms\n", (int)r, t * 1000.0f);
+	CHECK(r == CalResult::CACHED && t < 0.1f);
+	cal.getCalibration(&o);
+	CHECK(o.temp == stored.temp && o.gyro[0] == stored.gyro[0]);
+	r = calibrate(cal, &stored, 28.0f, moving, &t);
+	CHECK(r == CalResult::CACHED && t < 0.1f);
+
+	// Too far from the stored temperature, stored offsets that disagree, or
+	// no temperature: measured again
+	r = calibrate(cal, &stored, 45.0f, still, &t);
+	CHECK(r == CalResult::MEASURED);
+	cal.getCalibration(&o);
+	CHECK(o.temp == 45.0f);
+	ImuCalibration stale = stored;
+	stale.gyro[0] += 2.0f;
+	r = calibrate(cal, &stale, 30.0f, still, &t);
+	CHECK(r == CalResult::MEASURED);
+	CHECK(offsetsOk(cal, 0.06f));
+	r = calibrate(cal, &stored, NAN, still, &t);
+	CHECK(r == CalResult::MEASURED);
+	cal.getCalibration(&o);
+	CHECK(o.temp == CAL_TEMP_NONE);
+	ImuCalibration untagged = o;
+	r = calibrate(cal, &untagged, 30.0f, still, &t);
+	CHECK(r == CalResult::MEASURED);	// Never reused without a temperature
+
+	// Never still: gives up at the timeout with the quietest window
+	r = calibrate(cal, NULL, 30.0f, moving, &t);
+	printf("cold, moving: result %d in %.0f ms\n", (int)r, t * 1000.0f);
+	CHECK(r == CalResult::UNSETTLED);
+	CHECK_NEAR(t, CAL_TIMEOUT, 0.01f);
+	CHECK(cal.update(gyroTrue, accTrue, DT) == CalResult::UNSETTLED);
+
+	return checkDone("test_imu_calibrator");
+}
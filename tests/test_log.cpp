@@ -0,0 +1,98 @@
+/**
+ * @file
+ *
+ * @brief Host test of the log categories and levels
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Built with LOG_RAW and LOG_OUTPUT defined (see the Makefile), so RAW and
+ * OUTPUT messages are compiled in and the other categories are not.
+ * BinLog::write() is replaced by a stand-in that counts what reaches the
+ * ring.
+ *
+ */
+
+#include "Log.h"
+#include "check.h"
+#include <string.h>
+
+static int written = 0;			///< Entries that reached BinLog::write()
+static uint16_t lastId = 0xFFFF;	///< Id of the last one
+static uint8_t lastArgs = 0;	///< Its argument count
+
+bool BinLog::write(LogMsg id, const uint32_t *args, uint8_t n) {
+	(void)args;
+	written++;
+	lastId = (uint16_t)id;
+	lastArgs = n;
+	return true;
+}
+
+/**
+ * @brief Log one message of each category, return how many got through
+ */
+static int logEach(void) {
+	int before = written;
+
+	logMsg<LogMsg::GYRO_X>(1.0f);				// RAW, VERBOSE
+	logMsg<LogMsg::GYRO_X_FILT>(1.0f);			// PREFILTERED, VERBOSE
+	logMsg<LogMsg::ACC_ANGLES>(1.0f, 2.0f);		// ACC_ANGLE, INFO
+	logMsg<LogMsg::COMP_TERMS>(1.0f, 2.0f, 3.0f, 4.0f);	// COMP_FILTERED, INFO
+	logMsg<LogMsg::ATTITUDE>(1.0f, 2.0f);		// OUTPUT, INFO
+
+	return written - before;
+}
+
+// Build-time filter: categories from the defines, every level up to LOG_MAX_LEVEL
+static_assert(logBuildCategories == (LOG_CAT_BIT(RAW) | LOG_CAT_BIT(OUTPUT)), "build categories");
+static_assert(logBuilt(LogMsg::GYRO_X) && logBuilt(LogMsg::ATTITUDE), "built in");
+static_assert(!logBuilt(LogMsg::GYRO_X_FILT) && !logBuilt(LogMsg::COMP_TERMS), "compiled out");
+static_assert(sizeof(logCategories) / sizeof(logCategories[0]) == (size_t)LogMsg::NUM_MESSAGES, "one category per message");
+static_assert(sizeof(logLevels) / sizeof(logLevels[0]) == (size_t)LogMsg::NUM_MESSAGES, "one level per message");
+
+int main(void) {
+	// Everything compiled in is on at start up
+	CHECK(Log::getCategories() == logBuildCategories);
+	CHECK(Log::getLevel() == LOG_MAX_LEVEL);
+	CHECK(logEach() == 2);
+	CHECK(lastId == (uint16_t)LogMsg::ATTITUDE && lastArgs == 2);
+
+	// Compiled-out categories stay off whatever the parameters say
+	Log::setCategories(0xFFFFFFFF);
+	CHECK(Log::getCategories() == logBuildCategories);
+	CHECK(logEach() == 2);
+
+	// Run-time categories narrow the build
+	Log::setCategories(LOG_CAT_BIT(OUTPUT));
+	CHECK(logEach() == 1);
+	CHECK(lastId == (uint16_t)LogMsg::ATTITUDE);
+	Log::setCategories(LOG_CAT_BIT(RAW));
+	CHECK(logEach() == 1);
+	CHECK(lastId == (uint16_t)LogMsg::GYRO_X);
+	Log::setCategories(0);
+	CHECK(logEach() == 0);
+
+	// Levels: INFO drops the VERBOSE raw readings, FAULT drops everything here
+	Log::setCategories(LOG_DEFAULT_CATEGORIES);
+	Log::setLevel((uint8_t)LogLevel::INFO);
+	CHECK(Log::getLevel() == (uint8_t)LogLevel::INFO);
+	CHECK(logEach() == 1);
+	CHECK(lastId == (uint16_t)LogMsg::ATTITUDE);
+	Log::setLevel((uint8_t)LogLevel::FAULT);
+	CHECK(logEach() == 0);
+
+	// Levels above the build's are clamped
+	Log::setLevel(9);
+	CHECK(Log::getLevel() == LOG_MAX_LEVEL);
+	CHECK(logEach() == 2);
+
+	// Log::enabled() agrees with what logMsg() did for built messages
+	Log::setCategories(LOG_CAT_BIT(RAW));
+	CHECK(Log::enabled(LogMsg::GYRO_X));
+	CHECK(!Log::enabled(LogMsg::ATTITUDE));
+	CHECK(!Log::enabled(LogMsg::GYRO_X_FILT));
+
+	return checkDone("test_log");
+}
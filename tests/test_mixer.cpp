@@ -0,0 +1,118 @@
+/**
+ * @file
+ *
+ * @brief Host test of the motor mixer and its desaturation
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+#include "mixer.h"
+#include "check.h"
+#include <stdlib.h>
+
+#define TOL		1e-5f
+
+/**
+ * @brief Mix and return the applied fractions
+ */
+static void mixApplied(mixer &m, float t, float r, float p, float y, float *out, float *rp, float *yaw) {
+	m.mix(t, r, p, y, out);
+	m.getApplied(rp, yaw);
+}
+
+/**
+ * @brief Random value between lo and hi
+ */
+static float randRange(float lo, float hi) {
+	return lo + (hi - lo) * (float)rand() / (float)RAND_MAX;
+}
+
+int main(void) {
+	float out[MIXER_MAX_MOTORS];
+	float rp, yaw;
+
+	CHECK(mixerFrameMotors(mixerFrame::QUAD_PLUS) == 4);
+	CHECK(mixerFrameMotors(mixerFrame::QUAD_X) == 4);
+	CHECK(mixerFrameMotors(mixerFrame::HEX_X) == 6);
+	CHECK(mixerFrameMotors(mixerFrame::OCTO_X) == 8);
+
+	// Quad plus: front, rear, left, right
+	mixer q(mixerFrame::QUAD_PLUS, 1.0f);
+	CHECK(q.getMotors() == 4);
+
+	// Unsaturated: plain matrix product, everything applied
+	mixApplied(q, 0.5f, 0.1f, 0.05f, 0.02f, out, &rp, &yaw);
+	CHECK_NEAR(out[0], 0.5f - 0.05f - 0.02f, TOL);
+	CHECK_NEAR(out[1], 0.5f + 0.05f - 0.02f, TOL);
+	CHECK_NEAR(out[2], 0.5f + 0.1f + 0.02f, TOL);
+	CHECK_NEAR(out[3], 0.5f - 0.1f + 0.02f, TOL);
+	CHECK_NEAR(rp, 1.0f, TOL);
+	CHECK_NEAR(yaw, 1.0f, TOL);
+
+	// Zero throttle stops every motor whatever the attitude commands
+	mixApplied(q, 0.0f, 0.3f, -0.3f, 0.3f, out, &rp, &yaw);
+	for (int i = 0; i < 4; i++) CHECK(out[i] == 0.0f);
+	CHECK(rp == 0.0f && yaw == 0.0f);
+
+	// Near full throttle: throttle gives way, the roll differential stays
+	mixApplied(q, 0.95f, 0.1f, 0.0f, 0.0f, out, &rp, &yaw);
+	CHECK_NEAR(out[2], 1.0f, TOL);
+	CHECK_NEAR(out[2] - out[3], 0.2f, TOL);
+	CHECK_NEAR(rp, 1.0f, TOL);
+
+	// Near zero throttle: throttle is raised, the differential stays
+	mixApplied(q, 0.02f, 0.1f, 0.0f, 0.0f, out, &rp, &yaw);
+	CHECK_NEAR(out[3], 0.0f, TOL);
+	CHECK_NEAR(out[2] - out[3], 0.2f, TOL);
+
+	// Roll/pitch + yaw too wide: yaw is scaled, roll is kept.
+	// Roll spread 0.6, with yaw 1.1, so yaw scales by 0.4 / 0.5
+	mixApplied(q, 0.5f, 0.3f, 0.0f, 0.4f, out, &rp, &yaw);
+	CHECK_NEAR(rp, 1.0f, TOL);
+	CHECK_NEAR(yaw, 0.8f, TOL);
+	CHECK_NEAR(out[2] - out[3], 0.6f, TOL);
+	CHECK_NEAR(out[2] - out[0], 0.3f + 2.0f * 0.8f * 0.4f, TOL);
+
+	// Roll alone too wide: roll is scaled to the range, yaw dropped
+	mixApplied(q, 0.5f, 0.8f, 0.0f, 0.2f, out, &rp, &yaw);
+	CHECK_NEAR(rp, 1.0f / 1.6f, TOL);
+	CHECK_NEAR(yaw, 0.0f, TOL);
+	CHECK_NEAR(out[2], 1.0f, TOL);
+	CHECK_NEAR(out[3], 0.0f, TOL);
+	CHECK_NEAR(out[0], out[1], TOL);
+
+	// Output range other than 1
+	mixer q4(mixerFrame::QUAD_PLUS, 0.4f);
+	mixApplied(q4, 0.38f, 0.1f, 0.0f, 0.0f, out, &rp, &yaw);
+	CHECK_NEAR(out[2], 0.4f, TOL);
+	CHECK_NEAR(out[2] - out[3], 0.2f, TOL);
+
+	// Every frame, random commands: outputs stay in range, the applied
+	// fractions are within 0..1 and never scale an unsaturated mix
+	const mixerFrame frames[] = {mixerFrame::QUAD_PLUS, mixerFrame::QUAD_X, mixerFrame::HEX_X, mixerFrame::OCTO_X};
+	srand(3);
+	for (uint8_t f = 0; f < sizeof(frames) / sizeof(frames[0]); f++) {
+		mixer m(frames[f], 1.0f);
+		int bad = 0;
+
+		for (int k = 0; k < 20000; k++) {
+			float t = randRange(0.001f, 1.0f);
+			float r = randRange(-1.0f, 1.0f), p = randRange(-1.0f, 1.0f), y = randRange(-1.0f, 1.0f);
+			bool small = fabsf(r) + fabsf(p) + fabsf(y) < 0.1f && t > 0.2f && t < 0.8f;
+
+			mixApplied(m, t, r, p, y, out, &rp, &yaw);
+			for (uint8_t i = 0; i < m.getMotors(); i++) {
+				if (!(out[i] >= 0.0f && out[i] <= 1.0f)) bad++;
+			}
+			if (!(rp >= 0.0f && rp <= 1.0f && yaw >= 0.0f && yaw <= 1.0f)) bad++;
+			if (yaw > 0.0f && rp < 1.0f) bad++;
+			if (small && (rp != 1.0f || yaw != 1.0f)) bad++;
+		}
+		CHECK(bad == 0);
+	}
+
+	return checkDone("test_mixer");
+}
@@ -0,0 +1,175 @@
+/**
+ * @file
+ *
+ * @brief Host test of the MotorGroup PWM timing and CCR latch
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * motorGroupLatch() runs against plain TIM_TypeDef structs. Each one sits
+ * across a page boundary with its CCRs on a protected page, so every CCR
+ * write traps; the handler checks that update events are disabled on every
+ * TIM at that moment, then lets the write through.
+ *
+ */
+
+#include "MotorGroup.h"
+#include "check.h"
+#include <signal.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define NUM_TIMS	4		///< TIMs in the latch test
+#define NUM_MOTORS	8		///< Motors in the latch test, alternating TIMs
+
+static TIM_TypeDef *tims[NUM_TIMS];
+static uint8_t *ccrPage[NUM_TIMS];		///< Page holding the CCRs of each TIM
+static long pageSize;
+
+static int ccrWrites = 0;				///< CCR writes seen
+static int writesUnlatched = 0;			///< CCR writes made with UDIS clear on some TIM
+static int strayFaults = 0;				///< Faults outside the CCR pages
+
+/**
+ * @brief A CCR write: check every TIM has UDIS set, then open that TIM's
+ * CCR page and close the others, so the next write to another TIM traps
+ */
+static void onFault(int sig, siginfo_t *info, void *ctx) {
+	(void)sig;
+	(void)ctx;
+	uint8_t *addr = (uint8_t *)info->si_addr;
+	int hit = -1;
+
+	for (int t = 0; t < NUM_TIMS; t++) {
+		if (addr >= ccrPage[t] && addr < ccrPage[t] + pageSize) {
+			hit = t;
+		}
+	}
+	if (hit < 0) {
+		strayFaults++;
+		signal(SIGSEGV, SIG_DFL);
+		signal(SIGBUS, SIG_DFL);
+		return;
+	}
+
+	ccrWrites++;
+	for (int t = 0; t < NUM_TIMS; t++) {
+		if ((tims[t]->CR1 & TIM_CR1_UDIS) == 0) {
+			writesUnlatched++;
+		}
+		mprotect(ccrPage[t], pageSize, (t == hit) ? PROT_READ | PROT_WRITE : PROT_NONE);
+	}
+}
+
+/**
+ * @brief Open or close the CCR pages of all TIMs
+ */
+static void protectCcrs(bool on) {
+	for (int t = 0; t < NUM_TIMS; t++) {
+		mprotect(ccrPage[t], pageSize, on ? PROT_NONE : PROT_READ | PROT_WRITE);
+	}
+}
+
+/**
+ * @brief Every CCR is written while every TIM has update events disabled,
+ * and the events are enabled again afterwards
+ */
+static void testLatch(void) {
+	MotorGroupOut out[NUM_MOTORS];
+	const float s[NUM_MOTORS] = { 0.0f, 0.05f, 0.1f, 0.15f, 0.2f, 0.25f, 0.3f, MAX_SPEED };
+
+	pageSize = sysconf(_SC_PAGESIZE);
+	for (int t = 0; t < NUM_TIMS; t++) {
+		uint8_t *mem = (uint8_t *)mmap(NULL, 2 * pageSize, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		CHECK(mem != MAP_FAILED);
+		ccrPage[t] = mem + pageSize;
+		tims[t] = (TIM_TypeDef *)(ccrPage[t] - offsetof(TIM_TypeDef, CCR1));
+		tims[t]->CR1 = TIM_CR1_ARPE | TIM_CR1_CEN;
+	}
+
+	// Motor i on TIM i % NUM_TIMS, so consecutive writes change TIM
+	for (int i = 0; i < NUM_MOTORS; i++) {
+		out[i].tim = i % NUM_TIMS;
+		out[i].ccr = &tims[out[i].tim]->CCR1 + i / NUM_TIMS;
+		out[i].zero = 1000.0f + i;
+		out[i].span = 2000.0f;
+	}
+
+	struct sigaction sa;
+	sa.sa_sigaction = onFault;
+	sa.sa_flags = SA_SIGINFO;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGSEGV, &sa, NULL);
+	sigaction(SIGBUS, &sa, NULL);
+
+	protectCcrs(true);
+	motorGroupLatch(tims, NUM_TIMS, out, s, NUM_MOTORS);
+	protectCcrs(false);
+
+	printf("latch: %d CCR writes trapped, %d with update events enabled\n", ccrWrites, writesUnlatched);
+	CHECK(strayFaults == 0);
+	CHECK(ccrWrites == NUM_MOTORS);
+	CHECK(writesUnlatched == 0);
+
+	for (int t = 0; t < NUM_TIMS; t++) {
+		CHECK(tims[t]->CR1 == (TIM_CR1_ARPE | TIM_CR1_CEN));
+	}
+	for (int i = 0; i < NUM_MOTORS; i++) {
+		CHECK(*out[i].ccr == (uint32_t)(out[i].zero + s[i] * out[i].span));
+	}
+}
+
+/**
+ * @brief Tick rate, period and pulse scaling of each PWM protocol
+ * @param proto     ESC protocol
+ * @param clock     TIM clock [Hz]
+ * @param div       Prescaler division expected
+ * @param arr       Auto-reload value expected
+ */
+static void checkTiming(MotorProtocol proto, float clock, uint32_t div, uint32_t arr) {
+	float f, zeroW, fullW, zero, span;
+	uint32_t gotArr = 0;
+
+	CHECK(motorPwmTiming(proto, &f, &zeroW, &fullW));
+	float fTick = motorGroupTiming(proto, clock, &gotArr, &zero, &span);
+	printf("%3.0f MHz, %4.0f Hz: tick %.4f MHz, ARR %lu, zero %.1f, span %.1f ticks\n", clock * 1e-6f, f,
+			fTick * 1e-6f, (unsigned long)gotArr, zero, span);
+
+	CHECK_NEAR(fTick, clock / div, 1.0f);
+	CHECK(gotArr == arr);
+	CHECK(gotArr <= 0xFFFF);
+
+	// The period matches the protocol's frequency to a tick
+	CHECK_NEAR((gotArr + 1) / fTick, 1.0f / f, 1.0f / fTick);
+
+	// Zero and full throttle land on the protocol's widths, inside the period
+	CHECK_NEAR(zero, zeroW * 1e-3f * fTick, 0.01f);
+	CHECK_NEAR(zero + span, fullW * 1e-3f * fTick, 0.01f);
+	CHECK(zero + span < gotArr);
+	CHECK(span >= 1000.0f);		// Throttle steps of 0.1% or finer
+}
+
+static void testTiming(void) {
+	// APB1 TIMs run at 84 MHz, APB2 TIMs at 168 MHz
+	checkTiming(MotorProtocol::PWM, 84e6f, 26, 64614);
+	checkTiming(MotorProtocol::PWM, 168e6f, 52, 64614);
+	checkTiming(MotorProtocol::PWM400, 84e6f, 4, 52499);
+	checkTiming(MotorProtocol::PWM400, 168e6f, 7, 59999);
+	checkTiming(MotorProtocol::ONESHOT125, 84e6f, 1, 41999);
+	checkTiming(MotorProtocol::ONESHOT125, 168e6f, 2, 41999);
+
+	// No pulse widths for DShot
+	float zero, span;
+	uint32_t arr;
+	CHECK(motorGroupTiming(MotorProtocol::DSHOT600, 84e6f, &arr, &zero, &span) == 0.0f);
+}
+
+int main(void) {
+	testTiming();
+	testLatch();
+
+	return checkDone("test_motor_group");
+}
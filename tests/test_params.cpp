@@ -0,0 +1,136 @@
+/**
+ * @file
+ *
+ * @brief Host test of the parameter table and the flash parameter log
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * The flash is two RAM banks behind ParamFlashOps that, like NOR flash, can
+ * only clear bits when programming. Power loss is simulated by failing an
+ * operation partway through an update, sometimes leaving a torn word.
+ *
+ */
+
+#include "Params.h"
+#include "check.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define BANK_WORDS	256
+
+static uint32_t flash[2][BANK_WORDS];
+static int budget = -1;			///< Operations left before the power cut, -1 for none
+static uint32_t erases[2];
+
+static bool flashProgram(volatile uint32_t *addr, uint32_t word) {
+	if (budget == 0) return false;
+	if (budget > 0) budget--;
+	if (budget == 0 && rand() % 2) {
+		*addr &= (word | (uint32_t)(rand() | 1));	// Torn word
+		return false;
+	}
+	*addr &= word;
+	return true;
+}
+
+static bool flashErase(uint8_t b) {
+	if (budget == 0) return false;
+	if (budget > 0) budget--;
+	memset(flash[b], 0xFF, sizeof(flash[b]));
+	erases[b]++;
+	return true;
+}
+
+static const ParamFlashOps ops = {flashProgram, flashErase};
+static const uint16_t N = (uint16_t)ParamId::NUM_PARAMS;
+
+int main(void) {
+	ParamValue v;
+
+	// Every default is inside its own range
+	paramDefaults();
+	for (uint16_t i = 0; i < N; i++) {
+		CHECK(paramTable[i].min <= paramTable[i].max);
+		CHECK(paramTable[i].def >= paramTable[i].min && paramTable[i].def <= paramTable[i].max);
+		CHECK(paramCheck(i, paramAsFloat(i), &v) == ParamStatus::OK && v.u == paramValues[i].u);
+	}
+
+	// Range, id and type checks
+	const uint16_t tau = (uint16_t)ParamId::COMP_TAU;
+	CHECK(paramCheck(tau, paramTable[tau].max * 2.0f + 1.0f, &v) == ParamStatus::OUT_OF_RANGE);
+	CHECK(paramCheck(tau, paramTable[tau].min - 1.0f, &v) == ParamStatus::OUT_OF_RANGE);
+	CHECK(paramCheck(tau, 0.0f / 0.0f, &v) == ParamStatus::OUT_OF_RANGE);
+	CHECK(paramCheck(N, 0.0f, &v) == ParamStatus::UNKNOWN_ID);
+	CHECK(paramCheck((uint16_t)ParamId::TELEM_DIVIDER, 3.6f, &v) == ParamStatus::OK && v.i == 4);
+
+	// Blank flash loads nothing; the first change compacts every value into
+	// bank 0
+	memset(flash, 0xFF, sizeof(flash));
+	{
+		ParamLog log(flash[0], flash[1], sizeof(flash[0]), ops);
+		paramDefaults();
+		CHECK(log.load(paramValues, N) == 0);
+		CHECK(log.getActive() == -1);
+		CHECK(paramCheck(0, 7.5f, &v) == ParamStatus::OK);
+		paramValues[0] = v;
+		CHECK(log.append(0, v.u, paramValues, N));
+		CHECK(log.getActive() == 0);
+	}
+	{
+		ParamLog log(flash[0], flash[1], sizeof(flash[0]), ops);
+		paramDefaults();
+		CHECK(log.load(paramValues, N) == N);
+		CHECK(paramGet(ParamId::PITCH_P) == 7.5f);
+	}
+
+	// Many changes with random power cuts, checked against a reference copy.
+	// A cut change may load as the old or the new value, nothing else may move
+	ParamValue ref[N];
+	paramDefaults();
+	memcpy(ref, paramValues, sizeof(ref));
+	ref[0].f = 7.5f;
+	uint32_t cuts = 0, mismatches = 0;
+	srand(1);
+	for (int it = 0; it < 20000; it++) {
+		ParamLog log(flash[0], flash[1], sizeof(flash[0]), ops);
+		paramDefaults();
+		log.load(paramValues, N);
+		for (uint16_t i = 0; i < N; i++) {
+			if (paramValues[i].u != ref[i].u) mismatches++;
+		}
+
+		uint16_t id = rand() % N;
+		float f = paramTable[id].min + (paramTable[id].max - paramTable[id].min) * (rand() % 1000) / 1000.0f;
+		if (paramCheck(id, f, &v) != ParamStatus::OK) mismatches++;
+		ParamValue old = paramValues[id];
+		paramValues[id] = v;
+
+		bool cut = (rand() % 5 == 0);
+		if (cut) {
+			budget = 1 + rand() % 40;
+			cuts++;
+		}
+		bool ok = log.append(id, v.u, paramValues, N);
+		bool hit = cut && budget == 0;
+		budget = -1;
+
+		if (ok && !hit) {
+			ref[id] = v;
+		} else if (hit) {
+			ParamLog after(flash[0], flash[1], sizeof(flash[0]), ops);
+			paramDefaults();
+			after.load(paramValues, N);
+			if (paramValues[id].u != old.u && paramValues[id].u != v.u) mismatches++;
+			ref[id] = paramValues[id];
+		} else {
+			mismatches++;
+		}
+	}
+	printf("power cuts %u, erases %u/%u\n", cuts, erases[0], erases[1]);
+	CHECK(mismatches == 0);
+	CHECK(erases[0] > 10 && erases[1] > 10);
+
+	return checkDone("test_params");
+}
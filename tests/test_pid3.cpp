@@ -0,0 +1,162 @@
+/**
+ * @file
+ *
+ * @brief Host test of pid3: derivative, anti-windup and feed-forward
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Where pid3 is meant to do better than pid2 (derivative kick, windup), the
+ * same case is run through pid2 for comparison.
+ *
+ */
+
+#include "pid3.h"
+#include "pid2.h"
+#include "check.h"
+#include <stdlib.h>
+
+#define DT		0.005f		///< Sample time, the 200 Hz rate loop [s]
+
+/**
+ * @brief Outcome of a saturated rate step
+ */
+typedef struct {
+	float peak;		///< Highest rate reached [deg/s]
+	float final;	///< Rate at the end [deg/s]
+} stepResult;
+
+/**
+ * @brief A 200 deg/s step on a rate axis whose command saturates at +/-1
+ * @param usePid3 Run pid3 with back-calculation, else pid2 clamped after
+ *
+ * The axis accelerates at 100 deg/s^2 per unit command, with a little drag.
+ */
+static stepResult saturatedStep(bool usePid3) {
+	pid3 c(0.02f, 0.2f, 0.0f);
+	pid2 o(0.02f, 0.2f, 0.0f);
+	stepResult r = { 0.0f, 0.0f };
+	float w = 0.0f;
+
+	c.setLimits(-1.0f, 1.0f);
+	o.setLimits(1e9f, 0.0f);
+	for (int k = 0; k < 2000; k++) {
+		float u;
+		if (usePid3) {
+			u = c.calculate(200.0f, w, DT);
+		} else {
+			u = fminf(fmaxf(o.calculate(200.0f - w, DT), -1.0f), 1.0f);
+		}
+		w += (100.0f * u - 0.1f * w) * DT;
+		if (w > r.peak) {
+			r.peak = w;
+		}
+	}
+	r.final = w;
+	return r;
+}
+
+int main(void) {
+	float p, i, d;
+
+	// P, I and D terms of a plain output
+	pid3 a(2.0f, 10.0f, 0.0f);
+	CHECK_NEAR(a.calculate(3.0f, 1.0f, DT), 4.0f, 1e-6f);
+	a.getTerms(&p, &i, &d);
+	CHECK(p == 4.0f && i == 0.0f && d == 0.0f);
+	a.calculate(3.0f, 1.0f, DT);
+	a.getTerms(&p, &i, &d);
+	CHECK_NEAR(i, 10.0f * 2.0f * DT, 1e-6f);
+
+	// A setpoint step gives no derivative kick; pid2 differentiates the error
+	pid3 kick(1.0f, 0.0f, 0.5f);
+	pid2 kick2(1.0f, 0.0f, 0.5f);
+	kick.calculate(0.0f, 0.0f, DT);
+	kick.calculate(100.0f, 0.0f, DT);
+	kick.getTerms(&p, &i, &d);
+	kick2.setLimits(100.0f, 0.0f);
+	kick2.calculate(0.0f, DT);
+	float kick2D = kick2.calculate(100.0f, DT) - 100.0f;
+	printf("setpoint step 100: pid3 D %.1f, pid2 D %.1f\n", d, kick2D);
+	CHECK(d == 0.0f && p == 100.0f);
+	CHECK(kick2D > 1000.0f);
+
+	// The derivative of a ramp converges to -kd * slope
+	pid3 ramp(0.0f, 0.0f, 2.0f);
+	float y = 0.0f;
+	for (int k = 0; k < 400; k++) {
+		y += 10.0f * DT;
+		ramp.calculate(0.0f, y, DT);
+	}
+	ramp.getTerms(&p, &i, &d);
+	CHECK_NEAR(d, -20.0f, 0.01f);
+
+	// The derivative filter takes out most of the noise on the measurement
+	pid3 filtered(0.0f, 0.0f, 0.05f), raw(0.0f, 0.0f, 0.05f);
+	double sumF = 0.0, sumR = 0.0;
+	raw.setDerivativeCutoff(0.0f);
+	srand(1);
+	for (int k = 0; k < 4000; k++) {
+		float noise = (rand() / (float)RAND_MAX - 0.5f) * 2.0f;
+		filtered.calculate(0.0f, noise, DT);
+		raw.calculate(0.0f, noise, DT);
+		filtered.getTerms(&p, &i, &d);
+		sumF += d * d;
+		raw.getTerms(&p, &i, &d);
+		sumR += d * d;
+	}
+	printf("noise D RMS: %.0f Hz filter %.2f, none %.2f\n", PID_D_CUTOFF, sqrt(sumF / 4000), sqrt(sumR / 4000));
+	CHECK(sumF * 4.0 < sumR);
+
+	// A saturated step: back-calculation keeps the overshoot small where
+	// pid2's windup overshoots by most of the step
+	stepResult r3 = saturatedStep(true);
+	stepResult r2 = saturatedStep(false);
+	printf("saturated 200 deg/s step: pid3 peak %.1f, pid2 peak %.1f\n", r3.peak, r2.peak);
+	CHECK(r3.peak < 220.0f);
+	CHECK_NEAR(r3.final, 200.0f, 1.0f);
+	CHECK(r2.peak > 300.0f);
+
+	// Saturation downstream, reported with actuated(), stops the integral
+	pid3 stuck(0.0f, 1.0f, 0.0f);
+	stuck.setLimits(-10.0f, 10.0f);
+	for (int k = 0; k < 1000; k++) {
+		stuck.calculate(1.0f, 0.0f, DT);
+		stuck.actuated(0.0f);
+	}
+	stuck.getTerms(&p, &i, &d);
+	CHECK(fabsf(i) < 0.2f);		// 5.0 without the feedback
+
+	// Without an integral gain, saturation leaves no offset behind
+	pid3 prop(1.0f, 0.0f, 0.0f);
+	prop.setLimits(-5.0f, 5.0f);
+	for (int k = 0; k < 1000; k++) {
+		prop.calculate(100.0f, 0.0f, DT);
+		prop.actuated(2.0f);
+	}
+	CHECK(prop.calculate(1.0f, 0.0f, DT) == 1.0f);
+	prop.getTerms(&p, &i, &d);
+	CHECK(i == 0.0f);
+
+	// Setting the integral gain to 0 clears what was integrated
+	a.setGains(2.0f, 0.0f, 0.0f);
+	CHECK(a.calculate(3.0f, 1.0f, DT) == 4.0f);
+
+	// Feed-forward, output limits, reset
+	pid3 ff(0.0f, 0.0f, 0.0f);
+	ff.setFeedForward(0.5f);
+	CHECK(ff.calculate(10.0f, 3.0f, DT) == 5.0f);
+	CHECK(ff.getFeedForward() == 5.0f);
+	ff.setLimits(-2.0f, 3.0f);
+	CHECK(ff.calculate(10.0f, 3.0f, DT) == 3.0f);
+	CHECK(ff.calculate(-10.0f, 3.0f, DT) == -2.0f);
+	a.setGains(2.0f, 10.0f, 1.0f);
+	a.calculate(3.0f, 1.0f, DT);
+	a.reset(5.0f);
+	CHECK(a.calculate(5.0f, 5.0f, DT) == 0.0f);
+	a.getTerms(&p, &i, &d);
+	CHECK(p == 0.0f && i == 0.0f && d == 0.0f);
+
+	return checkDone("test_pid3");
+}
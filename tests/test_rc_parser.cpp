@@ -0,0 +1,107 @@
+/**
+ * @file
+ *
+ * @brief Host test of the streaming remote control packet parser
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+#include "RcParser.h"
+#include "check.h"
+#include <stdlib.h>
+
+/**
+ * @brief Feed bytes, return the number of packets completed
+ */
+static int feedAll(RcParser &p, const uint8_t *b, int n, uint32_t time) {
+	int packets = 0;
+	for (int i = 0; i < n; i++) {
+		if (p.feed(b[i], time)) packets++;
+	}
+	return packets;
+}
+
+int main(void) {
+	RcParser p;
+	RcPacket k;
+
+	// A stick packet, read once
+	const uint8_t sticks[] = {START, 10, 20, 30, 40, STOP};
+	CHECK(feedAll(p, sticks, 6, 5) == 1);
+	CHECK(p.read(&k));
+	CHECK(k.type == RcPacketType::STICKS && k.data[2] == 20 && k.time == 5);
+	CHECK(!p.read(&k));
+
+	// A lost byte drops that packet only; the next START resynchronises
+	const uint8_t lost[] = {START, 10, 20, 40, STOP, START, 1, 2, 3, 4, STOP};
+	CHECK(feedAll(p, lost, sizeof(lost), 6) == 1);
+	CHECK(p.getErrors() == 1);
+	CHECK(p.read(&k) && k.data[1] == 1 && k.data[4] == 4);
+
+	// Commands are TRANSFER_SIZE identical bytes
+	const uint8_t cmd[] = {DEMO_CMD, DEMO_CMD, DEMO_CMD, DEMO_CMD, DEMO_CMD, DEMO_CMD};
+	CHECK(feedAll(p, cmd, 6, 7) == 1);
+	CHECK(p.read(&k) && k.type == RcPacketType::COMMAND && k.data[0] == DEMO_CMD && k.time == 7);
+	CHECK(feedAll(p, cmd, 5, 8) == 0);
+	CHECK(!p.read(&k));
+
+	// Stick packets with identical data never read as commands
+	const uint8_t same[] = {START, 5, 5, 5, 5, STOP};
+	for (int r = 0; r < 3; r++) feedAll(p, same, 6, 9);
+	CHECK(p.read(&k) && k.type == RcPacketType::STICKS);
+
+	// A stray byte between packets loses nothing
+	const uint8_t extra[] = {START, 1, 2, 3, 4, STOP, 77, START, 9, 8, 7, 6, STOP};
+	CHECK(feedAll(p, extra, sizeof(extra), 10) == 2);
+	CHECK(p.getPackets() == 8);
+
+	// Random packets with dropped, corrupted and inserted bytes: whatever is
+	// reported is well formed, and every clean packet gets through
+	RcParser f;
+	uint32_t sent = 0, clean = 0, cleanGot = 0, malformed = 0;
+	srand(3);
+	for (uint32_t i = 0; i < 200000; i++) {
+		uint8_t pk[TRANSFER_SIZE];
+		bool fault = false;
+
+		if (rand() % 20 == 0) {
+			uint8_t c = 1 + rand() % 3;
+			for (int j = 0; j < TRANSFER_SIZE; j++) pk[j] = c;
+		} else {
+			pk[0] = START;
+			for (int j = 1; j < 5; j++) pk[j] = rand() % STOP;
+			pk[5] = STOP;
+		}
+
+		for (int j = 0; j < TRANSFER_SIZE; j++) {
+			int r = rand() % 400;
+			uint8_t b = pk[j];
+
+			if (r == 0) { fault = true; continue; }
+			if (r == 1) { fault = true; b = (uint8_t)rand(); }
+			bool done = f.feed(b, i);
+			if (r == 2) { fault = true; f.feed((uint8_t)rand(), i); }
+
+			if (done && f.read(&k)) {
+				if (k.type == RcPacketType::STICKS) {
+					if (k.data[0] != START || k.data[5] != STOP) malformed++;
+					for (int q = 1; q < 5; q++) if (k.data[q] >= STOP) malformed++;
+				} else {
+					for (int q = 1; q < TRANSFER_SIZE; q++) if (k.data[q] != k.data[0]) malformed++;
+				}
+				if (!fault && k.time == i && k.data[0] == pk[0] && k.data[3] == pk[3]) cleanGot++;
+			}
+		}
+		sent++;
+		if (!fault) clean++;
+	}
+
+	printf("sent %u clean %u clean received %u errors %u\n", sent, clean, cleanGot, f.getErrors());
+	CHECK(malformed == 0);
+	CHECK(cleanGot == clean);
+
+	return checkDone("test_rc_parser");
+}
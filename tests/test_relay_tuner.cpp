@@ -0,0 +1,196 @@
+/**
+ * @file
+ *
+ * @brief Host test of the relay autotuner against a simulated rate axis
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * The axis is a first-order lag with a transport delay, for which the
+ * ultimate gain and period are known in closed form. The tuner runs at the
+ * 200 Hz rate loop, the way fly() runs it.
+ *
+ */
+
+#include "RelayTuner.h"
+#include "pid3.h"
+#include "check.h"
+#include <stdlib.h>
+
+#ifndef PI
+#define PI 3.14159265358979f
+#endif
+
+#define DT			0.005f		///< Rate loop sample time [s]
+#define MAX_DELAY	64			///< Longest transport delay [samples]
+
+/**
+ * @brief Rate axis: rate' = (K * u(t - L) + disturbance - rate) / tau
+ */
+class plant {
+private:
+	float k;				///< Gain [deg/s per unit command]
+	float tau;				///< Lag [s]
+	int delay;				///< Transport delay [samples]
+	float buf[MAX_DELAY];	///< Delayed commands
+	int n;					///< Samples run
+
+public:
+	float rate;				///< [deg/s]
+	float angle;			///< Integrated rate [deg]
+
+	plant(float gain, float lag, int d) : k(gain), tau(lag), delay(d), n(0), rate(0.0f), angle(0.0f) {
+		for (int i = 0; i < MAX_DELAY; i++) {
+			buf[i] = 0.0f;
+		}
+	}
+
+	float step(float u, float disturbance) {
+		buf[n % MAX_DELAY] = u;
+		float ud = buf[(n - delay + MAX_DELAY) % MAX_DELAY];
+		n++;
+		rate += (k * ud + disturbance - rate) / tau * DT;
+		angle += rate * DT;
+		return rate;
+	}
+};
+
+/**
+ * @brief Ku and Tu of a plant, where the phase reaches -180 degrees
+ */
+static void ultimate(float k, float tau, float delay, float *ku, float *tu) {
+	float lo = 0.0f, hi = PI / delay;
+
+	for (int i = 0; i < 100; i++) {
+		float w = (lo + hi) / 2.0f;
+		if (atanf(w * tau) + w * delay < PI) {
+			lo = w;
+		} else {
+			hi = w;
+		}
+	}
+	*ku = sqrtf(1.0f + lo * tau * lo * tau) / k;
+	*tu = 2.0f * PI / lo;
+}
+
+/**
+ * @brief Run an experiment holding the rate at 0
+ * @param t           Tuner, limits set
+ * @param p           Plant
+ * @param h           Relay hysteresis [deg/s]
+ * @param noise       Gyro noise, peak [deg/s]
+ * @param disturbance Constant disturbance [deg/s]
+ * @return Time the experiment ran [s]
+ */
+static float runTune(RelayTuner &t, plant &p, float h, float noise, float disturbance) {
+	float y = 0.0f;
+	int n = 0;
+
+	t.start(0.5f, h, 0.0f);
+	while (t.getState() == TunerState::RUNNING && n < 10000) {
+		float measured = y + noise * ((rand() / (float)RAND_MAX) * 2.0f - 1.0f);
+		float u = t.update(0.0f - measured, p.angle, DT);
+		y = p.step(u, disturbance);
+		n++;
+	}
+
+	return n * DT;
+}
+
+int main(void) {
+	srand(3);
+
+	// Ku and Tu within 25% of theory on plants with dead time and gyro
+	// noise, and the Ziegler-Nichols gains from them close the loop
+	const struct { float k, tau; int delay; } axes[] = {
+		{ 100.0f, 0.05f, 4 }, { 300.0f, 0.03f, 2 }, { 50.0f, 0.1f, 6 }
+	};
+	for (auto &a : axes) {
+		float kuT, tuT, kp, ki, kd;
+		ultimate(a.k, a.tau, (a.delay + 0.5f) * DT, &kuT, &tuT);
+
+		RelayTuner t;
+		plant p(a.k, a.tau, a.delay);
+		t.setLimits(90.0f, 10.0f, 1000.0f);
+		float seconds = runTune(t, p, 1.0f, 0.3f, 0.0f);
+		CHECK(t.getGains(TuneRule::ZIEGLER_NICHOLS, &kp, &ki, &kd));
+		printf("K %3.0f tau %.2f L %.3f: Ku %.4f (%.4f) Tu %.3f (%.3f) in %.2f s\n", a.k, a.tau, a.delay * DT,
+				t.getUltimateGain(), kuT, t.getUltimatePeriod(), tuT, seconds);
+		CHECK(t.getState() == TunerState::DONE && t.getAbort() == TunerAbort::NONE);
+		CHECK_NEAR(t.getUltimateGain() / kuT, 1.0f, 0.25f);
+		CHECK_NEAR(t.getUltimatePeriod() / tuT, 1.0f, 0.25f);
+
+		pid3 c(kp, ki, kd);
+		plant q(a.k, a.tau, a.delay);
+		float y = 0.0f;
+		c.setLimits(-5.0f, 5.0f);
+		for (int k = 0; k < 2000; k++) {
+			y = q.step(c.calculate(100.0f, y, DT), 0.0f);
+		}
+		CHECK_NEAR(y, 100.0f, 1.0f);
+	}
+
+	// Rules: the formulas, and the overshoot rules are gentler
+	RelayTuner t;
+	plant p(100.0f, 0.05f, 4);
+	float g[(uint8_t)TuneRule::NUM_RULES][3];
+	t.setLimits(90.0f, 10.0f, 1000.0f);
+	runTune(t, p, 2.0f, 0.0f, 0.0f);
+	for (uint8_t r = 0; r < (uint8_t)TuneRule::NUM_RULES; r++) {
+		CHECK(t.getGains((TuneRule)r, &g[r][0], &g[r][1], &g[r][2]));
+	}
+	CHECK_NEAR(g[0][0], 0.6f * t.getUltimateGain(), 1e-6f);
+	CHECK_NEAR(g[0][1], g[0][0] / (0.5f * t.getUltimatePeriod()), 1e-4f);
+	CHECK(g[4][0] < g[3][0] && g[3][0] < g[0][0] && g[0][0] < g[2][0]);
+	CHECK(!t.getGains(TuneRule::NUM_RULES, &g[0][0], &g[0][1], &g[0][2]));
+
+	// A disturbance the relay can't overcome: the angle runs off and aborts
+	// at the limit (give or take the sample the plant runs on after it)
+	plant drift(100.0f, 0.05f, 4);
+	t.setLimits(1.0f, 10.0f, 1000.0f);
+	runTune(t, drift, 2.0f, 0.0f, 80.0f);
+	CHECK(t.getState() == TunerState::ABORTED && t.getAbort() == TunerAbort::ANGLE);
+	CHECK(fabsf(drift.angle) < 1.5f);
+
+	// Yaw, passing the integrated rate as the angle: the same runaway stops
+	// at the heading limit, or sooner at the rate error limit
+	plant yaw(100.0f, 0.05f, 4);
+	t.setLimits(45.0f, 10.0f, 1000.0f);
+	runTune(t, yaw, 2.0f, 0.0f, 80.0f);
+	printf("yaw runaway: abort %d at heading %.1f deg, rate %.1f deg/s\n", (int)t.getAbort(), yaw.angle, yaw.rate);
+	CHECK(t.getAbort() == TunerAbort::ANGLE);
+	CHECK(fabsf(yaw.angle) < 46.0f);
+
+	plant spin(100.0f, 0.05f, 4);
+	t.setLimits(45.0f, 10.0f, 20.0f);
+	runTune(t, spin, 2.0f, 0.0f, 80.0f);
+	printf("yaw runaway: abort %d at heading %.1f deg, rate %.1f deg/s\n", (int)t.getAbort(), spin.angle, spin.rate);
+	CHECK(t.getAbort() == TunerAbort::ERROR);
+	CHECK(fabsf(spin.angle) < 5.0f);
+
+	// A normal oscillation stays inside both limits
+	plant steady(100.0f, 0.05f, 4);
+	t.setLimits(45.0f, 10.0f, 150.0f);
+	runTune(t, steady, 2.0f, 0.3f, 20.0f);
+	CHECK(t.getState() == TunerState::DONE);
+
+	// No oscillation (too weak to beat the hysteresis) times out
+	plant weak(1.0f, 0.05f, 4);
+	t.setLimits(90.0f, 10.0f, 1000.0f);
+	runTune(t, weak, 2.0f, 0.0f, 0.0f);
+	CHECK(t.getState() == TunerState::ABORTED && t.getAbort() == TunerAbort::TIMED_OUT);
+
+	// The output is the trim plus or minus the amplitude; after stop() just
+	// the trim
+	RelayTuner s;
+	CHECK(s.getState() == TunerState::IDLE);
+	s.start(0.3f, 1.0f, 0.1f);
+	CHECK_NEAR(s.update(5.0f, 0.0f, DT), 0.4f, 1e-6f);
+	CHECK_NEAR(s.update(-5.0f, 0.0f, DT), -0.2f, 1e-6f);
+	s.stop();
+	CHECK(s.getState() == TunerState::ABORTED && s.getAbort() == TunerAbort::STOPPED);
+	CHECK(s.update(5.0f, 0.0f, DT) == 0.1f);
+
+	return checkDone("test_relay_tuner");
+}
@@ -0,0 +1,73 @@
+/**
+ * @file
+ *
+ * @brief Host test of the sensor pre-filter registry and selection
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+#include "sensorFilter.h"
+#include "check.h"
+
+/**
+ * @brief Counter that advances by one per call, for filterSweep()
+ */
+static uint32_t tickClock(void) {
+	static uint32_t t = 0;
+	return t++;
+}
+
+int main(void) {
+	// Registry indices are stored as GYRO_FILTER/ACC_FILTER, so they must match
+	for (uint8_t i = 0; i < FILTER_NUM_DESIGNS; i++) {
+		CHECK((uint8_t)filterRegistry[i].design == i);
+		CHECK(filterDesignFromIndex(i, filterDesign::NONE) == filterRegistry[i].design);
+		CHECK(filterDesignName(filterRegistry[i].design) == filterRegistry[i].name);
+	}
+	CHECK(filterDesignFromIndex(FILTER_NUM_DESIGNS, filterDesign::LPF2) == filterDesign::LPF2);
+	CHECK(filterDesignFromIndex(255, filterDesign::IIR_GYRO) == filterDesign::IIR_GYRO);
+
+	// Each design builds what was asked for; NONE passes samples through
+	for (uint8_t i = 0; i < FILTER_NUM_DESIGNS; i++) {
+		sensorFilter f(filterRegistry[i].design, PREFILTER_TAU);
+		CHECK(f.getDesign() == filterRegistry[i].design);
+	}
+	sensorFilter none(filterDesign::NONE, PREFILTER_TAU);
+	CHECK(none.filterSample(1.25f) == 1.25f);
+	CHECK(none.filterSample(-3.0f) == -3.0f);
+
+	// The low-pass designs settle to a constant input
+	const filterDesign lowPass[] = {
+		filterDesign::LPF1, filterDesign::LPF2, filterDesign::IIR_ACC,
+		filterDesign::IIR_GYRO, filterDesign::FIR
+	};
+	for (uint8_t i = 0; i < sizeof(lowPass) / sizeof(lowPass[0]); i++) {
+		sensorFilter f(lowPass[i], 5.0f);
+		float y = 0.0f;
+		for (int k = 0; k < 3000; k++) {
+			y = f.filterSample(2.0f);
+		}
+		printf("%-10s DC out %.4f\n", filterDesignName(lowPass[i]), y);
+		CHECK_NEAR(y, 2.0f, 0.05f);
+	}
+
+	// The sweep covers every design and times each sample with the clock
+	static float x[100];
+	filterSweepResult r[FILTER_NUM_DESIGNS];
+	for (int k = 0; k < 100; k++) {
+		x[k] = (k % 2) ? 1.0f : -1.0f;
+	}
+	CHECK(filterSweep(x, 100, PREFILTER_TAU, tickClock, r) == FILTER_NUM_DESIGNS);
+	for (uint8_t i = 0; i < FILTER_NUM_DESIGNS; i++) {
+		CHECK(r[i].design == filterRegistry[i].design);
+		CHECK(r[i].cycles == 100);
+	}
+	CHECK_NEAR(r[(int)filterDesign::NONE].rms, 1.0f, 1e-6f);
+	CHECK_NEAR(r[(int)filterDesign::NONE].rmsDiff, 0.0f, 1e-6f);
+	CHECK(r[(int)filterDesign::LPF2].rms < 0.5f);
+
+	return checkDone("test_sensor_filter");
+}
@@ -0,0 +1,177 @@
+/**
+ * @file
+ *
+ * @brief Host test of the COBS/CRC framing and the telemetry frames
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * Telemetry::send() is linked against a stand-in for the UART TX queue that
+ * keeps the committed bytes.
+ *
+ */
+
+#include "Telemetry.h"
+#include "Framing.h"
+#include "uart.h"
+#include "check.h"
+#include <string.h>
+
+static uint8_t txBuff[4096];	///< Bytes committed to the stand-in TX queue
+static uint16_t txLen = 0;		///< Bytes in txBuff
+static bool txFull = false;		///< Make usart_tx_reserve() fail
+
+uint8_t* usart_tx_reserve(uint16_t len) {
+	if (txFull || txLen + len > sizeof(txBuff)) return NULL;
+	return &txBuff[txLen];
+}
+
+void usart_tx_commit(uint16_t len) {
+	txLen += len;
+}
+
+/**
+ * @brief COBS encode and decode, return true if the round trip is exact
+ */
+static bool cobsRoundTrip(const uint8_t *in, uint16_t len) {
+	uint8_t enc[600], dec[600];
+	uint16_t n = cobsEncode(in, len, enc);
+
+	if (n > len + len/254 + 1) return false;
+	for (uint16_t i = 0; i < n; i++) {
+		if (enc[i] == 0) return false;
+	}
+
+	return cobsDecode(enc, n, dec) == len && memcmp(in, dec, len) == 0;
+}
+
+/**
+ * @brief Feed a buffer to a decoder, return the number of good frames
+ */
+static int feedAll(TelemetryDecoder &d, const uint8_t *b, uint16_t n) {
+	int frames = 0;
+	for (uint16_t i = 0; i < n; i++) {
+		if (d.feed(b[i])) frames++;
+	}
+	return frames;
+}
+
+int main(void) {
+	// CRC-16/CCITT-FALSE check value
+	const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+	CHECK(crc16Ccitt(check, 9) == 0x29B1);
+	CHECK(crc16Ccitt(check, 0) == 0xFFFF);
+
+	// COBS reference encodings
+	const uint8_t z1[] = {0x00};
+	const uint8_t z2[] = {0x11, 0x22, 0x00, 0x33};
+	uint8_t enc[600];
+	CHECK(cobsEncode(z1, 1, enc) == 2 && enc[0] == 0x01 && enc[1] == 0x01);
+	CHECK(cobsEncode(z2, 4, enc) == 5 && enc[0] == 0x03 && enc[3] == 0x02 && enc[4] == 0x33);
+
+	// Round trips: zeros, runs around the 254 byte block, mixed data
+	uint8_t in[520];
+	memset(in, 0, sizeof(in));
+	CHECK(cobsRoundTrip(in, 0));
+	CHECK(cobsRoundTrip(in, 5));
+	for (uint16_t i = 0; i < sizeof(in); i++) in[i] = (uint8_t)(i % 255 + 1);
+	CHECK(cobsRoundTrip(in, 253));
+	CHECK(cobsRoundTrip(in, 254));
+	CHECK(cobsRoundTrip(in, 255));
+	CHECK(cobsRoundTrip(in, 520));
+	for (uint16_t i = 0; i < sizeof(in); i++) in[i] = (uint8_t)(i * 37);
+	CHECK(cobsRoundTrip(in, 520));
+
+	// Malformed input is rejected
+	const uint8_t bad1[] = {0x05, 0x11};
+	const uint8_t bad2[] = {0x02, 0x11, 0x00};
+	uint8_t dec[16];
+	CHECK(cobsDecode(bad1, 2, dec) == 0);
+	CHECK(cobsDecode(bad2, 3, dec) == 0);
+
+	// Fixed-point fields round and saturate
+	CHECK(telemetryFixed(1.234f, 100.0f) == 123);
+	CHECK(telemetryFixed(-1.235f, 100.0f) == -124);
+	CHECK(telemetryFixed(1e6f, 1.0f) == 32767);
+	CHECK(telemetryFixed(-1e6f, 1.0f) == -32768);
+
+	// Frame round trip through the decoder
+	TelemetryFrame f(TelemetryId::FLIGHT, 7);
+	f.putU8(0xA5);
+	f.putU16(0x1234);
+	f.putS16(-2);
+	f.putU32(0xDEADBEEF);
+	f.putFixed(12.5f, TELEM_ANGLE_SCALE);
+	CHECK(!f.overflowed());
+	uint16_t n = f.encode(enc);
+	CHECK(n == TELEM_FRAME_BYTES(11));
+	CHECK(enc[n - 1] == 0);
+
+	TelemetryDecoder d;
+	CHECK(feedAll(d, enc, n) == 1);
+	CHECK(d.getId() == TelemetryId::FLIGHT);
+	CHECK(d.getSeq() == 7);
+	CHECK(d.getLength() == 11);
+	const uint8_t *p = d.getPayload();
+	CHECK(p[0] == 0xA5);
+	CHECK(telemetryGetU16(&p[1]) == 0x1234);
+	CHECK(telemetryGetS16(&p[3]) == -2);
+	CHECK(telemetryGetU16(&p[5]) == 0xBEEF && telemetryGetU16(&p[7]) == 0xDEAD);
+	CHECK(telemetryGetS16(&p[9]) == 1250);
+	CHECK(d.getCrcErrors() == 0 && d.getLost() == 0);
+
+	// Payload overflow is flagged, the fields that fit are kept
+	TelemetryFrame big(TelemetryId::TRACE, 0);
+	for (int i = 0; i < TELEM_MAX_PAYLOAD / 4; i++) big.putU32(0x01020304);
+	CHECK(!big.overflowed());
+	big.putU8(1);
+	CHECK(big.overflowed());
+	n = big.encode(enc);
+	CHECK(n <= TELEM_MAX_FRAME);
+	CHECK(feedAll(d, enc, n) == 1 && d.getLength() == TELEM_MAX_PAYLOAD);
+
+	// A corrupted byte fails the CRC; the next frame still decodes, and the
+	// sequence gap counts as lost frames
+	TelemetryDecoder e;
+	TelemetryFrame a(TelemetryId::LINK, 1);
+	a.putU16(100);
+	n = a.encode(enc);
+	enc[2] ^= 0x40;
+	CHECK(feedAll(e, enc, n) == 0);
+	CHECK(e.getCrcErrors() == 1);
+	TelemetryFrame b(TelemetryId::LINK, 2);
+	b.putU16(101);
+	n = b.encode(enc);
+	CHECK(feedAll(e, enc, n) == 1);
+	TelemetryFrame c(TelemetryId::LINK, 5);
+	c.putU16(102);
+	n = c.encode(enc);
+	CHECK(feedAll(e, enc, n) == 1);
+	CHECK(e.getLost() == 2);
+
+	// Noise longer than a frame is skipped up to the next delimiter
+	uint8_t noise[TELEM_MAX_FRAME + 10];
+	memset(noise, 0x55, sizeof(noise));
+	CHECK(feedAll(e, noise, sizeof(noise)) == 0);
+	CHECK(e.feed(0) == false);
+	CHECK(feedAll(e, enc, n) == 1);
+
+	// send() commits one encoded frame, or counts a drop on a full queue
+	Telemetry *t = Telemetry::Instance();
+	uint8_t s0 = t->nextSeq();
+	CHECK(t->nextSeq() == (uint8_t)(s0 + 1));
+	TelemetryFrame g(TelemetryId::BATTERY, t->nextSeq());
+	g.putFixed(11.1f, TELEM_VOLT_SCALE);
+	CHECK(t->send(g));
+	CHECK(txLen == TELEM_FRAME_BYTES(2));
+	TelemetryDecoder r;
+	CHECK(feedAll(r, txBuff, txLen) == 1);
+	CHECK(r.getId() == TelemetryId::BATTERY);
+	CHECK(telemetryGetS16(r.getPayload()) == 11100);
+	txFull = true;
+	CHECK(!t->send(g));
+	CHECK(t->getDropped() == 1);
+
+	return checkDone("test_telemetry");
+}
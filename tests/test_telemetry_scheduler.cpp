@@ -0,0 +1,210 @@
+/**
+ * @file
+ *
+ * @brief Host test of the telemetry scheduler against a simulated link
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * The link drains a fixed number of bytes per second. Frames handed out by
+ * the scheduler, and optionally other traffic, queue up in front of it the
+ * way they do in the UART TX queue.
+ *
+ */
+
+#include "TelemetryScheduler.h"
+#include "config.h"
+#include "check.h"
+
+// The flight channels of DeathChopper9000.cpp, CONTROL sized for an octo
+static const TelemetryChannel channels[] = {
+	{ TelemetryId::ATTITUDE,	0,	TELEM_RATE_ATTITUDE,	TELEM_FRAME_BYTES(12) },
+	{ TelemetryId::CONTROL,		1,	TELEM_RATE_CONTROL,		TELEM_FRAME_BYTES(25 + 2 * 8) },
+	{ TelemetryId::ALTITUDE,	2,	TELEM_RATE_ALTITUDE,	TELEM_FRAME_BYTES(2) },
+	{ TelemetryId::BATTERY,		3,	TELEM_RATE_BATTERY,		TELEM_FRAME_BYTES(6) },
+	{ TelemetryId::TIMING,		4,	TELEM_RATE_TIMING,		TELEM_FRAME_BYTES(6) },
+	{ TelemetryId::ERRORS,		5,	TELEM_RATE_ERRORS,		TELEM_FRAME_BYTES(29) },
+	{ TelemetryId::I2C_BUS,		6,	TELEM_RATE_I2C,			TELEM_FRAME_BYTES(34) }
+};
+#define NUM_CHANNELS	(sizeof(channels) / sizeof(channels[0]))
+
+#define LINK_57600		5236.0f		///< 57600 baud, 8N1, less a little margin [bytes/s]
+#define LATENCY			TELEM_LATENCY	///< [s]
+#define LOOP_DT			0.01f		///< Outer loop period [s]
+#define SECONDS			60.0f		///< Simulated time
+
+/**
+ * @brief Outcome of one simulated run
+ */
+typedef struct {
+	float rate[NUM_CHANNELS];	///< Achieved rate per channel [Hz]
+	float maxBacklog;			///< Most bytes queued just after a loop
+	float throughput;			///< Telemetry bytes per second
+} linkResult;
+
+/**
+ * @brief Run the scheduler over a link
+ * @param s        Scheduler, channels added
+ * @param linkBps  Link capacity [bytes/s]
+ * @param otherBps Other traffic on the link, in 40 byte frames [bytes/s]
+ */
+static linkResult runLink(TelemetryScheduler &s, float linkBps, float otherBps) {
+	linkResult r;
+	float backlog = 0.0f, other = 0.0f, sentBytes = 0.0f;
+	int loops = (int)(SECONDS / LOOP_DT);
+	uint32_t before[NUM_CHANNELS];
+
+	for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+		before[i] = s.getSent(i);
+	}
+	r.maxBacklog = 0.0f;
+
+	for (int k = 0; k < loops; k++) {
+		backlog -= linkBps * LOOP_DT;
+		if (backlog < 0.0f) {
+			backlog = 0.0f;
+		}
+		for (other += otherBps * LOOP_DT; other >= 40.0f; other -= 40.0f) {
+			backlog += 40.0f;
+		}
+
+		s.tick(LOOP_DT, (uint16_t)backlog);
+		int8_t ch;
+		while ((ch = s.next()) >= 0) {
+			backlog += channels[ch].size;
+			sentBytes += channels[ch].size;
+			s.sent(ch);
+		}
+		if (backlog > r.maxBacklog) {
+			r.maxBacklog = backlog;
+		}
+	}
+
+	for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+		r.rate[i] = (s.getSent(i) - before[i]) / SECONDS;
+	}
+	r.throughput = sentBytes / SECONDS;
+	return r;
+}
+
+/**
+ * @brief Print one run
+ */
+static void printRun(const char *name, const linkResult &r) {
+	printf("%-24s", name);
+	for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+		printf(" %5.1f/%-3.0f", r.rate[i], channels[i].rate);
+	}
+	printf(" | %4.0f B/s, backlog %3.0f\n", r.throughput, r.maxBacklog);
+}
+
+/**
+ * @brief Create a scheduler with every channel added
+ */
+static TelemetryScheduler *makeScheduler(void) {
+	TelemetryScheduler *s = new TelemetryScheduler(LINK_57600, LATENCY);
+
+	for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+		if (s->add(channels[i]) != (int8_t)i) {
+			return NULL;
+		}
+	}
+	return s;
+}
+
+int main(void) {
+	// Adding channels
+	TelemetryScheduler small(1000.0f, 0.02f);
+	TelemetryChannel big = { TelemetryId::ERRORS, 0, 1.0f, 21 };
+	CHECK(small.getWindow() == 20);
+	CHECK(small.add(big) == -1);		// Can never fit the window
+	big.size = 20;
+	for (int i = 0; i < TELEM_MAX_CHANNELS; i++) {
+		CHECK(small.add(big) == i);
+	}
+	CHECK(small.add(big) == -1);
+	CHECK(small.getSent(TELEM_MAX_CHANNELS) == 0);
+
+	// New channels are due at once, handed out by priority within the window
+	TelemetryScheduler *s = makeScheduler();
+	CHECK(s != NULL);
+	s->tick(0.0f, 0);
+	CHECK(s->next() == 0);
+	CHECK(s->getId(0) == TelemetryId::ATTITUDE);
+	s->sent(0);
+	CHECK(s->next() == 1);
+	s->sent(1);
+	CHECK(s->next() == 2);
+	s->sent(2);
+	CHECK(s->next() == 3);
+	s->sent(3);
+	CHECK(s->next() == 4);
+	s->sent(4);
+	CHECK(s->next() == 5);
+	s->sent(5);
+	CHECK(s->next() == -1);			// I2C_BUS no longer fits what is left
+	s->tick(0.0f, s->getWindow());
+	CHECK(s->next() == -1);			// Full link, nothing at all
+	delete s;
+
+	// A fast, idle link: every channel gets its rate and the queue stays
+	// within the latency window
+	s = makeScheduler();
+	linkResult r = runLink(*s, LINK_57600, 0.0f);
+	printRun("57600 idle", r);
+	for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+		CHECK_NEAR(r.rate[i], channels[i].rate, 0.02f * channels[i].rate + 0.05f);
+	}
+	CHECK(r.maxBacklog <= s->getWindow());
+	CHECK(s->getSkippedTotal() == 0);
+	delete s;
+
+	// Other traffic on the link is measured through the backlog and comes
+	// off the telemetry, least important first
+	s = makeScheduler();
+	r = runLink(*s, LINK_57600, 4000.0f);
+	printRun("57600 + 4000 B/s other", r);
+	CHECK_NEAR(r.rate[0], channels[0].rate, 0.05f * channels[0].rate);
+	CHECK(r.rate[1] < channels[1].rate);
+	CHECK(r.throughput < LINK_57600 - 4000.0f + 50.0f);
+	CHECK(r.maxBacklog <= s->getWindow() + 40.0f);
+	delete s;
+
+	// Poor links: priority decides, but starvation keeps every channel
+	// trickling through at 1/(TELEM_STARVE_SKIPS + 1) of its rate or better,
+	// while the link can carry that much (about 400 B/s here)
+	const float slow[] = { 2000.0f, 1000.0f, 300.0f };
+	for (float link : slow) {
+		s = makeScheduler();
+		r = runLink(*s, link, 0.0f);
+		char name[32];
+		snprintf(name, sizeof(name), "%.0f B/s", link);
+		printRun(name, r);
+		for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+			if (link >= 1000.0f) {
+				CHECK(r.rate[i] >= 0.9f * channels[i].rate / (TELEM_STARVE_SKIPS + 1));
+			}
+			CHECK(r.rate[i] <= channels[i].rate + 1.0f / SECONDS);
+			CHECK_NEAR(s->getSent(i) + s->getSkipped(i), channels[i].rate * SECONDS, 2.0f);
+		}
+		CHECK(r.rate[0] / channels[0].rate >= r.rate[NUM_CHANNELS - 1] / channels[NUM_CHANNELS - 1].rate);
+		// Whatever is still queued at the end counts as sent
+		CHECK(r.throughput <= link + s->getWindow() / SECONDS);
+		CHECK(r.throughput >= 0.9f * link);
+		CHECK(r.maxBacklog <= s->getWindow());
+		delete s;
+	}
+
+	// A channel set to rate 0 stops; the others carry on
+	s = makeScheduler();
+	runLink(*s, LINK_57600, 0.0f);
+	s->setRate(1, 0.0f);
+	s->setRate(NUM_CHANNELS, 5.0f);		// No such channel, ignored
+	r = runLink(*s, LINK_57600, 0.0f);
+	CHECK(r.rate[1] <= 1.0f / SECONDS);
+	CHECK_NEAR(r.rate[0], channels[0].rate, 0.02f * channels[0].rate);
+	delete s;
+
+	return checkDone("test_telemetry_scheduler");
+}
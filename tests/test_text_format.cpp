@@ -0,0 +1,183 @@
+/**
+ * @file
+ *
+ * @brief Host test of the number formatter against the C library's snprintf
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * textFormat() is meant to match printf for everything it supports, so each
+ * case is checked against the host's snprintf with the same arguments.
+ *
+ */
+
+#include "TextFormat.h"
+#include "check.h"
+#include <string.h>
+
+static int mismatches = 0;		///< Mismatches printed so far
+
+/**
+ * @brief Compare two strings, print the first few differences
+ */
+static bool same(const char *got, const char *want, const char *what) {
+	if (strcmp(got, want) == 0) {
+		return true;
+	}
+	if (mismatches++ < 20) {
+		printf("%s: got '%s', expected '%s'\n", what, got, want);
+	}
+	return false;
+}
+
+/**
+ * @brief xorshift32, for reproducible float bit patterns
+ */
+static uint32_t randomBits(void) {
+	static uint32_t x = 12345;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return x;
+}
+
+int main(void) {
+	char a[64], b[64], t[FMT_FLOAT_MAX + 1];
+	bool ok;
+
+	// fmtFloat() on random bit patterns, every number of decimals
+	ok = true;
+	for (long i = 0; i < 300000; i++) {
+		uint32_t bits = randomBits();
+		float v;
+		memcpy(&v, &bits, sizeof(v));
+		if (isnan(v) || fabsf(v) >= 1.8446744e19f) {
+			continue;
+		}
+		int d = i % (FMT_MAX_DECIMALS + 1);
+		t[fmtFloat(t, v, d)] = 0;
+		snprintf(b, sizeof(b), "%.*f", d, v);
+		ok &= same(t, b, "fmtFloat random");
+	}
+	CHECK(ok);
+
+	// Rounding ties, tiny and large magnitudes, infinities
+	const float specials[] = {
+		0.0f, -0.0f, 0.5f, 1.5f, 2.5f, -2.5f, 0.125f, 0.375f, 1e-7f, 9.9999999f, 99.5f,
+		0.05f, 1.0e-45f, 123456.789f, 4294967295.0f, 4294967296.0f, 1e18f, 0.999999f,
+		0.9999995f, INFINITY, -INFINITY
+	};
+	ok = true;
+	for (float v : specials) {
+		for (int d = 0; d <= FMT_MAX_DECIMALS; d++) {
+			t[fmtFloat(t, v, d)] = 0;
+			snprintf(b, sizeof(b), "%.*f", d, v);
+			ok &= same(t, b, "fmtFloat special");
+		}
+	}
+	for (int i = -1000; i <= 1000; i++) {
+		for (int d = 0; d <= 4; d++) {
+			t[fmtFloat(t, i / 8.0f, d)] = 0;
+			snprintf(b, sizeof(b), "%.*f", d, i / 8.0f);
+			ok &= same(t, b, "fmtFloat eighths");
+		}
+	}
+	CHECK(ok);
+	t[fmtFloat(t, 1e20f, 2)] = 0;
+	CHECK(strcmp(t, "ovf") == 0);
+
+	// Integer conversions
+	const int32_t ints[] = { 0, 1, -1, 9, 10, -10, 42, 2147483647, (int32_t)0x80000000, 12345, -98765 };
+	ok = true;
+	for (int32_t v : ints) {
+		t[fmtInt(t, v)] = 0;
+		snprintf(b, sizeof(b), "%d", (int)v);
+		ok &= same(t, b, "fmtInt");
+		t[fmtUint(t, (uint32_t)v)] = 0;
+		snprintf(b, sizeof(b), "%u", (unsigned)v);
+		ok &= same(t, b, "fmtUint");
+		t[fmtHex(t, (uint32_t)v, false)] = 0;
+		snprintf(b, sizeof(b), "%x", (unsigned)v);
+		ok &= same(t, b, "fmtHex");
+	}
+	CHECK(ok);
+
+	// Integer formats: flags, width and precision
+	const char *intFormats[] = {
+		"%d", "%5d", "%-5d|", "%05d", "%+d", "% d", "%+05d", "%i", "%u", "%x", "%X",
+		"%08X", "%-8x|", "%3d%%", "%.3d", "%.0d|", "%.1d", "%8.3d|", "%-8.3d|", "%08.3d|",
+		"%+.3d", "% .4i", "%.5u", "%010.4u|", "%.4x", "%.0x|", "%06.2X|", "%.12d"
+	};
+	ok = true;
+	for (const char *f : intFormats) {
+		for (int32_t v : ints) {
+			textFormat(a, sizeof(a), f, (int)v);
+			snprintf(b, sizeof(b), f, (int)v);
+			ok &= same(a, b, f);
+		}
+	}
+	CHECK(ok);
+
+	// The cases the precision was added for
+	textFormat(a, sizeof(a), "%.3d %.3d %.3d", 0, -1, 42);
+	CHECK(strcmp(a, "000 -001 042") == 0);
+	textFormat(a, sizeof(a), "[%05.3d] [%.0d]", 7, 0);
+	CHECK(strcmp(a, "[  007] []") == 0);
+	textFormat(a, sizeof(a), "%.*d", -1, 5);
+	CHECK(strcmp(a, "5") == 0);
+
+	// Long arguments
+	textFormat(a, sizeof(a), "%ld %lu %.4ld", -5L, 7UL, 3L);
+	snprintf(b, sizeof(b), "%ld %lu %.4ld", -5L, 7UL, 3L);
+	CHECK(same(a, b, "long"));
+
+	// Float formats
+	const char *floatFormats[] = {
+		"%f", "%.3f", "%10.2f", "%-10.2f|", "%010.3f", "%+f", "% .1f", "%.0f", "%F",
+		"%8.3F", "%+08.2f", "%.9f"
+	};
+	const float floats[] = { 0.0f, -0.0f, 3.14159265f, -2.5f, 1234.5678f, -0.001f, 1e10f, INFINITY, -INFINITY, NAN };
+	ok = true;
+	for (const char *f : floatFormats) {
+		for (float v : floats) {
+			textFormat(a, sizeof(a), f, v);
+			snprintf(b, sizeof(b), f, v);
+			ok &= same(a, b, f);
+		}
+	}
+	CHECK(ok);
+
+	// Strings, characters, stars
+	const char *stringFormats[] = { "%s", "%10s|", "%-10s|", "%.3s", "%8.2s|" };
+	ok = true;
+	for (const char *f : stringFormats) {
+		textFormat(a, sizeof(a), f, "hello");
+		snprintf(b, sizeof(b), f, "hello");
+		ok &= same(a, b, f);
+	}
+	textFormat(a, sizeof(a), "x%cy %3c|", 'A', 'B');
+	snprintf(b, sizeof(b), "x%cy %3c|", 'A', 'B');
+	ok &= same(a, b, "%c");
+	textFormat(a, sizeof(a), "%*d|%-*d|%.*f|%*.*d", 6, 42, 4, 7, 2, 1.005f, 6, 3, 9);
+	snprintf(b, sizeof(b), "%*d|%-*d|%.*f|%*.*d", 6, 42, 4, 7, 2, 1.005f, 6, 3, 9);
+	ok &= same(a, b, "star");
+	CHECK(ok);
+
+	// Unknown conversions are copied through
+	textFormat(a, sizeof(a), "a %q b %");
+	CHECK(strcmp(a, "a %q b %") == 0);
+
+	// Output cut short like snprintf: terminated, full length returned
+	ok = true;
+	for (uint16_t size = 0; size < 20; size++) {
+		memset(a, 'Z', sizeof(a));
+		memset(b, 'Z', sizeof(b));
+		int la = textFormat(a, size, "%s %d %.2f", "abc", -1234, 5.678f);
+		int lb = snprintf(b, size, "%s %d %.2f", "abc", -1234, 5.678f);
+		ok &= la == lb && memcmp(a, b, sizeof(a)) == 0;
+	}
+	CHECK(ok);
+
+	return checkDone("test_text_format");
+}
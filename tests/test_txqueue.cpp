@@ -0,0 +1,164 @@
+/**
+ * @file
+ *
+ * @brief Host test of the UART TX frame queue
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ * A simulated DMA drains the queue a few bytes per tick, the way
+ * HAL_UART_TxCpltCallback() does on the target, while frames are pushed and
+ * built in place. Everything accepted must come out once, in order.
+ *
+ */
+
+#include "TxQueue.h"
+#include "check.h"
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+static TxQueue q;
+static bool busy = false;			///< A transfer is in flight
+static const uint8_t *xferData;		///< Transfer in flight
+static uint16_t xferLen, xferPos;
+static uint32_t transfers = 0;
+static std::vector<uint8_t> sent;	///< Bytes on the wire
+
+/**
+ * @brief Start the next transfer, as usart_tx_kick()
+ */
+static void kick(void) {
+	if (busy) return;
+
+	const uint8_t *p = q.take(&xferLen);
+	if (p == NULL) return;
+
+	busy = true;
+	xferData = p;
+	xferPos = 0;
+	transfers++;
+}
+
+/**
+ * @brief Send up to n bytes, release and chain on completion
+ */
+static void dmaTick(uint16_t n) {
+	if (!busy) return;
+
+	for (uint16_t i = 0; i < n && xferPos < xferLen; i++) {
+		sent.push_back(xferData[xferPos++]);
+	}
+	if (xferPos == xferLen) {
+		q.release();
+		busy = false;
+		kick();
+	}
+}
+
+int main(void) {
+	uint8_t frame[UART_TX_RING_SIZE];
+
+	// Empty queue
+	uint16_t n = 0;
+	CHECK(q.empty());
+	CHECK(q.pending() == 0);
+	CHECK(q.take(&n) == NULL);
+
+	// Back to back frames merge into one transfer
+	const uint8_t a[] = "abc", b[] = "defg";
+	CHECK(q.push(a, 3));
+	CHECK(q.push(b, 4));
+	CHECK(q.pending() == 7);
+	const uint8_t *p = q.take(&n);
+	CHECK(p != NULL && n == 7 && memcmp(p, "abcdefg", 7) == 0);
+	q.release();
+	CHECK(q.empty());
+
+	// In-place frames: commit() may be shorter, 0 abandons the reservation
+	uint8_t *w = q.reserve(16);
+	CHECK(w != NULL);
+	memcpy(w, "xy", 2);
+	q.commit(2);
+	w = q.reserve(16);
+	CHECK(w != NULL);
+	q.commit(0);
+	CHECK(q.pending() == 2);
+	q.commit(5);
+	CHECK(q.pending() == 2);
+	p = q.take(&n);
+	CHECK(n == 2 && p[0] == 'x' && p[1] == 'y');
+	q.release();
+
+	// Oversized and zero-length frames are refused and counted
+	uint32_t d0 = q.getDropped();
+	CHECK(q.reserve(UART_TX_RING_SIZE + 1) == NULL);
+	CHECK(!q.push(frame, 0));
+	CHECK(q.getDropped() == d0 + 2);
+
+	// A full ring refuses frames until the consumer releases space
+	memset(frame, 0x5A, sizeof(frame));
+	CHECK(q.push(frame, UART_TX_RING_SIZE - 100));
+	CHECK(!q.push(frame, 200));
+	p = q.take(&n);
+	CHECK(n == UART_TX_RING_SIZE - 100);
+	q.release();
+	CHECK(q.push(frame, 200));
+	p = q.take(&n);
+	q.release();
+
+	// The frame count limits the queue too
+	for (int i = 0; i < UART_TX_MAX_FRAMES; i++) {
+		CHECK(q.push(frame, 1));
+	}
+	CHECK(!q.push(frame, 1));
+	p = q.take(&n);
+	CHECK(n == UART_TX_MAX_FRAMES);
+	q.release();
+	CHECK(q.empty());
+
+	// Random traffic with wrap-around: bytes come out once and in order
+	std::vector<uint8_t> expect;
+	uint32_t id = 0, accepted = 0, refused = 0;
+	srand(7);
+	for (int t = 0; t < 200000; t++) {
+		if (rand() % 4 == 0) {
+			uint16_t len = 1 + rand() % 300;
+			bool ok;
+
+			for (uint16_t i = 0; i < len; i++) frame[i] = (uint8_t)(id * 31 + i);
+			if (rand() % 2) {
+				ok = q.push(frame, len);
+			} else {
+				w = q.reserve(len + 20);
+				ok = (w != NULL);
+				if (ok) {
+					memcpy(w, frame, len);
+					q.commit(len);
+				}
+			}
+
+			if (ok) {
+				expect.insert(expect.end(), frame, frame + len);
+				accepted++;
+			} else {
+				refused++;
+			}
+			id++;
+			kick();
+		}
+		dmaTick(40);
+	}
+	for (int i = 0; i < 100000 && !q.empty(); i++) {
+		dmaTick(40);
+	}
+
+	printf("accepted %u refused %u transfers %u\n", accepted, refused, transfers);
+	CHECK(q.empty());
+	CHECK(accepted > 1000 && refused > 0);
+	CHECK(transfers < accepted);
+	CHECK(sent == expect);
+
+	return checkDone("test_txqueue");
+}
@@ -0,0 +1,183 @@
+/**
+ * @file
+ *
+ * @brief Host test of the uplink protocol (messages, framing, legacy packets)
+ *
+ * @author agent
+ *
+ * @date Oct 19, 2026
+ *
+ */
+
+#include "Uplink.h"
+#include "Framing.h"
+#include "check.h"
+#include <stdlib.h>
+
+static UplinkDecoder d;
+
+/**
+ * @brief Encode a message and feed it to d, return the messages decoded
+ */
+static int roundTrip(const UplinkMsg *m) {
+	uint8_t out[UPLINK_MAX_FRAME];
+	uint16_t n = uplinkEncode(m, out);
+	int got = 0;
+
+	CHECK(n <= UPLINK_MAX_FRAME);
+	for (uint16_t i = 0; i < n; i++) {
+		if (d.feed(out[i], 42)) got++;
+	}
+	return got;
+}
+
+/**
+ * @brief Frame raw header and payload bytes with a valid CRC and feed them
+ */
+static int feedRaw(uint8_t *raw, uint8_t n) {
+	uint8_t out[UPLINK_MAX_FRAME + 4];
+	uint16_t crc = crc16Ccitt(raw, n);
+	int got = 0;
+
+	raw[n] = (uint8_t)crc;
+	raw[n + 1] = (uint8_t)(crc >> 8);
+	uint16_t len = cobsEncode(raw, n + 2, out);
+	out[len++] = 0;
+	for (uint16_t i = 0; i < len; i++) {
+		if (d.feed(out[i], 0)) got++;
+	}
+	return got;
+}
+
+int main(void) {
+	UplinkMsg m;
+	uint8_t seq = 0;
+
+	// Every message type survives encode/decode
+	UplinkSticks st = {65535, -32767, 1234, -1}, st2;
+	uplinkSticks(&m, seq++, &st);
+	CHECK(roundTrip(&m) == 1);
+	CHECK(uplinkGetSticks(d.getMsg(), &st2));
+	CHECK(st2.throttle == 65535 && st2.pitch == -32767 && st2.roll == 1234 && st2.yaw == -1);
+	CHECK(d.getMsg()->time == 42);
+
+	UplinkMode mode;
+	uplinkMode(&m, seq++, UplinkMode::DEMO);
+	CHECK(roundTrip(&m) == 1);
+	CHECK(uplinkGetMode(d.getMsg(), &mode) && mode == UplinkMode::DEMO);
+	CHECK(!uplinkGetSticks(d.getMsg(), &st2));
+
+	bool armed = false;
+	uplinkArm(&m, seq++, true);
+	CHECK(roundTrip(&m) == 1);
+	CHECK(uplinkGetArm(d.getMsg(), &armed) && armed);
+	uplinkArm(&m, seq++, false);
+	CHECK(roundTrip(&m) == 1);
+	CHECK(uplinkGetArm(d.getMsg(), &armed) && !armed);
+
+	uint16_t id;
+	float value;
+	uplinkParamGet(&m, seq++, 513);
+	CHECK(roundTrip(&m) == 1);
+	CHECK(uplinkGetParamGet(d.getMsg(), &id) && id == 513);
+	uplinkParamSet(&m, seq++, 7, -3.25e-3f);
+	CHECK(roundTrip(&m) == 1);
+	CHECK(uplinkGetParamSet(d.getMsg(), &id, &value) && id == 7 && value == -3.25e-3f);
+
+	uint32_t time;
+	uplinkHeartbeat(&m, seq++, 0xA0B0C0D0);
+	CHECK(roundTrip(&m) == 1);
+	CHECK(uplinkGetHeartbeat(d.getMsg(), &time) && time == 0xA0B0C0D0);
+
+	uplinkLogErase(&m, seq++);
+	CHECK(roundTrip(&m) == 1);
+	CHECK(uplinkGetLogErase(d.getMsg()));
+
+	uint8_t axis, rule;
+	uplinkAutotune(&m, seq++, 2, 1);
+	CHECK(roundTrip(&m) == 1);
+	CHECK(uplinkGetAutotune(d.getMsg(), &axis, &rule) && axis == 2 && rule == 1);
+
+	// A wrong version or payload length is rejected and counted
+	UplinkStats s;
+	d.getStats(&s);
+	uint32_t errors = s.errors;
+	uint8_t raw[UPLINK_MAX_RAW + 2] = {UPLINK_VERSION + 1, (uint8_t)UplinkId::ARM, seq++, 1, 1};
+	CHECK(feedRaw(raw, 5) == 0);
+	raw[0] = UPLINK_VERSION;
+	raw[3] = 2;
+	CHECK(feedRaw(raw, 5) == 0);
+	d.getStats(&s);
+	CHECK(s.errors == errors + 2);
+
+	// A well-framed message of the wrong shape decodes but doesn't read as ARM
+	raw[2] = seq++;
+	raw[3] = 2;
+	raw[5] = 0;
+	CHECK(feedRaw(raw, 6) == 1);
+	CHECK(!uplinkGetArm(d.getMsg(), &armed));
+
+	// Stream with bit flips and dropped bytes: no damaged message gets
+	// through, and every message is either received or counted lost
+	UplinkDecoder f;
+	uint32_t sent = 0, clean = 0, good = 0, bad = 0;
+	srand(11);
+	for (uint32_t i = 0; i < 100000; i++) {
+		UplinkSticks x = {(uint16_t)rand(), (int16_t)rand(), (int16_t)rand(), (int16_t)rand()};
+		uint8_t out[UPLINK_MAX_FRAME];
+		bool fault = false;
+
+		uplinkSticks(&m, (uint8_t)i, &x);
+		uint16_t n = uplinkEncode(&m, out);
+		if (rand() % 50 == 0) {
+			out[rand() % (n - 1)] ^= (uint8_t)(1 << (rand() % 8));
+			fault = true;
+		}
+		int skip = (rand() % 100 == 0) ? rand() % (n - 1) : -1;
+		if (skip >= 0) fault = true;
+
+		for (uint16_t k = 0; k < n; k++) {
+			if (k == skip) continue;
+			if (f.feed(out[k], i)) {
+				UplinkSticks y;
+				good++;
+				if (!uplinkGetSticks(f.getMsg(), &y) || y.throttle != x.throttle || y.yaw != x.yaw) bad++;
+			}
+		}
+		sent++;
+		if (!fault) clean++;
+	}
+	UplinkStats fs;
+	f.getStats(&fs);
+	printf("sent %u clean %u good %u received %u lost %u errors %u\n", sent, clean, good, fs.received, fs.lost, fs.errors);
+	CHECK(bad == 0);
+	CHECK(good >= clean);
+	CHECK(fs.received + fs.lost == sent);
+
+	// Legacy packets: FLY selects the mode and arms, sticks are rescaled,
+	// the motor toggle disarms
+	RcParser p;
+	RcPacket k;
+	UplinkMsg out[2];
+	uint8_t lseq = 0;
+	bool larmed = false;
+	for (int i = 0; i < TRANSFER_SIZE; i++) p.feed(FLY_CMD, 5);
+	CHECK(p.read(&k));
+	CHECK(uplinkFromLegacy(&k, &lseq, &larmed, out) == 2);
+	CHECK(uplinkGetMode(&out[0], &mode) && mode == UplinkMode::FLY);
+	CHECK(uplinkGetArm(&out[1], &armed) && armed && out[1].time == 5);
+
+	const uint8_t sp[] = {START, 253, 0, 127, 253, STOP};
+	for (int i = 0; i < TRANSFER_SIZE; i++) p.feed(sp[i], 6);
+	CHECK(p.read(&k));
+	CHECK(uplinkFromLegacy(&k, &lseq, &larmed, out) == 1);
+	CHECK(uplinkGetSticks(&out[0], &st2));
+	CHECK(st2.throttle == 65535 && st2.pitch == -32767 && st2.roll == 0 && out[0].seq == 2);
+
+	for (int i = 0; i < TRANSFER_SIZE; i++) p.feed(DEMO_MOTOR_TOGGLE, 7);
+	CHECK(p.read(&k));
+	uplinkFromLegacy(&k, &lseq, &larmed, out);
+	CHECK(uplinkGetArm(&out[0], &armed) && !armed);
+
+	return checkDone("test_uplink");
+}